@@ -18,6 +18,13 @@ AS_IF([test "x${have_ftgl}" = "xyes"],[
 
  CPPFLAGS="$tmp_gem_check_lib_cppflags"
  ])
+dnl the glyph-atlas renderer uses FreeType directly
+AS_IF([test "x${have_ftgl}" = "xyes"],[
+ PKG_CHECK_MODULES([PKG_FT2], [freetype2],
+  [GEM_LIB_FTGL_CFLAGS="$GEM_LIB_FTGL_CFLAGS $PKG_FT2_CFLAGS"
+   GEM_LIB_FTGL_LIBS="$GEM_LIB_FTGL_LIBS $PKG_FT2_LIBS"],
+  [:])
+])
 AS_IF([test "x${have_ftgl}" != "xyes"],[
  GEM_LIB_FTGL_CFLAGS=""
  GEM_LIB_FTGL_LIBS=""
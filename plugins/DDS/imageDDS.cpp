@@ -0,0 +1,282 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+#include "imageDDS.h"
+#include "Gem/RTE.h"
+#include "Gem/Image.h"
+#include "Gem/Properties.h"
+#include "plugins/PluginFactory.h"
+
+using namespace gem::plugins;
+
+REGISTER_IMAGELOADERFACTORY("DDS", imageDDS);
+
+namespace
+{
+/* where to find the image data in the file */
+struct Layout {
+  unsigned int format;
+  unsigned int width, height;
+  unsigned int levels;
+  bool upsidedown;
+  /* KTX: each level is preceded by its size (in the file's byte order) */
+  bool ktx, swap;
+  long offset;
+  Layout(void)
+    : format(0), width(0), height(0), levels(1)
+    , upsidedown(false)
+    , ktx(false), swap(false)
+    , offset(0)
+  {}
+};
+
+unsigned int le32(const unsigned char*b)
+{
+  return b[0] | (b[1]<<8) | (b[2]<<16) | (static_cast<unsigned int>(b[3])<<24);
+}
+unsigned int be32(const unsigned char*b)
+{
+  return b[3] | (b[2]<<8) | (b[1]<<16) | (static_cast<unsigned int>(b[0])<<24);
+}
+
+size_t levelSize(unsigned int format, unsigned int width, unsigned int height)
+{
+  return ((width+3)/4) * ((height+3)/4) * imageStruct::blockSize(format);
+}
+
+bool readDDS(FILE*file, Layout&layout)
+{
+  /* "DDS ", DDS_HEADER and (optionally) DDS_HEADER_DXT10 */
+  unsigned char header[4+124+20];
+  if(fread(header, 1, 128, file)!=128 || memcmp(header, "DDS ", 4)) {
+    return false;
+  }
+  const unsigned char*h=header+4;
+  if(le32(h)!=124) {
+    return false;
+  }
+  layout.height=le32(h+8);
+  layout.width =le32(h+12);
+  layout.levels=le32(h+24);
+  layout.offset=128;
+
+  /* uncompressed files (no DDPF_FOURCC) are left to the other loaders */
+  if(!(le32(h+76) & 0x4)) {
+    return false;
+  }
+  const unsigned char*fourcc=h+80;
+  if(!memcmp(fourcc, "DXT1", 4)) {
+    layout.format=GEM_BC1;
+  } else if(!memcmp(fourcc, "DXT5", 4)) {
+    layout.format=GEM_BC3;
+  } else if(!memcmp(fourcc, "DX10", 4)) {
+    if(fread(header+128, 1, 20, file)!=20) {
+      return false;
+    }
+    layout.offset+=20;
+    /* for arrays and cubemaps, only the first image is used */
+    switch(le32(header+128)) {
+    case 71: /* DXGI_FORMAT_BC1_UNORM */
+    case 72: /* DXGI_FORMAT_BC1_UNORM_SRGB */
+      layout.format=GEM_BC1;
+      break;
+    case 77: /* DXGI_FORMAT_BC3_UNORM */
+    case 78: /* DXGI_FORMAT_BC3_UNORM_SRGB */
+      layout.format=GEM_BC3;
+      break;
+    case 98: /* DXGI_FORMAT_BC7_UNORM */
+    case 99: /* DXGI_FORMAT_BC7_UNORM_SRGB */
+      layout.format=GEM_BC7;
+      break;
+    default:
+      return false;
+    }
+  } else {
+    return false;
+  }
+  /* DDS files start with the top row */
+  layout.upsidedown=true;
+  return true;
+}
+
+bool readKTX(FILE*file, Layout&layout)
+{
+  static const unsigned char identifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+  };
+  unsigned char header[64];
+  if(fread(header, 1, 64, file)!=64 || memcmp(header, identifier, 12)) {
+    return false;
+  }
+  if(0x04030201 == le32(header+12)) {
+    layout.swap=false;
+  } else if(0x04030201 == be32(header+12)) {
+    layout.swap=true;
+  } else {
+    return false;
+  }
+  const unsigned char*h=header+16;
+  unsigned int values[12];
+  for(int i=0; i<12; i++) {
+    values[i]=layout.swap?be32(h+4*i):le32(h+4*i);
+  }
+  const unsigned int glType=values[0];
+  const unsigned int glInternalFormat=values[3];
+  const unsigned int depth=values[8];
+  const unsigned int keyValueBytes=values[11];
+  if(glType || depth>1) {
+    /* only compressed 2D textures */
+    return false;
+  }
+  switch(glInternalFormat) {
+  case 0x83F0: /* GL_COMPRESSED_RGB_S3TC_DXT1_EXT */
+  case 0x83F1: /* GL_COMPRESSED_RGBA_S3TC_DXT1_EXT */
+    layout.format=GEM_BC1;
+    break;
+  case 0x83F3: /* GL_COMPRESSED_RGBA_S3TC_DXT5_EXT */
+    layout.format=GEM_BC3;
+    break;
+  case 0x8E8C: /* GL_COMPRESSED_RGBA_BPTC_UNORM */
+    layout.format=GEM_BC7;
+    break;
+  case 0x8D64: /* GL_ETC1_RGB8_OES (a subset of ETC2) */
+  case 0x9274: /* GL_COMPRESSED_RGB8_ETC2 */
+    layout.format=GEM_ETC2;
+    break;
+  case 0x9278: /* GL_COMPRESSED_RGBA8_ETC2_EAC */
+    layout.format=GEM_ETC2A;
+    break;
+  default:
+    return false;
+  }
+  layout.width =values[6];
+  layout.height=values[7];
+  layout.levels=values[10];
+  layout.ktx=true;
+  layout.offset=64+keyValueBytes;
+
+  /* the first row is at the bottom, unless the writer says otherwise */
+  if(keyValueBytes) {
+    std::string keyvalues(keyValueBytes, 0);
+    if(fread(&keyvalues[0], 1, keyValueBytes, file)!=keyValueBytes) {
+      return false;
+    }
+    std::string::size_type pos=keyvalues.find("KTXorientation");
+    if(pos!=std::string::npos
+        && keyvalues.find("T=d", pos)!=std::string::npos) {
+      layout.upsidedown=true;
+    }
+  }
+  return true;
+}
+};
+
+/////////////////////////////////////////////////////////
+//
+// imageDDS
+//
+/////////////////////////////////////////////////////////
+// Constructor
+//
+/////////////////////////////////////////////////////////
+imageDDS :: imageDDS(void)
+{
+}
+imageDDS :: ~imageDDS(void)
+{
+}
+
+/////////////////////////////////////////////////////////
+// really open the file ! (OS dependent)
+//
+/////////////////////////////////////////////////////////
+bool imageDDS :: load(std::string filename, imageStruct&result,
+                      gem::Properties&props)
+{
+  FILE*file=fopen(filename.c_str(), "rb");
+  if(!file) {
+    return false;
+  }
+  Layout layout;
+  if(!readDDS(file, layout)) {
+    layout=Layout();
+    rewind(file);
+    if(!readKTX(file, layout)) {
+      fclose(file);
+      return false;
+    }
+  }
+  if(!layout.width || !layout.height) {
+    fclose(file);
+    return false;
+  }
+  if(!layout.levels) {
+    layout.levels=1;
+  }
+
+  // if the caller needs less, pick a smaller mipmap level
+  double minwidth=0, minheight=0;
+  props.get("minwidth", minwidth);
+  props.get("minheight", minheight);
+  unsigned int level=0;
+  unsigned int width=layout.width, height=layout.height;
+  long offset=layout.offset;
+  while(level+1 < layout.levels
+        && (minwidth>0 || minheight>0)
+        && (width >1 && width /2 >= minwidth)
+        && (height>1 && height/2 >= minheight)) {
+    size_t size=levelSize(layout.format, width, height);
+    if(layout.ktx) {
+      /* the size stored in the file also covers array elements and faces */
+      unsigned char buf[4];
+      if(fseek(file, offset, SEEK_SET) || fread(buf, 1, 4, file)!=4) {
+        fclose(file);
+        return false;
+      }
+      size=layout.swap?be32(buf):le32(buf);
+      offset+=4+((size+3)&~3);
+    } else {
+      offset+=size;
+    }
+    width/=2;
+    height/=2;
+    level++;
+  }
+  if(level) {
+    props.set("imagewidth",  (double)layout.width);
+    props.set("imageheight", (double)layout.height);
+  }
+  if(layout.ktx) {
+    offset+=4;
+  }
+
+  result.xsize=width;
+  result.ysize=height;
+  result.setCsizeByFormat(layout.format);
+  result.upsidedown=layout.upsidedown;
+  result.reallocate();
+  const size_t size=result.getDataSize();
+  bool success=(0==fseek(file, offset, SEEK_SET)
+                && fread(result.data, 1, size, file)==size);
+  fclose(file);
+  if(!success) {
+    fprintf(stderr, "[GEM:imageDDS] truncated image file: %s\n",
+            filename.c_str());
+  }
+  return success;
+}
@@ -0,0 +1,66 @@
+/*-----------------------------------------------------------------
+
+GEM - Graphics Environment for Multimedia
+
+Load block compressed (GPU) textures from DDS and KTX files
+
+Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+For information on usage and redistribution, and for a DISCLAIMER OF ALL
+WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE_GEMPLUGIN__IMAGEDDS_IMAGEDDS_H_
+#define _INCLUDE_GEMPLUGIN__IMAGEDDS_IMAGEDDS_H_
+#include "plugins/imageloader.h"
+#include <stdio.h>
+
+/*-----------------------------------------------------------------
+  -------------------------------------------------------------------
+  CLASS
+  imageDDS
+
+  Loads in a block compressed texture
+
+  KEYWORDS
+  pix
+
+  DESCRIPTION
+
+  the pixels are not decoded: the image is returned in its block compressed
+  format (GEM_BC1, GEM_BC3, GEM_BC7, GEM_ETC2, GEM_ETC2A),
+  so it can be uploaded to the GPU as it is
+
+  if the file contains mipmaps, the smallest level that satisfies
+  the 'minwidth'/'minheight' hints is returned
+
+  -----------------------------------------------------------------*/
+namespace gem
+{
+namespace plugins
+{
+class GEM_EXPORT imageDDS : public gem::plugins::imageloader
+{
+public:
+
+  //////////
+  // Constructor
+  imageDDS(void);
+  virtual ~imageDDS(void);
+
+  //////////
+  // read an image
+  virtual bool load(std::string filename, imageStruct&result,
+                    gem::Properties&props);
+
+  // this is always threadable
+  virtual bool isThreadable(void)
+  {
+    return true;
+  }
+};
+};
+};
+
+#endif  // for header file
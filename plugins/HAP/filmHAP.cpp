@@ -0,0 +1,805 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+#include "filmHAP.h"
+#include "plugins/PluginFactory.h"
+#include "Gem/Properties.h"
+#include "Gem/RTE.h"
+
+#ifndef _WIN32
+# include <sys/types.h>
+#endif
+
+using namespace gem::plugins;
+
+REGISTER_FILMFACTORY("HAP", filmHAP);
+
+namespace
+{
+unsigned int le24(const unsigned char*b)
+{
+  return b[0] | (b[1]<<8) | (b[2]<<16);
+}
+unsigned int le32(const unsigned char*b)
+{
+  return b[0] | (b[1]<<8) | (b[2]<<16) | (static_cast<unsigned int>(b[3])<<24);
+}
+unsigned int be32(const unsigned char*b)
+{
+  return b[3] | (b[2]<<8) | (b[1]<<16) | (static_cast<unsigned int>(b[0])<<24);
+}
+unsigned long long be64(const unsigned char*b)
+{
+  return (static_cast<unsigned long long>(be32(b))<<32) | be32(b+4);
+}
+
+bool seekTo(FILE*file, unsigned long long offset)
+{
+#ifdef _WIN32
+  return (0 == _fseeki64(file, static_cast<__int64>(offset), SEEK_SET));
+#else
+  return (0 == fseeko(file, static_cast<off_t>(offset), SEEK_SET));
+#endif
+}
+unsigned long long fileSize(FILE*file)
+{
+#ifdef _WIN32
+  if(_fseeki64(file, 0, SEEK_END)) {
+    return 0;
+  }
+  const __int64 size=_ftelli64(file);
+#else
+  if(fseeko(file, 0, SEEK_END)) {
+    return 0;
+  }
+  const off_t size=ftello(file);
+#endif
+  return (size>0)?static_cast<unsigned long long>(size):0;
+}
+
+/////////////////////////////////////////////////////////
+// QuickTime boxes
+//
+/////////////////////////////////////////////////////////
+struct Box {
+  const unsigned char*type;
+  const unsigned char*data;
+  size_t size;
+};
+
+/* the box at data[pos]; 'pos' is moved behind it */
+bool nextBox(const unsigned char*data, size_t size, size_t&pos, Box&box)
+{
+  if(pos+8 > size) {
+    return false;
+  }
+  unsigned long long boxsize=be32(data+pos);
+  size_t header=8;
+  if(1 == boxsize) {
+    if(pos+16 > size) {
+      return false;
+    }
+    boxsize=be64(data+pos+8);
+    header=16;
+  } else if(0 == boxsize) {
+    /* extends to the end of the parent */
+    boxsize=size-pos;
+  }
+  if(boxsize<header || boxsize>size-pos) {
+    return false;
+  }
+  box.type=data+pos+4;
+  box.data=data+pos+header;
+  box.size=static_cast<size_t>(boxsize)-header;
+  pos+=static_cast<size_t>(boxsize);
+  return true;
+}
+/* the first child of 'parent' with the given type */
+bool findBox(const Box&parent, const char*type, Box&box)
+{
+  size_t pos=0;
+  while(nextBox(parent.data, parent.size, pos, box)) {
+    if(!memcmp(box.type, type, 4)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* read the 'moov' box (which holds all the meta-data) into memory */
+bool readMovie(FILE*file, std::vector<unsigned char>&moov)
+{
+  unsigned long long pos=0;
+  unsigned char header[16];
+  while(seekTo(file, pos) && 8 == fread(header, 1, 8, file)) {
+    unsigned long long size=be32(header);
+    unsigned int headersize=8;
+    if(1 == size) {
+      if(8 != fread(header+8, 1, 8, file)) {
+        return false;
+      }
+      size=be64(header+8);
+      headersize=16;
+    }
+    if(!memcmp(header+4, "moov", 4)) {
+      if(0 == size) {
+        /* the rest of the file */
+        moov.clear();
+        unsigned char buf[4096];
+        size_t count;
+        while((count=fread(buf, 1, sizeof(buf), file))>0) {
+          moov.insert(moov.end(), buf, buf+count);
+        }
+        return !moov.empty();
+      }
+      /* no sane movie has 256MB of meta-data */
+      if(size<=headersize || size-headersize > (1<<28)) {
+        return false;
+      }
+      moov.resize(static_cast<size_t>(size-headersize));
+      return (moov.size() == fread(&moov[0], 1, moov.size(), file));
+    }
+    if(size<headersize) {
+      /* size 0 ("to the end of the file") or garbage */
+      return false;
+    }
+    pos+=size;
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////////////
+// Snappy
+//
+/////////////////////////////////////////////////////////
+
+/* the uncompressed length (a varint preceding the data) */
+bool snappyLength(const unsigned char*src, size_t srcsize,
+                  size_t&length, size_t&headersize)
+{
+  length=0;
+  for(size_t i=0; i<5 && i<srcsize; i++) {
+    length|=static_cast<size_t>(src[i]&0x7F)<<(7*i);
+    if(!(src[i]&0x80)) {
+      headersize=i+1;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool snappyDecompress(const unsigned char*src, size_t srcsize,
+                      unsigned char*dst, size_t dstsize)
+{
+  size_t length=0, pos=0, out=0;
+  if(!snappyLength(src, srcsize, length, pos) || length!=dstsize) {
+    return false;
+  }
+  while(pos<srcsize) {
+    const unsigned int tag=src[pos++];
+    size_t len=0, offset=0;
+    switch(tag&3) {
+    case 0: /* literal */
+      len=tag>>2;
+      if(len>=60) {
+        /* the length-1 follows in 1..4 bytes */
+        const size_t bytes=len-59;
+        if(pos+bytes>srcsize) {
+          return false;
+        }
+        len=0;
+        for(size_t i=0; i<bytes; i++) {
+          len|=static_cast<size_t>(src[pos+i])<<(8*i);
+        }
+        pos+=bytes;
+      }
+      len++;
+      if(len>srcsize-pos || len>dstsize-out) {
+        return false;
+      }
+      memcpy(dst+out, src+pos, len);
+      pos+=len;
+      out+=len;
+      continue;
+    case 1: /* copy with an 11bit offset */
+      if(pos+1>srcsize) {
+        return false;
+      }
+      len=((tag>>2)&7)+4;
+      offset=((tag>>5)<<8) | src[pos];
+      pos+=1;
+      break;
+    case 2: /* copy with a 16bit offset */
+      if(pos+2>srcsize) {
+        return false;
+      }
+      len=(tag>>2)+1;
+      offset=src[pos] | (src[pos+1]<<8);
+      pos+=2;
+      break;
+    default: /* copy with a 32bit offset */
+      if(pos+4>srcsize) {
+        return false;
+      }
+      len=(tag>>2)+1;
+      offset=le32(src+pos);
+      pos+=4;
+      break;
+    }
+    if(!offset || offset>out || len>dstsize-out) {
+      return false;
+    }
+    /* the copy may overlap its own output (e.g. runs of the same byte) */
+    const unsigned char*from=dst+out-offset;
+    unsigned char*to=dst+out;
+    for(size_t i=0; i<len; i++) {
+      to[i]=from[i];
+    }
+    out+=len;
+  }
+  return (out == dstsize);
+}
+
+/////////////////////////////////////////////////////////
+// HAP frames
+//
+/////////////////////////////////////////////////////////
+
+/* a section: 3 bytes size (or 0 and 4 more bytes), 1 byte type */
+bool readSection(const unsigned char*data, size_t size,
+                 size_t&headersize, size_t&length, unsigned int&type)
+{
+  if(size<4) {
+    return false;
+  }
+  length=le24(data);
+  type=data[3];
+  headersize=4;
+  if(!length) {
+    if(size<8) {
+      return false;
+    }
+    length=le32(data+4);
+    headersize=8;
+  }
+  return (length <= size-headersize);
+}
+
+/* the low nibble of the frame's type */
+unsigned int textureFormat(unsigned int type)
+{
+  switch(type&0x0F) {
+  case 0xB:
+    return GEM_BC1;
+  case 0xE:
+    return GEM_BC3;
+  case 0xF:
+    return GEM_BC3_YCOCG;
+  case 0xC:
+    return GEM_BC7;
+  default:
+    break;
+  }
+  return 0;
+}
+
+/* a part of the frame that can be decompressed on its own */
+struct Chunk {
+  const unsigned char*src;
+  size_t srcsize;
+  bool snappy;
+  size_t offset, size; /* in the texture */
+};
+
+class ChunkJob : public gem::thread::ThreadPool::Job
+{
+public:
+  const std::vector<Chunk>&m_chunks;
+  unsigned char*m_dst;
+  std::vector<unsigned char>m_ok;
+  ChunkJob(const std::vector<Chunk>&chunks, unsigned char*dst)
+    : m_chunks(chunks), m_dst(dst), m_ok(chunks.size())
+  {}
+  virtual ~ChunkJob(void) {}
+
+  void run(unsigned int start, unsigned int stop)
+  {
+    for(unsigned int i=start; i<stop; i++) {
+      const Chunk&c=m_chunks[i];
+      if(c.snappy) {
+        m_ok[i]=snappyDecompress(c.src, c.srcsize, m_dst+c.offset, c.size);
+      } else {
+        memcpy(m_dst+c.offset, c.src, c.size);
+        m_ok[i]=true;
+      }
+    }
+  }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    unsigned int start, stop;
+    gem::thread::ThreadPool::getSlice(slice, numSlices, m_chunks.size(),
+                                      start, stop);
+    run(start, stop);
+  }
+  bool ok(void) const
+  {
+    for(unsigned int i=0; i<m_ok.size(); i++) {
+      if(!m_ok[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+/* split the frame data according to the decode instructions */
+bool readChunks(const unsigned char*data, size_t size,
+                std::vector<Chunk>&chunks)
+{
+  size_t header, length;
+  unsigned int type;
+  if(!readSection(data, size, header, length, type) || 0x01 != type) {
+    return false;
+  }
+  const unsigned char*instructions=data+header;
+  size_t remaining=length;
+  const unsigned char*payload=data+header+length;
+  const size_t payloadsize=size-header-length;
+
+  const unsigned char*compressors=0, *sizes=0, *offsets=0;
+  size_t count=0, numSizes=0, numOffsets=0;
+  while(remaining) {
+    if(!readSection(instructions, remaining, header, length, type)) {
+      return false;
+    }
+    switch(type) {
+    case 0x02:
+      compressors=instructions+header;
+      count=length;
+      break;
+    case 0x03:
+      sizes=instructions+header;
+      numSizes=length/4;
+      break;
+    case 0x04:
+      offsets=instructions+header;
+      numOffsets=length/4;
+      break;
+    default:
+      break;
+    }
+    instructions+=header+length;
+    remaining-=header+length;
+  }
+  if(!compressors || !sizes || !count || numSizes != count
+      || (offsets && numOffsets != count)) {
+    return false;
+  }
+
+  chunks.resize(count);
+  size_t pos=0;
+  for(size_t i=0; i<count; i++) {
+    const size_t offset=offsets?le32(offsets+4*i):pos;
+    const size_t chunksize=le32(sizes+4*i);
+    if(offset>payloadsize || chunksize>payloadsize-offset) {
+      return false;
+    }
+    Chunk&c=chunks[i];
+    c.src=payload+offset;
+    c.srcsize=chunksize;
+    switch(compressors[i]) {
+    case 0x0A:
+      c.snappy=false;
+      break;
+    case 0x0B:
+      c.snappy=true;
+      break;
+    default:
+      return false;
+    }
+    pos=offset+chunksize;
+  }
+  return true;
+}
+};
+
+/////////////////////////////////////////////////////////
+//
+// filmHAP
+//
+/////////////////////////////////////////////////////////
+// Constructor
+//
+/////////////////////////////////////////////////////////
+
+filmHAP :: filmHAP(void) :
+  m_file(NULL),
+  m_width(0), m_height(0),
+  m_fps(-1.0),
+  m_curFrame(-1),
+  m_readNext(false),
+  m_newfilm(false),
+  m_pool(0)
+{ }
+
+/////////////////////////////////////////////////////////
+// Destructor
+//
+/////////////////////////////////////////////////////////
+filmHAP :: ~filmHAP(void)
+{
+  close();
+}
+
+
+void filmHAP :: close(void)
+{
+  if(m_file) {
+    fclose(m_file);
+  }
+  m_file=NULL;
+  m_samples.clear();
+  m_curFrame=-1;
+  m_readNext=false;
+}
+
+/////////////////////////////////////////////////////////
+// really open the file !
+//
+/////////////////////////////////////////////////////////
+bool filmHAP :: open(const std::string&filename,
+                     const gem::Properties&wantProps)
+{
+  close();
+  m_file=fopen(filename.c_str(), "rb");
+  if(!m_file) {
+    return false;
+  }
+  std::vector<unsigned char>moov;
+  if(!readMovie(m_file, moov)) {
+    close();
+    return false;
+  }
+
+  /* find the (first) HAP video track */
+  Box movie, trak, mdia, stbl, box;
+  movie.type=0;
+  movie.data=&moov[0];
+  movie.size=moov.size();
+  Box stsd, stsz, stsc, stco;
+  bool found=false, co64=false;
+  unsigned int timescale=0;
+  size_t pos=0;
+  while(!found && nextBox(movie.data, movie.size, pos, trak)) {
+    if(memcmp(trak.type, "trak", 4) || !findBox(trak, "mdia", mdia)) {
+      continue;
+    }
+    if(!findBox(mdia, "hdlr", box) || box.size<12
+        || memcmp(box.data+8, "vide", 4)) {
+      continue;
+    }
+    if(!findBox(mdia, "minf", box) || !findBox(box, "stbl", stbl)) {
+      continue;
+    }
+    if(!findBox(stbl, "stsd", stsd) || stsd.size<8+36) {
+      continue;
+    }
+    const unsigned char*codec=stsd.data+12;
+    if(memcmp(codec, "Hap1", 4) && memcmp(codec, "Hap5", 4)
+        && memcmp(codec, "HapY", 4) && memcmp(codec, "Hap7", 4)) {
+      if(!memcmp(codec, "Hap", 3)) {
+        verbose(0, "[GEM:filmHAP] unsupported HAP flavour '%.4s'", codec);
+      }
+      continue;
+    }
+    if(!findBox(stbl, "stsz", stsz) || stsz.size<12
+        || !findBox(stbl, "stsc", stsc) || stsc.size<8) {
+      continue;
+    }
+    if(findBox(stbl, "stco", stco)) {
+      co64=false;
+    } else if (findBox(stbl, "co64", stco)) {
+      co64=true;
+    } else {
+      continue;
+    }
+    if(stco.size<8) {
+      continue;
+    }
+    if(findBox(mdia, "mdhd", box) && box.size>=24) {
+      timescale=be32(box.data+((box.data[0]==1)?20:12));
+    }
+    m_width =(stsd.data[8+32]<<8) | stsd.data[8+33];
+    m_height=(stsd.data[8+34]<<8) | stsd.data[8+35];
+
+    /* the frame rate (assuming a constant rate) */
+    m_fps=-1.;
+    if(timescale && findBox(stbl, "stts", box) && box.size>=8) {
+      unsigned int entries=be32(box.data+4);
+      unsigned long long samples=0, duration=0;
+      for(unsigned int i=0; i<entries && 8+8*(i+1)<=box.size; i++) {
+        const unsigned int n=be32(box.data+8+8*i);
+        samples +=n;
+        duration+=static_cast<unsigned long long>(n) * be32(box.data+12+8*i);
+      }
+      if(duration) {
+        m_fps=static_cast<double>(timescale) * samples / duration;
+      }
+    }
+    found=true;
+  }
+  if(!found || !m_width || !m_height) {
+    close();
+    return false;
+  }
+
+  /* where to find the frames */
+  const unsigned int samplesize=be32(stsz.data+4);
+  unsigned int numSamples=be32(stsz.data+8);
+  if(!samplesize && 12+4*static_cast<unsigned long long>(numSamples)>stsz.size) {
+    numSamples=(stsz.size-12)/4;
+  }
+  unsigned int numChunks=be32(stco.data+4);
+  if(8+(co64?8:4)*static_cast<unsigned long long>(numChunks)>stco.size) {
+    numChunks=(stco.size-8)/(co64?8:4);
+  }
+  unsigned int numEntries=be32(stsc.data+4);
+  if(8+12*static_cast<unsigned long long>(numEntries)>stsc.size) {
+    numEntries=(stsc.size-8)/12;
+  }
+  /* the numbers in the file are not to be trusted:
+   * only accept samples that lie within the file
+   * (and that do not add up to more data than there is) */
+  const unsigned long long filesize=fileSize(m_file);
+  unsigned long long total=0;
+  unsigned int entry=0;
+  bool valid=true;
+  for(unsigned int chunk=0; valid && chunk<numChunks
+      && m_samples.size()<numSamples && numEntries; chunk++) {
+    /* entries are indexed by the first (1-based) chunk they apply to */
+    while(entry+1<numEntries
+          && be32(stsc.data+8+12*(entry+1)) <= chunk+1) {
+      entry++;
+    }
+    const unsigned int perChunk=be32(stsc.data+8+12*entry+4);
+    unsigned long long offset=co64
+                              ?be64(stco.data+8+8*chunk)
+                              :be32(stco.data+8+4*chunk);
+    for(unsigned int i=0; i<perChunk && m_samples.size()<numSamples; i++) {
+      Sample s;
+      s.offset=offset;
+      s.size=samplesize?samplesize:be32(stsz.data+12+4*m_samples.size());
+      total+=s.size;
+      if(!s.size || offset>filesize || s.size>filesize-offset
+          || total>filesize) {
+        valid=false;
+        break;
+      }
+      m_samples.push_back(s);
+      offset+=s.size;
+    }
+  }
+  if(!valid) {
+    verbose(0, "[GEM:filmHAP] broken sample table, ignoring frames from #%d on",
+            static_cast<int>(m_samples.size()));
+  }
+  if(m_samples.empty()) {
+    close();
+    return false;
+  }
+
+  double d;
+  if(wantProps.get("threads", d) && d>=0) {
+    m_pool.setThreads(static_cast<unsigned int>(d));
+  }
+
+  m_image.image.xsize=m_width;
+  m_image.image.ysize=m_height;
+  changeImage(0, -1);
+  m_newfilm=true;
+  return true;
+}
+
+/////////////////////////////////////////////////////////
+// decode a frame
+//
+/////////////////////////////////////////////////////////
+bool filmHAP :: decode(const unsigned char*data, size_t size)
+{
+  size_t header, length;
+  unsigned int type;
+  if(!readSection(data, size, header, length, type)) {
+    return false;
+  }
+  const unsigned int format=textureFormat(type);
+  if(!format) {
+    verbose(1, "[GEM:filmHAP] unsupported section type 0x%02X", type);
+    return false;
+  }
+  data+=header;
+  size=length;
+
+  std::vector<Chunk>chunks;
+  switch(type>>4) {
+  case 0xA:
+  case 0xB:
+    chunks.resize(1);
+    chunks[0].src=data;
+    chunks[0].srcsize=size;
+    chunks[0].snappy=(0xB == (type>>4));
+    break;
+  case 0xC:
+    if(!readChunks(data, size, chunks)) {
+      verbose(1, "[GEM:filmHAP] invalid decode instructions");
+      return false;
+    }
+    break;
+  default:
+    return false;
+  }
+
+  imageStruct&img=m_image.image;
+  img.xsize=m_width;
+  img.ysize=m_height;
+  img.setCsizeByFormat(format);
+  img.upsidedown=true;
+  img.reallocate();
+
+  /* the chunks are placed one after the other in the texture */
+  const size_t datasize=img.getDataSize();
+  size_t offset=0;
+  for(unsigned int i=0; i<chunks.size(); i++) {
+    Chunk&c=chunks[i];
+    size_t varint;
+    if(!c.snappy) {
+      c.size=c.srcsize;
+    } else if(!snappyLength(c.src, c.srcsize, c.size, varint)) {
+      return false;
+    }
+    if(c.size>datasize-offset) {
+      return false;
+    }
+    c.offset=offset;
+    offset+=c.size;
+  }
+  if(offset != datasize) {
+    return false;
+  }
+
+  ChunkJob job(chunks, img.data);
+  unsigned int numSlices=m_pool.getThreads();
+  if(numSlices>chunks.size()) {
+    numSlices=chunks.size();
+  }
+  if(numSlices<2) {
+    job.run(0, chunks.size());
+  } else {
+    m_pool.run(job, numSlices);
+  }
+  return job.ok();
+}
+
+/////////////////////////////////////////////////////////
+// render
+//
+/////////////////////////////////////////////////////////
+pixBlock* filmHAP :: getFrame(void)
+{
+  if (!m_readNext) {
+    return &m_image;
+  }
+  m_readNext = false;
+
+  if(!m_file || m_curFrame<0
+      || static_cast<unsigned int>(m_curFrame)>=m_samples.size()) {
+    return 0;
+  }
+  const Sample&s=m_samples[m_curFrame];
+  m_frame.resize(s.size);
+  if(!s.size || !seekTo(m_file, s.offset)
+      || fread(&m_frame[0], 1, s.size, m_file) != s.size) {
+    pd_error(0, "[GEM:filmHAP] could not read frame %d", m_curFrame);
+    return 0;
+  }
+  if(!decode(&m_frame[0], s.size)) {
+    pd_error(0, "[GEM:filmHAP] could not decode frame %d", m_curFrame);
+    return 0;
+  }
+
+  if(m_newfilm) {
+    m_image.newfilm=1;
+  }
+  m_newfilm=false;
+  m_image.newimage=1;
+  return &m_image;
+}
+
+film::errCode filmHAP :: changeImage(int imgNum, int trackNum)
+{
+  if (imgNum  ==-1) {
+    imgNum=m_curFrame;
+  }
+  if (imgNum<0 || static_cast<unsigned int>(imgNum)>=m_samples.size()) {
+    return film::FAILURE;
+  }
+  if (imgNum != m_curFrame) {
+    m_readNext = true;
+  }
+  m_curFrame=imgNum;
+  return film::SUCCESS;
+}
+
+
+///////////////////////////////
+// Properties
+bool filmHAP::enumProperties(gem::Properties&readable,
+                             gem::Properties&writeable)
+{
+  readable.clear();
+  writeable.clear();
+
+  gem::any value;
+  value=0.;
+  readable.set("fps", value);
+  readable.set("frames", value);
+  readable.set("width", value);
+  readable.set("height", value);
+
+  writeable.set("threads", value);
+
+  return true;
+}
+
+void filmHAP::setProperties(gem::Properties&props)
+{
+  double d;
+  if(props.get("threads", d) && d>=0) {
+    m_pool.setThreads(static_cast<unsigned int>(d));
+  }
+}
+
+void filmHAP::getProperties(gem::Properties&props)
+{
+  std::vector<std::string> keys=props.keys();
+  for(unsigned i=0; i<keys.size(); i++) {
+    gem::any value;
+    double d;
+    std::string key=keys[i];
+    props.erase(key);
+    if("fps"==key && m_fps>0) {
+      d=m_fps;
+      value=d;
+      props.set(key, value);
+    }
+    if("frames"==key) {
+      d=m_samples.size();
+      value=d;
+      props.set(key, value);
+    }
+    if("width"==key) {
+      d=m_width;
+      value=d;
+      props.set(key, value);
+    }
+    if("height"==key) {
+      d=m_height;
+      value=d;
+      props.set(key, value);
+    }
+  }
+}
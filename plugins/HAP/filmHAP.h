@@ -0,0 +1,116 @@
+/*-----------------------------------------------------------------
+
+GEM - Graphics Environment for Multimedia
+
+Load HAP encoded movies (HAP, HAP Alpha, HAP Q, HAP R) into a pix block
+
+Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+For information on usage and redistribution, and for a DISCLAIMER OF ALL
+WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE_GEMPLUGIN__FILMHAP_FILMHAP_H_
+#define _INCLUDE_GEMPLUGIN__FILMHAP_FILMHAP_H_
+#include "plugins/film.h"
+#include "Gem/Image.h"
+#include "Utils/ThreadPool.h"
+#include <stdio.h>
+#include <vector>
+
+/*-----------------------------------------------------------------
+  -------------------------------------------------------------------
+  CLASS
+  filmHAP
+
+  Loads in a HAP film
+
+  KEYWORDS
+  pix
+
+  DESCRIPTION
+
+  HAP frames are block compressed textures, wrapped in (optional) Snappy
+  compression: only the Snappy layer is undone here, and the frames are
+  returned as GEM_BC1 (HAP), GEM_BC3 (HAP Alpha), GEM_BC3_YCOCG (HAP Q)
+  or GEM_BC7 (HAP R) images, that [pix_texture] uploads as they are
+
+  frames that are split into chunks are decompressed in parallel
+
+  the movies are read from QuickTime (.mov) files with a single HAP track;
+  HAP Q Alpha and HAP Alpha-Only are not supported
+
+  -----------------------------------------------------------------*/
+namespace gem
+{
+namespace plugins
+{
+class GEM_EXPORT filmHAP : public film
+{
+public:
+
+  //////////
+  // Constructor
+  filmHAP(void);
+
+  //////////
+  // Destructor
+  virtual ~filmHAP(void);
+
+  //////////
+  // open a movie up
+  virtual bool open(const std::string&filename, const gem::Properties&);
+  //////////
+  // close the movie file
+  virtual void close(void);
+
+  //////////
+  // get the next frame
+  virtual pixBlock* getFrame(void);
+
+  //////////
+  // set the next frame to read;
+  virtual errCode changeImage(int imgNum, int trackNum = -1);
+
+  // we only use our own file handle
+  virtual bool isThreadable(void)
+  {
+    return true;
+  }
+
+  // Property handling
+  virtual bool enumProperties(gem::Properties&readable,
+                              gem::Properties&writeable);
+  virtual void setProperties(gem::Properties&props);
+  virtual void getProperties(gem::Properties&props);
+
+  //-----------------------------------
+  // GROUP:     Movie data
+  //-----------------------------------
+protected:
+  /* where to find a frame in the file */
+  struct Sample {
+    unsigned long long offset;
+    unsigned int size;
+  };
+  std::vector<Sample>m_samples;
+
+  FILE*m_file;
+  unsigned int m_width, m_height;
+  double m_fps;
+  int m_curFrame;
+  bool m_readNext;
+  bool m_newfilm;
+
+  pixBlock m_image; // output image
+  std::vector<unsigned char>m_frame; // the compressed frame
+
+  gem::thread::ThreadPool m_pool;
+
+  bool decode(const unsigned char*data, size_t size);
+};
+};
+};
+
+#endif  // for header file
@@ -147,17 +147,38 @@ bool imageJPEG :: load(std::string filename, imageStruct&result,
   // read in the file info
   jpeg_read_header(&cinfo, TRUE);
 
+  // if the caller needs less, let the IDCT do the downscaling (1/2, 1/4, 1/8)
+  double minwidth=0, minheight=0;
+  props.get("minwidth", minwidth);
+  props.get("minheight", minheight);
+  if(minwidth>0 || minheight>0) {
+    unsigned int denom=8;
+    while(denom>1
+          && (cinfo.image_width /denom < minwidth
+              || cinfo.image_height/denom < minheight)) {
+      denom/=2;
+    }
+    cinfo.scale_num=1;
+    cinfo.scale_denom=denom;
+    props.set("imagewidth",  (double)cinfo.image_width);
+    props.set("imageheight", (double)cinfo.image_height);
+  }
 
-  // do we have an RGB image?
-  if (cinfo.jpeg_color_space == JCS_RGB) {
-    result.setCsizeByFormat(GEM_RGBA);
-  } else if (cinfo.jpeg_color_space == JCS_GRAYSCALE) {
-    // do we have a gray8 image?
+  // do we have a gray8 image?
+  if (cinfo.jpeg_color_space == JCS_GRAYSCALE) {
     result.setCsizeByFormat(GEM_GRAY);
   } else {
     // something else, so decompress as RGB
     result.setCsizeByFormat(GEM_RGBA);
     cinfo.out_color_space = JCS_RGB;
+#ifdef JCS_EXTENSIONS
+    // libjpeg-turbo can write our RGBA layout (with opaque alpha) itself
+# ifdef __APPLE__
+    cinfo.out_color_space = JCS_EXT_ARGB;
+# else
+    cinfo.out_color_space = JCS_EXT_RGBA;
+# endif
+#endif
   }
 
   // start the decompression
@@ -170,20 +191,31 @@ bool imageJPEG :: load(std::string filename, imageStruct&result,
   result.ysize = ySize;
   result.reallocate();
 
-  // cycle through the scan lines
-  unsigned char *srcLine = new unsigned char[xSize * cSize];
-  unsigned char *dstLine = result.data;
   int yStride = xSize * cSize;
-  int lines = ySize;
-  int pixes = xSize;
 
-  // do RGBA/RGB data
-  if (cSize == 4) {
+  if (cinfo.output_components == cSize) {
+    // decode straight into the image
+    JSAMPROW rows[16];
+    while (cinfo.output_scanline < cinfo.output_height) {
+      JDIMENSION count=cinfo.output_height - cinfo.output_scanline;
+      if(count>16) {
+        count=16;
+      }
+      for (JDIMENSION i=0; i<count; i++) {
+        rows[i]=result.data + (cinfo.output_scanline + i) * yStride;
+      }
+      jpeg_read_scanlines(&cinfo, rows, count);
+    }
+  } else {
+    // do RGB data
+    unsigned char *srcLine = new unsigned char[xSize * cinfo.output_components];
+    unsigned char *dstLine = result.data;
+    int lines = ySize;
     while (lines--) {
       unsigned char *src = srcLine;
       unsigned char *dst = dstLine;
       jpeg_read_scanlines(&cinfo, &src, 1);
-      pixes = xSize;
+      int pixes = xSize;
       while (pixes--) {
         dst[chRed]   = src[0];
         dst[chGreen] = src[1];
@@ -194,18 +226,7 @@ bool imageJPEG :: load(std::string filename, imageStruct&result,
       }
       dstLine += yStride;
     }
-  } else {
-    // do grayscale data
-    while (lines--) {
-      unsigned char *src = srcLine;
-      unsigned char *dst = dstLine;
-      jpeg_read_scanlines(&cinfo, &src, 1);
-      pixes = xSize;
-      while (pixes--) {
-        *dst++ = *src++;
-      }
-      dstLine += yStride;
-    }
+    delete [] srcLine;
   }
 
   // finish the decompression
@@ -214,7 +235,6 @@ bool imageJPEG :: load(std::string filename, imageStruct&result,
   // cleanup
   jpeg_destroy_decompress(&cinfo);
   fclose(infile);
-  delete [] srcLine;
 
   return true;
 }
@@ -62,7 +62,13 @@ bool imageSTB :: load(std::string filename, imageStruct&result,
                       gem::Properties&props)
 {
   int xsize, ysize, csize;
-  unsigned char *data = stbi_load(filename.c_str(), &xsize, &ysize, &csize, 4);
+  /* grayscale images stay grayscale */
+  int channels=4;
+  if(stbi_info(filename.c_str(), &xsize, &ysize, &csize) && 1==csize) {
+    channels=1;
+  }
+  unsigned char *data = stbi_load(filename.c_str(), &xsize, &ysize, &csize,
+                                  channels);
 
   if(!data) {
     return(false);
@@ -70,15 +76,26 @@ bool imageSTB :: load(std::string filename, imageStruct&result,
 
   result.xsize=xsize;
   result.ysize=ysize;
-  result.setCsizeByFormat(GEM_RGBA);
+  result.setCsizeByFormat((1==channels)?GEM_GRAY:GEM_RGBA);
   result.reallocate();
 
-#ifdef __APPLE__
-  result.fromARGB(data);
-  result.swapRedBlue();
-#else
-  result.fromRGBA(data);
-#endif
+  /* stb_image allocates its own buffer,
+   * so the best we can do is a single pass into our layout */
+  const size_t pixels=static_cast<size_t>(xsize)*ysize;
+  if(1==channels || (0==chRed && 1==chGreen && 2==chBlue && 3==chAlpha)) {
+    memcpy(result.data, data, pixels*result.csize);
+  } else {
+    const unsigned char*src=data;
+    unsigned char*dst=result.data;
+    for(size_t i=0; i<pixels; i++) {
+      dst[chRed]   = src[0];
+      dst[chGreen] = src[1];
+      dst[chBlue]  = src[2];
+      dst[chAlpha] = src[3];
+      dst+=4;
+      src+=4;
+    }
+  }
 
   stbi_image_free(data);
   return true;
@@ -175,16 +175,23 @@ bool imageTIFF :: load(std::string filename, imageStruct&result,
     result.reallocate();
     unsigned char *dstLine = result.data;
     int yStride = result.xsize * result.csize;
+    /* if the scanlines are already in our layout, read them in place */
+    const bool direct = (TIFFScanlineSize(tif) == yStride)
+                        && (samps == 1
+                            || (samps == 4 && 0==chRed && 1==chGreen
+                                && 2==chBlue && 3==chAlpha));
     for (uint32_t row = 0; row < height; row++) {
       unsigned char *pixels = dstLine;
-      if (TIFFReadScanline(tif, buf, row, 0) < 0) {
+      if (TIFFReadScanline(tif, direct?dstLine:buf, row, 0) < 0) {
         verbose(1, "[GEM:imageTIFF] bad image data read on line: %d: %s", row,
                 filename.c_str());
         TIFFClose(tif);
         return false;
       }
       unsigned char *inp = buf;
-      if (samps == 1) {
+      if (direct) {
+        // nothing to do
+      } else if (samps == 1) {
         for (uint32_t i = 0; i < width; i++) {
           *pixels++ = *inp++;         // Gray8
         }
@@ -223,8 +230,18 @@ bool imageTIFF :: load(std::string filename, imageStruct&result,
       return false;
     }
 
-    uint32_t*raster = reinterpret_cast<uint32_t*>(_TIFFmalloc(npixels * sizeof(
-                      uint32_t)));
+    result.setCsizeByFormat(GEM_RGBA);
+    result.reallocate();
+
+    /* the raster holds ABGR words, which are RGBA bytes on little endian
+     * machines: if that is our layout, decode straight into the image */
+    const uint32_t endian=1;
+    const bool direct=(1==*reinterpret_cast<const unsigned char*>(&endian))
+                      && (0==chRed && 1==chGreen && 2==chBlue && 3==chAlpha);
+
+    uint32_t*raster = direct?reinterpret_cast<uint32_t*>(result.data)
+                      :reinterpret_cast<uint32_t*>(_TIFFmalloc(npixels * sizeof(
+                            uint32_t)));
     if (raster == NULL) {
       pd_error(0, "[GEM:imageTIFF] Unable to allocate memory for image '%s'",
                filename.c_str());
@@ -236,33 +253,35 @@ bool imageTIFF :: load(std::string filename, imageStruct&result,
     if (TIFFRGBAImageGet(&img, raster, width, height) == 0) {
       verbose(0, "[GEM:imageTIFF] Error getting image data in file '%s': %s",
               filename.c_str(), emsg);
-      _TIFFfree(raster);
+      if(!direct) {
+        _TIFFfree(raster);
+      }
       TIFFClose(tif);
       tiffhandlers_cleanup();
       return false;
     }
 
     TIFFRGBAImageEnd(&img);
-    result.setCsizeByFormat(GEM_RGBA);
-    result.reallocate();
 
-    unsigned char *dstLine = result.data;
-    int yStride = result.xsize * result.csize;
-    // transfer everything over
-    int k = 0;
-    for (uint32_t i = 0; i < height; i++) {
-      unsigned char *pixels = dstLine;
-      for (uint32_t j = 0; j < width; j++) {
-        pixels[chRed]   = static_cast<unsigned char>(TIFFGetR(raster[k])); // Red
-        pixels[chGreen] = static_cast<unsigned char>(TIFFGetG(raster[k])); // Green
-        pixels[chBlue]  = static_cast<unsigned char>(TIFFGetB(raster[k])); // Blue
-        pixels[chAlpha] = static_cast<unsigned char>(TIFFGetA(raster[k])); // Alpha
-        k++;
-        pixels += 4;
+    if(!direct) {
+      unsigned char *dstLine = result.data;
+      int yStride = result.xsize * result.csize;
+      // transfer everything over
+      int k = 0;
+      for (uint32_t i = 0; i < height; i++) {
+        unsigned char *pixels = dstLine;
+        for (uint32_t j = 0; j < width; j++) {
+          pixels[chRed]   = static_cast<unsigned char>(TIFFGetR(raster[k])); // Red
+          pixels[chGreen] = static_cast<unsigned char>(TIFFGetG(raster[k])); // Green
+          pixels[chBlue]  = static_cast<unsigned char>(TIFFGetB(raster[k])); // Blue
+          pixels[chAlpha] = static_cast<unsigned char>(TIFFGetA(raster[k])); // Alpha
+          k++;
+          pixels += 4;
+        }
+        dstLine += yStride;
       }
-      dstLine += yStride;
+      _TIFFfree(raster);
     }
-    _TIFFfree(raster);
   }
 
   result.fixUpDown();
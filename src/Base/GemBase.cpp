@@ -59,6 +59,7 @@
 
 #include "GemBase.h"
 #include "Gem/Cache.h"
+#include "Gem/ModelView.h"
 
 /////////////////////////////////////////////////////////
 //
@@ -70,7 +71,7 @@
 /////////////////////////////////////////////////////////
 GemBase :: GemBase(void)
   : gem_amRendering(false), m_cache(NULL), m_modified(true),
-    m_out1(NULL),
+    m_out1(NULL), m_onlyTransforms(false),
     m_enabled(true), m_state(INIT)
 {
   m_out1 = outlet_new(this->x_obj, 0);
@@ -156,10 +157,16 @@ void GemBase :: gem_renderMess(GemCache* cache, GemState*state)
   if(RENDERING==m_state) {
     gem_amRendering=true;
     if(state) {
+      if(!m_onlyTransforms) {
+        gem::ModelView::flush();
+      }
       render(state);
     }
     continueRender(state);
     if(state) {
+      if(!m_onlyTransforms) {
+        gem::ModelView::flush();
+      }
       postrender(state);
     }
   }
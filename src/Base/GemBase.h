@@ -93,6 +93,12 @@ protected:
   // The outlet
   t_outlet      *m_out1;
 
+  //////////
+  // set this to true if the object does nothing but transforming the
+  // modelview matrix via gem::ModelView
+  // (else any pending transformations are applied before render())
+  bool             m_onlyTransforms;
+
 
   //////////
   // this gets called in the before the startRendering() routine
@@ -78,6 +78,16 @@ void GemGluObj :: numSlicesMess(int numSlices, int numStacks)
   setModified();
 }
 
+/////////////////////////////////////////////////////////
+// meshParams
+//
+/////////////////////////////////////////////////////////
+void GemGluObj :: meshParams(std::vector<float>&params)
+{
+  params.push_back(m_numSlices);
+  params.push_back(m_numStacks);
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
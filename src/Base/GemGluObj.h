@@ -71,6 +71,10 @@ protected:
   // The number of slices
   int             m_numSlices, m_numStacks;
 
+  //////////
+  // the geometry depends on the number of slices
+  virtual void    meshParams(std::vector<float>&params);
+
   //////////
   t_inlet         *m_sliceInlet;
 
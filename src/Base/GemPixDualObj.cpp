@@ -20,6 +20,7 @@
 
 #include "Gem/Cache.h"
 #include "Gem/State.h"
+#include "Gem/ImageGPU.h"
 #include "Utils/Functions.h"
 
 #include <string.h>
@@ -149,6 +150,18 @@ void GemPixDualObj :: processImage(imageStruct &image)
     return;
   }
 
+  if(m_pixRight->texture) {
+    // the right image is texture-resident: read it back into host memory
+    if(!gem::image::GPUFilter::download(*m_pixRight, m_pixRightHost.image)) {
+      error("unable to read back texture-resident image");
+      m_pixRightValid = 0;
+      return;
+    }
+    m_pixRightHost.newimage = m_pixRight->newimage;
+    m_pixRightHost.newfilm  = m_pixRight->newfilm;
+    m_pixRight = &m_pixRightHost;
+  }
+
   if(image.upsidedown != m_pixRight->image.upsidedown) {
     image.fixUpDown();
     m_pixRight->image.fixUpDown();
@@ -180,6 +193,40 @@ void GemPixDualObj :: processImage(imageStruct &image)
   }
 }
 
+/////////////////////////////////////////////////////////
+// processTexture
+//
+/////////////////////////////////////////////////////////
+bool GemPixDualObj :: processTexture(pixBlock &image)
+{
+  if (!m_cacheRight || m_cacheRight->m_magic!=GEMCACHE_MAGIC) {
+    m_cacheRight=NULL;
+    return true;
+  }
+  if (!m_pixRightValid || !m_pixRight) {
+    return true;
+  }
+
+  if (image.image.xsize != m_pixRight->image.xsize ||
+      image.image.ysize != m_pixRight->image.ysize)    {
+    error("two images do not have equal dimensions (%dx%d != %dx%d)",
+          image.image.xsize, image.image.ysize,
+          m_pixRight->image.xsize, m_pixRight->image.ysize);
+    m_pixRightValid = 0;
+    return true;
+  }
+
+  // if the right image lives in host memory, we combine them on the CPU
+  if (!m_pixRight->texture) {
+    return false;
+  }
+  return processDualTexture(image, *m_pixRight);
+}
+bool GemPixDualObj :: processDualTexture(pixBlock &image, pixBlock &right)
+{
+  return false;
+}
+
 /////////////////////////////////////////////////////////
 // process
 //
@@ -56,6 +56,20 @@ protected:
   // This calls the other process functions based on the input images.
   virtual void    processImage(imageStruct &image);
 
+  //////////
+  // Derived classes should NOT override this!
+  // This makes sure that the images are the same size and both texture-resident.
+  // This calls processDualTexture()
+  virtual bool    processTexture(pixBlock &image);
+
+  //////////
+  // The derived class CAN override this.
+  // This is called whenever a new image comes through and both
+  //              images are texture-resident.
+  // Return false if the images cannot be combined on the GPU.
+  // The default is to return false.
+  virtual bool    processDualTexture(pixBlock &image, pixBlock &right);
+
 #ifndef NEW_DUAL_PIX
   //////////
   // The derived class HAS override this.
@@ -167,6 +181,8 @@ protected:
 
   //////////
   pixBlock        *m_pixRight;
+  // host copy of a texture-resident right image
+  pixBlock        m_pixRightHost;
 
   int             m_pixRightValid;
   int             org_pixRightValid;
@@ -19,8 +19,26 @@
 #include "Gem/Cache.h"
 #include "Gem/State.h"
 #include "Gem/Rectangle.h"
+#include "Gem/ImageGPU.h"
 #include "Utils/Functions.h"
 
+namespace
+{
+/* copy the meta-data of a texture-resident image */
+void copyTextureInfo(const pixBlock&from, pixBlock&to)
+{
+  to.image.xsize      = from.image.xsize;
+  to.image.ysize      = from.image.ysize;
+  to.image.csize      = from.image.csize;
+  to.image.format     = from.image.format;
+  to.image.type       = from.image.type;
+  to.image.upsidedown = from.image.upsidedown;
+  to.image.data       = NULL;
+  to.texture          = from.texture;
+  to.textureTarget    = from.textureTarget;
+}
+};
+
 /////////////////////////////////////////////////////////
 //
 // GemPixObj
@@ -85,9 +103,34 @@ void GemPixObj :: render(GemState *state)
     cachedPixBlock.newimage = image->newimage;
     cachedPixBlock.newfilm =
       image->newfilm; //added for newfilm copy from cache cgc 6-21-03
-    image->image.copy2ImageStruct(&cachedPixBlock.image);
+    bool needsProcessing = m_processOnOff;
+    if(image->texture) {
+      // a texture-resident image: process it on the GPU if possible,
+      // else read it back into host memory
+      copyTextureInfo(*image, cachedPixBlock);
+      if(needsProcessing && !processTexture(cachedPixBlock)) {
+        if(!gem::image::GPUFilter::download(*image, cachedPixBlock.image)) {
+          error("unable to read back texture-resident image");
+          return;
+        }
+        cachedPixBlock.texture = 0;
+        cachedPixBlock.textureTarget = 0;
+      } else {
+        needsProcessing = false;
+      }
+    } else {
+      cachedPixBlock.texture = 0;
+      cachedPixBlock.textureTarget = 0;
+      if(needsProcessing && image->readonly) {
+        // we must not process a shared image in place
+        image->image.copy2Image(&cachedPixBlock.image);
+      } else {
+        image->image.copy2ImageStruct(&cachedPixBlock.image);
+      }
+    }
+    cachedPixBlock.readonly = image->readonly && !needsProcessing;
     image = &cachedPixBlock;
-    if (m_processOnOff) {
+    if (needsProcessing) {
       switch (image->image.type) {
       case GL_FLOAT:
         processFloat32(image->image);
@@ -233,6 +276,12 @@ void GemPixObj :: processFloat64(imageStruct &image)
 }
 
 
+bool GemPixObj :: processTexture(pixBlock &image)
+{
+  return false;
+}
+
+
 /////////////////////////////////////////////////////////
 // processImage (typed)
 //
@@ -99,6 +99,15 @@ protected:
   virtual void  processFloat32(imageStruct &image);
   virtual void  processFloat64(imageStruct &image);
 
+  //////////
+  // The derived class should override this if it can process
+  // texture-resident images on the GPU (see gem::image::GPUFilter).
+  // This is called whenever a new texture-resident image comes through.
+  // Return false if the image cannot be processed on the GPU;
+  // it is then read back into host memory and processed as usual.
+  // The default is to return false.
+  virtual bool  processTexture(pixBlock &image);
+
 
   //////////
   // If the derived class needs the image resent.
@@ -17,7 +17,10 @@
 
 #include "GemShape.h"
 #include "Gem/State.h"
+#include "Gem/Mesh.h"
+#include "Gem/Instances.h"
 #include <algorithm>
+#include <typeinfo>
 
 /////////////////////////////////////////////////////////
 //
@@ -68,15 +71,48 @@ static void initialize_drawtypes(std::map<std::string, GLenum>&drawtypes)
   drawtypes["fill"]=GL_POLYGON;
 }
 
+/* passes the geometry on to another builder, scaling the vertices */
+class ScaledMesh : public gem::MeshBuilder
+{
+public:
+  ScaledMesh(gem::MeshBuilder&builder, float sx, float sy, float sz)
+    : m_builder(builder), m_sx(sx), m_sy(sy), m_sz(sz)
+  { }
+  virtual void begin(GLenum mode)
+  {
+    m_builder.begin(mode);
+  }
+  virtual void end(void)
+  {
+    m_builder.end();
+  }
+  virtual void normal(float x, float y, float z)
+  {
+    m_builder.normal(x, y, z);
+  }
+  virtual void texcoord(float s, float t)
+  {
+    m_builder.texcoord(s, t);
+  }
+  virtual void vertex(float x, float y, float z)
+  {
+    m_builder.vertex(x*m_sx, y*m_sy, z*m_sz);
+  }
+private:
+  gem::MeshBuilder&m_builder;
+  float m_sx, m_sy, m_sz;
+};
+
 }
 
 GemShape :: GemShape(t_floatarg size)
   : m_linewidth(1.0f), m_size((float)size), m_drawType(GL_DEFAULT_GEM),
-    m_blend(0),
+    m_blend(0), m_retained(true),
     m_inlet(NULL),
     m_texType(0), m_texNum(0),
     m_texCoords(NULL),
-    m_lighting(false)
+    m_lighting(false),
+    m_mesh(NULL)
 {
   if (m_size == 0.f) {
     m_size = 1.f;
@@ -90,10 +126,12 @@ GemShape :: GemShape(t_floatarg size)
 }
 GemShape :: GemShape()
   : m_linewidth(1.0f), m_size(1.0f), m_drawType(GL_DEFAULT_GEM), m_blend(0),
+    m_retained(true),
     m_inlet(NULL),
     m_texType(0), m_texNum(0),
     m_texCoords(NULL),
-    m_lighting(false)
+    m_lighting(false),
+    m_mesh(NULL)
 {
   // no size inlet
   initialize_drawtypes(m_drawTypes);
@@ -108,6 +146,7 @@ GemShape :: ~GemShape()
   if(m_inlet) {
     inlet_free(m_inlet);
   }
+  gem::Mesh::release(m_mesh);
 }
 
 /////////////////////////////////////////////////////////
@@ -225,6 +264,117 @@ void GemShape :: blendMess(float blend)
   setModified();
 }
 
+/////////////////////////////////////////////////////////
+// retainedMess
+//
+/////////////////////////////////////////////////////////
+void GemShape :: retainedMess(bool retained)
+{
+  m_retained = retained;
+  setModified();
+}
+
+/////////////////////////////////////////////////////////
+// meshes
+//
+/////////////////////////////////////////////////////////
+void GemShape :: meshScale(float&x, float&y, float&z)
+{
+  x=y=z=m_size;
+}
+void GemShape :: meshKey(std::vector<float>&key, bool sized)
+{
+  key.clear();
+  key.push_back(m_drawType);
+  key.push_back(m_texType);
+  key.push_back(m_texNum);
+  if(m_texType && m_texCoords) {
+    for(int i=0; i<m_texNum; i++) {
+      key.push_back(m_texCoords[i].s);
+      key.push_back(m_texCoords[i].t);
+    }
+  }
+  meshParams(key);
+  if(sized) {
+    float sx, sy, sz;
+    meshScale(sx, sy, sz);
+    key.push_back(sx);
+    key.push_back(sy);
+    key.push_back(sz);
+  }
+}
+
+void GemShape :: renderShape(GemState *state)
+{
+  float sx, sy, sz;
+  meshScale(sx, sy, sz);
+
+  /* the instance transformations are applied to the scaled shape,
+   * so instanced meshes are built with the scale applied */
+  gem::Instances*instances=NULL;
+  state->get(GemState::_GL_INSTANCES, instances);
+  const bool instanced=(NULL!=instances);
+  /* the retained mesh has unit size and is scaled with glScalef();
+   * mirrored or collapsed shapes would get flipped (or no) normals that way,
+   * so they are drawn in immediate mode */
+  const bool scalable=(sx>0.f && sy>0.f && sz>0.f);
+
+  if((m_retained && scalable) || instanced) {
+    std::vector<float>key;
+    meshKey(key, instanced);
+    if(key!=m_meshKey && !instanced) {
+      /* the geometry has changed; if it keeps changing (e.g. because
+       * a parameter is animated), caching it would only slow us down,
+       * so we draw in immediate mode until it settles */
+      gem::Mesh::release(m_mesh);
+      m_mesh=NULL;
+      m_meshKey=key;
+    } else if(!m_mesh || key!=m_meshKey) {
+      /* instances can only be drawn from a mesh */
+      gem::Mesh::release(m_mesh);
+      m_mesh=gem::Mesh::acquire(typeid(*this).name(), key);
+      if(m_mesh->empty()) {
+        if(instanced) {
+          ScaledMesh scaled(*m_mesh, sx, sy, sz);
+          buildMesh(state, scaled);
+        } else {
+          buildMesh(state, *m_mesh);
+        }
+        m_mesh->finish();
+      }
+      /* building the mesh might have resolved the 'default' drawtype */
+      meshKey(m_meshKey, instanced);
+    }
+    if(m_mesh && m_mesh->isValid()) {
+      if(instanced) {
+        m_mesh->draw(instances);
+      } else {
+        /* the mesh has unit size: the scaling must not affect the lighting */
+        const bool scaled=(m_lighting && (sx!=1.f || sy!=1.f || sz!=1.f));
+        if(scaled) {
+          glPushAttrib(GL_ENABLE_BIT);
+          if(sx==sy && sy==sz && GLEW_VERSION_1_2) {
+            glEnable(GL_RESCALE_NORMAL);
+          } else {
+            glEnable(GL_NORMALIZE);
+          }
+        }
+        glPushMatrix();
+        glScalef(sx, sy, sz);
+        m_mesh->draw();
+        glPopMatrix();
+        if(scaled) {
+          glPopAttrib();
+        }
+      }
+      return;
+    }
+  }
+
+  gem::ImmediateMesh mesh(sx, sy, sz);
+  buildMesh(state, mesh);
+}
+
 void GemShape :: render(GemState *state)
 {
   if (m_drawType == GL_LINE_LOOP
@@ -275,5 +425,6 @@ void GemShape :: obj_setupCallback(t_class *classPtr)
   CPPEXTERN_MSG1(classPtr, "width", linewidthMess, float);
   CPPEXTERN_MSG1(classPtr, "draw", typeMess, t_symbol*);
   CPPEXTERN_MSG1(classPtr, "blend", blendMess, float);
+  CPPEXTERN_MSG1(classPtr, "retained", retainedMess, bool);
   CPPEXTERN_MSG1(classPtr, "ft1", sizeMess, float);
 }
@@ -18,6 +18,7 @@
 #include "Base/GemBase.h"
 #include "Gem/GemGL.h"
 #include <map>
+#include <vector>
 /*-----------------------------------------------------------------
   -------------------------------------------------------------------
   CLASS
@@ -32,9 +33,17 @@
   "ft1" - the size of the shape
   "draw" - the drawing style
   "width" - the line width when drawing with lines
+  "retained" - draw the shape from a (shared) vertex buffer (default)
+               rather than in immediate mode
+               (below a [gem_instances], shapes are always retained)
 
   -----------------------------------------------------------------*/
 class TexCoord;
+namespace gem
+{
+class Mesh;
+class MeshBuilder;
+};
 class GEM_EXTERN GemShape : public GemBase
 {
 public:
@@ -100,10 +109,27 @@ protected:
   GLboolean             m_blend;
   void  blendMess(float blend);
 
+  //////////
+  // do we want to draw from a vertex buffer?
+  bool                  m_retained;
+  void  retainedMess(bool retained);
+
 
   ////////
   // override this memberfunction to automatically enable softblended rendering,...
-  virtual void renderShape(GemState *state) {;}
+  // (by default, this draws the geometry described by buildMesh())
+  virtual void renderShape(GemState *state);
+
+  ////////
+  // OR override this memberfunction to describe the geometry (at unit size)
+  // it is generated only once and then drawn from a vertex buffer
+  // that is shared by all shapes with the same parameters
+  virtual void buildMesh(GemState *state, gem::MeshBuilder&mesh) {;}
+  // the parameters the geometry depends on
+  // (besides the drawing style and the texture coordinates)
+  virtual void meshParams(std::vector<float>&params) {;}
+  // the size of the geometry
+  virtual void meshScale(float&x, float&y, float&z);
 
   // OR
   // override this memberfunction if you don't want softblending
@@ -142,6 +168,11 @@ protected:
   TexCoord*m_texCoords;
   bool m_lighting;
 
+  gem::Mesh*m_mesh;
+  std::vector<float>m_meshKey;
+  /* 'sized' meshes have the scale applied to their vertices */
+  void meshKey(std::vector<float>&key, bool sized=false);
+
   std::map<std::string, GLenum>m_drawTypes;
 };
 
@@ -23,6 +23,8 @@
 #include <set>
 #include <sstream>
 
+#include <pthread.h>
+
 namespace
 {
 bool sendContextDestroyedMsg(t_pd*x)
@@ -49,13 +51,26 @@ public:
     , dispatchClock(0)
     , dispatchTime(10.)
     , qClock(0)
+    , threaded(false)
+    , presenting(false)
+    , presentPending(false)
+    , presentQuit(false)
+    , handedOff(false)
   {
+    int i=0;
+    gem::Settings::get("window.threaded", i);
+    threaded=(i!=0);
+    pthread_mutex_init(&presentMutex, 0);
+    pthread_cond_init (&presentCond, 0);
     qClock=clock_new(this, reinterpret_cast<t_method>(qCallBack));
     dispatchClock=clock_new(this,
                             reinterpret_cast<t_method>(dispatchCallBack));
   }
   ~PIMPL(void)
   {
+    stopPresenter();
+    pthread_cond_destroy (&presentCond);
+    pthread_mutex_destroy(&presentMutex);
     if(qClock) {
       clock_free (qClock);
     }
@@ -162,6 +177,115 @@ public:
   }
 
   static std::set<GemWindow*>s_contexts;
+
+  /*
+   * threaded swap: presenting frames in a separate thread
+   *
+   * only the buffer swap is threaded: the chain is still traversed
+   * (and all GL commands are issued) in Pd's thread, as Pd objects are not
+   * thread-safe; swapping the buffers (which blocks until the
+   * vertical sync) is handed over to a per-window thread.
+   * that way, multiple windows no longer wait for each other's vsync,
+   * and Pd can already run the rest of the scheduler tick while frame #N
+   * is being presented.
+   * before frame #N+1 is rendered, the context is handed back
+   * (waiting for the presentation of frame #N if needed)
+   */
+  bool threaded;
+  bool presenting;
+  pthread_t presenter;
+  pthread_mutex_t presentMutex;
+  pthread_cond_t presentCond;
+  bool presentPending, presentQuit;
+  /* whether the context has been handed over to the presenter */
+  bool handedOff;
+
+  static void*presentThread(void*you)
+  {
+    PIMPL*me=reinterpret_cast<PIMPL*>(you);
+    me->presentLoop();
+    return 0;
+  }
+  void presentLoop(void)
+  {
+    pthread_mutex_lock(&presentMutex);
+    while(!presentQuit) {
+      if(!presentPending) {
+        pthread_cond_wait(&presentCond, &presentMutex);
+        continue;
+      }
+      pthread_mutex_unlock(&presentMutex);
+      if(parent->makeCurrent()) {
+        parent->swapBuffers();
+        parent->releaseCurrent();
+      }
+      pthread_mutex_lock(&presentMutex);
+      presentPending=false;
+      pthread_cond_broadcast(&presentCond);
+    }
+    pthread_mutex_unlock(&presentMutex);
+  }
+  bool isPresenter(void)
+  {
+    return (presenting && pthread_equal(presenter, pthread_self()));
+  }
+  bool startPresenter(void)
+  {
+    if(presenting) {
+      return true;
+    }
+    presentPending=false;
+    presentQuit=false;
+    if(pthread_create(&presenter, 0, presentThread, this)) {
+      return false;
+    }
+    presenting=true;
+    return true;
+  }
+  void stopPresenter(void)
+  {
+    if(!presenting) {
+      return;
+    }
+    pthread_mutex_lock(&presentMutex);
+    presentQuit=true;
+    pthread_cond_broadcast(&presentCond);
+    pthread_mutex_unlock(&presentMutex);
+    pthread_join(presenter, 0);
+    presenting=false;
+    presentPending=false;
+  }
+  /* wait until the presenter has finished the last frame */
+  void sync(void)
+  {
+    if(!presenting || isPresenter()) {
+      return;
+    }
+    pthread_mutex_lock(&presentMutex);
+    while(presentPending) {
+      pthread_cond_wait(&presentCond, &presentMutex);
+    }
+    pthread_mutex_unlock(&presentMutex);
+  }
+  /* hand the context over to the presenter;
+   * returns false if the window cannot do that
+   */
+  bool present(void)
+  {
+    if(!startPresenter()) {
+      return false;
+    }
+    glFlush();
+    if(!parent->releaseCurrent()) {
+      return false;
+    }
+    pthread_mutex_lock(&presentMutex);
+    presentPending=true;
+    pthread_cond_broadcast(&presentCond);
+    pthread_mutex_unlock(&presentMutex);
+    handedOff=true;
+    return true;
+  }
 }; /* GemWindow::PIMPL */
 std::set<GemWindow*>GemWindow::PIMPL::s_contexts;
 
@@ -203,6 +327,7 @@ GemWindow :: GemWindow()
 GemWindow :: ~GemWindow()
 {
   if(m_pimpl) {
+    m_pimpl->stopPresenter();
     m_pimpl->mycontext=destroyContext(m_pimpl->mycontext);
     delete m_pimpl;
     m_pimpl=0;
@@ -410,6 +535,13 @@ bool GemWindow::createGemWindow(void)
 
 void GemWindow::destroyGemWindow(void)
 {
+  m_pimpl->sync();
+  m_pimpl->stopPresenter();
+  if(m_pimpl->handedOff) {
+    // the objects need a current context to release their resources
+    m_pimpl->handedOff=false;
+    makeCurrent();
+  }
   // tell all objects that this context is vanishing
   sendContextDestroyedMsg(gensym("__gemBase")->s_thing);
   // do the rest
@@ -436,9 +568,27 @@ bool GemWindow::popContext(void)
   return (m_context && m_context->pop());
 }
 
+bool GemWindow::releaseCurrent(void)
+{
+  return false;
+}
+void GemWindow::syncPresent(void)
+{
+  m_pimpl->sync();
+}
+
 void GemWindow::render(void)
 {
-  if(m_context && m_context->isActive()) {
+  /* make sure the previous frame has been presented */
+  m_pimpl->sync();
+  if(m_pimpl->handedOff) {
+    // the presenter has released the context, so we must take it back
+    m_pimpl->handedOff=false;
+    if(!makeCurrent()) {
+      error("unable to switch to current window (do you have one?), cannot render!");
+      return;
+    }
+  } else if(m_context && m_context->isActive()) {
     // the context is already current, no need to force it
     // (which might be slow)
   } else {
@@ -453,7 +603,15 @@ void GemWindow::render(void)
   }
   bang();
   if(m_buffer==2) {
-    swapBuffers();
+    if(m_pimpl->threaded && !m_pimpl->present()) {
+      error("this window does not support threaded swapping");
+      m_pimpl->threaded=false;
+      m_pimpl->stopPresenter();
+      makeCurrent();
+    }
+    if(!m_pimpl->handedOff) {
+      swapBuffers();
+    }
   }
 
   popContext();
@@ -504,6 +662,19 @@ void GemWindow::      destroyMess(void)
   destroy();
 }
 
+void GemWindow::     threadedMess(bool on)
+{
+  if(!on) {
+    m_pimpl->sync();
+    m_pimpl->stopPresenter();
+    if(m_pimpl->handedOff) {
+      m_pimpl->handedOff=false;
+      makeCurrent();
+    }
+  }
+  m_pimpl->threaded=on;
+}
+
 void GemWindow::       cursorMess(bool on)
 {
   m_cursor=on;
@@ -560,6 +731,7 @@ void GemWindow :: obj_setupCallback(t_class *classPtr)
   CPPEXTERN_MSG1(classPtr, "border", borderMess, bool);
   CPPEXTERN_MSG1(classPtr, "cursor", cursorMess, bool);
   CPPEXTERN_MSG1(classPtr, "transparent", transparentMess, bool);
+  CPPEXTERN_MSG1(classPtr, "threaded", threadedMess, bool);
 
   CPPEXTERN_MSG0(classPtr, "print", printMess);
 
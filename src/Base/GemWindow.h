@@ -141,6 +141,15 @@ public:
    */
   virtual void swapBuffers(void) = 0;
 
+  /* release the object's context from the calling thread,
+   * so it can be made current in another thread
+   * windows that implement this can swap their buffers in a separate
+   * thread (see threadedMess()); such windows MUST call syncPresent()
+   * from their makeCurrent()
+   * the default implementation returns <tt>false</tt> (not supported)
+   */
+  virtual bool releaseCurrent(void);
+
   /* dispatch messages from the window
    * this might get called more often than the render-cycle
    * it might also be called automatically as soon as the window
@@ -155,6 +164,7 @@ public:
    *    bang();
    *    if(m_buffer==2)swap();
    *    popContext();
+   * (if the window is 'threaded', only the swap happens in a separate thread)
    * but you can override this, if you want to
    */
   virtual void render(void);
@@ -192,6 +202,10 @@ public:
   /* post creation */
   virtual void        cursorMess(bool on);
 
+  /* threaded swap: swap the buffers in a separate thread
+   * (rendering still happens in Pd's thread) */
+  virtual void      threadedMess(bool on);
+
   /* print some info */
   virtual void        printMess(void);
 
@@ -199,6 +213,11 @@ public:
   virtual void        anyMess(t_symbol*s, int argc, t_atom*argv);
 
 protected:
+  /* wait until the previous frame has been presented
+   * (does nothing if the window is not 'threaded')
+   */
+  void syncPresent(void);
+
   unsigned int m_width, m_height;
 
   // common properties of GemWindow's
@@ -0,0 +1,391 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "GlyphAtlas.h"
+#include "Gem/GemGL.h"
+#include "Gem/ContextData.h"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <map>
+#include <string.h>
+
+namespace
+{
+/* the atlas never grows beyond this (in either direction) */
+const unsigned int MAXSIZE=4096;
+
+unsigned int nextPowerOfTwo(unsigned int value)
+{
+  unsigned int result=1;
+  while(result<value) {
+    result<<=1;
+  }
+  return result;
+}
+
+FT_Library s_library=0;
+typedef std::pair<std::string, unsigned int> atlaskey_t;
+std::map<atlaskey_t, gem::text::GlyphAtlas*>s_atlases;
+std::map<gem::text::GlyphAtlas*, unsigned int>s_refcount;
+};
+
+namespace gem
+{
+namespace text
+{
+class GlyphAtlas::PIMPL
+{
+public:
+  struct Glyph {
+    FT_UInt index;
+    /* the quad (relative to the pen position) */
+    float x0, y0, x1, y1;
+    float advance;
+    /* the position within the atlas */
+    unsigned int x, y, w, h;
+  };
+
+  std::string font;
+  unsigned int size;
+  FT_Face face;
+
+  std::map<unsigned long, Glyph>glyphs;
+
+  unsigned int width, height;
+  std::vector<unsigned char>bitmap;
+  /* the shelf currently being filled */
+  unsigned int shelfX, shelfY, shelfHeight;
+
+  /* bumped when the texture coordinates change */
+  unsigned int version;
+  /* bumped when the bitmap changes */
+  unsigned int serial;
+
+  gem::ContextData<GLuint>texture;
+  gem::ContextData<unsigned int>uploaded;
+
+  PIMPL(const std::string&fontfile, unsigned int size_)
+    : font(fontfile)
+    , size(size_)
+    , face(0)
+    , width(0), height(0)
+    , shelfX(1), shelfY(1), shelfHeight(0)
+    , version(0), serial(1)
+    , texture(0), uploaded(0)
+  {
+    if(!s_library && FT_Init_FreeType(&s_library)) {
+      s_library=0;
+      return;
+    }
+    if(FT_New_Face(s_library, font.c_str(), 0, &face)) {
+      face=0;
+      return;
+    }
+    FT_Select_Charmap(face, FT_ENCODING_UNICODE);
+    if(FT_Set_Pixel_Sizes(face, 0, size)) {
+      FT_Done_Face(face);
+      face=0;
+      return;
+    }
+
+    /* fixed width, the height grows as needed */
+    width=nextPowerOfTwo(size*16);
+    if(width<256) {
+      width=256;
+    }
+    if(width>MAXSIZE) {
+      width=MAXSIZE;
+    }
+    height=nextPowerOfTwo(2*(size+2));
+    if(height>MAXSIZE) {
+      height=MAXSIZE;
+    }
+    bitmap.resize(width*height, 0);
+  }
+  ~PIMPL(void)
+  {
+    GLuint tex=texture;
+    if(tex) {
+      glDeleteTextures(1, &tex);
+    }
+    if(face) {
+      FT_Done_Face(face);
+    }
+  }
+
+  /* find a free spot of w*h pixels (with a 1px gap) */
+  bool allocate(unsigned int w, unsigned int h,
+                unsigned int&x, unsigned int&y)
+  {
+    if(w+2>width) {
+      return false;
+    }
+    if(shelfX+w+1>width) {
+      /* start a new shelf */
+      shelfY+=shelfHeight+1;
+      shelfX=1;
+      shelfHeight=0;
+    }
+    if(shelfY+h+1>height) {
+      unsigned int newheight=height;
+      while(shelfY+h+1>newheight) {
+        newheight*=2;
+      }
+      if(newheight>MAXSIZE) {
+        return false;
+      }
+      /* the rows are width wide, so the content stays in place */
+      height=newheight;
+      bitmap.resize(width*height, 0);
+      version++;
+    }
+    x=shelfX;
+    y=shelfY;
+    shelfX+=w+1;
+    if(h>shelfHeight) {
+      shelfHeight=h;
+    }
+    return true;
+  }
+
+  void rasterize(Glyph&g)
+  {
+    if(FT_Load_Glyph(face, g.index, FT_LOAD_RENDER)) {
+      return;
+    }
+    const FT_GlyphSlot slot=face->glyph;
+    const FT_Bitmap&bm=slot->bitmap;
+    g.advance=slot->advance.x/64.f;
+
+    const unsigned int w=bm.width;
+    const unsigned int h=bm.rows;
+    if(!w || !h) {
+      return;
+    }
+    if(FT_PIXEL_MODE_GRAY!=bm.pixel_mode && FT_PIXEL_MODE_MONO!=bm.pixel_mode) {
+      return;
+    }
+    unsigned int x=0, y=0;
+    if(!allocate(w, h, x, y)) {
+      return;
+    }
+
+    for(unsigned int row=0; row<h; row++) {
+      /* with a negative pitch, the rows are stored bottom-up */
+      const unsigned char*src=bm.buffer+((bm.pitch<0)
+                                         ?((h-1-row)*(-bm.pitch))
+                                         :(row*bm.pitch));
+      unsigned char*dst=&bitmap[(y+row)*width+x];
+      if(FT_PIXEL_MODE_MONO==bm.pixel_mode) {
+        for(unsigned int col=0; col<w; col++) {
+          dst[col]=((src[col>>3]>>(7-(col&7)))&1)?255:0;
+        }
+      } else {
+        memcpy(dst, src, w);
+      }
+    }
+    g.x=x;
+    g.y=y;
+    g.w=w;
+    g.h=h;
+    g.x0=slot->bitmap_left;
+    g.x1=g.x0+w;
+    g.y1=slot->bitmap_top;
+    g.y0=g.y1-h;
+    serial++;
+  }
+
+  const Glyph&getGlyph(unsigned long c)
+  {
+    std::map<unsigned long, Glyph>::iterator it=glyphs.find(c);
+    if(it!=glyphs.end()) {
+      return it->second;
+    }
+    Glyph&g=glyphs[c];
+    memset(&g, 0, sizeof(g));
+    g.index=FT_Get_Char_Index(face, c);
+    rasterize(g);
+    return g;
+  }
+};
+
+GlyphAtlas::GlyphAtlas(const std::string&fontfile, unsigned int size)
+  : m_pimpl(new PIMPL(fontfile, size))
+{
+}
+GlyphAtlas::~GlyphAtlas(void)
+{
+  delete m_pimpl;
+  m_pimpl=0;
+}
+
+GlyphAtlas*GlyphAtlas::acquire(const std::string&fontfile,
+                               unsigned int size)
+{
+  if(!size) {
+    return 0;
+  }
+  const atlaskey_t key(fontfile, size);
+  std::map<atlaskey_t, GlyphAtlas*>::iterator it=s_atlases.find(key);
+  if(it!=s_atlases.end()) {
+    s_refcount[it->second]++;
+    return it->second;
+  }
+  GlyphAtlas*atlas=new GlyphAtlas(fontfile, size);
+  if(!atlas->m_pimpl->face) {
+    delete atlas;
+    return 0;
+  }
+  s_atlases[key]=atlas;
+  s_refcount[atlas]=1;
+  return atlas;
+}
+void GlyphAtlas::release(GlyphAtlas*atlas)
+{
+  std::map<GlyphAtlas*, unsigned int>::iterator it=s_refcount.find(atlas);
+  if(it==s_refcount.end()) {
+    return;
+  }
+  if(--it->second) {
+    return;
+  }
+  s_refcount.erase(it);
+  s_atlases.erase(atlaskey_t(atlas->getFont(), atlas->getSize()));
+  delete atlas;
+}
+
+const std::string&GlyphAtlas::getFont(void) const
+{
+  return m_pimpl->font;
+}
+unsigned int GlyphAtlas::getSize(void) const
+{
+  return m_pimpl->size;
+}
+float GlyphAtlas::getAscender(void) const
+{
+  return m_pimpl->face->size->metrics.ascender/64.f;
+}
+float GlyphAtlas::getDescender(void) const
+{
+  return m_pimpl->face->size->metrics.descender/64.f;
+}
+float GlyphAtlas::getLineHeight(void) const
+{
+  return m_pimpl->face->size->metrics.height/64.f;
+}
+unsigned int GlyphAtlas::getVersion(void) const
+{
+  return m_pimpl->version;
+}
+
+unsigned int GlyphAtlas::layout(const std::wstring&line,
+                                std::vector<float>&vertices,
+                                float bbox[4], float x, float y)
+{
+  const bool kerning=FT_HAS_KERNING(m_pimpl->face);
+  unsigned int count=0;
+  bool empty=true;
+  float pen=0.f;
+  FT_UInt previous=0;
+  bbox[0]=bbox[1]=bbox[2]=bbox[3]=0.f;
+
+  for(unsigned int i=0; i<line.size(); i++) {
+    const PIMPL::Glyph&g=m_pimpl->getGlyph(line[i]);
+    if(kerning && previous && g.index) {
+      FT_Vector delta;
+      if(!FT_Get_Kerning(m_pimpl->face, previous, g.index,
+                         FT_KERNING_DEFAULT, &delta)) {
+        pen+=delta.x/64.f;
+      }
+    }
+    previous=g.index;
+    if(g.w && g.h) {
+      /* the texture size might have changed while adding the glyph,
+       * so query it for each glyph */
+      const float sw=1.f/m_pimpl->width;
+      const float sh=1.f/m_pimpl->height;
+      const float x0=x+pen+g.x0, x1=x+pen+g.x1;
+      const float y0=y+g.y0, y1=y+g.y1;
+      const float s0=g.x*sw, s1=(g.x+g.w)*sw;
+      const float t0=(g.y+g.h)*sh, t1=g.y*sh;
+      const float quad[6][4]= {
+        {x0, y0, s0, t0}, {x1, y0, s1, t0}, {x1, y1, s1, t1},
+        {x0, y0, s0, t0}, {x1, y1, s1, t1}, {x0, y1, s0, t1}
+      };
+      vertices.insert(vertices.end(), &quad[0][0], &quad[0][0]+6*4);
+      count+=6;
+
+      if(empty) {
+        empty=false;
+        bbox[0]=x0;
+        bbox[1]=y0;
+        bbox[2]=x1;
+        bbox[3]=y1;
+      } else {
+        if(x0<bbox[0]) {
+          bbox[0]=x0;
+        }
+        if(y0<bbox[1]) {
+          bbox[1]=y0;
+        }
+        if(x1>bbox[2]) {
+          bbox[2]=x1;
+        }
+        if(y1>bbox[3]) {
+          bbox[3]=y1;
+        }
+      }
+    }
+    pen+=g.advance;
+  }
+  return count;
+}
+
+bool GlyphAtlas::bind(void)
+{
+  GLuint tex=m_pimpl->texture;
+  if(!tex || !glIsTexture(tex)) {
+    glGenTextures(1, &tex);
+    if(!tex) {
+      return false;
+    }
+    m_pimpl->texture=tex;
+    m_pimpl->uploaded=0;
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  } else {
+    glBindTexture(GL_TEXTURE_2D, tex);
+  }
+
+  if(m_pimpl->uploaded != m_pimpl->serial) {
+    /* glyphs are only added occasionally, so we simply upload the entire atlas */
+    glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA,
+                 m_pimpl->width, m_pimpl->height, 0,
+                 GL_ALPHA, GL_UNSIGNED_BYTE, &m_pimpl->bitmap[0]);
+    glPopClientAttrib();
+    m_pimpl->uploaded=m_pimpl->serial;
+  }
+  return true;
+}
+};
+};
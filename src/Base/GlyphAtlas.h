@@ -0,0 +1,83 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    GlyphAtlas.h
+       - glyphs of a font rasterized into a shared texture
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_BASE_GLYPHATLAS_H_
+#define _INCLUDE__GEM_BASE_GLYPHATLAS_H_
+
+#include "Gem/ExportDef.h"
+#include <string>
+#include <vector>
+
+namespace gem
+{
+namespace text
+{
+/**
+ * a texture atlas holding the glyphs of a font at a given pixel size
+ *
+ * glyphs are rasterized (with FreeType) the first time they are laid out,
+ * and packed into a single alpha-texture
+ * atlases are shared between all objects using the same font at the
+ * same size: use acquire() to get one and release() when done
+ *
+ * layout() turns a line of text into textured quads
+ * (2 triangles per glyph; 4 floats per vertex: x, y, s, t)
+ * in pixel units, with the pen starting at (0,0) on the baseline
+ * the texture coordinates stay valid as long as getVersion() does not change
+ * (the atlas grows when it is full, which rescales all texture coordinates)
+ */
+class GEM_EXTERN GlyphAtlas
+{
+public:
+  static GlyphAtlas*acquire(const std::string&fontfile, unsigned int size);
+  static void release(GlyphAtlas*atlas);
+
+  const std::string&getFont(void) const;
+  unsigned int getSize(void) const;
+
+  /* font metrics (in pixels) */
+  float getAscender(void) const;
+  float getDescender(void) const;
+  float getLineHeight(void) const;
+
+  /*
+   * append the quads for 'line' (shifted by x/y) to 'vertices'
+   * 'bbox' receives the bounding box of the line (x0, y0, x1, y1)
+   * the return value is the number of vertices appended
+   */
+  unsigned int layout(const std::wstring&line, std::vector<float>&vertices,
+                      float bbox[4], float x=0.f, float y=0.f);
+  /* incremented whenever previously laid out texture coordinates
+   * are invalidated */
+  unsigned int getVersion(void) const;
+
+  /* bind the texture (uploading any new glyphs) to GL_TEXTURE_2D
+   * in the current context
+   * (requires a valid context) */
+  bool bind(void);
+
+private:
+  class PIMPL;
+  PIMPL*m_pimpl;
+
+  GlyphAtlas(const std::string&fontfile, unsigned int size);
+  virtual ~GlyphAtlas(void);
+  // noncopyable
+  GlyphAtlas(const GlyphAtlas&);
+  GlyphAtlas&operator=(const GlyphAtlas&);
+};
+};
+};
+
+#endif /* _INCLUDE__GEM_BASE_GLYPHATLAS_H_ */
@@ -38,6 +38,14 @@
 # elif defined HAVE_FTFONT_H
 #  include <FTFont.h>
 # endif
+# include "Gem/VertexBuffer.h"
+namespace gem
+{
+namespace text
+{
+class GlyphAtlas;
+};
+};
 #else
 # define FONT_SCALE 1.0
 #endif
@@ -229,6 +237,35 @@ protected:
   /* render one line of the text */
   virtual void renderLine(const char*line,float dist);
   virtual void renderLine(const wchar_t*line,float dist);
+
+  virtual void stopRendering(void);
+
+  //////////
+  // the glyph-atlas renderer:
+  // glyphs are rasterized once (per font and size) into a shared texture
+  // and the entire text is drawn as a single array of textured quads,
+  // which is only laid out anew if the text (or its appearance) changes
+  bool m_useAtlas;
+  gem::text::GlyphAtlas*m_atlas;
+  // the full path of the current font-file
+  std::string m_fontfile;
+  // the laid out text (x, y, s, t per vertex)
+  gem::VertexBuffer m_atlasVertices;
+  unsigned int m_atlasCount;
+  bool m_atlasDirty;
+  unsigned int m_atlasVersion;
+
+  // the size (in pixels) the glyphs are rasterized at
+  virtual unsigned int atlasSize(void);
+  // the vertical offset (in pixels) of the given line
+  virtual float atlasLineOffset(unsigned int line);
+  // (re)acquire the atlas and lay out the text if needed
+  // returns false if there is nothing to draw
+  bool updateAtlas(void);
+  // draw the laid out text (in pixel units)
+  void drawAtlas(void);
+  // render the text via the atlas
+  virtual void renderAtlas(void);
 #endif
 
 private:
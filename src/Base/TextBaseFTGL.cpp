@@ -22,12 +22,14 @@
  */
 
 #include "TextBase.h"
+#include "GlyphAtlas.h"
 #include "Utils/Functions.h"
 #include "Gem/Settings.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #ifdef _WIN32
 # include <io.h>
@@ -55,7 +57,10 @@ TextBase :: TextBase(int argc, t_atom *argv)
   m_widthJus(CENTER), m_heightJus(MIDDLE), m_depthJus(HALFWAY),
   m_inlet(NULL),
   m_infoOut(gem::RTE::Outlet(this)),
-  m_font(NULL), m_fontname(NULL)
+  m_font(NULL), m_fontname(NULL),
+  m_useAtlas(false), m_atlas(NULL),
+  m_atlasVertices(0, 4), m_atlasCount(0),
+  m_atlasDirty(true), m_atlasVersion(0)
 {
   // initial text
   gem::Settings::get("font.face", DEFAULT_FONT);
@@ -78,6 +83,15 @@ void TextBase :: startRendering(void)
     fontNameMess(m_fontname->s_name);
   }
 }
+void TextBase :: stopRendering(void)
+{
+  m_atlasVertices.destroy();
+  m_atlasVertices.enabled=false;
+  if(m_atlas) {
+    gem::text::GlyphAtlas::release(m_atlas);
+  }
+  m_atlas=NULL;
+}
 
 
 ////////////////////////////////////////////////////////
@@ -130,16 +144,145 @@ void TextBase :: render(GemState *)
   else {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   }
-  // step through the lines
-  for(i=0; i<m_theText.size(); i++) {
-    renderLine(m_theText[i].c_str(),
-               m_lineDist[i]*m_fontSize*m_dist*m_precision);
+  if(m_useAtlas) {
+    if(updateAtlas()) {
+      renderAtlas();
+    }
+  } else {
+    // step through the lines
+    for(i=0; i<m_theText.size(); i++) {
+      renderLine(m_theText[i].c_str(),
+                 m_lineDist[i]*m_fontSize*m_dist*m_precision);
+    }
   }
   glDisable(GL_BLEND);
   glPopAttrib();
   fontInfo();
 }
 
+////////////////////////////////////////////////////////
+// the glyph-atlas renderer
+//
+////////////////////////////////////////////////////////
+unsigned int TextBase :: atlasSize(void)
+{
+  int fs=static_cast<int>(m_fontSize*m_precision);
+  if(fs<0) {
+    fs=-fs;
+  }
+  return fs;
+}
+float TextBase :: atlasLineOffset(unsigned int line)
+{
+  return m_lineDist[line]*m_fontSize*m_dist*m_precision;
+}
+
+bool TextBase :: updateAtlas(void)
+{
+  const unsigned int size=atlasSize();
+  if(m_atlas && (m_atlas->getSize()!=size || m_atlas->getFont()!=m_fontfile)) {
+    gem::text::GlyphAtlas::release(m_atlas);
+    m_atlas=NULL;
+  }
+  if(!m_atlas) {
+    if(m_fontfile.empty()) {
+      return false;
+    }
+    m_atlas=gem::text::GlyphAtlas::acquire(m_fontfile, size);
+    if(!m_atlas) {
+      return false;
+    }
+    m_atlasDirty=true;
+  }
+  if(!m_atlasDirty && m_atlasVersion==m_atlas->getVersion()) {
+    return (m_atlasCount>0);
+  }
+
+  std::vector<float>vertices;
+  /* adding glyphs might grow the atlas (invalidating the texture coordinates
+   * of the lines already laid out); the 2nd pass will not add any glyphs */
+  do {
+    m_atlasVersion=m_atlas->getVersion();
+    vertices.clear();
+    for(unsigned int i=0; i<m_theText.size(); i++) {
+      float bbox[4];
+      const unsigned int start=vertices.size();
+      m_atlas->layout(m_theText[i], vertices, bbox);
+      Justification just=justifyFont(bbox[0], bbox[1], 0.f,
+                                     bbox[2], bbox[3], 0.f,
+                                     atlasLineOffset(i));
+      // keep the glyphs on the pixel grid
+      const float dx=floorf(just.width +0.5f);
+      const float dy=floorf(just.height+0.5f);
+      for(unsigned int j=start; j<vertices.size(); j+=4) {
+        vertices[j+0]-=dx;
+        vertices[j+1]-=dy;
+      }
+    }
+  } while(m_atlasVersion!=m_atlas->getVersion());
+
+  m_atlasCount=vertices.size()/4;
+  if(m_atlasCount>m_atlasVertices.size) {
+    m_atlasVertices.resize(m_atlasCount);
+  }
+  if(m_atlasCount) {
+    memcpy(m_atlasVertices.array, &vertices[0], vertices.size()*sizeof(float));
+  }
+  m_atlasVertices.dirty=true;
+  m_atlasDirty=false;
+  return (m_atlasCount>0);
+}
+
+void TextBase :: drawAtlas(void)
+{
+  if(!m_atlasCount) {
+    return;
+  }
+  glPushAttrib(GL_ENABLE_BIT | GL_TEXTURE_BIT);
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  if(!m_atlas->bind()) {
+    glPopClientAttrib();
+    glPopAttrib();
+    return;
+  }
+  glDisable(GL_TEXTURE_RECTANGLE_ARB);
+  glEnable(GL_TEXTURE_2D);
+  glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+  if(!m_atlasVertices.vbo) {
+    m_atlasVertices.enabled=m_atlasVertices.create();
+    m_atlasVertices.dirty=false;
+  }
+  // without VBOs, the client-side array is used
+  const float*data=m_atlasVertices.render()?NULL:m_atlasVertices.array;
+  const GLsizei stride=4*sizeof(float);
+
+  glDisableClientState(GL_NORMAL_ARRAY);
+  glDisableClientState(GL_COLOR_ARRAY);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(2, GL_FLOAT, stride, data);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glTexCoordPointer(2, GL_FLOAT, stride, data+2);
+
+  glNormal3f(0.0, 0.0, 1.0);
+  glDrawArrays(GL_TRIANGLES, 0, m_atlasCount);
+
+  if(m_atlasVertices.enabled) {
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+  glPopClientAttrib();
+  glPopAttrib();
+}
+
+void TextBase :: renderAtlas(void)
+{
+  const float scale=FONT_SCALE/m_precision;
+  glPushMatrix();
+  glScalef(scale, scale, scale);
+  drawAtlas();
+  glPopMatrix();
+}
+
 ////////////////////////////////////////////////////////
 // setFontSize
 //
@@ -147,6 +290,7 @@ void TextBase :: render(GemState *)
 void TextBase :: setFontSize(float size)
 {
   m_fontSize = size;
+  m_atlasDirty = true;
   setFontSize();
 }
 ////////////////////////////////////////////////////////
@@ -159,6 +303,7 @@ void TextBase :: setPrecision(float prec)
     prec=1.f;
   }
   m_precision = 3.*prec;
+  m_atlasDirty = true;
 
   setFontSize();
 }
@@ -194,6 +339,8 @@ void TextBase :: fontNameMess(const std::string&filename)
     return;
   }
   m_fontname=gensym(filename.c_str());
+  m_fontfile=fn;
+  m_atlasDirty=true;
 
   setFontSize();
   m_font->Depth(m_fontDepth);
@@ -212,6 +359,9 @@ TextBase :: ~TextBase()
   if(m_inlet) {
     inlet_free(m_inlet);
   }
+  if(m_atlas) {
+    gem::text::GlyphAtlas::release(m_atlas);
+  }
 }
 
 /////////////////////////////////////////////////////////
@@ -258,6 +408,7 @@ void TextBase :: setJustification(JustifyWidth wType, JustifyHeight hType)
 void TextBase :: setJustification(JustifyWidth wType)
 {
   m_widthJus = wType;
+  m_atlasDirty = true;
 }
 
 
@@ -443,6 +594,7 @@ void TextBase :: breakLine(wstring line)
 void TextBase :: textMess(int argc, t_atom *argv)
 {
   m_theText.clear();
+  m_atlasDirty = true;
   if ( argc < 1 ) {
     return;
   }
@@ -489,6 +641,7 @@ void TextBase :: textMess(int argc, t_atom *argv)
 /////////////////////////////////////////////////////////
 void TextBase :: makeLineDist()
 {
+  m_atlasDirty = true;
   m_lineDist.clear();
   if (m_heightJus == BOTTOM || m_heightJus == BASEH) {
     // so the offset will be a simple
@@ -538,6 +691,7 @@ void TextBase :: makeLineDist()
 void TextBase :: stringMess(int argc, t_atom *argv)
 {
   m_theText.clear();
+  m_atlasDirty = true;
 
   if ( argc < 1 ) {
     return;
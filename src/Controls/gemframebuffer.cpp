@@ -22,6 +22,25 @@
 
 CPPEXTERN_NEW_WITH_GIMME(gemframebuffer);
 
+namespace
+{
+GLenum getFormat(const std::string&format)
+{
+  if("YUV"==format) {
+    return GL_YUV422_GEM;
+  } else if ("RGB"==format) {
+    return GL_RGB;
+  } else if ("RGBA"==format) {
+    return GL_RGBA;
+  } else if ("RGB32"==format) {
+    return GL_RGB_FLOAT32_ATI;
+  } else if ("RGBA32F"==format) {
+    return GL_RGBA32F;
+  }
+  return 0;
+}
+};
+
 /////////////////////////////////////////////////////////
 //
 // gemframebuffer
@@ -38,27 +57,19 @@ CPPEXTERN_NEW_WITH_GIMME(gemframebuffer);
  * ff   <f:width> <f:height>: width(width), height(height), format(), type()
  * ffs  <f:width> <f:height> <s:format>: width(width), height(height), format(format), type()
  * ffss <f:width> <f:height> <s:format> <s:type>: width(width), height(height), format(format), type(type)
+ * ffss<s...> <f:width> <f:height> <s:format> <s:type> <s:format1>...: ffss + additional attachments
 
  */
 gemframebuffer :: gemframebuffer(int argc, t_atom*argv)
   : m_haveinit(false), m_wantinit(false), m_frameBufferIndex(0),
     m_depthBufferIndex(0),
-    m_offScreenID(0), m_texTarget(GL_TEXTURE_2D), m_texunit(0),
+    m_msFrameBufferIndex(0), m_msDepthBufferIndex(0),
+    m_texTarget(GL_TEXTURE_2D), m_texunit(0),
     m_width(256), m_height(256),
     m_rectangle(false), m_canRectangle(0),
-    m_internalformat(GL_RGB8), m_format(GL_RGB), m_wantFormat(GL_RGB),
     m_type(GL_UNSIGNED_BYTE),
-    m_outTexInfo(NULL)
+    m_samples(0), m_haveSamples(0)
 {
-  // create an outlet to send out texture info:
-  //  - ID
-  //  - width & height
-  //  - format/type (ie. GL_TEXTURE_RECTANGLE or GL_TEXTURE_2D)
-  //  - anything else?
-  if(!m_outTexInfo) {
-    m_outTexInfo = outlet_new(this->x_obj, 0);
-  }
-
   unsigned int typesignature = 0;
   for(int i=0; i<4; i++) {
     if(i>=argc) {
@@ -113,6 +124,36 @@ gemframebuffer :: gemframebuffer(int argc, t_atom*argv)
     break;
   }
 
+  t_attachment attachment;
+  attachment.wantFormat=GL_RGB;
+  attachment.internalformat=GL_RGB8;
+  attachment.format=GL_RGB;
+  attachment.texture=0;
+  attachment.multisample=0;
+  attachment.outTexInfo=NULL;
+  m_attachments.push_back(attachment);
+  if(index_type >= 0) {
+    /* any remaining arguments are the formats of additional attachments */
+    for(int i=index_type+1; i<argc; i++) {
+      const std::string format=atom_getsymbol(argv+i)->s_name;
+      attachment.wantFormat=getFormat(format);
+      if(!attachment.wantFormat) {
+        error("unknown format '%s'", format.c_str());
+        attachment.wantFormat=GL_RGB;
+      }
+      m_attachments.push_back(attachment);
+    }
+  }
+
+  // create an outlet (per attachment) to send out texture info:
+  //  - ID
+  //  - width & height
+  //  - format/type (ie. GL_TEXTURE_RECTANGLE or GL_TEXTURE_2D)
+  //  - anything else?
+  for(unsigned int i=0; i<m_attachments.size(); i++) {
+    m_attachments[i].outTexInfo = outlet_new(this->x_obj, 0);
+  }
+
   m_FBOcolor[0] = 0.f;
   m_FBOcolor[1] = 0.f;
   m_FBOcolor[2] = 0.f;
@@ -148,7 +189,9 @@ gemframebuffer :: gemframebuffer(int argc, t_atom*argv)
 gemframebuffer :: ~gemframebuffer()
 {
   destroyFBO();
-  outlet_free(m_outTexInfo);
+  for(unsigned int i=0; i<m_attachments.size(); i++) {
+    outlet_free(m_attachments[i].outTexInfo);
+  }
 }
 
 ////////////////////////////////////////////////////////
@@ -208,12 +251,11 @@ void gemframebuffer :: render(GemState *state)
   glGetFloatv( GL_COLOR_CLEAR_VALUE, m_color );
 
   glBindTexture( m_texTarget, 0 );
-  glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_frameBufferIndex);
-  // Bind the texture to the frame buffer.
-  glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT,
-                            m_texTarget, m_offScreenID, 0);
-  glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT,
-                               GL_RENDERBUFFER_EXT, m_depthBufferIndex);
+  // the textures are attached to the framebuffer in initFBO();
+  // with multisampling we render into the renderbuffers instead,
+  // and resolve them into the textures in postrender()
+  glBindFramebufferEXT(GL_FRAMEBUFFER_EXT,
+                       m_msFrameBufferIndex?m_msFrameBufferIndex:m_frameBufferIndex);
 
   // debug yellow color
   // glClearColor( 1,1,0,0);
@@ -274,8 +316,23 @@ void gemframebuffer :: postrender(GemState *state)
   // viewport-sized quad vertices are at [-1,-1], [1,-1], [1,1], and
   // [-1,1]: the corners of the viewport.
 
+  if(m_msFrameBufferIndex) {
+    glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, m_msFrameBufferIndex);
+    glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, m_frameBufferIndex);
+    for(unsigned int i=0; i<m_attachments.size(); i++) {
+      if(!m_attachments[i].multisample) {
+        continue;
+      }
+      const GLenum buffer=GL_COLOR_ATTACHMENT0_EXT+i;
+      glReadBuffer(buffer);
+      glDrawBuffer(buffer);
+      glBlitFramebufferEXT(0, 0, m_width, m_height, 0, 0, m_width, m_height,
+                           GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+  }
+
   glBindFramebufferEXT( GL_FRAMEBUFFER_EXT, 0 );
-  glBindTexture( m_texTarget, m_offScreenID );
+  glBindTexture( m_texTarget, m_attachments[0].texture );
 
   if(stacks) {
     stacks->pop(gem::GLStack::PROJECTION);
@@ -290,14 +347,17 @@ void gemframebuffer :: postrender(GemState *state)
   glViewport( m_vp[0], m_vp[1], m_vp[2], m_vp[3] );
   // now that the render is done,
 
-  // send textureID, w, h, textureTarget to outlet
-  t_atom ap[5];
-  SETFLOAT(ap+0, static_cast<t_float>(m_offScreenID));
-  SETFLOAT(ap+1, w);
-  SETFLOAT(ap+2, h);
-  SETFLOAT(ap+3, m_texTarget);
-  SETFLOAT(ap+4, static_cast<t_float>(0.));
-  outlet_list(m_outTexInfo, 0, 5, ap);
+  // send textureID, w, h, textureTarget to the outlets (right to left)
+  for(unsigned int i=m_attachments.size(); i>0; i--) {
+    const t_attachment&attachment=m_attachments[i-1];
+    t_atom ap[5];
+    SETFLOAT(ap+0, static_cast<t_float>(attachment.texture));
+    SETFLOAT(ap+1, w);
+    SETFLOAT(ap+2, h);
+    SETFLOAT(ap+3, m_texTarget);
+    SETFLOAT(ap+4, static_cast<t_float>(0.));
+    outlet_list(attachment.outTexInfo, 0, 5, ap);
+  }
 }
 
 namespace
@@ -332,9 +392,6 @@ const std::string getFormatString(int fmt)
 };
 void gemframebuffer :: printInfo()
 {
-  std::string format = getFormatString(m_format);
-  std::string internalformat = getFormatString(m_internalformat);
-
   std::string rectangle;
   switch(m_rectangle?m_canRectangle:GL_TEXTURE_2D) {
   case GL_TEXTURE_2D:
@@ -373,53 +430,25 @@ void gemframebuffer :: printInfo()
 
   verbose(0, "size: %dx%d", m_width, m_height);
   verbose(0, "rectangle: %d -> %s", m_rectangle, rectangle.c_str());
-  verbose(0, "format: %s/%s [%d/%d]", format.c_str(), internalformat.c_str(),
-          m_format, m_internalformat);
+  for(unsigned int i=0; i<m_attachments.size(); i++) {
+    const t_attachment&attachment=m_attachments[i];
+    std::string format = getFormatString(attachment.format);
+    std::string internalformat = getFormatString(attachment.internalformat);
+    verbose(0, "format#%d: %s/%s [%d/%d]", i,
+            format.c_str(), internalformat.c_str(),
+            attachment.format, attachment.internalformat);
+  }
   verbose(0, "type: %s [%d]", type.c_str(), m_type);
+  verbose(0, "samples: %d", m_haveSamples);
   verbose(0, "texunit: %d", m_texunit);
 }
 
 /////////////////////////////////////////////////////////
-// initFBO
+// checkFramebuffer
 //
 /////////////////////////////////////////////////////////
-void gemframebuffer :: initFBO()
+bool gemframebuffer :: checkFramebuffer()
 {
-  // clean up any existing FBO before creating a new one
-  if(m_haveinit) {
-    destroyFBO();
-  }
-
-  m_texTarget = (m_rectangle?m_canRectangle:GL_TEXTURE_2D);
-  /* check supported formats */
-  fixFormat(m_wantFormat);
-
-  // Generate frame buffer object then bind it.
-  glGenFramebuffersEXT(1, &m_frameBufferIndex);
-  glGenRenderbuffersEXT(1, &m_depthBufferIndex);
-
-  // Create the texture we will be using to render to.
-  glGenTextures(1, &m_offScreenID);
-  glBindTexture(m_texTarget, m_offScreenID);
-
-  glTexImage2D( m_texTarget, 0, m_internalformat, m_width, m_height, 0,
-                m_format, m_type, NULL );
-  // 2.13.2006
-  // GL_LINEAR causes fallback to software shader
-  // so switching back to GL_NEAREST
-  glTexParameteri(m_texTarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-  glTexParameteri(m_texTarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-  GLuint wrapmode = (GLEW_EXT_texture_edge_clamp)?GL_CLAMP_TO_EDGE:GL_CLAMP;
-
-  glTexParameterf(m_texTarget, GL_TEXTURE_WRAP_S, wrapmode);
-  glTexParameterf(m_texTarget, GL_TEXTURE_WRAP_T, wrapmode);
-
-  // Initialize the render buffer.
-  glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, m_depthBufferIndex);
-  glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_DEPTH_COMPONENT24,
-                           m_width, m_height);
-
   // Make sure we have not errors.
   GLenum status = glCheckFramebufferStatusEXT( GL_FRAMEBUFFER_EXT) ;
   if( status != GL_FRAMEBUFFER_COMPLETE_EXT ) {
@@ -442,6 +471,9 @@ void gemframebuffer :: initFBO()
     case GL_FRAMEBUFFER_INCOMPLETE_READ_BUFFER_EXT:
       error("GL_FRAMEBUFFER_INCOMPLETE_READ_BUFFER_EXT");
       break;
+    case GL_FRAMEBUFFER_INCOMPLETE_MULTISAMPLE_EXT:
+      error("GL_FRAMEBUFFER_INCOMPLETE_MULTISAMPLE_EXT");
+      break;
     case GL_FRAMEBUFFER_UNSUPPORTED_EXT:
       error("GL_FRAMEBUFFER_UNSUPPORTED_EXT");
       break;
@@ -451,10 +483,140 @@ void gemframebuffer :: initFBO()
     default:
       error("Unknown ERROR %d", status);
     }
+    return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////
+// initFBO
+//
+/////////////////////////////////////////////////////////
+void gemframebuffer :: initFBO()
+{
+  // clean up any existing FBO before creating a new one
+  if(m_haveinit) {
+    destroyFBO();
+  }
+
+  m_texTarget = (m_rectangle?m_canRectangle:GL_TEXTURE_2D);
+
+  /* how many attachments can we write to at once? */
+  unsigned int count=m_attachments.size();
+  if(count>1) {
+    GLint maxBuffers=1, maxAttachments=1;
+    if(GLEW_VERSION_2_0 || GLEW_ARB_draw_buffers) {
+      glGetIntegerv(GL_MAX_DRAW_BUFFERS, &maxBuffers);
+      glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS_EXT, &maxAttachments);
+    }
+    if(maxAttachments<maxBuffers) {
+      maxBuffers=maxAttachments;
+    }
+    if(maxBuffers<1) {
+      maxBuffers=1;
+    }
+    if(count>static_cast<unsigned int>(maxBuffers)) {
+      error("only %d of %d attachments are supported", maxBuffers, count);
+      count=maxBuffers;
+    }
+  }
+  std::vector<GLenum>drawbuffers;
+
+  // Generate frame buffer object then bind it.
+  glGenFramebuffersEXT(1, &m_frameBufferIndex);
+  glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_frameBufferIndex);
+
+  GLuint wrapmode = (GLEW_EXT_texture_edge_clamp)?GL_CLAMP_TO_EDGE:GL_CLAMP;
+  for(unsigned int i=0; i<count; i++) {
+    t_attachment&attachment=m_attachments[i];
+    /* check supported formats */
+    fixFormat(attachment);
+
+    // Create the texture we will be using to render to.
+    glGenTextures(1, &attachment.texture);
+    glBindTexture(m_texTarget, attachment.texture);
+
+    glTexImage2D( m_texTarget, 0, attachment.internalformat, m_width, m_height,
+                  0,
+                  attachment.format, m_type, NULL );
+    // 2.13.2006
+    // GL_LINEAR causes fallback to software shader
+    // so switching back to GL_NEAREST
+    glTexParameteri(m_texTarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(m_texTarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glTexParameterf(m_texTarget, GL_TEXTURE_WRAP_S, wrapmode);
+    glTexParameterf(m_texTarget, GL_TEXTURE_WRAP_T, wrapmode);
+
+    // Bind the texture to the frame buffer.
+    glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT+i,
+                              m_texTarget, attachment.texture, 0);
+    drawbuffers.push_back(GL_COLOR_ATTACHMENT0_EXT+i);
+  }
+  glBindTexture(m_texTarget, 0);
+
+  // Initialize the render buffer.
+  glGenRenderbuffersEXT(1, &m_depthBufferIndex);
+  glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, m_depthBufferIndex);
+  glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_DEPTH_COMPONENT24,
+                           m_width, m_height);
+  glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT,
+                               GL_RENDERBUFFER_EXT, m_depthBufferIndex);
+  if(count>1) {
+    glDrawBuffers(count, &drawbuffers[0]);
+  }
+
+  if(!checkFramebuffer()) {
+    glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, 0);
+    glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
     return;
   }
 
+  // a multisampled framebuffer with the same attachments
+  m_haveSamples=0;
+  if(m_samples>1) {
+    if(!GLEW_EXT_framebuffer_multisample || !GLEW_EXT_framebuffer_blit) {
+      error("multisampled framebuffers are not supported by this system");
+    } else {
+      GLint maxSamples=0;
+      glGetIntegerv(GL_MAX_SAMPLES_EXT, &maxSamples);
+      const int samples=(m_samples>maxSamples)?maxSamples:m_samples;
+
+      glGenFramebuffersEXT(1, &m_msFrameBufferIndex);
+      glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_msFrameBufferIndex);
+      for(unsigned int i=0; i<count; i++) {
+        t_attachment&attachment=m_attachments[i];
+        glGenRenderbuffersEXT(1, &attachment.multisample);
+        glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, attachment.multisample);
+        glRenderbufferStorageMultisampleEXT(GL_RENDERBUFFER_EXT, samples,
+                                            attachment.internalformat,
+                                            m_width, m_height);
+        glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT,
+                                     GL_COLOR_ATTACHMENT0_EXT+i,
+                                     GL_RENDERBUFFER_EXT, attachment.multisample);
+      }
+      glGenRenderbuffersEXT(1, &m_msDepthBufferIndex);
+      glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, m_msDepthBufferIndex);
+      glRenderbufferStorageMultisampleEXT(GL_RENDERBUFFER_EXT, samples,
+                                          GL_DEPTH_COMPONENT24,
+                                          m_width, m_height);
+      glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT,
+                                   GL_RENDERBUFFER_EXT, m_msDepthBufferIndex);
+      if(count>1) {
+        glDrawBuffers(count, &drawbuffers[0]);
+      }
+
+      if(checkFramebuffer()) {
+        m_haveSamples=samples;
+      } else {
+        error("falling back to non-multisampled rendering");
+        destroyMultisample();
+      }
+    }
+  }
+
   // Return out of the frame buffer.
+  glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, 0);
   glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
 
   m_haveinit = true;
@@ -463,6 +625,29 @@ void gemframebuffer :: initFBO()
   printInfo();
 }
 
+////////////////////////////////////////////////////////
+// destroyMultisample
+//
+/////////////////////////////////////////////////////////
+void gemframebuffer :: destroyMultisample()
+{
+  for(unsigned int i=0; i<m_attachments.size(); i++) {
+    if(m_attachments[i].multisample) {
+      glDeleteRenderbuffersEXT(1, &m_attachments[i].multisample);
+    }
+    m_attachments[i].multisample=0;
+  }
+  if(m_msDepthBufferIndex) {
+    glDeleteRenderbuffersEXT(1, &m_msDepthBufferIndex);
+  }
+  if(m_msFrameBufferIndex) {
+    glDeleteFramebuffersEXT(1, &m_msFrameBufferIndex);
+  }
+  m_msDepthBufferIndex=0;
+  m_msFrameBufferIndex=0;
+  m_haveSamples=0;
+}
+
 ////////////////////////////////////////////////////////
 // destroyFBO
 //
@@ -472,15 +657,21 @@ void gemframebuffer :: destroyFBO()
   //if(!GLEW_EXT_framebuffer_object)return;
 
   // Release all resources.
+  destroyMultisample();
   if(m_depthBufferIndex) {
     glDeleteRenderbuffersEXT(1, &m_depthBufferIndex);
   }
   if(m_frameBufferIndex) {
     glDeleteFramebuffersEXT(1, &m_frameBufferIndex);
   }
-  if(m_offScreenID) {
-    glDeleteTextures(1, &m_offScreenID);
+  for(unsigned int i=0; i<m_attachments.size(); i++) {
+    if(m_attachments[i].texture) {
+      glDeleteTextures(1, &m_attachments[i].texture);
+    }
+    m_attachments[i].texture=0;
   }
+  m_depthBufferIndex=0;
+  m_frameBufferIndex=0;
 
   m_haveinit = false;
 }
@@ -573,8 +764,9 @@ void gemframebuffer :: perspectiveMess(t_symbol*s,int argc, t_atom*argv)
 
 
 /* needs to be called with a valid context */
-void gemframebuffer :: fixFormat(GLenum wantFormat)
+void gemframebuffer :: fixFormat(t_attachment&attachment)
 {
+  GLenum wantFormat=attachment.wantFormat;
   if(wantFormat == GL_RGB_FLOAT32_ATI && !GLEW_ATI_texture_float) {
     wantFormat =  GL_RGB;
   }
@@ -584,23 +776,23 @@ void gemframebuffer :: fixFormat(GLenum wantFormat)
   default:
     verbose(1,"using default format");
   case GL_RGB:
-    m_internalformat=m_format=GL_RGB;
+    attachment.internalformat=attachment.format=GL_RGB;
     break;
   case  GL_RGB_FLOAT32_ATI:
-    m_internalformat = GL_RGB_FLOAT32_ATI;
-    m_format = GL_RGB_GEM;
+    attachment.internalformat = GL_RGB_FLOAT32_ATI;
+    attachment.format = GL_RGB_GEM;
     break;
   case  GL_RGBA32F:
-    m_internalformat = GL_RGBA32F;
-    m_format = GL_RGBA;
+    attachment.internalformat = GL_RGBA32F;
+    attachment.format = GL_RGBA;
     break;
   case GL_RGBA:
-    m_internalformat = GL_RGBA;
-    m_format = GL_RGBA_GEM;
+    attachment.internalformat = GL_RGBA;
+    attachment.format = GL_RGBA_GEM;
     break;
   case GL_YUV422_GEM:
-    m_format=GL_YUV422_GEM;
-    m_internalformat=GL_RGB8;
+    attachment.format=GL_YUV422_GEM;
+    attachment.internalformat=GL_RGB8;
 #ifdef __APPLE__
     m_type = GL_UNSIGNED_SHORT_8_8_REV_APPLE;
 #endif
@@ -611,24 +803,35 @@ void gemframebuffer :: fixFormat(GLenum wantFormat)
 
 void gemframebuffer :: formatMess(std::string format)
 {
-  GLenum tmp_format=0;
-  if("YUV"==format) {
-    tmp_format = GL_YUV422_GEM;
-  } else if ("RGB"==format) {
-    tmp_format = GL_RGB;
-  } else if ("RGBA"==format) {
-    tmp_format = GL_RGBA;
-  } else if ("RGB32"==format) {
-    tmp_format =  GL_RGB_FLOAT32_ATI;
-  } else if ("RGBA32F"==format) {
-    tmp_format =  GL_RGBA32F;
-  } else {
+  GLenum tmp_format=getFormat(format);
+  if(!tmp_format) {
     error("unknown format '%s'", format.c_str());
     return;
   }
 
-  if(tmp_format) {
-    m_wantFormat=tmp_format;
+  m_attachments[0].wantFormat=tmp_format;
+  setModified();
+}
+
+void gemframebuffer :: formatsMess(t_symbol*s, int argc, t_atom*argv)
+{
+  if(argc<1 || static_cast<unsigned int>(argc)>m_attachments.size()) {
+    error("'format' takes 1 to %d formats (one per attachment)",
+          static_cast<int>(m_attachments.size()));
+    return;
+  }
+  std::vector<GLenum>formats;
+  for(int i=0; i<argc; i++) {
+    const std::string format=atom_getsymbol(argv+i)->s_name;
+    GLenum tmp_format=getFormat(format);
+    if(!tmp_format) {
+      error("unknown format '%s'", format.c_str());
+      return;
+    }
+    formats.push_back(tmp_format);
+  }
+  for(unsigned int i=0; i<formats.size(); i++) {
+    m_attachments[i].wantFormat=formats[i];
   }
   setModified();
 }
@@ -662,6 +865,11 @@ void gemframebuffer :: texunitMess(int unit)
 {
   m_texunit=static_cast<GLuint>(unit);
 }
+void gemframebuffer :: samplesMess(int samples)
+{
+  m_samples=(samples<0)?0:samples;
+  setModified();
+}
 
 
 
@@ -675,10 +883,11 @@ void gemframebuffer :: obj_setupCallback(t_class *classPtr)
   CPPEXTERN_MSG (classPtr, "color",  colorMess);
   CPPEXTERN_MSG (classPtr, "perspec",  perspectiveMess);
   CPPEXTERN_MSG2(classPtr, "dimen",  dimMess, int, int);
-  CPPEXTERN_MSG1(classPtr, "format", formatMess, std::string);
+  CPPEXTERN_MSG (classPtr, "format", formatsMess);
   CPPEXTERN_MSG1(classPtr, "type",   typeMess, std::string);
   CPPEXTERN_MSG1(classPtr, "rectangle", rectangleMess, bool);
   CPPEXTERN_MSG1(classPtr, "texunit",   texunitMess, int);
+  CPPEXTERN_MSG1(classPtr, "samples",   samplesMess, int);
 
   /* legacy */
   CPPEXTERN_MSG2(classPtr, "dim",    dimMess, int, int);
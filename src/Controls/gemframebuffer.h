@@ -18,6 +18,7 @@
 #include "Base/GemBase.h"
 #include "Gem/GemGL.h"
 #include <iostream>
+#include <vector>
 
 /*-----------------------------------------------------------------
   -------------------------------------------------------------------
@@ -30,6 +31,10 @@
 
   "bang" - sends out a state list
 
+  additional format-arguments (after width, height, format and type)
+  add more colour attachments, which are all written in a single pass
+  (via glDrawBuffers()); each attachment gets its own texture-info outlet
+
   -----------------------------------------------------------------*/
 class GEM_EXTERN gemframebuffer : public GemBase
 {
@@ -53,6 +58,8 @@ protected:
   void         postrender(GemState *state);
   void         initFBO(void);
   void         destroyFBO(void);
+  void         destroyMultisample(void);
+  bool         checkFramebuffer(void);
 
   //////////
   // Set up the modifying flags
@@ -71,6 +78,8 @@ protected:
   //////////
   // format-message
   virtual void formatMess(std::string);
+  // per-attachment formats
+  virtual void formatsMess(t_symbol*,int argc, t_atom*argv);
   virtual void typeMess(std::string);
 
   virtual void colorMess(t_symbol*,int argc, t_atom*argv);
@@ -79,27 +88,44 @@ protected:
   virtual void rectangleMess(bool mode);
   virtual void texunitMess(int mode);
 
-  virtual void fixFormat(GLenum wantedFormat);
+  //////////
+  // multisampling (0 = off)
+  virtual void samplesMess(int samples);
+
+  //////////
+  // a colour attachment (each is rendered into a texture of its own)
+  struct t_attachment {
+    GLenum wantFormat;
+    int internalformat;
+    int format;
+    // the texture holding the result
+    GLuint texture;
+    // the multisampled renderbuffer (resolved into 'texture')
+    GLuint multisample;
+    t_outlet*outTexInfo;
+  };
+
+  virtual void fixFormat(t_attachment&attachment);
   virtual void printInfo(void);
 
 private:
   GLboolean             m_haveinit, m_wantinit;
   GLuint      m_frameBufferIndex;
   GLuint      m_depthBufferIndex;
-  GLuint      m_offScreenID;
+  // the multisampled framebuffer (only if m_samples>1)
+  GLuint      m_msFrameBufferIndex;
+  GLuint      m_msDepthBufferIndex;
   GLuint      m_texTarget;
   GLuint      m_texunit;
   int         m_width, m_height;
   bool        m_rectangle; // 1=TEXTURE_RECTANGLE_EXT, 0=TEXTURE_2D
   GLenum      m_canRectangle; // whichever rectangle formats are supported
-  int         m_internalformat;
-  int         m_format;
-  GLenum      m_wantFormat;
+  std::vector<t_attachment>m_attachments;
   int         m_type;
+  int         m_samples, m_haveSamples;
   GLint       m_vp[4];
   GLfloat     m_color[4];
   GLfloat     m_FBOcolor[4];
-  t_outlet   *m_outTexInfo;
   GLfloat     m_perspect[6];
 
   void        bangMess(void);
@@ -26,6 +26,8 @@
 #include "Base/GemBase.h"
 
 #include "Gem/GLStack.h"
+#include "Gem/VertexPipeline.h"
+#include "Gem/ModelView.h"
 #include "Gem/Exception.h"
 
 #include <stdio.h>
@@ -158,6 +160,7 @@ void gemhead :: renderGL(GemState *state)
       stacks->push();
     }
   }
+  gem::ModelView::discard();
 
   // are we profiling and need to send new images?
   if (GemMan::getProfileLevel() >= 2) {
@@ -171,12 +174,17 @@ void gemhead :: renderGL(GemState *state)
   (ap+1)->a_w.w_gpointer=reinterpret_cast<t_gpointer*>(state);
   outlet_anything(m_outlet, gensym("gem_state"), 2, ap);
 
+  // apply vertex-operations that nobody has asked for
+  gem::vertex::Pipeline::flush(state);
+
   m_cache->dirty = false;
   m_cache->vertexDirty=false;
   if(state) {
     state->get(GemState::_GL_STACKS, stacks);
   }
   if(stacks) {
+    // transformations after the last object would be popped anyhow
+    gem::ModelView::discard();
     stacks->pop();
   }
 }
@@ -29,6 +29,7 @@
 #endif // __APPLE__
 
 #include "Utils/GemMath.h"
+#include "Gem/FrameTiming.h"
 
 CPPEXTERN_NEW_WITH_ONE_ARG(gemwin, t_floatarg, A_DEFFLOAT);
 
@@ -433,6 +434,59 @@ void gemwin :: fpsMess()
   outlet_float(m_FrameRate,GemMan :: fps);
 }
 
+/////////////////////////////////////////////////////////
+// scheduleMess
+//
+/////////////////////////////////////////////////////////
+void gemwin :: scheduleMess(int mode)
+{
+  GemMan::scheduleMode(mode);
+}
+
+/////////////////////////////////////////////////////////
+// timingMess
+//
+/////////////////////////////////////////////////////////
+void gemwin :: timingMess()
+{
+  gem::FrameTiming&timing=GemMan::getTiming();
+  float mean, min, max;
+  t_atom ap[3];
+
+  SETFLOAT(ap+0, timing.getFrames());
+  SETFLOAT(ap+1, timing.getMissed());
+  outlet_anything(m_FrameRate, gensym("frames"), 2, ap);
+
+  timing.getFrameTime(mean, min, max);
+  SETFLOAT(ap+0, mean);
+  SETFLOAT(ap+1, min);
+  SETFLOAT(ap+2, max);
+  outlet_anything(m_FrameRate, gensym("frametime"), 3, ap);
+
+  timing.getRenderTime(mean, max);
+  SETFLOAT(ap+0, mean);
+  SETFLOAT(ap+1, max);
+  outlet_anything(m_FrameRate, gensym("rendertime"), 2, ap);
+
+  SETFLOAT(ap+0, timing.getVsyncPeriod());
+  outlet_anything(m_FrameRate, gensym("vsync"), 1, ap);
+
+  // <binwidth> <count0> <count1>... (omitting the empty bins at the end)
+  const std::vector<unsigned int>&histogram=timing.getHistogram();
+  unsigned int size=histogram.size();
+  while(size>0 && !histogram[size-1]) {
+    size--;
+  }
+  std::vector<t_atom>alist(size+1);
+  SETFLOAT(&alist[0], timing.getBinWidth());
+  for(unsigned int i=0; i<size; i++) {
+    SETFLOAT(&alist[i+1], histogram[i]);
+  }
+  outlet_anything(m_FrameRate, gensym("histogram"), alist.size(), &alist[0]);
+
+  timing.reset();
+}
+
 /////////////////////////////////////////////////////////
 // fsaaMess
 //
@@ -552,6 +606,8 @@ void gemwin :: obj_setupCallback(t_class *classPtr)
                   gensym("frame"), A_FLOAT, A_NULL);
 
   CPPEXTERN_MSG0(classPtr, "fps", fpsMess);
+  CPPEXTERN_MSG1(classPtr, "schedule", scheduleMess, int);
+  CPPEXTERN_MSG0(classPtr, "timing", timingMess);
   CPPEXTERN_MSG1(classPtr, "FSAA", fsaaMess, int);
 }
 void gemwin :: printMessCallback(void *)
@@ -40,6 +40,12 @@
   "dimen" - the window dimensions
   "offset" - the window offset
   "frame" - the frame rate
+  "schedule" - how frames are scheduled
+  - 0 : wait 1/fps after each frame (default)
+  - 1 : finish frames at a fixed rate (compensating for rendering time
+        and adapting to vsync)
+  - 2 : free-running (render the next frame as soon as possible)
+  "timing" - output the frame timing statistics (since the last "timing")
   "lighting" - turn lighting on/off
   "ambient" - the ambient light color
   "specular" - the specular light color
@@ -110,6 +116,8 @@ private:
   void          topmostMess(float setting);
   void          blurMess(float setting);
   void          fpsMess();
+  void          scheduleMess(int mode);
+  void          timingMess();
   void          fsaaMess(int value);
   t_outlet      *m_FrameRate;
 
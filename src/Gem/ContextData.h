@@ -42,7 +42,7 @@ class GEM_EXTERN ContextDataBase
 {
 protected:
   static const int INVALID_CONTEXT;
-  virtual int getCurContext(void);
+  static int getCurContext(void);
   virtual ~ContextDataBase(void);
 };
 
@@ -56,14 +56,33 @@ public:
   //////////
   // Constructor
   /* coverity[uninit_member] we track the un-initialization ourselves */
-  ContextData(void) : m_haveDefaultValue(false) {;}
+  ContextData(void) : m_haveDefaultValue(false), m_values(0), m_size(0) {;}
 
   explicit ContextData(ContextDataType v) : m_haveDefaultValue(true),
-    m_defaultValue(v) {;}
+    m_defaultValue(v), m_values(0), m_size(0) {;}
+
+  ContextData(const ContextData&org) : m_haveDefaultValue(
+      org.m_haveDefaultValue),
+    m_defaultValue(org.m_defaultValue), m_values(0), m_size(0)
+  {
+    copyValues(org);
+  }
+
+  ContextData&operator=(const ContextData&org)
+  {
+    if(&org != this) {
+      m_haveDefaultValue=org.m_haveDefaultValue;
+      m_defaultValue=org.m_defaultValue;
+      copyValues(org);
+    }
+    return (*this);
+  }
 
   virtual ~ContextData()
   {
-    m_ContextDataVector.clear();
+    delete[]m_values;
+    m_values=0;
+    m_size=0;
   }
 
   /**
@@ -75,7 +94,7 @@ public:
    * @note Should only be called from the draw function.
    *        Results are un-defined if there is no valid context
    */
-  virtual operator ContextDataType()
+  operator ContextDataType()
   {
     return (*getPtrToCur());
   }
@@ -87,7 +106,7 @@ public:
    * @note Should only be called from the draw function.
    *       Results are un-defined if there is no valid context
    */
-  virtual ContextDataType&operator = (ContextDataType value)
+  ContextDataType&operator = (ContextDataType value)
   {
     /* simplistic approach to handle out-of-context assignments:
      *  assign the value to all context instances
@@ -105,23 +124,36 @@ public:
 private:
   bool m_haveDefaultValue;
   ContextDataType m_defaultValue;
-  std::vector<ContextDataType*>  m_ContextDataVector;
-
+  /* the values of all contexts, indexed by the context-id
+   * (a plain array rather than a std::vector, which has a
+   * specialization for 'bool' that we cannot point into) */
+  ContextDataType*m_values;
+  unsigned int m_size;
 
-  /* Makes sure that the vector is at least requiredSize large */
+  /* Makes sure that the array is at least requiredSize large */
   void checkSize(unsigned int requiredSize)
   {
-    if(requiredSize > m_ContextDataVector.size()) {
-      m_ContextDataVector.reserve(requiredSize);          // Resize smartly
-      while(m_ContextDataVector.size() <
-            requiredSize) {  // Add any new items needed
-        if(m_haveDefaultValue) {
-          m_ContextDataVector.push_back(new ContextDataType(m_defaultValue));
-        } else {
-          m_ContextDataVector.push_back(new ContextDataType);
-        }
+    if(requiredSize <= m_size) {
+      return;
+    }
+    /* context-ids are small and dense: grow in small steps */
+    unsigned int size=m_size?m_size:4;
+    while(size<requiredSize) {
+      size*=2;
+    }
+    ContextDataType*values=new ContextDataType[size];
+    unsigned int i;
+    for(i=0; i<m_size; i++) {
+      values[i]=m_values[i];
+    }
+    if(m_haveDefaultValue) {
+      for(; i<size; i++) {
+        values[i]=m_defaultValue;
       }
     }
+    delete[]m_values;
+    m_values=values;
+    m_size=size;
   }
 
   /**
@@ -131,22 +163,34 @@ private:
    * @post Synchronized.
    * @note ASSERT: Same context is rendered by same thread each time.
    */
-  ContextDataType* getPtrToCur(void)
+  inline ContextDataType* getPtrToCur(void)
   {
-    // Get current context
-    int context_id = getCurContext();
-    // Cache ref for better performance
-    checkSize(context_id
-              +1);     // Make sure we are large enough (+1 since we have index)
+    const unsigned int context_id = getCurContext();
+    if(context_id >= m_size) {
+      checkSize(context_id+1);
+    }
+    return m_values+context_id;
+  }
 
-    return m_ContextDataVector[context_id];
+  void copyValues(const ContextData&org)
+  {
+    delete[]m_values;
+    m_values=0;
+    m_size=0;
+    if(org.m_size) {
+      m_values=new ContextDataType[org.m_size];
+      m_size=org.m_size;
+      for(unsigned int i=0; i<m_size; i++) {
+        m_values[i]=org.m_values[i];
+      }
+    }
   }
 
   void doSetAll(ContextDataType v)
   {
     unsigned int i=0;
-    for(i=0; i< m_ContextDataVector.size(); i++) {
-      *m_ContextDataVector[i]=v;
+    for(i=0; i<m_size; i++) {
+      m_values[i]=v;
     }
   }
 };
@@ -0,0 +1,337 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "DisplacedGrid.h"
+#include "Gem/ContextData.h"
+
+#include "m_pd.h"
+#include <string>
+
+namespace
+{
+const char*s_prefix =
+  "#version 120\n"
+  "uniform sampler2D displacement;\n"
+  "uniform bool lighting;\n"
+  "vec4 lit(vec4 color, vec3 normal, vec4 position) {\n"
+  "  if(lighting) {\n"
+  "    normal = normalize(gl_NormalMatrix * normal);\n"
+  "    vec3 light = gl_LightSource[0].position.xyz;\n"
+  "    if(gl_LightSource[0].position.w != 0.) {\n"
+  "      light -= vec3(gl_ModelViewMatrix * position);\n"
+  "    }\n"
+  "    float diffuse = max(dot(normal, normalize(light)), 0.);\n"
+  "    color.rgb *= gl_LightModel.ambient.rgb + gl_LightSource[0].ambient.rgb\n"
+  "               + diffuse * gl_LightSource[0].diffuse.rgb;\n"
+  "  }\n"
+  "  return color;\n"
+  "}\n";
+};
+
+namespace gem
+{
+
+class DisplacedGrid::PIMPL
+{
+public:
+  /* the openGL objects of a single context */
+  struct Context {
+    GLuint program;
+    int status; /* 0: not yet tried; 1: ready; -1: failed */
+    GLenum unit; /* the texture unit for the data texture */
+    GLuint texture;
+    unsigned int texVersion;
+    GLint texFormat;
+    GLsizei texWidth, texHeight;
+    unsigned int gridVersion;
+    Context(void)
+      : program(0), status(0)
+      , unit(0)
+      , texture(0), texVersion(0)
+      , texFormat(0), texWidth(0), texHeight(0)
+      , gridVersion(0)
+    {}
+  };
+
+  std::string name;
+  std::string source;
+  GridMesh mesh;
+  unsigned int gridX, gridY;
+  unsigned int gridVersion;
+  gem::ContextData<Context>context;
+
+  /* the state between begin() and end() */
+  GLenum unit;
+  bool active;
+
+  PIMPL(const char*name_, const char*source_)
+    : name(name_), source(source_)
+    , gridX(0), gridY(0)
+    , gridVersion(1)
+    , context(Context())
+    , unit(0)
+    , active(false)
+  {}
+
+  /* build the program and pick a texture unit
+   * returns false if this context cannot displace vertices */
+  bool prepare(Context&ctx)
+  {
+    if(ctx.status) {
+      return (ctx.status>0);
+    }
+    ctx.status=-1;
+
+    /* the fixed function fragment stage only looks at the first few units,
+     * so the data texture goes to the very last one */
+    GLint vertexUnits=0, units=0;
+    glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, &vertexUnits);
+    glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &units);
+    if(vertexUnits<1 || units<2) {
+      verbose(0, "[GEM:%s] no texture access in vertex shaders", name.c_str());
+      return false;
+    }
+    ctx.unit=GL_TEXTURE0+units-1;
+
+    GLuint shader=glCreateShader(GL_VERTEX_SHADER);
+    if(!shader) {
+      return false;
+    }
+    const char*sources[2] = { s_prefix, source.c_str() };
+    glShaderSource(shader, 2, sources, NULL);
+    glCompileShader(shader);
+    GLint compiled=0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if(!compiled) {
+      GLint length=0;
+      glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+      if(length>0) {
+        std::vector<GLchar>log(length+1);
+        glGetShaderInfoLog(shader, length, NULL, &log[0]);
+        verbose(0, "[GEM:%s] compile log: %s", name.c_str(), &log[0]);
+      }
+      glDeleteShader(shader);
+      pd_error(0, "[GEM:%s] unable to build the displacement shader",
+               name.c_str());
+      return false;
+    }
+    GLuint program=glCreateProgram();
+    if(program) {
+      glAttachShader(program, shader);
+      glLinkProgram(program);
+      GLint linked=0;
+      glGetProgramiv(program, GL_LINK_STATUS, &linked);
+      if(!linked) {
+        glDeleteProgram(program);
+        program=0;
+      }
+    }
+    /* the shader is flagged for deletion, and goes away with the program */
+    glDeleteShader(shader);
+    if(!program) {
+      pd_error(0, "[GEM:%s] unable to build the displacement shader",
+               name.c_str());
+      return false;
+    }
+    ctx.program=program;
+    ctx.status=1;
+    return true;
+  }
+
+  /* write the (static) grid to the vertex buffer of the current context */
+  void fillGrid(void)
+  {
+    float*v=mesh.map();
+    if(!v) {
+      return;
+    }
+    for(unsigned int i=0; i<gridX; i++) {
+      for(unsigned int j=0; j<gridY; j++) {
+        v[0]=static_cast<float>(i);
+        v[1]=static_cast<float>(j);
+        v[2]=0.f;
+        v[3]=0.f;
+        v[4]=0.f;
+        v[5]=1.f;
+        v[6]=0.f;
+        v[7]=0.f;
+        v+=GridMesh::STRIDE;
+      }
+    }
+    mesh.unmap();
+  }
+};
+
+/////////////////////////////////////////////////////////
+//
+// DisplacedGrid
+//
+/////////////////////////////////////////////////////////
+DisplacedGrid::DisplacedGrid(const char*name, const char*vertexShader)
+  : m_pimpl(new PIMPL(name, vertexShader))
+{
+}
+DisplacedGrid::~DisplacedGrid(void)
+{
+  delete m_pimpl;
+  m_pimpl=0;
+}
+
+void DisplacedGrid::setSize(unsigned int gridX, unsigned int gridY)
+{
+  if(gridX == m_pimpl->gridX && gridY == m_pimpl->gridY) {
+    return;
+  }
+  m_pimpl->gridX=gridX;
+  m_pimpl->gridY=gridY;
+  m_pimpl->gridVersion++;
+  m_pimpl->mesh.setSize(gridX, gridY);
+}
+
+bool DisplacedGrid::setTexture(unsigned int version, GLint internalFormat,
+                               GLsizei width, GLsizei height,
+                               GLenum format, GLenum type, const void*data)
+{
+  if(!isRunnable() || !data || width<1 || height<1) {
+    return false;
+  }
+  PIMPL::Context ctx=m_pimpl->context;
+  if(!m_pimpl->prepare(ctx)) {
+    m_pimpl->context=ctx;
+    return false;
+  }
+  if(ctx.texture && version == ctx.texVersion) {
+    return true;
+  }
+  if(!ctx.texture) {
+    glGenTextures(1, &ctx.texture);
+    if(!ctx.texture) {
+      m_pimpl->context=ctx;
+      return false;
+    }
+  }
+
+  GLint oldUnit=GL_TEXTURE0;
+  glGetIntegerv(GL_ACTIVE_TEXTURE, &oldUnit);
+  glActiveTexture(ctx.unit);
+  glBindTexture(GL_TEXTURE_2D, ctx.texture);
+  glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  if(internalFormat != ctx.texFormat
+      || width != ctx.texWidth || height != ctx.texHeight) {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0,
+                 format, type, data);
+    ctx.texFormat=internalFormat;
+    ctx.texWidth=width;
+    ctx.texHeight=height;
+  } else {
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height,
+                    format, type, data);
+  }
+  glPopClientAttrib();
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glActiveTexture(oldUnit);
+
+  ctx.texVersion=version;
+  m_pimpl->context=ctx;
+  return true;
+}
+
+bool DisplacedGrid::begin(void)
+{
+  if(!isRunnable() || !m_pimpl->mesh.size()) {
+    return false;
+  }
+  /* leave the active program alone */
+  GLint program=0;
+  glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+  if(program) {
+    return false;
+  }
+
+  PIMPL::Context ctx=m_pimpl->context;
+  if(!ctx.texture || !m_pimpl->prepare(ctx)) {
+    m_pimpl->context=ctx;
+    return false;
+  }
+  if(ctx.gridVersion != m_pimpl->gridVersion) {
+    m_pimpl->fillGrid();
+    ctx.gridVersion=m_pimpl->gridVersion;
+  }
+  m_pimpl->context=ctx;
+
+  GLint oldUnit=GL_TEXTURE0;
+  glGetIntegerv(GL_ACTIVE_TEXTURE, &oldUnit);
+  glActiveTexture(ctx.unit);
+  glBindTexture(GL_TEXTURE_2D, ctx.texture);
+  glActiveTexture(oldUnit);
+
+  glUseProgram(ctx.program);
+  glUniform1i(glGetUniformLocation(ctx.program, "displacement"),
+              ctx.unit-GL_TEXTURE0);
+  glUniform1i(glGetUniformLocation(ctx.program, "lighting"),
+              glIsEnabled(GL_LIGHTING));
+  m_pimpl->unit=ctx.unit;
+  m_pimpl->active=true;
+  return true;
+}
+
+GLint DisplacedGrid::uniform(const char*name)
+{
+  GLint program=0;
+  glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+  return program?glGetUniformLocation(program, name):-1;
+}
+
+bool DisplacedGrid::draw(GLenum mode, GridMesh::Layout layout)
+{
+  return m_pimpl->active && m_pimpl->mesh.draw(mode, layout);
+}
+
+void DisplacedGrid::end(void)
+{
+  if(!m_pimpl->active) {
+    return;
+  }
+  glUseProgram(0);
+  GLint oldUnit=GL_TEXTURE0;
+  glGetIntegerv(GL_ACTIVE_TEXTURE, &oldUnit);
+  glActiveTexture(m_pimpl->unit);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glActiveTexture(oldUnit);
+  m_pimpl->active=false;
+}
+
+void DisplacedGrid::release(void)
+{
+  PIMPL::Context ctx=m_pimpl->context;
+  if(ctx.program) {
+    glDeleteProgram(ctx.program);
+  }
+  if(ctx.texture) {
+    glDeleteTextures(1, &ctx.texture);
+  }
+  m_pimpl->mesh.release();
+  m_pimpl->context=PIMPL::Context();
+}
+
+bool DisplacedGrid::isRunnable(void)
+{
+  return GLEW_VERSION_2_0 && GridMesh::isRunnable();
+}
+};
@@ -0,0 +1,88 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    DisplacedGrid.h
+       - a static grid that is displaced in a vertex shader
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_GEM_DISPLACEDGRID_H_
+#define _INCLUDE__GEM_GEM_DISPLACEDGRID_H_
+
+#include "Gem/GridMesh.h"
+
+namespace gem
+{
+/**
+ * a regular grid of gridX*gridY vertices that is displaced on the GPU
+ * (e.g. by the pixels of an image, or by a set of control points)
+ *
+ * the grid itself is only uploaded when its size changes:
+ * vertex [i][j] is simply (i, j, 0), and the vertex shader turns it
+ * into the final position by sampling the data texture,
+ * which is all that needs to be updated per frame
+ *
+ * the program consists of a vertex shader only, so the fragments
+ * are processed by the fixed function pipeline (e.g. texturing by [pix_texture])
+ * the shader source is prefixed (GLSL 1.20) with:
+ *   - uniform sampler2D displacement; (the data texture)
+ *   - vec4 lit(vec4 color, vec3 normal, vec4 position);
+ *     (simple diffuse lighting by the first light, if lighting is enabled)
+ *
+ * if a GLSL program is already active, the grid refuses to draw
+ * (so the caller can fall back to the CPU, and user shaders still work)
+ * all methods but setSize() must be called with a valid openGL context
+ */
+class GEM_EXTERN DisplacedGrid
+{
+private:
+  class PIMPL;
+  PIMPL*m_pimpl;
+
+  /* dummy implementations */
+  DisplacedGrid(const DisplacedGrid&);
+  DisplacedGrid&operator=(const DisplacedGrid&);
+
+public:
+  /* 'name' is used for error messages */
+  DisplacedGrid(const char*name, const char*vertexShader);
+  virtual ~DisplacedGrid(void);
+
+  void setSize(unsigned int gridX, unsigned int gridY);
+
+  /* upload the data texture to the current context,
+   * unless it already holds the given 'version' of the data
+   * ('format' and 'type' describe 'data', as with glTexImage2D())
+   * the texture is sampled with GL_NEAREST and GL_CLAMP_TO_EDGE
+   * returns false if there is no data texture
+   */
+  bool setTexture(unsigned int version, GLint internalFormat,
+                  GLsizei width, GLsizei height,
+                  GLenum format, GLenum type, const void*data);
+
+  /* bind the program and the data texture
+   * returns false if the grid cannot be drawn
+   * (the caller should then draw on the CPU)
+   */
+  bool begin(void);
+  /* the location of a uniform in the bound program */
+  GLint uniform(const char*name);
+  /* see GridMesh::draw() */
+  bool draw(GLenum mode, GridMesh::Layout layout);
+  void end(void);
+
+  /* release the openGL resources of the current context */
+  void release(void);
+
+  /* whether the current openGL context can displace vertices */
+  static bool isRunnable(void);
+};
+};
+
+#endif /* _INCLUDE__GEM_GEM_DISPLACEDGRID_H_ */
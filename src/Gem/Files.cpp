@@ -3,11 +3,15 @@
 #ifdef _WIN32
 #define _WIN32_WINNT 0x0400
 # include <io.h>
+# include <direct.h>
 # include <windows.h>
 #else
 # include <glob.h>
 # include <unistd.h>
 #endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <errno.h>
 
 #include "Files.h"
 
@@ -204,6 +208,28 @@ void close(int fd)
 #endif
 }
 
+bool makeDirectory(const std::string&path)
+{
+  if(path.empty()) {
+    return false;
+  }
+  /* create all the parent directories first */
+  std::string::size_type pos=path.find_last_of("/\\");
+  if(pos!=std::string::npos && pos>0 && pos+1<path.size()) {
+    const std::string parent=path.substr(0, pos);
+    struct stat st;
+    if(0!=stat(parent.c_str(), &st)) {
+      makeDirectory(parent);
+    }
+  }
+#ifdef _WIN32
+  int err=::_mkdir(path.c_str());
+#else
+  int err=::mkdir(path.c_str(), 0777);
+#endif
+  return (0==err || EEXIST==errno);
+}
+
 
 };
 };
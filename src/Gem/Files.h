@@ -39,6 +39,9 @@ GEM_EXTERN std::string getFullpath(const std::string&,
                                    const CPPExtern*obj=NULL);
 
 GEM_EXTERN void close(int fd);
+
+/* create a directory (and all its parents); returns true if it exists afterwards */
+GEM_EXTERN bool makeDirectory(const std::string&path);
 };
 };
 
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "FrameTiming.h"
+
+namespace
+{
+/* weight of the latest frame in the smoothed estimates */
+const double SMOOTHING=0.1;
+/* a swap that takes longer than this (in ms) is assumed to wait for vsync */
+const double BLOCKINGSWAP=1.;
+/* forget about vsync after that many frames that didn't wait for it */
+const unsigned int UNBLOCKED=10;
+};
+
+namespace gem
+{
+FrameTiming::FrameTiming(float binwidth, unsigned int numbins)
+  : m_binwidth((binwidth>0.f)?binwidth:1.f)
+  , m_histogram((numbins>1)?numbins:2, 0)
+  , m_frames(0), m_intervals(0), m_missed(0)
+  , m_intervalSum(0.), m_intervalMin(0.), m_intervalMax(0.)
+  , m_renderSum(0.), m_renderMax(0.)
+  , m_renderEstimate(0.)
+  , m_vsyncEstimate(0.)
+  , m_unblocked(0)
+{
+}
+FrameTiming::~FrameTiming(void)
+{
+}
+
+void FrameTiming::reset(void)
+{
+  for(unsigned int i=0; i<m_histogram.size(); i++) {
+    m_histogram[i]=0;
+  }
+  m_frames=m_intervals=m_missed=0;
+  m_intervalSum=m_intervalMin=m_intervalMax=0.;
+  m_renderSum=m_renderMax=0.;
+}
+
+void FrameTiming::add(double interval, double rendertime, double swaptime,
+                      bool missed)
+{
+  m_frames++;
+  if(missed) {
+    m_missed++;
+  }
+
+  m_renderSum+=rendertime;
+  if(rendertime>m_renderMax) {
+    m_renderMax=rendertime;
+  }
+  if(m_renderEstimate>0.) {
+    m_renderEstimate+=SMOOTHING*(rendertime-m_renderEstimate);
+  } else {
+    m_renderEstimate=rendertime;
+  }
+  /* react immediately to spikes, so we don't miss the next deadline as well */
+  if(rendertime>m_renderEstimate) {
+    m_renderEstimate=rendertime;
+  }
+
+  if(interval<=0.) {
+    return;
+  }
+
+  if(swaptime<0.) {
+    /* the swap is done elsewhere (e.g. in another thread),
+     * so we cannot tell whether it waits for the display */
+    m_unblocked=0;
+    m_vsyncEstimate=0.;
+  } else if(swaptime>BLOCKINGSWAP) {
+    /* the swap waited for the display: the frames are paced by vsync */
+    m_unblocked=0;
+    if(m_vsyncEstimate>0.) {
+      m_vsyncEstimate+=SMOOTHING*(interval-m_vsyncEstimate);
+    } else {
+      m_vsyncEstimate=interval;
+    }
+  } else if(m_vsyncEstimate>0. && ++m_unblocked>UNBLOCKED) {
+    m_vsyncEstimate=0.;
+  }
+
+  if(!m_intervals || interval<m_intervalMin) {
+    m_intervalMin=interval;
+  }
+  if(interval>m_intervalMax) {
+    m_intervalMax=interval;
+  }
+  m_intervalSum+=interval;
+  m_intervals++;
+
+  unsigned int bin=static_cast<unsigned int>(interval/m_binwidth);
+  if(bin>=m_histogram.size()) {
+    bin=m_histogram.size()-1;
+  }
+  m_histogram[bin]++;
+}
+
+unsigned int FrameTiming::getFrames(void) const
+{
+  return m_frames;
+}
+unsigned int FrameTiming::getMissed(void) const
+{
+  return m_missed;
+}
+void FrameTiming::getFrameTime(float&mean, float&min, float&max) const
+{
+  mean=(m_intervals)?(m_intervalSum/m_intervals):0.;
+  min=m_intervalMin;
+  max=m_intervalMax;
+}
+void FrameTiming::getRenderTime(float&mean, float&max) const
+{
+  mean=(m_frames)?(m_renderSum/m_frames):0.;
+  max=m_renderMax;
+}
+const std::vector<unsigned int>&FrameTiming::getHistogram(void) const
+{
+  return m_histogram;
+}
+float FrameTiming::getBinWidth(void) const
+{
+  return m_binwidth;
+}
+double FrameTiming::getPredictedRenderTime(void) const
+{
+  return m_renderEstimate;
+}
+double FrameTiming::getVsyncPeriod(void) const
+{
+  return m_vsyncEstimate;
+}
+};
@@ -0,0 +1,89 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    FrameTiming.h
+       - statistics about the time it takes to render frames
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_GEM_FRAMETIMING_H_
+#define _INCLUDE__GEM_GEM_FRAMETIMING_H_
+
+#include "Gem/ExportDef.h"
+#include <vector>
+
+namespace gem
+{
+/**
+ * collects the timing of rendered frames (all times are in milliseconds)
+ *
+ * besides the statistics (and a histogram of the frame intervals),
+ * this keeps smoothed estimates of the rendering time and of the
+ * display's refresh period, that can be used to schedule the next frame
+ */
+class GEM_EXTERN FrameTiming
+{
+public:
+  FrameTiming(float binwidth=1.f, unsigned int numbins=100);
+  virtual ~FrameTiming(void);
+
+  /* forget the statistics (but keep the estimates) */
+  void reset(void);
+
+  /*
+   * add a rendered frame
+   *  'interval': time since the previous frame was finished (0 for the first)
+   *  'rendertime': time spent rendering (without swapping)
+   *  'swaptime': time spent swapping the buffers
+   *              (negative if the buffers are not swapped synchronously,
+   *               e.g. in a separate thread: no refresh period is estimated then)
+   *  'missed': whether the frame was finished too late
+   */
+  void add(double interval, double rendertime, double swaptime, bool missed);
+
+  unsigned int getFrames(void) const;
+  unsigned int getMissed(void) const;
+
+  /* frame intervals (since the last reset()) */
+  void getFrameTime(float&mean, float&min, float&max) const;
+  /* rendering time (since the last reset()) */
+  void getRenderTime(float&mean, float&max) const;
+
+  /*
+   * histogram of the frame intervals
+   * bin #i holds the frames with an interval in [i*binwidth, (i+1)*binwidth[
+   * the last bin holds all the longer frames
+   */
+  const std::vector<unsigned int>&getHistogram(void) const;
+  float getBinWidth(void) const;
+
+  /* the expected time to render the next frame */
+  double getPredictedRenderTime(void) const;
+  /*
+   * the refresh period of the display,
+   * if swapping the buffers appears to wait for the vertical sync
+   * (else 0)
+   */
+  double getVsyncPeriod(void) const;
+
+private:
+  float m_binwidth;
+  std::vector<unsigned int>m_histogram;
+
+  unsigned int m_frames, m_intervals, m_missed;
+  double m_intervalSum, m_intervalMin, m_intervalMax;
+  double m_renderSum, m_renderMax;
+
+  double m_renderEstimate;
+  double m_vsyncEstimate;
+  unsigned int m_unblocked;
+};
+};
+
+#endif /* _INCLUDE__GEM_GEM_FRAMETIMING_H_ */
@@ -0,0 +1,268 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "GridMesh.h"
+
+namespace
+{
+/* the k-th vertex of the strip that alternates between two rows */
+inline GLuint stripIndex(GLuint row, GLuint next, unsigned int k)
+{
+  return (k&1)?(next+k/2):(row+k/2);
+}
+};
+
+namespace gem
+{
+GridMesh::GridMesh(void)
+  : m_gridX(0), m_gridY(0)
+  , m_mapped(false)
+  , m_indexLayout(-1), m_indexPrimitive(-1)
+  , m_indexVersion(1)
+  , m_context(Context())
+{
+}
+GridMesh::~GridMesh(void)
+{
+}
+
+void GridMesh::setSize(unsigned int gridX, unsigned int gridY)
+{
+  if(gridX == m_gridX && gridY == m_gridY) {
+    return;
+  }
+  m_gridX=gridX;
+  m_gridY=gridY;
+  /* force a rebuild of the connectivity */
+  m_indexLayout=-1;
+  std::vector<float>().swap(m_vertices);
+}
+unsigned int GridMesh::size(void) const
+{
+  return m_gridX*m_gridY;
+}
+
+float*GridMesh::map(void)
+{
+  if(!isRunnable() || !size()) {
+    return 0;
+  }
+  Context ctx=m_context;
+  if(!ctx.vbo) {
+    glGenBuffers(1, &ctx.vbo);
+  }
+  if(!ctx.vbo) {
+    return 0;
+  }
+  const GLsizeiptr bytes=size()*STRIDE*sizeof(float);
+  glBindBuffer(GL_ARRAY_BUFFER, ctx.vbo);
+  /* orphan the old storage, so we don't have to wait until the GPU
+   * is done with the last frame */
+  glBufferData(GL_ARRAY_BUFFER, bytes, 0, GL_STREAM_DRAW);
+  ctx.vboSize=bytes;
+  m_context=ctx;
+
+  void*ptr=0;
+  if(glMapBufferRange) {
+    ptr=glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes,
+                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  } else if(glMapBuffer) {
+    ptr=glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+  }
+  m_mapped=(0!=ptr);
+  if(m_mapped) {
+    return static_cast<float*>(ptr);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  m_vertices.resize(size()*STRIDE);
+  return &m_vertices[0];
+}
+
+void GridMesh::unmap(void)
+{
+  Context ctx=m_context;
+  if(!ctx.vbo) {
+    return;
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, ctx.vbo);
+  if(m_mapped) {
+    /* if the data got lost (e.g. a mode switch), we will
+     * simply draw garbage for a single frame */
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    m_mapped=false;
+  } else if(!m_vertices.empty()) {
+    glBufferSubData(GL_ARRAY_BUFFER, 0, m_vertices.size()*sizeof(float),
+                    &m_vertices[0]);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GridMesh::buildIndices(Layout layout, int primitive)
+{
+  m_indices.clear();
+  m_indexLayout=layout;
+  m_indexPrimitive=primitive;
+  m_indexVersion++;
+  if(m_gridX<2 || m_gridY<2) {
+    return;
+  }
+
+  const GLuint gridY=m_gridY;
+  const unsigned int cells=(m_gridX-1)*(m_gridY-1);
+  m_indices.reserve(cells*((TRIANGLES==primitive)?6:8));
+
+  for(GLuint i=0; i+1<m_gridX; i++) {
+    const GLuint row=i*gridY;
+    const GLuint next=row+gridY;
+    if(STRIPS == layout) {
+      const unsigned int n=2*gridY;
+      unsigned int k;
+      if(TRIANGLES == primitive) {
+        /* keep the winding of every other triangle */
+        for(k=0; k+2<n; k++) {
+          m_indices.push_back(stripIndex(row, next, (k&1)?(k+1):k));
+          m_indices.push_back(stripIndex(row, next, (k&1)?k:(k+1)));
+          m_indices.push_back(stripIndex(row, next, k+2));
+        }
+      } else {
+        for(k=0; k+1<n; k++) {
+          m_indices.push_back(stripIndex(row, next, k));
+          m_indices.push_back(stripIndex(row, next, k+1));
+        }
+      }
+      continue;
+    }
+    for(GLuint j=0; j+1<gridY; j++) {
+      const GLuint q0=row+j;
+      const GLuint q1=row+j+1;
+      const GLuint q2=next+j+1;
+      const GLuint q3=next+j;
+      if(TRIANGLES == primitive) {
+        m_indices.push_back(q0);
+        m_indices.push_back(q1);
+        m_indices.push_back(q2);
+        m_indices.push_back(q0);
+        m_indices.push_back(q2);
+        m_indices.push_back(q3);
+      } else {
+        m_indices.push_back(q0);
+        m_indices.push_back(q1);
+        m_indices.push_back(q1);
+        m_indices.push_back(q2);
+        m_indices.push_back(q2);
+        m_indices.push_back(q3);
+        m_indices.push_back(q3);
+        m_indices.push_back(q0);
+      }
+    }
+  }
+}
+
+bool GridMesh::draw(GLenum mode, Layout layout, bool normals)
+{
+  if(!isRunnable()) {
+    return false;
+  }
+  int primitive=POINTS;
+  switch(mode) {
+  case GL_POINTS:
+    primitive=POINTS;
+    break;
+  case GL_LINES:
+  case GL_LINE_STRIP:
+  case GL_LINE_LOOP:
+    primitive=LINES;
+    break;
+  case GL_TRIANGLES:
+  case GL_TRIANGLE_STRIP:
+  case GL_TRIANGLE_FAN:
+  case GL_QUADS:
+  case GL_QUAD_STRIP:
+  case GL_POLYGON:
+    primitive=TRIANGLES;
+    break;
+  default:
+    return false;
+  }
+
+  Context ctx=m_context;
+  if(!ctx.vbo || !ctx.vboSize) {
+    /* nothing has been written yet */
+    return false;
+  }
+  if(POINTS != primitive) {
+    if(layout != m_indexLayout || primitive != m_indexPrimitive) {
+      buildIndices(layout, primitive);
+    }
+    if(m_indices.empty()) {
+      return true;
+    }
+    if(!ctx.ibo) {
+      glGenBuffers(1, &ctx.ibo);
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ctx.ibo);
+    if(ctx.iboVersion != m_indexVersion) {
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size()*sizeof(GLuint),
+                   &m_indices[0], GL_STATIC_DRAW);
+      ctx.iboVersion=m_indexVersion;
+    }
+    m_context=ctx;
+  }
+
+  const GLsizei stride=STRIDE*sizeof(float);
+  const float*data=0;
+  glBindBuffer(GL_ARRAY_BUFFER, ctx.vbo);
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(3, GL_FLOAT, stride, data);
+  if(normals) {
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glNormalPointer(GL_FLOAT, stride, data+3);
+  }
+  if(glClientActiveTexture) {
+    glClientActiveTexture(GL_TEXTURE0);
+  }
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glTexCoordPointer(2, GL_FLOAT, stride, data+6);
+
+  if(POINTS == primitive) {
+    glDrawArrays(GL_POINTS, 0, size());
+  } else {
+    glDrawElements((LINES == primitive)?GL_LINES:GL_TRIANGLES,
+                   m_indices.size(), GL_UNSIGNED_INT, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  }
+
+  glPopClientAttrib();
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  return true;
+}
+
+void GridMesh::release(void)
+{
+  Context ctx=m_context;
+  if(ctx.vbo && glDeleteBuffers) {
+    glDeleteBuffers(1, &ctx.vbo);
+  }
+  if(ctx.ibo && glDeleteBuffers) {
+    glDeleteBuffers(1, &ctx.ibo);
+  }
+  m_context=Context();
+}
+
+bool GridMesh::isRunnable(void)
+{
+  return glGenBuffers && glBindBuffer && glBufferData && glBufferSubData;
+}
+};
@@ -0,0 +1,115 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    GridMesh.h
+       - animated geometry on a regular grid
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_GEM_GRIDMESH_H_
+#define _INCLUDE__GEM_GEM_GRIDMESH_H_
+
+#include "Gem/GemGL.h"
+#include "Gem/ContextData.h"
+#include <vector>
+
+namespace gem
+{
+/**
+ * a regular grid of gridX*gridY vertices that change every frame
+ * (e.g. the surface of a simulation), drawn from a streaming
+ * vertex buffer object
+ *
+ * vertex [i][j] lives at index i*gridY+j, and consists of
+ * STRIDE floats: x/y/z, nx/ny/nz, s/t
+ *
+ * the vertices are written (each frame) between map() and unmap(),
+ * the connectivity is generated once per grid size and drawing style
+ * and kept in an index buffer
+ * all methods must be called with a valid openGL context
+ */
+class GEM_EXTERN GridMesh
+{
+public:
+  static const unsigned int STRIDE=8;
+
+  /* how the vertices are connected */
+  enum Layout {
+    /* a strip for each column i, alternating between [i][j] and [i+1][j]
+     * (like [newWave]) */
+    STRIPS,
+    /* a quad for each cell: [i][j], [i][j+1], [i+1][j+1], [i+1][j]
+     * (like [ripple] and [rubber]) */
+    CELLS
+  };
+
+  GridMesh(void);
+  virtual ~GridMesh(void);
+
+  void setSize(unsigned int gridX, unsigned int gridY);
+  unsigned int size(void) const;
+
+  /* get a pointer to size()*STRIDE floats to write the vertices to
+   * (the vertex buffer itself if it can be mapped, else a copy that
+   * is uploaded by unmap())
+   * the previous content is undefined, so all vertices must be written
+   * returns NULL if there are no vertex buffers
+   */
+  float*map(void);
+  void unmap(void);
+
+  /* draw the vertices with the given openGL primitive
+   *   GL_POINTS: all vertices
+   *   GL_LINE_STRIP, GL_LINE_LOOP, GL_LINES: the outlines of the primitives
+   *   GL_TRIANGLE_STRIP, GL_POLYGON,...: filled
+   * returns false if the vertices cannot be drawn this way
+   * (the caller should then fall back to immediate mode)
+   */
+  bool draw(GLenum mode, Layout layout, bool normals=true);
+
+  /* release the openGL resources of the current context */
+  void release(void);
+
+  /* whether the current openGL context has vertex buffer objects */
+  static bool isRunnable(void);
+
+private:
+  GridMesh(const GridMesh&);
+  GridMesh&operator=(const GridMesh&);
+
+  enum { POINTS=0, LINES, TRIANGLES };
+  void buildIndices(Layout layout, int primitive);
+
+  unsigned int m_gridX, m_gridY;
+
+  /* the vertices, if the buffer cannot be mapped */
+  std::vector<float>m_vertices;
+  bool m_mapped;
+
+  /* the connectivity, shared by all contexts */
+  std::vector<GLuint>m_indices;
+  int m_indexLayout, m_indexPrimitive;
+  unsigned int m_indexVersion;
+
+  /* the openGL objects of a single context */
+  struct Context {
+    GLuint vbo;
+    GLsizeiptr vboSize;
+    GLuint ibo;
+    unsigned int iboVersion;
+    Context(void)
+      : vbo(0), vboSize(0)
+      , ibo(0), iboVersion(0)
+    {}
+  };
+  gem::ContextData<Context>m_context;
+};
+};
+
+#endif /* _INCLUDE__GEM_GEM_GRIDMESH_H_ */
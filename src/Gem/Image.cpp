@@ -27,6 +27,7 @@
 #include "Image.h"
 #include "GemGL.h"
 #include "PixConvert.h"
+#include "ImageCompress.h"
 #include "Utils/Functions.h"
 // utility functions from PeteHelpers.h
 //#include "Utils/PixPete.h"
@@ -170,6 +171,12 @@ namespace {
     case GL_RGB: return "RGB";
     case GL_RGBA: return "RGBA";
     case GL_YUV422_GEM: return "YUV422";
+    case GEM_BC1: return "BC1";
+    case GEM_BC3: return "BC3";
+    case GEM_BC3_YCOCG: return "BC3_YCoCg";
+    case GEM_BC7: return "BC7";
+    case GEM_ETC2: return "ETC2";
+    case GEM_ETC2A: return "ETC2_EAC";
     default: break;
     }
     sprintf(buf, "<format:%d>", format);
@@ -208,6 +215,8 @@ namespace {
 
 pixBlock :: pixBlock(void)
   : image(imageStruct()), newimage(0), newfilm(0)
+  , texture(0), textureTarget(0)
+  , readonly(false)
 {}
 
 
@@ -288,7 +297,7 @@ GEM_EXTERN unsigned char* imageStruct::allocate(size_t size)
 
 GEM_EXTERN unsigned char* imageStruct::allocate(void)
 {
-  return allocate(xsize*ysize*csize*type2size(type));
+  return allocate(getDataSize());
 }
 
 GEM_EXTERN unsigned char* imageStruct::reallocate(size_t size)
@@ -305,7 +314,7 @@ GEM_EXTERN unsigned char* imageStruct::reallocate(size_t size)
 }
 GEM_EXTERN unsigned char* imageStruct::reallocate(void)
 {
-  return reallocate(xsize*ysize*csize*type2size(type));
+  return reallocate(getDataSize());
 }
 
 GEM_EXTERN void imageStruct::clear(void)
@@ -372,7 +381,7 @@ static bool copy_imagestruct2imagestruct(const imageStruct*from,
     return false;
   }
 
-  memcpy(to->data, from->data, from->xsize*from->ysize*from->csize*type2size(from->type));
+  memcpy(to->data, from->data, from->getDataSize());
   return true;
 }
 
@@ -399,13 +408,14 @@ GEM_EXTERN void imageStruct::refreshImage(imageStruct *to) const
       to->ysize != ysize ||
       to->csize != csize ||
       to->type != type ||
+      (!csize && to->format != format) ||
       !to->data) {
     to->clear();
     copy2Image(to);
   } else
     // copy the data over
   {
-    memcpy(to->data, this->data, to->xsize * to->ysize * to->csize * type2size(to->type));
+    memcpy(to->data, this->data, to->getDataSize());
   }
 }
 
@@ -448,6 +458,17 @@ GEM_EXTERN int imageStruct::setCsizeByFormat(int setformat)
     csize=3;
     break;
 
+  case GEM_BC1:
+  case GEM_BC3:
+  case GEM_BC3_YCOCG:
+  case GEM_BC7:
+  case GEM_ETC2:
+  case GEM_ETC2A:
+    format=setformat;
+    type=GL_UNSIGNED_BYTE;
+    csize=0;
+    break;
+
   case GL_RGBA:
   case GL_BGRA:
   default:
@@ -478,6 +499,32 @@ GEM_EXTERN int imageStruct::setCsizeByFormat(void)
   return setCsizeByFormat(format);
 }
 
+GEM_EXTERN unsigned int imageStruct::blockSize(unsigned int fmt)
+{
+  switch(fmt) {
+  case GEM_BC1:
+  case GEM_ETC2:
+    return 8;
+  case GEM_BC3:
+  case GEM_BC3_YCOCG:
+  case GEM_BC7:
+  case GEM_ETC2A:
+    return 16;
+  default:
+    break;
+  }
+  return 0;
+}
+GEM_EXTERN size_t imageStruct::getDataSize(void) const
+{
+  const size_t blocksize=blockSize(format);
+  if(blocksize) {
+    /* partial blocks at the right and bottom edge are stored as whole blocks */
+    return ((xsize+3)/4) * ((ysize+3)/4) * blocksize;
+  }
+  return xsize*ysize*csize*type2size(type);
+}
+
 void pix_addsat(unsigned char *leftPix, unsigned char *rightPix,
                 size_t datasize)
 {
@@ -570,6 +617,23 @@ GEM_EXTERN bool imageStruct::convertFrom(const imageStruct *from,
 
   upsidedown=from->upsidedown;
 
+  if(blockSize(from->format) || blockSize(format)) {
+    /* block compressed images are converted via RGBA */
+    imageStruct rgba;
+    const imageStruct*src=from;
+    if(blockSize(from->format)) {
+      if(!gem::image::compress::decode(*from, rgba)) {
+        pd_error(0, "%s: unable to convert from %s", __FUNCTION__, format2name(from->format));
+        return false;
+      }
+      src=&rgba;
+    }
+    if(blockSize(format)) {
+      return gem::image::compress::encode(*src, *this, format);
+    }
+    return convertFrom(src);
+  }
+
   bool fixOrder = needsReverseOrdering(from->type);
 
   switch (from->format) {
@@ -1236,6 +1300,11 @@ GEM_EXTERN void imageStruct::fixUpDown(void)
   if(upsidedown) {
     return;  /* everything's fine! */
   }
+  if(blockSize(format)) {
+    /* the pixels are scattered across the blocks;
+     * leave the flipping to the texture coordinates */
+    return;
+  }
 
   int linewidth = xsize*csize;
   unsigned char*line = new unsigned char[linewidth];
@@ -64,6 +64,18 @@ const int chY0    = 1;
 const int chV     = 2;
 const int chY1    = 3;
 
+/* block compressed (GPU) formats: 4x4 pixels are stored in 8 resp. 16 bytes
+ * these images can only be uploaded to textures (or converted to RGBA) */
+#define GEM_BC1   0x83F0 /* GL_COMPRESSED_RGB_S3TC_DXT1_EXT */
+#define GEM_BC3   0x83F3 /* GL_COMPRESSED_RGBA_S3TC_DXT5_EXT */
+#define GEM_BC7   0x8E8C /* GL_COMPRESSED_RGBA_BPTC_UNORM_ARB */
+#define GEM_ETC2  0x9274 /* GL_COMPRESSED_RGB8_ETC2 */
+#define GEM_ETC2A 0x9278 /* GL_COMPRESSED_RGBA8_ETC2_EAC */
+/* BC3 blocks holding scaled YCoCg (RGBA = Co, Cg, scale, Y), as used by HAP Q
+ * there is no openGL format for this: it is uploaded as BC3 and
+ * converted to RGB by a shader */
+#define GEM_BC3_YCOCG 0x183F3
+
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
 CLASS
@@ -103,6 +115,7 @@ struct GEM_EXTERN imageStruct {
 
   //////////
   // (average) width of 1 pixel (LUMINANCE = 1, RGBA = 4, YUV = 2)
+  // block compressed formats (e.g. GEM_BC1) have a csize of 0
   int csize;
 
   //////////
@@ -171,6 +184,15 @@ struct GEM_EXTERN imageStruct {
   virtual int setCsizeByFormat(int format);
   virtual int setCsizeByFormat(void);
 
+  /* the number of bytes a 4x4 block of pixels occupies in a block compressed
+   * format (e.g. 8 for GEM_BC1), or 0 if the format is not block compressed
+   */
+  static unsigned int blockSize(unsigned int format);
+  /* the size of the image-data in bytes
+   * (xsize*ysize*csize, unless the image is block compressed)
+   */
+  virtual size_t getDataSize(void) const;
+
 
   /* various copy functions
    * sometimes we want to copy the whole image (including pixel-data),
@@ -292,6 +314,21 @@ struct GEM_EXTERN pixBlock {
   // keeps track of when new films are loaded
   // (useful for rectangle_textures on macOS)
   bool newfilm;
+
+  //////////
+  // texture-resident images
+  // if 'texture' is non-zero, the pixels live in this openGL texture
+  // (bound to 'textureTarget') rather than in image.data;
+  // 'image' still describes the size, format and orientation of the pixels
+  // (see gem::image::GPUFilter for reading them back into host memory)
+  unsigned int texture;
+  unsigned int textureTarget;
+
+  //////////
+  // if 'readonly' is set, image.data refers to memory that must not be
+  // modified (e.g. images shared with the image cache);
+  // objects that want to process such an image in place, need to copy it first
+  bool readonly;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,384 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "ImageCompress.h"
+#include "Gem/Image.h"
+#include "Gem/GemGL.h"
+#include "Utils/ThreadPool.h"
+
+#include <string.h>
+
+namespace
+{
+/* a 4x4 block of pixels, as R, G, B, A */
+typedef unsigned char Block[16][4];
+
+inline unsigned short pack565(const unsigned char*rgb)
+{
+  return static_cast<unsigned short>(
+           (((rgb[0]*31+127)/255)<<11) |
+           (((rgb[1]*63+127)/255)<< 5) |
+           (((rgb[2]*31+127)/255)    ));
+}
+inline void unpack565(unsigned short c, unsigned char*rgb)
+{
+  const unsigned int r=(c>>11)&0x1F, g=(c>>5)&0x3F, b=c&0x1F;
+  rgb[0]=static_cast<unsigned char>((r<<3)|(r>>2));
+  rgb[1]=static_cast<unsigned char>((g<<2)|(g>>4));
+  rgb[2]=static_cast<unsigned char>((b<<3)|(b>>2));
+}
+
+/* the color palette of a block: 'opaque' forces the four-color mode */
+void colorPalette(const unsigned char*block, bool opaque,
+                  unsigned char palette[4][4])
+{
+  const unsigned short c0=block[0] | (block[1]<<8);
+  const unsigned short c1=block[2] | (block[3]<<8);
+  unpack565(c0, palette[0]);
+  unpack565(c1, palette[1]);
+  palette[0][3]=palette[1][3]=palette[2][3]=palette[3][3]=255;
+  for(int c=0; c<3; c++) {
+    const int p0=palette[0][c], p1=palette[1][c];
+    if(opaque || c0>c1) {
+      palette[2][c]=static_cast<unsigned char>((2*p0+p1)/3);
+      palette[3][c]=static_cast<unsigned char>((p0+2*p1)/3);
+    } else {
+      palette[2][c]=static_cast<unsigned char>((p0+p1)/2);
+      palette[3][c]=0;
+    }
+  }
+}
+/* the 8 alpha values of a BC3 block */
+void alphaPalette(const unsigned char*block, unsigned char palette[8])
+{
+  const int a0=block[0], a1=block[1];
+  palette[0]=block[0];
+  palette[1]=block[1];
+  if(a0>a1) {
+    for(int i=2; i<8; i++) {
+      palette[i]=static_cast<unsigned char>(((8-i)*a0 + (i-1)*a1)/7);
+    }
+  } else {
+    for(int i=2; i<6; i++) {
+      palette[i]=static_cast<unsigned char>(((6-i)*a0 + (i-1)*a1)/5);
+    }
+    palette[6]=0;
+    palette[7]=255;
+  }
+}
+
+void encodeColor(const Block&px, unsigned char*out)
+{
+  unsigned char mn[3]= {255, 255, 255}, mx[3]= {0, 0, 0};
+  int i, c;
+  for(i=0; i<16; i++) {
+    for(c=0; c<3; c++) {
+      if(px[i][c]<mn[c]) {
+        mn[c]=px[i][c];
+      }
+      if(px[i][c]>mx[c]) {
+        mx[c]=px[i][c];
+      }
+    }
+  }
+  /* shrink the bounding box a bit, as its corners are rarely hit */
+  for(c=0; c<3; c++) {
+    const int inset=(mx[c]-mn[c])>>4;
+    mn[c]+=inset;
+    mx[c]-=inset;
+  }
+  unsigned short c0=pack565(mx), c1=pack565(mn);
+  if(c0<c1) {
+    const unsigned short tmp=c0;
+    c0=c1;
+    c1=tmp;
+  }
+  out[0]=c0&0xFF;
+  out[1]=c0>>8;
+  out[2]=c1&0xFF;
+  out[3]=c1>>8;
+
+  unsigned int indices=0;
+  if(c0 != c1) {
+    unsigned char palette[4][4];
+    colorPalette(out, true, palette);
+    for(i=0; i<16; i++) {
+      unsigned int best=0;
+      int bestDist=0x7FFFFFFF;
+      for(unsigned int k=0; k<4; k++) {
+        const int dr=px[i][0]-palette[k][0];
+        const int dg=px[i][1]-palette[k][1];
+        const int db=px[i][2]-palette[k][2];
+        const int dist=dr*dr + dg*dg + db*db;
+        if(dist<bestDist) {
+          bestDist=dist;
+          best=k;
+        }
+      }
+      indices|=best<<(2*i);
+    }
+  }
+  out[4]=(indices    )&0xFF;
+  out[5]=(indices>> 8)&0xFF;
+  out[6]=(indices>>16)&0xFF;
+  out[7]=(indices>>24)&0xFF;
+}
+
+void encodeAlpha(const Block&px, unsigned char*out)
+{
+  unsigned char mn=255, mx=0;
+  int i;
+  for(i=0; i<16; i++) {
+    if(px[i][3]<mn) {
+      mn=px[i][3];
+    }
+    if(px[i][3]>mx) {
+      mx=px[i][3];
+    }
+  }
+  out[0]=mx;
+  out[1]=mn;
+  memset(out+2, 0, 6);
+  if(mx == mn) {
+    return;
+  }
+  unsigned char palette[8];
+  alphaPalette(out, palette);
+  /* 16 3bit indices, packed as two groups of 24 bits */
+  for(int half=0; half<2; half++) {
+    unsigned int bits=0;
+    for(i=0; i<8; i++) {
+      const int a=px[half*8+i][3];
+      unsigned int best=0;
+      int bestDist=256;
+      for(unsigned int k=0; k<8; k++) {
+        const int dist=(a>palette[k])?(a-palette[k]):(palette[k]-a);
+        if(dist<bestDist) {
+          bestDist=dist;
+          best=k;
+        }
+      }
+      bits|=best<<(3*i);
+    }
+    out[2+half*3]=(bits    )&0xFF;
+    out[3+half*3]=(bits>> 8)&0xFF;
+    out[4+half*3]=(bits>>16)&0xFF;
+  }
+}
+
+void decodeColor(const unsigned char*in, bool opaque, Block&px)
+{
+  unsigned char palette[4][4];
+  colorPalette(in, opaque, palette);
+  const unsigned int indices=in[4] | (in[5]<<8) | (in[6]<<16) |
+                             (static_cast<unsigned int>(in[7])<<24);
+  for(int i=0; i<16; i++) {
+    memcpy(px[i], palette[(indices>>(2*i))&3], 4);
+  }
+}
+void decodeAlpha(const unsigned char*in, Block&px)
+{
+  unsigned char palette[8];
+  alphaPalette(in, palette);
+  for(int half=0; half<2; half++) {
+    const unsigned char*b=in+2+half*3;
+    const unsigned int bits=b[0] | (b[1]<<8) | (b[2]<<16);
+    for(int i=0; i<8; i++) {
+      px[half*8+i][3]=palette[(bits>>(3*i))&7];
+    }
+  }
+}
+/* scaled YCoCg (R=Co, G=Cg, B=scale, A=Y) to opaque RGB */
+inline unsigned char clamp8(int v)
+{
+  return static_cast<unsigned char>((v<0)?0:((v>255)?255:v));
+}
+void decodeYCoCg(Block&px)
+{
+  for(int i=0; i<16; i++) {
+    const int scale=(px[i][2]>>3)+1;
+    const int co=(px[i][0]-128)/scale;
+    const int cg=(px[i][1]-128)/scale;
+    const int y=px[i][3];
+    px[i][0]=clamp8(y+co-cg);
+    px[i][1]=clamp8(y+cg);
+    px[i][2]=clamp8(y-co-cg);
+    px[i][3]=255;
+  }
+}
+
+class BlockJob : public gem::thread::ThreadPool::Job
+{
+public:
+  const imageStruct&m_src;
+  imageStruct&m_dst;
+  const bool m_encode;
+  const unsigned int m_format;
+  BlockJob(const imageStruct&src, imageStruct&dst, bool enc,
+           unsigned int format)
+    : m_src(src), m_dst(dst), m_encode(enc), m_format(format)
+  {}
+  virtual ~BlockJob(void) {}
+
+  /* encode resp. decode the block rows [start, stop[ */
+  void run(unsigned int start, unsigned int stop)
+  {
+    const imageStruct&rgba=m_encode?m_src:m_dst;
+    const imageStruct&blocks=m_encode?m_dst:m_src;
+    const int width=rgba.xsize, height=rgba.ysize;
+    const unsigned int blockX=(width+3)/4;
+    const unsigned int blocksize=imageStruct::blockSize(m_format);
+    const bool ycocg=(GEM_BC3_YCOCG==m_format);
+    const bool bc3=(GEM_BC3==m_format || ycocg);
+    Block px;
+    for(unsigned int by=start; by<stop; by++) {
+      unsigned char*block=blocks.data+by*blockX*blocksize;
+      for(unsigned int bx=0; bx<blockX; bx++, block+=blocksize) {
+        unsigned char*color=bc3?block+8:block;
+        if(m_encode) {
+          for(int i=0; i<16; i++) {
+            /* pixels beyond the edge repeat the last row resp. column */
+            int x=bx*4+(i&3), y=by*4+(i>>2);
+            if(x>=width) {
+              x=width-1;
+            }
+            if(y>=height) {
+              y=height-1;
+            }
+            const unsigned char*pixel=rgba.data+(y*width+x)*4;
+            px[i][0]=pixel[chRed];
+            px[i][1]=pixel[chGreen];
+            px[i][2]=pixel[chBlue];
+            px[i][3]=pixel[chAlpha];
+          }
+          encodeColor(px, color);
+          if(bc3) {
+            encodeAlpha(px, block);
+          }
+        } else {
+          decodeColor(color, bc3, px);
+          if(bc3) {
+            decodeAlpha(block, px);
+          }
+          if(ycocg) {
+            decodeYCoCg(px);
+          }
+          for(int i=0; i<16; i++) {
+            const int x=bx*4+(i&3), y=by*4+(i>>2);
+            if(x>=width || y>=height) {
+              continue;
+            }
+            unsigned char*pixel=rgba.data+(y*width+x)*4;
+            pixel[chRed]  =px[i][0];
+            pixel[chGreen]=px[i][1];
+            pixel[chBlue] =px[i][2];
+            pixel[chAlpha]=px[i][3];
+          }
+        }
+      }
+    }
+  }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    unsigned int start, stop;
+    gem::thread::ThreadPool::getSlice(slice, numSlices,
+                                      (m_src.ysize+3)/4, start, stop);
+    run(start, stop);
+  }
+};
+
+void runJob(BlockJob&job, unsigned int blockRows,
+            gem::thread::ThreadPool*pool)
+{
+  unsigned int numSlices=pool?pool->getThreads():1;
+  if(numSlices>blockRows) {
+    numSlices=blockRows;
+  }
+  if(numSlices<2) {
+    job.run(0, blockRows);
+  } else {
+    pool->run(job, numSlices);
+  }
+}
+};
+
+namespace gem
+{
+namespace image
+{
+bool compress::canEncode(unsigned int format)
+{
+  return (GEM_BC1==format || GEM_BC3==format);
+}
+bool compress::canDecode(unsigned int format)
+{
+  return (GEM_BC1==format || GEM_BC3==format || GEM_BC3_YCOCG==format);
+}
+
+bool compress::encode(const imageStruct&src, imageStruct&dst,
+                      unsigned int format,
+                      gem::thread::ThreadPool*pool)
+{
+  if(!canEncode(format) || !src.data || src.xsize<1 || src.ysize<1) {
+    return false;
+  }
+  if(&src == &dst) {
+    imageStruct img;
+    src.copy2Image(&img);
+    return encode(img, dst, format, pool);
+  }
+  if(src.format != GEM_RGBA || GL_FLOAT==src.type || GL_DOUBLE==src.type) {
+    imageStruct rgba;
+    rgba.setCsizeByFormat(GEM_RGBA);
+    if(!rgba.convertFrom(&src) || GEM_RGBA!=rgba.format) {
+      return false;
+    }
+    return encode(rgba, dst, format, pool);
+  }
+
+  dst.xsize=src.xsize;
+  dst.ysize=src.ysize;
+  dst.setCsizeByFormat(format);
+  dst.upsidedown=src.upsidedown;
+  dst.reallocate();
+
+  BlockJob job(src, dst, true, format);
+  runJob(job, (src.ysize+3)/4, pool);
+  return true;
+}
+
+bool compress::decode(const imageStruct&src, imageStruct&dst,
+                      gem::thread::ThreadPool*pool)
+{
+  if(!canDecode(src.format) || !src.data || src.xsize<1 || src.ysize<1) {
+    return false;
+  }
+  if(&src == &dst) {
+    imageStruct img;
+    src.copy2Image(&img);
+    return decode(img, dst, pool);
+  }
+
+  dst.xsize=src.xsize;
+  dst.ysize=src.ysize;
+  dst.setCsizeByFormat(GEM_RGBA);
+  dst.upsidedown=src.upsidedown;
+  dst.reallocate();
+
+  BlockJob job(src, dst, false, src.format);
+  runJob(job, (src.ysize+3)/4, pool);
+  return true;
+}
+};
+};
@@ -0,0 +1,66 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    ImageCompress.h
+       - encoding and decoding of block compressed (GPU) image formats
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_GEM_IMAGECOMPRESS_H_
+#define _INCLUDE__GEM_GEM_IMAGECOMPRESS_H_
+
+#include "Gem/ExportDef.h"
+
+struct imageStruct;
+
+namespace gem
+{
+namespace thread
+{
+class ThreadPool;
+};
+namespace image
+{
+/**
+ * block compressed images (see imageStruct::blockSize()) are meant to be
+ * uploaded to the GPU as they are (e.g. by [pix_texture]),
+ * which saves both memory and bandwidth
+ *
+ * the CPU side can create BC1 (DXT1) and BC3 (DXT5) images,
+ * and read them back into RGBA (e.g. for saving them or if the GPU lacks
+ * support for the format); this includes the YCoCg flavour of BC3 (HAP Q)
+ * BC7 and ETC2 can only be passed on to the GPU
+ */
+class GEM_EXTERN compress
+{
+public:
+  /*
+   * encode 'src' (any 8bit image that can be converted to RGBA)
+   * into 'dst', using the given block compressed 'format'
+   * (GEM_BC1 drops the alpha channel)
+   * if a 'pool' is given, the image is split into bands of blocks
+   * that are encoded in parallel
+   */
+  static bool encode(const imageStruct&src, imageStruct&dst,
+                     unsigned int format,
+                     gem::thread::ThreadPool*pool=0);
+  /*
+   * decode the block compressed 'src' into the RGBA image 'dst'
+   */
+  static bool decode(const imageStruct&src, imageStruct&dst,
+                     gem::thread::ThreadPool*pool=0);
+
+  /* whether encode() resp. decode() can handle the format */
+  static bool canEncode(unsigned int format);
+  static bool canDecode(unsigned int format);
+};
+};
+};
+
+#endif /* _INCLUDE__GEM_GEM_IMAGECOMPRESS_H_ */
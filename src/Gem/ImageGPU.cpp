@@ -0,0 +1,541 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "ImageGPU.h"
+#include "Gem/Image.h"
+#include "Gem/GemGL.h"
+#include "Gem/ContextData.h"
+
+#include "m_pd.h"
+
+#include <map>
+#include <vector>
+#include <string.h>
+
+namespace
+{
+const char*s_vertexShader =
+  "void main(void) {\n"
+  "  gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+  "  gl_Position = gl_Vertex;\n"
+  "}\n";
+const char*s_copyShader =
+  "uniform sampler2D tex0;\n"
+  "void main(void) {\n"
+  "  gl_FragColor = texture2D(tex0, gl_TexCoord[0].st);\n"
+  "}\n";
+
+GLuint compileShader(GLenum type, const char*source)
+{
+  GLuint shader=glCreateShader(type);
+  if(!shader) {
+    return 0;
+  }
+  glShaderSource(shader, 1, &source, NULL);
+  glCompileShader(shader);
+  GLint compiled=0;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if(!compiled) {
+    GLint length=0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+    if(length>0) {
+      std::vector<GLchar>log(length+1);
+      glGetShaderInfoLog(shader, length, NULL, &log[0]);
+      verbose(0, "[GEM:GPUFilter] compile log: %s", &log[0]);
+    }
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+
+void setTextureParameters(GLenum target)
+{
+  glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+/* the texture-resident images are always RGBA */
+void setTextureInfo(imageStruct&img, unsigned int xsize, unsigned int ysize)
+{
+  img.xsize=xsize;
+  img.ysize=ysize;
+  img.setCsizeByFormat(GEM_RGBA);
+  img.data=0;
+}
+};
+
+namespace gem
+{
+namespace image
+{
+
+class GPUFilter::PIMPL
+{
+public:
+  /* the openGL objects of a single context */
+  struct Context {
+    GLuint program, vertex, fragment;
+    GLuint fbo, texture, lut;
+    GLint width, height; /* size of 'texture' */
+    int status; /* 0: not yet tried; 1: ready; -1: failed */
+    unsigned int lutVersion;
+    Context(void)
+      : program(0), vertex(0), fragment(0)
+      , fbo(0), texture(0), lut(0)
+      , width(0), height(0)
+      , status(0)
+      , lutVersion(0)
+    {}
+  };
+  struct Uniform {
+    std::vector<float>value;
+    bool matrix;
+    Uniform(void) : matrix(false) {}
+  };
+
+  std::string source;
+  std::map<std::string, Uniform>uniforms;
+  unsigned char lut[256*4];
+  unsigned int lutVersion;
+
+  gem::ContextData<Context>context;
+
+  /* conversion buffer for uploads */
+  imageStruct buffer;
+
+  PIMPL(const std::string&fragmentShader)
+    : source(fragmentShader)
+    , lutVersion(0)
+    , context(Context())
+  {
+    if(source.empty()) {
+      source=s_copyShader;
+    }
+    memset(lut, 0, sizeof(lut));
+  }
+
+  void setUniform(const std::string&name, const float*values,
+                  unsigned int count, bool matrix=false)
+  {
+    Uniform&u=uniforms[name];
+    u.value.assign(values, values+count);
+    u.matrix=matrix;
+  }
+
+  /* make sure that 'ctx.texture' exists and is of the given size
+   * (the texture is left bound to GL_TEXTURE_2D)
+   */
+  bool prepareTexture(Context&ctx, GLint width, GLint height)
+  {
+    if(!ctx.texture) {
+      glGenTextures(1, &ctx.texture);
+      if(!ctx.texture) {
+        return false;
+      }
+      ctx.width=ctx.height=0;
+    }
+    glBindTexture(GL_TEXTURE_2D, ctx.texture);
+    if(width != ctx.width || height != ctx.height) {
+      setTextureParameters(GL_TEXTURE_2D);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0,
+                   GL_RGBA, GL_UNSIGNED_BYTE, 0);
+      ctx.width=width;
+      ctx.height=height;
+      if(ctx.fbo) {
+        /* re-attach the resized texture (and re-check completeness) */
+        GLint oldFBO=0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &oldFBO);
+        glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, ctx.fbo);
+        glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT,
+                                  GL_TEXTURE_2D, ctx.texture, 0);
+        glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, oldFBO);
+        if(ctx.status>0) {
+          ctx.status=0;
+        }
+      }
+    }
+    return true;
+  }
+
+  /* make sure that the shader and the FBO exist (for rendering into 'ctx.texture')
+   * leaves the FBO bound
+   */
+  bool prepareProgram(Context&ctx)
+  {
+    if(ctx.status<0) {
+      return false;
+    }
+    if(!ctx.program) {
+      ctx.vertex  =compileShader(GL_VERTEX_SHADER, s_vertexShader);
+      ctx.fragment=compileShader(GL_FRAGMENT_SHADER, source.c_str());
+      if(ctx.vertex && ctx.fragment) {
+        ctx.program=glCreateProgram();
+      }
+      if(!ctx.program) {
+        pd_error(0, "[GEM:GPUFilter] unable to compile shader");
+        ctx.status=-1;
+        return false;
+      }
+      glAttachShader(ctx.program, ctx.vertex);
+      glAttachShader(ctx.program, ctx.fragment);
+      glLinkProgram(ctx.program);
+      GLint linked=0;
+      glGetProgramiv(ctx.program, GL_LINK_STATUS, &linked);
+      if(!linked) {
+        pd_error(0, "[GEM:GPUFilter] unable to link shader");
+        ctx.status=-1;
+        return false;
+      }
+    }
+    if(!ctx.fbo) {
+      glGenFramebuffersEXT(1, &ctx.fbo);
+      glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, ctx.fbo);
+      glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT,
+                                GL_TEXTURE_2D, ctx.texture, 0);
+    } else {
+      glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, ctx.fbo);
+    }
+    if(ctx.status<1) {
+      GLenum status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
+      if(GL_FRAMEBUFFER_COMPLETE_EXT != status) {
+        pd_error(0, "[GEM:GPUFilter] incomplete framebuffer (0x%X)", status);
+        ctx.status=-1;
+        return false;
+      }
+      ctx.status=1;
+    }
+    return true;
+  }
+
+  void applyUniforms(GLuint program)
+  {
+    glUniform1i(glGetUniformLocation(program, "tex0"), 0);
+    glUniform1i(glGetUniformLocation(program, "tex1"), 1);
+    glUniform1i(glGetUniformLocation(program, "lut" ), 2);
+
+    std::map<std::string, Uniform>::iterator it;
+    for(it=uniforms.begin(); it!=uniforms.end(); ++it) {
+      GLint loc=glGetUniformLocation(program, it->first.c_str());
+      if(loc<0) {
+        continue;
+      }
+      const float*v=&it->second.value[0];
+      if(it->second.matrix) {
+        glUniformMatrix4fv(loc, 1, GL_FALSE, v);
+        continue;
+      }
+      switch(it->second.value.size()) {
+      case 1:
+        glUniform1fv(loc, 1, v);
+        break;
+      case 2:
+        glUniform2fv(loc, 1, v);
+        break;
+      case 3:
+        glUniform3fv(loc, 1, v);
+        break;
+      default:
+        glUniform4fv(loc, 1, v);
+        break;
+      }
+    }
+  }
+
+  void bindLookupTable(Context&ctx)
+  {
+    if(!lutVersion) {
+      return;
+    }
+    if(!ctx.lut) {
+      glGenTextures(1, &ctx.lut);
+      ctx.lutVersion=0;
+    }
+    glBindTexture(GL_TEXTURE_2D, ctx.lut);
+    if(ctx.lutVersion != lutVersion) {
+      setTextureParameters(GL_TEXTURE_2D);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 256, 1, 0,
+                   GL_RGBA, GL_UNSIGNED_BYTE, lut);
+      ctx.lutVersion=lutVersion;
+    }
+  }
+};
+
+GPUFilter::GPUFilter(const std::string&fragmentShader)
+  : m_pimpl(new PIMPL(fragmentShader))
+{
+}
+GPUFilter::~GPUFilter(void)
+{
+  delete m_pimpl;
+  m_pimpl=0;
+}
+
+/* _private_ dummy implementations */
+GPUFilter&GPUFilter::operator=(const GPUFilter&org)
+{
+  return (*this);
+}
+GPUFilter::GPUFilter(const GPUFilter&org)
+  : m_pimpl(new PIMPL(org.m_pimpl->source))
+{
+}
+
+void GPUFilter::setUniform(const std::string&name, float x)
+{
+  m_pimpl->setUniform(name, &x, 1);
+}
+void GPUFilter::setUniform(const std::string&name, float x, float y)
+{
+  float v[2] = {x, y};
+  m_pimpl->setUniform(name, v, 2);
+}
+void GPUFilter::setUniform(const std::string&name, float x, float y,
+                           float z)
+{
+  float v[3] = {x, y, z};
+  m_pimpl->setUniform(name, v, 3);
+}
+void GPUFilter::setUniform(const std::string&name, float x, float y,
+                           float z, float w)
+{
+  float v[4] = {x, y, z, w};
+  m_pimpl->setUniform(name, v, 4);
+}
+void GPUFilter::setUniformMatrix(const std::string&name,
+                                 const float*matrix)
+{
+  m_pimpl->setUniform(name, matrix, 16, true);
+}
+
+void GPUFilter::setLookupTable(const unsigned char*table)
+{
+  if(m_pimpl->lutVersion && !memcmp(m_pimpl->lut, table, sizeof(m_pimpl->lut))) {
+    return;
+  }
+  memcpy(m_pimpl->lut, table, sizeof(m_pimpl->lut));
+  if(!++m_pimpl->lutVersion) {
+    m_pimpl->lutVersion++;
+  }
+}
+
+bool GPUFilter::process(pixBlock&image, const pixBlock*right)
+{
+  if(!image.texture || GL_TEXTURE_2D != image.textureTarget) {
+    return false;
+  }
+  if(right) {
+    if(!right->texture || GL_TEXTURE_2D != right->textureTarget) {
+      return false;
+    }
+    if(right->image.xsize != image.image.xsize
+        || right->image.ysize != image.image.ysize
+        || right->image.upsidedown != image.image.upsidedown) {
+      return false;
+    }
+  }
+  if(!isRunnable()) {
+    return false;
+  }
+  const GLint width =image.image.xsize;
+  const GLint height=image.image.ysize;
+  if(width<1 || height<1) {
+    return false;
+  }
+
+  PIMPL::Context ctx=m_pimpl->context;
+  if(ctx.texture && (image.texture == ctx.texture
+                     || (right && right->texture == ctx.texture))) {
+    /* refusing to render into our input */
+    return false;
+  }
+
+  GLint oldFBO=0, oldProgram=0;
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &oldFBO);
+  glGetIntegerv(GL_CURRENT_PROGRAM, &oldProgram);
+  glPushAttrib(GL_ALL_ATTRIB_BITS);
+
+  bool result=false;
+  glActiveTexture(GL_TEXTURE0);
+  if(m_pimpl->prepareTexture(ctx, width, height)
+      && m_pimpl->prepareProgram(ctx)) {
+    glViewport(0, 0, width, height);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_ALPHA_TEST);
+    glDisable(GL_BLEND);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_CULL_FACE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    glUseProgram(ctx.program);
+    m_pimpl->applyUniforms(ctx.program);
+
+    glActiveTexture(GL_TEXTURE2);
+    m_pimpl->bindLookupTable(ctx);
+    if(right) {
+      glActiveTexture(GL_TEXTURE1);
+      glBindTexture(GL_TEXTURE_2D, right->texture);
+      setTextureParameters(GL_TEXTURE_2D);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, image.texture);
+    setTextureParameters(GL_TEXTURE_2D);
+
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.f, 0.f);
+    glVertex2f(-1.f, -1.f);
+    glTexCoord2f(1.f, 0.f);
+    glVertex2f( 1.f, -1.f);
+    glTexCoord2f(1.f, 1.f);
+    glVertex2f( 1.f,  1.f);
+    glTexCoord2f(0.f, 1.f);
+    glVertex2f(-1.f,  1.f);
+    glEnd();
+
+    glUseProgram(oldProgram);
+    result=true;
+  }
+  glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, oldFBO);
+  glPopAttrib();
+  m_pimpl->context=ctx;
+
+  if(result) {
+    setTextureInfo(image.image, width, height);
+    image.texture=ctx.texture;
+    image.textureTarget=GL_TEXTURE_2D;
+  }
+  return result;
+}
+
+bool GPUFilter::upload(pixBlock&image)
+{
+  const imageStruct*src=&image.image;
+  if(!src->data || src->xsize<1 || src->ysize<1) {
+    return false;
+  }
+  switch(src->type) {
+  case GL_FLOAT:
+  case GL_DOUBLE:
+    return false;
+  default:
+    break;
+  }
+  if(GEM_RGBA != src->format) {
+    if(!m_pimpl->buffer.convertFrom(src, GEM_RGBA)) {
+      return false;
+    }
+    src=&m_pimpl->buffer;
+  }
+
+  PIMPL::Context ctx=m_pimpl->context;
+  glPushAttrib(GL_TEXTURE_BIT);
+  glActiveTexture(GL_TEXTURE0);
+  bool result=m_pimpl->prepareTexture(ctx, src->xsize, src->ysize);
+  if(result) {
+    glTexSubImage2D(GL_TEXTURE_2D, 0,
+                    0, 0, src->xsize, src->ysize,
+                    src->format, src->type, src->data);
+  }
+  glPopAttrib();
+  m_pimpl->context=ctx;
+
+  if(result) {
+    const bool upsidedown=src->upsidedown;
+    setTextureInfo(image.image, src->xsize, src->ysize);
+    image.image.upsidedown=upsidedown;
+    image.texture=ctx.texture;
+    image.textureTarget=GL_TEXTURE_2D;
+  }
+  return result;
+}
+
+void GPUFilter::release(void)
+{
+  PIMPL::Context ctx=m_pimpl->context;
+  if(ctx.fbo) {
+    glDeleteFramebuffersEXT(1, &ctx.fbo);
+  }
+  if(ctx.texture) {
+    glDeleteTextures(1, &ctx.texture);
+  }
+  if(ctx.lut) {
+    glDeleteTextures(1, &ctx.lut);
+  }
+  if(ctx.program) {
+    glDeleteProgram(ctx.program);
+  }
+  if(ctx.vertex) {
+    glDeleteShader(ctx.vertex);
+  }
+  if(ctx.fragment) {
+    glDeleteShader(ctx.fragment);
+  }
+  m_pimpl->context=PIMPL::Context();
+}
+
+bool GPUFilter::isRunnable(void)
+{
+  return (GLEW_VERSION_2_0 && GLEW_EXT_framebuffer_object);
+}
+
+bool GPUFilter::download(const pixBlock&src, imageStruct&dest)
+{
+  if(!src.texture) {
+    return false;
+  }
+  dest.xsize=src.image.xsize;
+  dest.ysize=src.image.ysize;
+  dest.setCsizeByFormat(GEM_RGBA);
+  dest.upsidedown=src.image.upsidedown;
+  if(!dest.reallocate()) {
+    return false;
+  }
+
+  glPushAttrib(GL_TEXTURE_BIT);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(src.textureTarget, src.texture);
+  glGetTexImage(src.textureTarget, 0, dest.format, dest.type, dest.data);
+  glPopAttrib();
+  return true;
+}
+
+pixBlock*GPUFilter::hostImage(pixBlock*image, pixBlock&cache)
+{
+  if(!image || !image->texture) {
+    return image;
+  }
+  if(image->newimage || !cache.image.data
+      || cache.image.xsize != image->image.xsize
+      || cache.image.ysize != image->image.ysize) {
+    if(!download(*image, cache.image)) {
+      return 0;
+    }
+  }
+  cache.newimage=image->newimage;
+  cache.newfilm=image->newfilm;
+  cache.readonly=false;
+  cache.texture=0;
+  cache.textureTarget=0;
+  return &cache;
+}
+
+};
+}; // } image } gem
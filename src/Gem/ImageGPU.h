@@ -0,0 +1,111 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    ImageGPU.h
+       - processing of texture-resident images with GLSL
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_GEM_IMAGEGPU_H_
+#define _INCLUDE__GEM_GEM_IMAGEGPU_H_
+
+#include "Gem/ExportDef.h"
+#include <string>
+
+struct imageStruct;
+struct pixBlock;
+
+namespace gem
+{
+namespace image
+{
+/**
+ * a fragment shader that is run on a texture-resident image
+ *
+ * the result is rendered (via an FBO) into a texture owned by the filter,
+ * which is then handed on downstream in the pixBlock
+ *
+ * the fragment shader gets the following:
+ *   - uniform sampler2D tex0 : the (left) input image
+ *   - uniform sampler2D tex1 : the right input image (for dual filters)
+ *   - uniform sampler2D lut  : a 256x1 lookup-table (see setLookupTable())
+ *   - gl_TexCoord[0].st : the normalized coordinates of the current pixel
+ * colour values are in the range 0..1, with channels in RGBA order
+ * (regardless of the byte-order of the host images)
+ *
+ * all methods that take a pixBlock must be called with a valid openGL context
+ */
+class GEM_EXTERN GPUFilter
+{
+private:
+  class PIMPL;
+  PIMPL*m_pimpl;
+
+  /* dummy implementations */
+  GPUFilter(const GPUFilter&);
+  GPUFilter&operator=(const GPUFilter&);
+
+public:
+  /* if no 'fragmentShader' is given, the filter just copies the image */
+  GPUFilter(const std::string&fragmentShader=std::string());
+  virtual ~GPUFilter(void);
+
+  ////
+  // set uniform variables for the shader (they are applied on the next process())
+  // vec1..vec4 are chosen according to the number of components
+  virtual void setUniform(const std::string&name, float x);
+  virtual void setUniform(const std::string&name, float x, float y);
+  virtual void setUniform(const std::string&name, float x, float y, float z);
+  virtual void setUniform(const std::string&name,
+                          float x, float y, float z, float w);
+  // a column-major 4x4 matrix
+  virtual void setUniformMatrix(const std::string&name, const float*matrix);
+
+  ////
+  // set the lookup-table (256 RGBA-quadruples in RGBA order)
+  virtual void setLookupTable(const unsigned char*table);
+
+  ////
+  // run the shader on the texture-resident 'image'
+  // (and optionally a texture-resident 'right' image of the same size)
+  // on success, 'image' refers to the filter's texture and true is returned
+  // if the images cannot be processed (e.g. because the openGL context lacks
+  // the needed capabilities), false is returned and 'image' is left untouched
+  virtual bool process(pixBlock&image, const pixBlock*right=0);
+
+  ////
+  // upload the host image in 'image' into the filter's texture
+  // on success, 'image' becomes texture-resident
+  virtual bool upload(pixBlock&image);
+
+  ////
+  // release the openGL resources of the current context
+  virtual void release(void);
+
+  ////
+  // whether the current openGL context allows processing on the GPU
+  // (GLSL, framebuffer objects and non-power-of-two textures)
+  static bool isRunnable(void);
+
+  ////
+  // read a texture-resident image back into host memory
+  // 'dest' becomes an RGBA image that owns its data
+  static bool download(const pixBlock&src, imageStruct&dest);
+
+  ////
+  // for objects that need the pixels in host memory:
+  // returns 'image' itself if it is not texture-resident, else the image
+  // is read back into 'cache' (once for each new image) and 'cache' is returned
+  // returns NULL if the image cannot be read back
+  static pixBlock*hostImage(pixBlock*image, pixBlock&cache);
+};
+};
+};
+
+#endif /* _INCLUDE__GEM_GEM_IMAGEGPU_H_ */
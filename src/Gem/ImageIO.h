@@ -22,6 +22,7 @@ LOG
 struct imageStruct;
 
 #include <string>
+#include <stddef.h>
 
 
 // image2mem() reads an image file into memory
@@ -103,10 +104,22 @@ public:
                     const std::string&filename,
                     id_t&ID
                    );
+  /* like above, but with a priority:
+   * requests with a higher priority are served first
+   * (the above uses a priority of 0)
+   */
+  static bool async(callback cb,
+                    void*userdata,
+                    const std::string&filename,
+                    id_t&ID,
+                    int priority);
 
   /* cancels asynchronous loading of an image
    * removes the given ID (as returned by loadAsync()) from the loader queue
    * returns TRUE if item could be removed, or FALSE if no item ID is in the queue
+   * if the image is currently being loaded (or has been loaded but not
+   * delivered yet), it is discarded once it is done and TRUE is returned
+   * either way, the callback will not be called for a cancelled ID
    *
    * there is no point in cancel()ing an IMMEDIATE or ILLEGAL id
    */
@@ -132,6 +145,172 @@ public:
   static bool setPolling(bool);
 
 
+  /*
+   * the number of threads used for asynchronous loading
+   * (0: one per CPU)
+   * returns the number of threads actually used
+   * (0 if threaded loading is not available)
+   * the default can be set with the "image.loading.threads" setting
+   */
+  static unsigned int setThreads(unsigned int);
+
+
+  /*
+   * shared images
+   *
+   * all images are loaded through a process-wide cache
+   * a file that is requested several times (e.g. by multiple objects)
+   * is only decoded once (as long as it has not been modified on disk)
+   * the shared images are reference counted: each image obtained by
+   * the functions below MUST be release()d once it is no longer needed,
+   * and it MUST NOT be modified (copy it if you need to)
+   *
+   * images that are no longer referenced are kept in the cache,
+   * until the memory budget is exceeded (in which case the least recently
+   * used ones are dropped first)
+   */
+
+  /* the callback used for asynchronous loading of shared images
+   * same as the 'callback' above, except that 'img' is shared
+   * (so you must release() it rather than delete it)
+   */
+  typedef void (*sharedcallback)(void *userdata,
+                                 id_t ID,
+                                 const imageStruct*img,
+                                 const Properties&props);
+  static bool async(sharedcallback cb,
+                    void*userdata,
+                    const std::string&filename,
+                    id_t&ID,
+                    int priority=0);
+  static bool sync(sharedcallback cb,
+                   void*userdata,
+                   const std::string&filename,
+                   id_t&ID);
+
+  /* like above, but with 'hints' on the size that is actually needed
+   * (the 'minwidth' and 'minheight' properties, see gem::plugins::imageloader)
+   * so the image might be decoded at a (much faster) reduced resolution
+   * images loaded with different hints are cached separately
+   */
+  static bool async(sharedcallback cb,
+                    void*userdata,
+                    const std::string&filename,
+                    const Properties&hints,
+                    id_t&ID,
+                    int priority=0);
+  static bool sync(sharedcallback cb,
+                   void*userdata,
+                   const std::string&filename,
+                   const Properties&hints,
+                   id_t&ID);
+
+  /* get a shared image synchronously (NULL on failure)
+   * on entry, 'props' may hold size hints (as above) */
+  static const imageStruct*acquire(const std::string&filename,
+                                   Properties&props);
+  /* give a shared image back to the cache */
+  static void release(const imageStruct*img);
+
+  /*
+   * the memory budget (in bytes) for images that are not referenced anymore
+   * the default can be set (in MB) with the "image.cache.size" setting
+   */
+  static void setCacheSize(size_t bytes);
+
+
+};
+};
+};
+
+namespace gem
+{
+class Properties;
+namespace image
+{
+class GEM_EXTERN save
+{
+public:
+  /**
+   * saves an image (to 'filename') synchronously
+   * the backend is chosen by 'mimetype' (if not empty), the filename
+   * and the 'props' (see gem::plugins::imagesaver::estimateSave())
+   * returns TRUE if the image was written
+   */
+  static bool sync(const imageStruct&img,
+                   const std::string&filename,
+                   const std::string&mimetype,
+                   const Properties&props);
+
+
+  typedef unsigned int id_t;
+  static const id_t IMMEDIATE;
+  static const id_t INVALID;
+
+  /* the callback used for asynchronous image saving
+   * userdata is the pointer supplied when calling async();
+   * id is the ID returned by async()
+   * filename is the file the image was (or was not) written to
+   * success is TRUE if the image was written
+   *
+   * currently (with Pd being the only RTE),
+   * the callback will always be called from within the main thread
+   *
+   * the callback might be called directly from within async(),
+   * in which case the ID given in the callback and returned by async()
+   * is IMMEDIATE
+   */
+  typedef void (*callback)(void *userdata,
+                           id_t ID,
+                           const std::string&filename,
+                           bool success);
+
+  /* saves an image asynchronously
+   * the image is encoded and written in a separate thread (if possible);
+   * with several threads, several images are encoded in parallel
+   * when the image has been written, the callback 'cb' is called
+   * (if 'cb' is NULL, the image is written all the same)
+   *
+   * the saver takes over 'img' (which must have been allocated with 'new'),
+   * and deletes it once it is written, so the caller must not touch it anymore
+   *
+   * returns FALSE if the image cannot be queued
+   * (in which case 'img' is still deleted and ID is INVALID)
+   */
+  static bool async(callback cb,
+                    void*userdata,
+                    imageStruct*img,
+                    const std::string&filename,
+                    const std::string&mimetype,
+                    const Properties&props,
+                    id_t&ID);
+
+  /* cancels asynchronous saving of an image
+   * if the image is not being encoded yet, it is removed from the queue;
+   * else it is written all the same
+   * either way, the callback will not be called for a cancelled ID
+   * returns FALSE if there is no such ID
+   */
+  static bool cancel(id_t ID);
+
+  /*
+   * deliver the results of all images written so far
+   */
+  static void poll(void);
+
+  /*
+   * set asynch saving to "polling" mode (see gem::image::load::setPolling())
+   */
+  static bool setPolling(bool);
+
+  /*
+   * the number of threads used for asynchronous saving
+   * (0: one per CPU)
+   * returns the number of threads actually used
+   * (0 if threaded saving is not available)
+   * the default can be set with the "image.saving.threads" setting
+   */
+  static unsigned int setThreads(unsigned int);
 };
 };
 };
@@ -17,10 +17,243 @@
 /////////////////////////////////////////////////////////
 #include "ImageIO.h"
 #include "Gem/RTE.h"
+#include "Gem/Image.h"
+#include "Gem/Properties.h"
+#include "Gem/Settings.h"
 #include "Utils/SynchedWorkerThread.h"
+#include "Utils/ThreadMutex.h"
+#include "Utils/Thread.h"
 
 #include "plugins/imageloader.h"
 
+#include <map>
+#include <list>
+#include <vector>
+#include <stdio.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+namespace
+{
+/*
+ * a process-wide cache of decoded images
+ *
+ * entries are keyed by the path (and the size hints, if any) and validated
+ * against the modification time (and size) of the file; images that are referenced are never dropped;
+ * unreferenced images are kept in LRU order, as long as they fit into the
+ * memory budget
+ * a file that is being decoded (by any thread) is not decoded a second time:
+ * other requests for the same file wait until it is done
+ */
+class ImageCache
+{
+  struct Entry {
+    std::string path;
+    time_t mtime;
+    off_t size;
+    imageStruct*img;
+    gem::Properties props;
+    size_t bytes;
+    unsigned int refCount;
+    bool loading;
+    bool cached; /* FALSE if the entry is not found via its path (anymore) */
+    std::list<Entry*>::iterator lru; /* only valid if refCount==0 */
+    Entry(const std::string&p, time_t t, off_t s)
+      : path(p), mtime(t), size(s)
+      , img(0), bytes(0), refCount(0)
+      , loading(true), cached(true)
+    { }
+    ~Entry(void)
+    {
+      delete img;
+    }
+  };
+
+  std::map<std::string, Entry*>m_entries;
+  std::map<const imageStruct*, Entry*>m_images;
+  std::list<Entry*>m_lru; /* unreferenced entries, most recent first */
+  size_t m_used;   /* bytes held by unreferenced entries */
+  size_t m_budget;
+  pthread_mutex_t m_mutex;
+  pthread_cond_t  m_loaded;
+
+  ImageCache(void)
+    : m_used(0)
+    , m_budget(256*1024*1024)
+  {
+    pthread_mutex_init(&m_mutex, 0);
+    pthread_cond_init (&m_loaded, 0);
+    int mbytes=-1;
+    gem::Settings::get("image.cache.size", mbytes);
+    if(mbytes>=0) {
+      m_budget=static_cast<size_t>(mbytes)*1024*1024;
+    }
+  }
+
+  /* the following must be called with the mutex locked */
+  void forget(Entry*e)
+  {
+    if(!e->cached) {
+      return;
+    }
+    std::map<std::string, Entry*>::iterator it=m_entries.find(e->path);
+    if(it!=m_entries.end() && it->second == e) {
+      m_entries.erase(it);
+    }
+    e->cached=false;
+  }
+  void destroy(Entry*e)
+  {
+    forget(e);
+    if(e->img) {
+      m_images.erase(e->img);
+    }
+    delete e;
+  }
+  void evict(void)
+  {
+    while(m_used>m_budget && !m_lru.empty()) {
+      Entry*e=m_lru.back();
+      m_lru.pop_back();
+      m_used-=e->bytes;
+      destroy(e);
+    }
+  }
+  void reference(Entry*e)
+  {
+    if(!e->refCount++) {
+      m_lru.erase(e->lru);
+      m_used-=e->bytes;
+    }
+  }
+
+public:
+  static ImageCache&getInstance(void)
+  {
+    /* never destroyed, as images might be released at exit */
+    static ImageCache*s_cache=new ImageCache();
+    return *s_cache;
+  }
+
+  const imageStruct*acquire(const std::string&path,
+                            gem::Properties&props,
+                            gem::plugins::imageloader*loader)
+  {
+    struct stat st;
+    bool cacheable=(0==stat(path.c_str(), &st));
+    time_t mtime=cacheable?st.st_mtime:0;
+    off_t size=cacheable?st.st_size:0;
+
+    /* a reduced image must not be handed out to those who need it all */
+    double minwidth=0, minheight=0;
+    props.get("minwidth", minwidth);
+    props.get("minheight", minheight);
+    const bool hinted=(minwidth>0 || minheight>0);
+    std::string key=path;
+    if(hinted) {
+      char buf[64];
+      sprintf(buf, "?%gx%g", minwidth, minheight);
+      key+=buf;
+    }
+
+    Entry*e=0;
+    pthread_mutex_lock(&m_mutex);
+    while(cacheable) {
+      std::map<std::string, Entry*>::iterator it=m_entries.find(key);
+      if(it==m_entries.end()) {
+        break;
+      }
+      e=it->second;
+      if(e->loading) {
+        pthread_cond_wait(&m_loaded, &m_mutex);
+        e=0;
+        continue;
+      }
+      if(e->mtime == mtime && e->size == size) {
+        reference(e);
+        props=e->props;
+        pthread_mutex_unlock(&m_mutex);
+        return e->img;
+      }
+      /* the file has changed: users of the old image keep it until they release it */
+      forget(e);
+      if(!e->refCount) {
+        m_lru.erase(e->lru);
+        m_used-=e->bytes;
+        destroy(e);
+      }
+      e=0;
+    }
+    e=new Entry(key, mtime, size);
+    if(cacheable) {
+      m_entries[key]=e;
+    } else {
+      e->cached=false;
+    }
+    if(hinted) {
+      e->props.set("minwidth", minwidth);
+      e->props.set("minheight", minheight);
+    }
+    pthread_mutex_unlock(&m_mutex);
+
+    /* decode without holding the lock */
+    imageStruct*img=new imageStruct;
+    if(!loader || !loader->load(path, *img, e->props)) {
+      delete img;
+      img=0;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    e->loading=false;
+    pthread_cond_broadcast(&m_loaded);
+    if(!img) {
+      destroy(e);
+      pthread_mutex_unlock(&m_mutex);
+      return 0;
+    }
+    e->img=img;
+    e->bytes=img->xsize*img->ysize*img->csize;
+    e->refCount=1;
+    m_images[img]=e;
+    props=e->props;
+    pthread_mutex_unlock(&m_mutex);
+    return img;
+  }
+
+  void release(const imageStruct*img)
+  {
+    if(!img) {
+      return;
+    }
+    pthread_mutex_lock(&m_mutex);
+    std::map<const imageStruct*, Entry*>::iterator it=m_images.find(img);
+    if(it!=m_images.end()) {
+      Entry*e=it->second;
+      if(!--e->refCount) {
+        if(e->cached) {
+          m_lru.push_front(e);
+          e->lru=m_lru.begin();
+          m_used+=e->bytes;
+          evict();
+        } else {
+          destroy(e);
+        }
+      }
+    }
+    pthread_mutex_unlock(&m_mutex);
+  }
+
+  void setSize(size_t bytes)
+  {
+    pthread_mutex_lock(&m_mutex);
+    m_budget=bytes;
+    evict();
+    pthread_mutex_unlock(&m_mutex);
+  }
+};
+};
+
 namespace gem
 {
 namespace image
@@ -28,30 +261,57 @@ namespace image
 struct PixImageThreadLoader : public gem::thread::SynchedWorkerThread {
   struct InData {
     load::callback cb;
+    load::sharedcallback scb;
     void*userdata;
     std::string filename;
-    InData(load::callback cb_, void*data_, const std::string&fname) :
+    gem::Properties hints;
+    InData(load::callback cb_, load::sharedcallback scb_, void*data_,
+           const std::string&fname, const gem::Properties&hints_) :
       cb(cb_),
+      scb(scb_),
       userdata(data_),
-      filename(fname)
+      filename(fname),
+      hints(hints_)
     {
     };
   };
 
   struct OutData {
     load::callback cb;
+    load::sharedcallback scb;
     void*userdata;
-    imageStruct*img;
+    imageStruct*img; /* for 'cb' */
+    const imageStruct*shared; /* for 'scb' */
     gem::Properties props;
     explicit OutData(const InData&in) :
       cb(in.cb),
+      scb(in.scb),
       userdata(in.userdata),
-      img(NULL)
+      img(NULL),
+      shared(NULL),
+      props(in.hints)
     {
     };
+    ~OutData(void)
+    {
+      delete img;
+      ImageCache::getInstance().release(shared);
+    }
   };
 
+  /* the loader used in the main thread */
   static gem::plugins::imageloader*s_imageloader;
+
+  /* each worker thread needs a loader of its own;
+   * they are created in the main thread and handed out by acquireLoader() */
+  std::vector<gem::plugins::imageloader*>m_loaders;
+  std::vector<gem::plugins::imageloader*>m_freeLoaders;
+  gem::thread::Mutex m_loaderMutex;
+
+  /* requests that have not been delivered yet (main thread only) */
+  std::map<id_t, InData*>m_pending;
+  std::map<id_t, bool>m_cancelled;
+
   PixImageThreadLoader(void) :
     SynchedWorkerThread(false)
   {
@@ -65,10 +325,64 @@ struct PixImageThreadLoader : public gem::thread::SynchedWorkerThread {
     if(!s_imageloader->isThreadable()) {
       throw(42);
     }
+    int threads=0;
+    gem::Settings::get("image.loading.threads", threads);
+    setThreads(threads<0?1:threads);
     start();
   }
   virtual ~PixImageThreadLoader(void)
   {
+    stop(true);
+    for(unsigned int i=0; i<m_loaders.size(); i++) {
+      delete m_loaders[i];
+    }
+  }
+
+  virtual unsigned int setThreads(unsigned int numThreads)
+  {
+    if(!numThreads) {
+      numThreads=gem::thread::getCPUCount();
+    }
+    /* the loaders must be ready before the threads start */
+    m_loaderMutex.lock();
+    while(m_loaders.size()<numThreads) {
+      gem::plugins::imageloader*loader=gem::plugins::imageloader::getInstance();
+      if(!loader) {
+        break;
+      }
+      m_loaders.push_back(loader);
+      m_freeLoaders.push_back(loader);
+    }
+    if(m_loaders.size()<numThreads) {
+      numThreads=m_loaders.size();
+    }
+    m_loaderMutex.unlock();
+    if(!numThreads) {
+      stop(true);
+      return 0;
+    }
+    return SynchedWorkerThread::setThreads(numThreads);
+  }
+
+  gem::plugins::imageloader*acquireLoader(void)
+  {
+    gem::plugins::imageloader*loader=0;
+    m_loaderMutex.lock();
+    if(!m_freeLoaders.empty()) {
+      loader=m_freeLoaders.back();
+      m_freeLoaders.pop_back();
+    }
+    m_loaderMutex.unlock();
+    return loader;
+  }
+  void releaseLoader(gem::plugins::imageloader*loader)
+  {
+    if(!loader) {
+      return;
+    }
+    m_loaderMutex.lock();
+    m_freeLoaders.push_back(loader);
+    m_loaderMutex.unlock();
   }
 
   virtual void* process(id_t ID, void*data)
@@ -84,10 +398,18 @@ struct PixImageThreadLoader : public gem::thread::SynchedWorkerThread {
       return NULL;
     }
     // DOIT
-    out->img=new imageStruct;
-    if(!s_imageloader->load(in->filename, *out->img, out->props)) {
-      delete out->img;
-      out->img=0;
+    gem::plugins::imageloader*loader=acquireLoader();
+    const imageStruct*img=ImageCache::getInstance().acquire(in->filename,
+                          out->props, loader);
+    releaseLoader(loader);
+
+    if(img && out->cb) {
+      /* the caller owns the image, so give it a copy */
+      out->img=new imageStruct;
+      img->copy2Image(out->img);
+      ImageCache::getInstance().release(img);
+    } else {
+      out->shared=img;
     }
     void*result=reinterpret_cast<void*>(out);
     //post("processing[%d] %p -> %p", ID, data, result);
@@ -96,22 +418,66 @@ struct PixImageThreadLoader : public gem::thread::SynchedWorkerThread {
 
   virtual void done(id_t ID, void*data)
   {
+    std::map<id_t, InData*>::iterator it=m_pending.find(ID);
+    if(it!=m_pending.end()) {
+      delete it->second;
+      m_pending.erase(it);
+    }
+
     OutData*out=reinterpret_cast<OutData*>(data);
+    std::map<id_t, bool>::iterator cit=m_cancelled.find(ID);
+    if(cit!=m_cancelled.end()) {
+      m_cancelled.erase(cit);
+      delete out;
+      return;
+    }
+
     if(out) {
-      (*(out->cb))(out->userdata, ID, out->img, out->props);
+      if(out->cb) {
+        imageStruct*img=out->img;
+        out->img=0;
+        (*(out->cb))(out->userdata, ID, img, out->props);
+      } else {
+        const imageStruct*img=out->shared;
+        out->shared=0;
+        (*(out->scb))(out->userdata, ID, img, out->props);
+      }
       delete out;
     } else {
       pd_error(0, "loaded image:%d with no data!", ID);
     }
   };
 
-  virtual bool queue(id_t&ID, load::callback cb, void*userdata,
-                     std::string filename)
+  virtual bool queue(id_t&ID, load::callback cb, load::sharedcallback scb,
+                     void*userdata,
+                     std::string filename, const gem::Properties&hints,
+                     int priority)
   {
-    InData *in = new InData(cb, userdata, filename);
-    return SynchedWorkerThread::queue(ID, reinterpret_cast<void*>(in));
+    InData *in = new InData(cb, scb, userdata, filename, hints);
+    if(!SynchedWorkerThread::queue(ID, reinterpret_cast<void*>(in), priority)) {
+      delete in;
+      return false;
+    }
+    m_pending[ID]=in;
+    return true;
   };
 
+  virtual bool cancel(id_t ID)
+  {
+    std::map<id_t, InData*>::iterator it=m_pending.find(ID);
+    if(it==m_pending.end()) {
+      return false;
+    }
+    if(SynchedWorkerThread::cancel(ID, false)) {
+      delete it->second;
+      m_pending.erase(it);
+    } else {
+      /* in flight: discard the result once it arrives */
+      m_cancelled[ID]=true;
+    }
+    return true;
+  }
+
   static PixImageThreadLoader*getInstance(bool retry=true)
   {
     static bool didit=false;
@@ -150,16 +516,36 @@ gem::plugins::imageloader*PixImageThreadLoader::s_imageloader=NULL;
 const load::id_t load::IMMEDIATE= 0;
 const load::id_t load::INVALID  =~0;
 
-bool load::sync(const std::string&filename,
-                imageStruct&result,
-                gem::Properties&props)
+const imageStruct*load::acquire(const std::string&filename,
+                                gem::Properties&props)
 {
   if(!PixImageThreadLoader::s_imageloader) {
     PixImageThreadLoader::s_imageloader=
       gem::plugins::imageloader::getInstance();
   }
-  if((PixImageThreadLoader::s_imageloader) &&
-      (PixImageThreadLoader::s_imageloader->load(filename, result, props))) {
+  if(!PixImageThreadLoader::s_imageloader) {
+    return 0;
+  }
+  return ImageCache::getInstance().acquire(filename, props,
+         PixImageThreadLoader::s_imageloader);
+}
+void load::release(const imageStruct*img)
+{
+  ImageCache::getInstance().release(img);
+}
+void load::setCacheSize(size_t bytes)
+{
+  ImageCache::getInstance().setSize(bytes);
+}
+
+bool load::sync(const std::string&filename,
+                imageStruct&result,
+                gem::Properties&props)
+{
+  const imageStruct*img=acquire(filename, props);
+  if(img) {
+    img->copy2Image(&result);
+    release(img);
     return true;
   }
   return false;
@@ -169,6 +555,14 @@ bool load::async(load::callback cb,
                  void*userdata,
                  const std::string&filename,
                  id_t&ID)
+{
+  return async(cb, userdata, filename, ID, 0);
+}
+bool load::async(load::callback cb,
+                 void*userdata,
+                 const std::string&filename,
+                 id_t&ID,
+                 int priority)
 {
   if(NULL==cb) {
     ID=INVALID;
@@ -180,10 +574,37 @@ bool load::async(load::callback cb,
   //post("threadloader %p", threadloader);
 
   if(threadloader) {
-    return threadloader->queue(ID, cb, userdata, filename);
+    return threadloader->queue(ID, cb, 0, userdata, filename,
+                               gem::Properties(), priority);
   }
   return sync(cb, userdata, filename, ID);
 }
+bool load::async(load::sharedcallback cb,
+                 void*userdata,
+                 const std::string&filename,
+                 id_t&ID,
+                 int priority)
+{
+  return async(cb, userdata, filename, gem::Properties(), ID, priority);
+}
+bool load::async(load::sharedcallback cb,
+                 void*userdata,
+                 const std::string&filename,
+                 const gem::Properties&hints,
+                 id_t&ID,
+                 int priority)
+{
+  if(NULL==cb) {
+    ID=INVALID;
+    return false;
+  }
+
+  PixImageThreadLoader*threadloader=PixImageThreadLoader::getInstance();
+  if(threadloader) {
+    return threadloader->queue(ID, 0, cb, userdata, filename, hints, priority);
+  }
+  return sync(cb, userdata, filename, hints, ID);
+}
 
 bool load::sync(load::callback cb,
                 void*userdata,
@@ -201,6 +622,34 @@ bool load::sync(load::callback cb,
     (*cb)(userdata, ID, result, props);
     return true;
   }
+  delete result;
+  ID=INVALID;
+  return false;
+}
+bool load::sync(load::sharedcallback cb,
+                void*userdata,
+                const std::string&filename,
+                id_t&ID)
+{
+  return sync(cb, userdata, filename, gem::Properties(), ID);
+}
+bool load::sync(load::sharedcallback cb,
+                void*userdata,
+                const std::string&filename,
+                const gem::Properties&hints,
+                id_t&ID)
+{
+  if(NULL==cb) {
+    ID=INVALID;
+    return false;
+  }
+  gem::Properties props=hints;
+  const imageStruct*result=acquire(filename, props);
+  if(result) {
+    ID=IMMEDIATE;
+    (*cb)(userdata, ID, result, props);
+    return true;
+  }
   ID=INVALID;
   return false;
 }
@@ -209,11 +658,7 @@ bool load::cancel(id_t ID)
 {
   PixImageThreadLoader*threadloader=PixImageThreadLoader::getInstance(false);
   if(threadloader) {
-    bool success=threadloader->cancel(ID);
-    if(!success) {
-      poll();
-    }
-    return success;
+    return threadloader->cancel(ID);
   }
   return false;
 }
@@ -233,6 +678,14 @@ void load::poll(void)
     threadloader->dequeue();
   }
 }
+unsigned int load::setThreads(unsigned int threads)
+{
+  PixImageThreadLoader*threadloader=PixImageThreadLoader::getInstance();
+  if(threadloader) {
+    return threadloader->setThreads(threads);
+  }
+  return 0;
+}
 
 
 }; // image
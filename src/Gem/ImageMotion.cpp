@@ -0,0 +1,770 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "ImageMotion.h"
+#include "Gem/Image.h"
+#include "Gem/GemGL.h"
+#include "Gem/PixConvert.h"
+#include "Utils/SIMD.h"
+#include "Utils/ThreadPool.h"
+
+#include <string.h>
+
+namespace
+{
+/* adaptation of the per-pixel thresholds (see pix_movement2):
+ *   thresh = ((256-26)*thresh + 26*5*|cur-background|)>>8
+ * which equals ((115*thresh + 65*|cur-background|)>>7)
+ * (so the 16bit intermediates of the SIMD code don't overflow) */
+const int ADAPT_THRESH = 115;
+const int ADAPT_DIFF   = 65;
+
+inline unsigned char absdiff(unsigned char a, unsigned char b)
+{
+  return (a>b)?(a-b):(b-a);
+}
+
+/* everything a band of rows needs */
+struct MotionRow {
+  const unsigned char*prev[gem::image::Motion::MAXHISTORY];
+  unsigned int numPrev;
+  unsigned char*cur;
+  unsigned char*background;
+  unsigned char*threshold;
+  unsigned char*mask;
+  unsigned char*history;
+
+  unsigned int flags;
+  unsigned char thresh, lowthresh, decay;
+  unsigned int rate;
+
+  void advance(unsigned int offset)
+  {
+    for(unsigned int k=0; k<numPrev; k++) {
+      prev[k]+=offset;
+    }
+    cur+=offset;
+    background+=offset;
+    threshold+=offset;
+    mask+=offset;
+    history+=offset;
+  }
+};
+
+/* extract the luminance of 'count' pixels */
+void lumaScalar(const unsigned char*data, unsigned int format,
+                unsigned char*luma, unsigned int count)
+{
+  switch(format) {
+  case GEM_RGBA:
+    while(count--) {
+      *luma++=(data[chRed  ]*RGB2GRAY_RED
+               +data[chGreen]*RGB2GRAY_GREEN
+               +data[chBlue ]*RGB2GRAY_BLUE)>>8;
+      data+=4;
+    }
+    break;
+  case GEM_YUV:
+    count/=2;
+    while(count--) {
+      *luma++=data[chY0];
+      *luma++=data[chY1];
+      data+=4;
+    }
+    break;
+  default:
+    memcpy(luma, data, count);
+    break;
+  }
+}
+
+void motionScalar(MotionRow&row, unsigned int start, unsigned int stop)
+{
+  using gem::image::Motion;
+  const bool doFrame   = (row.flags & Motion::FRAMEDIFF);
+  const bool doAdapt   = (row.flags & Motion::ADAPTIVE);
+  const bool doBack    = doAdapt || (row.flags & Motion::BACKGROUND);
+  const bool doHistory = (row.flags & Motion::HISTORY);
+  const int rate=row.rate;
+
+  for(unsigned int x=start; x<stop; x++) {
+    const unsigned char c=row.cur[x];
+    const unsigned char t=doAdapt?row.threshold[x]:row.thresh;
+    bool moving=doFrame;
+    for(unsigned int k=0; moving && k<row.numPrev; k++) {
+      if(absdiff(c, row.prev[k][x])<=t) {
+        moving=false;
+      }
+    }
+    unsigned char out=moving?255:0;
+    if(!moving && doBack) {
+      const unsigned char b=row.background[x];
+      const unsigned char d=absdiff(c, b);
+      if(d>t) {
+        out=255;
+      }
+      if(doAdapt) {
+        const int tt=(t<row.lowthresh)?row.lowthresh:t;
+        const int nt=(ADAPT_THRESH*tt + ADAPT_DIFF*d)>>7;
+        row.threshold[x]=(nt>255)?255:nt;
+      }
+      row.background[x]=((256-rate)*b + rate*c)>>8;
+    }
+    row.mask[x]=out;
+    if(doHistory) {
+      const unsigned char h=row.history[x];
+      row.history[x]=out?255:((h>row.decay)?(h-row.decay):0);
+    }
+  }
+}
+
+#ifdef __SSE2__
+/* the luminance of 16 pixels */
+unsigned int lumaSSE2(const unsigned char*data, unsigned int format,
+                      unsigned char*luma, unsigned int count)
+{
+  const __m128i mask8 = _mm_set1_epi32(0xFF);
+  unsigned int x=0;
+  switch(format) {
+  case GEM_RGBA: {
+    const __m128i wRG = _mm_set1_epi32(RGB2GRAY_RED | (RGB2GRAY_GREEN<<16));
+    const __m128i wB  = _mm_set1_epi32(RGB2GRAY_BLUE);
+    const __m128i*in=reinterpret_cast<const __m128i*>(data);
+    for(; x+16<=count; x+=16) {
+      __m128i y[4];
+      for(unsigned int i=0; i<4; i++) {
+        const __m128i v = _mm_loadu_si128(in++);
+        const __m128i r = _mm_and_si128(_mm_srli_epi32(v, 8*chRed  ), mask8);
+        const __m128i g = _mm_and_si128(_mm_srli_epi32(v, 8*chGreen), mask8);
+        const __m128i b = _mm_and_si128(_mm_srli_epi32(v, 8*chBlue ), mask8);
+        const __m128i rg= _mm_or_si128 (r, _mm_slli_epi32(g, 16));
+        y[i]=_mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(rg, wRG),
+                                          _mm_madd_epi16(b , wB )), 8);
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(luma+x),
+                       _mm_packus_epi16(_mm_packs_epi32(y[0], y[1]),
+                                        _mm_packs_epi32(y[2], y[3])));
+    }
+  }
+  break;
+  case GEM_YUV: {
+    const __m128i*in=reinterpret_cast<const __m128i*>(data);
+    for(; x+16<=count; x+=16) {
+      __m128i y[2];
+      for(unsigned int i=0; i<2; i++) {
+        const __m128i v = _mm_loadu_si128(in++);
+        const __m128i y0= _mm_and_si128(_mm_srli_epi32(v, 8*chY0), mask8);
+        const __m128i y1= _mm_and_si128(_mm_srli_epi32(v, 8*chY1), mask8);
+        y[i]=_mm_or_si128(y0, _mm_slli_epi32(y1, 16));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(luma+x),
+                       _mm_packus_epi16(y[0], y[1]));
+    }
+  }
+  break;
+  default:
+    break;
+  }
+  return x;
+}
+
+/* the 4 bytes repeated all over the register */
+inline __m128i set4SSE2(const unsigned char bytes[4])
+{
+  int i;
+  memcpy(&i, bytes, sizeof(i));
+  return _mm_set1_epi32(i);
+}
+/* (a*(256-rate) + b*rate)>>8 */
+inline __m128i blendSSE2(__m128i a, __m128i b, __m128i wa, __m128i wb)
+{
+  const __m128i zero=_mm_setzero_si128();
+  __m128i lo=_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), wa),
+                           _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), wb));
+  __m128i hi=_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), wa),
+                           _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), wb));
+  return _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+}
+inline __m128i absdiffSSE2(__m128i a, __m128i b)
+{
+  return _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+}
+/* 0xFF where a<=b */
+inline __m128i lessequalSSE2(__m128i a, __m128i b)
+{
+  return _mm_cmpeq_epi8(_mm_subs_epu8(a, b), _mm_setzero_si128());
+}
+
+unsigned int motionSSE2(MotionRow&row, unsigned int count)
+{
+  using gem::image::Motion;
+  const bool doFrame   = (row.flags & Motion::FRAMEDIFF);
+  const bool doAdapt   = (row.flags & Motion::ADAPTIVE);
+  const bool doBack    = doAdapt || (row.flags & Motion::BACKGROUND);
+  const bool doHistory = (row.flags & Motion::HISTORY);
+
+  const __m128i zero    = _mm_setzero_si128();
+  const __m128i ones    = _mm_cmpeq_epi8(zero, zero);
+  const __m128i thresh  = _mm_set1_epi8(static_cast<char>(row.thresh));
+  const __m128i low     = _mm_set1_epi8(static_cast<char>(row.lowthresh));
+  const __m128i decay   = _mm_set1_epi8(static_cast<char>(row.decay));
+  const __m128i wBack   = _mm_set1_epi16(static_cast<short>(256-row.rate));
+  const __m128i wCur    = _mm_set1_epi16(static_cast<short>(row.rate));
+  const __m128i wThresh = _mm_set1_epi16(ADAPT_THRESH);
+  const __m128i wDiff   = _mm_set1_epi16(ADAPT_DIFF);
+
+  unsigned int x=0;
+  for(; x+16<=count; x+=16) {
+    const __m128i c=_mm_loadu_si128(reinterpret_cast<const __m128i*>
+                                    (row.cur+x));
+    const __m128i t=doAdapt
+                    ?_mm_loadu_si128(reinterpret_cast<const __m128i*>(row.threshold+x))
+                    :thresh;
+    __m128i moving=doFrame?ones:zero;
+    for(unsigned int k=0; k<row.numPrev; k++) {
+      const __m128i p=_mm_loadu_si128(reinterpret_cast<const __m128i*>
+                                      (row.prev[k]+x));
+      moving=_mm_andnot_si128(lessequalSSE2(absdiffSSE2(c, p), t), moving);
+    }
+    __m128i out=moving;
+    if(doBack) {
+      const __m128i b=_mm_loadu_si128(reinterpret_cast<const __m128i*>
+                                      (row.background+x));
+      const __m128i d=absdiffSSE2(c, b);
+      out=_mm_or_si128(out, _mm_andnot_si128(lessequalSSE2(d, t), ones));
+
+      /* only non-moving pixels update the background model */
+      const __m128i nb=blendSSE2(b, c, wBack, wCur);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(row.background+x),
+                       _mm_or_si128(_mm_and_si128(moving, b),
+                                    _mm_andnot_si128(moving, nb)));
+      if(doAdapt) {
+        const __m128i tt=_mm_max_epu8(t, low);
+        __m128i lo=_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(tt, zero),
+                                 wThresh),
+                                 _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), wDiff));
+        __m128i hi=_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(tt, zero),
+                                 wThresh),
+                                 _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), wDiff));
+        const __m128i nt=_mm_packus_epi16(_mm_srli_epi16(lo, 7),
+                                          _mm_srli_epi16(hi, 7));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row.threshold+x),
+                         _mm_or_si128(_mm_and_si128(moving, t),
+                                      _mm_andnot_si128(moving, nt)));
+      }
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(row.mask+x), out);
+    if(doHistory) {
+      __m128i*h=reinterpret_cast<__m128i*>(row.history+x);
+      _mm_storeu_si128(h, _mm_or_si128(_mm_subs_epu8(_mm_loadu_si128(h), decay),
+                                       out));
+    }
+  }
+  return x;
+}
+#endif /* __SSE2__ */
+
+/* the format of the luminance that is extracted (and the bytes per pixel) */
+unsigned int lumaFormat(const imageStruct&img)
+{
+  switch(img.format) {
+  case GEM_GRAY:
+  case GEM_RGBA:
+  case GEM_YUV:
+    return img.format;
+  default:
+    break;
+  }
+  return 0;
+}
+
+class MotionJob : public gem::thread::ThreadPool::Job
+{
+public:
+  const imageStruct&image;
+  const MotionRow&proto;
+  std::vector< std::vector<unsigned char> >&frames;
+  unsigned int current;
+  bool reset;
+
+  MotionJob(const imageStruct&img, const MotionRow&row,
+            std::vector< std::vector<unsigned char> >&f, unsigned int cur,
+            bool rst)
+    : image(img), proto(row)
+    , frames(f), current(cur)
+    , reset(rst)
+  { }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    const unsigned int width=image.xsize;
+    const unsigned int rowbytes=image.xsize*image.csize;
+    unsigned int start, stop;
+    gem::thread::ThreadPool::getSlice(slice, numSlices, image.ysize,
+                                      start, stop);
+#ifdef __SSE2__
+    const bool simd=(GEM_SIMD_SSE2 == GemSIMD::getCPU());
+#endif
+    MotionRow row=proto;
+    row.advance(start*width);
+    for(unsigned int y=start; y<stop; y++) {
+      /* 1. the luminance goes right into the ring-buffer */
+      const unsigned char*data=image.data+y*rowbytes;
+      unsigned int x=0;
+#ifdef __SSE2__
+      if(simd) {
+        x=lumaSSE2(data, image.format, row.cur, width);
+      }
+#endif
+      lumaScalar(data+x*image.csize, image.format, row.cur+x, width-x);
+
+      /* 2. compare it with the history while the row is still in the cache */
+      if(reset) {
+        const unsigned int offset=y*width;
+        for(unsigned int i=0; i<frames.size(); i++) {
+          if(i!=current) {
+            memcpy(&frames[i][offset], row.cur, width);
+          }
+        }
+        memcpy(row.background, row.cur, width);
+        memset(row.mask, 0, width);
+        memset(row.history, 0, width);
+      } else {
+        x=0;
+#ifdef __SSE2__
+        if(simd) {
+          x=motionSSE2(row, width);
+        }
+#endif
+        motionScalar(row, x, width);
+      }
+      row.advance(width);
+    }
+  }
+};
+
+
+/* background subtraction on elements of 'channels' bytes */
+struct SubtractRow {
+  unsigned char*data;
+  unsigned char*reference;
+  unsigned int channels;
+  unsigned char range[4], key[4];
+  unsigned int rate;
+};
+
+void subtractScalar(SubtractRow&row, unsigned int start, unsigned int stop)
+{
+  const unsigned int ch=row.channels;
+  const int rate=row.rate;
+  for(unsigned int i=start; i<stop; i+=ch) {
+    unsigned char*pix=row.data+i;
+    unsigned char*ref=row.reference+i;
+    bool background=true;
+    for(unsigned int c=0; background && c<ch; c++) {
+      if(absdiff(pix[c], ref[c]) >= row.range[c]) {
+        background=false;
+      }
+    }
+    if(!background) {
+      continue;
+    }
+    for(unsigned int c=0; c<ch; c++) {
+      if(rate) {
+        ref[c]=((256-rate)*ref[c] + rate*pix[c])>>8;
+      }
+      pix[c]=row.key[c];
+    }
+  }
+}
+
+#ifdef __SSE2__
+unsigned int subtractSSE2(SubtractRow&row, unsigned int count)
+{
+  if(1!=row.channels && 4!=row.channels) {
+    return 0;
+  }
+  const bool single=(1==row.channels);
+  const __m128i zero=_mm_setzero_si128();
+  const __m128i range=single
+                      ?_mm_set1_epi8(static_cast<char>(row.range[0]))
+                      :set4SSE2(row.range);
+  const __m128i key=single
+                    ?_mm_set1_epi8(static_cast<char>(row.key[0]))
+                    :set4SSE2(row.key);
+  const __m128i wRef=_mm_set1_epi16(static_cast<short>(256-row.rate));
+  const __m128i wCur=_mm_set1_epi16(static_cast<short>(row.rate));
+
+  unsigned int i=0;
+  for(; i+16<=count; i+=16) {
+    __m128i*pix=reinterpret_cast<__m128i*>(row.data+i);
+    __m128i*ref=reinterpret_cast<__m128i*>(row.reference+i);
+    const __m128i p=_mm_loadu_si128(pix);
+    const __m128i r=_mm_loadu_si128(ref);
+    /* 0xFF for each channel that is _not_ within the range */
+    const __m128i outside=_mm_cmpeq_epi8(_mm_subs_epu8(range,
+                                         absdiffSSE2(p, r)), zero);
+    /* an element is background, if all its channels are within the range */
+    const __m128i background=single
+                             ?_mm_cmpeq_epi8 (outside, zero)
+                             :_mm_cmpeq_epi32(outside, zero);
+    _mm_storeu_si128(pix, _mm_or_si128(_mm_and_si128(background, key),
+                                       _mm_andnot_si128(background, p)));
+    if(row.rate) {
+      _mm_storeu_si128(ref, _mm_or_si128(_mm_and_si128(background,
+                                         blendSSE2(r, p, wRef, wCur)),
+                                         _mm_andnot_si128(background, r)));
+    }
+  }
+  return i;
+}
+#endif /* __SSE2__ */
+
+class SubtractJob : public gem::thread::ThreadPool::Job
+{
+public:
+  const SubtractRow&proto;
+  unsigned int height, rowbytes;
+  SubtractJob(const SubtractRow&row, unsigned int h, unsigned int bytes)
+    : proto(row), height(h), rowbytes(bytes)
+  { }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    unsigned int start, stop;
+    gem::thread::ThreadPool::getSlice(slice, numSlices, height, start, stop);
+    SubtractRow row=proto;
+    row.data     +=start*rowbytes;
+    row.reference+=start*rowbytes;
+    const unsigned int count=(stop-start)*rowbytes;
+    unsigned int i=0;
+#ifdef __SSE2__
+    if(GEM_SIMD_SSE2 == GemSIMD::getCPU()) {
+      i=subtractSSE2(row, count);
+    }
+#endif
+    subtractScalar(row, i, count);
+  }
+};
+
+
+/* the absolute difference; the 4 byte 'pattern' tells what to do
+ * with each byte of an element: 0=absolute difference, 1=keep,
+ * 2=signed difference (+128) */
+enum { DIFF_ABS=0, DIFF_KEEP=1, DIFF_SIGNED=2 };
+
+void differenceScalar(unsigned char*left, const unsigned char*right,
+                      const unsigned char pattern[4],
+                      unsigned int start, unsigned int stop)
+{
+  for(unsigned int i=start; i<stop; i++) {
+    switch(pattern[i&3]) {
+    case DIFF_ABS:
+      left[i]=absdiff(left[i], right[i]);
+      break;
+    case DIFF_SIGNED: {
+      const int d=left[i]-right[i]+128;
+      left[i]=(d<0)?0:((d>255)?255:d);
+    }
+    break;
+    default:
+      break;
+    }
+  }
+}
+
+#ifdef __SSE2__
+unsigned int differenceSSE2(unsigned char*left, const unsigned char*right,
+                            const unsigned char pattern[4],
+                            unsigned int count)
+{
+  unsigned char keep[4], sign[4];
+  for(unsigned int c=0; c<4; c++) {
+    keep[c]=(DIFF_KEEP  ==pattern[c])?0xFF:0;
+    sign[c]=(DIFF_SIGNED==pattern[c])?0xFF:0;
+  }
+  const __m128i keepmask=set4SSE2(keep);
+  const __m128i signmask=set4SSE2(sign);
+  const __m128i absmask =_mm_andnot_si128(_mm_or_si128(keepmask, signmask),
+                                          _mm_cmpeq_epi8(keepmask, keepmask));
+  const __m128i offset  =_mm_set1_epi8(static_cast<char>(0x80));
+
+  unsigned int i=0;
+  for(; i+16<=count; i+=16) {
+    __m128i*l=reinterpret_cast<__m128i*>(left+i);
+    const __m128i a=_mm_loadu_si128(l);
+    const __m128i b=_mm_loadu_si128(reinterpret_cast<const __m128i*>(right+i));
+    /* (a-128)-(b-128) with signed saturation, +128 */
+    const __m128i s=_mm_xor_si128(_mm_subs_epi8(_mm_xor_si128(a, offset),
+                                  _mm_xor_si128(b, offset)), offset);
+    _mm_storeu_si128(l, _mm_or_si128(_mm_or_si128(_mm_and_si128(keepmask, a),
+                                     _mm_and_si128(signmask, s)),
+                                     _mm_and_si128(absmask, absdiffSSE2(a, b))));
+  }
+  return i;
+}
+#endif /* __SSE2__ */
+
+class DifferenceJob : public gem::thread::ThreadPool::Job
+{
+public:
+  unsigned char*left;
+  const unsigned char*right;
+  const unsigned char*pattern;
+  unsigned int height, rowbytes;
+  DifferenceJob(unsigned char*l, const unsigned char*r,
+                const unsigned char*p,
+                unsigned int h, unsigned int bytes)
+    : left(l), right(r), pattern(p), height(h), rowbytes(bytes)
+  { }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    unsigned int start, stop;
+    gem::thread::ThreadPool::getSlice(slice, numSlices, height, start, stop);
+    /* bands start at multiples of 4 bytes, so the pattern stays aligned */
+    unsigned char*l=left+start*rowbytes;
+    const unsigned char*r=right+start*rowbytes;
+    const unsigned int count=(stop-start)*rowbytes;
+    unsigned int i=0;
+#ifdef __SSE2__
+    if(GEM_SIMD_SSE2 == GemSIMD::getCPU()) {
+      i=differenceSSE2(l, r, pattern, count);
+    }
+#endif
+    differenceScalar(l, r, pattern, i, count);
+  }
+};
+
+void runJob(gem::thread::ThreadPool::Job&job, unsigned int height,
+            gem::thread::ThreadPool*pool)
+{
+  unsigned int numSlices=pool?pool->getThreads():1;
+  if(numSlices>height) {
+    numSlices=height;
+  }
+  if(numSlices<2) {
+    job.process(0, 1);
+    return;
+  }
+  pool->run(job, numSlices);
+}
+};
+
+namespace gem
+{
+namespace image
+{
+
+Motion::Motion(void)
+  : width(0), height(0)
+  , m_current(0)
+  , m_referenceFormat(0), m_referenceWidth(0), m_referenceHeight(0)
+  , m_numHistory(1)
+  , m_thresh(127), m_lowthresh(0)
+  , m_rate(0)
+  , m_decay(0)
+  , m_reset(true), m_resetThreshold(true), m_resetReference(true)
+{
+}
+Motion::~Motion(void)
+{
+}
+
+void Motion::setHistory(unsigned int frames)
+{
+  if(frames<1) {
+    frames=1;
+  }
+  if(frames>MAXHISTORY) {
+    frames=MAXHISTORY;
+  }
+  if(frames!=m_numHistory) {
+    m_numHistory=frames;
+    m_reset=true;
+  }
+}
+void Motion::setThreshold(unsigned char threshold)
+{
+  m_thresh=threshold;
+  m_resetThreshold=true;
+}
+void Motion::setLowThreshold(unsigned char threshold)
+{
+  m_lowthresh=threshold;
+}
+void Motion::setLearningRate(unsigned int rate)
+{
+  m_rate=(rate>256)?256:rate;
+}
+void Motion::setDecay(unsigned char decay)
+{
+  m_decay=decay;
+}
+void Motion::reset(void)
+{
+  m_reset=true;
+  m_resetThreshold=true;
+  m_resetReference=true;
+}
+
+const unsigned char*Motion::mask(void) const
+{
+  return m_mask.empty()?0:&m_mask[0];
+}
+const unsigned char*Motion::history(void) const
+{
+  return m_history.empty()?0:&m_history[0];
+}
+const unsigned char*Motion::background(void) const
+{
+  return m_background.empty()?0:&m_background[0];
+}
+const unsigned char*Motion::luminance(void) const
+{
+  if(m_frames.empty() || m_frames[m_current].empty()) {
+    return 0;
+  }
+  return &m_frames[m_current][0];
+}
+
+bool Motion::analyze(const imageStruct&img, unsigned int flags,
+                     gem::thread::ThreadPool*pool)
+{
+  if(!img.data || !lumaFormat(img) || img.xsize<1 || img.ysize<1) {
+    return false;
+  }
+  const unsigned int w=img.xsize, h=img.ysize;
+  const size_t size=static_cast<size_t>(w)*h;
+  if(w!=width || h!=height || m_frames.size()!=m_numHistory+1) {
+    width=w;
+    height=h;
+    m_frames.resize(m_numHistory+1);
+    for(unsigned int i=0; i<m_frames.size(); i++) {
+      m_frames[i].resize(size);
+    }
+    m_mask      .resize(size);
+    m_history   .resize(size);
+    m_background.resize(size);
+    m_threshold .resize(size);
+    m_current=0;
+    m_reset=true;
+    m_resetThreshold=true;
+  }
+  if(m_resetThreshold) {
+    memset(&m_threshold[0], m_thresh, size);
+    m_resetThreshold=false;
+  }
+
+  const unsigned int numFrames=m_frames.size();
+  m_current=(m_current+1)%numFrames;
+
+  MotionRow row;
+  row.numPrev=m_numHistory;
+  for(unsigned int k=0; k<m_numHistory; k++) {
+    row.prev[k]=&m_frames[(m_current+numFrames-1-k)%numFrames][0];
+  }
+  row.cur       =&m_frames[m_current][0];
+  row.background=&m_background[0];
+  row.threshold =&m_threshold[0];
+  row.mask      =&m_mask[0];
+  row.history   =&m_history[0];
+  row.flags     =flags;
+  row.thresh    =m_thresh;
+  row.lowthresh =m_lowthresh;
+  row.decay     =m_decay;
+  row.rate      =m_rate;
+
+  MotionJob job(img, row, m_frames, m_current, m_reset);
+  runJob(job, h, pool);
+  m_reset=false;
+  return true;
+}
+
+bool Motion::subtract(imageStruct&img,
+                      const unsigned char range[4], const unsigned char key[4],
+                      gem::thread::ThreadPool*pool)
+{
+  if(!img.data || img.xsize<1 || img.ysize<1) {
+    return false;
+  }
+  unsigned int channels=0;
+  switch(img.format) {
+  case GEM_GRAY:
+    channels=1;
+    break;
+  case GEM_RGBA:
+  case GEM_YUV:
+    /* YUV: the elements are macropixels */
+    channels=4;
+    break;
+  default:
+    return false;
+  }
+  const unsigned int rowbytes=img.xsize*img.csize;
+  const size_t size=static_cast<size_t>(rowbytes)*img.ysize;
+  if(m_resetReference
+      || img.format!=m_referenceFormat
+      || static_cast<unsigned int>(img.xsize)!=m_referenceWidth
+      || static_cast<unsigned int>(img.ysize)!=m_referenceHeight) {
+    m_referenceFormat=img.format;
+    m_referenceWidth =img.xsize;
+    m_referenceHeight=img.ysize;
+    m_reference.resize(size);
+    memcpy(&m_reference[0], img.data, size);
+    m_resetReference=false;
+  }
+
+  SubtractRow row;
+  row.data=img.data;
+  row.reference=&m_reference[0];
+  row.channels=channels;
+  for(unsigned int c=0; c<4; c++) {
+    row.range[c]=range[c];
+    row.key  [c]=key  [c];
+  }
+  row.rate=m_rate;
+
+  SubtractJob job(row, img.ysize, rowbytes);
+  runJob(job, img.ysize, pool);
+  return true;
+}
+
+bool Motion::difference(imageStruct&img, const imageStruct&right,
+                        gem::thread::ThreadPool*pool)
+{
+  if(!img.data || !right.data
+      || img.xsize!=right.xsize || img.ysize!=right.ysize
+      || img.format!=right.format) {
+    return false;
+  }
+  unsigned char pattern[4]= {DIFF_ABS, DIFF_ABS, DIFF_ABS, DIFF_ABS};
+  switch(img.format) {
+  case GEM_GRAY:
+    break;
+  case GEM_RGBA:
+    pattern[chAlpha]=DIFF_KEEP;
+    break;
+  case GEM_YUV:
+    pattern[chU]=DIFF_SIGNED;
+    pattern[chV]=DIFF_SIGNED;
+    break;
+  default:
+    return false;
+  }
+  DifferenceJob job(img.data, right.data, pattern,
+                    img.ysize, img.xsize*img.csize);
+  runJob(job, img.ysize, pool);
+  return true;
+}
+
+};
+};
@@ -0,0 +1,137 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    ImageMotion.h
+       - motion analysis of image sequences (frame differencing,
+         background models, motion history)
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_GEM_IMAGEMOTION_H_
+#define _INCLUDE__GEM_GEM_IMAGEMOTION_H_
+
+#include "Gem/ExportDef.h"
+#include <vector>
+
+struct imageStruct;
+
+namespace gem
+{
+namespace thread
+{
+class ThreadPool;
+};
+namespace image
+{
+/**
+ * motion analysis on the luminance of an image sequence
+ *
+ * for each frame, the luminance is extracted and stored in a ring-buffer
+ * holding the last frames; in the same pass over each row,
+ * the motion-mask (0 or 255 for each pixel) is calculated:
+ *  - FRAMEDIFF: a pixel moves, if it differs by more than the threshold
+ *    from each frame in the history
+ *  - BACKGROUND: a pixel that does not move (according to FRAMEDIFF)
+ *    is compared with a running-average background;
+ *    the background is then updated with the pixel
+ *  - ADAPTIVE: the (per-pixel) thresholds of non-moving pixels adapt
+ *    to the deviation from the background (but never drop below the
+ *    low threshold)
+ *  - HISTORY: moving pixels are set to 255 in the motion-history image,
+ *    all others fade out by 'decay'
+ *
+ * if a 'pool' is given, the image is split into bands of rows
+ * that are processed in parallel
+ */
+class GEM_EXTERN Motion
+{
+public:
+  enum {
+    FRAMEDIFF  = (1<<0),
+    BACKGROUND = (1<<1),
+    ADAPTIVE   = (1<<2), /* implies BACKGROUND */
+    HISTORY    = (1<<3)
+  };
+  static const unsigned int MAXHISTORY = 8;
+
+  Motion(void);
+  virtual ~Motion(void);
+
+  /* number of previous frames a pixel is compared with (1..MAXHISTORY) */
+  void setHistory(unsigned int frames);
+  /* a pixel moves, if the difference is greater than 'threshold'
+   * with ADAPTIVE thresholds, this (re)sets all per-pixel thresholds */
+  void setThreshold(unsigned char threshold);
+  /* ADAPTIVE thresholds never drop below the 'lowThreshold' */
+  void setLowThreshold(unsigned char lowThreshold);
+  /* the weight (0..256) of the current frame when updating the background */
+  void setLearningRate(unsigned int rate);
+  /* by how much the motion-history fades per frame */
+  void setDecay(unsigned char decay);
+
+  /* re-initialize history and background with the next frame
+   * (which yields an empty mask) */
+  void reset(void);
+
+  /*
+   * analyze the next frame
+   * GRAY, RGBA and YUV images are accepted
+   * if the size changes, the analysis is reset()
+   */
+  bool analyze(const imageStruct&img, unsigned int flags,
+               gem::thread::ThreadPool*pool=0);
+
+  /* the results (width*height bytes, tightly packed);
+   * valid until the next analyze() */
+  unsigned int width, height;
+  const unsigned char*mask(void) const;
+  const unsigned char*history(void) const;
+  const unsigned char*background(void) const;
+  /* the luminance of the last frame */
+  const unsigned char*luminance(void) const;
+
+
+  /*
+   * background subtraction on the full colour information
+   * each element (a pixel; a macropixel for YUV) that lies within
+   * 'range' (per channel) of the stored reference image gets replaced by 'key'
+   * the first frame (after a reset() or a change of the size/format)
+   * becomes the reference
+   * with a learning rate > 0 (see setLearningRate()), the background
+   * elements are blended into the reference
+   */
+  bool subtract(imageStruct&img,
+                const unsigned char range[4], const unsigned char key[4],
+                gem::thread::ThreadPool*pool=0);
+
+  /*
+   * in-place absolute difference of two images of the same size and format
+   * RGBA: the alpha channel of 'img' is kept
+   * YUV: the chroma channels hold the (saturated) signed difference
+   */
+  static bool difference(imageStruct&img, const imageStruct&right,
+                         gem::thread::ThreadPool*pool=0);
+
+private:
+  std::vector< std::vector<unsigned char> >m_frames;
+  unsigned int m_current;
+  std::vector<unsigned char>m_mask, m_history, m_background, m_threshold;
+  std::vector<unsigned char>m_reference;
+  unsigned int m_referenceFormat, m_referenceWidth, m_referenceHeight;
+
+  unsigned int m_numHistory;
+  unsigned char m_thresh, m_lowthresh;
+  unsigned int m_rate;
+  unsigned char m_decay;
+  bool m_reset, m_resetThreshold, m_resetReference;
+};
+};
+};
+
+#endif /* _INCLUDE__GEM_GEM_IMAGEMOTION_H_ */
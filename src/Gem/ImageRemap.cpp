@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "ImageRemap.h"
+#include "Gem/Image.h"
+#include "Utils/SIMD.h"
+#include "Utils/ThreadPool.h"
+
+#include <string.h>
+
+namespace
+{
+template<typename T>
+void gatherScalar(const int*map, const T*src, T*dst,
+                  unsigned int start, unsigned int count)
+{
+  for(unsigned int i=start; i<count; i++) {
+    const int index=map[i];
+    dst[i]=(index<0)?0:src[index];
+  }
+}
+void gatherGeneric(const int*map, const unsigned char*src,
+                   unsigned char*dst, unsigned int count,
+                   unsigned int elementSize)
+{
+  for(unsigned int i=0; i<count; i++) {
+    const int index=map[i];
+    if(index<0) {
+      memset(dst, 0, elementSize);
+    } else {
+      memcpy(dst, src+index*elementSize, elementSize);
+    }
+    dst+=elementSize;
+  }
+}
+
+#ifdef __SSE2__
+/* there is no gather instruction in SSE2: the elements are fetched
+ * individually, but assembled and stored a full register at once */
+unsigned int gather32SSE2(const int*map, const unsigned int*src,
+                          unsigned int*dst, unsigned int count)
+{
+  unsigned int i=0;
+  for(; i+4<=count; i+=4) {
+    const int i0=map[i+0], i1=map[i+1], i2=map[i+2], i3=map[i+3];
+    if((i0|i1|i2|i3)<0) {
+      gatherScalar(map, src, dst, i, i+4);
+      continue;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i),
+                     _mm_set_epi32(src[i3], src[i2], src[i1], src[i0]));
+  }
+  return i;
+}
+unsigned int gather8SSE2(const int*map, const unsigned char*src,
+                         unsigned char*dst, unsigned int count)
+{
+  unsigned int i=0;
+  for(; i+16<=count; i+=16) {
+    const int*m=map+i;
+    int any=0;
+    for(unsigned int j=0; j<16; j++) {
+      any|=m[j];
+    }
+    if(any<0) {
+      gatherScalar(map, src, dst, i, i+16);
+      continue;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i),
+                     _mm_set_epi8(src[m[15]], src[m[14]], src[m[13]], src[m[12]],
+                                  src[m[11]], src[m[10]], src[m[ 9]], src[m[ 8]],
+                                  src[m[ 7]], src[m[ 6]], src[m[ 5]], src[m[ 4]],
+                                  src[m[ 3]], src[m[ 2]], src[m[ 1]], src[m[ 0]]));
+  }
+  return i;
+}
+#endif /* __SSE2__ */
+
+class RemapJob : public gem::thread::ThreadPool::Job
+{
+public:
+  const int*map;
+  const unsigned char*src;
+  unsigned char*dst;
+  unsigned int width, height, elementSize;
+  RemapJob(const int*m, const unsigned char*s, unsigned char*d,
+           unsigned int w, unsigned int h, unsigned int size)
+    : map(m), src(s), dst(d), width(w), height(h), elementSize(size)
+  { }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    unsigned int start, stop;
+    gem::thread::ThreadPool::getSlice(slice, numSlices, height, start, stop);
+    const unsigned int offset=start*width;
+    const unsigned int count=(stop-start)*width;
+    const int*m=map+offset;
+    unsigned char*d=dst+offset*elementSize;
+    unsigned int i=0;
+
+    switch(elementSize) {
+    case 4: {
+      const unsigned int*s32=reinterpret_cast<const unsigned int*>(src);
+      unsigned int*d32=reinterpret_cast<unsigned int*>(d);
+#ifdef __SSE2__
+      if(GEM_SIMD_SSE2 == GemSIMD::getCPU()) {
+        i=gather32SSE2(m, s32, d32, count);
+      }
+#endif
+      gatherScalar(m, s32, d32, i, count);
+    }
+    break;
+    case 2:
+      gatherScalar(m, reinterpret_cast<const unsigned short*>(src),
+                   reinterpret_cast<unsigned short*>(d), 0, count);
+      break;
+    case 1:
+#ifdef __SSE2__
+      if(GEM_SIMD_SSE2 == GemSIMD::getCPU()) {
+        i=gather8SSE2(m, src, d, count);
+      }
+#endif
+      gatherScalar(m, src, d, i, count);
+      break;
+    default:
+      gatherGeneric(m, src, d, count, elementSize);
+      break;
+    }
+  }
+};
+};
+
+namespace gem
+{
+namespace image
+{
+
+Remap::Remap(void)
+  : width(0), height(0)
+  , m_valid(false)
+{
+}
+Remap::~Remap(void)
+{
+}
+
+bool Remap::update(unsigned int w, unsigned int h)
+{
+  if(w!=width || h!=height) {
+    width=w;
+    height=h;
+    m_map.resize(width*height);
+    m_valid=false;
+  }
+  if(m_valid) {
+    return false;
+  }
+  m_valid=true;
+  return true;
+}
+void Remap::invalidate(void)
+{
+  m_valid=false;
+}
+
+int*Remap::map(void)
+{
+  return m_map.empty()?0:&m_map[0];
+}
+const int*Remap::map(void) const
+{
+  return m_map.empty()?0:&m_map[0];
+}
+
+bool Remap::apply(const unsigned char*src, unsigned char*dst,
+                  unsigned int elementSize,
+                  gem::thread::ThreadPool*pool) const
+{
+  if(!src || !dst || !elementSize || m_map.empty()) {
+    return false;
+  }
+  RemapJob job(&m_map[0], src, dst, width, height, elementSize);
+  unsigned int numSlices=pool?pool->getThreads():1;
+  if(numSlices>height) {
+    numSlices=height;
+  }
+  if(numSlices<2) {
+    job.process(0, 1);
+  } else {
+    pool->run(job, numSlices);
+  }
+  return true;
+}
+
+bool Remap::apply(const imageStruct&src, imageStruct&dst,
+                  gem::thread::ThreadPool*pool) const
+{
+  if(!src.data || !width
+      || static_cast<unsigned int>(src.ysize)!=height) {
+    return false;
+  }
+  const unsigned int rowbytes=src.xsize*src.csize;
+  if(rowbytes%width) {
+    return false;
+  }
+  dst.xsize=src.xsize;
+  dst.ysize=src.ysize;
+  dst.setCsizeByFormat(src.format);
+  dst.upsidedown=src.upsidedown;
+  dst.reallocate();
+  return apply(src.data, dst.data, rowbytes/width, pool);
+}
+
+};
+};
@@ -0,0 +1,88 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    ImageRemap.h
+       - geometric transformations of images via precomputed lookup-maps
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_GEM_IMAGEREMAP_H_
+#define _INCLUDE__GEM_GEM_IMAGEREMAP_H_
+
+#include "Gem/ExportDef.h"
+#include <vector>
+
+struct imageStruct;
+
+namespace gem
+{
+namespace thread
+{
+class ThreadPool;
+};
+namespace image
+{
+/**
+ * a lookup-map that tells for each element of the output image,
+ * which element of the source image it is copied from
+ *
+ * an element is usually a pixel; for YUV images it is a macropixel
+ * (2 pixels sharing the chroma), so the map has half the image width
+ * negative entries in the map yield an element with all bytes set to 0
+ *
+ * the map only needs to be (re)built when the geometry changes
+ * (e.g. when a parameter or the image size changes);
+ * applying it is a mere gather of the source elements, which is split
+ * into bands of rows if a 'pool' is given
+ */
+class GEM_EXTERN Remap
+{
+public:
+  Remap(void);
+  virtual ~Remap(void);
+
+  /* the dimensions of the map (in elements) */
+  unsigned int width, height;
+
+  /*
+   * prepare the map for an image of width*height elements
+   * returns true if the map has to be (re)built by the caller
+   * (because the size has changed or because of an invalidate())
+   */
+  bool update(unsigned int width, unsigned int height);
+  /* force a rebuild on the next update() */
+  void invalidate(void);
+
+  /* the width*height indices (row-major) */
+  int*map(void);
+  const int*map(void) const;
+
+  /*
+   * gather the elements of 'src' into 'dst'
+   * both buffers hold width*height elements of 'elementSize' bytes
+   * ('src' and 'dst' must not overlap)
+   */
+  bool apply(const unsigned char*src, unsigned char*dst,
+             unsigned int elementSize,
+             gem::thread::ThreadPool*pool=0) const;
+  /*
+   * remap 'src' into 'dst' (which is reallocated to match 'src')
+   * the element size is deduced from the width of the map
+   */
+  bool apply(const imageStruct&src, imageStruct&dst,
+             gem::thread::ThreadPool*pool=0) const;
+
+private:
+  std::vector<int>m_map;
+  bool m_valid;
+};
+};
+};
+
+#endif /* _INCLUDE__GEM_GEM_IMAGEREMAP_H_ */
@@ -18,10 +18,19 @@
 #include "ImageIO.h"
 #include "Gem/RTE.h"
 #include "Gem/Files.h"
+#include "Gem/Image.h"
+#include "Gem/Properties.h"
+#include "Gem/Settings.h"
+#include "Utils/SynchedWorkerThread.h"
+#include "Utils/ThreadMutex.h"
+#include "Utils/Thread.h"
 
 #include "plugins/imagesaver.h"
 #include "plugins/PluginFactory.h"
 
+#include <map>
+#include <vector>
+
 namespace gem
 {
 namespace PixImageSaver
@@ -35,6 +44,299 @@ static gem::plugins::imagesaver*getInstance(void)
   return s_instance;
 }
 };
+
+namespace image
+{
+/*
+ * a pool of threads that encode and write images
+ * each thread uses a saver (wrapping all plugins) of its own,
+ * so several images are encoded in parallel
+ */
+struct PixImageThreadSaver : public gem::thread::SynchedWorkerThread {
+  struct Job {
+    imageStruct*img;
+    std::string filename;
+    std::string mimetype;
+    gem::Properties props;
+    /* only touched by the main thread */
+    save::callback cb;
+    void*userdata;
+    /* only touched by the worker */
+    bool success;
+    Job(save::callback cb_, void*data_, imageStruct*img_,
+        const std::string&fname, const std::string&mime,
+        const gem::Properties&props_) :
+      img(img_),
+      filename(fname),
+      mimetype(mime),
+      props(props_),
+      cb(cb_),
+      userdata(data_),
+      success(false)
+    {
+    };
+    ~Job(void)
+    {
+      delete img;
+    }
+  };
+
+  /* each worker thread needs a saver of its own;
+   * they are created in the main thread and handed out by acquireSaver() */
+  std::vector<gem::plugins::imagesaver*>m_savers;
+  std::vector<gem::plugins::imagesaver*>m_freeSavers;
+  gem::thread::Mutex m_saverMutex;
+
+  /* jobs that have not been delivered yet (main thread only) */
+  std::map<id_t, Job*>m_pending;
+
+  PixImageThreadSaver(void) :
+    SynchedWorkerThread(false)
+  {
+    gem::plugins::imagesaver*saver=PixImageSaver::getInstance();
+    if(!saver) {
+      throw(40);
+    }
+    if(!saver->isThreadable()) {
+      throw(42);
+    }
+    int threads=0;
+    gem::Settings::get("image.saving.threads", threads);
+    setThreads(threads<0?1:threads);
+    start();
+  }
+  virtual ~PixImageThreadSaver(void)
+  {
+    stop(true);
+    for(unsigned int i=0; i<m_savers.size(); i++) {
+      delete m_savers[i];
+    }
+  }
+
+  virtual unsigned int setThreads(unsigned int numThreads)
+  {
+    if(!numThreads) {
+      numThreads=gem::thread::getCPUCount();
+    }
+    /* the savers must be ready before the threads start */
+    m_saverMutex.lock();
+    while(m_savers.size()<numThreads) {
+      gem::plugins::imagesaver*saver=gem::plugins::imagesaver::getInstance();
+      if(!saver) {
+        break;
+      }
+      m_savers.push_back(saver);
+      m_freeSavers.push_back(saver);
+    }
+    if(m_savers.size()<numThreads) {
+      numThreads=m_savers.size();
+    }
+    m_saverMutex.unlock();
+    if(!numThreads) {
+      stop(true);
+      return 0;
+    }
+    return SynchedWorkerThread::setThreads(numThreads);
+  }
+
+  gem::plugins::imagesaver*acquireSaver(void)
+  {
+    gem::plugins::imagesaver*saver=0;
+    m_saverMutex.lock();
+    if(!m_freeSavers.empty()) {
+      saver=m_freeSavers.back();
+      m_freeSavers.pop_back();
+    }
+    m_saverMutex.unlock();
+    return saver;
+  }
+  void releaseSaver(gem::plugins::imagesaver*saver)
+  {
+    if(!saver) {
+      return;
+    }
+    m_saverMutex.lock();
+    m_freeSavers.push_back(saver);
+    m_saverMutex.unlock();
+  }
+
+  virtual void* process(id_t ID, void*data)
+  {
+    Job*job=reinterpret_cast<Job*>(data);
+    if(!job) {
+      return NULL;
+    }
+    gem::plugins::imagesaver*saver=acquireSaver();
+    job->success=(saver && job->img
+                  && saver->save(*job->img, job->filename, job->mimetype,
+                                 job->props));
+    releaseSaver(saver);
+    /* free the pixels as early as possible */
+    delete job->img;
+    job->img=NULL;
+    return data;
+  };
+
+  virtual void done(id_t ID, void*data)
+  {
+    m_pending.erase(ID);
+    Job*job=reinterpret_cast<Job*>(data);
+    if(!job) {
+      pd_error(0, "saved image:%d with no data!", ID);
+      return;
+    }
+    if(job->cb) {
+      (*(job->cb))(job->userdata, ID, job->filename, job->success);
+    } else if(!job->success) {
+      pd_error(0, "GEM: Unable to save image to '%s'", job->filename.c_str());
+    }
+    delete job;
+  };
+
+  virtual bool queue(id_t&ID, save::callback cb, void*userdata,
+                     imageStruct*img, const std::string&filename,
+                     const std::string&mimetype, const gem::Properties&props)
+  {
+    Job*job=new Job(cb, userdata, img, filename, mimetype, props);
+    if(!SynchedWorkerThread::queue(ID, reinterpret_cast<void*>(job))) {
+      delete job;
+      return false;
+    }
+    m_pending[ID]=job;
+    return true;
+  };
+
+  virtual bool cancel(id_t ID)
+  {
+    std::map<id_t, Job*>::iterator it=m_pending.find(ID);
+    if(it==m_pending.end()) {
+      return false;
+    }
+    if(SynchedWorkerThread::cancel(ID, false)) {
+      delete it->second;
+      m_pending.erase(it);
+    } else {
+      /* in flight: it is written all the same, but not delivered */
+      it->second->cb=0;
+      it->second->userdata=0;
+    }
+    return true;
+  }
+
+  static PixImageThreadSaver*getInstance(bool retry=true)
+  {
+    static bool didit=false;
+    if(!retry && didit) {
+      return s_instance;
+    }
+    didit=true;
+
+    if(NULL==s_instance) {
+      try {
+        s_instance=new PixImageThreadSaver();
+      } catch(int i) {
+        i=0;
+        static bool dunnit=false;
+        if(!dunnit) {
+          verbose(1, "threaded ImageSaving not supported!");
+        }
+        dunnit=true;
+      }
+
+      if(s_instance) {
+        s_instance->setPolling(true);
+      }
+    }
+
+    return s_instance;
+  };
+
+private:
+  static PixImageThreadSaver*s_instance;
+};
+PixImageThreadSaver*PixImageThreadSaver::s_instance=NULL;
+
+
+const save::id_t save::IMMEDIATE= 0;
+const save::id_t save::INVALID  =~0;
+
+bool save::sync(const imageStruct&img,
+                const std::string&filename,
+                const std::string&mimetype,
+                const gem::Properties&props)
+{
+  gem::plugins::imagesaver*piximagesaver=PixImageSaver::getInstance();
+  return (piximagesaver
+          && piximagesaver->save(img, filename, mimetype, props));
+}
+
+bool save::async(save::callback cb,
+                 void*userdata,
+                 imageStruct*img,
+                 const std::string&filename,
+                 const std::string&mimetype,
+                 const gem::Properties&props,
+                 id_t&ID)
+{
+  if(NULL==img) {
+    ID=INVALID;
+    return false;
+  }
+  PixImageThreadSaver*threadsaver=PixImageThreadSaver::getInstance();
+  if(threadsaver) {
+    if(threadsaver->queue(ID, cb, userdata, img, filename, mimetype, props)) {
+      return true;
+    }
+    ID=INVALID;
+    return false;
+  }
+
+  /* no threads: write it right away */
+  bool success=sync(*img, filename, mimetype, props);
+  delete img;
+  ID=IMMEDIATE;
+  if(cb) {
+    (*cb)(userdata, ID, filename, success);
+  } else if(!success) {
+    pd_error(0, "GEM: Unable to save image to '%s'", filename.c_str());
+  }
+  return true;
+}
+
+bool save::cancel(id_t ID)
+{
+  PixImageThreadSaver*threadsaver=PixImageThreadSaver::getInstance(false);
+  if(threadsaver) {
+    return threadsaver->cancel(ID);
+  }
+  return false;
+}
+
+bool save::setPolling(bool value)
+{
+  PixImageThreadSaver*threadsaver=PixImageThreadSaver::getInstance();
+  if(threadsaver) {
+    return threadsaver->setPolling(value);
+  }
+  return true;
+}
+void save::poll(void)
+{
+  PixImageThreadSaver*threadsaver=PixImageThreadSaver::getInstance(false);
+  if(threadsaver) {
+    threadsaver->dequeue();
+  }
+}
+unsigned int save::setThreads(unsigned int threads)
+{
+  PixImageThreadSaver*threadsaver=PixImageThreadSaver::getInstance();
+  if(threadsaver) {
+    return threadsaver->setThreads(threads);
+  }
+  return 0;
+}
+
+}; // image
 };
 
 
@@ -46,16 +348,13 @@ static gem::plugins::imagesaver*getInstance(void)
 GEM_EXTERN int mem2image(imageStruct* image, const char *filename,
                          const int type)
 {
-  gem::plugins::imagesaver*piximagesaver=gem::PixImageSaver::getInstance();
-  if(piximagesaver) {
-    std::string mimetype;
-    gem::Properties props;
-    if(type>0) {
-      props.set("quality", (float)type);
-    }
-    if(piximagesaver->save(*image, filename, mimetype, props)) {
-      return (1);
-    }
+  std::string mimetype;
+  gem::Properties props;
+  if(type>0) {
+    props.set("quality", (float)type);
+  }
+  if(gem::image::save::sync(*image, filename, mimetype, props)) {
+    return (1);
   }
   pd_error(0, "GEM: Unable to save image to '%s'", filename);
   return (0);
@@ -0,0 +1,477 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "ImageStatistics.h"
+#include "Gem/Image.h"
+#include "Gem/GemGL.h"
+#include "Gem/PixConvert.h"
+#include "Utils/SIMD.h"
+#include "Utils/ThreadPool.h"
+
+#include <string.h>
+#include <vector>
+
+namespace
+{
+/* the per-row accumulators are flushed into the (double) results
+ * before they can overflow */
+const unsigned int SCALAR_CHUNK = 16384; /* elements: 16384*255*255 < 2^32 */
+
+template<unsigned int CH>
+void analyzeRowScalar(const unsigned char*data, unsigned int width,
+                      unsigned int y, unsigned int flags,
+                      gem::image::Statistics&stats)
+{
+  const bool doSum    = (flags & (gem::image::Statistics::SUM
+                                  | gem::image::Statistics::VARIANCE
+                                  | gem::image::Statistics::CENTROID));
+  const bool doSum2   = (flags & gem::image::Statistics::VARIANCE);
+  const bool doMinMax = (flags & gem::image::Statistics::MINMAX);
+  const bool doHisto  = (flags & gem::image::Statistics::HISTOGRAM);
+  const bool doX      = (flags & gem::image::Statistics::CENTROID);
+  const bool doLuma   = (CH == 4) && (flags & gem::image::Statistics::LUMA);
+
+  unsigned int x=0;
+  while(x<width) {
+    unsigned int stop=x+SCALAR_CHUNK;
+    if(stop>width) {
+      stop=width;
+    }
+    unsigned int sum[CH], sum2[CH];
+    double sumX[CH];
+    unsigned char mn[CH], mx[CH];
+    for(unsigned int c=0; c<CH; c++) {
+      sum[c]=sum2[c]=0;
+      sumX[c]=0.;
+      mn[c]=stats.min[c];
+      mx[c]=stats.max[c];
+    }
+    const unsigned char*pixels=data+x*CH;
+    for(; x<stop; x++) {
+      for(unsigned int c=0; c<CH; c++) {
+        const unsigned int v=pixels[c];
+        sum [c]+=v;
+        sum2[c]+=v*v;
+        if(doX) {
+          sumX[c]+=static_cast<double>(v*x);
+        }
+        if(v<mn[c]) {
+          mn[c]=v;
+        }
+        if(v>mx[c]) {
+          mx[c]=v;
+        }
+        if(doHisto) {
+          stats.histogram[c][v]++;
+        }
+      }
+      if(doLuma) {
+        const unsigned int grey=((pixels[chRed  ]*RGB2GRAY_RED+
+                                  pixels[chGreen]*RGB2GRAY_GREEN+
+                                  pixels[chBlue ]*RGB2GRAY_BLUE)
+                                 >>8)+RGB2GRAY_OFFSET;
+        stats.luma[grey]++;
+      }
+      pixels+=CH;
+    }
+    for(unsigned int c=0; c<CH; c++) {
+      if(doSum) {
+        stats.sum [c]+=sum[c];
+        stats.sumY[c]+=static_cast<double>(sum[c])*y;
+      }
+      if(doSum2) {
+        stats.sum2[c]+=sum2[c];
+      }
+      if(doX) {
+        stats.sumX[c]+=sumX[c];
+      }
+      if(doMinMax) {
+        stats.min[c]=mn[c];
+        stats.max[c]=mx[c];
+      }
+    }
+  }
+}
+
+void analyzeRowsScalar(const unsigned char*data,
+                       unsigned int width, unsigned int channels,
+                       unsigned int start, unsigned int stop,
+                       unsigned int flags,
+                       gem::image::Statistics&stats)
+{
+  const size_t rowsize=width*channels;
+  for(unsigned int y=start; y<stop; y++) {
+    const unsigned char*row=data+y*rowsize;
+    switch(channels) {
+    case 1:
+      analyzeRowScalar<1>(row, width, y, flags, stats);
+      break;
+    case 2:
+      analyzeRowScalar<2>(row, width, y, flags, stats);
+      break;
+    case 3:
+      analyzeRowScalar<3>(row, width, y, flags, stats);
+      break;
+    case 4:
+      analyzeRowScalar<4>(row, width, y, flags, stats);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+#ifdef __SSE2__
+/* sum, sum of squares and min/max in SSE2
+ * only for layouts where 16 is a multiple of the number of channels (1, 2, 4)
+ * histograms and centroids are done in scalar code on the same (cached) row
+ */
+const unsigned int SSE2_SUMCHUNK  = 128;  /* blocks: 128*2*255 < 2^16 */
+const unsigned int SSE2_SUM2CHUNK = 8192; /* blocks: 8192*4*255*255 < 2^32 */
+
+void analyzeRowsSSE2(const unsigned char*data,
+                     unsigned int width, unsigned int channels,
+                     unsigned int start, unsigned int stop,
+                     unsigned int flags,
+                     gem::image::Statistics&stats)
+{
+  const bool doSum    = (flags & (gem::image::Statistics::SUM
+                                  | gem::image::Statistics::VARIANCE
+                                  | gem::image::Statistics::CENTROID));
+  const bool doSum2   = (flags & gem::image::Statistics::VARIANCE);
+  const bool doMinMax = (flags & gem::image::Statistics::MINMAX);
+  /* whatever cannot be done in SIMD */
+  const unsigned int scalarflags = flags & (gem::image::Statistics::HISTOGRAM
+                                   | gem::image::Statistics::CENTROID
+                                   | gem::image::Statistics::LUMA);
+
+  const size_t rowsize=width*channels;
+  const unsigned int blocks=rowsize/16;
+  const unsigned int rest  =(rowsize%16)/channels;
+  const __m128i zero=_mm_setzero_si128();
+
+  gem::image::Statistics scalar, tail;
+  scalar.channels=tail.channels=channels;
+
+  for(unsigned int y=start; y<stop; y++) {
+    const unsigned char*row=data+y*rowsize;
+    const __m128i*in=reinterpret_cast<const __m128i*>(row);
+    __m128i vmin=_mm_set1_epi8(static_cast<char>(0xFF));
+    __m128i vmax=zero;
+    unsigned int rowsum[4]= {0, 0, 0, 0};
+    double rowsum2[4]= {0, 0, 0, 0};
+
+    unsigned int b=0;
+    while(b<blocks) {
+      unsigned int chunkstop=b+SSE2_SUM2CHUNK;
+      if(chunkstop>blocks) {
+        chunkstop=blocks;
+      }
+      __m128i acc32 =zero;
+      __m128i acc2  =zero;
+      while(b<chunkstop) {
+        unsigned int stop16=b+SSE2_SUMCHUNK;
+        if(stop16>chunkstop) {
+          stop16=chunkstop;
+        }
+        __m128i acc16=zero;
+        for(; b<stop16; b++) {
+          const __m128i v=_mm_loadu_si128(in+b);
+          if(doMinMax) {
+            vmin=_mm_min_epu8(vmin, v);
+            vmax=_mm_max_epu8(vmax, v);
+          }
+          const __m128i lo=_mm_unpacklo_epi8(v, zero);
+          const __m128i hi=_mm_unpackhi_epi8(v, zero);
+          acc16=_mm_add_epi16(acc16, _mm_add_epi16(lo, hi));
+          if(doSum2) {
+            const __m128i lo2=_mm_mullo_epi16(lo, lo);
+            const __m128i hi2=_mm_mullo_epi16(hi, hi);
+            acc2=_mm_add_epi32(acc2, _mm_unpacklo_epi16(lo2, zero));
+            acc2=_mm_add_epi32(acc2, _mm_unpackhi_epi16(lo2, zero));
+            acc2=_mm_add_epi32(acc2, _mm_unpacklo_epi16(hi2, zero));
+            acc2=_mm_add_epi32(acc2, _mm_unpackhi_epi16(hi2, zero));
+          }
+        }
+        acc32=_mm_add_epi32(acc32, _mm_unpacklo_epi16(acc16, zero));
+        acc32=_mm_add_epi32(acc32, _mm_unpackhi_epi16(acc16, zero));
+      }
+      /* lane 'i' holds channel 'i%channels' */
+      unsigned int s[4], s2[4];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(s), acc32);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(s2), acc2);
+      for(unsigned int i=0; i<4; i++) {
+        rowsum [i%channels]+=s [i];
+        rowsum2[i%channels]+=s2[i];
+      }
+    }
+    if(doMinMax) {
+      unsigned char mn[16], mx[16];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(mn), vmin);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(mx), vmax);
+      if(blocks) {
+        for(unsigned int i=0; i<16; i++) {
+          const unsigned int c=i%channels;
+          if(mn[i]<stats.min[c]) {
+            stats.min[c]=mn[i];
+          }
+          if(mx[i]>stats.max[c]) {
+            stats.max[c]=mx[i];
+          }
+        }
+      }
+    }
+    for(unsigned int c=0; c<channels; c++) {
+      if(doSum) {
+        stats.sum [c]+=rowsum[c];
+        stats.sumY[c]+=static_cast<double>(rowsum[c])*y;
+      }
+      if(doSum2) {
+        stats.sum2[c]+=rowsum2[c];
+      }
+    }
+
+    /* the remaining elements */
+    if(rest) {
+      const unsigned int offset=width-rest;
+      const unsigned char*pixels=row+offset*channels;
+      for(unsigned int c=0; c<channels; c++) {
+        tail.sum[c]=tail.sum2[c]=0.;
+        tail.min[c]=255;
+        tail.max[c]=0;
+      }
+      analyzeRowsScalar(pixels, rest, channels, 0, 1,
+                        flags & ~(gem::image::Statistics::HISTOGRAM
+                                  | gem::image::Statistics::CENTROID
+                                  | gem::image::Statistics::LUMA),
+                        tail);
+      for(unsigned int c=0; c<channels; c++) {
+        stats.sum [c]+=tail.sum [c];
+        stats.sum2[c]+=tail.sum2[c];
+        stats.sumY[c]+=tail.sum[c]*y;
+        if(tail.min[c]<stats.min[c]) {
+          stats.min[c]=tail.min[c];
+        }
+        if(tail.max[c]>stats.max[c]) {
+          stats.max[c]=tail.max[c];
+        }
+      }
+    }
+
+    if(scalarflags) {
+      /* the row is still in the cache */
+      scalar.sumX[0]=scalar.sumX[1]=scalar.sumX[2]=scalar.sumX[3]=0.;
+      analyzeRowsScalar(row, width, channels, 0, 1, scalarflags, scalar);
+      for(unsigned int c=0; c<channels; c++) {
+        stats.sumX[c]+=scalar.sumX[c];
+      }
+    }
+  }
+  if(scalarflags) {
+    for(unsigned int c=0; c<channels; c++) {
+      if(flags & gem::image::Statistics::HISTOGRAM) {
+        for(unsigned int i=0; i<256; i++) {
+          stats.histogram[c][i]+=scalar.histogram[c][i];
+        }
+      }
+    }
+    if(flags & gem::image::Statistics::LUMA) {
+      for(unsigned int i=0; i<256; i++) {
+        stats.luma[i]+=scalar.luma[i];
+      }
+    }
+  }
+}
+#endif /* __SSE2__ */
+
+void analyzeRows(const unsigned char*data,
+                 unsigned int width, unsigned int channels,
+                 unsigned int start, unsigned int stop,
+                 unsigned int flags,
+                 gem::image::Statistics&stats)
+{
+#ifdef __SSE2__
+  if(GEM_SIMD_SSE2 == GemSIMD::getCPU()
+      && (1==channels || 2==channels || 4==channels)) {
+    analyzeRowsSSE2(data, width, channels, start, stop, flags, stats);
+    return;
+  }
+#endif
+  analyzeRowsScalar(data, width, channels, start, stop, flags, stats);
+}
+
+/* each band of rows is analyzed into its private Statistics,
+ * which get merged once all bands are done */
+class StatisticsJob : public gem::thread::ThreadPool::Job
+{
+public:
+  const unsigned char*data;
+  unsigned int width, height, channels, flags;
+  std::vector<gem::image::Statistics>&partial;
+  StatisticsJob(const unsigned char*d,
+                unsigned int w, unsigned int h, unsigned int c,
+                unsigned int f,
+                std::vector<gem::image::Statistics>&p)
+    : data(d), width(w), height(h), channels(c), flags(f)
+    , partial(p)
+  { }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    unsigned int start, stop;
+    gem::thread::ThreadPool::getSlice(slice, numSlices, height, start, stop);
+    gem::image::Statistics&stats=partial[slice];
+    stats.clear();
+    stats.channels=channels;
+    analyzeRows(data, width, channels, start, stop, flags, stats);
+  }
+};
+};
+
+namespace gem
+{
+namespace image
+{
+
+Statistics::Statistics(void)
+  : channels(0)
+  , width(0), height(0)
+  , flags(0)
+  , count(0.)
+{
+  clear();
+}
+Statistics::~Statistics(void)
+{
+}
+
+void Statistics::clear(void)
+{
+  count=0.;
+  for(unsigned int c=0; c<MAXCHANNELS; c++) {
+    sum [c]=0.;
+    sum2[c]=0.;
+    sumX[c]=0.;
+    sumY[c]=0.;
+    min [c]=255;
+    max [c]=0;
+  }
+  memset(histogram, 0, sizeof(histogram));
+  memset(luma, 0, sizeof(luma));
+}
+
+void Statistics::merge(const Statistics&other)
+{
+  count+=other.count;
+  for(unsigned int c=0; c<MAXCHANNELS; c++) {
+    sum [c]+=other.sum [c];
+    sum2[c]+=other.sum2[c];
+    sumX[c]+=other.sumX[c];
+    sumY[c]+=other.sumY[c];
+    if(other.min[c]<min[c]) {
+      min[c]=other.min[c];
+    }
+    if(other.max[c]>max[c]) {
+      max[c]=other.max[c];
+    }
+  }
+  if(flags & HISTOGRAM) {
+    for(unsigned int c=0; c<channels; c++) {
+      for(unsigned int i=0; i<256; i++) {
+        histogram[c][i]+=other.histogram[c][i];
+      }
+    }
+  }
+  if(flags & LUMA) {
+    for(unsigned int i=0; i<256; i++) {
+      luma[i]+=other.luma[i];
+    }
+  }
+}
+
+double Statistics::mean(unsigned int channel) const
+{
+  if(channel>=MAXCHANNELS || count<=0.) {
+    return 0.;
+  }
+  return sum[channel]/count;
+}
+double Statistics::variance(unsigned int channel) const
+{
+  if(channel>=MAXCHANNELS || count<=0.) {
+    return 0.;
+  }
+  const double m=mean(channel);
+  const double v=sum2[channel]/count - m*m;
+  return (v>0.)?v:0.;
+}
+
+bool Statistics::analyze(const unsigned char*data,
+                         unsigned int w, unsigned int h, unsigned int ch,
+                         unsigned int f,
+                         gem::thread::ThreadPool*pool)
+{
+  clear();
+  channels=ch;
+  width=w;
+  height=h;
+  flags=f;
+  if(!data || !w || !h || ch<1 || ch>MAXCHANNELS) {
+    return false;
+  }
+  count=static_cast<double>(w)*h;
+
+  unsigned int numSlices=pool?pool->getThreads():1;
+  if(numSlices>h) {
+    numSlices=h;
+  }
+  if(numSlices<2) {
+    analyzeRows(data, w, ch, 0, h, f, *this);
+    return true;
+  }
+
+  std::vector<Statistics>partial(numSlices);
+  for(unsigned int i=0; i<numSlices; i++) {
+    partial[i].flags=f;
+    partial[i].channels=ch;
+  }
+  StatisticsJob job(data, w, h, ch, f, partial);
+  pool->run(job, numSlices);
+  for(unsigned int i=0; i<numSlices; i++) {
+    merge(partial[i]);
+  }
+  count=static_cast<double>(w)*h;
+  return true;
+}
+
+bool Statistics::analyze(const imageStruct&img, unsigned int f,
+                         gem::thread::ThreadPool*pool)
+{
+  switch(img.format) {
+  case GEM_GRAY:
+    return analyze(img.data, img.xsize, img.ysize, 1, f, pool);
+  case GEM_RGB:
+    return analyze(img.data, img.xsize, img.ysize, 3, f, pool);
+  case GEM_RGBA:
+    return analyze(img.data, img.xsize, img.ysize, 4, f, pool);
+  case GEM_YUV:
+    return analyze(img.data, img.xsize/2, img.ysize, 4, f, pool);
+  default:
+    break;
+  }
+  clear();
+  return false;
+}
+
+};
+};
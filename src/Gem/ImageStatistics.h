@@ -0,0 +1,102 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    ImageStatistics.h
+       - single-pass statistics (sums, min/max, variance, histograms)
+         of 8bit image data
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_GEM_IMAGESTATISTICS_H_
+#define _INCLUDE__GEM_GEM_IMAGESTATISTICS_H_
+
+#include "Gem/ExportDef.h"
+
+struct imageStruct;
+
+namespace gem
+{
+namespace thread
+{
+class ThreadPool;
+};
+namespace image
+{
+class GEM_EXTERN Statistics
+{
+public:
+  /* what to calculate */
+  enum {
+    SUM       = (1<<0), /* sum[] (and thus mean()) */
+    MINMAX    = (1<<1), /* min[] and max[] */
+    VARIANCE  = (1<<2), /* sum2[] (and thus variance()); implies SUM */
+    HISTOGRAM = (1<<3), /* histogram[][] */
+    CENTROID  = (1<<4), /* sumX[] and sumY[] (value-weighted coordinates); implies SUM */
+    LUMA      = (1<<5), /* luma[]: histogram of the RGB luminance (4 channels only) */
+    ALL       = SUM|MINMAX|VARIANCE|HISTOGRAM|CENTROID
+  };
+  static const unsigned int MAXCHANNELS = 4;
+
+  Statistics(void);
+  virtual ~Statistics(void);
+
+  /*
+   * analyze interleaved 8bit data
+   * 'width' is the number of elements per row, each element consisting of
+   * 'channels' bytes (1..MAXCHANNELS); rows are tightly packed
+   *
+   * 'flags' selects what to calculate (a combination of the above enum)
+   * if a 'pool' is given, the image is split into bands of rows
+   * that are processed in parallel
+   */
+  bool analyze(const unsigned char*data,
+               unsigned int width, unsigned int height, unsigned int channels,
+               unsigned int flags,
+               gem::thread::ThreadPool*pool=0);
+  /*
+   * analyze an image
+   * GRAY images have 1 channel, RGBA images 4 channels;
+   * YUV images are analyzed per macropixel (4 channels: chU, chY0, chV, chY1)
+   */
+  bool analyze(const imageStruct&img, unsigned int flags,
+               gem::thread::ThreadPool*pool=0);
+
+  /* the results: indices are channel offsets (e.g. chRed) */
+  unsigned int channels;
+  unsigned int width, height;
+  unsigned int flags;
+  /* number of elements that have been analyzed (width*height) */
+  double count;
+
+  double sum [MAXCHANNELS];
+  double sum2[MAXCHANNELS];
+  /* sum of value*column resp. value*row (as stored in memory) */
+  double sumX[MAXCHANNELS];
+  double sumY[MAXCHANNELS];
+  unsigned char min[MAXCHANNELS];
+  unsigned char max[MAXCHANNELS];
+
+  unsigned int histogram[MAXCHANNELS][256];
+  unsigned int luma[256];
+
+  /* mean value of a channel (0..255) */
+  double mean(unsigned int channel) const;
+  /* variance of a channel */
+  double variance(unsigned int channel) const;
+
+  /* reset all results */
+  void clear(void);
+
+  /* merge the results of another analysis of the same geometry */
+  void merge(const Statistics&other);
+};
+};
+};
+
+#endif /* _INCLUDE__GEM_GEM_IMAGESTATISTICS_H_ */
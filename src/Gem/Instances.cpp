@@ -0,0 +1,435 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "Instances.h"
+#include "Gem/ContextData.h"
+
+#include "m_pd.h"
+
+namespace
+{
+/* the values per instance of the fixed attributes */
+const unsigned int TRANSFORM=16;
+const unsigned int COLOR=4;
+
+/* the built-in program comes in three flavours, depending on the texture */
+enum { UNTEXTURED=0, TEXTURE_2D, TEXTURE_RECT, NUM_VARIANTS };
+const char*s_variants[NUM_VARIANTS] = {
+  "\n",
+  "#define TEXTURE_2D 1\n",
+  "#define TEXTURE_RECT 1\n"
+};
+
+const char*s_vertexShader =
+  "attribute mat4 instance_transform;\n"
+  "attribute vec4 instance_color;\n"
+  "uniform bool lighting;\n"
+  "void main(void) {\n"
+  "  vec4 position = instance_transform * gl_Vertex;\n"
+  "  gl_Position = gl_ModelViewProjectionMatrix * position;\n"
+  "  gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;\n"
+  "  vec4 color = gl_Color * instance_color;\n"
+  "  if(lighting) {\n"
+  "    vec3 normal = normalize(gl_NormalMatrix * (mat3(instance_transform) * gl_Normal));\n"
+  "    vec3 light = gl_LightSource[0].position.xyz;\n"
+  "    if(gl_LightSource[0].position.w != 0.) {\n"
+  "      light -= vec3(gl_ModelViewMatrix * position);\n"
+  "    }\n"
+  "    float diffuse = max(dot(normal, normalize(light)), 0.);\n"
+  "    color.rgb *= gl_LightModel.ambient.rgb + gl_LightSource[0].ambient.rgb\n"
+  "               + diffuse * gl_LightSource[0].diffuse.rgb;\n"
+  "  }\n"
+  "  gl_FrontColor = color;\n"
+  "}\n";
+const char*s_fragmentShader =
+  "#if defined(TEXTURE_RECT)\n"
+  "#extension GL_ARB_texture_rectangle : enable\n"
+  "uniform sampler2DRect tex0;\n"
+  "#elif defined(TEXTURE_2D)\n"
+  "uniform sampler2D tex0;\n"
+  "#endif\n"
+  "void main(void) {\n"
+  "#if defined(TEXTURE_RECT)\n"
+  "  gl_FragColor = gl_Color * texture2DRect(tex0, gl_TexCoord[0].st);\n"
+  "#elif defined(TEXTURE_2D)\n"
+  "  gl_FragColor = gl_Color * texture2D(tex0, gl_TexCoord[0].st);\n"
+  "#else\n"
+  "  gl_FragColor = gl_Color;\n"
+  "#endif\n"
+  "}\n";
+
+GLuint compileShader(GLenum type, const char*variant, const char*source)
+{
+  GLuint shader=glCreateShader(type);
+  if(!shader) {
+    return 0;
+  }
+  const char*sources[3] = { "#version 120\n", variant, source };
+  glShaderSource(shader, 3, sources, NULL);
+  glCompileShader(shader);
+  GLint compiled=0;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if(!compiled) {
+    GLint length=0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+    if(length>0) {
+      std::vector<GLchar>log(length+1);
+      glGetShaderInfoLog(shader, length, NULL, &log[0]);
+      verbose(0, "[GEM:Instances] compile log: %s", &log[0]);
+    }
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+
+void vertexAttribDivisor(GLuint index, GLuint divisor)
+{
+  if(glVertexAttribDivisor) {
+    glVertexAttribDivisor(index, divisor);
+  } else {
+    glVertexAttribDivisorARB(index, divisor);
+  }
+}
+
+/* append 'count' entries of 'dimen' values from 'data' to 'dest',
+ * padding with 'defaults' if there are not enough
+ */
+void append(std::vector<float>&dest, const std::vector<float>&data,
+            unsigned int dimen, unsigned int count, const float*defaults)
+{
+  unsigned int have=data.size()/dimen;
+  if(have>count) {
+    have=count;
+  }
+  dest.insert(dest.end(), data.begin(), data.begin()+have*dimen);
+  for(unsigned int i=have; i<count; i++) {
+    dest.insert(dest.end(), defaults, defaults+dimen);
+  }
+}
+};
+
+namespace gem
+{
+
+class Instances::PIMPL
+{
+public:
+  /* the openGL objects of a single context */
+  struct Context {
+    GLuint vbo;
+    unsigned int version; /* version of the data in 'vbo' */
+    GLuint program[NUM_VARIANTS];
+    int status[NUM_VARIANTS]; /* 0: not yet tried; 1: ready; -1: failed */
+    Context(void)
+      : vbo(0)
+      , version(0)
+    {
+      for(unsigned int i=0; i<NUM_VARIANTS; i++) {
+        program[i]=0;
+        status[i]=0;
+      }
+    }
+  };
+  struct Attribute {
+    std::string name;
+    unsigned int dimen;
+    std::vector<float>data;
+    size_t offset; /* in the VBO */
+  };
+
+  unsigned int count;
+  std::vector<float>transforms;
+  std::vector<float>colors;
+  std::vector<Attribute>attributes;
+  size_t colorOffset;
+  unsigned int version;
+
+  gem::ContextData<Context>context;
+
+  /* the state between begin() and end() */
+  std::vector<GLuint>enabled;
+  GLint oldProgram;
+  bool ownProgram;
+
+  PIMPL(void)
+    : count(0)
+    , colorOffset(0)
+    , version(1)
+    , context(Context())
+    , oldProgram(0)
+    , ownProgram(false)
+  {}
+
+  /* (re)fill the buffer object with the current data
+   * (the buffer must be bound)
+   */
+  void upload(void)
+  {
+    static const float identity[TRANSFORM] = {
+      1.f, 0.f, 0.f, 0.f,
+      0.f, 1.f, 0.f, 0.f,
+      0.f, 0.f, 1.f, 0.f,
+      0.f, 0.f, 0.f, 1.f
+    };
+    static const float white[COLOR] = { 1.f, 1.f, 1.f, 1.f };
+    static const float zero[4] = { 0.f, 0.f, 0.f, 0.f };
+
+    std::vector<float>buffer;
+    append(buffer, transforms, TRANSFORM, count, identity);
+    colorOffset=buffer.size()*sizeof(float);
+    append(buffer, colors, COLOR, count, white);
+    for(unsigned int i=0; i<attributes.size(); i++) {
+      Attribute&attr=attributes[i];
+      attr.offset=buffer.size()*sizeof(float);
+      append(buffer, attr.data, attr.dimen, count, zero);
+    }
+    glBufferData(GL_ARRAY_BUFFER, buffer.size()*sizeof(float),
+                 buffer.empty()?0:&buffer[0], GL_DYNAMIC_DRAW);
+  }
+
+  GLuint getProgram(Context&ctx, unsigned int variant)
+  {
+    if(ctx.status[variant]) {
+      return (ctx.status[variant]>0)?ctx.program[variant]:0;
+    }
+    ctx.status[variant]=-1;
+    GLuint vertex=compileShader(GL_VERTEX_SHADER, s_variants[variant],
+                                s_vertexShader);
+    GLuint fragment=compileShader(GL_FRAGMENT_SHADER, s_variants[variant],
+                                  s_fragmentShader);
+    GLuint program=0;
+    if(vertex && fragment) {
+      program=glCreateProgram();
+    }
+    if(program) {
+      glAttachShader(program, vertex);
+      glAttachShader(program, fragment);
+      glLinkProgram(program);
+      GLint linked=0;
+      glGetProgramiv(program, GL_LINK_STATUS, &linked);
+      if(!linked) {
+        glDeleteProgram(program);
+        program=0;
+      }
+    }
+    /* the shaders are flagged for deletion, and go away with the program */
+    if(vertex) {
+      glDeleteShader(vertex);
+    }
+    if(fragment) {
+      glDeleteShader(fragment);
+    }
+    if(!program) {
+      pd_error(0, "[GEM:Instances] unable to build the instancing shader");
+      return 0;
+    }
+    ctx.program[variant]=program;
+    ctx.status[variant]=1;
+    return program;
+  }
+
+  /* point the attribute 'name' of 'program' to the bound buffer */
+  void bindAttribute(GLuint program, const char*name, GLint size,
+                     unsigned int columns, size_t offset)
+  {
+    GLint loc=glGetAttribLocation(program, name);
+    if(loc<0) {
+      return;
+    }
+    const GLsizei stride=size*columns*sizeof(float);
+    for(unsigned int col=0; col<columns; col++) {
+      const GLuint index=loc+col;
+      glEnableVertexAttribArray(index);
+      glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, stride,
+                            reinterpret_cast<const GLvoid*>(offset
+                                + col*size*sizeof(float)));
+      vertexAttribDivisor(index, 1);
+      enabled.push_back(index);
+    }
+  }
+};
+
+/////////////////////////////////////////////////////////
+//
+// Instances
+//
+/////////////////////////////////////////////////////////
+Instances::Instances(void)
+  : m_pimpl(new PIMPL())
+{
+}
+Instances::~Instances(void)
+{
+  delete m_pimpl;
+  m_pimpl=0;
+}
+
+void Instances::setSize(unsigned int count)
+{
+  if(count != m_pimpl->count) {
+    m_pimpl->count=count;
+    m_pimpl->version++;
+  }
+}
+unsigned int Instances::size(void) const
+{
+  return m_pimpl->count;
+}
+
+void Instances::setTransforms(const std::vector<float>&matrices)
+{
+  m_pimpl->transforms=matrices;
+  m_pimpl->version++;
+}
+void Instances::setColors(const std::vector<float>&colors)
+{
+  m_pimpl->colors=colors;
+  m_pimpl->version++;
+}
+void Instances::setAttribute(const std::string&name, unsigned int dimen,
+                             const std::vector<float>&data)
+{
+  std::vector<PIMPL::Attribute>&attributes=m_pimpl->attributes;
+  m_pimpl->version++;
+  for(unsigned int i=0; i<attributes.size(); i++) {
+    if(name == attributes[i].name) {
+      if(data.empty() || dimen<1 || dimen>4) {
+        attributes.erase(attributes.begin()+i);
+      } else {
+        attributes[i].dimen=dimen;
+        attributes[i].data=data;
+      }
+      return;
+    }
+  }
+  if(data.empty() || dimen<1 || dimen>4) {
+    return;
+  }
+  PIMPL::Attribute attr;
+  attr.name=name;
+  attr.dimen=dimen;
+  attr.data=data;
+  attr.offset=0;
+  attributes.push_back(attr);
+}
+
+bool Instances::begin(void)
+{
+  if(!m_pimpl->count || !isRunnable()) {
+    return false;
+  }
+  PIMPL::Context ctx=m_pimpl->context;
+
+  GLint oldBuffer=0;
+  glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &oldBuffer);
+  if(!ctx.vbo) {
+    glGenBuffers(1, &ctx.vbo);
+    if(!ctx.vbo) {
+      return false;
+    }
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, ctx.vbo);
+  if(ctx.version != m_pimpl->version) {
+    m_pimpl->upload();
+    ctx.version=m_pimpl->version;
+  }
+
+  /* use the active program (if any), so users can do their own shading */
+  GLint program=0;
+  glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+  m_pimpl->oldProgram=program;
+  m_pimpl->ownProgram=false;
+  if(!program) {
+    unsigned int variant=UNTEXTURED;
+    if(glIsEnabled(GL_TEXTURE_RECTANGLE_ARB)) {
+      variant=TEXTURE_RECT;
+    } else if(glIsEnabled(GL_TEXTURE_2D)) {
+      variant=TEXTURE_2D;
+    }
+    program=m_pimpl->getProgram(ctx, variant);
+    if(program) {
+      glUseProgram(program);
+      glUniform1i(glGetUniformLocation(program, "lighting"),
+                  glIsEnabled(GL_LIGHTING));
+      glUniform1i(glGetUniformLocation(program, "tex0"), 0);
+      m_pimpl->ownProgram=true;
+    }
+  }
+  m_pimpl->context=ctx;
+  if(!program) {
+    glBindBuffer(GL_ARRAY_BUFFER, oldBuffer);
+    return false;
+  }
+
+  m_pimpl->enabled.clear();
+  m_pimpl->bindAttribute(program, "instance_transform", 4, 4, 0);
+  m_pimpl->bindAttribute(program, "instance_color", COLOR, 1,
+                         m_pimpl->colorOffset);
+  for(unsigned int i=0; i<m_pimpl->attributes.size(); i++) {
+    const PIMPL::Attribute&attr=m_pimpl->attributes[i];
+    m_pimpl->bindAttribute(program, attr.name.c_str(), attr.dimen, 1,
+                           attr.offset);
+  }
+
+  /* the vertex arrays of the consumer are left alone */
+  glBindBuffer(GL_ARRAY_BUFFER, oldBuffer);
+  return true;
+}
+
+void Instances::draw(GLenum mode, GLint first, GLsizei count)
+{
+  if(glDrawArraysInstanced) {
+    glDrawArraysInstanced(mode, first, count, m_pimpl->count);
+  } else {
+    glDrawArraysInstancedARB(mode, first, count, m_pimpl->count);
+  }
+}
+
+void Instances::end(void)
+{
+  /* the attribute divisors would otherwise stick with the attribute */
+  for(unsigned int i=0; i<m_pimpl->enabled.size(); i++) {
+    vertexAttribDivisor(m_pimpl->enabled[i], 0);
+    glDisableVertexAttribArray(m_pimpl->enabled[i]);
+  }
+  m_pimpl->enabled.clear();
+  if(m_pimpl->ownProgram) {
+    glUseProgram(m_pimpl->oldProgram);
+    m_pimpl->ownProgram=false;
+  }
+}
+
+void Instances::release(void)
+{
+  PIMPL::Context ctx=m_pimpl->context;
+  if(ctx.vbo && glDeleteBuffers) {
+    glDeleteBuffers(1, &ctx.vbo);
+  }
+  for(unsigned int i=0; i<NUM_VARIANTS; i++) {
+    if(ctx.program[i]) {
+      glDeleteProgram(ctx.program[i]);
+    }
+  }
+  m_pimpl->context=PIMPL::Context();
+}
+
+bool Instances::isRunnable(void)
+{
+  return GLEW_VERSION_2_0
+         && (glVertexAttribDivisor || glVertexAttribDivisorARB)
+         && (glDrawArraysInstanced || glDrawArraysInstancedARB)
+         && glGenBuffers;
+}
+};
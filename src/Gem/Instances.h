@@ -0,0 +1,96 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    Instances.h
+       - per-instance data for hardware-instanced rendering
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_GEM_INSTANCES_H_
+#define _INCLUDE__GEM_GEM_INSTANCES_H_
+
+#include "Gem/GemGL.h"
+#include <string>
+#include <vector>
+
+namespace gem
+{
+/**
+ * a set of instances: a transformation matrix, a colour and
+ * any number of custom attributes per instance
+ *
+ * the data lives in a vertex buffer object,
+ * and geometry is drawn once for each instance with a single
+ * glDrawArraysInstanced() call
+ *
+ * if no GLSL program is active, a built-in program is used,
+ * that applies the transformation and the colour
+ * (with textures on unit 0 and simple diffuse lighting by the first light)
+ * user programs get the per-instance data as vertex attributes:
+ *   - attribute mat4 instance_transform;
+ *   - attribute vec4 instance_color;
+ *   - attribute float|vec2|vec3|vec4 <name>; (custom attributes)
+ *
+ * consumers (geos) find the instances in the GemState ("gl.instances"),
+ * and call begin(), draw() (any number of times) and end()
+ * all these methods must be called with a valid openGL context
+ */
+class GEM_EXTERN Instances
+{
+private:
+  class PIMPL;
+  PIMPL*m_pimpl;
+
+  /* dummy implementations */
+  Instances(const Instances&);
+  Instances&operator=(const Instances&);
+
+public:
+  Instances(void);
+  virtual ~Instances(void);
+
+  ////
+  // set the number of instances
+  // missing per-instance data is padded with defaults
+  // (the identity matrix, opaque white, zeros)
+  virtual void setSize(unsigned int count);
+  virtual unsigned int size(void) const;
+
+  ////
+  // the transformation matrices (16 column-major values per instance)
+  virtual void setTransforms(const std::vector<float>&matrices);
+  // the colours (RGBA-quadruples)
+  virtual void setColors(const std::vector<float>&colors);
+  // a custom attribute with 'dimen' (1..4) values per instance
+  // (an empty 'data' removes the attribute)
+  virtual void setAttribute(const std::string&name, unsigned int dimen,
+                            const std::vector<float>&data);
+
+  ////
+  // prepare for drawing the instances
+  // (uploads the data if it has changed, and binds the program)
+  // returns false if the instances cannot be drawn
+  virtual bool begin(void);
+  // draw the currently bound vertex arrays for each instance
+  virtual void draw(GLenum mode, GLint first, GLsizei count);
+  // restore the state as before begin()
+  virtual void end(void);
+
+  ////
+  // release the openGL resources of the current context
+  virtual void release(void);
+
+  ////
+  // whether the current openGL context allows instanced rendering
+  // (GLSL, instanced arrays and instanced draw-calls)
+  static bool isRunnable(void);
+};
+};
+
+#endif /* _INCLUDE__GEM_GEM_INSTANCES_H_ */
@@ -24,9 +24,13 @@
 #include "Gem/GLStack.h"
 #include "Gem/State.h"
 #include "Gem/Event.h"
+#include "Gem/FrameTiming.h"
+#include "Gem/ImageIO.h"
+#include "Gem/ModelView.h"
 
 #include <stdlib.h>
 #include <string.h>
+#include <vector>
 
 #ifdef __unix__
 # include <sys/time.h>
@@ -114,6 +118,27 @@ static t_clock *s_clock = NULL;
 static double s_deltime = 50.;
 static int s_hit = 0;
 
+static int s_schedule = GemMan::SCHEDULE_FIXED;
+// the shortest delay between two frames:
+// a clock that is re-set with a delay of 0 fires again within the same
+// scheduler tick, and Pd would never get a chance to process messages
+static const double s_mindeltime = 1.;
+static gem::FrameTiming s_timing;
+// realtime (in ms) when the last frame was swapped, and when the next one is due
+static double s_lastSwap = 0.;
+static double s_deadline = 0.;
+
+static t_clock *s_prepareClock = NULL;
+static bool s_prepared = false;
+typedef std::pair<GemMan::prepareCallback, void*> prepare_t;
+static std::vector<prepare_t> s_prepareCallbacks;
+// deliver the images that have been loaded (or saved) in the background
+static void pollImageIO(void*)
+{
+  gem::image::load::poll();
+  gem::image::save::poll();
+}
+
 GEM_EXTERN void gemAbortRendering()
 {
   GemMan::stopRendering();
@@ -264,6 +289,9 @@ void GemMan :: initGem()
   m_mat_shininess = 100.0;
 
   s_clock = clock_new(NULL, reinterpret_cast<t_method>(&GemMan::render));
+  s_prepareClock = clock_new(NULL,
+                             reinterpret_cast<t_method>(&GemMan::prepare));
+  addPrepareCallback(pollImageIO, NULL);
 
   GemSIMD simd_init;
 
@@ -506,6 +534,14 @@ void GemMan :: resetState()
   gem::Settings::get("window.fps", rate);
   frameRate(rate);
 
+  int schedule=SCHEDULE_FIXED;
+  gem::Settings::get("window.schedule", schedule);
+  scheduleMode(schedule);
+
+  int deferred=1;
+  gem::Settings::get("modelview.deferred", deferred);
+  gem::ModelView::setEnabled(deferred!=0);
+
 }
 
 /////////////////////////////////////////////////////////
@@ -571,6 +607,13 @@ void GemMan :: render(void *)
     return;
   }
 
+  // any CPU work that is still pending should not eat into the frame time
+  if(!s_prepared) {
+    clock_unset(s_prepareClock);
+    prepare(NULL);
+  }
+  s_prepared=false;
+
   // are we profiling?
   double starttime=sys_getrealtime();
   double stoptime=0;
@@ -856,10 +899,33 @@ void GemMan :: render(void *)
     renderChain(chain2, &currentState);
   }
   }
+  double swaptime=sys_getrealtime();
   swapBuffers();
 
   // are we profiling?
   stoptime=sys_getrealtime();
+
+  const double now=stoptime*1000.;
+  const double interval=(s_lastSwap>0.)?(now-s_lastSwap):0.;
+  double vsync=s_timing.getVsyncPeriod();
+  bool missed=false;
+  if(SCHEDULE_DEADLINE==s_schedule && s_deadline>0.) {
+    // with vsync, the swap returns anywhere within the refresh period
+    missed=(now > s_deadline + ((vsync>0.)?(vsync*0.5):1.));
+  } else if(vsync>0. && interval>0.) {
+    // we skipped a refresh
+    missed=(interval > 1.5*vsync);
+  }
+  // the refresh period can only be derived from a swap that happens right here
+#ifndef GEM_MULTICONTEXT
+  const bool swapMeasured=(2 == GemMan::m_buffer);
+#else
+  const bool swapMeasured=false;
+#endif
+  s_timing.add(interval, (swaptime-starttime)*1000.,
+               swapMeasured?((stoptime-swaptime)*1000.):-1.,
+               missed);
+  s_lastSwap=now;
   if (profiling>0) {
     double seconds =  stoptime-starttime;
     if(seconds>0.f) {
@@ -872,23 +938,57 @@ void GemMan :: render(void *)
   // only keep going if no one set the s_hit (could be hit if scheduler gets
   //        ahold of a stopRendering command)
   double deltime=s_deltime;
-  if(profiling<0) {
-    float spent=(stoptime-starttime)*1000;
-    if(profiling<-1) {
-      deltime-=spent;
-    } else if(spent<deltime && spent>0.f) {
-      deltime-=spent;
+  switch(s_schedule) {
+  case SCHEDULE_FREE:
+    deltime=s_mindeltime;
+    break;
+  case SCHEDULE_DEADLINE:
+    if(0.0 == s_deltime) {
+      break;
+    }
+    vsync=s_timing.getVsyncPeriod();
+    if(vsync>0.) {
+      // the swap is synced to the display, so it sets the phase
+      s_deadline=now+((vsync>s_deltime)?vsync:s_deltime);
+    } else if(s_deadline>0.) {
+      s_deadline+=s_deltime;
+      // skip the frames we are too late for
+      while(s_deadline<now) {
+        s_deadline+=s_deltime;
+      }
     } else {
-      post("unable to annihiliate %f ms", spent);
+      s_deadline=now+s_deltime;
     }
-    if(deltime<0.) {
-      verbose(1, "negative delay time: %f", deltime);
-      deltime=1.f;
+    // start rendering just in time to finish before the deadline
+    deltime=s_deadline-now-s_timing.getPredictedRenderTime();
+    if(deltime<s_mindeltime) {
+      deltime=s_mindeltime;
     }
+    break;
+  default:
+    if(profiling<0) {
+      float spent=(stoptime-starttime)*1000;
+      if(profiling<-1) {
+        deltime-=spent;
+      } else if(spent<deltime && spent>0.f) {
+        deltime-=spent;
+      } else {
+        post("unable to annihiliate %f ms", spent);
+      }
+      if(deltime<0.) {
+        verbose(1, "negative delay time: %f", deltime);
+        deltime=1.f;
+      }
+    }
+    break;
   }
 
-  if (!s_hit && (0.0 != deltime)) {
-    clock_delay(s_clock, deltime);
+  if (!s_hit) {
+    // do the CPU work for the next frame while we are waiting
+    clock_delay(s_prepareClock, 0.);
+    if(0.0 != deltime) {
+      clock_delay(s_clock, deltime);
+    }
   }
 
   glReportError();
@@ -923,6 +1023,8 @@ void GemMan :: startRendering()
   }
 
   m_lastRenderTime = clock_getsystime();
+  s_lastSwap = s_deadline = 0.;
+  s_timing.reset();
   render(NULL);
 }
 
@@ -938,6 +1040,7 @@ void GemMan :: stopRendering()
 
   m_rendering = 0;
   clock_unset(s_clock);
+  clock_unset(s_prepareClock);
   s_hit = 1;
 
   // clean out all of the gemheads
@@ -1324,6 +1427,68 @@ float GemMan :: getFramerate()
   return (s_deltime != 0.0) ? (1000. / s_deltime) : 0.0;
 }
 
+/////////////////////////////////////////////////////////
+// scheduleMode
+//
+/////////////////////////////////////////////////////////
+void GemMan :: scheduleMode(int mode)
+{
+  switch(mode) {
+  case SCHEDULE_FIXED:
+  case SCHEDULE_DEADLINE:
+  case SCHEDULE_FREE:
+    break;
+  default:
+    pd_error(0, "GEM: Invalid schedule mode %d (0=fixed, 1=deadline, 2=free)",
+             mode);
+    return;
+  }
+  s_schedule = mode;
+  s_deadline = 0.;
+}
+
+/////////////////////////////////////////////////////////
+// prepare
+//
+/////////////////////////////////////////////////////////
+void GemMan :: addPrepareCallback(prepareCallback cb, void*data)
+{
+  if(cb) {
+    s_prepareCallbacks.push_back(prepare_t(cb, data));
+  }
+}
+void GemMan :: removePrepareCallback(prepareCallback cb, void*data)
+{
+  std::vector<prepare_t>::iterator it=s_prepareCallbacks.begin();
+  while(it!=s_prepareCallbacks.end()) {
+    if(it->first == cb && it->second == data) {
+      it=s_prepareCallbacks.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+void GemMan :: prepare(void*)
+{
+  s_prepared = true;
+
+  // callbacks might (un)register themselves, so we iterate over a copy
+  std::vector<prepare_t>callbacks=s_prepareCallbacks;
+  for(unsigned int i=0; i<callbacks.size(); i++) {
+    callbacks[i].first(callbacks[i].second);
+  }
+
+  t_symbol*s=gensym("__gem_prepare");
+  if(s->s_thing) {
+    pd_bang(s->s_thing);
+  }
+}
+
+gem::FrameTiming&GemMan :: getTiming(void)
+{
+  return s_timing;
+}
+
 
 /////////////////////////////////////////////////////////
 // get window dimensions
@@ -1522,6 +1687,7 @@ void GemMan :: printInfo()
   post("width: %d, height %d", m_width, m_height);
   post("offset: %d+%d", m_xoffset, m_yoffset);
   post("frame rate: %f", (0.0 != s_deltime) ? 1000. / s_deltime : 0.0);
+  post("schedule: %d", s_schedule);
 
   GLint bitnum = 0;
   glGetIntegerv(GL_RED_BITS, &bitnum);
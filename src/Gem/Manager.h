@@ -32,6 +32,7 @@ class WindowInfo;
 namespace gem
 {
 class Context;
+class FrameTiming;
 };
 
 /*-----------------------------------------------------------------
@@ -118,6 +119,27 @@ public:
   // Get the frame rate
   static float      getFramerate(void);
 
+  //////////
+  // How the next frame is scheduled
+  enum ScheduleMode {
+    SCHEDULE_FIXED = 0, // wait 1/fps after each frame
+    SCHEDULE_DEADLINE,  // finish each frame at a fixed rate (adapting to vsync)
+    SCHEDULE_FREE       // render the next frame as soon as possible
+  };
+  static void       scheduleMode(int mode);
+
+  //////////
+  // CPU work that should be done between two frames
+  // (so it does not delay the swap)
+  // the callbacks are called right after a frame has been swapped
+  typedef void (*prepareCallback)(void*data);
+  static void       addPrepareCallback(prepareCallback cb, void*data);
+  static void       removePrepareCallback(prepareCallback cb, void*data);
+
+  //////////
+  // timing statistics of the rendered frames
+  static gem::FrameTiming&getTiming(void);
+
   static int        getProfileLevel(void);
 
   static void getDimen(int*width, int*height);
@@ -251,6 +273,8 @@ private:
   static void       windowCleanup(void);
   static void       resetValues(void);
 
+  static void prepare(void*);
+
   static void resizeCallback(int xsize, int ysize, void*);
   static void dispatchWinmessCallback(void *owner);
 
@@ -0,0 +1,348 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "Mesh.h"
+#include "Instances.h"
+#include <map>
+
+namespace
+{
+/* x/y/z, nx/ny/nz, s/t */
+const unsigned int STRIDE=8;
+/* keep at most that many meshes around that are no longer used by anybody
+ * (so objects that switch back and forth don't have to rebuild them) */
+const unsigned int MAXUNUSED=32;
+
+typedef std::pair<std::string, std::vector<float> > MeshKey;
+typedef std::map<MeshKey, gem::Mesh*> MeshMap;
+MeshMap s_meshes;
+};
+
+namespace gem
+{
+MeshBuilder::~MeshBuilder(void)
+{
+}
+
+/////////////////////////////////////////////////////////
+//
+// ImmediateMesh
+//
+/////////////////////////////////////////////////////////
+ImmediateMesh::ImmediateMesh(float sx, float sy, float sz)
+  : m_sx(sx), m_sy(sy), m_sz(sz)
+{
+}
+ImmediateMesh::~ImmediateMesh(void)
+{
+}
+void ImmediateMesh::begin(GLenum mode)
+{
+  glBegin(mode);
+}
+void ImmediateMesh::end(void)
+{
+  glEnd();
+}
+void ImmediateMesh::normal(float x, float y, float z)
+{
+  glNormal3f(x, y, z);
+}
+void ImmediateMesh::texcoord(float s, float t)
+{
+  glTexCoord2f(s, t);
+}
+void ImmediateMesh::vertex(float x, float y, float z)
+{
+  glVertex3f(x*m_sx, y*m_sy, z*m_sz);
+}
+
+/////////////////////////////////////////////////////////
+//
+// Mesh
+//
+/////////////////////////////////////////////////////////
+Mesh::Mesh(void)
+  : m_mode(0)
+  , m_hasNormals(false), m_hasTexCoords(false)
+  , m_finished(false), m_valid(true)
+  , m_vbo(0)
+  , m_refcount(0)
+{
+  m_normal[0]=m_normal[1]=0.f;
+  m_normal[2]=1.f;
+  m_texcoord[0]=m_texcoord[1]=0.f;
+  for(unsigned int i=0; i<NUM_BATCHES; i++) {
+    m_first[i]=0;
+    m_count[i]=0;
+  }
+}
+Mesh::~Mesh(void)
+{
+}
+
+void Mesh::begin(GLenum mode)
+{
+  m_mode=mode;
+  m_primitive.clear();
+}
+void Mesh::normal(float x, float y, float z)
+{
+  m_normal[0]=x;
+  m_normal[1]=y;
+  m_normal[2]=z;
+  m_hasNormals=true;
+}
+void Mesh::texcoord(float s, float t)
+{
+  m_texcoord[0]=s;
+  m_texcoord[1]=t;
+  m_hasTexCoords=true;
+}
+void Mesh::vertex(float x, float y, float z)
+{
+  m_primitive.push_back(x);
+  m_primitive.push_back(y);
+  m_primitive.push_back(z);
+  m_primitive.push_back(m_normal[0]);
+  m_primitive.push_back(m_normal[1]);
+  m_primitive.push_back(m_normal[2]);
+  m_primitive.push_back(m_texcoord[0]);
+  m_primitive.push_back(m_texcoord[1]);
+}
+void Mesh::emit(unsigned int batch, unsigned int index)
+{
+  const float*v=&m_primitive[index*STRIDE];
+  m_batch[batch].insert(m_batch[batch].end(), v, v+STRIDE);
+}
+void Mesh::end(void)
+{
+  const unsigned int n=m_primitive.size()/STRIDE;
+  unsigned int i;
+  switch(m_mode) {
+  case GL_POINTS:
+    for(i=0; i<n; i++) {
+      emit(POINTS, i);
+    }
+    break;
+  case GL_LINES:
+    for(i=0; i+1<n; i+=2) {
+      emit(LINES, i);
+      emit(LINES, i+1);
+    }
+    break;
+  case GL_LINE_STRIP:
+  case GL_LINE_LOOP:
+    for(i=0; i+1<n; i++) {
+      emit(LINES, i);
+      emit(LINES, i+1);
+    }
+    if(GL_LINE_LOOP == m_mode && n>1) {
+      emit(LINES, n-1);
+      emit(LINES, 0);
+    }
+    break;
+  case GL_TRIANGLES:
+    for(i=0; i+2<n; i+=3) {
+      emit(TRIANGLES, i);
+      emit(TRIANGLES, i+1);
+      emit(TRIANGLES, i+2);
+    }
+    break;
+  case GL_TRIANGLE_STRIP:
+    /* keep the winding of every other triangle */
+    for(i=0; i+2<n; i++) {
+      emit(TRIANGLES, (i&1)?(i+1):i);
+      emit(TRIANGLES, (i&1)?i:(i+1));
+      emit(TRIANGLES, i+2);
+    }
+    break;
+  case GL_TRIANGLE_FAN:
+  case GL_POLYGON:
+    for(i=1; i+1<n; i++) {
+      emit(TRIANGLES, 0);
+      emit(TRIANGLES, i);
+      emit(TRIANGLES, i+1);
+    }
+    break;
+  case GL_QUADS:
+    for(i=0; i+3<n; i+=4) {
+      emit(QUADS, i);
+      emit(QUADS, i+1);
+      emit(QUADS, i+2);
+      emit(QUADS, i+3);
+    }
+    break;
+  case GL_QUAD_STRIP:
+    for(i=0; i+3<n; i+=2) {
+      emit(QUADS, i);
+      emit(QUADS, i+1);
+      emit(QUADS, i+3);
+      emit(QUADS, i+2);
+    }
+    break;
+  default:
+    /* e.g. primitives with adjacency */
+    m_valid=false;
+    break;
+  }
+  m_primitive.clear();
+}
+
+bool Mesh::empty(void) const
+{
+  return !m_finished;
+}
+void Mesh::finish(void)
+{
+  m_data.clear();
+  for(unsigned int i=0; i<NUM_BATCHES; i++) {
+    m_first[i]=m_data.size()/STRIDE;
+    m_count[i]=m_batch[i].size()/STRIDE;
+    m_data.insert(m_data.end(), m_batch[i].begin(), m_batch[i].end());
+    std::vector<float>().swap(m_batch[i]);
+  }
+  std::vector<float>().swap(m_primitive);
+  m_finished=true;
+}
+bool Mesh::isValid(void) const
+{
+  return m_valid;
+}
+
+bool Mesh::draw(Instances*instances)
+{
+  if(!m_finished || !m_valid) {
+    return false;
+  }
+  if(m_data.empty()) {
+    return true;
+  }
+
+  /* without VBOs, we can still use plain vertex arrays */
+  const float*data=&m_data[0];
+  if(glGenBuffers && glBindBuffer && glBufferData) {
+    GLuint vbo=m_vbo;
+    if(!vbo) {
+      glGenBuffers(1, &vbo);
+      glBindBuffer(GL_ARRAY_BUFFER, vbo);
+      glBufferData(GL_ARRAY_BUFFER, m_data.size()*sizeof(float), data,
+                   GL_STATIC_DRAW);
+      m_vbo=vbo;
+    } else {
+      glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    }
+    if(vbo) {
+      data=0;
+    }
+  }
+
+  const GLsizei stride=STRIDE*sizeof(float);
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(3, GL_FLOAT, stride, data);
+  if(m_hasNormals) {
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glNormalPointer(GL_FLOAT, stride, data+3);
+  }
+  if(m_hasTexCoords) {
+    if(glClientActiveTexture) {
+      glClientActiveTexture(GL_TEXTURE0);
+    }
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glTexCoordPointer(2, GL_FLOAT, stride, data+6);
+  }
+
+  static const GLenum modes[NUM_BATCHES] = {
+    GL_POINTS, GL_LINES, GL_TRIANGLES, GL_QUADS
+  };
+  if(instances && instances->begin()) {
+    for(unsigned int i=0; i<NUM_BATCHES; i++) {
+      if(m_count[i]) {
+        instances->draw(modes[i], m_first[i], m_count[i]);
+      }
+    }
+    instances->end();
+  } else {
+    for(unsigned int i=0; i<NUM_BATCHES; i++) {
+      if(m_count[i]) {
+        glDrawArrays(modes[i], m_first[i], m_count[i]);
+      }
+    }
+  }
+
+  glPopClientAttrib();
+  if(!data && glBindBuffer) {
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+  return true;
+}
+
+void Mesh::destroy(void)
+{
+  GLuint vbo=m_vbo;
+  if(vbo && glDeleteBuffers) {
+    glDeleteBuffers(1, &vbo);
+  }
+  m_vbo=0;
+}
+
+/////////////////////////////////////////////////////////
+// the cache
+//
+/////////////////////////////////////////////////////////
+Mesh*Mesh::acquire(const std::string&name, const std::vector<float>&params)
+{
+  const MeshKey key(name, params);
+  MeshMap::iterator it=s_meshes.find(key);
+  if(s_meshes.end() != it) {
+    it->second->m_refcount++;
+    return it->second;
+  }
+
+  /* we are about to add a new mesh; throw away the unused ones
+   * if there are too many (there's a context, as we are rendering) */
+  unsigned int unused=0;
+  for(it=s_meshes.begin(); it!=s_meshes.end(); ++it) {
+    if(!it->second->m_refcount) {
+      unused++;
+    }
+  }
+  if(unused>=MAXUNUSED) {
+    it=s_meshes.begin();
+    while(it!=s_meshes.end()) {
+      Mesh*mesh=it->second;
+      if(mesh->m_refcount) {
+        ++it;
+        continue;
+      }
+      mesh->destroy();
+      delete mesh;
+      s_meshes.erase(it++);
+    }
+  }
+
+  Mesh*mesh=new Mesh();
+  mesh->m_refcount=1;
+  s_meshes[key]=mesh;
+  return mesh;
+}
+
+void Mesh::release(Mesh*mesh)
+{
+  if(mesh && mesh->m_refcount) {
+    mesh->m_refcount--;
+  }
+}
+};
@@ -0,0 +1,152 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    Mesh.h
+       - retained geometry of the built-in shapes
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_GEM_MESH_H_
+#define _INCLUDE__GEM_GEM_MESH_H_
+
+#include "Gem/GemGL.h"
+#include "Gem/ContextData.h"
+#include <string>
+#include <vector>
+
+namespace gem
+{
+class Instances;
+
+/**
+ * something that takes geometry,
+ * specified just like in openGL's immediate mode
+ * (glBegin(), glNormal3f(), glTexCoord2f(), glVertex3f(), glEnd())
+ */
+class GEM_EXTERN MeshBuilder
+{
+public:
+  virtual ~MeshBuilder(void);
+
+  virtual void begin(GLenum mode) = 0;
+  virtual void end(void) = 0;
+
+  virtual void normal(float x, float y, float z) = 0;
+  virtual void texcoord(float s, float t) = 0;
+  virtual void vertex(float x, float y, float z) = 0;
+  void vertex(float x, float y)
+  {
+    vertex(x, y, 0.f);
+  }
+};
+
+/**
+ * passes the geometry directly on to openGL
+ * (the vertices are scaled on the way)
+ */
+class GEM_EXTERN ImmediateMesh : public MeshBuilder
+{
+public:
+  ImmediateMesh(float sx=1.f, float sy=1.f, float sz=1.f);
+  virtual ~ImmediateMesh(void);
+
+  virtual void begin(GLenum mode);
+  virtual void end(void);
+  virtual void normal(float x, float y, float z);
+  virtual void texcoord(float s, float t);
+  virtual void vertex(float x, float y, float z);
+
+private:
+  float m_sx, m_sy, m_sz;
+};
+
+/**
+ * records the geometry, and draws it from a vertex buffer object
+ *
+ * all primitives are converted into (at most) four batches
+ * of points, lines, triangles and quads
+ * (quads are kept, so drawing with glPolygonMode() still outlines them)
+ *
+ * meshes are shared by all objects that would generate the same geometry:
+ * they are kept in a process-wide cache, identified by a name
+ * (the type of the shape) and the parameters the geometry depends on
+ */
+class GEM_EXTERN Mesh : public MeshBuilder
+{
+public:
+  virtual void begin(GLenum mode);
+  virtual void end(void);
+  virtual void normal(float x, float y, float z);
+  virtual void texcoord(float s, float t);
+  virtual void vertex(float x, float y, float z);
+
+  /* whether the geometry still has to be recorded */
+  bool empty(void) const;
+  /* done recording */
+  void finish(void);
+
+  /* whether the geometry could be converted into vertex arrays
+   * (if not, it has to be rendered in immediate mode)
+   */
+  bool isValid(void) const;
+
+  /* draw the geometry
+   * (the first time in a context, the vertex buffer object is created)
+   * if 'instances' are given, the geometry is drawn once for each of them
+   */
+  bool draw(Instances*instances=0);
+
+  /*
+   * get the mesh with the given name and parameters from the cache
+   * (a new empty one is created if needed)
+   * the caller holds a reference and must return it with release()
+   */
+  static Mesh*acquire(const std::string&name,
+                      const std::vector<float>&params);
+  /*
+   * give a reference back
+   * meshes that are no longer used are kept for a while
+   * (their openGL resources are freed from within acquire(),
+   * when we know that there is a context)
+   */
+  static void release(Mesh*mesh);
+
+private:
+  Mesh(void);
+  virtual ~Mesh(void);
+  Mesh(const Mesh&);
+  Mesh&operator=(const Mesh&);
+
+  void emit(unsigned int batch, unsigned int index);
+  void destroy(void);
+
+  enum { POINTS=0, LINES, TRIANGLES, QUADS, NUM_BATCHES };
+
+  /* the batches while recording, each is x/y/z, nx/ny/nz, s/t per vertex */
+  std::vector<float>m_batch[NUM_BATCHES];
+  /* the primitive that is currently recorded */
+  GLenum m_mode;
+  std::vector<float>m_primitive;
+  float m_normal[3];
+  float m_texcoord[2];
+  bool m_hasNormals, m_hasTexCoords;
+
+  /* all the batches in a single array, once we are done */
+  std::vector<float>m_data;
+  GLint m_first[NUM_BATCHES];
+  GLsizei m_count[NUM_BATCHES];
+  bool m_finished, m_valid;
+
+  gem::ContextData<GLuint>m_vbo;
+
+  unsigned int m_refcount;
+};
+};
+
+#endif /* _INCLUDE__GEM_GEM_MESH_H_ */
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "ModelView.h"
+#include "Gem/GemGL.h"
+#include "Utils/Matrix.h"
+
+namespace
+{
+Matrix s_matrix;
+bool s_enabled=true;
+};
+
+namespace gem
+{
+bool ModelView::s_pending=false;
+
+Matrix*ModelView::defer(void)
+{
+  if(!s_enabled) {
+    return 0;
+  }
+  if(!s_pending) {
+    s_matrix.identity();
+    s_pending=true;
+  }
+  return &s_matrix;
+}
+
+bool ModelView::apply(void)
+{
+  s_pending=false;
+  if(s_matrix.isIdentity()) {
+    return false;
+  }
+  float m[16];
+  s_matrix.getColumnMajor(m);
+  glMultMatrixf(m);
+  return true;
+}
+
+void ModelView::discard(void)
+{
+  s_pending=false;
+}
+
+void ModelView::setEnabled(bool enabled)
+{
+  s_enabled=enabled;
+}
+bool ModelView::isEnabled(void)
+{
+  return s_enabled;
+}
+};
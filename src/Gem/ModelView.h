@@ -0,0 +1,67 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    ModelView.h
+       - deferred transformations of the modelview matrix
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_GEM_MODELVIEW_H_
+#define _INCLUDE__GEM_GEM_MODELVIEW_H_
+
+#include "Gem/ExportDef.h"
+
+class Matrix;
+
+namespace gem
+{
+/**
+ * transformations of the modelview matrix that have not been applied yet
+ *
+ * manipulators like [rotate] or [translate] don't call glRotatef() and
+ * friends, but post-multiply the pending matrix on the CPU.
+ * right before an object that might use the modelview matrix is rendered,
+ * the pending matrix is applied with a single glMultMatrixf()
+ * (GemBase takes care of that).
+ * nothing is ever read back from openGL.
+ *
+ * there is only one pending matrix, since the render-chains are traversed
+ * one after the other (and they all share the same openGL matrix stack)
+ */
+class GEM_EXTERN ModelView
+{
+public:
+  /* get the pending matrix, to post-multiply a transformation;
+   * returns NULL if deferring is disabled, in which case the caller
+   * has to apply the transformation to openGL directly
+   */
+  static Matrix*defer(void);
+
+  /* apply the pending transformation to the current openGL matrix */
+  static inline bool flush(void)
+  {
+    return (s_pending && apply());
+  }
+
+  /* forget the pending transformation
+   * (e.g. because the openGL matrix is about to be popped anyhow)
+   */
+  static void discard(void);
+
+  /* whether transformations are deferred at all (default: yes) */
+  static void setEnabled(bool enabled);
+  static bool isEnabled(void);
+
+private:
+  static bool apply(void);
+  static bool s_pending;
+};
+};
+
+#endif /* _INCLUDE__GEM_GEM_MODELVIEW_H_ */
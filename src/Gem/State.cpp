@@ -21,6 +21,7 @@
 /* for GemMan::StackIDs */
 #include "Gem/Manager.h"
 #include "Gem/GLStack.h"
+#include "Gem/VertexPipeline.h"
 
 #include <map>
 #include <memory>
@@ -53,7 +54,10 @@ class GemStateData
 {
   friend class GemState;
 public:
-  GemStateData(void) : stacks(new GLStack()) {}
+  GemStateData(void)
+    : stacks(new GLStack())
+    , vertexops(new vertex::Pipeline())
+  {}
 
   ~GemStateData(void)
   {
@@ -78,6 +82,7 @@ protected:
   std::map <GemState::key_t, any> data;
 
   std::auto_ptr<GLStack>stacks;
+  std::auto_ptr<vertex::Pipeline>vertexops;
 
   static std::map <std::string, int> keys;
 };
@@ -125,6 +130,7 @@ GemState :: GemState()
   set(_GL_DRAWTYPE, (drawType=0));
 
   set(_GL_STACKS, data->stacks.get());
+  set(_VERTEX_PIPELINE, data->vertexops.get());
 
   /*
     set("vertex.array.vertex", 0);
@@ -213,6 +219,12 @@ void GemState :: reset()
   set(GemState::_PIX, (image=0));
   set(GemState::_GL_TEX_NUMCOORDS, (numTexCoords=0));
 
+  vertex::Pipeline*vertexops=NULL;
+  get(GemState::_VERTEX_PIPELINE, vertexops);
+  if(vertexops) {
+    vertexops->clear();
+  }
+
 }
 
 GemState :: ~GemState()
@@ -384,6 +396,8 @@ const GemState::key_t GemState::getKey(const std::string&s)
     GemStateData::keys["gl.tex.units"]=_GL_TEX_UNITS;
     GemStateData::keys["gl.tex.orientation"]=_GL_TEX_ORIENTATION;
     GemStateData::keys["gl.tex.basecoord"]=_GL_TEX_BASECOORD;
+    GemStateData::keys["vertex.pipeline"]=_VERTEX_PIPELINE;
+    GemStateData::keys["gl.instances"]=_GL_INSTANCES;
   }
 
   key_t result=_ILLEGAL;
@@ -74,6 +74,8 @@ public:
     _GL_TEX_UNITS,       /* "tex.units" <int> # of texUnits */
     _GL_TEX_ORIENTATION, /* "tex.orientation" <bool> false=bottomleft; true=topleft */
     _GL_TEX_BASECOORD,   /* "tex.basecoords" <TexCoord> width/height of texture  */
+    _VERTEX_PIPELINE,    /* "vertex.pipeline" <gem::vertex::Pipeline*> pending vertex-operations */
+    _GL_INSTANCES,       /* "gl.instances" <gem::Instances*> draw the geometry once per instance */
 
 
 
@@ -0,0 +1,377 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "VertexPipeline.h"
+#include "Gem/State.h"
+#include "Utils/SIMD.h"
+#include "Utils/ThreadPool.h"
+
+#ifdef __GNUC__
+# pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+namespace
+{
+typedef gem::vertex::Pipeline::Op Op;
+
+/* the number of elements that are run through all operations at once
+ * (4K of data per array, so it stays in the L1 cache) */
+const unsigned int BLOCKSIZE=256;
+/* don't bother spawning threads for less elements than this */
+const unsigned int MINSLICE=4096;
+
+void applyParam(gem::vertex::Pipeline::Operation op, float*a,
+                unsigned int n, const float*p)
+{
+  unsigned int i;
+  switch(op) {
+  case gem::vertex::Pipeline::SCALE:
+    for(i=0; i<n; i++, a+=4) {
+      a[0]*=p[0];
+      a[1]*=p[1];
+      a[2]*=p[2];
+      a[3]*=p[3];
+    }
+    break;
+  case gem::vertex::Pipeline::OFFSET:
+    for(i=0; i<n; i++, a+=4) {
+      a[0]+=p[0];
+      a[1]+=p[1];
+      a[2]+=p[2];
+      a[3]+=p[3];
+    }
+    break;
+  case gem::vertex::Pipeline::SET:
+    for(i=0; i<n; i++, a+=4) {
+      a[0]=p[0];
+      a[1]=p[1];
+      a[2]=p[2];
+      a[3]=p[3];
+    }
+    break;
+  default:
+    break;
+  }
+}
+void applyArray(gem::vertex::Pipeline::Operation op, float*a,
+                unsigned int n, const float*r)
+{
+  unsigned int i;
+  if(gem::vertex::Pipeline::MUL == op) {
+    for(i=0; i<n; i++, a+=4, r+=4) {
+      a[0]*=r[0];
+      a[1]*=r[1];
+      a[2]*=r[2];
+      a[3]*=r[3];
+    }
+  } else {
+    for(i=0; i<n; i++, a+=4, r+=4) {
+      a[0]+=r[0];
+      a[1]+=r[1];
+      a[2]+=r[2];
+      a[3]+=r[3];
+    }
+  }
+}
+/* nearest neighbour resampling of the right-hand array
+ * (this is only ever used if the arrays differ in size) */
+void applyResampled(const Op&op, unsigned int lo, unsigned int hi)
+{
+  const float inc=static_cast<float>(op.rsize)/static_cast<float>(op.count);
+  const unsigned int last=4*(op.rsize-1);
+  float*a=op.array+4*lo;
+  for(unsigned int i=lo; i<hi; i++, a+=4) {
+    unsigned int J;
+    if(gem::vertex::Pipeline::MUL == op.op) {
+      /* [vertex_mul] has always resampled with float (not element) granularity */
+      J=static_cast<unsigned int>(4.f*static_cast<float>(i)*inc);
+    } else {
+      J=4*static_cast<unsigned int>(static_cast<float>(i)*inc);
+    }
+    if(J>last) {
+      J=last;
+    }
+    const float*r=op.rhs+J;
+    if(gem::vertex::Pipeline::MUL == op.op) {
+      a[0]*=r[0];
+      a[1]*=r[1];
+      a[2]*=r[2];
+      a[3]*=r[3];
+    } else {
+      a[0]+=r[0];
+      a[1]+=r[1];
+      a[2]+=r[2];
+      a[3]+=r[3];
+    }
+  }
+}
+
+#ifdef __SSE2__
+void applyParamSSE2(gem::vertex::Pipeline::Operation op, float*a,
+                    unsigned int n, const float*p)
+{
+  const __m128 P=_mm_loadu_ps(p);
+  unsigned int i;
+  switch(op) {
+  case gem::vertex::Pipeline::SCALE:
+    for(i=0; i<n; i++, a+=4) {
+      _mm_storeu_ps(a, _mm_mul_ps(_mm_loadu_ps(a), P));
+    }
+    break;
+  case gem::vertex::Pipeline::OFFSET:
+    for(i=0; i<n; i++, a+=4) {
+      _mm_storeu_ps(a, _mm_add_ps(_mm_loadu_ps(a), P));
+    }
+    break;
+  case gem::vertex::Pipeline::SET:
+    for(i=0; i<n; i++, a+=4) {
+      _mm_storeu_ps(a, P);
+    }
+    break;
+  default:
+    break;
+  }
+}
+void applyArraySSE2(gem::vertex::Pipeline::Operation op, float*a,
+                    unsigned int n, const float*r)
+{
+  unsigned int i;
+  if(gem::vertex::Pipeline::MUL == op) {
+    for(i=0; i<n; i++, a+=4, r+=4) {
+      _mm_storeu_ps(a, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(r)));
+    }
+  } else {
+    for(i=0; i<n; i++, a+=4, r+=4) {
+      _mm_storeu_ps(a, _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(r)));
+    }
+  }
+}
+#endif /* __SSE2__ */
+
+/* apply 'op' to those of the elements [lo, hi[ that it covers */
+void apply(const Op&op, unsigned int lo, unsigned int hi, bool simd)
+{
+  if(lo<op.start) {
+    lo=op.start;
+  }
+  if(hi>op.start+op.count) {
+    hi=op.start+op.count;
+  }
+  if(lo>=hi) {
+    return;
+  }
+  float*a=op.array+4*lo;
+  const unsigned int n=hi-lo;
+
+  switch(op.op) {
+  case gem::vertex::Pipeline::SCALE:
+  case gem::vertex::Pipeline::OFFSET:
+  case gem::vertex::Pipeline::SET:
+#ifdef __SSE2__
+    if(simd) {
+      applyParamSSE2(op.op, a, n, op.param);
+      break;
+    }
+#endif
+    applyParam(op.op, a, n, op.param);
+    break;
+  case gem::vertex::Pipeline::ADD:
+  case gem::vertex::Pipeline::MUL:
+    if(op.rsize!=op.count) {
+      applyResampled(op, lo, hi);
+      break;
+    }
+#ifdef __SSE2__
+    if(simd) {
+      applyArraySSE2(op.op, a, n, op.rhs+4*lo);
+      break;
+    }
+#endif
+    applyArray(op.op, a, n, op.rhs+4*lo);
+    break;
+  }
+}
+
+class FlushJob : public gem::thread::ThreadPool::Job
+{
+public:
+  const std::vector<Op>&ops;
+  unsigned int size;
+  bool simd;
+  FlushJob(const std::vector<Op>&o, unsigned int s, bool sse)
+    : ops(o), size(s), simd(sse)
+  { }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    unsigned int start, stop;
+    gem::thread::ThreadPool::getSlice(slice, numSlices, size, start, stop,
+                                      BLOCKSIZE);
+    for(unsigned int lo=start; lo<stop; lo+=BLOCKSIZE) {
+      const unsigned int hi=(lo+BLOCKSIZE<stop)?(lo+BLOCKSIZE):stop;
+      for(unsigned int i=0; i<ops.size(); i++) {
+        apply(ops[i], lo, hi, simd);
+      }
+    }
+  }
+};
+
+/*
+ * an operation that reads from an array that is written by the pipeline
+ * (at another index than its own) must see the results of all
+ * previous operations on all elements: it cannot be fused
+ */
+bool needsSequential(const std::vector<Op>&ops)
+{
+  for(unsigned int i=0; i<ops.size(); i++) {
+    const Op&op=ops[i];
+    if(!op.rhs) {
+      continue;
+    }
+    const float*r0=op.rhs;
+    const float*r1=op.rhs+4*op.rsize;
+    for(unsigned int j=0; j<ops.size(); j++) {
+      const Op&other=ops[j];
+      if(other.array==op.rhs && op.rsize==op.count) {
+        /* element-wise in-place is fine */
+        continue;
+      }
+      const float*a0=other.array+4*other.start;
+      const float*a1=other.array+4*(other.start+other.count);
+      if(r0<a1 && a0<r1) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+};
+
+namespace gem
+{
+namespace vertex
+{
+
+Pipeline::Pipeline(void)
+{
+}
+Pipeline::~Pipeline(void)
+{
+}
+
+void Pipeline::add(Operation op, float*array,
+                   unsigned int start, unsigned int count, const float param[4])
+{
+  if(!array || !count) {
+    return;
+  }
+  Op o;
+  o.op=op;
+  o.array=array;
+  o.start=start;
+  o.count=count;
+  for(unsigned int i=0; i<4; i++) {
+    o.param[i]=param[i];
+  }
+  o.rhs=0;
+  o.rsize=0;
+  m_ops.push_back(o);
+}
+void Pipeline::add(Operation op, float*array, unsigned int size,
+                   const float*rhs, unsigned int rsize)
+{
+  if(!array || !size || !rhs || !rsize) {
+    return;
+  }
+  Op o;
+  o.op=op;
+  o.array=array;
+  o.start=0;
+  o.count=size;
+  o.param[0]=o.param[1]=o.param[2]=o.param[3]=0.f;
+  o.rhs=rhs;
+  o.rsize=rsize;
+  m_ops.push_back(o);
+}
+
+bool Pipeline::empty(void) const
+{
+  return m_ops.empty();
+}
+void Pipeline::clear(void)
+{
+  m_ops.clear();
+}
+
+bool Pipeline::flush(gem::thread::ThreadPool*pool)
+{
+  if(m_ops.empty()) {
+    return false;
+  }
+  bool simd=false;
+#ifdef __SSE2__
+  simd=(GEM_SIMD_SSE2 == GemSIMD::getCPU());
+#endif
+
+  if(needsSequential(m_ops)) {
+    /* one full pass per operation, just like the objects used to do */
+    for(unsigned int i=0; i<m_ops.size(); i++) {
+      const Op&op=m_ops[i];
+      apply(op, op.start, op.start+op.count, simd);
+    }
+    m_ops.clear();
+    return true;
+  }
+
+  unsigned int size=0;
+  for(unsigned int i=0; i<m_ops.size(); i++) {
+    const unsigned int stop=m_ops[i].start+m_ops[i].count;
+    if(stop>size) {
+      size=stop;
+    }
+  }
+
+  FlushJob job(m_ops, size, simd);
+  unsigned int numSlices=pool?pool->getThreads():1;
+  if(numSlices>size/MINSLICE) {
+    numSlices=size/MINSLICE;
+  }
+  if(numSlices<2) {
+    job.process(0, 1);
+  } else {
+    pool->run(job, numSlices);
+  }
+  m_ops.clear();
+  return true;
+}
+
+Pipeline*Pipeline::get(GemState*state)
+{
+  Pipeline*pipeline=0;
+  if(state) {
+    state->get(GemState::_VERTEX_PIPELINE, pipeline);
+  }
+  return pipeline;
+}
+bool Pipeline::flush(GemState*state, gem::thread::ThreadPool*pool)
+{
+  Pipeline*pipeline=get(state);
+  if(!pipeline || !pipeline->flush(pool)) {
+    return false;
+  }
+  state->VertexDirty=true;
+  return true;
+}
+
+};
+};
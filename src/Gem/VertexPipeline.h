@@ -0,0 +1,106 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    VertexPipeline.h
+       - deferred operations on the vertex-arrays of a render-chain
+       - part of GEM
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_GEM_VERTEXPIPELINE_H_
+#define _INCLUDE__GEM_GEM_VERTEXPIPELINE_H_
+
+#include "Gem/ExportDef.h"
+#include <vector>
+
+class GemState;
+
+namespace gem
+{
+namespace thread
+{
+class ThreadPool;
+};
+namespace vertex
+{
+/**
+ * a list of pending operations on (4-component) vertex-arrays
+ *
+ * objects like [vertex_scale] don't touch the arrays themselves,
+ * but append their operation to the pipeline of the GemState.
+ * whoever needs the actual data (e.g. [vertex_draw]) calls flush(),
+ * which applies all pending operations in a single pass over the arrays
+ * (in blocks that stay in the cache, possibly split across threads)
+ *
+ * the arrays are referenced by pointer, so they must stay valid until
+ * the pipeline is flushed (or cleared)
+ */
+class GEM_EXTERN Pipeline
+{
+public:
+  enum Operation {
+    SCALE,  /* array *= param */
+    OFFSET, /* array += param */
+    SET,    /* array  = param */
+    ADD,    /* array += rhs */
+    MUL     /* array *= rhs */
+  };
+
+  Pipeline(void);
+  virtual ~Pipeline(void);
+
+  /*
+   * record a SCALE/OFFSET/SET of the elements [start, start+count[
+   * of 'array' with the 4 values in 'param'
+   */
+  void add(Operation op, float*array,
+           unsigned int start, unsigned int count, const float param[4]);
+  /*
+   * record an ADD/MUL of the 'size' elements of 'array' with 'rhs'
+   * if 'rsize' differs from 'size', 'rhs' is resampled (nearest neighbour)
+   */
+  void add(Operation op, float*array, unsigned int size,
+           const float*rhs, unsigned int rsize);
+
+  bool empty(void) const;
+  /* drop all pending operations */
+  void clear(void);
+  /*
+   * apply (and remove) all pending operations
+   * returns false if there was nothing to do
+   */
+  bool flush(gem::thread::ThreadPool*pool=0);
+
+  /* the pipeline of a render-chain (or NULL) */
+  static Pipeline*get(GemState*state);
+  /*
+   * flush the pipeline of 'state' (if any)
+   * and mark the vertex-data as dirty if it was changed
+   */
+  static bool flush(GemState*state, gem::thread::ThreadPool*pool=0);
+
+  struct Op {
+    Operation op;
+    float*array;
+    unsigned int start, count;
+    float param[4];
+    const float*rhs;
+    unsigned int rsize;
+  };
+
+private:
+  std::vector<Op>m_ops;
+
+  // noncopyable
+  Pipeline(const Pipeline&);
+  Pipeline&operator=(const Pipeline&);
+};
+};
+};
+
+#endif /* _INCLUDE__GEM_GEM_VERTEXPIPELINE_H_ */
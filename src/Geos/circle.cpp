@@ -19,6 +19,7 @@
 #include <math.h>
 
 #include "Gem/State.h"
+#include "Gem/Mesh.h"
 
 #define NUM_PNTS 100
 GLfloat *circle::m_cos = NULL;
@@ -48,17 +49,16 @@ circle :: ~circle()
 { }
 
 /////////////////////////////////////////////////////////
-// renderShape
+// buildMesh
 //
 /////////////////////////////////////////////////////////
-void circle :: renderShape(GemState *state)
+void circle :: buildMesh(GemState *state, gem::MeshBuilder&mesh)
 {
   if(m_drawType==GL_DEFAULT_GEM) {
     m_drawType=GL_POLYGON;
   }
-  glNormal3f(0.0f, 0.0f, 1.0f);
-  glLineWidth(m_linewidth);
-  glBegin(m_drawType);
+  mesh.normal(0.0f, 0.0f, 1.0f);
+  mesh.begin(m_drawType);
   if (GemShape::m_texType) {
     GLfloat xsize0 = 0.f;
     GLfloat xsize  = 1.f;
@@ -71,20 +71,16 @@ void circle :: renderShape(GemState *state)
       ysize  = GemShape::m_texCoords[1].t;
     }
     for (int n = 0; n < NUM_PNTS; n++) {
-      glTexCoord2f((xsize-xsize0)*(m_cos[n] + 1) / 2.f+xsize0,
-                   (ysize0-ysize)*(m_sin[n] + 1) / 2.f+ysize);
-      glVertex3f(m_cos[n] * m_size,
-                 m_sin[n] * m_size,
-                 0.0);
+      mesh.texcoord((xsize-xsize0)*(m_cos[n] + 1) / 2.f+xsize0,
+                    (ysize0-ysize)*(m_sin[n] + 1) / 2.f+ysize);
+      mesh.vertex(m_cos[n], m_sin[n]);
     }
   } else {
-    for (int n = 0; n < NUM_PNTS; n++)
-      glVertex3f(m_cos[n] * m_size,
-                 m_sin[n] * m_size,
-                 0.0);
+    for (int n = 0; n < NUM_PNTS; n++) {
+      mesh.vertex(m_cos[n], m_sin[n]);
+    }
   }
-  glEnd();
-  glLineWidth(1.0);
+  mesh.end();
 }
 
 /////////////////////////////////////////////////////////
@@ -47,8 +47,8 @@ protected:
   virtual ~circle();
 
   //////////
-  // Do the renderShapeing
-  virtual void    renderShape(GemState *state);
+  // Describe the geometry
+  virtual void    buildMesh(GemState *state, gem::MeshBuilder&mesh);
 
   //////////
   // cos lookup table
@@ -16,6 +16,7 @@
 
 #include "cube.h"
 #include "Gem/State.h"
+#include "Gem/Mesh.h"
 
 CPPEXTERN_NEW_WITH_ONE_ARG(cube, t_floatarg, A_DEFFLOAT);
 
@@ -39,10 +40,10 @@ cube :: ~cube()
 { }
 
 /////////////////////////////////////////////////////////
-// renderShape
+// buildMesh
 //
 /////////////////////////////////////////////////////////
-void cube :: renderShape(GemState *state)
+void cube :: buildMesh(GemState *state, gem::MeshBuilder&mesh)
 {
   if(m_drawType==GL_DEFAULT_GEM) {
     m_drawType=GL_QUADS;
@@ -61,76 +62,39 @@ void cube :: renderShape(GemState *state)
   };
   if (m_drawType == GL_LINE_LOOP) {
     for (int i = 0; i < 6; i++) {
-      glBegin(m_drawType);
-      glNormal3f(0.0f, 0.0f, 1.0f);
-      glVertex3d(v[faces[i][0]][0] * m_size, v[faces[i][0]][1] * m_size,
-                 v[faces[i][0]][2] * m_size);
-      glVertex3d(v[faces[i][1]][0] * m_size, v[faces[i][1]][1] * m_size,
-                 v[faces[i][1]][2] * m_size);
-      glVertex3d(v[faces[i][2]][0] * m_size, v[faces[i][2]][1] * m_size,
-                 v[faces[i][2]][2] * m_size);
-      glVertex3d(v[faces[i][3]][0] * m_size, v[faces[i][3]][1] * m_size,
-                 v[faces[i][3]][2] * m_size);
-      glEnd();
+      mesh.begin(m_drawType);
+      mesh.normal(0.0f, 0.0f, 1.0f);
+      for (int j = 0; j < 4; j++) {
+        mesh.vertex(v[faces[i][j]][0], v[faces[i][j]][1], v[faces[i][j]][2]);
+      }
+      mesh.end();
     }
-    glLineWidth(1.0);
   } else if (GemShape::m_texType && GemShape::m_texNum) {
-    glBegin(m_drawType);
+    mesh.begin(m_drawType);
     for (int i = 0; i < 6; i++) {
-      int curCoord = 0;
-      glNormal3fv(&n[i][0]);
-      glTexCoord2f(GemShape::m_texCoords[curCoord].s,
-                   GemShape::m_texCoords[curCoord].t);
-      //              glTexCoord2f(0.0, 0.0);
-      glVertex3f(v[faces[i][0]][0] * m_size, v[faces[i][0]][1] * m_size,
-                 v[faces[i][0]][2] * m_size);
-
-      if (GemShape::m_texNum > 1) {
-        curCoord = 1;
-      }
-      glTexCoord2f(GemShape::m_texCoords[curCoord].s,
-                   GemShape::m_texCoords[curCoord].t);
-      //              glTexCoord2f(1.0, 0.0);
-      glVertex3f(v[faces[i][1]][0] * m_size, v[faces[i][1]][1] * m_size,
-                 v[faces[i][1]][2] * m_size);
-
-      if (GemShape::m_texNum > 2) {
-        curCoord = 2;
+      mesh.normal(n[i][0], n[i][1], n[i][2]);
+      for (int j = 0; j < 4; j++) {
+        // glTexCoord2f(0.0, 0.0), (1.0, 0.0), (1.0, 1.0), (0.0, 1.0);
+        int curCoord = (j < GemShape::m_texNum)?j:(GemShape::m_texNum - 1);
+        mesh.texcoord(GemShape::m_texCoords[curCoord].s,
+                      GemShape::m_texCoords[curCoord].t);
+        mesh.vertex(v[faces[i][j]][0], v[faces[i][j]][1], v[faces[i][j]][2]);
       }
-      glTexCoord2f(GemShape::m_texCoords[curCoord].s,
-                   GemShape::m_texCoords[curCoord].t);
-      //              glTexCoord2f(1.0, 1.0);
-      glVertex3f(v[faces[i][2]][0] * m_size, v[faces[i][2]][1] * m_size,
-                 v[faces[i][2]][2] * m_size);
-
-      if (GemShape::m_texNum > 3) {
-        curCoord = 3;
-      }
-      glTexCoord2f(GemShape::m_texCoords[curCoord].s,
-                   GemShape::m_texCoords[curCoord].t);
-      //              glTexCoord2f(0.0, 1.0);
-      glVertex3f(v[faces[i][3]][0] * m_size, v[faces[i][3]][1] * m_size,
-                 v[faces[i][3]][2] * m_size);
     }
-    glEnd();
+    mesh.end();
   } else {
-    glBegin(m_drawType);
+    static GLfloat t[4][2] = {
+      {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}
+    };
+    mesh.begin(m_drawType);
     for (int i = 0; i < 6; i++) {
-      glNormal3fv(&n[i][0]);
-      glTexCoord2f(0.0, 0.0);
-      glVertex3f(v[faces[i][0]][0] * m_size, v[faces[i][0]][1] * m_size,
-                 v[faces[i][0]][2] * m_size);
-      glTexCoord2f(1.0, 0.0);
-      glVertex3f(v[faces[i][1]][0] * m_size, v[faces[i][1]][1] * m_size,
-                 v[faces[i][1]][2] * m_size);
-      glTexCoord2f(1.0, 1.0);
-      glVertex3f(v[faces[i][2]][0] * m_size, v[faces[i][2]][1] * m_size,
-                 v[faces[i][2]][2] * m_size);
-      glTexCoord2f(0.0, 1.0);
-      glVertex3f(v[faces[i][3]][0] * m_size, v[faces[i][3]][1] * m_size,
-                 v[faces[i][3]][2] * m_size);
+      mesh.normal(n[i][0], n[i][1], n[i][2]);
+      for (int j = 0; j < 4; j++) {
+        mesh.texcoord(t[j][0], t[j][1]);
+        mesh.vertex(v[faces[i][j]][0], v[faces[i][j]][1], v[faces[i][j]][2]);
+      }
     }
-    glEnd();
+    mesh.end();
   }
 }
 
@@ -48,8 +48,8 @@ protected:
   virtual ~cube();
 
   //////////
-  // Do the renderShapeing
-  virtual void    renderShape(GemState *state);
+  // Describe the geometry
+  virtual void    buildMesh(GemState *state, gem::MeshBuilder&mesh);
 };
 
 #endif  // for header file
@@ -20,6 +20,7 @@
 
 #include "cuboid.h"
 #include "Gem/State.h"
+#include "Gem/Mesh.h"
 #include <string.h>
 
 CPPEXTERN_NEW_WITH_THREE_ARGS(cuboid, t_floatarg, A_DEFFLOAT, t_floatarg,
@@ -60,15 +61,14 @@ cuboid :: ~cuboid(void)
 }
 
 /////////////////////////////////////////////////////////
-// renderShape
+// buildMesh
 //
 /////////////////////////////////////////////////////////
-void cuboid :: renderShape(GemState *state)
+void cuboid :: buildMesh(GemState *state, gem::MeshBuilder&mesh)
 {
   if(m_drawType==GL_DEFAULT_GEM) {
     m_drawType=GL_QUADS;
   }
-
   static GLfloat n[6][3] = {
     { 0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f,  0.0f, -1.0f},
     {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, -1.0f,  0.0f}
@@ -83,78 +83,52 @@ void cuboid :: renderShape(GemState *state)
   };
   if (m_drawType == GL_LINE_LOOP) {
     for (int i = 0; i < 6; i++) {
-      glBegin(m_drawType);
-      glNormal3f(0.0f, 0.0f, 1.0f);
-      glVertex3d(v[faces[i][0]][0] * m_size, v[faces[i][0]][1] * m_sizey,
-                 v[faces[i][0]][2] * m_sizez);
-      glVertex3d(v[faces[i][1]][0] * m_size, v[faces[i][1]][1] * m_sizey,
-                 v[faces[i][1]][2] * m_sizez);
-      glVertex3d(v[faces[i][2]][0] * m_size, v[faces[i][2]][1] * m_sizey,
-                 v[faces[i][2]][2] * m_sizez);
-      glVertex3d(v[faces[i][3]][0] * m_size, v[faces[i][3]][1] * m_sizey,
-                 v[faces[i][3]][2] * m_sizez);
-      glEnd();
+      mesh.begin(m_drawType);
+      mesh.normal(0.0f, 0.0f, 1.0f);
+      for (int j = 0; j < 4; j++) {
+        mesh.vertex(v[faces[i][j]][0], v[faces[i][j]][1], v[faces[i][j]][2]);
+      }
+      mesh.end();
     }
-    glLineWidth(1.0);
   } else if (GemShape::m_texType && GemShape::m_texNum) {
-    glBegin(m_drawType);
+    mesh.begin(m_drawType);
     for (int i = 0; i < 6; i++) {
-      int curCoord = 0;
-      glNormal3fv(&n[i][0]);
-      glTexCoord2f(GemShape::m_texCoords[curCoord].s,
-                   GemShape::m_texCoords[curCoord].t);
-      //              glTexCoord2f(0.0, 0.0);
-      glVertex3f(v[faces[i][0]][0] * m_size, v[faces[i][0]][1] * m_sizey,
-                 v[faces[i][0]][2] * m_sizez);
-
-      if (GemShape::m_texNum > 1) {
-        curCoord = 1;
-      }
-      glTexCoord2f(GemShape::m_texCoords[curCoord].s,
-                   GemShape::m_texCoords[curCoord].t);
-      //              glTexCoord2f(1.0, 0.0);
-      glVertex3f(v[faces[i][1]][0] * m_size, v[faces[i][1]][1] * m_sizey,
-                 v[faces[i][1]][2] * m_sizez);
-
-      if (GemShape::m_texNum > 2) {
-        curCoord = 2;
-      }
-      glTexCoord2f(GemShape::m_texCoords[curCoord].s,
-                   GemShape::m_texCoords[curCoord].t);
-      //              glTexCoord2f(1.0, 1.0);
-      glVertex3f(v[faces[i][2]][0] * m_size, v[faces[i][2]][1] * m_sizey,
-                 v[faces[i][2]][2] * m_sizez);
-
-      if (GemShape::m_texNum > 3) {
-        curCoord = 3;
+      mesh.normal(n[i][0], n[i][1], n[i][2]);
+      for (int j = 0; j < 4; j++) {
+        // glTexCoord2f(0.0, 0.0), (1.0, 0.0), (1.0, 1.0), (0.0, 1.0);
+        int curCoord = (j < GemShape::m_texNum)?j:(GemShape::m_texNum - 1);
+        mesh.texcoord(GemShape::m_texCoords[curCoord].s,
+                      GemShape::m_texCoords[curCoord].t);
+        mesh.vertex(v[faces[i][j]][0], v[faces[i][j]][1], v[faces[i][j]][2]);
       }
-      glTexCoord2f(GemShape::m_texCoords[curCoord].s,
-                   GemShape::m_texCoords[curCoord].t);
-      //              glTexCoord2f(0.0, 1.0);
-      glVertex3f(v[faces[i][3]][0] * m_size, v[faces[i][3]][1] * m_sizey,
-                 v[faces[i][3]][2] * m_sizez);
     }
-    glEnd();
+    mesh.end();
   } else {
-    glBegin(m_drawType);
+    static GLfloat t[4][2] = {
+      {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}
+    };
+    mesh.begin(m_drawType);
     for (int i = 0; i < 6; i++) {
-      glNormal3fv(&n[i][0]);
-      glTexCoord2f(0.0, 0.0);
-      glVertex3f(v[faces[i][0]][0] * m_size, v[faces[i][0]][1] * m_sizey,
-                 v[faces[i][0]][2] * m_sizez);
-      glTexCoord2f(1.0, 0.0);
-      glVertex3f(v[faces[i][1]][0] * m_size, v[faces[i][1]][1] * m_sizey,
-                 v[faces[i][1]][2] * m_sizez);
-      glTexCoord2f(1.0, 1.0);
-      glVertex3f(v[faces[i][2]][0] * m_size, v[faces[i][2]][1] * m_sizey,
-                 v[faces[i][2]][2] * m_sizez);
-      glTexCoord2f(0.0, 1.0);
-      glVertex3f(v[faces[i][3]][0] * m_size, v[faces[i][3]][1] * m_sizey,
-                 v[faces[i][3]][2] * m_sizez);
+      mesh.normal(n[i][0], n[i][1], n[i][2]);
+      for (int j = 0; j < 4; j++) {
+        mesh.texcoord(t[j][0], t[j][1]);
+        mesh.vertex(v[faces[i][j]][0], v[faces[i][j]][1], v[faces[i][j]][2]);
+      }
     }
-    glEnd();
+    mesh.end();
   }
 }
+
+/////////////////////////////////////////////////////////
+// meshScale
+//
+/////////////////////////////////////////////////////////
+void cuboid :: meshScale(float&x, float&y, float&z)
+{
+  x = m_size;
+  y = m_sizey;
+  z = m_sizez;
+}
 /////////////////////////////////////////////////////////
 // heightMess
 //
@@ -54,8 +54,9 @@ protected:
   void          widthMess(float sizez);
 
   //////////
-  // Do the rendering
-  virtual void  renderShape(GemState *state);
+  // Describe the geometry (a unit cube)
+  virtual void  buildMesh(GemState *state, gem::MeshBuilder&mesh);
+  virtual void  meshScale(float&x, float&y, float&z);
 
   //////////
   // The height of the object
@@ -16,12 +16,11 @@
 
 #include "cylinder.h"
 #include "Gem/State.h"
+#include "Gem/Mesh.h"
 
 CPPEXTERN_NEW_WITH_TWO_ARGS(cylinder, t_floatarg, A_DEFFLOAT, t_floatarg,
                             A_DEFFLOAT);
 
-#define normal3f glNormal3f
-
 /////////////////////////////////////////////////////////
 //
 // cylinder
@@ -52,13 +51,14 @@ cylinder :: ~cylinder()
 /////////////////////////////////////////////////////////
 void cylinder :: setupParameters(void)
 {
-  baseRadius=m_size;
-  topRadius=m_size;
-  height=m_size*2;
+  /* unit size, the geometry is scaled when drawing */
+  baseRadius=1.;
+  topRadius=1.;
+  height=2.;
   slices=m_numSlices;
   stacks=m_numSlices;
 }
-void cylinder :: renderShape(GemState *state)
+void cylinder :: buildMesh(GemState *state, gem::MeshBuilder&mesh)
 {
   setupParameters();
   if(m_drawType==GL_DEFAULT_GEM) {
@@ -75,11 +75,9 @@ void cylinder :: renderShape(GemState *state)
   TexCoord*texCoords=NULL;
   int texType=0;
   int texNum=0;
-  bool lighting=false;
   state->get(GemState::_GL_TEX_COORDS, texCoords);
   state->get(GemState::_GL_TEX_TYPE, texType);
   state->get(GemState::_GL_TEX_NUMCOORDS, texNum);
-  state->get(GemState::_GL_LIGHTING, lighting);
 
 
   GLfloat xsize = 1.0, xsize0 = 0.0;
@@ -91,8 +89,8 @@ void cylinder :: renderShape(GemState *state)
     ysize  = texCoords[2].t-ysize0;
   }
 
-  glPushMatrix();
-  glTranslatef(0.f, 0.f, -m_size);
+  /* the cylinder is centered around the origin */
+  const GLfloat z0 = -height / 2.;
 
   // gluCylinder(m_thing, m_size, m_size, m_size * 2, m_numSlices, m_numSlices);
   da = 2.0 * M_PI / slices;
@@ -102,78 +100,78 @@ void cylinder :: renderShape(GemState *state)
        height;       /* Z component of normal vectors */
 
   if (m_drawType == GL_POINT) {
-    glBegin(GL_POINTS);
+    mesh.begin(GL_POINTS);
     for (i = 0; i < slices; i++) {
       x = cos(i * da);
       y = sin(i * da);
-      normal3f(x * nsign, y * nsign, nz * nsign);
+      mesh.normal(x * nsign, y * nsign, nz * nsign);
 
-      z = 0.0;
+      z = z0;
       r = baseRadius;
       for (j = 0; j <= stacks; j++) {
-        glVertex3f(x * r, y * r, z);
+        mesh.vertex(x * r, y * r, z);
         z += dz;
         r += dr;
       }
     }
-    glEnd();
+    mesh.end();
   } else if (m_drawType == GL_LINE || m_drawType == GLU_SILHOUETTE) {
     /* Draw rings */
     if (m_drawType == GL_LINE) {
-      z = 0.0;
+      z = z0;
       r = baseRadius;
       for (j = 0; j <= stacks; j++) {
-        glBegin(GL_LINE_LOOP);
+        mesh.begin(GL_LINE_LOOP);
         for (i = 0; i < slices; i++) {
           x = cos(i * da);
           y = sin(i * da);
-          normal3f(x * nsign, y * nsign, nz * nsign);
-          glVertex3f(x * r, y * r, z);
+          mesh.normal(x * nsign, y * nsign, nz * nsign);
+          mesh.vertex(x * r, y * r, z);
         }
-        glEnd();
+        mesh.end();
         z += dz;
         r += dr;
       }
     } else {
       /* draw one ring at each end */
       if (baseRadius != 0.0) {
-        glBegin(GL_LINE_LOOP);
+        mesh.begin(GL_LINE_LOOP);
         for (i = 0; i < slices; i++) {
           x = cos(i * da);
           y = sin(i * da);
-          normal3f(x * nsign, y * nsign, nz * nsign);
-          glVertex3f(x * baseRadius, y * baseRadius, 0.0);
+          mesh.normal(x * nsign, y * nsign, nz * nsign);
+          mesh.vertex(x * baseRadius, y * baseRadius, z0);
         }
-        glEnd();
-        glBegin(GL_LINE_LOOP);
+        mesh.end();
+        mesh.begin(GL_LINE_LOOP);
         for (i = 0; i < slices; i++) {
           x = cos(i * da);
           y = sin(i * da);
-          normal3f(x * nsign, y * nsign, nz * nsign);
-          glVertex3f(x * topRadius, y * topRadius, height);
+          mesh.normal(x * nsign, y * nsign, nz * nsign);
+          mesh.vertex(x * topRadius, y * topRadius, z0 + height);
         }
-        glEnd();
+        mesh.end();
       }
     }
     /* draw length lines */
-    glBegin(GL_LINES);
+    mesh.begin(GL_LINES);
     for (i = 0; i < slices; i++) {
       x = cos(i * da);
       y = sin(i * da);
-      normal3f(x * nsign, y * nsign, nz * nsign);
-      glVertex3f(x * baseRadius, y * baseRadius, 0.0);
-      glVertex3f(x * topRadius, y * topRadius, height);
+      mesh.normal(x * nsign, y * nsign, nz * nsign);
+      mesh.vertex(x * baseRadius, y * baseRadius, z0);
+      mesh.vertex(x * topRadius, y * topRadius, z0 + height);
     }
-    glEnd();
+    mesh.end();
   } else if (m_drawType == GL_FILL) {
     GLfloat ds = 1.0 / slices;
     GLfloat dt = 1.0 / stacks;
     GLfloat t = 0.0;
-    z = 0.0;
+    z = z0;
     r = baseRadius;
     for (j = 0; j < stacks; j++) {
       GLfloat s = 0.0;
-      glBegin(GL_QUAD_STRIP);
+      mesh.begin(GL_QUAD_STRIP);
       for (i = 0; i <= slices; i++) {
         GLfloat x, y;
         if (i == slices) {
@@ -183,26 +181,25 @@ void cylinder :: renderShape(GemState *state)
           x = sin(i * da);
           y = cos(i * da);
         }
-        normal3f(x * nsign, y * nsign, nz * nsign);
+        mesh.normal(x * nsign, y * nsign, nz * nsign);
         if(texType) {
-          glTexCoord2f(s*xsize+xsize0, t*ysize+ysize0);
+          mesh.texcoord(s*xsize+xsize0, t*ysize+ysize0);
         }
-        glVertex3f(x * r, y * r, z);
-        normal3f(x * nsign, y * nsign, nz * nsign);
+        mesh.vertex(x * r, y * r, z);
+        mesh.normal(x * nsign, y * nsign, nz * nsign);
         if(texType) {
-          glTexCoord2f(s*xsize+xsize0, (t + dt)*ysize+ysize0);
+          mesh.texcoord(s*xsize+xsize0, (t + dt)*ysize+ysize0);
         }
-        glVertex3f(x * (r + dr), y * (r + dr), z + dz);
+        mesh.vertex(x * (r + dr), y * (r + dr), z + dz);
 
         s += ds;
       }                 /* for slices */
-      glEnd();
+      mesh.end();
       r += dr;
       t += dt;
       z += dz;
     }                           /* for stacks */
   }
-  glPopMatrix();
 }
 
 /////////////////////////////////////////////////////////
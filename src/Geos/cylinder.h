@@ -47,8 +47,8 @@ protected:
   virtual ~cylinder();
 
   //////////
-  // Do the rendering
-  virtual void    renderShape(GemState *state);
+  // Describe the geometry
+  virtual void    buildMesh(GemState *state, gem::MeshBuilder&mesh);
 
 
   virtual void setupParameters(void);
@@ -22,6 +22,7 @@
 
 #include "disk.h"
 #include "Gem/State.h"
+#include "Gem/Mesh.h"
 #include "Gem/Exception.h"
 
 CPPEXTERN_NEW_WITH_GIMME(disk);
@@ -83,10 +84,10 @@ void disk :: innerRadius(float radius)
 }
 
 /////////////////////////////////////////////////////////
-// render
+// buildMesh
 //
 /////////////////////////////////////////////////////////
-void disk :: renderShape(GemState *state)
+void disk :: buildMesh(GemState *state, gem::MeshBuilder&mesh)
 {
   if(m_drawType==GL_DEFAULT_GEM) {
     m_drawType=GL_FILL;
@@ -100,14 +101,13 @@ void disk :: renderShape(GemState *state)
   TexCoord*texCoords=NULL;
   int texType=0;
   int texNum=0;
-  bool lighting=false;
   state->get(GemState::_GL_TEX_COORDS, texCoords);
   state->get(GemState::_GL_TEX_TYPE, texType);
   state->get(GemState::_GL_TEX_NUMCOORDS, texNum);
-  state->get(GemState::_GL_LIGHTING, lighting);
 
-
-  GLboolean normals = (lighting);
+  /* unit size, the geometry is scaled when drawing */
+  const GLfloat size = 1.f;
+  const GLfloat inner = (m_size != 0.f)?(m_innerRadius / m_size):0.f;
 
   GLfloat xsize = 1.0, xsize0 = 0.0;
   GLfloat ysize = 1.0, ysize0 = 0.0;
@@ -123,20 +123,18 @@ void disk :: renderShape(GemState *state)
 
 
   /* Normal vectors */
-  if (normals) {
-    if (!orientation) {
-      glNormal3f(0.0, 0.0, +1.0);
-    } else {
-      glNormal3f(0.0, 0.0, -1.0);
-    }
+  if (!orientation) {
+    mesh.normal(0.0, 0.0, +1.0);
+  } else {
+    mesh.normal(0.0, 0.0, -1.0);
   }
 
   da = 2.0 * M_PI / m_numSlices;
-  dr = (m_size - m_innerRadius) / static_cast<GLfloat>(loops);
+  dr = (size - inner) / static_cast<GLfloat>(loops);
 
-  GLfloat dtc = 2.0f * m_size;
+  GLfloat dtc = 2.0f * size;
   GLfloat sa, ca;
-  GLfloat r1 = m_innerRadius;
+  GLfloat r1 = inner;
 
   switch (m_drawType) {
   default:
@@ -150,42 +148,42 @@ void disk :: renderShape(GemState *state)
       GLfloat r2 = r1 + dr;
       if (!orientation) {
         GLint s;
-        glBegin(GL_QUAD_STRIP);
+        mesh.begin(GL_QUAD_STRIP);
         for (s = 0; s <= m_numSlices; s++) {
           GLfloat a=(s == m_numSlices)?0.0:(s * da);
           sa = sin(a);
           ca = cos(a);
           if(texType) {
-            glTexCoord2f((0.5 + sa * r2 / dtc)*xsize+xsize0,
-                         (0.5 + ca * r2 / dtc)*ysize+ysize0);
+            mesh.texcoord((0.5 + sa * r2 / dtc)*xsize+xsize0,
+                          (0.5 + ca * r2 / dtc)*ysize+ysize0);
           }
-          glVertex2f(r2 * sa, r2 * ca);
+          mesh.vertex(r2 * sa, r2 * ca);
           if(texType) {
-            glTexCoord2f((0.5 + sa * r1 / dtc)*xsize+xsize0,
-                         (0.5 + ca * r1 / dtc)*ysize+ysize0);
+            mesh.texcoord((0.5 + sa * r1 / dtc)*xsize+xsize0,
+                          (0.5 + ca * r1 / dtc)*ysize+ysize0);
           }
-          glVertex2f(r1 * sa, r1 * ca);
+          mesh.vertex(r1 * sa, r1 * ca);
         }
-        glEnd();
+        mesh.end();
       } else {
         GLint s;
-        glBegin(GL_QUAD_STRIP);
+        mesh.begin(GL_QUAD_STRIP);
         for (s = m_numSlices; s >= 0; s--) {
           GLfloat a=(s==m_numSlices)?0.0:s * da;
           sa = sin(a);
           ca = cos(a);
           if(texType) {
-            glTexCoord2f((0.5 - sa * r2 / dtc)*xsize+xsize0,
-                         (0.5 + ca * r2 / dtc)*ysize+ysize0);
+            mesh.texcoord((0.5 - sa * r2 / dtc)*xsize+xsize0,
+                          (0.5 + ca * r2 / dtc)*ysize+ysize0);
           }
-          glVertex2f(r2 * sa, r2 * ca);
+          mesh.vertex(r2 * sa, r2 * ca);
           if(texType) {
-            glTexCoord2f((0.5 - sa * r1 / dtc)*xsize+xsize0,
-                         (0.5 + ca * r1 / dtc)*ysize+ysize0);
+            mesh.texcoord((0.5 - sa * r1 / dtc)*xsize+xsize0,
+                          (0.5 + ca * r1 / dtc)*ysize+ysize0);
           }
-          glVertex2f(r1 * sa, r1 * ca);
+          mesh.vertex(r1 * sa, r1 * ca);
         }
-        glEnd();
+        mesh.end();
       }
       r1 = r2;
     }
@@ -195,80 +193,90 @@ void disk :: renderShape(GemState *state)
     GLint l, s;
     /* draw loops */
     for (l = 0; l <= loops; l++) {
-      GLfloat r = m_innerRadius + l * dr;
-      glBegin(GL_LINE_LOOP);
+      GLfloat r = inner + l * dr;
+      mesh.begin(GL_LINE_LOOP);
       for (s = 0; s < m_numSlices; s++) {
         GLfloat a = s * da;
         if(texType) {
-          glTexCoord2f((0.5+r*sin(a)/dtc)*xsize+xsize0,
-                       (0.5+r*cos(a)/dtc)*ysize+ysize0);
+          mesh.texcoord((0.5+r*sin(a)/dtc)*xsize+xsize0,
+                        (0.5+r*cos(a)/dtc)*ysize+ysize0);
         }
-        glVertex2f(r * sin(a), r * cos(a));
+        mesh.vertex(r * sin(a), r * cos(a));
       }
-      glEnd();
+      mesh.end();
     }
     /* draw spokes */
     for (s = 0; s < m_numSlices; s++) {
       GLfloat a = s * da;
       GLfloat x = sin(a);
       GLfloat y = cos(a);
-      glBegin(GL_LINE_STRIP);
+      mesh.begin(GL_LINE_STRIP);
       for (l = 0; l <= loops; l++) {
-        GLfloat r = m_innerRadius + l * dr;
+        GLfloat r = inner + l * dr;
         if(texType) {
-          glTexCoord2f((0.5+r*x/dtc)*xsize+xsize0, (0.5+r*y/dtc)*ysize+ysize0);
+          mesh.texcoord((0.5+r*x/dtc)*xsize+xsize0, (0.5+r*y/dtc)*ysize+ysize0);
         }
-        glVertex2f(r * x, r * y);
+        mesh.vertex(r * x, r * y);
       }
-      glEnd();
+      mesh.end();
     }
     break;
   }
   case GL_POINT: {
     GLint s;
-    glBegin(GL_POINTS);
+    mesh.begin(GL_POINTS);
     for (s = 0; s < m_numSlices; s++) {
       GLfloat a = s * da;
       GLfloat x = sin(a);
       GLfloat y = cos(a);
       GLint l;
       for (l = 0; l <= loops; l++) {
-        GLfloat r = m_innerRadius * l * dr;
-        glVertex2f(r * x, r * y);
+        GLfloat r = inner * l * dr;
+        mesh.vertex(r * x, r * y);
         if(texType) {
-          glTexCoord2f((0.5+r*x/dtc)*xsize+xsize0, (0.5+r*y/dtc)*ysize+ysize0);
+          mesh.texcoord((0.5+r*x/dtc)*xsize+xsize0, (0.5+r*y/dtc)*ysize+ysize0);
         }
       }
     }
-    glEnd();
+    mesh.end();
     break;
   }
   case GLU_SILHOUETTE: {
-    if (m_innerRadius != 0.0) {
+    if (inner != 0.0) {
       GLfloat a;
-      glBegin(GL_LINE_LOOP);
+      mesh.begin(GL_LINE_LOOP);
       for (a = 0.0; a < 2.0 * M_PI; a += da) {
-        GLfloat x = m_innerRadius * sin(a);
-        GLfloat y = m_innerRadius * cos(a);
-        glVertex2f(x, y);
+        GLfloat x = inner * sin(a);
+        GLfloat y = inner * cos(a);
+        mesh.vertex(x, y);
       }
-      glEnd();
+      mesh.end();
     }
     {
       GLfloat a;
-      glBegin(GL_LINE_LOOP);
+      mesh.begin(GL_LINE_LOOP);
       for (a = 0; a < 2.0 * M_PI; a += da) {
-        GLfloat x = m_size * sin(a);
-        GLfloat y = m_size * cos(a);
-        glVertex2f(x, y);
+        GLfloat x = size * sin(a);
+        GLfloat y = size * cos(a);
+        mesh.vertex(x, y);
       }
-      glEnd();
+      mesh.end();
     }
     break;
   }
   }
 }
 
+/////////////////////////////////////////////////////////
+// meshParams
+//
+/////////////////////////////////////////////////////////
+void disk :: meshParams(std::vector<float>&params)
+{
+  GemGluObj::meshParams(params);
+  params.push_back((m_size != 0.f)?(m_innerRadius / m_size):0.f);
+}
+
 /////////////////////////////////////////////////////////
 // static member functions
 //
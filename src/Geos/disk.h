@@ -53,8 +53,9 @@ protected:
   virtual ~disk(void);
 
   //////////
-  // Do the rendering
-  virtual void    renderShape(GemState *state);
+  // Describe the geometry
+  virtual void    buildMesh(GemState *state, gem::MeshBuilder&mesh);
+  virtual void    meshParams(std::vector<float>&params);
 
   //////////
   // Set the inner radius
@@ -16,6 +16,7 @@
 /////////////////////////////////////////////////////////
 
 #include "gemvertexbuffer.h"
+#include "Gem/Instances.h"
 
 #include "Utils/Functions.h"
 
@@ -129,7 +130,14 @@ void gemvertexbuffer :: renderShape(GemState *state)
     end=vbo_size;
   }
 
-  glDrawArrays(m_drawType, start, end-start);
+  gem::Instances*instances=NULL;
+  state->get(GemState::_GL_INSTANCES, instances);
+  if(instances && instances->begin()) {
+    instances->draw(m_drawType, start, end-start);
+    instances->end();
+  } else {
+    glDrawArrays(m_drawType, start, end-start);
+  }
 
   for(unsigned int i=0; i<m_attribute.size(); i++) {
     if ( m_attribute[i].enabled ) {
@@ -17,9 +17,28 @@
 
 #include "imageVert.h"
 #include "Gem/State.h"
+#include "Gem/ImageGPU.h"
 
 CPPEXTERN_NEW(imageVert);
 
+namespace
+{
+/* vertex [i][j] is the pixel in row i, column j */
+const char*s_shader =
+  "uniform vec2 size;\n"
+  "uniform float flip;\n"
+  "uniform bool colored;\n"
+  "void main(void) {\n"
+  "  vec2 pixel = gl_Vertex.yx;\n"
+  "  vec4 color = texture2DLod(displacement, (pixel + .5) / size, 0.);\n"
+  "  vec4 position = vec4(pixel.x / size.x - .5, flip * (pixel.y / size.y - .5),\n"
+  "                       color.r + color.g + color.b, 1.);\n"
+  "  gl_Position = gl_ModelViewProjectionMatrix * position;\n"
+  "  gl_TexCoord[0] = gl_TextureMatrix[0] * vec4(pixel / size, 0., 1.);\n"
+  "  gl_FrontColor = lit(colored ? color : gl_Color, vec3(0., 0., 1.), position);\n"
+  "}\n";
+};
+
 /////////////////////////////////////////////////////////
 //
 // imageVert
@@ -30,6 +49,9 @@ CPPEXTERN_NEW(imageVert);
 /////////////////////////////////////////////////////////
 imageVert :: imageVert()
   : m_rebuildList(1)
+  , m_gpu(false)
+  , m_grid("imageVert", s_shader)
+  , m_version(0)
 {
   m_dispList = 0;
 }
@@ -312,6 +334,45 @@ void imageVert :: processYUVPix(imageStruct &image, int texture)
     }
   */
 }
+/////////////////////////////////////////////////////////
+// renderGPU
+//
+/////////////////////////////////////////////////////////
+bool imageVert :: renderGPU(imageStruct &image, int texture)
+{
+  GLint internalFormat=0;
+  switch(image.format) {
+  case GL_RGBA:
+  case GL_BGRA_EXT:
+    internalFormat=GL_RGBA8;
+    break;
+  case GL_LUMINANCE:
+    /* sampled as (gray, gray, gray, 1) */
+    internalFormat=GL_LUMINANCE8;
+    break;
+  default:
+    return false;
+  }
+  if(image.xsize<2 || image.ysize<2) {
+    return false;
+  }
+  if(!m_grid.setTexture(m_version, internalFormat, image.xsize, image.ysize,
+                        image.format, image.type, image.data)) {
+    return false;
+  }
+  m_grid.setSize(image.ysize, image.xsize);
+  if(!m_grid.begin()) {
+    return false;
+  }
+  glUniform2f(m_grid.uniform("size"), image.xsize, image.ysize);
+  glUniform1f(m_grid.uniform("flip"), image.upsidedown?-1.f:1.f);
+  glUniform1i(m_grid.uniform("colored"), !texture);
+  glShadeModel(GL_SMOOTH);
+  m_grid.draw(GL_QUAD_STRIP, gem::GridMesh::STRIPS);
+  m_grid.end();
+  return true;
+}
+
 /////////////////////////////////////////////////////////
 // render
 //
@@ -323,6 +384,7 @@ void imageVert :: render(GemState *state)
   bool dl = false;
 
   state->get(GemState::_PIX, img);
+  img=gem::image::GPUFilter::hostImage(img, m_hostImage);
   state->get(GemState::_GL_TEX_TYPE, texType);
   state->get(GemState::_GL_DISPLAYLIST, dl);
 
@@ -333,6 +395,12 @@ void imageVert :: render(GemState *state)
 
   if (img->newimage) {
     m_rebuildList = 1;
+    m_version++;
+  }
+
+  // (display lists cannot hold the vertex buffers)
+  if (m_gpu && !dl && renderGPU(img->image, texType)) {
+    return;
   }
 
   if (!m_dispList) {
@@ -367,9 +435,27 @@ void imageVert :: render(GemState *state)
   }
 }
 
+void imageVert :: stopRendering(void)
+{
+  m_grid.release();
+}
+
+/////////////////////////////////////////////////////////
+// gpuMess
+//
+/////////////////////////////////////////////////////////
+void imageVert :: gpuMess(bool gpu)
+{
+  m_gpu = gpu;
+  m_rebuildList = 1;
+  setModified();
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
 /////////////////////////////////////////////////////////
-void imageVert :: obj_setupCallback(t_class *)
-{ }
+void imageVert :: obj_setupCallback(t_class *classPtr)
+{
+  CPPEXTERN_MSG1(classPtr, "gpu", gpuMess, bool);
+}
@@ -18,6 +18,8 @@ LOG
 
 #include "Base/GemPixObj.h"
 #include "Gem/GemGL.h"
+#include "Gem/DisplacedGrid.h"
+#include "Gem/Image.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -32,6 +34,10 @@ DESCRIPTION
                 still override a lot of the virtual functions...including
                 render.
 
+        "gpu" <bool> - displace a static grid in a vertex shader
+                (only the image is uploaded per frame),
+                rather than building the polygons on the CPU
+
 -----------------------------------------------------------------*/
 class GEM_EXTERN imageVert : public GemPixObj
 {
@@ -74,6 +80,12 @@ protected:
   //////////
   // Do the rendering.
   virtual void    render(GemState *state);
+  virtual void    stopRendering(void);
+
+  //////////
+  // Do the rendering on the GPU
+  // returns false if the image cannot be displaced this way
+  bool            renderGPU(imageStruct &image, int texture);
 
   //////////
   // The display list
@@ -82,6 +94,18 @@ protected:
   //////////
   // Do we need to rebuild the display list?
   int             m_rebuildList;
+
+  //////////
+  // displace the vertices on the GPU?
+  bool            m_gpu;
+  void            gpuMess(bool gpu);
+  gem::DisplacedGrid m_grid;
+  // incremented with each new image
+  unsigned int    m_version;
+
+  //////////
+  // texture-resident images are read back into here
+  pixBlock m_hostImage;
 };
 
 #endif  // for header file
@@ -17,6 +17,7 @@
 #include "model.h"
 #include "plugins/modelloader.h"
 #include "Gem/State.h"
+#include "Gem/Instances.h"
 
 #include <algorithm> // std::min
 
@@ -682,7 +683,14 @@ void model :: render(GemState *state)
 
   if ( sizeList.size() > 0 ) {
     unsigned int npoints = *std::min_element(sizeList.begin(),sizeList.end());
-    glDrawArrays(m_drawType, 0, npoints);
+    gem::Instances*instances=NULL;
+    state->get(GemState::_GL_INSTANCES, instances);
+    if(instances && instances->begin()) {
+      instances->draw(m_drawType, 0, npoints);
+      instances->end();
+    } else {
+      glDrawArrays(m_drawType, 0, npoints);
+    }
   }
 
   if ( m_position.enabled ) {
@@ -14,6 +14,9 @@
 
 #include "newWave.h"
 #include "Gem/State.h"
+#include "Utils/SIMD.h"
+
+#include <string.h>
 
 /* Grid */
 enum {WIREFRAME, HIDDENLINE, FLATSHADED, SMOOTHSHADED, TEXTURED};
@@ -33,6 +36,223 @@ static int random2(void)
   return (foo & 0x7fffffff);
 }
 
+namespace
+{
+/* runs a member function of newWave on the slices of a job */
+class SliceJob : public gem::thread::ThreadPool::Job
+{
+public:
+  typedef void (newWave::*Method)(unsigned int, unsigned int);
+  newWave*obj;
+  Method method;
+  SliceJob(newWave*o, Method m)
+    : obj(o), method(m)
+  { }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    (obj->*method)(slice, numSlices);
+  }
+};
+
+void runJob(gem::thread::ThreadPool::Job&job, unsigned int size,
+            gem::thread::ThreadPool&pool)
+{
+  unsigned int numSlices=pool.getThreads();
+  if(numSlices>size) {
+    numSlices=size;
+  }
+  if(numSlices<2) {
+    job.process(0, 1);
+    return;
+  }
+  pool.run(job, numSlices);
+}
+
+/* the spring and damping constants */
+struct WaveCoeffs {
+  float K1, K2, K3, D1, D2, D3;
+};
+
+/* the rows (i-1, i, i+1) around the masses of row i */
+struct WaveRow {
+  const float*above, *row, *below;
+  const float*oldAbove, *oldRow, *oldBelow;
+  float*force;
+};
+
+/*
+ * the force on mass [i][j], gathered from its 8 neighbours
+ * (rather than scattered along the springs, so rows are independent)
+ *  - springs to the direct (K1) and diagonal (K2) neighbours
+ *  - a spring to the rest position (K3)
+ *  - damping of the relative velocities (D1, D2) and of the velocity (D3)
+ */
+inline float waveForce(const WaveRow&r, unsigned int j, const WaveCoeffs&c)
+{
+  const float p=r.row[j];
+  const float q=p-r.oldRow[j];
+  const float lap=r.above[j]+r.below[j]+r.row[j-1]+r.row[j+1] - 4.f*p;
+  const float diag=r.above[j-1]+r.above[j+1]+r.below[j-1]+r.below[j+1] - 4.f*p;
+  const float qlap=(r.above[j]-r.oldAbove[j]) + (r.below[j]-r.oldBelow[j])
+                   + (r.row[j-1]-r.oldRow[j-1]) + (r.row[j+1]-r.oldRow[j+1])
+                   - 4.f*q;
+  const float qdiag=(r.above[j-1]-r.oldAbove[j-1])
+                    + (r.above[j+1]-r.oldAbove[j+1])
+                    + (r.below[j-1]-r.oldBelow[j-1])
+                    + (r.below[j+1]-r.oldBelow[j+1])
+                    - 4.f*q;
+  return c.K1*lap + c.K2*diag - c.K3*p
+         + c.D1*qlap + c.D2*qdiag - 2.f*c.D3*q;
+}
+
+/* normalize (x, y, z) into n[0][index], n[1][index], n[2][index] */
+inline void storeNorm(std::vector<float>*n, unsigned int index,
+                      float x, float y, float z)
+{
+  const float c=sqrt(x*x + y*y + z*z);
+  n[0][index]=x/c;
+  n[1][index]=y/c;
+  n[2][index]=z/c;
+}
+inline void addNorm(float avg[3], const std::vector<float>*n,
+                    unsigned int index)
+{
+  avg[0]+=n[0][index];
+  avg[1]+=n[1][index];
+  avg[2]+=n[2][index];
+}
+
+#ifdef __SSE2__
+/* the SIMD versions process 4 values at once, and return how many
+ * values they have processed (the rest is left to the scalar code) */
+
+unsigned int integrateSSE2(float*p, float*v, const float*f,
+                           unsigned int count)
+{
+  const __m128 lo=_mm_set1_ps(-1e20f);
+  const __m128 hi=_mm_set1_ps(1e20f);
+  unsigned int j=0;
+  for(; j+4<=count; j+=4) {
+    const __m128 vel=_mm_add_ps(_mm_loadu_ps(v+j), _mm_loadu_ps(f+j));
+    const __m128 pos=_mm_add_ps(_mm_loadu_ps(p+j), vel);
+    _mm_storeu_ps(v+j, vel);
+    _mm_storeu_ps(p+j, _mm_max_ps(lo, _mm_min_ps(hi, pos)));
+  }
+  return j;
+}
+
+/* normalize (x, y, 1) */
+inline void storeNormSSE2(std::vector<float>*n, unsigned int index,
+                          __m128 x, __m128 y)
+{
+  const __m128 one=_mm_set1_ps(1.f);
+  const __m128 len=_mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x),
+                                          _mm_mul_ps(y, y)), one));
+  const __m128 inv=_mm_div_ps(one, len);
+  _mm_storeu_ps(&n[0][index], _mm_mul_ps(x, inv));
+  _mm_storeu_ps(&n[1][index], _mm_mul_ps(y, inv));
+  _mm_storeu_ps(&n[2][index], inv);
+}
+
+unsigned int faceNormsSSE2(const float*p0, const float*p1,
+                           std::vector<float>*n0, std::vector<float>*n1,
+                           unsigned int index, unsigned int count)
+{
+  unsigned int j=0;
+  for(; j+4<=count; j+=4) {
+    const __m128 p00=_mm_loadu_ps(p0+j);
+    const __m128 p01=_mm_loadu_ps(p0+j+1);
+    const __m128 p10=_mm_loadu_ps(p1+j);
+    const __m128 p11=_mm_loadu_ps(p1+j+1);
+    storeNormSSE2(n0, index+j, _mm_sub_ps(p00, p10), _mm_sub_ps(p00, p01));
+    storeNormSSE2(n1, index+j, _mm_sub_ps(p01, p11), _mm_sub_ps(p10, p11));
+  }
+  return j;
+}
+
+/* the vertex normals of the masses that are surrounded by 6 triangles */
+unsigned int vertNormsSSE2(const std::vector<float>*n0,
+                           const std::vector<float>*n1,
+                           std::vector<float>*n,
+                           unsigned int index, unsigned int stride,
+                           unsigned int count)
+{
+  unsigned int j=0;
+  __m128 sum[3];
+  for(; j+4<=count; j+=4) {
+    const unsigned int k=index+j;
+    for(unsigned int c=0; c<3; c++) {
+      const float*f0=&n0[c][0];
+      const float*f1=&n1[c][0];
+      sum[c]=_mm_add_ps(_mm_add_ps(_mm_loadu_ps(f0+k),
+                                   _mm_loadu_ps(f0+k-stride)),
+                        _mm_add_ps(_mm_loadu_ps(f1+k-stride),
+                                   _mm_loadu_ps(f0+k-1)));
+      sum[c]=_mm_add_ps(sum[c], _mm_add_ps(_mm_loadu_ps(f1+k-1),
+                                           _mm_loadu_ps(f1+k-stride-1)));
+    }
+    const __m128 len=_mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sum[0],
+                                            sum[0]),
+                                            _mm_mul_ps(sum[1], sum[1])),
+                                            _mm_mul_ps(sum[2], sum[2])));
+    for(unsigned int c=0; c<3; c++) {
+      _mm_storeu_ps(&n[c][k], _mm_div_ps(sum[c], len));
+    }
+  }
+  return j;
+}
+
+unsigned int forcesSSE2(const WaveRow&r, unsigned int start,
+                        unsigned int count, const WaveCoeffs&c)
+{
+  const __m128 four=_mm_set1_ps(4.f);
+  const __m128 K1=_mm_set1_ps(c.K1), K2=_mm_set1_ps(c.K2);
+  const __m128 K3=_mm_set1_ps(c.K3), D1=_mm_set1_ps(c.D1);
+  const __m128 D2=_mm_set1_ps(c.D2), D3=_mm_set1_ps(2.f*c.D3);
+  unsigned int n=0;
+  for(; n+4<=count; n+=4) {
+    const unsigned int j=start+n;
+    const __m128 a_=_mm_loadu_ps(r.above+j-1);
+    const __m128 a0=_mm_loadu_ps(r.above+j);
+    const __m128 a1=_mm_loadu_ps(r.above+j+1);
+    const __m128 r_=_mm_loadu_ps(r.row+j-1);
+    const __m128 r0=_mm_loadu_ps(r.row+j);
+    const __m128 r1=_mm_loadu_ps(r.row+j+1);
+    const __m128 b_=_mm_loadu_ps(r.below+j-1);
+    const __m128 b0=_mm_loadu_ps(r.below+j);
+    const __m128 b1=_mm_loadu_ps(r.below+j+1);
+    const __m128 qa_=_mm_sub_ps(a_, _mm_loadu_ps(r.oldAbove+j-1));
+    const __m128 qa0=_mm_sub_ps(a0, _mm_loadu_ps(r.oldAbove+j));
+    const __m128 qa1=_mm_sub_ps(a1, _mm_loadu_ps(r.oldAbove+j+1));
+    const __m128 qr_=_mm_sub_ps(r_, _mm_loadu_ps(r.oldRow+j-1));
+    const __m128 qr0=_mm_sub_ps(r0, _mm_loadu_ps(r.oldRow+j));
+    const __m128 qr1=_mm_sub_ps(r1, _mm_loadu_ps(r.oldRow+j+1));
+    const __m128 qb_=_mm_sub_ps(b_, _mm_loadu_ps(r.oldBelow+j-1));
+    const __m128 qb0=_mm_sub_ps(b0, _mm_loadu_ps(r.oldBelow+j));
+    const __m128 qb1=_mm_sub_ps(b1, _mm_loadu_ps(r.oldBelow+j+1));
+
+    const __m128 p4=_mm_mul_ps(four, r0);
+    const __m128 q4=_mm_mul_ps(four, qr0);
+    const __m128 lap=_mm_sub_ps(_mm_add_ps(_mm_add_ps(a0, b0),
+                                           _mm_add_ps(r_, r1)), p4);
+    const __m128 diag=_mm_sub_ps(_mm_add_ps(_mm_add_ps(a_, a1),
+                                            _mm_add_ps(b_, b1)), p4);
+    const __m128 qlap=_mm_sub_ps(_mm_add_ps(_mm_add_ps(qa0, qb0),
+                                            _mm_add_ps(qr_, qr1)), q4);
+    const __m128 qdiag=_mm_sub_ps(_mm_add_ps(_mm_add_ps(qa_, qa1),
+                                  _mm_add_ps(qb_, qb1)), q4);
+
+    __m128 f=_mm_sub_ps(_mm_add_ps(_mm_mul_ps(K1, lap), _mm_mul_ps(K2, diag)),
+                        _mm_mul_ps(K3, r0));
+    f=_mm_add_ps(f, _mm_add_ps(_mm_mul_ps(D1, qlap), _mm_mul_ps(D2, qdiag)));
+    f=_mm_sub_ps(f, _mm_mul_ps(D3, qr0));
+    _mm_storeu_ps(r.force+j, f);
+  }
+  return n;
+}
+#endif /* __SSE2__ */
+};
+
 CPPEXTERN_NEW_WITH_GIMME(newWave);
 
 /////////////////////////////////////////////////////////
@@ -54,6 +274,8 @@ newWave :: newWave( int argc,
   , alreadyInit(0)
   , m_textureMode(0)
   , m_resetMode(HILLFOUR)
+  , m_vertices(0)
+  , m_sizeX(0), m_sizeY(0)
 {
   int widthX=10;
   int widthY=10;
@@ -82,6 +304,8 @@ newWave :: newWave( int argc,
   gridY = MIN(widthY, MAXGRID );
   gridY = MAX( 3,     gridY);
 
+  setSize(gridX, gridY);
+
   // the height inlet
   m_inletH = inlet_new(this->x_obj, &this->x_obj->ob_pd, &s_float,
                        gensym("height"));
@@ -153,8 +377,8 @@ void newWave :: renderShape(GemState *state)
     m_drawType=GL_TRIANGLE_STRIP;
   }
 
-  GLfloat sizeX = 2.*m_size / (gridX-1);
-  GLfloat sizeY = 2.*m_size / (gridY-1);
+  m_sizeX = 2.*m_size / (gridX-1);
+  m_sizeY = 2.*m_size / (gridY-1);
 
   glNormal3f( 0.0f, 0.0f, 1.0f);
 
@@ -177,20 +401,6 @@ void newWave :: renderShape(GemState *state)
       reset( m_resetMode );
       alreadyInit = 1;
     }
-
-    for (int i=0; i<gridX -1; ++i) {
-      glBegin(m_drawType);
-      for (int j = 0; j < gridY ; ++j) {
-        glNormal3fv( vertNorms[i][j] );
-        glTexCoord2fv( texCoords[i][j] );
-        glVertex3f( i*sizeX - 1, j*sizeY -1, posit[i][j]*m_height);
-
-        glNormal3fv( vertNorms[i+1][j] );
-        glTexCoord2fv( texCoords[i+1][j] );
-        glVertex3f(  (i+1)*sizeX - 1, j*sizeY -1, posit[i+1][j]*m_height);
-      }
-      glEnd();
-    }
   } else {
     if (!alreadyInit) {
       xsize = 1;
@@ -202,156 +412,95 @@ void newWave :: renderShape(GemState *state)
       reset( m_resetMode );
       alreadyInit = 1;
     }
+  }
 
-    for (int i = 0; i<gridX -1; ++i) {
-      glBegin(m_drawType);
-      for (int j = 0; j < gridY  ; ++j) {
-        glNormal3fv( vertNorms[i][j] );
-        glTexCoord2fv( texCoords[i][j] );
-        glVertex3f( i*sizeX -1, j*sizeY -1, posit[i][j]*m_height );
+  m_vertices=m_mesh.map();
+  if(m_vertices) {
+    SliceJob emitJob(this, &newWave::emit);
+    runJob(emitJob, gridX, m_pool);
+    m_mesh.unmap();
+    m_vertices=0;
+    if(m_mesh.draw(m_drawType, gem::GridMesh::STRIPS)) {
+      return;
+    }
+  }
 
-        glNormal3fv( vertNorms[i+1][j] );
-        glTexCoord2fv( texCoords[i+1][j] );
-        glVertex3f( (i+1)*sizeX -1, j*sizeY -1, posit[i+1][j]*m_height );
+  /* no vertex buffers: immediate mode */
+  for (int i=0; i<gridX -1; ++i) {
+    glBegin(m_drawType);
+    for (int j = 0; j < gridY ; ++j) {
+      for (int n = i; n <= i+1; ++n) {
+        const int index=n*gridY+j;
+        glNormal3f(vertNorms[0][index], vertNorms[1][index],
+                   vertNorms[2][index]);
+        glTexCoord2f( ((xsize*1.*n)/(gridX-1)) + xsize0,
+                      ((ysize*1.*j)/(gridY-1)) + ysize0 );
+        glVertex3f( n*m_sizeX - 1, j*m_sizeY -1, posit[index]*m_height);
       }
-      glEnd();
     }
+    glEnd();
   }
 }
 
 /////////////////////////////////////////////////////////
-// heightMess
+// stopRendering
 //
 /////////////////////////////////////////////////////////
-void newWave :: heightMess(float size)
+void newWave :: stopRendering(void)
 {
-  m_height = size;
-  setModified();
+  m_mesh.release();
 }
 
 /////////////////////////////////////////////////////////
-// getforce
-//
+// emit
+//   write the vertices of a few rows into the vertex buffer
 /////////////////////////////////////////////////////////
-void newWave :: getforce(void)
+void newWave :: emit(unsigned int slice, unsigned int numSlices)
 {
-  float d;
-  int i;
-  int j;
-  for (i=0; i<gridX; i++)
-    for ( j=0; j<gridY; j++) {
-      force[i][j] =0.0;
-    }
-  // add (low amplitude) noise to avoid denormalisation.
-  // this noise does propagate thrus the all structure.
-  force[2][2]= 2e-20 * (double)random2() * (1. / 2147483648.) - 1e-20;
+  const unsigned int gy=gridY;
+  const unsigned int stride=gem::GridMesh::STRIDE;
+  const float scaleS=xsize/(gridX-1);
+  const float scaleT=ysize/(gridY-1);
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, gridX, start, stop);
 
-  if (K1 != 0) {
-    for ( i=1; i<gridX; i++)
-      for (int j=1; j<gridY; j++) {
-        d = K1 * (posit[i][j] - posit[i][j-1]);
-        force[i][j] -= d;
-        force[i][j-1] += d;
-
-
-        d = K1 * (posit[i][j] - posit[i-1][j]);
-        force[i][j] -= d;
-        force[i-1][j] += d;
-      }
-  }
-
-  if (K2 != 0) {
-    for ( i=1; i<gridX; i++)
-      for (int j=1; j<gridY; j++) {
-        d = K2 * (posit[i][j] - posit[i-1][j-1]);
-        force[i][j] -= d;
-        force[i-1][j-1] += d;
-
-      }
-
-    for ( i=0; i<gridX-1; i++)
-      for (int j=1; j<gridY; j++) {
-        d = K2 * (posit[i][j] - posit[i+1][j-1]);
-        force[i][j] -= d;
-        force[i+1][j-1] += d;
-      }
-  }
-
-  if (K3 != 0) {
-    for ( i=1; i<gridX-1; i++)
-      for (int j=1; j<gridY-1; j++) {
-        d = K3 * posit[i][j];
-        force[i][j] -= d;
-      }
+  for(unsigned int i=start; i<stop; i++) {
+    float*v=m_vertices+i*gy*stride;
+    const float x=i*m_sizeX - 1;
+    const float s=scaleS*i + xsize0;
+    for(unsigned int j=0; j<gy; j++, v+=stride) {
+      const unsigned int index=i*gy+j;
+      v[0]=x;
+      v[1]=j*m_sizeY - 1;
+      v[2]=posit[index]*m_height;
+      v[3]=vertNorms[0][index];
+      v[4]=vertNorms[1][index];
+      v[5]=vertNorms[2][index];
+      v[6]=s;
+      v[7]=scaleT*j + ysize0;
+    }
   }
-
 }
+
 /////////////////////////////////////////////////////////
-// random
+// heightMess
 //
 /////////////////////////////////////////////////////////
-void newWave :: noise(float rnd)
+void newWave :: heightMess(float size)
 {
-  int i, j;
-  for (i=0; i<gridX; i++)
-    for ( j=0; j<gridY; j++) {
-      force[i][j] += rnd * (double)random2() * (1. / 2147483648.) - rnd/2;
-    }
+  m_height = size;
+  setModified();
 }
 
 /////////////////////////////////////////////////////////
-// getdamp
+// random
 //
 /////////////////////////////////////////////////////////
-void newWave :: getdamp(void)
+void newWave :: noise(float rnd)
 {
-  float d;
-  int i;
-  int j;
-
-  if (D1 != 0) {
-    for ( i=1; i<gridX; i++) {
-      for (j=1; j<gridY; j++) {
-        d = D1 * ((posit[i][j] - posit[i][j-1])-(positold[i][j] - positold[i][j
-                  -1]));
-        force[i][j] -= d;
-        force[i][j-1] += d;
-
-        d = D1 * ((posit[i][j] - posit[i-1][j])-(positold[i][j] - positold[i
-                  -1][j]));
-        force[i][j] -= d;
-        force[i-1][j] += d;
-      }
-    }
-  }
-
-  if (D2 != 0) {
-    for ( i=1; i<gridX; i++)
-      for (j=1; j<gridY; j++) {
-        d = D2 * ((posit[i][j] - posit[i-1][j-1])-(positold[i][j] - positold[i-1][j
-                  -1]));
-        force[i][j] -= d;
-        force[i-1][j-1] += d;
-      }
-
-    for ( i=0; i<gridX-1; i++)
-      for (j=1; j<gridY; j++) {
-        d = D2 * ((posit[i][j] - posit[i+1][j-1])-(positold[i][j] - positold[i+1][j
-                  -1]));
-        force[i][j] -= d;
-        force[i+1][j-1] += d;
-      }
-  }
-
-  if (D3 != 0) {
-    for ( i=1; i<gridX-1; i++)
-      for (j=1; j<gridY-1; j++) {
-        d = D3 * (posit[i][j]-positold[i][j]);
-        force[i][j] -= d;
-
-        d = D3 * (posit[i][j]-positold[i][j]);
-        force[i][j] -= d;
-      }
+  const int size=gridX*gridY;
+  for (int i=0; i<size; i++) {
+    force[i] += rnd * (double)random2() * (1. / 2147483648.) - rnd/2;
   }
 }
 
@@ -365,7 +514,7 @@ void newWave :: setforce(float posX, float posY, float valforce)
   int posYi=static_cast<int>(posY);
   if ( (posXi > 0) & (posXi < gridX - 1) & (posYi > 0) &
        (posYi < gridY - 1) ) {
-    force[posXi][posYi] += valforce;
+    force[posXi*gridY+posYi] += valforce;
   }
 }
 
@@ -379,63 +528,7 @@ void newWave :: position(float posX, float posY, float posZ)
   int posYi=static_cast<int>(posY);
   if ( (posXi > 0) & (posXi < gridX - 1) & (posYi > 0) &
        (posYi < gridY - 1) ) {
-    posit[posXi][posYi] = posZ;
-  }
-}
-
-
-/////////////////////////////////////////////////////////
-// savepos
-//
-/////////////////////////////////////////////////////////
-void newWave :: savepos(void)
-{
-  int i;
-  int j;
-  for (i=0; i<gridX; i++)
-    for ( j=0; j<gridY; j++) {
-      positold[i][j] = posit[i][j];
-    }
-}
-
-
-/////////////////////////////////////////////////////////
-// getvelocity
-//
-/////////////////////////////////////////////////////////
-void newWave :: getvelocity(void)
-{
-  for (int i=1; i<gridX-1; i++)
-    for (int j=1; j<gridY-1; j++) {
-      veloc[i][j] += force[i][j] ;
-    }
-}
-
-/////////////////////////////////////////////////////////
-// getposition
-//
-/////////////////////////////////////////////////////////
-void newWave :: getposition(void)
-{
-  for ( int i=1; i<gridX-1; i++)
-    for ( int j=1; j<gridY-1; j++)
-      //            posit[i][j] += veloc[i][j];
-    {
-      posit[i][j] = MAX(-1e20f, MIN(1e20f, posit[i][j]+veloc[i][j]));
-    }
-}
-
-/////////////////////////////////////////////////////////
-// getTexCoords
-//
-/////////////////////////////////////////////////////////
-void newWave :: getTexCoords(void)
-{
-  for ( int i = 0; i < gridX; ++i) {
-    for ( int j = 0; j < gridY; ++j) {
-      texCoords[i][j][0] = (((xsize*1.*i)/(gridX-1)) + xsize0 );
-      texCoords[i][j][1] = (((ysize*1.*j)/(gridY-1)) + ysize0 );
-    }
+    posit[posXi*gridY+posYi] = posZ;
   }
 }
 
@@ -448,9 +541,20 @@ void newWave :: setSize( int valueX, int valueY )
   gridX = valueX>MAXGRID?MAXGRID:valueX;
   gridY = valueY>MAXGRID?MAXGRID:valueY;
 
-  reset(m_resetMode);
+  const unsigned int size=gridX*gridY;
+  force.assign(size, 0.f);
+  veloc.assign(size, 0.f);
+  posit.assign(size, 0.f);
+  positold.assign(size, 0.f);
+  for(unsigned int c=0; c<3; c++) {
+    /* flat until the first step */
+    vertNorms[c].assign(size, (2==c)?1.f:0.f);
+    faceNorms[0][c].assign(size, 0.f);
+    faceNorms[1][c].assign(size, 0.f);
+  }
+  m_mesh.setSize(gridX, gridY);
 
-  getTexCoords();
+  reset(m_resetMode);
 }
 
 /////////////////////////////////////////////////////////
@@ -459,195 +563,200 @@ void newWave :: setSize( int valueX, int valueY )
 /////////////////////////////////////////////////////////
 void newWave :: bangMess(void)
 {
-
-  savepos();
-
-  getvelocity();
-  getposition();
-
-  getFaceNorms();
-  getVertNorms();
-
-  getforce();
-  getdamp();
-
+  step();
 }
 
 /////////////////////////////////////////////////////////
-// vector operations
-//
+// step
+//   the passes are separated, as each of them
+//   needs the results of the previous one for the neighbouring rows
 /////////////////////////////////////////////////////////
-void newWave :: copy(float vec0[3], float vec1[3])
+void newWave :: step(void)
 {
-  vec0[0] = vec1[0];
-  vec0[1] = vec1[1];
-  vec0[2] = vec1[2];
-}
+  SliceJob integrateJob(this, &newWave::integrate);
+  runJob(integrateJob, gridX, m_pool);
 
-void newWave :: sub(float vec0[3], float vec1[3], float vec2[3])
-{
-  vec0[0] = vec1[0] - vec2[0];
-  vec0[1] = vec1[1] - vec2[1];
-  vec0[2] = vec1[2] - vec2[2];
-}
-
-void newWave :: add(float vec0[3], float vec1[3], float vec2[3])
-{
-  vec0[0] = vec1[0] + vec2[0];
-  vec0[1] = vec1[1] + vec2[1];
-  vec0[2] = vec1[2] + vec2[2];
-}
+  SliceJob faceJob(this, &newWave::getFaceNorms);
+  runJob(faceJob, gridX-1, m_pool);
 
-void newWave :: scalDiv(float vec[3], float c)
-{
-  vec[0] /= c;
-  vec[1] /= c;
-  vec[2] /= c;
-}
+  SliceJob vertJob(this, &newWave::getVertNormsAndForces);
+  runJob(vertJob, gridX, m_pool);
 
-void newWave :: cross(float vec0[3], float vec1[3], float vec2[3])
-{
-  vec0[0] = vec1[1] * vec2[2] - vec1[2] * vec2[1];
-  vec0[1] = vec1[2] * vec2[0] - vec1[0] * vec2[2];
-  vec0[2] = vec1[0] * vec2[1] - vec1[1] * vec2[0];
+  // add (low amplitude) noise to avoid denormalisation.
+  // this noise does propagate thrus the all structure.
+  force[2*gridY+2] += 2e-20 * (double)random2() * (1. / 2147483648.) - 1e-20;
 }
 
-void newWave :: norm(float vec[3])
+/////////////////////////////////////////////////////////
+// integrate
+//   savepos, getvelocity and getposition
+/////////////////////////////////////////////////////////
+void newWave :: integrate(unsigned int slice, unsigned int numSlices)
 {
-  float c = sqrt(vec[0] * vec[0] + vec[1] * vec[1] + vec[2] * vec[2]);
-  scalDiv(vec, c);
-}
+  const unsigned int gx=gridX, gy=gridY;
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, gx, start, stop);
+#ifdef __SSE2__
+  const bool simd=(GEM_SIMD_SSE2 == GemSIMD::getCPU());
+#endif
 
-void newWave :: set(float vec[3], float x, float y, float z)
-{
-  vec[0] = x;
-  vec[1] = y;
-  vec[2] = z;
+  for(unsigned int i=start; i<stop; i++) {
+    const unsigned int row=i*gy;
+    float*p=&posit[row];
+    float*v=&veloc[row];
+    const float*f=&force[row];
+    memcpy(&positold[row], p, gy*sizeof(float));
+    /* the borders are fixed */
+    if(i<1 || i>=gx-1) {
+      continue;
+    }
+    unsigned int j=1;
+#ifdef __SSE2__
+    if(simd) {
+      j+=integrateSSE2(p+1, v+1, f+1, gy-2);
+    }
+#endif
+    for(; j<gy-1; j++) {
+      v[j] += f[j];
+      p[j] = MAX(-1e20f, MIN(1e20f, p[j]+v[j]));
+    }
+  }
 }
 
 /////////////////////////////////////////////////////////
 // getFaceNorms
 // face normals - for flat shading
-/////////////////////////////////////////////////////////
-
-void newWave :: getFaceNorms(void)
-{
-  float vec0[3], vec1[3], vec2[3], norm0[3], norm1[3];
-  float geom0[3], geom1[3], geom2[3], geom3[3];
-  for (int i = 0; i < gridX-1; ++i) {
-    for ( int j = 0; j < gridY-1; ++j) {
-      /* get vectors from geometry points */
-      geom0[0] = i;
-      geom0[1] = j;
-      geom0[2] = posit[i][j];
-      geom1[0] = i;
-      geom1[1] = j+1;
-      geom1[2] = posit[i][j+1];
-      geom2[0] = i+1;
-      geom2[1] = j;
-      geom2[2] = posit[i+1][j];
-      geom3[0] = i+1;
-      geom3[1] = j+1;
-      geom3[2] = posit[i+1][j+1];
-
-      sub( vec0, geom1, geom0 );
-      sub( vec1, geom1, geom2 );
-      sub( vec2, geom1, geom3 );
-
-      /* get triangle face normals from vectors & normalize them */
-      cross( norm0, vec0, vec1 );
-      norm( norm0 );
-
-      cross( norm1, vec1, vec2 );
-      norm( norm1 );
-
-      copy( faceNorms[0][i][j], norm0 );
-      copy( faceNorms[1][i][j], norm1 );
+//   the two triangles of cell [i][j] are
+//   [i][j], [i][j+1], [i+1][j] and [i][j+1], [i+1][j], [i+1][j+1]
+//   (on a grid with unit spacing)
+/////////////////////////////////////////////////////////
+void newWave :: getFaceNorms(unsigned int slice, unsigned int numSlices)
+{
+  const unsigned int gy=gridY;
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, gridX-1, start, stop);
+#ifdef __SSE2__
+  const bool simd=(GEM_SIMD_SSE2 == GemSIMD::getCPU());
+#endif
+
+  for(unsigned int i=start; i<stop; i++) {
+    const unsigned int row=i*gy;
+    const float*p0=&posit[row];
+    const float*p1=&posit[row+gy];
+    unsigned int j=0;
+#ifdef __SSE2__
+    if(simd) {
+      j=faceNormsSSE2(p0, p1, faceNorms[0], faceNorms[1], row, gy-1);
+    }
+#endif
+    for(; j<gy-1; j++) {
+      storeNorm(faceNorms[0], row+j, p0[j]-p1[j], p0[j]-p0[j+1], 1.f);
+      storeNorm(faceNorms[1], row+j, p0[j+1]-p1[j+1], p1[j]-p1[j+1], 1.f);
     }
   }
 }
+
 /////////////////////////////////////////////////////////
-// getVertNorms
+// getVertNormsAndForces
 // vertex normals - average of face normals for smooth shading
-/////////////////////////////////////////////////////////
-void newWave :: getVertNorms(void)
-{
-  float avg[3];
-  for ( int i = 0; i < gridX; ++i) {
-    for ( int j = 0; j < gridY; ++j) {
+// forces - getforce and getdamp
+/////////////////////////////////////////////////////////
+void newWave :: getVertNormsAndForces(unsigned int slice,
+                                      unsigned int numSlices)
+{
+  const unsigned int gx=gridX, gy=gridY;
+  const WaveCoeffs coeffs= {K1, K2, K3, D1, D2, D3};
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, gx, start, stop);
+#ifdef __SSE2__
+  const bool simd=(GEM_SIMD_SSE2 == GemSIMD::getCPU());
+#endif
+
+  for(unsigned int i=start; i<stop; i++) {
+    const unsigned int row=i*gy;
+    const bool inner=(i>0 && i<gx-1);
+    unsigned int j;
+    for(j=0; j<gy; j++) {
+#ifdef __SSE2__
+      /* masses that are surrounded by 6 triangles */
+      if(simd && inner && 1==j) {
+        j+=vertNormsSSE2(faceNorms[0], faceNorms[1], vertNorms, row+1, gy,
+                         gy-2);
+      }
+#endif
+      float avg[3]= {0.f, 0.f, 0.f};
+      const unsigned int index=row+j;
       /* For each vertex, average normals from all faces sharing */
       /* vertex.  Check each quadrant in turn */
-      set(avg, 0.0, 0.0, 0.0);
 
       /* Right & above */
-      if (j < gridY-1 && i < gridX-1) {
-        add( avg, avg, faceNorms[0][i][j] );
+      if (j < gy-1 && i < gx-1) {
+        addNorm(avg, faceNorms[0], index);
       }
       /* Right & below */
-      if (j < gridY-1 && i > 0) {
-        add( avg, avg, faceNorms[0][i-1][j] );
-        add( avg, avg, faceNorms[1][i-1][j] );
+      if (j < gy-1 && i > 0) {
+        addNorm(avg, faceNorms[0], index-gy);
+        addNorm(avg, faceNorms[1], index-gy);
       }
       /* Left & above */
-      if (j > 0 && i < gridX-1) {
-        add( avg, avg, faceNorms[0][i][j-1] );
-        add( avg, avg, faceNorms[1][i][j-1] );
+      if (j > 0 && i < gx-1) {
+        addNorm(avg, faceNorms[0], index-1);
+        addNorm(avg, faceNorms[1], index-1);
       }
       /* Left & below */
       if (j > 0 && i > 0) {
-        add( avg, avg, faceNorms[1][i-1][j-1] );
+        addNorm(avg, faceNorms[1], index-gy-1);
       }
 
       /* Normalize */
-      norm( avg );
-      copy( vertNorms[i][j], avg );
+      storeNorm(vertNorms, index, avg[0], avg[1], avg[2]);
+    }
+
+    float*f=&force[row];
+    /* the borders are fixed */
+    if(!inner) {
+      memset(f, 0, gy*sizeof(float));
+      continue;
+    }
+    f[0]=f[gy-1]=0.f;
+    WaveRow r;
+    r.above=&posit[row-gy];
+    r.row=&posit[row];
+    r.below=&posit[row+gy];
+    r.oldAbove=&positold[row-gy];
+    r.oldRow=&positold[row];
+    r.oldBelow=&positold[row+gy];
+    r.force=f;
+    j=1;
+#ifdef __SSE2__
+    if(simd) {
+      j+=forcesSSE2(r, 1, gy-2, coeffs);
+    }
+#endif
+    for(; j<gy-1; j++) {
+      f[j]=waveForce(r, j, coeffs);
     }
   }
 }
 
 /////////////////////////////////////////////////////////
-// getFaceNormSegs
-//
+// benchmarkMess
+//   run the simulation for a number of steps
 /////////////////////////////////////////////////////////
-void newWave :: getFaceNormSegs(void)
-{
-  float center0[3], center1[3], normSeg0[3], normSeg1[3];
-  float geom0[3], geom1[3], geom2[3], geom3[3];
-  for ( int i = 0; i < gridX - 1; ++i) {
-    for ( int j = 0; j < gridY - 1; ++j) {
-      geom0[0] = i;
-      geom0[1] = j;
-      geom0[2] = posit[i][j];
-      geom1[0] = i;
-      geom1[1] = j+1;
-      geom1[2] = posit[i][j+1];
-      geom2[0] = i+1;
-      geom2[1] = j;
-      geom2[2] = posit[i+1][j];
-      geom3[0] = i+1;
-      geom3[1] = j+1;
-      geom3[2] = posit[i+1][j+1];
-
-      /* find center of triangle face by averaging three vertices */
-      add( center0, geom2, geom0 );
-      add( center0, center0, geom1 );
-      scalDiv( center0, 3.0 );
-
-      add( center1, geom2, geom1 );
-      add( center1, center1, geom3 );
-      scalDiv( center1, 3.0 );
-
-      /* translate normal to center of triangle face to get normal segment */
-      add( normSeg0, center0, faceNorms[0][i][j] );
-      add( normSeg1, center1, faceNorms[1][i][j] );
-
-      copy( faceNormSegs[0][0][i][j], center0 );
-      copy( faceNormSegs[1][0][i][j], center1 );
-
-      copy( faceNormSegs[0][1][i][j], normSeg0 );
-      copy( faceNormSegs[1][1][i][j], normSeg1 );
-    }
+void newWave :: benchmarkMess(int steps)
+{
+  if(steps<1) {
+    error("number of steps must be greater than 0");
+    return;
+  }
+  const double starttime=sys_getrealtime();
+  for(int i=0; i<steps; i++) {
+    step();
   }
+  const double duration=sys_getrealtime()-starttime;
+  post("benchmark: %dx%d grid, %d thread(s): %d steps in %f seconds (%f steps/sec)",
+       gridX, gridY, m_pool.getThreads(), steps, duration,
+       (duration>0.)?(steps/duration):0.);
 }
 
 void newWave :: reset(int value)
@@ -657,49 +766,49 @@ void newWave :: reset(int value)
   }
   for( int i=0; i<gridX; i++)
     for( int j=0; j<gridY; j++) {
-      force[i][j]=0.0;
-      veloc[i][j]=0.0;
+      force[i*gridY+j]=0.0;
+      veloc[i*gridY+j]=0.0;
 
       switch(m_resetMode) {
       case FLAT:
-        posit[i][j] = 0.0;
+        posit[i*gridY+j] = 0.0;
         break;
       case SPIKE:
-        posit[i][j]= (i == gridX/2 && j == gridY/2) ? gridX*1.5 : 0.0;
+        posit[i*gridY+j]= (i == gridX/2 && j == gridY/2) ? gridX*1.5 : 0.0;
         break;
       case HOLE:
-        posit[i][j]= (!((i > gridX/3 && j > gridY/3)&&(i < gridX*2/3
+        posit[i*gridY+j]= (!((i > gridX/3 && j > gridY/3)&&(i < gridX*2/3
                         && j < gridY*2/3))) ? gridX/4 : 0.0;
         break;
       case DIAGONALWALL:
-        posit[i][j]= (((gridX-i)-j<3) && ((gridX-i)-j>0)) ? gridX/6 : 0.0;
+        posit[i*gridY+j]= (((gridX-i)-j<3) && ((gridX-i)-j>0)) ? gridX/6 : 0.0;
         break;
       case SIDEWALL:
-        posit[i][j]= (i==1) ? gridX/4 : 0.0;
+        posit[i*gridY+j]= (i==1) ? gridX/4 : 0.0;
         break;
       case DIAGONALBLOCK:
-        posit[i][j]= ((gridX-i)-j<3) ? gridX/6 : 0.0;
+        posit[i*gridY+j]= ((gridX-i)-j<3) ? gridX/6 : 0.0;
         break;
       case MIDDLEBLOCK:
-        posit[i][j]= ((i > gridX/3 && j > gridY/3)&&(i < gridX*2/3
+        posit[i*gridY+j]= ((i > gridX/3 && j > gridY/3)&&(i < gridX*2/3
                       && j < gridY*2/3)) ? gridX/4 : 0.0;
         break;
       case CORNERBLOCK:
-        posit[i][j]= ((i > gridX*3/4 && j > gridY*3/4)) ? gridX/4 : 0.0;
+        posit[i*gridY+j]= ((i > gridX*3/4 && j > gridY*3/4)) ? gridX/4 : 0.0;
         break;
       case HILL:
-        posit[i][j]=
+        posit[i*gridY+j]=
           (sin(M_PI * ((1.*i)/gridX)) +
            sin(M_PI * ((1.*j)/gridY)))* gridX/6.0;
         break;
       case HILLFOUR:
-        posit[i][j]=
+        posit[i*gridY+j]=
           (sin(M_PI*2.* ((1.*i)/gridX)) +
            sin(M_PI*2.* ((1.*j)/gridY)))* gridX/6.0;
         break;
       }
       if (i==0||j==0||i==gridX-1||j==gridY-1) {
-        posit[i][j]=0.0;
+        posit[i*gridY+j]=0.0;
       }
     }
 }
@@ -741,6 +850,9 @@ void newWave :: obj_setupCallback(t_class *classPtr)
   CPPEXTERN_MSG1(classPtr, "D1", setD1Mess, float);
   CPPEXTERN_MSG1(classPtr, "D2", setD2Mess, float);
   CPPEXTERN_MSG1(classPtr, "D3", setD3Mess, float);
+
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
+  CPPEXTERN_MSG1(classPtr, "benchmark", benchmarkMess, int);
 }
 
 void newWave :: setK1Mess(float K)
@@ -768,3 +880,8 @@ void newWave :: setD3Mess(float D)
 {
   D3=D;
 }
+
+void newWave :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
+}
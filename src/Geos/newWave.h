@@ -14,14 +14,18 @@
 #define _INCLUDE__GEM_GEOS_NEWWAVE_H_
 
 #include "Base/GemShape.h"
+#include "Gem/GridMesh.h"
 #include "Utils/Functions.h"
+#include "Utils/ThreadPool.h"
+
+#include <vector>
 
 #ifdef __ppc__
 #undef sqrt
 #define sqrt fast_sqrtf
 #endif
 
-#define MAXGRID 600
+#define MAXGRID 1024
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
 CLASS
@@ -34,6 +38,13 @@ KEYWORDS
 
 DESCRIPTION
 
+    the simulation is stepped with each "bang"
+    (split into rows for the threads; see "threads")
+    the surface is drawn from a streaming vertex buffer
+
+    "threads" <n> - number of threads (0: one per CPU; default: 1)
+    "benchmark" <steps> - time the simulation (without drawing)
+
 -----------------------------------------------------------------*/
 class GEM_EXTERN newWave : public GemShape
 {
@@ -64,6 +75,7 @@ protected:
   //////////
   // Do the rendering
   virtual void  renderShape(GemState *state);
+  virtual void  stopRendering(void);
 
   //////////
   // The height of the object
@@ -75,14 +87,7 @@ protected:
 
   //////////
   // getStuff
-  void  getforce(void);
-  void  getvelocity(void);
-  void  getposition(void);
-  void  savepos(void);
-  void  getK(void);
-  void  getdamp(void);
   void  noise(float);
-  void  getTexCoords(void);
   void  setSize( int valueX, int valueY );
 
   void  setK1Mess(float K);
@@ -95,19 +100,25 @@ protected:
   void  position( float posX, float posY, float posZ );
   void  setforce( float posX, float posY, float valforce);
 
-  void copy( float vec0[3], float vec1[3]);
-  void sub(float vec0[3], float vec1[3], float vec2[3]);
-  void add(float vec0[3], float vec1[3], float vec2[3]);
-  void scalDiv(float vec[3], float c);
-  void cross(float vec0[3], float vec1[3], float vec2[3]);
-  void norm(float vec[3]);
-  void set(float vec[3], float x, float y, float z);
   void reset( int value );
   void setOther( int value );
 
-  void getFaceNorms( void );
-  void getVertNorms( void );
-  void getFaceNormSegs( void );
+  //////////
+  // a single step of the simulation, split into passes over rows
+  // (each pass is split into slices for the threads)
+  void  step(void);
+  //   positold=posit; veloc+=force; posit+=veloc
+  void  integrate(unsigned int slice, unsigned int numSlices);
+  //   the normals of the two triangles of each cell
+  void  getFaceNorms(unsigned int slice, unsigned int numSlices);
+  //   the averaged normals of each vertex, and the forces for the next step
+  void  getVertNormsAndForces(unsigned int slice, unsigned int numSlices);
+  //   fill the vertex buffer
+  void  emit(unsigned int slice, unsigned int numSlices);
+
+  gem::thread::ThreadPool m_pool;
+  void  threadMess(int threads);
+  void  benchmarkMess(int steps);
 
   float xsize, xsize0, ysize, ysize0;
   float K1, D1, K2, D2, K3, D3;
@@ -117,15 +128,17 @@ protected:
 
   int m_resetMode;
 
-  float force[MAXGRID][MAXGRID],
-        veloc[MAXGRID][MAXGRID],
-        posit[MAXGRID][MAXGRID],
-        positold[MAXGRID][MAXGRID],
-        vertNorms[MAXGRID][MAXGRID][3],
-        faceNorms[2][MAXGRID][MAXGRID][3],
-        faceNormSegs[2][2][MAXGRID][MAXGRID][3];
-
-  float texCoords[MAXGRID][MAXGRID][2];
+  // the state of the grid; [i][j] lives at [i*gridY+j]
+  std::vector<float>force, veloc, posit, positold;
+  // separate x/y/z components
+  std::vector<float>vertNorms[3];
+  // separate components of the lower-left and upper-right triangles
+  std::vector<float>faceNorms[2][3];
+
+  gem::GridMesh m_mesh;
+  // the vertex buffer while it is filled
+  float*m_vertices;
+  float m_sizeX, m_sizeY;
 };
 
 #endif  // for header file
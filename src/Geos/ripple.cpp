@@ -14,6 +14,39 @@
 #include "ripple.h"
 #include "Gem/State.h"
 
+namespace
+{
+/* runs a member function of ripple on the slices of a job */
+class SliceJob : public gem::thread::ThreadPool::Job
+{
+public:
+  typedef void (ripple::*Method)(unsigned int, unsigned int);
+  ripple*obj;
+  Method method;
+  SliceJob(ripple*o, Method m)
+    : obj(o), method(m)
+  { }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    (obj->*method)(slice, numSlices);
+  }
+};
+
+void runJob(gem::thread::ThreadPool::Job&job, unsigned int size,
+            gem::thread::ThreadPool&pool)
+{
+  unsigned int numSlices=pool.getThreads();
+  if(numSlices>size) {
+    numSlices=size;
+  }
+  if(numSlices<2) {
+    job.process(0, 1);
+    return;
+  }
+  pool.run(job, numSlices);
+}
+};
+
 CPPEXTERN_NEW_WITH_TWO_ARGS(ripple, t_floatarg, A_DEFFLOAT, t_floatarg,
                             A_DEFFLOAT);
 
@@ -33,12 +66,14 @@ ripple :: ripple( t_floatarg gridX, t_floatarg gridY )
     m_gridX(0), m_gridY(0),
     m_alreadyInit(false),
     m_sizeX(0.f), m_sizeY(0.f), m_sizeY0(0.f),
-    m_rippleMax(0.f)
+    m_rippleVectorMax(0),
+    m_rippleMax(0.f),
+    m_vertices(NULL), m_textured(false)
 {
   int gridXi=static_cast<int>(gridX);
   int gridYi=static_cast<int>(gridY);
-  m_gridX=(gridXi>0&&gridXi<GRID_MAX_X)?gridXi:GRID_SIZE_X;
-  m_gridY=(gridYi>0&&gridXi<GRID_MAX_Y)?gridYi:GRID_SIZE_Y;
+  m_gridX=(gridXi>0&&gridXi<=GRID_MAX_X)?gridXi:GRID_SIZE_X;
+  m_gridY=(gridYi>0&&gridYi<=GRID_MAX_Y)?gridYi:GRID_SIZE_Y;
 
   // the height inlet
   m_inletH = inlet_new(this->x_obj, &this->x_obj->ob_pd, &s_float,
@@ -50,7 +85,10 @@ ripple :: ripple( t_floatarg gridX, t_floatarg gridY )
 
   m_drawType = GL_POLYGON;
   precalc_ripple_amp();
-
+  for (int i = 0; i < RIPPLE_COUNT; i++) {
+    m_t[i] = m_cx[i] = m_cy[i] = m_max[i] = 0;
+    m_amp[i] = 0.f;
+  }
 
   m_drawTypes.clear();
   m_drawTypes["default"]=GL_POLYGON;
@@ -78,11 +116,10 @@ ripple :: ~ripple(void)
 void ripple :: renderShape(GemState *state)
 {
   int i, j;
+  const bool textured=(GemShape::m_texType && GemShape::m_texNum>=3);
   glNormal3f(0.0f, 0.0f, 1.0f);
 
-  glScalef(2.*m_size, 2.*m_size, 2.*m_size);
-
-  if (GemShape::m_texType && GemShape::m_texNum>=3) {
+  if (textured) {
     if ((m_sizeX  != GemShape::m_texCoords[1].s) ||
         (m_sizeY  != GemShape::m_texCoords[1].t) ||
         (m_sizeY0 != GemShape::m_texCoords[2].t)) {
@@ -94,56 +131,105 @@ void ripple :: renderShape(GemState *state)
       m_sizeY0 = GemShape::m_texCoords[2].t;
       m_sizeY  = GemShape::m_texCoords[1].t;
 
+      glDisable(GL_DEPTH_TEST);
       ripple_init();
       precalc_ripple_vector();
       m_alreadyInit = true;
     }
-    for (i = 0; i < m_gridX - 1; i++)  {
-      for (j = 0; j < m_gridY - 1; j++)  {
-        glBegin(m_drawType);
-        glTexCoord2fv(m_rippleVertex[i][j].t);
-        glVertex2fv(m_rippleVertex[i][j].x);
-        glTexCoord2fv(m_rippleVertex[i][j + 1].t);
-        glVertex2fv(m_rippleVertex[i][j + 1].x);
-        glTexCoord2fv(m_rippleVertex[i + 1][j + 1].t);
-        glVertex2fv(m_rippleVertex[i + 1][j + 1].x);
-        glTexCoord2fv(m_rippleVertex[i + 1][j].t);
-        glVertex2fv(m_rippleVertex[i + 1][j].x);
-        glEnd();
-      }
-    }
-    ripple_dynamics();
   }  else  {
     if (!m_alreadyInit)   {
       m_sizeX = 1;
       m_sizeY = 1;
       m_sizeY0= 0;
 
+      glDisable(GL_DEPTH_TEST);
       ripple_init();
       precalc_ripple_vector();
       m_alreadyInit = true;
     }
+  }
+
+  /* the vertices are the (static) grid, or the (rippling)
+   * texture coordinates themselves */
+  m_vertices=m_mesh.map();
+  if(m_vertices) {
+    m_textured=textured;
+    SliceJob emitJob(this, &ripple::emit);
+    runJob(emitJob, m_gridX, m_pool);
+    m_mesh.unmap();
+    m_vertices=NULL;
+    if(m_mesh.draw(m_drawType, gem::GridMesh::CELLS)) {
+      ripple_dynamics();
+      return;
+    }
+  }
+
+  /* no vertex buffers: immediate mode */
+  glScalef(2.*m_size, 2.*m_size, 2.*m_size);
+  if(!textured) {
     glTranslatef(-.5, -.5, 0.0);
-    for (i = 0; i < m_gridX - 1; i++)  {
-      for (j = 0; j < m_gridY - 1; j++) {
-        glBegin(m_drawType);
-        glTexCoord2fv(m_rippleVertex[i][j].t);
-        glVertex2fv(m_rippleVertex[i][j].t);
-        glTexCoord2fv(m_rippleVertex[i][j + 1].t);
-        glVertex2fv(m_rippleVertex[i][j + 1].t);
-        glTexCoord2fv(m_rippleVertex[i + 1][j + 1].t);
-        glVertex2fv(m_rippleVertex[i + 1][j + 1].t);
-        glTexCoord2fv(m_rippleVertex[i + 1][j].t);
-        glVertex2fv(m_rippleVertex[i + 1][j].t);
-        glEnd();
+  }
+  for (i = 0; i < m_gridX - 1; i++)  {
+    for (j = 0; j < m_gridY - 1; j++)  {
+      const RIPPLE_VERTEX*v[4] = {
+        &m_rippleVertex[i*m_gridY + j],
+        &m_rippleVertex[i*m_gridY + j + 1],
+        &m_rippleVertex[(i + 1)*m_gridY + j + 1],
+        &m_rippleVertex[(i + 1)*m_gridY + j]
+      };
+      glBegin(m_drawType);
+      for (int k = 0; k < 4; k++) {
+        glTexCoord2fv(v[k]->t);
+        glVertex2fv(textured?v[k]->x:v[k]->t);
       }
+      glEnd();
     }
+  }
+  if(!textured) {
     glTranslatef(.5, .5, 0.0);
-    ripple_dynamics();
   }
-
   glScalef(.5/m_size, .5/m_size, .5/m_size);
+
+  ripple_dynamics();
+}
+
+/////////////////////////////////////////////////////////
+// stopRendering
+//
+/////////////////////////////////////////////////////////
+void ripple :: stopRendering(void)
+{
+  m_mesh.release();
+}
+
+/////////////////////////////////////////////////////////
+// emit
+//
+/////////////////////////////////////////////////////////
+void ripple :: emit(unsigned int slice, unsigned int numSlices)
+{
+  const unsigned int stride=gem::GridMesh::STRIDE;
+  const float scale=2.*m_size;
+  /* untextured, the vertices are centered around the origin */
+  const float offset=m_textured?0.f:-.5f;
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, m_gridX, start, stop);
+
+  for (unsigned int k = start*m_gridY; k < stop*m_gridY; k++) {
+    const RIPPLE_VERTEX&rv=m_rippleVertex[k];
+    const float*pos=m_textured?rv.x:rv.t;
+    float*v=m_vertices+k*stride;
+    v[0]=(pos[0]+offset)*scale;
+    v[1]=(pos[1]+offset)*scale;
+    v[2]=0.f;
+    v[3]=0.f;
+    v[4]=0.f;
+    v[5]=1.f;
+    v[6]=rv.t[0];
+    v[7]=rv.t[1];
+  }
 }
+
 /////////////////////////////////////////////////////////
 //
 //      ripple_init
@@ -156,7 +242,6 @@ void ripple :: renderShape(GemState *state)
 void ripple :: ripple_init(void)
 {
   int i, j;
-  glDisable(GL_DEPTH_TEST);
 
   m_rippleMax = (int)sqrt(m_sizeX * (m_sizeY+m_sizeY0) + m_sizeX * m_sizeX);
   for (i = 0; i < RIPPLE_COUNT; i++) {
@@ -166,14 +251,18 @@ void ripple :: ripple_init(void)
     m_max[i] = 0;
   }
 
+  m_rippleVertex.resize(m_gridX*m_gridY);
+  m_mesh.setSize(m_gridX, m_gridY);
   for (i = 0; i < m_gridX; i++)
     for (j = 0; j < m_gridY; j++) {
-
-      m_rippleVertex[i][j].x[0] = (i/(m_gridX - 1.0 ))-0.5;
-      m_rippleVertex[i][j].x[1] = (j/(m_gridY - 1.0 ))-0.5;
-      m_rippleVertex[i][j].dt[0] = m_sizeX*(i/(m_gridX - 1.0 ));
-      m_rippleVertex[i][j].dt[1] = (m_sizeY0-m_sizeY)*(j/(m_gridY - 1.0 ))
-                                   +m_sizeY;
+      RIPPLE_VERTEX&v=m_rippleVertex[i*m_gridY + j];
+      v.x[0] = (i/(m_gridX - 1.0 ))-0.5;
+      v.x[1] = (j/(m_gridY - 1.0 ))-0.5;
+      v.dt[0] = m_sizeX*(i/(m_gridX - 1.0 ));
+      v.dt[1] = (m_sizeY0-m_sizeY)*(j/(m_gridY - 1.0 ))
+                +m_sizeY;
+      v.t[0] = v.dt[0];
+      v.t[1] = v.dt[1];
     }
 }
 
@@ -186,8 +275,11 @@ void ripple :: precalc_ripple_vector(void)
   int i, j, z;
   float x, y, l;
 
+  m_rippleVector.resize(m_gridX*m_gridY);
+  m_rippleVectorMax = 0;
   for (i = 0; i < m_gridX; i++) {
     for (j = 0; j < m_gridY; j++) {
+      RIPPLE_VECTOR&v=m_rippleVector[i*m_gridY + j];
       x = (float) i/(m_gridX - 1);
       y = (float) j/(m_gridY - 1);
       l = (float) sqrt(x*x + y*y);
@@ -199,9 +291,12 @@ void ripple :: precalc_ripple_vector(void)
         y /= l;
       }
       z = (int)(l*m_sizeX*2);
-      m_rippleVector[i][j].dx[0] = x*m_sizeX;
-      m_rippleVector[i][j].dx[1] = y*(m_sizeY+m_sizeY0);
-      m_rippleVector[i][j].r = z;
+      v.dx[0] = x*m_sizeX;
+      v.dx[1] = y*(m_sizeY+m_sizeY0);
+      v.r = z;
+      if (z > m_rippleVectorMax) {
+        m_rippleVectorMax = z;
+      }
     }
   }
 }
@@ -230,54 +325,72 @@ void ripple :: precalc_ripple_amp(void)
 
 void ripple :: ripple_dynamics(void)
 {
-  int i, j, k;
-  int x, y;
-  int mi, mj;
-  int r;
-  float sx, sy;
+  int k;
   float amp;
 
-  for (i = 0; i < RIPPLE_COUNT; i++) {
-    m_t[i] += RIPPLE_STEP;
+  for (k = 0; k < RIPPLE_COUNT; k++) {
+    m_t[k] += RIPPLE_STEP;
+
+    /* once the wave has passed the whole grid, the amplitude table
+     * is 0 everywhere, and the ripple can be skipped */
+    if (m_t[k] - m_rippleVectorMax >= RIPPLE_LENGTH - 1) {
+      m_amp[k] = 0.f;
+      continue;
+    }
+    amp = 1.0 - 1.0*m_t[k]/RIPPLE_LENGTH;
+    amp *= amp;
+    if (amp < 0.0) {
+      amp = 0.0;
+    }
+    /* jmz: added m_height */
+    m_amp[k] = amp*m_height;
   }
 
-  for (i = 0; i < m_gridX; i++)
-    for (j = 0; j < m_gridY; j++)    {
-      m_rippleVertex[i][j].t[0] = m_rippleVertex[i][j].dt[0];
-      m_rippleVertex[i][j].t[1] = m_rippleVertex[i][j].dt[1];
-      for (k = 0; k < RIPPLE_COUNT; k++)      {
-        x = i - m_cx[k];
-        y = j - m_cy[k];
-        if (x < 0) {
-          x *= -1;
-          sx = -1.0;
-        } else {
-          sx = 1.0;
-        }
-        if (y < 0) {
-          y *= -1;
+  SliceJob job(this, &ripple::ripple_rows);
+  runJob(job, m_gridX, m_pool);
+}
+
+void ripple :: ripple_rows(unsigned int slice, unsigned int numSlices)
+{
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, m_gridX, start, stop);
+
+  for (int i = start; i < static_cast<int>(stop); i++) {
+    RIPPLE_VERTEX*row=&m_rippleVertex[i*m_gridY];
+    int j;
+    for (j = 0; j < m_gridY; j++) {
+      row[j].t[0] = row[j].dt[0];
+      row[j].t[1] = row[j].dt[1];
+    }
+    for (int k = 0; k < RIPPLE_COUNT; k++) {
+      if (0.f == m_amp[k]) {
+        continue;
+      }
+      /* the horizontal distance is the same for the whole row */
+      int mi = i - m_cx[k];
+      float sx = 1.0;
+      if (mi < 0) {
+        mi *= -1;
+        sx = -1.0;
+      }
+      if (mi >= m_gridX) {
+        mi = m_gridX - 1;
+      }
+      const RIPPLE_VECTOR*vec=&m_rippleVector[mi*m_gridY];
+      const float ampX = sx*m_amp[k];
+
+      for (j = 0; j < m_gridY; j++) {
+        int mj = j - m_cy[k];
+        float sy = 1.0;
+        if (mj < 0) {
+          mj *= -1;
           sy = -1.0;
-        } else {
-          sy = 1.0;
-        }
-        mi = x;
-        mj = y;
-        /* coverity[dead_error_line] <0 is a safety check (even if it never triggers) */
-        if(mi<0) {
-          mi=0;
-        }
-        if(mi>=m_gridX) {
-          mi=m_gridX-1;
         }
-        /* coverity[dead_error_line] <0 is a safety check (see above) */
-        if(mj<0) {
-          mj=0;
-        }
-        if(mj>=m_gridY) {
-          mj=m_gridY-1;
+        if (mj >= m_gridY) {
+          mj = m_gridY - 1;
         }
 
-        r = m_t[k] - m_rippleVector[mi][mj].r;
+        int r = m_t[k] - vec[mj].r;
         if (r < 0) {
           r = 0;
         }
@@ -285,18 +398,12 @@ void ripple :: ripple_dynamics(void)
           r = RIPPLE_LENGTH - 1;
         }
 
-        amp = 1.0 - 1.0*m_t[k]/RIPPLE_LENGTH;
-        amp *= amp;
-        if (amp < 0.0) {
-          amp = 0.0;
-        }
-        /* jmz: added m_height */
-        m_rippleVertex[i][j].t[0]
-        += m_rippleVector[mi][mj].dx[0]*sx*m_rippleAmp[r].amplitude*amp*m_height;
-        m_rippleVertex[i][j].t[1]
-        += m_rippleVector[mi][mj].dx[1]*sy*m_rippleAmp[r].amplitude*amp*m_height;
+        const float a = m_rippleAmp[r].amplitude;
+        row[j].t[0] += vec[mj].dx[0]*a*ampX;
+        row[j].t[1] += vec[mj].dx[1]*a*sy*m_amp[k];
       }
     }
+  }
 }
 /////////////////////////////////////////////////////////
 //
@@ -399,4 +506,48 @@ void ripple :: obj_setupCallback(t_class *classPtr)
   CPPEXTERN_MSG1(classPtr, "Ht", heightMess, float);
   CPPEXTERN_MSG1(classPtr, "cX", ctrXMess, float);
   CPPEXTERN_MSG1(classPtr, "cY", ctrYMess, float);
+
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
+  CPPEXTERN_MSG1(classPtr, "benchmark", benchmarkMess, int);
+}
+
+/////////////////////////////////////////////////////////
+// threadMess
+//
+/////////////////////////////////////////////////////////
+void ripple :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
+}
+
+/////////////////////////////////////////////////////////
+// benchmarkMess
+//   run the dynamics for a number of steps
+/////////////////////////////////////////////////////////
+void ripple :: benchmarkMess(int steps)
+{
+  if(steps<1) {
+    error("number of steps must be greater than 0");
+    return;
+  }
+  if(m_rippleVertex.empty()) {
+    /* not rendered yet; the grid is properly set up with the first frame */
+    m_sizeX = 1;
+    m_sizeY = 1;
+    m_sizeY0= 0;
+    ripple_init();
+    precalc_ripple_vector();
+  }
+  /* keep all the ripples busy */
+  for (int k = 0; k < RIPPLE_COUNT; k++) {
+    m_t[k] = 4*RIPPLE_STEP;
+  }
+  const double starttime=sys_getrealtime();
+  for(int i=0; i<steps; i++) {
+    ripple_dynamics();
+  }
+  const double duration=sys_getrealtime()-starttime;
+  post("benchmark: %dx%d grid, %d thread(s): %d steps in %f seconds (%f steps/sec)",
+       m_gridX, m_gridY, m_pool.getThreads(), steps, duration,
+       (duration>0.)?(steps/duration):0.);
 }
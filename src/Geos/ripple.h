@@ -14,8 +14,11 @@
 #define _INCLUDE__GEM_GEOS_RIPPLE_H_
 
 #include "Base/GemShape.h"
+#include "Gem/GridMesh.h"
+#include "Utils/ThreadPool.h"
 #include <string.h>
 #include <math.h>
+#include <vector>
 
 #ifdef __ppc__
 #include "Utils/Functions.h"
@@ -32,8 +35,8 @@
 #define GRID_SIZE_X   32
 #define GRID_SIZE_Y   32
 
-#define GRID_MAX_X   128
-#define GRID_MAX_Y   128
+#define GRID_MAX_X   1024
+#define GRID_MAX_Y   1024
 
 #define CLIP_NEAR  0.0
 #define CLIP_FAR   1000.0
@@ -65,6 +68,13 @@ typedef struct {
 
   DESCRIPTION
 
+  the ripples advance with each frame
+  (split into rows for the threads; see "threads")
+  the grid is drawn from a streaming vertex buffer
+
+  "threads" <n> - number of threads (0: one per CPU; default: 1)
+  "benchmark" <steps> - time the dynamics (without drawing; restarts the ripples)
+
   -----------------------------------------------------------------*/
 class GEM_EXTERN ripple : public GemShape
 {
@@ -91,8 +101,13 @@ protected:
   //////////
   // Do the rendering
   virtual void  renderShape(GemState *state);
+  virtual void  stopRendering(void);
 
   void  ripple_dynamics(void);
+  // the texture coordinates of a few rows
+  void  ripple_rows(unsigned int slice, unsigned int numSlices);
+  // write the vertices of a few rows into the vertex buffer
+  void  emit(unsigned int slice, unsigned int numSlices);
   void  ripple_init(void);
   float ripple_distance( int gx, int gy, int cx, int cy);
   int   ripple_max_distance( int gx, int gy );
@@ -116,9 +131,12 @@ protected:
 
   bool          m_alreadyInit;
   float         m_sizeX, m_sizeY, m_sizeY0;
-  RIPPLE_VECTOR m_rippleVector[GRID_MAX_X][GRID_MAX_Y];
+  // [i][j] lives at [i*m_gridY+j]
+  std::vector<RIPPLE_VECTOR> m_rippleVector;
   RIPPLE_AMP m_rippleAmp[RIPPLE_LENGTH];
-  RIPPLE_VERTEX m_rippleVertex[GRID_MAX_X][GRID_MAX_Y];
+  std::vector<RIPPLE_VERTEX> m_rippleVertex;
+  // the largest distance in m_rippleVector
+  int m_rippleVectorMax;
 
   int m_cx[RIPPLE_COUNT];
   int m_cy[RIPPLE_COUNT];
@@ -126,6 +144,18 @@ protected:
   int m_max[RIPPLE_COUNT];
 
   int m_rippleMax;
+
+  // the current amplitude of each ripple (0: ripple has died away)
+  float m_amp[RIPPLE_COUNT];
+
+  gem::thread::ThreadPool m_pool;
+  void threadMess(int threads);
+  void benchmarkMess(int steps);
+
+  gem::GridMesh m_mesh;
+  // the vertex buffer while it is filled
+  float*m_vertices;
+  bool m_textured;
 };
 
 #endif  // for header file
@@ -13,10 +13,79 @@
 
 #include "rubber.h"
 #include "Gem/State.h"
+#include "Utils/SIMD.h"
 
 #define GRID_SIZE_X  32
 #define GRID_SIZE_Y  32
 
+namespace
+{
+/* runs a member function of rubber on the slices of a job */
+class SliceJob : public gem::thread::ThreadPool::Job
+{
+public:
+  typedef void (rubber::*Method)(unsigned int, unsigned int);
+  rubber*obj;
+  Method method;
+  SliceJob(rubber*o, Method m)
+    : obj(o), method(m)
+  { }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    (obj->*method)(slice, numSlices);
+  }
+};
+
+void runJob(gem::thread::ThreadPool::Job&job, unsigned int size,
+            gem::thread::ThreadPool&pool)
+{
+  unsigned int numSlices=pool.getThreads();
+  if(numSlices>size) {
+    numSlices=size;
+  }
+  if(numSlices<2) {
+    job.process(0, 1);
+    return;
+  }
+  pool.run(job, numSlices);
+}
+
+#ifdef __SSE2__
+/* the SIMD versions process 4 masses at once, and return how many
+ * masses they have processed (the rest is left to the scalar code) */
+
+unsigned int springsSSE2(const float*x, float*v, unsigned int stride,
+                         unsigned int count, float ks)
+{
+  const __m128 four=_mm_set1_ps(4.f);
+  const __m128 k=_mm_set1_ps(ks);
+  unsigned int j=0;
+  for(; j+4<=count; j+=4) {
+    const __m128 x0=_mm_loadu_ps(x+j);
+    const __m128 sum=_mm_add_ps(_mm_add_ps(_mm_loadu_ps(x+j-stride),
+                                           _mm_loadu_ps(x+j+stride)),
+                                _mm_add_ps(_mm_loadu_ps(x+j-1),
+                                           _mm_loadu_ps(x+j+1)));
+    const __m128 force=_mm_mul_ps(k, _mm_sub_ps(sum, _mm_mul_ps(four, x0)));
+    _mm_storeu_ps(v+j, _mm_add_ps(_mm_loadu_ps(v+j), force));
+  }
+  return j;
+}
+
+unsigned int moveSSE2(float*x, float*v, unsigned int count, float damp)
+{
+  const __m128 d=_mm_set1_ps(damp);
+  unsigned int j=0;
+  for(; j+4<=count; j+=4) {
+    const __m128 vel=_mm_loadu_ps(v+j);
+    _mm_storeu_ps(x+j, _mm_add_ps(_mm_loadu_ps(x+j), vel));
+    _mm_storeu_ps(v+j, _mm_mul_ps(vel, d));
+  }
+  return j;
+}
+#endif /* __SSE2__ */
+};
+
 CPPEXTERN_NEW_WITH_TWO_ARGS(rubber, t_floatarg, A_DEFFLOAT, t_floatarg,
                             A_DEFFLOAT);
 
@@ -38,8 +107,7 @@ rubber :: rubber( t_floatarg gridX, t_floatarg gridY )
     m_springKS(0.3), m_drag(0.5),
     xsize(0.), ysize(0.), ysize0(0.),
     m_grid_sizeX(GRID_SIZE_X), m_grid_sizeY(GRID_SIZE_Y),
-    m_mass(NULL), m_spring(NULL),
-    m_spring_count(0)
+    m_vertices(NULL)
 {
   int gridXi=static_cast<int>(gridX);
   int gridYi=static_cast<int>(gridY);
@@ -89,68 +157,29 @@ void rubber :: ctrYMess(float center)
 
 void rubber :: rubber_init(void)
 {
-  int k;
-
-  if (m_mass != NULL) {
-    delete[]m_mass;
+  const int size=m_grid_sizeX*m_grid_sizeY;
+  for (int c = 0; c < 3; c++) {
+    m_x[c].assign(size, 0.f);
+    m_v[c].assign(size, 0.f);
   }
-  m_mass=NULL;
+  m_t[0].assign(size, 0.f);
+  m_t[1].assign(size, 0.f);
+  m_mesh.setSize(m_grid_sizeX, m_grid_sizeY);
 
-  m_mass = new MASS[m_grid_sizeX*m_grid_sizeY];
-  if (m_mass == NULL)    {
-    error("can't allocate memory for masses.\n");
-    return;
-  }
-
-  k = 0;
+  int k = 0;
   for (int i = 0; i < m_grid_sizeX; i++)
     for (int j = 0; j < m_grid_sizeY; j++) {
-      m_mass[k].nail = (i == 0 || j == 0 || i == m_grid_sizeX -1
-                        || j == m_grid_sizeY - 1 );
-      m_mass[k].x[0] = ((i/(m_grid_sizeX-1.0)) - 0.5);
-      m_mass[k].x[1] = ((j/(m_grid_sizeY-1.0)) - 0.5);
-      m_mass[k].x[2] = 0;
+      m_x[0][k] = ((i/(m_grid_sizeX-1.0)) - 0.5);
+      m_x[1][k] = ((j/(m_grid_sizeY-1.0)) - 0.5);
 
-      m_mass[k].v[0] = 0.0;
-      m_mass[k].v[1] = 0.0;
-      m_mass[k].v[2] = 0.0;
-
-      m_mass[k].t[0] = xsize*( i/(m_grid_sizeX - 1.0) );
-      m_mass[k].t[1] = (ysize0-ysize)*( j/(m_grid_sizeY - 1.0) )+ysize;
+      m_t[0][k] = xsize*( i/(m_grid_sizeX - 1.0) );
+      m_t[1][k] = (ysize0-ysize)*( j/(m_grid_sizeY - 1.0) )+ysize;
 
       k++;
     }
-
-  if (m_spring != NULL) {
-    delete[]m_spring;
+  if (m_grab >= size) {
+    m_grab = -1;
   }
-  m_spring_count = (m_grid_sizeX - 1)*(m_grid_sizeY - 2)
-                   + (m_grid_sizeY - 1)*(m_grid_sizeX - 2);
-
-  m_spring=new SPRING[m_spring_count];
-  if (m_spring == NULL)    {
-    error("can't allocate memory for springs.\n");
-    return;
-  }
-
-  k = 0;
-  for (int i = 1; i < m_grid_sizeX - 1; i++)
-    for (int j = 0; j < m_grid_sizeY - 1; j++) {
-      int m = m_grid_sizeY*i + j;
-      m_spring[k].i = m;
-      m_spring[k].j = m + 1;
-      m_spring[k].r = 0;
-      k++;
-    }
-
-  for (int j = 1; j < m_grid_sizeY - 1; j++)
-    for (int i = 0; i < m_grid_sizeX - 1; i++) {
-      int m = m_grid_sizeY*i + j;
-      m_spring[k].i = m;
-      m_spring[k].j = m + m_grid_sizeX;
-      m_spring[k].r = 0.0;
-      k++;
-    }
 }
 
 /////////////////////////////////////////////////////////
@@ -159,9 +188,9 @@ void rubber :: rubber_init(void)
 /////////////////////////////////////////////////////////
 void rubber :: renderShape(GemState *state)
 {
-  int k, i, j;
+  const bool textured=(GemShape::m_texType && GemShape::m_texNum>=3);
 
-  if (GemShape::m_texType && GemShape::m_texNum>=3) {
+  if (textured) {
 
     if ((xsize  != GemShape::m_texCoords[1].s) ||
         (ysize  != GemShape::m_texCoords[1].t) ||
@@ -177,125 +206,199 @@ void rubber :: renderShape(GemState *state)
       rubber_init();
       m_alreadyInit = 1;
     }
-
-    k = 0;
-    for (i = 0; i < m_grid_sizeX - 1; i++)  {
-      for (j = 0; j < m_grid_sizeY - 1; j++) {
-        glBegin(GL_POLYGON);
-
-        glTexCoord2fv( m_mass[k].t);
-        glVertex3f( m_mass[k].x[0]*m_size, m_mass[k].x[1]*m_size, m_mass[k].x[2] );
-        glTexCoord2fv( m_mass[k + 1].t );
-        glVertex3f( m_mass[k + 1].x[0]*m_size, m_mass[k + 1].x[1]*m_size,
-                    m_mass[k + 1].x[2] );
-        glTexCoord2fv( m_mass[k + m_grid_sizeY + 1].t );
-        glVertex3f( m_mass[k + m_grid_sizeY + 1].x[0]*m_size,
-                    m_mass[k + m_grid_sizeY + 1].x[1]*m_size,
-                    m_mass[k + m_grid_sizeY + 1].x[2] );
-        glTexCoord2fv( m_mass[k + m_grid_sizeY].t );
-        glVertex3f( m_mass[k + m_grid_sizeY].x[0]*m_size,
-                    m_mass[k + m_grid_sizeY].x[1]*m_size,
-                    m_mass[k + m_grid_sizeY].x[2] );
-        glEnd();
-        k++;
-      }
-      k++;
-    }
-    rubber_dynamics();
   } else {
     if (!m_alreadyInit) {
       rubber_init();
       m_alreadyInit = 1;
     }
+  }
+  /* textured, the cells are always filled */
+  const GLenum mode = textured?GL_POLYGON:m_drawType;
+
+  m_vertices=m_mesh.map();
+  if(m_vertices) {
+    SliceJob emitJob(this, &rubber::emit);
+    runJob(emitJob, m_grid_sizeX, m_pool);
+    m_mesh.unmap();
+    m_vertices=NULL;
+    if(m_mesh.draw(mode, gem::GridMesh::CELLS)) {
+      rubber_dynamics();
+      return;
+    }
+  }
 
-    k = 0;
-    for (i = 0; i < m_grid_sizeX - 1; i++)  {
-      for (j = 0; j < m_grid_sizeY - 1; j++) {
-        glBegin(m_drawType);
-        glTexCoord2fv( m_mass[k].t );
-        glVertex3f( m_mass[k].x[0]*m_size, m_mass[k].x[1]*m_size, m_mass[k].x[2] );
-        glTexCoord2fv( m_mass[k + 1].t );
-        glVertex3f( m_mass[k + 1].x[0]*m_size, m_mass[k + 1].x[1]*m_size,
-                    m_mass[k + 1].x[2] );
-        glTexCoord2fv( m_mass[k + m_grid_sizeY + 1].t );
-        glVertex3f( m_mass[k + m_grid_sizeY + 1].x[0]*m_size,
-                    m_mass[k + m_grid_sizeY + 1].x[1]*m_size,
-                    m_mass[k + m_grid_sizeY + 1].x[2] );
-        glTexCoord2fv( m_mass[k + m_grid_sizeY].t );
-        glVertex3f( m_mass[k + m_grid_sizeY].x[0]*m_size,
-                    m_mass[k + m_grid_sizeY].x[1]*m_size,
-                    m_mass[k + m_grid_sizeY].x[2] );
-        glEnd();
-        k++;
+  /* no vertex buffers: immediate mode */
+  const int gy=m_grid_sizeY;
+  for (int i = 0; i < m_grid_sizeX - 1; i++)  {
+    for (int j = 0; j < gy - 1; j++) {
+      const int k = i*gy + j;
+      const int corner[4] = { k, k + 1, k + gy + 1, k + gy };
+      glBegin(mode);
+      for (int n = 0; n < 4; n++) {
+        const int m = corner[n];
+        glTexCoord2f( m_t[0][m], m_t[1][m] );
+        glVertex3f( m_x[0][m]*m_size, m_x[1][m]*m_size, m_x[2][m] );
       }
-      k++;
+      glEnd();
     }
-    rubber_dynamics();
-    /*      for (k = 0; k < spring_count; k++)
-            {
-            glBegin(GL_LINES);
-            glVertex3fv(mass[spring[k].i].x);
-            glVertex3fv(mass[spring[k].j].x);
-            glEnd();
-            }
-            }
-    */
   }
+  rubber_dynamics();
+}
+
+/////////////////////////////////////////////////////////
+// stopRendering
+//
+/////////////////////////////////////////////////////////
+void rubber :: stopRendering(void)
+{
+  m_mesh.release();
 }
+
+/////////////////////////////////////////////////////////
+// emit
+//   the normals are taken from the neighbouring masses
+/////////////////////////////////////////////////////////
+void rubber :: emit(unsigned int slice, unsigned int numSlices)
+{
+  const unsigned int stride=gem::GridMesh::STRIDE;
+  const int gx=m_grid_sizeX, gy=m_grid_sizeY;
+  const float scale[3] = { m_size, m_size, 1.f };
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, gx, start, stop);
+
+  for (int i = start; i < static_cast<int>(stop); i++) {
+    const int prev=(i>0)?(i-1):i;
+    const int next=(i<gx-1)?(i+1):i;
+    for (int j = 0; j < gy; j++) {
+      const int k = i*gy + j;
+      const int left  = k - ((j>0)?1:0);
+      const int right = k + ((j<gy-1)?1:0);
+      float du[3], dv[3];
+      float*v=m_vertices+k*stride;
+      for (int c = 0; c < 3; c++) {
+        const float*x=&m_x[c][0];
+        v[c] = x[k]*scale[c];
+        du[c] = (x[next*gy + j] - x[prev*gy + j])*scale[c];
+        dv[c] = (x[right] - x[left])*scale[c];
+      }
+      float n[3] = {
+        du[1]*dv[2] - du[2]*dv[1],
+        du[2]*dv[0] - du[0]*dv[2],
+        du[0]*dv[1] - du[1]*dv[0]
+      };
+      const float l = sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+      if (l > 0.f) {
+        n[0] /= l;
+        n[1] /= l;
+        n[2] /= l;
+      } else {
+        n[0] = n[1] = 0.f;
+        n[2] = 1.f;
+      }
+      v[3] = n[0];
+      v[4] = n[1];
+      v[5] = n[2];
+      v[6] = m_t[0][k];
+      v[7] = m_t[1][k];
+    }
+  }
+}
+
 /*
   Do the dynamics simulation for the next frame.
+
+  the springs (with a rest length of 0) pull each mass towards
+  its neighbours, so the force is simply the sum of the distances
+  (gathered per mass, so the rows can be processed independently)
 */
 
 void rubber :: rubber_dynamics(void)
 {
-  /* calculate all the spring forces acting on the mass points */
-
-  for (int k = 0; k < m_spring_count; k++) {
-    float d[3];
-    int i = m_spring[k].i;
-    int j = m_spring[k].j;
-
-    d[0] = m_mass[i].x[0] - m_mass[j].x[0];
-    d[1] = m_mass[i].x[1] - m_mass[j].x[1];
-    d[2] = m_mass[i].x[2] - m_mass[j].x[2];
-
-    float l = sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
-    if (l != 0.0) {
-      d[0] /= l;
-      d[1] /= l;
-      d[2] /= l;
+  if (m_x[0].empty()) {
+    return;
+  }
 
-      float a = l - m_spring[k].r;
+  /* calculate all the spring forces acting on the mass points */
+  SliceJob springJob(this, &rubber::rubber_springs);
+  runJob(springJob, m_grid_sizeX, m_pool);
 
-      m_mass[i].v[0] -= d[0]*a*m_springKS;
-      m_mass[i].v[1] -= d[1]*a*m_springKS;
-      m_mass[i].v[2] -= d[2]*a*m_springKS;
+  /* update the state of the mass points */
+  SliceJob moveJob(this, &rubber::rubber_move);
+  runJob(moveJob, m_grid_sizeX, m_pool);
 
-      m_mass[j].v[0] += d[0]*a*m_springKS;
-      m_mass[j].v[1] += d[1]*a*m_springKS;
-      m_mass[j].v[2] += d[2]*a*m_springKS;
+  /* if a mass point is grabbed, attach it to the mouse */
+  if (m_grab != -1) {
+    const int i = m_grab / m_grid_sizeY;
+    const int j = m_grab % m_grid_sizeY;
+    const bool nail = (i == 0 || j == 0 || i == m_grid_sizeX -1
+                       || j == m_grid_sizeY - 1 );
+    if (!nail) {
+      m_x[0][m_grab] = ctrX;
+      m_x[1][m_grab] = ctrY;
+      m_x[2][m_grab] = m_height;
     }
   }
+}
 
-  /* update the state of the mass points */
-
-  for (int k = 0; k < m_grid_sizeX*m_grid_sizeY; k++)
-    if (!m_mass[k].nail) {
-      m_mass[k].x[0] += m_mass[k].v[0];
-      m_mass[k].x[1] += m_mass[k].v[1];
-      m_mass[k].x[2] += m_mass[k].v[2];
-
-      m_mass[k].v[0] *= (1.0 - m_drag);
-      m_mass[k].v[1] *= (1.0 - m_drag);
-      m_mass[k].v[2] *= (1.0 - m_drag);
+void rubber :: rubber_springs(unsigned int slice, unsigned int numSlices)
+{
+  const int gx=m_grid_sizeX, gy=m_grid_sizeY;
+  const float ks=m_springKS;
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, gx, start, stop);
+#ifdef __SSE2__
+  const bool simd=(GEM_SIMD_SSE2 == GemSIMD::getCPU());
+#endif
+
+  for (int i = start; i < static_cast<int>(stop); i++) {
+    /* the masses on the border are nailed down */
+    if (i < 1 || i >= gx - 1) {
+      continue;
     }
+    for (int c = 0; c < 3; c++) {
+      const float*x=&m_x[c][i*gy];
+      float*v=&m_v[c][i*gy];
+      int j = 1;
+#ifdef __SSE2__
+      if (simd) {
+        j += springsSSE2(x+1, v+1, gy, gy-2, ks);
+      }
+#endif
+      for (; j < gy - 1; j++) {
+        v[j] += ks*(x[j-gy] + x[j+gy] + x[j-1] + x[j+1] - 4.f*x[j]);
+      }
+    }
+  }
+}
 
-  /* if a mass point is grabbed, attach it to the mouse */
-
-  if (m_grab != -1 && !m_mass[m_grab].nail) {
-    m_mass[m_grab].x[0] = ctrX;
-    m_mass[m_grab].x[1] = ctrY;
-    m_mass[m_grab].x[2] = m_height;
+void rubber :: rubber_move(unsigned int slice, unsigned int numSlices)
+{
+  const int gx=m_grid_sizeX, gy=m_grid_sizeY;
+  const float damp=1.0 - m_drag;
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, gx, start, stop);
+#ifdef __SSE2__
+  const bool simd=(GEM_SIMD_SSE2 == GemSIMD::getCPU());
+#endif
+
+  for (int i = start; i < static_cast<int>(stop); i++) {
+    if (i < 1 || i >= gx - 1) {
+      continue;
+    }
+    for (int c = 0; c < 3; c++) {
+      float*x=&m_x[c][i*gy];
+      float*v=&m_v[c][i*gy];
+      int j = 1;
+#ifdef __SSE2__
+      if (simd) {
+        j += moveSSE2(x+1, v+1, gy-2, damp);
+      }
+#endif
+      for (; j < gy - 1; j++) {
+        x[j] += v[j];
+        v[j] *= damp;
+      }
+    }
   }
 }
 
@@ -309,9 +412,12 @@ int rubber :: rubber_grab(void)
   float min_d=0;
   int min_i=0;
 
+  if (m_x[0].empty()) {
+    return -1;
+  }
   for (int i = 0; i < m_grid_sizeX*m_grid_sizeY; i++) {
-    float dx0 = m_mass[i].x[0] - ctrX;
-    float dx1 = m_mass[i].x[1] - ctrY;
+    float dx0 = m_x[0][i] - ctrX;
+    float dx1 = m_x[1][i] - ctrY;
     float d = sqrt(dx0*dx0 + dx1*dx1);
     if (i == 0 || d < min_d) {
       min_i = i;
@@ -355,6 +461,9 @@ void rubber :: obj_setupCallback(t_class *classPtr)
 
   CPPEXTERN_MSG1(classPtr, "drag", dragMess, float);
   CPPEXTERN_MSG1(classPtr, "spring", springMess, float);
+
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
+  CPPEXTERN_MSG1(classPtr, "benchmark", benchmarkMess, int);
 }
 void rubber :: dragMess(float drag)
 {
@@ -364,3 +473,30 @@ void rubber :: springMess(float spring)
 {
   m_springKS=spring;
 }
+void rubber :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
+}
+
+/////////////////////////////////////////////////////////
+// benchmarkMess
+//   run the simulation for a number of steps
+/////////////////////////////////////////////////////////
+void rubber :: benchmarkMess(int steps)
+{
+  if(steps<1) {
+    error("number of steps must be greater than 0");
+    return;
+  }
+  if(m_x[0].empty()) {
+    rubber_init();
+  }
+  const double starttime=sys_getrealtime();
+  for(int i=0; i<steps; i++) {
+    rubber_dynamics();
+  }
+  const double duration=sys_getrealtime()-starttime;
+  post("benchmark: %dx%d grid, %d thread(s): %d steps in %f seconds (%f steps/sec)",
+       m_grid_sizeX, m_grid_sizeY, m_pool.getThreads(), steps, duration,
+       (duration>0.)?(steps/duration):0.);
+}
@@ -15,6 +15,9 @@
 #define _INCLUDE__GEM_GEOS_RUBBER_H_
 
 #include "Base/GemShape.h"
+#include "Gem/GridMesh.h"
+#include "Utils/ThreadPool.h"
+#include <vector>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -26,18 +29,6 @@
 #define sqrt fast_sqrtf
 #endif
 
-typedef struct {
-  float x[3];
-  float v[3];
-  float t[2];
-  int nail;
-} MASS;
-
-typedef struct {
-  int i, j;
-  float r;
-} SPRING;
-
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
 CLASS
@@ -50,6 +41,16 @@ KEYWORDS
 
 DESCRIPTION
 
+    a grid of masses, each connected to its 4 direct neighbours with springs
+    (the masses on the border are nailed down)
+
+    the simulation advances with each frame
+    (split into rows for the threads; see "threads")
+    the grid is drawn from a streaming vertex buffer
+
+    "threads" <n> - number of threads (0: one per CPU; default: 1)
+    "benchmark" <steps> - time the simulation (without drawing)
+
 -----------------------------------------------------------------*/
 class GEM_EXTERN rubber : public GemShape
 {
@@ -77,12 +78,21 @@ protected:
   //////////
   // Do the rendering
   virtual void  renderShape(GemState *state);
+  virtual void  stopRendering(void);
 
   virtual void  rubber_init();
   virtual void  rubber_dynamics();
   virtual void  rubber_bang();
   virtual int   rubber_grab();
 
+  // the steps of rubber_dynamics() for a few rows
+  //  accelerate the masses by the spring forces
+  void  rubber_springs(unsigned int slice, unsigned int numSlices);
+  //  move the masses
+  void  rubber_move(unsigned int slice, unsigned int numSlices);
+  // write the vertices of a few rows into the vertex buffer
+  void  emit(unsigned int slice, unsigned int numSlices);
+
   //////////
   // The height of the object
   GLfloat               m_height;
@@ -106,9 +116,17 @@ protected:
 
   // number of grid-segments in X/Y direction (defaults: 32);
   int           m_grid_sizeX,m_grid_sizeY;
-  MASS          *m_mass;
-  SPRING        *m_spring;
-  int           m_spring_count;
+  // position, velocity and texture coordinates of the masses
+  // ([i][j] lives at [i*m_grid_sizeY+j])
+  std::vector<float> m_x[3], m_v[3], m_t[2];
+
+  gem::thread::ThreadPool m_pool;
+  void  threadMess(int threads);
+  void  benchmarkMess(int steps);
+
+  gem::GridMesh m_mesh;
+  // the vertex buffer while it is filled
+  float         *m_vertices;
 
   void  dragMess(float);
   void  springMess(float);
@@ -21,6 +21,11 @@
 
 CPPEXTERN_NEW_NAMED_WITH_ONE_ARG(scopeXYZ, "scopeXYZ~", t_floatarg, A_DEFFLOAT);
 
+namespace
+{
+const unsigned int MAX_LATENCY = 128;
+};
+
 /////////////////////////////////////////////////////////
 //
 // scopeXYZ
@@ -34,6 +39,7 @@ scopeXYZ :: scopeXYZ(t_floatarg len)
   , m_blocksize(64), m_length(64)
   , m_position(0)
   , m_vertices(64, 3)
+  , m_latency(32)
 {
   lengthMess(static_cast<int>(len));
 
@@ -72,10 +78,28 @@ void scopeXYZ :: lengthMess(int l)
 }
 void scopeXYZ :: setBlocksize(unsigned int bs)
 {
+  /* the DSP-chain is not running, so we can safely reallocate the ring */
+  if(bs != m_blocksize || !m_samples.capacity()) {
+    m_samples.resize(MAX_LATENCY * 3 * bs);
+    m_block.resize(3 * bs);
+  }
   m_blocksize = bs;
   m_vertices.enabled = true;
   doLengthMess(m_length);
 }
+void scopeXYZ :: latencyMess(int blocks)
+{
+  if(blocks < 1 || static_cast<unsigned int>(blocks) > MAX_LATENCY) {
+    error("latency must be between 1 and %d blocks", MAX_LATENCY);
+    return;
+  }
+  m_latency = blocks;
+}
+void scopeXYZ :: statsMess(void)
+{
+  post("stats: %lu underrun(s), %lu overrun(s)",
+       m_samples.underruns(), m_samples.overruns());
+}
 
 /////////////////////////////////////////////////////////
 // renderShape
@@ -83,6 +107,17 @@ void scopeXYZ :: setBlocksize(unsigned int bs)
 /////////////////////////////////////////////////////////
 void scopeXYZ :: renderShape(GemState *state)
 {
+  /* apply all the blocks since the last frame */
+  const unsigned int n = m_blocksize;
+  if(m_samples.capacity()) {
+    if(m_samples.readable() < 3*n) {
+      m_samples.underrun();
+    }
+    while(m_samples.read(&m_block[0], 3*n)) {
+      processBlock(n, &m_block[0], &m_block[n], &m_block[2*n]);
+    }
+  }
+
   float*vertices=m_vertices.array+3*m_position;
   int count=m_length/2;
   GLenum typ=GL_FLOAT;
@@ -193,6 +228,8 @@ void scopeXYZ :: obj_setupCallback(t_class *classPtr)
   CPPEXTERN_MSG0(classPtr, "bang", bangMess);
   CPPEXTERN_MSG1(classPtr, "linewidth", linewidthMess, float);
   CPPEXTERN_MSG1(classPtr, "length", lengthMess, int);
+  CPPEXTERN_MSG1(classPtr, "latency", latencyMess, int);
+  CPPEXTERN_MSG0(classPtr, "stats", statsMess);
 
   class_addmethod(classPtr,
       reinterpret_cast<t_method>(&scopeXYZ::dspCallback),
@@ -208,6 +245,21 @@ void scopeXYZ ::  dspCallback(void *data,t_signal** sp)
 
 void scopeXYZ :: perform(unsigned int count, t_sample*X, t_sample*Y,
                          t_sample*Z)
+{
+  const size_t blocksize = 3*count;
+  const size_t queued = m_samples.capacity() - m_samples.writable();
+  if(count != m_blocksize || queued + blocksize > m_latency * blocksize) {
+    m_samples.overrun();
+    return;
+  }
+  m_samples.write(X, count);
+  m_samples.write(Y, count);
+  m_samples.write(Z, count);
+  m_samples.publish();
+}
+
+void scopeXYZ :: processBlock(unsigned int count, t_sample*X, t_sample*Y,
+                              t_sample*Z)
 {
   int position=m_position;
   float*vertices = m_vertices.array;
@@ -17,6 +17,9 @@
 
 #include "Base/GemShape.h"
 #include "Gem/VertexBuffer.h"
+#include "Utils/ThreadRing.h"
+
+#include <vector>
 
 
 /*-----------------------------------------------------------------
@@ -35,6 +38,11 @@
   Inlet~ for signal Y
   Inlet~ for signal Z
 
+  "latency" <blocks> - number of DSP blocks (1..128) that can be queued
+                       between two frames (default: 32)
+  "stats" - print the number of underruns (frames without new blocks)
+            and overruns (blocks dropped because the render lagged behind)
+
   -----------------------------------------------------------------*/
 class GEM_EXTERN scopeXYZ : public GemShape
 {
@@ -83,7 +91,19 @@ protected:
   t_inlet*m_inX, *m_inY, *m_inZ;
 
 
+  //////////
+  // the blocks on their way from the DSP to the render
+  // (each is 3 channels of m_blocksize samples)
+  gem::thread::ThreadRing<t_sample> m_samples;
+  std::vector<t_sample> m_block;
+  unsigned int m_latency;
+  void latencyMess(int blocks);
+  void statsMess(void);
+
+  // DSP perform: pass the block on to the render
   void perform(unsigned int count, t_sample*X, t_sample*Y, t_sample*Z);
+  // write a block of signals into the vertices
+  void processBlock(unsigned int count, t_sample*X, t_sample*Y, t_sample*Z);
 
 private:
 
@@ -16,6 +16,7 @@
 
 #include "sphere.h"
 #include "Gem/State.h"
+#include "Gem/Mesh.h"
 CPPEXTERN_NEW_WITH_TWO_ARGS(sphere, t_floatarg, A_DEFFLOAT, t_floatarg,
                             A_DEFFLOAT);
 
@@ -235,12 +236,13 @@ void sphere :: createSphere(GemState *state)
 
 }
 /////////////////////////////////////////////////////////
-// render
+// buildMesh
 //
 /////////////////////////////////////////////////////////
-void sphere :: renderShape(GemState *state)
+void sphere :: buildMesh(GemState *state, gem::MeshBuilder&mesh)
 {
-  GLdouble radius=m_size;
+  /* unit size, the geometry is scaled when drawing */
+  GLdouble radius=1.;
   GLint slices=(m_numSlices>0)?m_numSlices:10;
   GLint stacks=(m_numStacks>0)?m_numStacks:10;
 
@@ -256,11 +258,9 @@ void sphere :: renderShape(GemState *state)
   TexCoord*texCoords=NULL;
   int texType=0;
   int texNum=0;
-  bool lighting=false;
   state->get(GemState::_GL_TEX_COORDS, texCoords);
   state->get(GemState::_GL_TEX_TYPE, texType);
   state->get(GemState::_GL_TEX_NUMCOORDS, texNum);
-  state->get(GemState::_GL_LIGHTING, lighting);
 
   GLfloat xsize = 1.0, xsize0 = 0.0;
   GLfloat ysize = 1.0, ysize0 = 0.0;
@@ -295,17 +295,15 @@ void sphere :: renderShape(GemState *state)
     src = 0;
     if (!texType) {
       /* draw +Z end as a triangle fan */
-      glBegin(GL_TRIANGLE_FAN);
-      glNormal3f(0.0, 0.0, 1.0);
-      glVertex3f(0.0, 0.0, nsign * radius);
+      mesh.begin(GL_TRIANGLE_FAN);
+      mesh.normal(0.0, 0.0, 1.0);
+      mesh.vertex(0.0, 0.0, nsign * radius);
       for (j = 0; j <= slices; j++) {
-        if (lighting) {
-          glNormal3f(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
-        }
-        glVertex3f(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
+        mesh.normal(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
+        mesh.vertex(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
         src++;
       }
-      glEnd();
+      mesh.end();
     }
 
     ds = 1.0 / slices;
@@ -321,48 +319,42 @@ void sphere :: renderShape(GemState *state)
 
     /* draw intermediate stacks as quad strips */
     for (i = imin; i < imax; i++) {
-      glBegin(GL_QUAD_STRIP);
+      mesh.begin(GL_QUAD_STRIP);
       s = 0.0;
       for (j = 0; j <= slices; j++) {
 
-        if (lighting) {
-          glNormal3f(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
-        }
+        mesh.normal(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
         if(texType) {
-          glTexCoord2f(s*xsize+xsize0, t*ysize+ysize0);
+          mesh.texcoord(s*xsize+xsize0, t*ysize+ysize0);
         }
-        glVertex3f(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
+        mesh.vertex(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
         src++;
-        if (lighting) {
-          glNormal3f(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
-        }
+        mesh.normal(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
         if(texType) {
-          glTexCoord2f(s*xsize+xsize0, (t - dt)*ysize+ysize0);
+          mesh.texcoord(s*xsize+xsize0, (t - dt)*ysize+ysize0);
         }
         s += ds;
-        glVertex3f(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
+        mesh.vertex(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
         src++;
       }
-      glEnd();
+      mesh.end();
       t -= dt;
     }
 
     if (!texType) {
       /* draw -Z end as a triangle fan */
-      glBegin(GL_TRIANGLE_FAN);
-      glNormal3f(0.0, 0.0, -1.0);
-      glVertex3f(0.0, 0.0, -radius * nsign);
+      mesh.begin(GL_TRIANGLE_FAN);
+      mesh.normal(0.0, 0.0, -1.0);
+      mesh.vertex(0.0, 0.0, -radius * nsign);
       s = 1.0;
       t = dt;
       for (j = slices; j >= 0; j--) {
-        if (lighting) {
-          glNormal3f(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
-        }
+        mesh.normal(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
         s -= ds;
-        glVertex3f(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
+        mesh.vertex(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
         src++;
       }
-      glEnd();
+      mesh.end();
     }
   } else if (m_drawType == GL_LINE || m_drawType == GLU_SILHOUETTE) {
 
@@ -370,57 +362,47 @@ void sphere :: renderShape(GemState *state)
 
     for (i = 1; i < stacks;
          i++) {    // stack line at i==stacks-1 was missing here
-      glBegin(GL_LINE_LOOP);
+      mesh.begin(GL_LINE_LOOP);
       for (j = 0; j < slices; j++) {
 
-        if (lighting) {
-          glNormal3f(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
-        }
-        glVertex3f(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
+        mesh.normal(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
+        mesh.vertex(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
         src++;
       }
-      glEnd();
+      mesh.end();
     }
 
     for (j = 0; j < slices; j++) {
-      glBegin(GL_LINE_STRIP);
+      mesh.begin(GL_LINE_STRIP);
       for (i = 0; i <= stacks; i++) {
 
-        if (lighting) {
-          glNormal3f(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
-        }
-        glVertex3f(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
+        mesh.normal(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
+        mesh.vertex(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
         src++;
       }
-      glEnd();
+      mesh.end();
     }
   }
 
   else if (m_drawType == GL_POINT) {
     /* top and bottom-most points */
-    glBegin(GL_POINTS);
-    if (lighting) {
-      glNormal3f(0.0, 0.0, nsign);
-    }
-    glVertex3d(0.0, 0.0, radius);
-    if (lighting) {
-      glNormal3f(0.0, 0.0, -nsign);
-    }
-    glVertex3d(0.0, 0.0, -radius);
+    mesh.begin(GL_POINTS);
+    mesh.normal(0.0, 0.0, nsign);
+    mesh.vertex(0.0, 0.0, radius);
+    mesh.normal(0.0, 0.0, -nsign);
+    mesh.vertex(0.0, 0.0, -radius);
 
     src = 0;
 
     for (i = 1; i < stacks - 1; i++) {
       rho = i * drho;
       for (j = 0; j < slices; j++) {
-        if (lighting) {
-          glNormal3f(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
-        }
-        glVertex3f(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
+        mesh.normal(m_x[src] * nsign, m_y[src] * nsign, m_z[src] * nsign);
+        mesh.vertex(m_x[src] * radius, m_y[src] * radius, m_z[src] * radius);
         src++;
       }
     }
-    glEnd();
+    mesh.end();
   }
 }
 /////////////////////////////////////////////////////////
@@ -30,6 +30,57 @@ struct t_float3 {
 CPPEXTERN_NEW_WITH_TWO_ARGS(surface3d, t_floatarg, A_DEFFLOAT, t_floatarg,
                             A_DEFFLOAT);
 
+namespace
+{
+/* the same bicubic interpolation as surface3d::bicubic3(),
+ * with the normal from the analytic derivatives
+ * vertex [i][j] is the point (i/grid.x, j/grid.y) of the surface
+ */
+const char*s_shader =
+  "uniform vec2 controls;\n"
+  "uniform vec2 grid;\n"
+  "uniform vec2 texBase;\n"
+  "uniform vec2 texScale;\n"
+  "uniform bool normals;\n"
+  "vec3 point(vec2 p) {\n"
+  "  return texture2DLod(displacement, (p + .5) / controls, 0.).xyz;\n"
+  "}\n"
+  "vec4 weights(float t) {\n"
+  "  float t2 = t * t, t3 = t2 * t;\n"
+  "  return vec4(-.5 * t3 + t2 - .5 * t, 1.5 * t3 - 2.5 * t2 + 1.,\n"
+  "              -1.5 * t3 + 2. * t2 + .5 * t, .5 * t3 - .5 * t2);\n"
+  "}\n"
+  "vec4 slopes(float t) {\n"
+  "  float t2 = t * t;\n"
+  "  return vec4(-1.5 * t2 + 2. * t - .5, 4.5 * t2 - 5. * t,\n"
+  "              -4.5 * t2 + 4. * t + .5, 1.5 * t2 - t);\n"
+  "}\n"
+  "void main(void) {\n"
+  "  vec2 uv = gl_Vertex.xy / grid;\n"
+  "  vec2 f = 1. + uv * (controls - 3.);\n"
+  "  vec2 i = floor(f);\n"
+  "  f -= i;\n"
+  "  vec4 wx = weights(f.x), dx = slopes(f.x);\n"
+  "  vec4 wy = weights(f.y), dy = slopes(f.y);\n"
+  "  mat4x3 rows, drows;\n"
+  "  for(int k = 0; k < 4; k++) {\n"
+  "    vec2 c = i + vec2(-1., float(k - 1));\n"
+  "    mat4x3 row = mat4x3(point(c), point(c + vec2(1., 0.)),\n"
+  "                        point(c + vec2(2., 0.)), point(c + vec2(3., 0.)));\n"
+  "    rows[k] = row * wx;\n"
+  "    drows[k] = row * dx;\n"
+  "  }\n"
+  "  vec4 position = vec4(rows * wy, 1.);\n"
+  "  vec3 normal = vec3(0., 0., 1.);\n"
+  "  if(normals) {\n"
+  "    normal = normalize(cross(drows * wy, rows * dy));\n"
+  "  }\n"
+  "  gl_Position = gl_ModelViewProjectionMatrix * position;\n"
+  "  gl_TexCoord[0] = gl_TextureMatrix[0] * vec4(texBase + texScale * uv, 0., 1.);\n"
+  "  gl_FrontColor = lit(gl_Color, normal, position);\n"
+  "}\n";
+};
+
 
 /////////////////////////////////////////////////////////
 //
@@ -44,7 +95,10 @@ surface3d :: surface3d(t_floatarg sizeX,t_floatarg sizeY )
     nb_pts_control_X(4), nb_pts_control_Y(4),
     nb_pts_affich_X (30), nb_pts_affich_Y (30),
     m_posXYZ(NULL),
-    compute_normal(true)
+    compute_normal(true),
+    m_gpu(false),
+    m_grid("surface3d", s_shader),
+    m_version(0)
 {
   nb_pts_control_X = MAX(4, static_cast<int>(sizeX));
   nb_pts_control_Y = MAX(4, static_cast<int>(sizeY));
@@ -103,6 +157,7 @@ void surface3d :: setMess(int X, int Y, float posX, float posY, float posZ)
     m_posXYZ[X+Y*nb_pts_control_X].x=posX;
     m_posXYZ[X+Y*nb_pts_control_X].y=posY;
     m_posXYZ[X+Y*nb_pts_control_X].z=posZ;
+    m_version++;
     setModified();
   }
 }
@@ -131,6 +186,7 @@ void surface3d :: resolutionMess(int resolutionX, int resolutionY)
       m_posXYZ[a].z= 0.0;
     }
 
+  m_version++;
   setModified();
 }
 
@@ -154,6 +210,16 @@ void surface3d :: normalMess(bool normal)
   compute_normal = normal;
 }
 
+//////////////////////////////////////////////////////////
+// gpuMess
+//
+/////////////////////////////////////////////////////////
+void surface3d :: gpuMess(bool gpu)
+{
+  m_gpu = gpu;
+  setModified();
+}
+
 //////////////////////////////////////////////////////////
 // interpolate
 //
@@ -275,6 +341,10 @@ void surface3d :: renderShape(GemState *state)
   GLfloat xsizediff = xsize0 - xsize;
   GLfloat ysizediff = ysize0 - ysize;
 
+  if (m_gpu && renderGPU(xsize, ysize, xsizediff, ysizediff)) {
+    return;
+  }
+
   GLfloat affich_X=static_cast<GLfloat>(nb_pts_affich_X);
   GLfloat affich_Y=static_cast<GLfloat>(nb_pts_affich_Y);
 
@@ -619,6 +689,55 @@ void surface3d :: renderShape(GemState *state)
   }
 }
 
+//////////////////////////////////////////////////////////
+// renderGPU
+//
+/////////////////////////////////////////////////////////
+bool surface3d :: renderGPU(GLfloat s0, GLfloat t0, GLfloat ds, GLfloat dt)
+{
+  GLenum mode = GL_POINTS;
+  gem::GridMesh::Layout layout = gem::GridMesh::CELLS;
+  switch (m_drawType) {
+  case FILL:
+    mode = GL_TRIANGLE_STRIP;
+    layout = gem::GridMesh::STRIPS;
+    break;
+  case LINE:
+    mode = GL_LINES;
+    break;
+  case POINT:
+    mode = GL_POINTS;
+    break;
+  default:
+    return false;
+  }
+  if (!m_posXYZ || !(GLEW_VERSION_3_0 || GLEW_ARB_texture_float)) {
+    return false;
+  }
+  if (!m_grid.setTexture(m_version, GL_RGB32F_ARB,
+                         nb_pts_control_X, nb_pts_control_Y,
+                         GL_RGB, GL_FLOAT, m_posXYZ)) {
+    return false;
+  }
+  m_grid.setSize(nb_pts_affich_X+1, nb_pts_affich_Y+1);
+  if (!m_grid.begin()) {
+    return false;
+  }
+  glUniform2f(m_grid.uniform("controls"), nb_pts_control_X, nb_pts_control_Y);
+  glUniform2f(m_grid.uniform("grid"), nb_pts_affich_X, nb_pts_affich_Y);
+  glUniform2f(m_grid.uniform("texBase"), s0, t0);
+  glUniform2f(m_grid.uniform("texScale"), ds, dt);
+  glUniform1i(m_grid.uniform("normals"), compute_normal);
+  m_grid.draw(mode, layout);
+  m_grid.end();
+  return true;
+}
+
+void surface3d :: stopRendering(void)
+{
+  m_grid.release();
+}
+
 //////////////////////////////////////////////////////////
 // static member function
 //
@@ -629,4 +748,5 @@ void surface3d :: obj_setupCallback(t_class *classPtr)
   CPPEXTERN_MSG2(classPtr, "grid", gridMess, int, int);
   CPPEXTERN_MSG5(classPtr, "set", setMess, int, int, float, float, float);
   CPPEXTERN_MSG1(classPtr, "normal",  normalMess, bool);
+  CPPEXTERN_MSG1(classPtr, "gpu",  gpuMess, bool);
 }
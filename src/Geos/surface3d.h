@@ -16,6 +16,7 @@ LOG
 #define _INCLUDE__GEM_GEOS_SURFACE_D_H_
 
 #include "Base/GemShape.h"
+#include "Gem/DisplacedGrid.h"
 
 
 /*-----------------------------------------------------------------
@@ -30,6 +31,10 @@ LOG
 
   DESCRIPTION
 
+  "gpu" <bool> - evaluate the surface in a vertex shader
+                 (only the control points are uploaded when they change)
+                 for the "fill", "line" and "point" drawing styles
+
   -----------------------------------------------------------------*/
 
 class GEM_EXTERN surface3d : public GemShape
@@ -51,6 +56,13 @@ protected:
   //////////
   // Do the renderShapeing
   virtual void  renderShape(GemState *state);
+  virtual void  stopRendering(void);
+
+  //////////
+  // Do the rendering on the GPU
+  // returns false if the surface cannot be drawn this way
+  // [in] s0, t0, ds, dt - the texture coordinates (s0+ds*X, t0+dt*Y)
+  bool          renderGPU(GLfloat s0, GLfloat t0, GLfloat ds, GLfloat dt);
 
 
 //  typedef struct {
@@ -69,6 +81,7 @@ protected:
   void interpolate(float X,float Y);
   t_float3 bicubic3(t_float X, t_float Y);
   void normalMess(bool normal);
+  void gpuMess(bool gpu);
 
   enum C3dDrawType {LINE, FILL, POINT,
                     LINE1, LINE2, LINE3, LINE4,
@@ -77,6 +90,11 @@ protected:
 
   t_float3              *m_posXYZ;
 
+  bool                  m_gpu;
+  gem::DisplacedGrid    m_grid;
+  // incremented whenever the control points change
+  unsigned int          m_version;
+
 private:
   static void           interpolate(void *data, t_float X, t_float Y);
   static t_float        cubic (t_float  X0, t_float  X1, t_float  X2,
@@ -16,6 +16,8 @@
 /////////////////////////////////////////////////////////
 
 #include "text2d.h"
+#include "Gem/Settings.h"
+#include <math.h>
 
 #if defined FTGL && !defined HAVE_FTGL_FTGL_H
 # include <FTGLPixmapFont.h>
@@ -37,6 +39,9 @@ text2d :: text2d(int argc, t_atom *argv)
   : TextBase(argc,argv), m_antialias(true),
     m_aafont(NULL), m_bmfont(NULL)
 {
+  int atlas=0;
+  gem::Settings::get("font.atlas", atlas);
+  m_useAtlas=(0!=atlas);
   fontNameMess(DEFAULT_FONT);
 }
 
@@ -152,6 +157,64 @@ void text2d :: renderLine(const wchar_t*line, float dist)
   glPopMatrix();
 }
 
+/////////////////////////////////////////////////////////
+// the glyph-atlas renderer
+//
+/////////////////////////////////////////////////////////
+unsigned int text2d :: atlasSize(void)
+{
+  int fs=static_cast<int>(m_fontSize);
+  if(fs<0) {
+    fs=-fs;
+  }
+  return fs;
+}
+float text2d :: atlasLineOffset(unsigned int line)
+{
+  return m_lineDist[line]*m_fontSize*m_dist;
+}
+void text2d :: renderAtlas(void)
+{
+  /* like the pixmap fonts, the text is anchored at the raster position
+   * of the origin, and drawn in window coordinates */
+  GLboolean valid=GL_FALSE;
+  GLfloat pos[4];
+  GLint viewport[4];
+  glRasterPos2i(0,0);
+  glGetBooleanv(GL_CURRENT_RASTER_POSITION_VALID, &valid);
+  if(!valid) {
+    return;
+  }
+  glGetFloatv(GL_CURRENT_RASTER_POSITION, pos);
+  glGetIntegerv(GL_VIEWPORT, viewport);
+
+  glMatrixMode(GL_PROJECTION);
+  glPushMatrix();
+  glLoadIdentity();
+  glOrtho(viewport[0], viewport[0]+viewport[2],
+          viewport[1], viewport[1]+viewport[3],
+          0, 1);
+  glMatrixMode(GL_MODELVIEW);
+  glPushMatrix();
+  glLoadIdentity();
+  glTranslatef(floorf(pos[0]+0.5f), floorf(pos[1]+0.5f), -pos[2]);
+
+  if(!m_antialias) {
+    glPushAttrib(GL_COLOR_BUFFER_BIT);
+    glEnable(GL_ALPHA_TEST);
+    glAlphaFunc(GL_GREATER, 0.5f);
+    drawAtlas();
+    glPopAttrib();
+  } else {
+    drawAtlas();
+  }
+
+  glPopMatrix();
+  glMatrixMode(GL_PROJECTION);
+  glPopMatrix();
+  glMatrixMode(GL_MODELVIEW);
+}
+
 #else /* !FTGL */
 text2d :: text2d(int argc, t_atom *argv)
   : TextBase(argc, argv)
@@ -169,6 +232,7 @@ void text2d :: obj_setupCallback(t_class *classPtr )
 {
   CPPEXTERN_MSG1(classPtr, "alias", aliasMess, int);
   CPPEXTERN_MSG1(classPtr, "antialias", aliasMess, int);
+  CPPEXTERN_MSG1(classPtr, "atlas", atlasMess, bool);
 }
 
 void text2d :: aliasMess(int io)
@@ -178,3 +242,9 @@ void text2d :: aliasMess(int io)
   m_font=selectFont();
 #endif
 }
+void text2d :: atlasMess(bool state)
+{
+#ifdef FTGL
+  m_useAtlas = state;
+#endif
+}
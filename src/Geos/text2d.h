@@ -49,6 +49,10 @@ protected:
   bool m_antialias;
   void aliasMess(int io);
 
+  //////
+  // render via a glyph-atlas (rather than FTGL)
+  void atlasMess(bool state);
+
 #ifdef FTGL
   /////////
   // Do the rendering
@@ -57,6 +61,10 @@ protected:
 
   virtual void            setFontSize(void);
 
+  virtual unsigned int atlasSize(void);
+  virtual float atlasLineOffset(unsigned int line);
+  virtual void renderAtlas(void);
+
   virtual FTFont* makeFont(const char*fontname);
   virtual FTFont* selectFont(void);
   FTGLPixmapFont *m_aafont;
@@ -16,6 +16,7 @@
 /////////////////////////////////////////////////////////
 
 #include "text3d.h"
+#include "Gem/Settings.h"
 
 #if defined FTGL && !defined HAVE_FTGL_FTGL_H
 # include <FTGLPolygonFont.h>
@@ -36,6 +37,9 @@ text3d :: text3d(int argc, t_atom *argv)
   : TextBase(argc, argv), m_antialias(true),
     m_aafont(NULL), m_pyfont(NULL)
 {
+  int atlas=0;
+  gem::Settings::get("font.atlas", atlas);
+  m_useAtlas=(0!=atlas);
   fontNameMess(DEFAULT_FONT);
 }
 text3d :: ~text3d()
@@ -141,6 +145,7 @@ void text3d :: obj_setupCallback(t_class *classPtr)
 {
   CPPEXTERN_MSG1(classPtr, "alias", aliasMess, int);
   CPPEXTERN_MSG1(classPtr, "antialias", aliasMess, int);
+  CPPEXTERN_MSG1(classPtr, "atlas", atlasMess, bool);
 }
 void text3d :: aliasMess(int io)
 {
@@ -149,3 +154,9 @@ void text3d :: aliasMess(int io)
   m_font=selectFont();
 #endif
 }
+void text3d :: atlasMess(bool state)
+{
+#ifdef FTGL
+  m_useAtlas = state;
+#endif
+}
@@ -56,6 +56,10 @@ protected:
   // anti aliasing (aka: pixmap instead of bitmap)
   bool m_antialias;
   void aliasMess(int io);
+
+  //////
+  // render via a glyph-atlas (rather than FTGL)
+  void atlasMess(bool state);
 };
 
 #endif  // for header file
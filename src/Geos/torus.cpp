@@ -22,6 +22,7 @@
 
 #include "torus.h"
 #include "Gem/State.h"
+#include "Gem/Mesh.h"
 #include "Gem/Exception.h"
 
 CPPEXTERN_NEW_WITH_GIMME(torus);
@@ -88,15 +89,6 @@ void torus :: innerRadius(float radius)
 /////////////////////////////////////////////////////////
 void torus :: renderShape(GemState *state)
 {
-  TexCoord*texCoords=NULL;
-  bool lighting = false;
-  int texNum=0;
-  int texType=0;
-  state->get(GemState::_GL_TEX_COORDS, texCoords);
-  state->get(GemState::_GL_TEX_TYPE, texType);
-  state->get(GemState::_GL_TEX_NUMCOORDS, texNum);
-  state->get(GemState::_GL_LIGHTING, lighting);
-
   GLenum type = m_drawType;
   switch(m_drawType) {
   case GL_LINE_LOOP:
@@ -124,6 +116,25 @@ void torus :: renderShape(GemState *state)
   }
 #endif
 
+  glPushAttrib(GL_POLYGON_BIT);
+  glPolygonMode(GL_FRONT_AND_BACK, type);
+  GemShape::renderShape(state);
+  glPopAttrib();
+}
+
+/////////////////////////////////////////////////////////
+// buildMesh
+//
+/////////////////////////////////////////////////////////
+void torus :: buildMesh(GemState *state, gem::MeshBuilder&mesh)
+{
+  TexCoord*texCoords=NULL;
+  int texNum=0;
+  int texType=0;
+  state->get(GemState::_GL_TEX_COORDS, texCoords);
+  state->get(GemState::_GL_TEX_TYPE, texType);
+  state->get(GemState::_GL_TEX_NUMCOORDS, texNum);
+
   GLfloat xsize = 1.0, xsize0 = 0.0;
   GLfloat ysize = 1.0, ysize0 = 0.0;
   if(texType && texNum>=3) {
@@ -137,8 +148,9 @@ void torus :: renderShape(GemState *state)
   GLint rings = m_numSlices;
   GLint nsides= m_numSlices;
 
-  GLfloat r = m_innerRadius;
-  GLfloat R = m_size;
+  /* unit size, the geometry is scaled when drawing */
+  GLfloat r = (m_size != 0.f)?(m_innerRadius / m_size):0.f;
+  GLfloat R = 1.f;
 
   int i, j;
   GLfloat theta, phi, theta1;
@@ -152,9 +164,6 @@ void torus :: renderShape(GemState *state)
   const GLfloat dt = 1.0 / nsides;
   GLfloat s, t;
 
-  glPushAttrib(GL_POLYGON_BIT);
-  glPolygonMode(GL_FRONT_AND_BACK, type);
-
   theta = 0.0;
   cosTheta = 1.0;
   sinTheta = 0.0;
@@ -163,7 +172,7 @@ void torus :: renderShape(GemState *state)
     theta1 = theta + ringDelta;
     cosTheta1 = cos(theta1);
     sinTheta1 = sin(theta1);
-    glBegin(GL_QUAD_STRIP);
+    mesh.begin(GL_QUAD_STRIP);
     phi = 0.0;
     s = 0.0;
     for (j = nsides; j >= 0; j--) {
@@ -174,31 +183,36 @@ void torus :: renderShape(GemState *state)
       sinPhi = sin(phi);
       dist = R + r * cosPhi;
 
-      if(lighting) {
-        glNormal3f(cosTheta1 * cosPhi, -sinTheta1 * cosPhi, sinPhi);
-      }
+      mesh.normal(cosTheta1 * cosPhi, -sinTheta1 * cosPhi, sinPhi);
       if(texType) {
-        glTexCoord2f(s*xsize+xsize0, t*ysize+ysize0);
+        mesh.texcoord(s*xsize+xsize0, t*ysize+ysize0);
       }
-      glVertex3f(cosTheta1 * dist, -sinTheta1 * dist, r * sinPhi);
+      mesh.vertex(cosTheta1 * dist, -sinTheta1 * dist, r * sinPhi);
 
-      if(lighting) {
-        glNormal3f(cosTheta * cosPhi, -sinTheta * cosPhi, sinPhi);
-      }
+      mesh.normal(cosTheta * cosPhi, -sinTheta * cosPhi, sinPhi);
       if(texType) {
-        glTexCoord2f(s*xsize+xsize0, (t - dt)*ysize+ysize0);
+        mesh.texcoord(s*xsize+xsize0, (t - dt)*ysize+ysize0);
       }
-      glVertex3f(cosTheta * dist, -sinTheta * dist,  r * sinPhi);
+      mesh.vertex(cosTheta * dist, -sinTheta * dist,  r * sinPhi);
 
       s+=ds;
     }
-    glEnd();
+    mesh.end();
     theta = theta1;
     cosTheta = cosTheta1;
     sinTheta = sinTheta1;
     t += dt;
   }
-  glPopAttrib();
+}
+
+/////////////////////////////////////////////////////////
+// meshParams
+//
+/////////////////////////////////////////////////////////
+void torus :: meshParams(std::vector<float>&params)
+{
+  GemGluObj::meshParams(params);
+  params.push_back((m_size != 0.f)?(m_innerRadius / m_size):0.f);
 }
 
 /////////////////////////////////////////////////////////
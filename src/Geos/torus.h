@@ -61,9 +61,14 @@ protected:
   void                    innerRadius(float radius);
 
   //////////
-  // Do the rendering
+  // Do the rendering (with the polygon mode set)
   virtual void    renderShape(GemState *state);
 
+  //////////
+  // Describe the geometry
+  virtual void    buildMesh(GemState *state, gem::MeshBuilder&mesh);
+  virtual void    meshParams(std::vector<float>&params);
+
 };
 
 #endif  // for header file
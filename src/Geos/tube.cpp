@@ -29,6 +29,7 @@
 #include <math.h>
 
 #include "Gem/State.h"
+#include "Gem/Mesh.h"
 
 const float tube::TWO_PI = 8.f * atan(1.);
 
@@ -116,10 +117,10 @@ tube :: ~tube(void)
 }
 
 //////////////////////////////////////////////////////////
-// renderShape
+// buildMesh
 //
 /////////////////////////////////////////////////////////
-void tube :: renderShape(GemState *state)
+void tube :: buildMesh(GemState *state, gem::MeshBuilder&mesh)
 {
 #ifdef __GNUC__
   GLfloat vectors1[order+3][3];
@@ -197,8 +198,7 @@ void tube :: renderShape(GemState *state)
   vectors1[order+2][1] = vectors1[2][1];
   vectors1[order+2][2] = vectors1[2][2];
 
-  glLineWidth(m_linewidth);
-  glBegin(m_drawType);
+  mesh.begin(m_drawType);
 
   if (GemShape::m_texType)    {
     GLfloat xsize = 1.0;
@@ -213,29 +213,55 @@ void tube :: renderShape(GemState *state)
 
     for (n = 1; n < order + 2 ; n++)    {
       Matrix::generateNormal(vectors1[n-1], vectors2[n], vectors1[n+1], normal);
-      glNormal3fv(normal);
-      glTexCoord2f( 1.*xsize*(n-1)/order, ysize0 );
-      glVertex3fv(vectors1[n]);
+      mesh.normal(normal[0], normal[1], normal[2]);
+      mesh.texcoord( 1.*xsize*(n-1)/order, ysize0 );
+      mesh.vertex(vectors1[n][0], vectors1[n][1], vectors1[n][2]);
 
       Matrix::generateNormal(vectors2[n+1], vectors1[n], vectors2[n-1], normal);
-      glNormal3fv(normal);
-      glTexCoord2f( 1.*xsize*(n-1)/order, ysize1);
-      glVertex3fv(vectors2[n]);
+      mesh.normal(normal[0], normal[1], normal[2]);
+      mesh.texcoord( 1.*xsize*(n-1)/order, ysize1);
+      mesh.vertex(vectors2[n][0], vectors2[n][1], vectors2[n][2]);
     }
   }  else  {
     for (n = 1; n < order + 2; n++) {
       Matrix::generateNormal(vectors1[n-1], vectors2[n], vectors1[n+1], normal);
-      glNormal3fv(normal);
-      glVertex3fv(vectors1[n]);
+      mesh.normal(normal[0], normal[1], normal[2]);
+      mesh.vertex(vectors1[n][0], vectors1[n][1], vectors1[n][2]);
 
       Matrix::generateNormal(vectors2[n+1], vectors1[n], vectors2[n-1], normal);
-      glNormal3fv(normal);
-      glVertex3fv(vectors2[n]);
+      mesh.normal(normal[0], normal[1], normal[2]);
+      mesh.vertex(vectors2[n][0], vectors2[n][1], vectors2[n][2]);
     }
   }
 
-  glEnd();
-  glLineWidth(1.0);
+  mesh.end();
+}
+
+/////////////////////////////////////////////////////////
+// meshParams
+//
+/////////////////////////////////////////////////////////
+void tube :: meshParams(std::vector<float>&params)
+{
+  params.push_back(order);
+  params.push_back(m_size);
+  params.push_back(m_size2);
+  params.push_back(m_high);
+  params.push_back(m_TX);
+  params.push_back(m_TY);
+  params.push_back(cos_rotX1);
+  params.push_back(sin_rotX1);
+  params.push_back(cos_rotY1);
+  params.push_back(sin_rotY1);
+  params.push_back(cos_rotX2);
+  params.push_back(sin_rotX2);
+  params.push_back(cos_rotY2);
+  params.push_back(sin_rotY2);
+}
+void tube :: meshScale(float&x, float&y, float&z)
+{
+  /* the geometry is not uniformly scaled by the sizes */
+  x=y=z=1.f;
 }
 
 void tube :: sizeMess2(float size2)
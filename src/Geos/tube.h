@@ -84,8 +84,10 @@ protected:
 
 
   //////////
-  // Do the renderShapeing
-  virtual void  renderShape(GemState *state);
+  // Describe the geometry
+  virtual void  buildMesh(GemState *state, gem::MeshBuilder&mesh);
+  virtual void  meshParams(std::vector<float>&params);
+  virtual void  meshScale(float&x, float&y, float&z);
 
   //////////
   // 2 PI
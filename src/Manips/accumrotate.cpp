@@ -15,6 +15,7 @@
 /////////////////////////////////////////////////////////
 
 #include "accumrotate.h"
+#include "Gem/ModelView.h"
 #include "Gem/GemGL.h"
 #include "Gem/Exception.h"
 
@@ -30,6 +31,7 @@ CPPEXTERN_NEW_WITH_GIMME(accumrotate);
 /////////////////////////////////////////////////////////
 accumrotate :: accumrotate(int argc, t_atom *argv)
 {
+  m_onlyTransforms=true;
   m_rotMatrix.identity();
 
   if (argc == 3) {
@@ -61,6 +63,11 @@ accumrotate :: ~accumrotate()
 /////////////////////////////////////////////////////////
 void accumrotate :: render(GemState *)
 {
+  Matrix*m=gem::ModelView::defer();
+  if(m) {
+    m->multiply((float *)(&m_rotMatrix.mat));
+    return;
+  }
   glMultMatrixf((float *)(&m_rotMatrix.mat));
 }
 
@@ -0,0 +1,312 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "gem_instances.h"
+#include "Gem/State.h"
+#include "RTE/MessageCallbacks.h"
+
+#include "Utils/GemMath.h"
+
+CPPEXTERN_NEW(gem_instances);
+
+/////////////////////////////////////////////////////////
+//
+// gem_instances
+//
+/////////////////////////////////////////////////////////
+// Constructor
+//
+/////////////////////////////////////////////////////////
+gem_instances :: gem_instances(void)
+  : m_position(3), m_rotation(3), m_scale(3), m_matrix(16), m_color(4)
+  , m_count(0)
+  , m_oldInstances(NULL)
+  , m_warned(false)
+{
+}
+
+/////////////////////////////////////////////////////////
+// Destructor
+//
+/////////////////////////////////////////////////////////
+gem_instances :: ~gem_instances(void)
+{
+}
+
+/////////////////////////////////////////////////////////
+// render
+//
+/////////////////////////////////////////////////////////
+void gem_instances :: render(GemState *state)
+{
+  m_oldInstances=NULL;
+  state->get(GemState::_GL_INSTANCES, m_oldInstances);
+  if(!gem::Instances::isRunnable()) {
+    /* the geos will just draw themselves once */
+    if(!m_warned) {
+      error("instanced rendering is not supported by this openGL context");
+      m_warned=true;
+    }
+    return;
+  }
+  state->set(GemState::_GL_INSTANCES, &m_instances);
+}
+void gem_instances :: postrender(GemState *state)
+{
+  state->set(GemState::_GL_INSTANCES, m_oldInstances);
+}
+void gem_instances :: stopRendering(void)
+{
+  m_instances.release();
+}
+
+/////////////////////////////////////////////////////////
+// update
+//
+/////////////////////////////////////////////////////////
+unsigned int gem_instances :: readTables(const std::vector<std::string>
+    &names, unsigned int dimen, std::vector<float>&data)
+{
+  data.clear();
+  if(names.empty()) {
+    return 0;
+  }
+  const bool interleaved=(1==names.size());
+  std::vector<t_word*>vecs;
+  unsigned int count=0;
+  for(unsigned int i=0; i<names.size(); i++) {
+    t_garray*a=(t_garray*)pd_findbyclass(gensym(names[i].c_str()),
+                                         garray_class);
+    int npoints=0;
+    t_word*vec=NULL;
+    if(!a) {
+      error("%s: no such array", names[i].c_str());
+      return 0;
+    }
+    if(!garray_getfloatwords(a, &npoints, &vec)) {
+      error("%s: bad template for tabLink", names[i].c_str());
+      return 0;
+    }
+    unsigned int n=(npoints>0)?npoints:0;
+    if(interleaved) {
+      n/=dimen;
+    }
+    if(!i || n<count) {
+      count=n;
+    }
+    vecs.push_back(vec);
+  }
+
+  data.resize(count*dimen);
+  if(interleaved) {
+    const t_word*vec=vecs[0];
+    for(unsigned int i=0; i<count*dimen; i++) {
+      data[i]=vec[i].w_float;
+    }
+  } else {
+    for(unsigned int d=0; d<dimen; d++) {
+      const t_word*vec=vecs[d];
+      for(unsigned int i=0; i<count; i++) {
+        data[i*dimen+d]=vec[i].w_float;
+      }
+    }
+  }
+  return count;
+}
+
+void gem_instances :: update(void)
+{
+  std::vector<float>position, rotation, scale, matrices, data;
+  unsigned int count=0, n=0;
+
+  if(!m_matrix.names.empty()) {
+    count=readTables(m_matrix.names, m_matrix.dimen, matrices);
+  } else {
+    const unsigned int npos=readTables(m_position.names, m_position.dimen,
+                                       position);
+    const unsigned int nrot=readTables(m_rotation.names, m_rotation.dimen,
+                                       rotation);
+    const unsigned int nscale=readTables(m_scale.names, m_scale.dimen, scale);
+    count=npos;
+    if(nrot>count) {
+      count=nrot;
+    }
+    if(nscale>count) {
+      count=nscale;
+    }
+
+    /* translate, rotate (X, then Y, then Z) and scale; column-major */
+    const float deg2rad=static_cast<float>(M_PI/180.);
+    matrices.resize(count*16);
+    for(unsigned int i=0; i<count; i++) {
+      float*m=&matrices[i*16];
+      float tx=0.f, ty=0.f, tz=0.f;
+      float cx=1.f, sx=0.f, cy=1.f, sy=0.f, cz=1.f, sz=0.f;
+      float kx=1.f, ky=1.f, kz=1.f;
+      if(i<npos) {
+        tx=position[i*3+0];
+        ty=position[i*3+1];
+        tz=position[i*3+2];
+      }
+      if(i<nrot) {
+        cx=cosf(rotation[i*3+0]*deg2rad);
+        sx=sinf(rotation[i*3+0]*deg2rad);
+        cy=cosf(rotation[i*3+1]*deg2rad);
+        sy=sinf(rotation[i*3+1]*deg2rad);
+        cz=cosf(rotation[i*3+2]*deg2rad);
+        sz=sinf(rotation[i*3+2]*deg2rad);
+      }
+      if(i<nscale) {
+        kx=scale[i*3+0];
+        ky=scale[i*3+1];
+        kz=scale[i*3+2];
+      }
+      m[ 0]=kx*(cy*cz);
+      m[ 1]=kx*(sx*sy*cz + cx*sz);
+      m[ 2]=kx*(sx*sz - cx*sy*cz);
+      m[ 3]=0.f;
+      m[ 4]=ky*(-cy*sz);
+      m[ 5]=ky*(cx*cz - sx*sy*sz);
+      m[ 6]=ky*(cx*sy*sz + sx*cz);
+      m[ 7]=0.f;
+      m[ 8]=kz*(sy);
+      m[ 9]=kz*(-sx*cy);
+      m[10]=kz*(cx*cy);
+      m[11]=0.f;
+      m[12]=tx;
+      m[13]=ty;
+      m[14]=tz;
+      m[15]=1.f;
+    }
+  }
+  m_instances.setTransforms(matrices);
+
+  n=readTables(m_color.names, m_color.dimen, data);
+  if(n>count) {
+    count=n;
+  }
+  m_instances.setColors(data);
+
+  std::map<std::string, std::vector<std::string> >::iterator it;
+  for(it=m_attributes.begin(); it!=m_attributes.end(); ++it) {
+    const unsigned int dimen=it->second.size();
+    /* a single table holds a single component */
+    n=readTables(it->second, dimen, data);
+    if(n>count) {
+      count=n;
+    }
+    m_instances.setAttribute(it->first, dimen, data);
+  }
+
+  m_instances.setSize(m_count?m_count:count);
+}
+
+/////////////////////////////////////////////////////////
+// messages
+//
+/////////////////////////////////////////////////////////
+void gem_instances :: tablesMess(Tables&tables, t_symbol*s, int argc,
+                                 t_atom*argv)
+{
+  /* 1 interleaved table, or one table per component */
+  if(argc && argc!=1 && static_cast<unsigned int>(argc)!=tables.dimen) {
+    error("illegal arguments to '%s': must be <table[1..%d]>",
+          s->s_name, tables.dimen);
+    return;
+  }
+  for(int i=0; i<argc; i++) {
+    if(A_SYMBOL!=argv[i].a_type) {
+      error("illegal arguments to '%s': tablenames must be symbols",
+            s->s_name);
+      return;
+    }
+  }
+  tables.names.clear();
+  for(int i=0; i<argc; i++) {
+    tables.names.push_back(atom_getsymbol(argv+i)->s_name);
+  }
+  update();
+}
+void gem_instances :: positionMess(t_symbol*s, int argc, t_atom*argv)
+{
+  tablesMess(m_position, s, argc, argv);
+}
+void gem_instances :: rotationMess(t_symbol*s, int argc, t_atom*argv)
+{
+  tablesMess(m_rotation, s, argc, argv);
+}
+void gem_instances :: scaleMess(t_symbol*s, int argc, t_atom*argv)
+{
+  tablesMess(m_scale, s, argc, argv);
+}
+void gem_instances :: matrixMess(t_symbol*s, int argc, t_atom*argv)
+{
+  if(argc>1) {
+    error("illegal arguments to '%s': must be <table>", s->s_name);
+    return;
+  }
+  tablesMess(m_matrix, s, argc, argv);
+}
+void gem_instances :: colorMess(t_symbol*s, int argc, t_atom*argv)
+{
+  tablesMess(m_color, s, argc, argv);
+}
+void gem_instances :: attributeMess(t_symbol*s, int argc, t_atom*argv)
+{
+  if(argc<1 || argc>5) {
+    error("illegal arguments to '%s': must be <name> <table[1..4]>",
+          s->s_name);
+    return;
+  }
+  for(int i=0; i<argc; i++) {
+    if(A_SYMBOL!=argv[i].a_type) {
+      error("illegal arguments to '%s': must be <name> <table[1..4]>",
+            s->s_name);
+      return;
+    }
+  }
+  const std::string name=atom_getsymbol(argv)->s_name;
+  if(1==argc) {
+    m_attributes.erase(name);
+    m_instances.setAttribute(name, 0, std::vector<float>());
+  } else {
+    std::vector<std::string>&names=m_attributes[name];
+    names.clear();
+    for(int i=1; i<argc; i++) {
+      names.push_back(atom_getsymbol(argv+i)->s_name);
+    }
+  }
+  update();
+}
+void gem_instances :: countMess(int count)
+{
+  m_count=(count>0)?count:0;
+  update();
+}
+
+/////////////////////////////////////////////////////////
+// static member function
+//
+/////////////////////////////////////////////////////////
+void gem_instances :: obj_setupCallback(t_class *classPtr)
+{
+  CPPEXTERN_MSG (classPtr, "position", positionMess);
+  CPPEXTERN_MSG (classPtr, "rotation", rotationMess);
+  CPPEXTERN_MSG (classPtr, "scale", scaleMess);
+  CPPEXTERN_MSG (classPtr, "matrix", matrixMess);
+  CPPEXTERN_MSG (classPtr, "color", colorMess);
+  CPPEXTERN_MSG (classPtr, "attribute", attributeMess);
+  CPPEXTERN_MSG1(classPtr, "count", countMess, int);
+  CPPEXTERN_MSG0(classPtr, "bang", update);
+}
@@ -0,0 +1,108 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    draw the following geos once per instance
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_MANIPS_GEM_INSTANCES_H_
+#define _INCLUDE__GEM_MANIPS_GEM_INSTANCES_H_
+
+#include "Base/GemBase.h"
+#include "Gem/Instances.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*-----------------------------------------------------------------
+-------------------------------------------------------------------
+CLASS
+    gem_instances
+
+    hardware-instanced rendering
+
+DESCRIPTION
+
+    the retained geos that follow ([cube], [sphere],... [model],
+    [gemvertexbuffer]) are drawn once for each instance,
+    with a single draw-call
+
+    the per-instance data is read from tables
+    (either a single table with interleaved values, or one table per component)
+
+    "position" <table(s)> - translation (X Y Z)
+    "rotation" <table(s)> - rotation in degrees (X Y Z, as in [rotateXYZ])
+    "scale" <table(s)> - scale (X Y Z)
+    "matrix" <table> - 16 values (column-major) per instance
+                       (replaces position/rotation/scale)
+    "color" <table(s)> - colour (R G B A)
+    "attribute" <name> <table(s)> - a custom attribute for a GLSL program
+                                    (one table per component; 1..4)
+    any of these without tables removes the data
+
+    "count" <n> - number of instances (0: as many as there are in the tables)
+    "bang" - re-read all the tables
+
+-----------------------------------------------------------------*/
+class GEM_EXTERN gem_instances : public GemBase
+{
+  CPPEXTERN_HEADER(gem_instances, GemBase);
+
+public:
+
+  //////////
+  // Constructor
+  gem_instances(void);
+
+protected:
+
+  //////////
+  // Destructor
+  virtual ~gem_instances(void);
+
+  //////////
+  // Do the rendering
+  virtual void render(GemState *state);
+  virtual void postrender(GemState *state);
+  virtual void stopRendering(void);
+
+  //////////
+  // the tables for a single kind of per-instance data
+  struct Tables {
+    std::vector<std::string>names;
+    unsigned int dimen;
+    Tables(unsigned int d=0) : dimen(d) {}
+  };
+  Tables m_position, m_rotation, m_scale, m_matrix, m_color;
+  std::map<std::string, std::vector<std::string> >m_attributes;
+
+  unsigned int m_count;
+
+  gem::Instances m_instances;
+  gem::Instances*m_oldInstances;
+  bool m_warned;
+
+  //////////
+  // read the tables and pass the data on to m_instances
+  void update(void);
+  // returns the number of entries read
+  unsigned int readTables(const std::vector<std::string>&names,
+                          unsigned int dimen, std::vector<float>&data);
+
+  void tablesMess(Tables&tables, t_symbol*s, int argc, t_atom*argv);
+  void positionMess(t_symbol*s, int argc, t_atom*argv);
+  void rotationMess(t_symbol*s, int argc, t_atom*argv);
+  void scaleMess(t_symbol*s, int argc, t_atom*argv);
+  void matrixMess(t_symbol*s, int argc, t_atom*argv);
+  void colorMess(t_symbol*s, int argc, t_atom*argv);
+  void attributeMess(t_symbol*s, int argc, t_atom*argv);
+  void countMess(int count);
+};
+
+#endif  // for header file
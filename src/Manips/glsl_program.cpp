@@ -13,6 +13,11 @@
 /////////////////////////////////////////////////////////
 
 #include "glsl_program.h"
+#include "Gem/Settings.h"
+#include "Gem/Files.h"
+
+#include <stdio.h>
+#include <string.h>
 
 using namespace gem::utils::gl;
 
@@ -43,6 +48,12 @@ GLenum uniform2type(CPPExtern*obj, GLenum type)
   case GL_FLOAT_MAT2:
   case GL_FLOAT_MAT3:
   case GL_FLOAT_MAT4:
+  case GL_FLOAT_MAT2x3:
+  case GL_FLOAT_MAT2x4:
+  case GL_FLOAT_MAT3x2:
+  case GL_FLOAT_MAT3x4:
+  case GL_FLOAT_MAT4x2:
+  case GL_FLOAT_MAT4x3:
     return GL_FLOAT;
   case GL_DOUBLE:
   case GL_DOUBLE_VEC2:
@@ -51,6 +62,12 @@ GLenum uniform2type(CPPExtern*obj, GLenum type)
   case GL_DOUBLE_MAT2:
   case GL_DOUBLE_MAT3:
   case GL_DOUBLE_MAT4:
+  case GL_DOUBLE_MAT2x3:
+  case GL_DOUBLE_MAT2x4:
+  case GL_DOUBLE_MAT3x2:
+  case GL_DOUBLE_MAT3x4:
+  case GL_DOUBLE_MAT4x2:
+  case GL_DOUBLE_MAT4x3:
     return GL_DOUBLE;
   case GL_INT:
   case GL_INT_VEC2:
@@ -143,6 +160,21 @@ size_t uniform2numelements(CPPExtern*obj, GLenum type)
   case GL_DOUBLE_MAT4:
   case GL_FLOAT_MAT4:
     return 16;
+  case GL_DOUBLE_MAT2x3:
+  case GL_FLOAT_MAT2x3:
+  case GL_DOUBLE_MAT3x2:
+  case GL_FLOAT_MAT3x2:
+    return 6;
+  case GL_DOUBLE_MAT2x4:
+  case GL_FLOAT_MAT2x4:
+  case GL_DOUBLE_MAT4x2:
+  case GL_FLOAT_MAT4x2:
+    return 8;
+  case GL_DOUBLE_MAT3x4:
+  case GL_FLOAT_MAT3x4:
+  case GL_DOUBLE_MAT4x3:
+  case GL_FLOAT_MAT4x3:
+    return 12;
   case GL_SAMPLER_1D:
   case GL_SAMPLER_2D:
   case GL_SAMPLER_3D:
@@ -191,6 +223,297 @@ size_t uniform2numelements(CPPExtern*obj, GLenum type)
   obj->error("unknown base size for uniform type 0x%X, assuming 1", type);
   return 1;
 }
+bool uniform2matrix(GLenum type, size_t&columns, size_t&rows)
+{
+  /* the shape of a matrix uniform type (matCxR has C columns of R rows);
+     returns false if the type is not a matrix
+  */
+  switch(type) {
+  default:
+    return false;
+  case GL_DOUBLE_MAT2:
+  case GL_FLOAT_MAT2:
+    columns=2;
+    rows=2;
+    break;
+  case GL_DOUBLE_MAT3:
+  case GL_FLOAT_MAT3:
+    columns=3;
+    rows=3;
+    break;
+  case GL_DOUBLE_MAT4:
+  case GL_FLOAT_MAT4:
+    columns=4;
+    rows=4;
+    break;
+  case GL_DOUBLE_MAT2x3:
+  case GL_FLOAT_MAT2x3:
+    columns=2;
+    rows=3;
+    break;
+  case GL_DOUBLE_MAT2x4:
+  case GL_FLOAT_MAT2x4:
+    columns=2;
+    rows=4;
+    break;
+  case GL_DOUBLE_MAT3x2:
+  case GL_FLOAT_MAT3x2:
+    columns=3;
+    rows=2;
+    break;
+  case GL_DOUBLE_MAT3x4:
+  case GL_FLOAT_MAT3x4:
+    columns=3;
+    rows=4;
+    break;
+  case GL_DOUBLE_MAT4x2:
+  case GL_FLOAT_MAT4x2:
+    columns=4;
+    rows=2;
+    break;
+  case GL_DOUBLE_MAT4x3:
+  case GL_FLOAT_MAT4x3:
+    columns=4;
+    rows=3;
+    break;
+  }
+  return true;
+}
+
+/*
+ * the on-disk cache of linked programs
+ * each program binary is stored in a file named after a hash of the
+ * shader sources, the (geometry) parameters and the driver strings
+ * the file starts with the full key, so a hash collision is detected
+ * before the binary is handed to the driver
+ */
+#ifdef _WIN32
+# define GLSL_CACHEDIR "%LOCALAPPDATA%\\Gem\\glsl"
+#elif defined __APPLE__
+# define GLSL_CACHEDIR "~/Library/Caches/Gem/glsl"
+#else
+# define GLSL_CACHEDIR "~/.cache/Gem/glsl"
+#endif
+const char s_cacheMagic[4]= {'G', 'e', 'm', 'K'};
+
+bool haveProgramBinary(void)
+{
+  if(!(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)) {
+    return false;
+  }
+  if(!(glProgramBinary && glGetProgramBinary && glProgramParameteri)) {
+    return false;
+  }
+  GLint formats=0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  return (formats>0);
+}
+std::string getCacheFile(const std::string&key, bool create)
+{
+  /* 2 FNV-1a hashes (forward and backward) make for a 64bit key */
+  unsigned int h0=2166136261U, h1=2166136261U;
+  const size_t length=key.size();
+  for(size_t i=0; i<length; i++) {
+    h0=(h0^static_cast<unsigned char>(key[i]))*16777619U;
+    h1=(h1^static_cast<unsigned char>(key[length-1-i]))*16777619U;
+  }
+  std::string dir=GLSL_CACHEDIR;
+  gem::Settings::get("glsl.cachedir", dir);
+  dir=gem::files::expandEnv(dir, true);
+  if(create && !gem::files::makeDirectory(dir)) {
+    return "";
+  }
+  char name[32];
+  sprintf(name, "/%08x%08x.bin", h0, h1);
+  return dir+name;
+}
+bool loadProgramBinary(GLuint program, const std::string&key)
+{
+  const std::string filename=getCacheFile(key, false);
+  FILE*f=fopen(filename.c_str(), "rb");
+  if(!f) {
+    return false;
+  }
+  char magic[4];
+  GLenum format=0;
+  unsigned int keylength=0, length=0;
+  std::vector<char>binary;
+  bool ok=(1==fread(magic, sizeof(magic), 1, f))
+          && (0==memcmp(magic, s_cacheMagic, sizeof(magic)))
+          && (1==fread(&keylength, sizeof(keylength), 1, f))
+          && (keylength==key.size());
+  if(ok) {
+    /* the file might belong to another program with the same hash */
+    std::vector<char>filekey(keylength);
+    ok=(1==fread(&filekey[0], keylength, 1, f))
+       && (0==memcmp(&filekey[0], key.data(), keylength))
+       && (1==fread(&format, sizeof(format), 1, f))
+       && (1==fread(&length, sizeof(length), 1, f))
+       && (length>0);
+  }
+  if(ok) {
+    binary.resize(length);
+    ok=(1==fread(&binary[0], length, 1, f));
+  }
+  fclose(f);
+  if(!ok) {
+    return false;
+  }
+  GLint status=0;
+  glProgramBinary(program, format, &binary[0], length);
+  glGetProgramiv(program, GL_LINK_STATUS, &status);
+  return (0!=status);
+}
+void storeProgramBinary(GLuint program, const std::string&key)
+{
+  GLint length=0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if(length<=0) {
+    return;
+  }
+  std::vector<char>binary(length);
+  GLsizei written=0;
+  GLenum format=0;
+  glGetProgramBinary(program, length, &written, &format, &binary[0]);
+  if(written<=0) {
+    return;
+  }
+  const std::string filename=getCacheFile(key, true);
+  if(filename.empty()) {
+    return;
+  }
+  /* write to a temporary file first, so concurrent readers
+   * never see a partial binary */
+  const std::string tmpname=filename+".tmp";
+  FILE*f=fopen(tmpname.c_str(), "wb");
+  if(!f) {
+    return;
+  }
+  const unsigned int keylength=key.size();
+  const unsigned int size=written;
+  bool ok=(1==fwrite(s_cacheMagic, sizeof(s_cacheMagic), 1, f))
+          && (1==fwrite(&keylength, sizeof(keylength), 1, f))
+          && (1==fwrite(key.data(), keylength, 1, f))
+          && (1==fwrite(&format, sizeof(format), 1, f))
+          && (1==fwrite(&size, sizeof(size), 1, f))
+          && (1==fwrite(&binary[0], size, 1, f));
+  ok=(0==fclose(f)) && ok;
+  if(ok) {
+    remove(filename.c_str());
+    ok=(0==rename(tmpname.c_str(), filename.c_str()));
+  }
+  if(!ok) {
+    remove(tmpname.c_str());
+  }
+}
+};
+
+/////////////////////////////////////////////////////////
+//
+// glsl_program::t_uniformblock
+//
+/////////////////////////////////////////////////////////
+
+/*
+ * the storage of a uniform block, shared by all programs that use
+ * a block of the same name (which should be declared with
+ * the same std140 (or shared) layout in each of them)
+ * each block gets its own binding point, so switching programs
+ * does not require re-binding
+ * all changes of a frame are uploaded to the UBO in a single write
+ */
+struct glsl_program::t_uniformblock {
+  std::string name;
+  GLuint binding;
+  std::vector<unsigned char>data;
+  /* bumped whenever the data changes */
+  unsigned int serial;
+  unsigned int refcount;
+
+  gem::ContextData<GLuint>buffer;
+  gem::ContextData<unsigned int>uploaded;
+
+  t_uniformblock(const std::string&name_, GLuint binding_)
+    : name(name_)
+    , binding(binding_)
+    , serial(1)
+    , refcount(0)
+    , buffer(0)
+    , uploaded(0)
+  { }
+  ~t_uniformblock(void)
+  {
+    GLuint buf=buffer;
+    if(buf) {
+      glDeleteBuffers(1, &buf);
+    }
+  }
+
+  static std::map<std::string, t_uniformblock*>&getBlocks(void)
+  {
+    static std::map<std::string, t_uniformblock*>s_blocks;
+    return s_blocks;
+  }
+  static t_uniformblock*acquire(const std::string&name, size_t size)
+  {
+    std::map<std::string, t_uniformblock*>&blocks=getBlocks();
+    std::map<std::string, t_uniformblock*>::iterator it=blocks.find(name);
+    t_uniformblock*block=0;
+    if(it!=blocks.end()) {
+      block=it->second;
+    } else {
+      /* use the lowest unused binding point */
+      GLuint binding=0;
+      bool used=true;
+      while(used) {
+        used=false;
+        for(it=blocks.begin(); it!=blocks.end(); ++it) {
+          if(it->second->binding == binding) {
+            used=true;
+            binding++;
+            break;
+          }
+        }
+      }
+      block=new t_uniformblock(name, binding);
+      blocks[name]=block;
+    }
+    if(size>block->data.size()) {
+      block->data.resize(size, 0);
+      block->serial++;
+    }
+    block->refcount++;
+    return block;
+  }
+  static void release(t_uniformblock*block)
+  {
+    if(--block->refcount) {
+      return;
+    }
+    getBlocks().erase(block->name);
+    delete block;
+  }
+
+  /* copy the values of a uniform into the block */
+  void write(const t_uniform&uni);
+
+  /* bind the block to its binding point (uploading any changes) */
+  void bind(void)
+  {
+    GLuint buf=buffer;
+    if(!buf || !glIsBuffer(buf)) {
+      glGenBuffers(1, &buf);
+      buffer=buf;
+      uploaded=0;
+    }
+    if(uploaded != serial) {
+      glBindBuffer(GL_UNIFORM_BUFFER, buf);
+      glBufferData(GL_UNIFORM_BUFFER, data.size(), &data[0], GL_DYNAMIC_DRAW);
+      glBindBuffer(GL_UNIFORM_BUFFER, 0);
+      uploaded=serial;
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, buf);
+  }
 };
 
 /////////////////////////////////////////////////////////
@@ -213,14 +536,21 @@ struct glsl_program::t_uniform {
   GLint arraysize; /* array size (or 1) */
   bool changed;
 
+  /* members of a uniform block are stored in the block's buffer */
+  t_uniformblock*block;
+  GLint offset, arraystride, matrixstride;
+
   t_uniform(void)
     : paramsize(1)
+    , block(0)
   {  }
   t_uniform(glsl_program*parent, GLint _loc, GLenum _type, GLint _arraysize)
     : loc(_loc)
     , type(_type)
     , arraysize(_arraysize)
     , changed(false)
+    , block(0)
+    , offset(0), arraystride(0), matrixstride(0)
   {
     paramsize = uniform2numelements(parent, type);
     paramtype = uniform2type(parent, type);
@@ -233,6 +563,10 @@ struct glsl_program::t_uniform {
     if(!changed)return;
     // remove flag because the value is going to be in the GL's state soon...
     changed = false;
+    if(block) {
+      block->write(*this);
+      return;
+    }
     GLfloat*floatarray = param.f.data();
     GLdouble*doublearray = param.d.data();
     GLint*intarray = param.i.data();
@@ -304,6 +638,24 @@ struct glsl_program::t_uniform {
     case GL_FLOAT_MAT4:
       glUniformMatrix4fv( loc, arraysize, GL_FALSE, floatarray );
       break;
+    case GL_FLOAT_MAT2x3:
+      glUniformMatrix2x3fv( loc, arraysize, GL_FALSE, floatarray );
+      break;
+    case GL_FLOAT_MAT2x4:
+      glUniformMatrix2x4fv( loc, arraysize, GL_FALSE, floatarray );
+      break;
+    case GL_FLOAT_MAT3x2:
+      glUniformMatrix3x2fv( loc, arraysize, GL_FALSE, floatarray );
+      break;
+    case GL_FLOAT_MAT3x4:
+      glUniformMatrix3x4fv( loc, arraysize, GL_FALSE, floatarray );
+      break;
+    case GL_FLOAT_MAT4x2:
+      glUniformMatrix4x2fv( loc, arraysize, GL_FALSE, floatarray );
+      break;
+    case GL_FLOAT_MAT4x3:
+      glUniformMatrix4x3fv( loc, arraysize, GL_FALSE, floatarray );
+      break;
 
        /* double matrices */
     case GL_DOUBLE_MAT2:
@@ -316,6 +668,24 @@ struct glsl_program::t_uniform {
     case GL_DOUBLE_MAT4:
       glUniformMatrix4dv( loc, arraysize, GL_FALSE, doublearray );
       break;
+    case GL_DOUBLE_MAT2x3:
+      glUniformMatrix2x3dv( loc, arraysize, GL_FALSE, doublearray );
+      break;
+    case GL_DOUBLE_MAT2x4:
+      glUniformMatrix2x4dv( loc, arraysize, GL_FALSE, doublearray );
+      break;
+    case GL_DOUBLE_MAT3x2:
+      glUniformMatrix3x2dv( loc, arraysize, GL_FALSE, doublearray );
+      break;
+    case GL_DOUBLE_MAT3x4:
+      glUniformMatrix3x4dv( loc, arraysize, GL_FALSE, doublearray );
+      break;
+    case GL_DOUBLE_MAT4x2:
+      glUniformMatrix4x2dv( loc, arraysize, GL_FALSE, doublearray );
+      break;
+    case GL_DOUBLE_MAT4x3:
+      glUniformMatrix4x3dv( loc, arraysize, GL_FALSE, doublearray );
+      break;
 
       /* textures */
     case GL_SAMPLER_1D:
@@ -413,6 +783,42 @@ struct glsl_program::t_uniform {
 };
 
 
+void glsl_program::t_uniformblock::write(const t_uniform&uni)
+{
+  size_t elemsize=sizeof(GLfloat);
+  const unsigned char*src=0;
+  switch(uni.paramtype) {
+  case GL_DOUBLE:
+    elemsize=sizeof(GLdouble);
+    src=reinterpret_cast<const unsigned char*>(uni.param.d.data());
+    break;
+  case GL_INT:
+    elemsize=sizeof(GLint);
+    src=reinterpret_cast<const unsigned char*>(uni.param.i.data());
+    break;
+  default:
+    src=reinterpret_cast<const unsigned char*>(uni.param.f.data());
+    break;
+  }
+  /* matrices are stored column by column (each column 'matrixstride' apart) */
+  size_t columns=1, rows=uni.paramsize;
+  if(uni.matrixstride<=0 || !uniform2matrix(uni.type, columns, rows)) {
+    columns=1;
+    rows=uni.paramsize;
+  }
+  for(GLint a=0; a<uni.arraysize; a++) {
+    for(size_t c=0; c<columns; c++) {
+      const size_t offset=uni.offset + a*uni.arraystride + c*uni.matrixstride;
+      if(offset+rows*elemsize > data.size()) {
+        break;
+      }
+      memcpy(&data[offset], src+(a*uni.paramsize + c*rows)*elemsize,
+             rows*elemsize);
+    }
+  }
+  serial++;
+}
+
 /////////////////////////////////////////////////////////
 //
 // glsl_program
@@ -432,7 +838,12 @@ glsl_program :: glsl_program()
   , m_geoInType(GL_TRIANGLES), m_geoOutType(GL_TRIANGLE_STRIP)
   , m_geoOutVertices(-1)
   , m_keepUniforms(true)
+  , m_useCache(true)
 {
+  int cache=1;
+  gem::Settings::get("glsl.cache", cache);
+  m_useCache=(0!=cache);
+
   int i=0;
   for(i=0; i<MAX_NUM_SHADERS; i++) {
     m_shaderObj[i]=0;
@@ -452,6 +863,7 @@ glsl_program :: ~glsl_program()
 {
   m_programmapper.del(m_programmapped);
   m_programmapped=0.;
+  releaseBlocks();
 
   if(m_program) {
     glDeleteProgram( m_program );
@@ -488,6 +900,11 @@ void glsl_program :: renderGL2()
   for(std::map<std::string, t_uniform>::iterator it = m_uniforms.begin(); it != m_uniforms.end(); it++) {
     it->second.applyGL2();
   }
+  for(unsigned int i=0; i<m_blocks.size(); i++) {
+    if(m_blocks[i]) {
+      m_blocks[i]->bind();
+    }
+  }
 }
 
 void glsl_program :: renderARB()
@@ -629,6 +1046,9 @@ void glsl_program :: paramMess(t_symbol*s,int argc, const t_atom *argv)
 void glsl_program :: keepUniformsMess(bool keep) {
   m_keepUniforms = keep;
 }
+void glsl_program :: cacheMess(bool state) {
+  m_useCache = state;
+}
 
 
 /////////////////////////////////////////////////////////
@@ -665,6 +1085,35 @@ void glsl_program :: shaderMess(int argc, t_atom *argv)
   setModified();
 }
 
+/////////////////////////////////////////////////////////
+// setTessellationDefaults
+//
+/////////////////////////////////////////////////////////
+void glsl_program :: setTessellationDefaults()
+{
+  if(!glPatchParameterfv) {
+    return;
+  }
+  float kInnerTessellationLevel = 1.0f;
+  float kOuterTessellationLevel = 1.0f;
+  const GLfloat innerTessLevels[2] = {
+    kInnerTessellationLevel, // inner horizontal
+    kInnerTessellationLevel  // inner vertical
+  };
+
+  const GLfloat outerTessLevels[4] = {
+    kOuterTessellationLevel, // outer left (vertical)
+    kOuterTessellationLevel, // outer bottom (horizontal)
+    kOuterTessellationLevel, // outer right (vertical)
+    kOuterTessellationLevel  // outer top (horizontal)
+  };
+
+  // We can define the tessellation levels using glPatchParameter if we don't
+  // have a Tessellation Control Shader stage.
+  glPatchParameterfv(GL_PATCH_DEFAULT_INNER_LEVEL, innerTessLevels);
+  glPatchParameterfv(GL_PATCH_DEFAULT_OUTER_LEVEL, outerTessLevels);
+}
+
 /////////////////////////////////////////////////////////
 // LinkProgram
 //
@@ -688,9 +1137,9 @@ bool glsl_program :: LinkGL2()
     m_program = 0;
   }
   m_program = glCreateProgram();
+
   for (i = 0; i < m_numShaders; i++) {
     GLint type;
-    glAttachShader( m_program, m_shaderObj[i] );
     glGetShaderiv ( m_shaderObj[i], GL_SHADER_TYPE, &type);
     switch(type) {
     case GL_VERTEX_SHADER:
@@ -711,6 +1160,31 @@ bool glsl_program :: LinkGL2()
     }
   }
 
+  std::string cachekey;
+  const bool useCache = m_useCache && haveProgramBinary();
+  if(useCache) {
+    cachekey = getCacheKey();
+  }
+  if(!cachekey.empty()) {
+    if(loadProgramBinary(m_program, cachekey)) {
+      verbose(1, "loaded linked program from the cache");
+      m_linked = 1;
+      /* the tessellation defaults are not part of the program binary */
+      if(numTessEvalShaders>0) {
+        setTessellationDefaults();
+      }
+      glUseProgram( m_program );
+      return true;
+    }
+    /* start afresh (the binary might have been rejected) */
+    glDeleteProgram( m_program );
+    m_program = glCreateProgram();
+  }
+
+  for (i = 0; i < m_numShaders; i++) {
+    glAttachShader( m_program, m_shaderObj[i] );
+  }
+
   /* setup geometry shader */
   if(numGeometryShaders>0 && glProgramParameteriEXT) {
     glProgramParameteriEXT(m_program,GL_GEOMETRY_INPUT_TYPE_EXT,m_geoInType);
@@ -723,32 +1197,21 @@ bool glsl_program :: LinkGL2()
     glProgramParameteriEXT(m_program,GL_GEOMETRY_VERTICES_OUT_EXT,temp);
   }
 
-  if(numTessEvalShaders>0 && glPatchParameterfv) {
-    float kInnerTessellationLevel = 1.0f;
-    float kOuterTessellationLevel = 1.0f;
-    const GLfloat innerTessLevels[2] = {
-      kInnerTessellationLevel, // inner horizontal
-      kInnerTessellationLevel  // inner vertical
-    };
-
-    const GLfloat outerTessLevels[4] = {
-      kOuterTessellationLevel, // outer left (vertical)
-      kOuterTessellationLevel, // outer bottom (horizontal)
-      kOuterTessellationLevel, // outer right (vertical)
-      kOuterTessellationLevel  // outer top (horizontal)
-    };
-
-    // We can define the tessellation levels using glPatchParameter if we don't
-    // have a Tessellation Control Shader stage.
-    glPatchParameterfv(GL_PATCH_DEFAULT_INNER_LEVEL, innerTessLevels);
-    glPatchParameterfv(GL_PATCH_DEFAULT_OUTER_LEVEL, outerTessLevels);
+  if(numTessEvalShaders>0) {
+    setTessellationDefaults();
   }
 
+  if(!cachekey.empty()) {
+    glProgramParameteri(m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
 
   GLint linkstatus = 0;
   glLinkProgram( m_program );
   glGetProgramiv( m_program, GL_LINK_STATUS, &linkstatus );
   m_linked = linkstatus;
+  if(linkstatus && !cachekey.empty()) {
+    storeProgramBinary(m_program, cachekey);
+  }
 
   glGetProgramiv( m_program, GL_INFO_LOG_LENGTH, &infoLength );
   GLchar *infoLog = new GLchar[infoLength];
@@ -778,6 +1241,46 @@ bool glsl_program :: LinkGL2()
   }
   return true;
 }
+/////////////////////////////////////////////////////////
+// getCacheKey
+//
+/////////////////////////////////////////////////////////
+std::string glsl_program :: getCacheKey()
+{
+  /* a program binary is only valid for the very same driver */
+  static const GLenum driverstrings[] = {
+    GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION
+  };
+  std::string key;
+  char buf[MAXPDSTRING];
+  for(unsigned int i=0; i<sizeof(driverstrings)/sizeof(*driverstrings); i++) {
+    const GLubyte*s=glGetString(driverstrings[i]);
+    if(s) {
+      key+=reinterpret_cast<const char*>(s);
+    }
+    key+="\n";
+  }
+  sprintf(buf, "geometry: 0x%X 0x%X %d\n", m_geoInType, m_geoOutType,
+          m_geoOutVertices);
+  key+=buf;
+
+  for(int i=0; i<m_numShaders; i++) {
+    GLint type=0, length=0;
+    glGetShaderiv(m_shaderObj[i], GL_SHADER_TYPE, &type);
+    glGetShaderiv(m_shaderObj[i], GL_SHADER_SOURCE_LENGTH, &length);
+    if(length<=0) {
+      /* no source, no key */
+      return "";
+    }
+    std::vector<GLchar>source(length);
+    glGetShaderSource(m_shaderObj[i], length, 0, &source[0]);
+    sprintf(buf, "shader: 0x%X %d\n", type, length);
+    key+=buf;
+    key+=&source[0];
+  }
+  return key;
+}
+
 /////////////////////////////////////////////////////////
 // LinkProgram
 //
@@ -946,6 +1449,40 @@ void glsl_program :: getVariables()
   std::map<std::string, t_uniform>olduniforms(m_uniforms);
   m_uniforms.clear();
 
+  //
+  // uniform blocks are shared (by name) with other programs
+  // (acquire the new blocks before releasing the old ones,
+  //  so the values survive re-linking)
+  //
+  std::vector<t_uniformblock*>oldblocks;
+  oldblocks.swap(m_blocks);
+  const bool haveBlocks = GLEW_VERSION_2_0
+                          && (GLEW_VERSION_3_1 || GLEW_ARB_uniform_buffer_object);
+  if(haveBlocks) {
+    GLint blockcount=0, maxbindings=0;
+    glGetProgramiv( m_program, GL_ACTIVE_UNIFORM_BLOCKS, &blockcount);
+    glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxbindings);
+    for (GLint i = 0; i < blockcount; i++) {
+      GLint namelength=0, size=0;
+      glGetActiveUniformBlockiv(m_program, i, GL_UNIFORM_BLOCK_NAME_LENGTH,
+                                &namelength);
+      glGetActiveUniformBlockiv(m_program, i, GL_UNIFORM_BLOCK_DATA_SIZE,
+                                &size);
+      std::vector<GLchar>blockname(namelength+1);
+      glGetActiveUniformBlockName(m_program, i, namelength+1, 0,
+                                  &blockname[0]);
+      t_uniformblock*block=t_uniformblock::acquire(&blockname[0], size);
+      if(block->binding >= static_cast<GLuint>(maxbindings)) {
+        error("too many uniform blocks: ignoring '%s'", block->name.c_str());
+        t_uniformblock::release(block);
+        block=0;
+      } else {
+        glUniformBlockBinding(m_program, i, block->binding);
+      }
+      m_blocks.push_back(block);
+    }
+  }
+
   for (GLuint i = 0; i < uniformcount; i++) {
     GLint loc, size, arraysize=1;
     GLenum type;
@@ -968,6 +1505,26 @@ void glsl_program :: getVariables()
     }
 
     name = removeArrayBrackets(name);
+
+    t_uniformblock*block=0;
+    GLint blockindex=-1, offset=0, arraystride=0, matrixstride=0;
+    if(haveBlocks) {
+      glGetActiveUniformsiv(m_program, 1, &i, GL_UNIFORM_BLOCK_INDEX, &blockindex);
+    }
+    if(blockindex>=0) {
+      if(static_cast<size_t>(blockindex) < m_blocks.size()) {
+        block=m_blocks[blockindex];
+      }
+      if(!block) {
+        continue;
+      }
+      glGetActiveUniformsiv(m_program, 1, &i, GL_UNIFORM_OFFSET, &offset);
+      glGetActiveUniformsiv(m_program, 1, &i, GL_UNIFORM_ARRAY_STRIDE,
+                            &arraystride);
+      glGetActiveUniformsiv(m_program, 1, &i, GL_UNIFORM_MATRIX_STRIDE,
+                            &matrixstride);
+    }
+
     std::map<std::string, t_uniform>::const_iterator it = olduniforms.find(name);
     if (olduniforms.end() == it || !m_keepUniforms) {
       m_uniforms[name] = t_uniform(this, loc, type, arraysize);
@@ -984,9 +1541,34 @@ void glsl_program :: getVariables()
         m_uniforms[name] = t_uniform(this, loc, type, arraysize);
       }
     }
+    t_uniform &uni = m_uniforms[name];
+    uni.block = block;
+    uni.offset = offset;
+    uni.arraystride = arraystride;
+    uni.matrixstride = matrixstride;
   }
   delete[]nameGL;
   delete[]nameARB;
+
+  for(unsigned int i=0; i<oldblocks.size(); i++) {
+    if(oldblocks[i]) {
+      t_uniformblock::release(oldblocks[i]);
+    }
+  }
+}
+
+void glsl_program :: releaseBlocks()
+{
+  for(unsigned int i=0; i<m_blocks.size(); i++) {
+    if(m_blocks[i]) {
+      t_uniformblock::release(m_blocks[i]);
+    }
+  }
+  m_blocks.clear();
+  /* the uniforms must not refer to released blocks */
+  for(std::map<std::string, t_uniform>::iterator it = m_uniforms.begin(); it != m_uniforms.end(); it++) {
+    it->second.block = 0;
+  }
 }
 
 /////////////////////////////////////////////////////////
@@ -1019,6 +1601,15 @@ void glsl_program :: printInfo()
     post("-> %d", program);
   }
 
+  for(unsigned int i=0; i<m_blocks.size(); i++) {
+    const t_uniformblock*block = m_blocks[i];
+    if(block) {
+      post("uniform block \"%s\": %d bytes at binding %d (shared by %d)",
+           block->name.c_str(), (int)block->data.size(), block->binding,
+           block->refcount);
+    }
+  }
+
   post("");
   for(std::map<std::string, t_uniform>::const_iterator it = m_uniforms.begin(); it != m_uniforms.end(); it++) {
     const t_uniform &uni = it->second;
@@ -1141,6 +1732,7 @@ void glsl_program :: obj_setupCallback(t_class *classPtr)
   CPPEXTERN_MSG (classPtr, "link", linkMess);
   CPPEXTERN_MSG0(classPtr, "print", printInfo);
   CPPEXTERN_MSG1(classPtr, "keepuniforms", keepUniformsMess, bool);
+  CPPEXTERN_MSG1(classPtr, "cache", cacheMess, bool);
 
   class_addmethod(classPtr,
                   reinterpret_cast<t_method>(&glsl_program::intypeMessCallback),
@@ -21,6 +21,7 @@ WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
 #include "Base/GemBase.h"
 #include "Utils/GLUtil.h"
 #include <map>
+#include <vector>
 
 #define MAX_NUM_SHADERS 32
 
@@ -37,6 +38,12 @@ WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
 
   DESCRIPTION
 
+  linked programs are cached on disk (as program binaries),
+  so they can be re-loaded without linking
+
+  uniform blocks are backed by uniform buffer objects,
+  that are shared (by block name) between all programs
+
   -----------------------------------------------------------------*/
 
 class GEM_EXTERN glsl_program : public GemBase
@@ -89,6 +96,8 @@ protected:
   virtual bool  LinkGL2(void);
   virtual bool  LinkARB(void);
   virtual void  LinkProgram(void);
+  // default tessellation levels (for programs without a control shader)
+  void          setTessellationDefaults(void);
 
   //////////
   // What can we play with?
@@ -112,6 +121,12 @@ protected:
   struct t_uniform;
   std::map<std::string, t_uniform>m_uniforms;
 
+  //////////
+  // uniform blocks used by the program
+  struct t_uniformblock;
+  std::vector<t_uniformblock*>m_blocks;
+  void releaseBlocks(void);
+
   gem::ContextData<GLint>m_linked;
   int m_numShaders;
 
@@ -135,6 +150,12 @@ protected:
   virtual void keepUniformsMess(bool);
   bool m_keepUniforms; /* should we keep uniforms across reloading of shaders?)*/
 
+  //////////
+  // the on-disk cache of linked programs
+  virtual void cacheMess(bool);
+  bool m_useCache;
+  std::string getCacheKey(void);
+
 
 private:
 
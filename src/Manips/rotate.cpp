@@ -15,6 +15,8 @@
 /////////////////////////////////////////////////////////
 
 #include "rotate.h"
+#include "Gem/ModelView.h"
+#include "Utils/Matrix.h"
 #include "Gem/GemGL.h"
 #include "Gem/Exception.h"
 
@@ -30,6 +32,7 @@ CPPEXTERN_NEW_WITH_GIMME(rotate);
 /////////////////////////////////////////////////////////
 rotate :: rotate(int argc, t_atom *argv)
 {
+  m_onlyTransforms=true;
   m_angle = 0.0;
   if (argc == 4) {
     m_angle = atom_getfloat(&argv[0]);
@@ -63,6 +66,11 @@ rotate :: ~rotate()
 /////////////////////////////////////////////////////////
 void rotate :: render(GemState *)
 {
+  Matrix*m=gem::ModelView::defer();
+  if(m) {
+    m->rotate(m_angle, m_vector[0], m_vector[1], m_vector[2]);
+    return;
+  }
   glRotatef(m_angle, m_vector[0], m_vector[1], m_vector[2]);
 }
 
@@ -15,6 +15,9 @@
 /////////////////////////////////////////////////////////
 
 #include "rotateXYZ.h"
+#include "Gem/ModelView.h"
+#include "Utils/Matrix.h"
+#include "Utils/Quaternion.h"
 #include "Gem/GemGL.h"
 #include "Gem/Exception.h"
 
@@ -30,6 +33,7 @@ CPPEXTERN_NEW_WITH_GIMME(rotateXYZ);
 /////////////////////////////////////////////////////////
 rotateXYZ :: rotateXYZ(int argc, t_atom *argv)
 {
+  m_onlyTransforms=true;
   if (argc == 3) {
     m_vector[0] = atom_getfloat(&argv[0]);
     m_vector[1] = atom_getfloat(&argv[1]);
@@ -61,6 +65,11 @@ rotateXYZ :: ~rotateXYZ()
 /////////////////////////////////////////////////////////
 void rotateXYZ :: render(GemState *)
 {
+  Matrix*m=gem::ModelView::defer();
+  if(m) {
+    m->rotate(Quaternion::fromEuler(m_vector[0], m_vector[1], m_vector[2]));
+    return;
+  }
   glRotatef(m_vector[0], 1.f, 0.f, 0.f);
   glRotatef(m_vector[1], 0.f, 1.f, 0.f);
   glRotatef(m_vector[2], 0.f, 0.f, 1.f);
@@ -15,6 +15,8 @@
 /////////////////////////////////////////////////////////
 
 #include "scale.h"
+#include "Gem/ModelView.h"
+#include "Utils/Matrix.h"
 #include "Gem/GemGL.h"
 #include "Gem/Exception.h"
 
@@ -30,6 +32,7 @@ CPPEXTERN_NEW_WITH_GIMME(scale);
 /////////////////////////////////////////////////////////
 scale :: scale(int argc, t_atom *argv)
 {
+  m_onlyTransforms=true;
   m_distance  = 0.0f;
   if (argc == 4) {
     m_distance = atom_getfloat(&argv[0]);
@@ -66,6 +69,12 @@ scale :: ~scale()
 /////////////////////////////////////////////////////////
 void scale :: render(GemState *)
 {
+  Matrix*m=gem::ModelView::defer();
+  if(m) {
+    m->scale(m_vector[0] * m_distance, m_vector[1] * m_distance,
+             m_vector[2] * m_distance);
+    return;
+  }
   glScalef(m_vector[0] * m_distance, m_vector[1] * m_distance,
            m_vector[2] * m_distance);
 }
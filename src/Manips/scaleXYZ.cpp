@@ -15,6 +15,8 @@
 /////////////////////////////////////////////////////////
 
 #include "scaleXYZ.h"
+#include "Gem/ModelView.h"
+#include "Utils/Matrix.h"
 #include "Gem/GemGL.h"
 #include "Gem/Exception.h"
 
@@ -30,6 +32,7 @@ CPPEXTERN_NEW_WITH_GIMME(scaleXYZ);
 /////////////////////////////////////////////////////////
 scaleXYZ :: scaleXYZ(int argc, t_atom *argv)
 {
+  m_onlyTransforms=true;
   if (argc == 3) {
     m_vector[0] = atom_getfloat(&argv[0]);
     m_vector[1] = atom_getfloat(&argv[1]);
@@ -65,6 +68,11 @@ scaleXYZ :: ~scaleXYZ()
 /////////////////////////////////////////////////////////
 void scaleXYZ :: render(GemState *)
 {
+  Matrix*m=gem::ModelView::defer();
+  if(m) {
+    m->scale(m_vector[0], m_vector[1], m_vector[2]);
+    return;
+  }
   glScalef(m_vector[0], m_vector[1], m_vector[2]);
 }
 
@@ -15,6 +15,8 @@
 /////////////////////////////////////////////////////////
 
 #include "translate.h"
+#include "Gem/ModelView.h"
+#include "Utils/Matrix.h"
 #include "Gem/GemGL.h"
 #include "Gem/Exception.h"
 
@@ -30,6 +32,7 @@ CPPEXTERN_NEW_WITH_GIMME(translate);
 /////////////////////////////////////////////////////////
 translate :: translate(int argc, t_atom *argv)
 {
+  m_onlyTransforms=true;
   m_distance  = 0.0;
   if (argc == 4) {
     m_distance = atom_getfloat(&argv[0]);
@@ -63,6 +66,12 @@ translate :: ~translate()
 /////////////////////////////////////////////////////////
 void translate :: render(GemState *)
 {
+  Matrix*m=gem::ModelView::defer();
+  if(m) {
+    m->translate(m_vector[0] * m_distance, m_vector[1] * m_distance,
+                 m_vector[2] * m_distance);
+    return;
+  }
   glTranslatef(m_vector[0] * m_distance, m_vector[1] * m_distance,
                m_vector[2] * m_distance);
 }
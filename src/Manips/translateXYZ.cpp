@@ -15,6 +15,8 @@
 /////////////////////////////////////////////////////////
 
 #include "translateXYZ.h"
+#include "Gem/ModelView.h"
+#include "Utils/Matrix.h"
 #include "Gem/GemGL.h"
 #include "Gem/Exception.h"
 
@@ -30,6 +32,7 @@ CPPEXTERN_NEW_WITH_GIMME(translateXYZ);
 /////////////////////////////////////////////////////////
 translateXYZ :: translateXYZ(int argc, t_atom *argv)
 {
+  m_onlyTransforms=true;
   if (argc == 3) {
     m_vector[0] = atom_getfloat(&argv[0]);
     m_vector[1] = atom_getfloat(&argv[1]);
@@ -59,6 +62,11 @@ translateXYZ :: ~translateXYZ()
 /////////////////////////////////////////////////////////
 void translateXYZ :: render(GemState *)
 {
+  Matrix*m=gem::ModelView::defer();
+  if(m) {
+    m->translate(m_vector[0], m_vector[1], m_vector[2]);
+    return;
+  }
   glTranslatef(m_vector[0], m_vector[1], m_vector[2]);
 }
 
@@ -616,9 +616,15 @@ bool gemglfw3window :: makeCurrent(void)
   if(!m_window) {
     return false;
   }
+  syncPresent();
   glfwMakeContextCurrent(m_window);
   return true;
 }
+bool gemglfw3window :: releaseCurrent(void)
+{
+  glfwMakeContextCurrent(0);
+  return true;
+}
 
 void gemglfw3window :: swapBuffers(void)
 {
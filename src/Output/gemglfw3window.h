@@ -47,6 +47,7 @@
   "cursor" - whether we want a cursor or not
   "menubar" - hide notorious menubars
   "topmost" - set the window to stay on top
+  "threaded" - threaded swap: swap the buffers in a separate thread
 
   -----------------------------------------------------------------*/
 
@@ -93,6 +94,8 @@ private:
 
   // check whether we have a window and if so, make it current
   virtual bool makeCurrent(void);
+  // hand the context over to another thread
+  virtual bool releaseCurrent(void);
   // swap buffers
   virtual void swapBuffers(void);
   // dispatch events
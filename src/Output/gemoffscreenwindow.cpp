@@ -0,0 +1,363 @@
+///////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+#include "Gem/GemConfig.h"
+
+#include "Gem/GemGL.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "gemoffscreenwindow.h"
+
+#include "RTE/MessageCallbacks.h"
+#include "Gem/Exception.h"
+
+#include <string.h>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+# define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+/* the EGL display is shared by all instances,
+ * and terminated once the last surface has been destroyed
+ */
+static EGLDisplay s_display=EGL_NO_DISPLAY;
+static unsigned int s_surfaces=0;
+
+static bool hasExtension(const char*extensions, const char*name)
+{
+  if(!extensions) {
+    return false;
+  }
+  const size_t len=strlen(name);
+  const char*s=extensions;
+  while((s=strstr(s, name))) {
+    if((s==extensions || ' '==s[-1]) && (' '==s[len] || 0==s[len])) {
+      return true;
+    }
+    s+=len;
+  }
+  return false;
+}
+
+static EGLDisplay getDisplay(void)
+{
+  if(EGL_NO_DISPLAY != s_display) {
+    return s_display;
+  }
+  EGLDisplay dpy=EGL_NO_DISPLAY;
+
+  /* prefer a display that does not need any display-server */
+  const char*clientext=eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+  if(hasExtension(clientext, "EGL_MESA_platform_surfaceless")) {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay=
+      (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if(getPlatformDisplay) {
+      dpy=getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY,
+                             0);
+    }
+  }
+  if(EGL_NO_DISPLAY == dpy) {
+    dpy=eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  }
+  if(EGL_NO_DISPLAY == dpy) {
+    return dpy;
+  }
+
+  EGLint major=0, minor=0;
+  if(!eglInitialize(dpy, &major, &minor)) {
+    return EGL_NO_DISPLAY;
+  }
+  ::verbose(1, "[gemoffscreenwindow] EGL-%d.%d: %s", major, minor,
+            eglQueryString(dpy, EGL_VENDOR));
+  s_display=dpy;
+  return s_display;
+}
+
+class gemoffscreenwindow::PIMPL
+{
+public:
+  EGLConfig config;
+  EGLContext context;
+  EGLSurface surface;
+
+  PIMPL(void)
+    : config(0)
+    , context(EGL_NO_CONTEXT)
+    , surface(EGL_NO_SURFACE)
+  { }
+
+  EGLSurface createSurface(unsigned int width, unsigned int height)
+  {
+    const EGLint attribs[] = {
+      EGL_WIDTH, static_cast<EGLint>(width),
+      EGL_HEIGHT, static_cast<EGLint>(height),
+      EGL_NONE
+    };
+    return eglCreatePbufferSurface(s_display, config, attribs);
+  }
+};
+
+CPPEXTERN_NEW(gemoffscreenwindow);
+
+/////////////////////////////////////////////////////////
+//
+// gemoffscreenwindow
+//
+/////////////////////////////////////////////////////////
+// Constructor
+//
+/////////////////////////////////////////////////////////
+gemoffscreenwindow :: gemoffscreenwindow(void) :
+  m_pimpl(new PIMPL())
+{
+  m_width = m_height = 0;
+}
+
+/////////////////////////////////////////////////////////
+// Destructor
+//
+/////////////////////////////////////////////////////////
+gemoffscreenwindow :: ~gemoffscreenwindow()
+{
+  destroyMess();
+  delete m_pimpl;
+  m_pimpl=0;
+}
+
+
+bool gemoffscreenwindow :: makeCurrent(void)
+{
+  if(EGL_NO_SURFACE == m_pimpl->surface) {
+    return false;
+  }
+  syncPresent();
+  return eglMakeCurrent(s_display, m_pimpl->surface, m_pimpl->surface,
+                        m_pimpl->context);
+}
+bool gemoffscreenwindow :: releaseCurrent(void)
+{
+  return eglMakeCurrent(s_display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                        EGL_NO_CONTEXT);
+}
+
+void gemoffscreenwindow :: swapBuffers(void)
+{
+  /* a pbuffer has no front buffer, so there is nothing to swap;
+   * make sure that the frame is actually rendered though */
+  if(makeCurrent()) {
+    glFlush();
+  }
+}
+
+void gemoffscreenwindow :: dispatch()
+{
+  /* no events */
+}
+
+
+/////////////////////////////////////////////////////////
+// dimensionsMess
+//
+/////////////////////////////////////////////////////////
+void gemoffscreenwindow :: dimensionsMess(unsigned int width,
+    unsigned int height)
+{
+  if (width < 1) {
+    error("width must be greater than 0");
+    return;
+  }
+
+  if (height < 1) {
+    error ("height must be greater than 0");
+    return;
+  }
+  m_width = width;
+  m_height = height;
+  if(EGL_NO_SURFACE == m_pimpl->surface) {
+    return;
+  }
+
+  /* pbuffers cannot be resized, so we replace the surface
+   * (keeping the context and thus all the resources) */
+  syncPresent();
+  EGLSurface surface=m_pimpl->createSurface(m_width, m_height);
+  if(EGL_NO_SURFACE == surface) {
+    error("couldn't resize offscreen surface to %dx%d", m_width, m_height);
+    return;
+  }
+  EGLSurface old=m_pimpl->surface;
+  m_pimpl->surface=surface;
+  if(!makeCurrent()) {
+    error("couldn't switch to resized offscreen surface");
+  }
+  eglDestroySurface(s_display, old);
+
+  dimension(m_width, m_height);
+  framebuffersize(m_width, m_height);
+}
+
+
+/////////////////////////////////////////////////////////
+// createMess
+//
+/////////////////////////////////////////////////////////
+bool gemoffscreenwindow :: create(void)
+{
+  if(EGL_NO_SURFACE != m_pimpl->surface) {
+    error("window already made!");
+    return false;
+  }
+  if(!m_width) {
+    m_width = 500;
+  }
+  if(!m_height) {
+    m_height = 500;
+  }
+
+  if(EGL_NO_DISPLAY == getDisplay()) {
+    error("couldn't open EGL display");
+    return false;
+  }
+  if(!eglBindAPI(EGL_OPENGL_API)) {
+    error("EGL does not support desktop openGL");
+    return false;
+  }
+
+  const EGLint fsaa=(m_fsaa>0)?m_fsaa:0;
+  const EGLint attribs[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_ALPHA_SIZE, 8,
+    EGL_DEPTH_SIZE, 24,
+    EGL_STENCIL_SIZE, 8,
+    EGL_SAMPLE_BUFFERS, fsaa?1:0,
+    EGL_SAMPLES, fsaa,
+    EGL_NONE
+  };
+  EGLint count=0;
+  if(!eglChooseConfig(s_display, attribs, &m_pimpl->config, 1, &count)
+      || count<1) {
+    error("no suitable EGL configuration found");
+    return false;
+  }
+
+  m_pimpl->context=eglCreateContext(s_display, m_pimpl->config,
+                                    EGL_NO_CONTEXT, 0);
+  if(EGL_NO_CONTEXT == m_pimpl->context) {
+    error("couldn't create EGL context");
+    return false;
+  }
+  m_pimpl->surface=m_pimpl->createSurface(m_width, m_height);
+  if(EGL_NO_SURFACE == m_pimpl->surface) {
+    error("couldn't create %dx%d offscreen surface", m_width, m_height);
+    eglDestroyContext(s_display, m_pimpl->context);
+    m_pimpl->context=EGL_NO_CONTEXT;
+    return false;
+  }
+  s_surfaces++;
+
+  if(!makeCurrent()) {
+    error("couldn't switch to offscreen context");
+  }
+  /* render as fast as we are asked to */
+  eglSwapInterval(s_display, 0);
+
+  if(!createGemWindow()) {
+    destroyMess();
+    return false;
+  }
+
+  dimension(m_width, m_height);
+  framebuffersize(m_width, m_height);
+
+  return true;
+}
+void gemoffscreenwindow :: createMess(const std::string&)
+{
+  create();
+}
+
+
+/////////////////////////////////////////////////////////
+// destroy window
+//
+/////////////////////////////////////////////////////////
+void gemoffscreenwindow :: destroy(void)
+{
+  destroyGemWindow();
+  info("window", "closed");
+}
+void gemoffscreenwindow :: destroyMess(void)
+{
+  if(EGL_NO_SURFACE == m_pimpl->surface) {
+    return;
+  }
+  makeCurrent();
+  destroy();
+
+  eglMakeCurrent(s_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  eglDestroySurface(s_display, m_pimpl->surface);
+  eglDestroyContext(s_display, m_pimpl->context);
+  m_pimpl->surface=EGL_NO_SURFACE;
+  m_pimpl->context=EGL_NO_CONTEXT;
+
+  if(s_surfaces && 0==--s_surfaces) {
+    eglTerminate(s_display);
+    s_display=EGL_NO_DISPLAY;
+  }
+}
+
+/////////////////////////////////////////////////////////
+// benchmarkMess
+//
+/////////////////////////////////////////////////////////
+void gemoffscreenwindow :: benchmarkMess(int frames)
+{
+  if(frames<1) {
+    error("number of frames must be greater than 0");
+    return;
+  }
+  if(!makeCurrent()) {
+    error("no offscreen surface to render to (create one first)");
+    return;
+  }
+
+  double starttime=sys_getrealtime();
+  for(int i=0; i<frames; i++) {
+    render();
+  }
+  if(makeCurrent()) {
+    /* wait until the GPU has really finished */
+    glFinish();
+  }
+  const double duration=sys_getrealtime()-starttime;
+
+  t_atom ap[3];
+  SETFLOAT(ap+0, frames);
+  SETFLOAT(ap+1, duration);
+  SETFLOAT(ap+2, (duration>0.)?(frames/duration):0.);
+  info(gensym("benchmark"), 3, ap);
+}
+
+/////////////////////////////////////////////////////////
+// static member function
+//
+/////////////////////////////////////////////////////////
+void gemoffscreenwindow :: obj_setupCallback(t_class *classPtr)
+{
+  CPPEXTERN_MSG1(classPtr, "benchmark", benchmarkMess, int);
+}
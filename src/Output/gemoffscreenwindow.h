@@ -0,0 +1,88 @@
+/*-----------------------------------------------------------------
+  LOG
+  GEM - Graphics Environment for Multimedia
+
+  Interface for the window manager
+
+  Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+  For information on usage and redistribution, and for a DISCLAIMER OF ALL
+  WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+  -----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_OUTPUT_GEMOFFSCREENWINDOW_H_
+#define _INCLUDE__GEM_OUTPUT_GEMOFFSCREENWINDOW_H_
+
+#include "Base/GemWindow.h"
+
+/*-----------------------------------------------------------------
+  -------------------------------------------------------------------
+  CLASS
+  gemoffscreenwindow
+
+  A headless window
+
+  DESCRIPTION
+
+  renders into an offscreen (pbuffer) surface via EGL,
+  so no display server is needed (e.g. on CI machines)
+  the surface can have any size, and there is no vsync:
+  a frame is rendered as soon as it is requested
+
+  "bang"  - render a frame now
+  "create" - create the offscreen surface
+  "destroy" - destroy the offscreen surface
+
+  "dimen" - the surface dimensions (can be changed on the fly)
+  "fsaa" - full screen anti-aliasing
+  "threaded" - threaded swap: swap the buffers in a separate thread
+
+  "benchmark" <n> - render <n> frames as fast as possible
+                    and report the time it took
+
+  -----------------------------------------------------------------*/
+
+
+class GEM_EXPORT gemoffscreenwindow : public GemWindow
+{
+  CPPEXTERN_HEADER(gemoffscreenwindow, GemWindow);
+
+public:
+
+  //////////
+  // Constructor
+  gemoffscreenwindow(void);
+
+private:
+
+  //////////
+  // Destructor
+  virtual ~gemoffscreenwindow(void);
+
+  /* window position/dimension */
+  virtual void    dimensionsMess(unsigned int width, unsigned int height);
+
+  /* creation/destruction */
+  virtual bool create (void);
+  virtual void destroy(void);
+
+  virtual void        createMess(const std::string&);
+  virtual void       destroyMess(void);
+
+  // check whether we have a surface and if so, make it current
+  virtual bool makeCurrent(void);
+  // hand the context over to another thread
+  virtual bool releaseCurrent(void);
+  // swap buffers
+  virtual void swapBuffers(void);
+  // dispatch events
+  virtual void dispatch(void);
+
+  /* render a number of frames back-to-back */
+  void benchmarkMess(int frames);
+
+  class PIMPL;
+  PIMPL*m_pimpl;
+};
+
+#endif    // for header file
@@ -74,6 +74,8 @@ PARTICLEDLL_API void pStartingAge(float age, float sigma = 1.0f);
 
 PARTICLEDLL_API void pTimeStep(float new_dt);
 
+PARTICLEDLL_API float pGetTimeStep();
+
 PARTICLEDLL_API void pVelocity(float x, float y, float z);
 
 PARTICLEDLL_API void pVelocityD(PDomainEnum dtype,
@@ -126,6 +128,8 @@ PARTICLEDLL_API int pGenParticleGroups(int p_group_count = 1,
 
 PARTICLEDLL_API int pGetGroupCount();
 
+PARTICLEDLL_API int pGetCurrentGroup();
+
 PARTICLEDLL_API int pGetParticles(int index, int count,
                                   float *position = NULL, float *color = NULL,
                                   float *vel = NULL, float *size = NULL, float *age = NULL);
@@ -501,6 +501,13 @@ PARTICLEDLL_API void pTimeStep(float newDT)
   _ps.dt = newDT;
 }
 
+PARTICLEDLL_API float pGetTimeStep()
+{
+  _ParticleState &_ps = _GetPState();
+
+  return _ps.dt;
+}
+
 ////////////////////////////////////////////////////////
 // Action List Calls
 
@@ -703,6 +710,14 @@ PARTICLEDLL_API void pCurrentGroup(int p_group_num)
   }
 }
 
+// Returns the number of the current particle group (or -1).
+PARTICLEDLL_API int pGetCurrentGroup()
+{
+  _ParticleState &_ps = _GetPState();
+
+  return _ps.group_id;
+}
+
 // Change the maximum number of particles in the current group.
 PARTICLEDLL_API int pSetMaxParticles(int max_count)
 {
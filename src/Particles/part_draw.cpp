@@ -16,6 +16,7 @@
 
 #include <string.h>
 #include "Gem/State.h"
+#include "Gem/Manager.h"
 
 #include "papi/papi.h"
 
@@ -31,14 +32,21 @@ CPPEXTERN_NEW(part_draw);
 /////////////////////////////////////////////////////////
 part_draw :: part_draw(void)
   : m_drawType(GL_LINES)
-{ }
+  , m_early(false)
+  , m_group(-1), m_timeStep(0.f)
+  , m_movePending(false), m_moved(false)
+{
+  GemMan::addPrepareCallback(prepareCallback, this);
+}
 
 /////////////////////////////////////////////////////////
 // Destructor
 //
 /////////////////////////////////////////////////////////
 part_draw :: ~part_draw(void)
-{ }
+{
+  GemMan::removePrepareCallback(prepareCallback, this);
+}
 
 /////////////////////////////////////////////////////////
 // renderParticles
@@ -51,13 +59,54 @@ void part_draw :: renderParticles(GemState *state)
   if (lighting)   {
     glDisable(GL_LIGHTING);
   }
-  if (m_tickTime > 0.f)   {
+  const int group=pGetCurrentGroup();
+  // in "early" mode, the particles have usually been moved between the frames already
+  if (m_tickTime > 0.f && !(m_moved && group == m_group))   {
     pMove();
   }
+  m_moved=false;
   pDrawGroupp(m_drawType);
   if (lighting) {
     glEnable(GL_LIGHTING);
   }
+
+  // move the particles for the next frame after the swap
+  m_group=group;
+  m_timeStep=pGetTimeStep();
+  m_movePending=(m_early && m_tickTime > 0.f);
+}
+
+/////////////////////////////////////////////////////////
+// earlyMess
+//
+/////////////////////////////////////////////////////////
+void part_draw :: earlyMess(bool early)
+{
+  m_early=early;
+  if(!m_early) {
+    m_movePending=false;
+  }
+}
+
+/////////////////////////////////////////////////////////
+// prepare
+//
+/////////////////////////////////////////////////////////
+void part_draw :: prepare(void)
+{
+  if (!m_movePending) {
+    return;
+  }
+  m_movePending=false;
+
+  const int group=pGetCurrentGroup();
+  const float timeStep=pGetTimeStep();
+  pCurrentGroup(m_group);
+  pTimeStep(m_timeStep);
+  pMove();
+  pCurrentGroup(group);
+  pTimeStep(timeStep);
+  m_moved=true;
 }
 
 /////////////////////////////////////////////////////////
@@ -94,4 +143,9 @@ void part_draw :: typeMess(t_symbol*s,int ac,t_atom* av)
 void part_draw :: obj_setupCallback(t_class *classPtr)
 {
   CPPEXTERN_MSG (classPtr, "draw", typeMess);
+  CPPEXTERN_MSG1(classPtr, "early", earlyMess, bool);
+}
+void part_draw :: prepareCallback(void *data)
+{
+  reinterpret_cast<part_draw*>(data)->prepare();
 }
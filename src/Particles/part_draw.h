@@ -53,6 +53,21 @@ protected:
 
   //////////
   int                               m_drawType;
+
+  //////////
+  // with "early 1", the particles are moved between the frames
+  // (see GemMan::addPrepareCallback) rather than when they are drawn;
+  // the [part_]-objects before [part_draw] then act on particles that have
+  // already been moved for the next frame
+  void                      earlyMess(bool early);
+  bool                              m_early;
+  void                      prepare(void);
+  int                               m_group;
+  float                             m_timeStep;
+  bool                              m_movePending, m_moved;
+
+private:
+  static void               prepareCallback(void *data);
 };
 
 #endif  // for header file
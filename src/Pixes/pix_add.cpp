@@ -20,6 +20,18 @@
 
 CPPEXTERN_NEW(pix_add);
 
+namespace
+{
+const char*s_fragmentShader =
+  "uniform sampler2D tex0;\n"
+  "uniform sampler2D tex1;\n"
+  "void main(void) {\n"
+  "  vec4 l = texture2D(tex0, gl_TexCoord[0].st);\n"
+  "  vec4 r = texture2D(tex1, gl_TexCoord[0].st);\n"
+  "  gl_FragColor = vec4(l.rgb + r.rgb, l.a);\n"
+  "}\n";
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_add
@@ -29,6 +41,7 @@ CPPEXTERN_NEW(pix_add);
 //
 /////////////////////////////////////////////////////////
 pix_add :: pix_add()
+  : m_gpu(s_fragmentShader)
 { }
 
 /////////////////////////////////////////////////////////
@@ -329,6 +342,20 @@ void pix_add :: processDualImage(imageStruct &image, imageStruct &right)
 }
 
 
+/////////////////////////////////////////////////////////
+// processDualTexture
+//
+/////////////////////////////////////////////////////////
+bool pix_add :: processDualTexture(pixBlock &image, pixBlock &right)
+{
+  return m_gpu.process(image, &right);
+}
+void pix_add :: stopRendering(void)
+{
+  GemPixDualObj::stopRendering();
+  m_gpu.release();
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
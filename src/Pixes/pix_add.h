@@ -17,6 +17,7 @@
 #define _INCLUDE__GEM_PIXES_PIX_ADD_H_
 
 #include "Base/GemPixDualObj.h"
+#include "Gem/ImageGPU.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -66,6 +67,12 @@ protected:
 #endif
 
   virtual void    processDualImage(imageStruct &image, imageStruct &right);
+
+  //////////
+  // Do the processing on the GPU
+  virtual bool    processDualTexture(pixBlock &image, pixBlock &right);
+  virtual void    stopRendering(void);
+  gem::image::GPUFilter m_gpu;
 };
 
 #endif  // for header file
@@ -11,6 +11,8 @@
 #define _INCLUDE__GEM_PIXES_PIX_BACKGROUND_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageMotion.h"
+#include "Utils/ThreadPool.h"
 
 /*-----------------------------------------------------------------
   -------------------------------------------------------------------
@@ -50,23 +52,22 @@ protected:
   virtual void  processRGBAImage(imageStruct &image);
   virtual void  processGrayImage(imageStruct &image);
   virtual void  processYUVImage (imageStruct &image);
-#ifdef __MMX__
-  virtual void processRGBAMMX   (imageStruct &image);
-  virtual void processYUVMMX    (imageStruct &image);
-  virtual void processGrayMMX   (imageStruct &image);
-#endif
-#ifdef __VEC__
+
   //////////
-  // Do the YUV Altivec processing
-  virtual void  processYUVAltivec(imageStruct &image);
-#endif
+  // blank everything that lies within 'range' of the saved image
+  // (the arrays are indexed by channel offsets, e.g. chRed)
+  void subtract(imageStruct &image,
+                const int range[4], const unsigned char key[4]);
 
   virtual void rangeNMess(int argc, t_atom*argv);
+  virtual void learnMess(t_float rate);
+  virtual void threadMess(int threads);
 
-  imageStruct   m_savedImage;
+  // the saved image (and the subtraction)
+  gem::image::Motion m_motion;
+  gem::thread::ThreadPool m_pool;
   int           m_Yrange,m_Urange,m_Vrange, m_Arange;
   t_inlet      *inletRange;
-  int           m_reset;
 
 
 private:
@@ -74,18 +74,24 @@ pix_blob :: ~pix_blob()
 // processImage
 //
 /////////////////////////////////////////////////////////
-void pix_blob :: processRGBAImage(imageStruct &image)
+void pix_blob :: outputBlob(unsigned int width, unsigned int height,
+                            double sum, double sum_x, double sum_y,
+                            double gain)
 {
-  unsigned char *pixels = image.data;
-  int rows  = image.ysize;
-
-  //t_float x_inv = 1./image.xsize;
-  //t_float y_inv = 1./image.ysize;
+  /* the coordinates are counted from the bottom-right corner */
+  const double sum_cols=(width -1)*sum - sum_x;
+  const double sum_rows=(height-1)*sum - sum_y;
+  outlet_float(m_zOut, sum/(width*height*255.*gain));
+  if (sum) {
+    outlet_float(m_yOut, 1 - sum_rows/(height*sum));
+    outlet_float(m_xOut, 1 - sum_cols/(width*sum));
+  }
+}
 
+void pix_blob :: processRGBAImage(imageStruct &image)
+{
   int channel = -1;
-  float gain_r = 0.3, gain_g = 0.3, gain_b = 0.3, gain_a = 0.1;
-
-  float sum = 0.0, sum_x = 0.0, sum_y = 0.0;
+  float gain[4] = {0.3, 0.3, 0.3, 0.1};
 
   switch (m_method) {
   case 1:
@@ -104,102 +110,59 @@ void pix_blob :: processRGBAImage(imageStruct &image)
   default:
     error("no method %d: using GREY", m_method);
   case 0:
-    gain_r = 0.3086;
-    gain_g = 0.6094;
-    gain_b = 0.082;
-    gain_a = 0.0;
+    gain[chRed]   = 0.3086;
+    gain[chGreen] = 0.6094;
+    gain[chBlue]  = 0.082;
+    gain[chAlpha] = 0.0;
     break;
   case -1:
-    gain_r = m_gain[chRed];
-    gain_g = m_gain[chGreen];
-    gain_b = m_gain[chBlue];
-    gain_a = m_gain[chAlpha];
+    gain[chRed]   = m_gain[chRed];
+    gain[chGreen] = m_gain[chGreen];
+    gain[chBlue]  = m_gain[chBlue];
+    gain[chAlpha] = m_gain[chAlpha];
   }
 
-  if (channel==-1) {
-    while (rows--) {
-      int cols = image.xsize;
-      while (cols--) {
-        float val  = gain_r * pixels[chRed] + gain_g * pixels[chGreen] +
-                     gain_b * pixels[chBlue] + gain_a * pixels[chAlpha];
-        sum   += val;
-        sum_y += rows * val;
-        sum_x += cols * val;
-        pixels+=4;
-      }
-    }
-  } else
-    while (rows--) {
-      int cols = image.xsize;
-      while (cols--) {
-        int val  = pixels[channel];
-        sum   += val;
-        sum_y += rows * val;
-        sum_x += cols * val;
-        pixels+=4;
-      }
-    }
+  if(!m_stats.analyze(image, gem::image::Statistics::CENTROID, &m_pool)) {
+    return;
+  }
 
-  outlet_float(m_zOut, sum/(image.xsize*image.ysize*255*
-                            (gain_r+gain_g+gain_b+gain_a)));
-  if (sum) {
-    outlet_float(m_yOut, 1 - sum_y/(image.ysize*sum));
-    outlet_float(m_xOut, 1 - sum_x/(image.xsize*sum));
+  /* the centroid of a weighted sum of channels is the weighted sum of the
+   * per-channel centroids */
+  double sum = 0.0, sum_x = 0.0, sum_y = 0.0, gainsum = 0.0;
+  for(int c=0; c<4; c++) {
+    const double g = (channel<0)?gain[c]:(c==channel);
+    sum   += g * m_stats.sum [c];
+    sum_x += g * m_stats.sumX[c];
+    sum_y += g * m_stats.sumY[c];
+    gainsum += gain[c];
   }
+
+  outputBlob(image.xsize, image.ysize, sum, sum_x, sum_y, gainsum);
 }
 void pix_blob :: processGrayImage(imageStruct &image)
 {
-  unsigned char *pixels = image.data;
-  int rows  = image.ysize;
-
-  //  float sum = 0.0, sum_x = 0.0, sum_y = 0.0;
-  int sum = 0, sum_x = 0, sum_y = 0;
-
-  while (rows--) {
-    int cols = image.xsize;
-    while (cols--) {
-      int val  = *pixels++;
-      sum   += val;
-      sum_y += rows * val;
-      sum_x += cols * val;
-    }
-  }
-
-  t_float sumf=sum/(image.xsize*image.ysize*255.);
-  outlet_float(m_zOut, sumf);
-  if (sum) {
-    t_float sumxf=(static_cast<t_float>(sum_x)/(sum*image.xsize));
-    t_float sumyf=(static_cast<t_float>(sum_y)/(sum*image.ysize));
-    outlet_float(m_yOut, 1 - sumyf);
-    outlet_float(m_xOut, 1 - sumxf);
+  if(!m_stats.analyze(image, gem::image::Statistics::CENTROID, &m_pool)) {
+    return;
   }
+  outputBlob(image.xsize, image.ysize,
+             m_stats.sum[chGray], m_stats.sumX[chGray], m_stats.sumY[chGray]);
 }
 void pix_blob :: processYUVImage(imageStruct &image)
 {
-  unsigned char *pixels = image.data;
-  int rows  = image.ysize;
-
-  int sum = 0, sum_x = 0,sum_y = 0;
-  while (rows--) {
-    int cols = image.xsize;
-    while (cols--) {
-      int val  = pixels[chY0];
-      sum   += val;
-      sum_y += rows * val;
-      sum_x += cols * val;
-      pixels+=2;
-    }
-  }
-
-  t_float sumf=sum/(image.xsize*image.ysize*255.);
-  outlet_float(m_zOut, sumf);
-  if (sum) {
-    t_float sumxf=(static_cast<t_float>(sum_x)/(sum*image.xsize));
-    t_float sumyf=(static_cast<t_float>(sum_y)/(sum*image.ysize));
-    outlet_float(m_yOut, 1 - sumyf);
-    outlet_float(m_xOut, 1 - sumxf);
+  if(!m_stats.analyze(image, gem::image::Statistics::CENTROID, &m_pool)) {
+    return;
   }
+  /* the statistics are per macropixel: Y0 is at 2*x, Y1 at 2*x+1 */
+  const double sum   = m_stats.sum[chY0] + m_stats.sum[chY1];
+  const double sum_x = 2*(m_stats.sumX[chY0] + m_stats.sumX[chY1])
+                        + m_stats.sum[chY1];
+  const double sum_y = m_stats.sumY[chY0] + m_stats.sumY[chY1];
+  outputBlob(image.xsize, image.ysize, sum, sum_x, sum_y);
+}
 
+void pix_blob :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
 }
 
 /////////////////////////////////////////////////////////
@@ -256,6 +219,7 @@ void pix_blob :: obj_setupCallback(t_class *classPtr)
   class_addmethod(classPtr,
                   reinterpret_cast<t_method>(&pix_blob::gainMessCallback),
                   gensym("gain"), A_GIMME, A_NULL);
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
 }
 
 void pix_blob :: gainMessCallback(void *data, t_symbol*, int argc,
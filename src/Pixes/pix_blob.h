@@ -24,6 +24,8 @@ pix_blob
 #define _INCLUDE__GEM_PIXES_PIX_BLOB_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageStatistics.h"
+#include "Utils/ThreadPool.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -63,6 +65,19 @@ protected:
   virtual void    processGrayImage(imageStruct &image);
   virtual void    processYUVImage(imageStruct &image);
 
+  //////////
+  // image statistics (optionally calculated on several threads)
+  gem::image::Statistics m_stats;
+  gem::thread::ThreadPool m_pool;
+  void threadMess(int threads);
+
+  //////////
+  // output the (normalized) centroid
+  // 'sum_x' resp. 'sum_y' are the value-weighted column resp. row indices
+  void outputBlob(unsigned int width, unsigned int height,
+                  double sum, double sum_x, double sum_y,
+                  double gain=1.);
+
   //////////
   void            ChannelMess(int  channel);
   void            GainMess(int argc, t_atom *argv);
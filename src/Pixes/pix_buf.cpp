@@ -16,6 +16,7 @@
 
 #include "pix_buf.h"
 #include "Gem/State.h"
+#include "Gem/ImageGPU.h"
 
 #include "Gem/Cache.h"
 
@@ -54,6 +55,7 @@ void pix_buf :: render(GemState *state)
   pixBlock*img=NULL;
   state->get(GemState::_PIX, img);
   orgPixBlock = img;
+  img=gem::image::GPUFilter::hostImage(img, m_hostImage);
 
   if (!img || !img->image.data) {
     return;
@@ -76,6 +76,10 @@ protected:
   void            autoMess(int);
   bool            m_auto;
 
+
+  //////////
+  // texture-resident images are read back into here
+  pixBlock m_hostImage;
 };
 
 #endif  // for header file
@@ -18,6 +18,7 @@
 
 #include "pix_buffer.h"
 #include "Gem/ImageIO.h"
+#include "Gem/ImageCompress.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -93,8 +94,10 @@ pix_buffer :: pix_buffer(t_symbol* s,t_float f=100.0)
   : m_buffer(NULL),
     m_numframes(0),
     m_bindname(NULL),
+    m_compress(0),
     m_handle(NULL),
-    m_outlet(new gem::RTE::Outlet(this))
+    m_outlet(new gem::RTE::Outlet(this)),
+    m_clock(NULL)
 {
   if (s==&s_) {
     static int buffercounter=0;
@@ -117,6 +120,8 @@ pix_buffer :: pix_buffer(t_symbol* s,t_float f=100.0)
 
   pd_bind(&this->x_obj->ob_pd, m_bindname);
   outlet_new(this->x_obj, &s_float);
+
+  m_clock=clock_new(this, reinterpret_cast<t_method>(tickCallback));
 }
 /////////////////////////////////////////////////////////
 // Destructor
@@ -126,6 +131,15 @@ pix_buffer :: ~pix_buffer( void )
 {
   pd_unbind(&this->x_obj->ob_pd, m_bindname);
 
+  std::set<gem::image::save::id_t>::iterator it;
+  for(it=m_saving.begin(); it!=m_saving.end(); ++it) {
+    gem::image::save::cancel(*it);
+  }
+  if(m_clock) {
+    clock_free(m_clock);
+  }
+  m_clock=NULL;
+
   if(m_buffer) {
     delete [] m_buffer;
   }
@@ -235,6 +249,11 @@ bool pix_buffer :: putMess(imageStruct*img, unsigned int pos)
   if(!img) {
     return false;
   }
+  if(m_compress && !imageStruct::blockSize(img->format)
+      && gem::image::compress::encode(*img, m_buffer[pos], m_compress,
+                                      &m_pool)) {
+    return true;
+  }
   img->copy2Image(m_buffer+pos);
   return true;
 }
@@ -269,7 +288,8 @@ void pix_buffer :: loadMess(std::string filename, int pos)
   // GRH: muss i wie in pix_image die ganzen andern Sachen a machen ????
 
   // load an image into mem
-  imageStruct *image = NULL;
+  const imageStruct *image = NULL;
+  gem::Properties props;
 
   // some checks
   if (pos<0 || pos>=m_numframes) {
@@ -278,16 +298,19 @@ void pix_buffer :: loadMess(std::string filename, int pos)
   }
   std::string file=findFile(filename);
 
-  image = image2mem(file.c_str());
+  /* the image is shared with the image cache, so loading the same file
+   * into several slots (or buffers) only decodes it once */
+  image = gem::image::load::acquire(file, props);
   if(!image) {
     error("'%s' is no valid image!", file.c_str());
     return;
   }
 
-  putMess(image,pos);
+  /* putMess() only reads from the image */
+  putMess(const_cast<imageStruct*>(image),pos);
 
-  // destroy the image-data
-  delete image;
+  // give the image-data back to the cache
+  gem::image::load::release(image);
 }
 
 /////////////////////////////////////////////////////////
@@ -307,10 +330,25 @@ void pix_buffer :: saveMess(std::string filename, int pos)
 
   if(img && img->data) {
     std::string fullname=gem::files::getFullpath(filename);
-    if(m_handle) {
-      m_handle->save(*img, fullname, std::string(), m_writeprops);
+    /* the slot might be overwritten while the image is being encoded */
+    imageStruct*copy=new imageStruct;
+    gem::image::save::id_t ID=gem::image::save::INVALID;
+    if(imageStruct::blockSize(img->format)) {
+      /* the image savers only know about uncompressed pixels */
+      if(!copy->convertFrom(img, GEM_RGBA)) {
+        delete copy;
+        saved(ID, fullname, false);
+        return;
+      }
     } else {
-      mem2image(img, fullname.c_str(), 0);
+      img->copy2Image(copy);
+    }
+    if(!gem::image::save::async(savedCallback, this, copy, fullname,
+                                std::string(), m_writeprops, ID)) {
+      saved(ID, fullname, false);
+    } else if(gem::image::save::IMMEDIATE != ID) {
+      m_saving.insert(ID);
+      clock_delay(m_clock, 0);
     }
   } else {
     error("index %d out of range (0..%d) or slot empty!", pos, m_numframes);
@@ -337,6 +375,59 @@ void pix_buffer :: copyMess(int src, int dst)
   }
 }
 
+/////////////////////////////////////////////////////////
+// compressMess
+//
+/////////////////////////////////////////////////////////
+void pix_buffer :: compressMess(t_symbol*s, int argc, t_atom*argv)
+{
+  if(1!=argc) {
+    error("usage: compress 0|bc1|bc3");
+    return;
+  }
+  unsigned int format=0;
+  if(A_FLOAT==argv->a_type) {
+    if(0!=atom_getint(argv)) {
+      error("usage: compress 0|bc1|bc3");
+      return;
+    }
+  } else {
+    const std::string name=atom_getsymbol(argv)->s_name;
+    if("bc1"==name || "dxt1"==name) {
+      format=GEM_BC1;
+    } else if("bc3"==name || "dxt5"==name) {
+      format=GEM_BC3;
+    } else {
+      error("unknown compression '%s' (use 'bc1' or 'bc3')", name.c_str());
+      return;
+    }
+  }
+  m_compress=format;
+}
+void pix_buffer :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
+}
+
+/////////////////////////////////////////////////////////
+// saved
+//
+/////////////////////////////////////////////////////////
+void pix_buffer :: saved(gem::image::save::id_t ID,
+                         const std::string&filename, bool success)
+{
+  m_saving.erase(ID);
+  std::vector<gem::any>data;
+  if(success) {
+    data.push_back(std::string("success"));
+  } else {
+    error("unable to save image to '%s'", filename.c_str());
+    data.push_back(std::string("fail"));
+  }
+  data.push_back(filename);
+  m_outlet->send("save", data);
+}
+
 void pix_buffer :: enumProperties(void)
 {
   std::vector<std::string> mimetypes;
@@ -431,6 +522,8 @@ void pix_buffer :: obj_setupCallback(t_class *classPtr)
   CPPEXTERN_MSG2(classPtr, "save", saveMess, std::string, int);
   CPPEXTERN_MSG2(classPtr, "copy", copyMess, int, int);
   CPPEXTERN_MSG (classPtr, "allocate", allocateMess);
+  CPPEXTERN_MSG (classPtr, "compress", compressMess);
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
 
   CPPEXTERN_MSG0(classPtr, "enumProps",  enumProperties);
   CPPEXTERN_MSG0(classPtr, "clearProps", clearProperties);
@@ -526,3 +619,18 @@ void pix_buffer :: allocateMess(t_symbol*s, int argc, t_atom*argv)
 
   allocateMess((int)x, (int)y, (int)c);
 }
+void pix_buffer :: savedCallback(void*data, gem::image::save::id_t ID,
+                                 const std::string&filename, bool success)
+{
+  pix_buffer*me=reinterpret_cast<pix_buffer*>(data);
+  me->saved(ID, filename, success);
+}
+void pix_buffer :: tickCallback(void*data)
+{
+  pix_buffer*me=reinterpret_cast<pix_buffer*>(data);
+  /* there is no render loop to deliver the saved images, so poll */
+  gem::image::save::poll();
+  if(!me->m_saving.empty()) {
+    clock_delay(me->m_clock, 10);
+  }
+}
@@ -19,6 +19,10 @@ LOG
 #include "Gem/Image.h"
 
 #include "Gem/Properties.h"
+#include "Gem/ImageIO.h"
+#include "Utils/ThreadPool.h"
+
+#include <set>
 
 #define DEFAULT_NUM_FRAMES 100
 
@@ -77,10 +81,20 @@ public:
 
   virtual void  resizeMess(int);
 
+  //////////
+  // store incoming images block compressed (GEM_BC1, GEM_BC3) or not (0)
+  void          compressMess(t_symbol*,int,t_atom*);
+  void          threadMess(int);
+
   virtual void enumProperties( void );
   virtual void clearProperties( void );
   virtual void setProperties( t_symbol*, int, t_atom*);
 
+  //////////
+  // called (in the main thread) when an image has been saved
+  virtual void  saved(gem::image::save::id_t ID, const std::string&filename,
+                      bool success);
+
 protected:
   imageStruct    *m_buffer;
   unsigned int m_numframes;
@@ -88,8 +102,23 @@ protected:
 
   gem::Properties m_writeprops;
 
+  //////////
+  // the block compressed format for storing images (or 0)
+  unsigned int m_compress;
+  gem::thread::ThreadPool m_pool;
+
   gem::plugins::imagesaver*m_handle;
   gem::RTE::Outlet*m_outlet;
+
+  //////////
+  // images that are being saved in the background
+  std::set<gem::image::save::id_t>m_saving;
+  t_clock*m_clock;
+
+private:
+  static void savedCallback(void*data, gem::image::save::id_t ID,
+                            const std::string&filename, bool success);
+  static void tickCallback(void*data);
 };
 
 #endif  // for header file
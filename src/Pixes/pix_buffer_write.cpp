@@ -15,6 +15,7 @@
 #include "pix_buffer.h"
 #include "pix_buffer_write.h"
 #include "Gem/State.h"
+#include "Gem/ImageGPU.h"
 
 /*
  * we export the "pix_buffer_class"
@@ -93,6 +94,7 @@ void pix_buffer_write :: render(GemState*state)
   }
   pixBlock*img=NULL;
   state->get(GemState::_PIX, img);
+  img=gem::image::GPUFilter::hostImage(img, m_hostImage);
   if (state && img && &img->image) {
     if (img->newimage || m_frame!=m_lastframe) {
       if(m_bindname==NULL || m_bindname->s_name==NULL) {
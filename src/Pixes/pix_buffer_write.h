@@ -16,6 +16,7 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_BUFFER_WRITE_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/Image.h"
 
 /*-----------------------------------------------------------------
   -------------------------------------------------------------------
@@ -64,6 +65,10 @@ private:
   // static member functions
   static void setMessCallback  (void*data, t_symbol*s);
   static void frameMessCallback(void*data, t_float  f);
+
+  //////////
+  // texture-resident images are read back into here
+  pixBlock m_hostImage;
 };
 
 #endif  // for header file
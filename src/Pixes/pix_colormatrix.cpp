@@ -19,6 +19,16 @@
 
 CPPEXTERN_NEW(pix_colormatrix);
 
+namespace
+{
+const char*s_fragmentShader =
+  "uniform sampler2D tex0;\n"
+  "uniform mat4 matrix;\n"
+  "void main(void) {\n"
+  "  gl_FragColor = matrix * texture2D(tex0, gl_TexCoord[0].st);\n"
+  "}\n";
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_colormatrix
@@ -28,6 +38,7 @@ CPPEXTERN_NEW(pix_colormatrix);
 //
 /////////////////////////////////////////////////////////
 pix_colormatrix :: pix_colormatrix()
+  : m_gpu(s_fragmentShader)
 {
   // zero out the matrix
   for (int i = 0; i < 16; i++) {
@@ -112,6 +123,20 @@ void pix_colormatrix :: matrixMess(int argc, t_atom *argv)
   setPixModified();
 }
 
+/////////////////////////////////////////////////////////
+// processTexture
+//
+/////////////////////////////////////////////////////////
+bool pix_colormatrix :: processTexture(pixBlock &image)
+{
+  m_gpu.setUniformMatrix("matrix", m_matrix);
+  return m_gpu.process(image);
+}
+void pix_colormatrix :: stopRendering(void)
+{
+  m_gpu.release();
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
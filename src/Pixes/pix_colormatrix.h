@@ -17,6 +17,7 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_COLORMATRIX_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageGPU.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -63,6 +64,13 @@ protected:
   // The matrix
   float           m_matrix[16];
 
+  //////////
+  // Do the processing on the GPU
+  virtual bool    processTexture(pixBlock &image);
+  virtual void    stopRendering(void);
+  gem::image::GPUFilter m_gpu;
+
+
 private:
 
   //////////
@@ -20,6 +20,18 @@
 
 CPPEXTERN_NEW(pix_composite);
 
+namespace
+{
+const char*s_fragmentShader =
+  "uniform sampler2D tex0;\n"
+  "uniform sampler2D tex1;\n"
+  "void main(void) {\n"
+  "  vec4 l = texture2D(tex0, gl_TexCoord[0].st);\n"
+  "  vec4 r = texture2D(tex1, gl_TexCoord[0].st);\n"
+  "  gl_FragColor = vec4(mix(r.rgb, l.rgb, l.a), l.a);\n"
+  "}\n";
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_composite
@@ -29,6 +41,7 @@ CPPEXTERN_NEW(pix_composite);
 //
 /////////////////////////////////////////////////////////
 pix_composite :: pix_composite()
+  : m_gpu(s_fragmentShader)
 { }
 
 /////////////////////////////////////////////////////////
@@ -184,6 +197,20 @@ void pix_composite :: processRGBA_MMX(imageStruct &image,
   _mm_empty();
 }
 #endif
+/////////////////////////////////////////////////////////
+// processDualTexture
+//
+/////////////////////////////////////////////////////////
+bool pix_composite :: processDualTexture(pixBlock &image, pixBlock &right)
+{
+  return m_gpu.process(image, &right);
+}
+void pix_composite :: stopRendering(void)
+{
+  GemPixDualObj::stopRendering();
+  m_gpu.release();
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
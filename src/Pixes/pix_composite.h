@@ -16,6 +16,7 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_COMPOSITE_H_
 
 #include "Base/GemPixDualObj.h"
+#include "Gem/ImageGPU.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -57,6 +58,12 @@ protected:
   virtual void        processRGBA_MMX(imageStruct &image,
                                       imageStruct &right);
 #endif
+
+  //////////
+  // Do the processing on the GPU
+  virtual bool    processDualTexture(pixBlock &image, pixBlock &right);
+  virtual void    stopRendering(void);
+  gem::image::GPUFilter m_gpu;
 };
 
 #endif  // for header file
@@ -18,6 +18,7 @@
 #include "pix_cubemap.h"
 
 #include "Gem/Image.h"
+#include "Gem/ImageGPU.h"
 #include <string.h>
 
 //#define DEBUG_ME
@@ -227,6 +228,7 @@ void pix_cubemap :: render(GemState *state)
   /* here comes the work: a new image has to be transferred from main memory to GPU and attached to a texture object */
   pixBlock*img=NULL;
   state->get(GemState::_PIX, img);
+  img=gem::image::GPUFilter::hostImage(img, m_hostImage[0]);
   if(img) {
     if(img->newimage) {
       m_img[0]=&img->image;
@@ -286,9 +288,11 @@ void pix_cubemap :: rightImage(int id, GemState *state)
   }
   if(id<0 || id>=6) {
     error("not a valid image-slot %d", id);
+    return;
   }
   pixBlock*img=NULL;
   state->get(GemState::_PIX, img);
+  img=gem::image::GPUFilter::hostImage(img, m_hostImage[id]);
 
   if(img) {
     if(img->newimage) {
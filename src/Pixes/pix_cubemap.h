@@ -156,6 +156,8 @@ protected:
   void applyTex(GLint, imageStruct*);
   void rightImage(int id, GemState *state);
   imageStruct*m_img[6];
+  // texture-resident images are read back into here
+  pixBlock m_hostImage[6];
 
   void texunitMess(int);
   void mapMess(int);
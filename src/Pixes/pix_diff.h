@@ -17,6 +17,7 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_DIFF_H_
 
 #include "Base/GemPixDualObj.h"
+#include "Utils/ThreadPool.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -53,18 +54,10 @@ protected:
   virtual void    processYUV_YUV(imageStruct &image, imageStruct &right);
   virtual void    processGray_Gray(imageStruct &image, imageStruct &right);
 
-#ifdef __MMX__
-  virtual void    processRGBA_MMX(imageStruct &image, imageStruct &right);
-  virtual void    processYUV_MMX (imageStruct &image, imageStruct &right);
-  virtual void    processGray_MMX(imageStruct &image, imageStruct &right);
-
-#endif
-
-#ifdef __VEC__
-  virtual void    processRGBA_Altivec(imageStruct &image,
-                                      imageStruct &right);
-  virtual void    processYUV_Altivec(imageStruct &image, imageStruct &right);
-#endif
+  //////////
+  // the difference is optionally calculated on several threads
+  gem::thread::ThreadPool m_pool;
+  void threadMess(int threads);
 };
 
 #endif  // for header file
@@ -18,6 +18,7 @@
 
 #include "Gem/Image.h"
 #include "Gem/State.h"
+#include "Gem/ImageGPU.h"
 
 CPPEXTERN_NEW(pix_draw);
 
@@ -57,6 +58,7 @@ void pix_draw :: render(GemState *state)
   int orientation=1;
   pixBlock*img=NULL;
   state->get(GemState::_PIX, img);
+  img=gem::image::GPUFilter::hostImage(img, m_hostImage);
   if ( !img || !&img->image ) {
     return;
   }
@@ -16,6 +16,7 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_DRAW_H_
 
 #include "Base/GemBase.h"
+#include "Gem/Image.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -49,6 +50,10 @@ protected:
   //////////
   // Do the rendering
   virtual void    render(GemState *state);
+
+  //////////
+  // texture-resident images are read back into here
+  pixBlock m_hostImage;
 };
 
 #endif  // for header file
@@ -22,6 +22,7 @@ WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
 #endif
 
 #include "plugins/film.h"
+#include <vector>
 
 
 /*-----------------------------------------------------------------
@@ -135,6 +135,14 @@ private:
     }
 
   public:
+    static inline FFUInt32 getDepth(const imageStruct&image)
+    {
+      return csize2depth(image.csize);
+    }
+    static inline FFUInt32 getOrientation(const imageStruct&image)
+    {
+      return updown2orientation(image.upsidedown);
+    }
     FFInstance(FF_Main_FuncPtr plugin, VideoInfoStruct&vis)
       : m_instance(NULL)
       , m_plugin(plugin)
@@ -209,6 +217,17 @@ private:
   FF_Main_FuncPtr m_plugin;
   FFInstance     *m_instance;
 
+  /* slice mode: one instance per horizontal band of the image */
+  struct Slice {
+    FFInstance*instance;
+    unsigned int start, stop; /* the rows this slice is responsible for */
+    unsigned int first, last; /* the rows the instance actually sees (including overlap) */
+    std::vector<unsigned char>buffer;
+  };
+  std::vector<Slice>m_slices;
+  unsigned int m_sliceCount, m_sliceOverlap;
+  imageStruct m_sliceImage; /* dimensions the slices were created for */
+
   std::string m_id;
 
   std::string m_description;
@@ -601,6 +620,12 @@ private:
     SetParameterStruct sps = { ParameterNumber, ParameterValue};
     FFMixed input;
     input.PointerValue = &sps;
+    for(unsigned int i=0; i<m_slices.size(); i++) {
+      m_slices[i].instance->call(FF_SETPARAMETER, input);
+    }
+    if(!m_instance && !m_slices.empty()) {
+      return true;
+    }
     FFMixed result = callInstance(FF_SETPARAMETER, input);
 
     return (FF_SUCCESS == result.UIntValue);
@@ -649,8 +674,94 @@ private:
       delete m_instance;
     }
     m_instance=NULL;
+    deinstantiateSlices_();
     return true;
   }
+  bool instantiateSlices_(const imageStruct&img,
+                          unsigned int numSlices, unsigned int overlap)
+  {
+    deinstantiate_();
+    m_sliceImage.xsize=img.xsize;
+    m_sliceImage.ysize=img.ysize;
+    m_sliceImage.csize=img.csize;
+    m_sliceImage.upsidedown=img.upsidedown;
+    m_sliceCount=numSlices;
+    m_sliceOverlap=overlap;
+
+    VideoInfoStruct vis;
+    vis.FrameWidth =img.xsize;
+    vis.BitDepth   =FFInstance::getDepth(img);
+    vis.Orientation=FFInstance::getOrientation(img);
+    if(0==vis.BitDepth) {
+      return false;
+    }
+
+    for(unsigned int i=0; i<numSlices; i++) {
+      Slice slice;
+      gem::thread::ThreadPool::getSlice(i, numSlices, img.ysize,
+                                        slice.start, slice.stop);
+      if(slice.start>=slice.stop) {
+        break;
+      }
+      slice.first=(slice.start>overlap)?(slice.start-overlap):0;
+      slice.last =slice.stop+overlap;
+      if(slice.last>static_cast<unsigned int>(img.ysize)) {
+        slice.last=img.ysize;
+      }
+      vis.FrameHeight=slice.last-slice.first;
+      try {
+        slice.instance = new FFInstance(m_plugin, vis);
+      } catch (GemException&x) {
+        x.report("pix_freeframe");
+        deinstantiateSlices_();
+        return false;
+      }
+      if(overlap) {
+        slice.buffer.resize(img.xsize*img.csize*vis.FrameHeight);
+      }
+      m_slices.push_back(slice);
+      applyParameters_(slice.instance);
+    }
+    return true;
+  }
+  bool deinstantiateSlices_(void)
+  {
+    for(unsigned int i=0; i<m_slices.size(); i++) {
+      delete m_slices[i].instance;
+    }
+    m_slices.clear();
+    return true;
+  }
+  /* bring a freshly created instance up to date with the current parameters */
+  void applyParameters_(FFInstance*instance)
+  {
+    for(unsigned int i=0; i<m_parameterNames.size(); i++) {
+      const std::string&key=m_parameterNames[i];
+      SetParameterStruct sps;
+      sps.ParameterNumber=i;
+      std::string str;
+      double d;
+      switch(m_parameter.type(key)) {
+      case gem::Properties::DOUBLE:
+        if(!m_parameter.get(key, d)) {
+          continue;
+        }
+        sps.NewParameterValue.FloatValue=d;
+        break;
+      case gem::Properties::STRING:
+        if(!m_parameter.get(key, str)) {
+          continue;
+        }
+        sps.NewParameterValue.PointerValue=const_cast<char*>(str.c_str());
+        break;
+      default:
+        continue;
+      }
+      FFMixed input;
+      input.PointerValue = &sps;
+      instance->call(FF_SETPARAMETER, input);
+    }
+  }
   bool processFrameCopy_(ProcessFrameCopyStruct&pfcs)
   {
     return false;
@@ -722,6 +833,8 @@ public:
     : m_name(name)
     , m_plugin(NULL)
     , m_instance(NULL)
+    , m_sliceCount(0)
+    , m_sliceOverlap(0)
     , m_rgba(false)
     , m_type(FF_EFFECT)
     , m_majorVersion(0)
@@ -787,6 +900,7 @@ public:
       return true;
     }
     if(!m_instance) {
+      deinstantiateSlices_();
       instantiate_(img);
     }
     if(m_instance) {
@@ -803,6 +917,60 @@ public:
     }
     return false;
   }
+
+  class SliceJob : public gem::thread::ThreadPool::Job
+  {
+  public:
+    FFPlugin*plugin;
+    imageStruct&image;
+    SliceJob(FFPlugin*p, imageStruct&img)
+      : plugin(p), image(img)
+    { }
+    virtual void process(unsigned int index, unsigned int numSlices)
+    {
+      Slice&slice=plugin->m_slices[index];
+      const size_t rowsize=image.xsize*image.csize;
+      FFMixed input;
+      if(slice.buffer.empty()) {
+        input.PointerValue = image.data+rowsize*slice.first;
+        slice.instance->call(FF_PROCESSFRAME, input);
+        return;
+      }
+      /* with overlap, the bands must not be processed in-place */
+      memcpy(&slice.buffer[0], image.data+rowsize*slice.first,
+             rowsize*(slice.last-slice.first));
+      input.PointerValue = &slice.buffer[0];
+      slice.instance->call(FF_PROCESSFRAME, input);
+      memcpy(image.data+rowsize*slice.start,
+             &slice.buffer[rowsize*(slice.start-slice.first)],
+             rowsize*(slice.stop-slice.start));
+    }
+  };
+  bool processFrame(imageStruct&img, gem::thread::ThreadPool&pool,
+                    unsigned int overlap)
+  {
+    unsigned int numSlices=pool.getThreads();
+    /* only effects can be processed in bands */
+    if(numSlices<2 || FF_EFFECT != m_type) {
+      return processFrame(img);
+    }
+    if(NULL==img.data) {
+      return true;
+    }
+    if(m_slices.empty()
+        || m_sliceCount!=numSlices || m_sliceOverlap!=overlap
+        || m_sliceImage.xsize!=img.xsize || m_sliceImage.ysize!=img.ysize
+        || m_sliceImage.csize!=img.csize
+        || m_sliceImage.upsidedown!=img.upsidedown) {
+      instantiateSlices_(img, numSlices, overlap);
+    }
+    if(m_slices.empty()) {
+      return false;
+    }
+    SliceJob job(this, img);
+    pool.run(job, m_slices.size());
+    return true;
+  }
   std::string getParameterDisplay(FFUInt32 ParameterNumber)
   {
     return getParameterDisplay_(ParameterNumber);
@@ -904,6 +1072,8 @@ pix_freeframe :: pix_freeframe(t_symbol*s)
 #ifndef DONT_WANT_FREEFRAME
   : m_plugin(NULL)
   , m_canopen(false)
+  , m_threads(1)
+  , m_overlap(0)
 #endif /* DONT_WANT_FREEFRAME */
 {
 #ifdef DONT_WANT_FREEFRAME
@@ -1011,16 +1181,31 @@ void pix_freeframe :: processImage(imageStruct &image)
 
   // convert the current image into a format that suits the FreeFrame-plugin
   m_image.setCsizeByFormat();
-  if(image.format != m_image.format) {
-    if(m_image.convertFrom(&image)) {
-      m_plugin->processFrame(m_image);
-      m_image.convertTo(&image);
-    }
+  imageStruct&img=(image.format != m_image.format)?m_image:image;
+  if(&img == &m_image && !m_image.convertFrom(&image)) {
+    return;
+  }
+  if(m_threads>1) {
+    m_plugin->processFrame(img, m_pool, m_overlap);
   } else {
-    m_plugin->processFrame(image);
+    m_plugin->processFrame(img);
+  }
+  if(&img == &m_image) {
+    m_image.convertTo(&image);
   }
 }
 
+void pix_freeframe :: threadMess(int threads)
+{
+  m_threads=m_pool.setThreads(threads);
+  setPixModified();
+}
+void pix_freeframe :: overlapMess(unsigned int rows)
+{
+  m_overlap=rows;
+  setPixModified();
+}
+
 
 void pix_freeframe :: parmMess(std::string key, t_atom *value)
 {
@@ -1137,6 +1322,10 @@ void pix_freeframe :: obj_setupCallback(t_class *classPtr)
   class_addmethod  (classPtr,
                     reinterpret_cast<t_method>(&pix_freeframe::openCallback), gensym("load"),
                     A_SYMBOL, A_NULL);
+#ifndef DONT_WANT_FREEFRAME
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
+  CPPEXTERN_MSG1(classPtr, "overlap", overlapMess, unsigned int);
+#endif /* DONT_WANT_FREEFRAME */
   gem_register_loader(freeframe_loader);
 }
 
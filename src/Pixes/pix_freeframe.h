@@ -16,6 +16,8 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_FREEFRAME_H_
 
 #include "Base/GemPixObj.h"
+#include "Utils/ThreadPool.h"
+#include <vector>
 /*
 #if defined SIZEOF_VOID_P && defined SIZEOF_UNSIGNED_INT
 # if SIZEOF_VOID_P != SIZEOF_UNSIGNED_INT
@@ -88,6 +90,16 @@ protected:
 
   void openMess(t_symbol*name);
   void closeMess(void);
+
+  //////////
+  // slice mode: process horizontal bands of the image in parallel,
+  // each with its own instance of the plugin
+  gem::thread::ThreadPool m_pool;
+  unsigned int m_threads;
+  // number of rows each band additionally sees above/below
+  unsigned int m_overlap;
+  void threadMess(int threads);
+  void overlapMess(unsigned int rows);
 #endif /* DONT_WANT_FREEFRAME */
 
 private:
@@ -246,6 +246,9 @@ public:
     m_instance=f0r_construct(width, height);
     m_width=width;
     m_height=height;
+    if(m_instance) {
+      applyParameters(m_instance);
+    }
     return (m_instance!=NULL);
   }
   void destruct(void)
@@ -254,10 +257,74 @@ public:
       f0r_destruct(m_instance);
     }
     m_instance=NULL;
+    destructSlices();
   }
 
   f0r_instance_t m_instance;
 
+  /* slice mode: one instance per horizontal band of the image */
+  struct Slice {
+    f0r_instance_t instance;
+    unsigned int start, stop; /* the rows this slice is responsible for */
+    unsigned int first, last; /* the rows the instance actually sees (including overlap) */
+    std::vector<uint32_t>buffer;
+  };
+  std::vector<Slice>m_slices;
+  unsigned int m_sliceCount;
+  unsigned int m_sliceOverlap;
+
+  bool constructSlices(unsigned int width, unsigned int height,
+                       unsigned int numSlices, unsigned int overlap)
+  {
+    destructSlices();
+    m_width=width;
+    m_height=height;
+    m_sliceCount=numSlices;
+    m_sliceOverlap=overlap;
+    /* frei0r wants multiples of 8, so the overlap must keep the bands aligned */
+    overlap=(overlap+7)&~7u;
+    for(unsigned int i=0; i<numSlices; i++) {
+      Slice slice;
+      /* frei0r wants multiples of 8 */
+      gem::thread::ThreadPool::getSlice(i, numSlices, height,
+                                        slice.start, slice.stop, 8);
+      if(slice.start>=slice.stop) {
+        break;
+      }
+      slice.first=(slice.start>overlap)?(slice.start-overlap):0;
+      slice.last =slice.stop+overlap;
+      if(slice.last>height) {
+        slice.last=height;
+      }
+      slice.instance=f0r_construct(width, slice.last-slice.first);
+      if(!slice.instance) {
+        destructSlices();
+        return false;
+      }
+      applyParameters(slice.instance);
+      if(overlap) {
+        slice.buffer.resize(width*(slice.last-slice.first));
+      }
+      m_slices.push_back(slice);
+    }
+    return true;
+  }
+  void destructSlices(void)
+  {
+    for(unsigned int i=0; i<m_slices.size(); i++) {
+      f0r_destruct(m_slices[i].instance);
+    }
+    m_slices.clear();
+  }
+
+  /* the parameters currently set, so they can be applied to new instances */
+  struct Parameter {
+    int type;
+    double value[3];
+    std::string string;
+  };
+  std::map<unsigned int, Parameter>m_parameterCache;
+
   std::string m_name;
   std::string m_author;
   int   m_type;
@@ -316,6 +383,7 @@ public:
   F0RPlugin(const std::string&name) :
     m_width(0), m_height(0),
     m_instance(NULL),
+    m_sliceCount(0), m_sliceOverlap(0),
     m_name(""), m_author(""),
     m_type(0), m_color(0),
     m_frei0rVersion(0), m_majorVersion(0), m_minorVersion(0),
@@ -349,55 +417,98 @@ public:
     }
   }
 
-  bool set(unsigned int key, bool value)
+  void setParameter(f0r_instance_t instance, unsigned int key,
+                    const Parameter&p)
   {
-    if(!m_instance) {
-      return false;
+    f0r_param_bool b;
+    f0r_param_double d;
+    f0r_param_position pos;
+    f0r_param_color col;
+    f0r_param_string str;
+    switch(p.type) {
+    case F0R_PARAM_BOOL:
+      b=p.value[0];
+      f0r_set_param_value(instance, &b, key);
+      break;
+    case F0R_PARAM_DOUBLE:
+      d=p.value[0];
+      f0r_set_param_value(instance, &d, key);
+      break;
+    case F0R_PARAM_POSITION:
+      pos.x=p.value[0];
+      pos.y=p.value[1];
+      f0r_set_param_value(instance, &pos, key);
+      break;
+    case F0R_PARAM_COLOR:
+      col.r=p.value[0];
+      col.g=p.value[1];
+      col.b=p.value[2];
+      f0r_set_param_value(instance, &col, key);
+      break;
+    case F0R_PARAM_STRING:
+      str=const_cast<f0r_param_string>(p.string.c_str());
+      f0r_set_param_value(instance, &str, key);
+      break;
+    default:
+      break;
     }
-    f0r_param_bool v=value;
-    f0r_set_param_value(m_instance, &v, key);
-    return true;
   }
-  bool set(unsigned int key, double value)
+  void applyParameters(f0r_instance_t instance)
   {
-    if(!m_instance) {
-      return false;
+    std::map<unsigned int, Parameter>::iterator it;
+    for(it=m_parameterCache.begin(); it!=m_parameterCache.end(); ++it) {
+      setParameter(instance, it->first, it->second);
     }
-    f0r_param_double v=value;
-    f0r_set_param_value(m_instance, &v, key);
-    return true;
   }
-  bool set(unsigned int key, double x, double y)
+  bool set(unsigned int key, const Parameter&p)
   {
-    if(!m_instance) {
-      return false;
+    m_parameterCache[key]=p;
+    if(m_instance) {
+      setParameter(m_instance, key, p);
+    }
+    for(unsigned int i=0; i<m_slices.size(); i++) {
+      setParameter(m_slices[i].instance, key, p);
     }
-    f0r_param_position v;
-    v.x=x;
-    v.y=y;
-    f0r_set_param_value(m_instance, &v, key);
     return true;
   }
+
+  bool set(unsigned int key, bool value)
+  {
+    Parameter p;
+    p.type=F0R_PARAM_BOOL;
+    p.value[0]=value;
+    return set(key, p);
+  }
+  bool set(unsigned int key, double value)
+  {
+    Parameter p;
+    p.type=F0R_PARAM_DOUBLE;
+    p.value[0]=value;
+    return set(key, p);
+  }
+  bool set(unsigned int key, double x, double y)
+  {
+    Parameter p;
+    p.type=F0R_PARAM_POSITION;
+    p.value[0]=x;
+    p.value[1]=y;
+    return set(key, p);
+  }
   bool set(unsigned int key, double r, double g, double b)
   {
-    if(!m_instance) {
-      return false;
-    }
-    f0r_param_color v;
-    v.r=r;
-    v.g=g;
-    v.b=b;
-    f0r_set_param_value(m_instance, &v, key);
-    return true;
+    Parameter p;
+    p.type=F0R_PARAM_COLOR;
+    p.value[0]=r;
+    p.value[1]=g;
+    p.value[2]=b;
+    return set(key, p);
   }
   bool set(unsigned int key, std::string s)
   {
-    if(!m_instance) {
-      return false;
-    }
-    f0r_param_string v=const_cast<f0r_param_string>(s.c_str());
-    f0r_set_param_value(m_instance, &v, key);
-    return true;
+    Parameter p;
+    p.type=F0R_PARAM_STRING;
+    p.string=s;
+    return set(key, p);
   }
 
 
@@ -418,6 +529,66 @@ public:
     return true;
   }
 
+  class SliceJob : public gem::thread::ThreadPool::Job
+  {
+  public:
+    F0RPlugin*plugin;
+    double time;
+    const uint32_t*input;
+    uint32_t*output;
+    SliceJob(F0RPlugin*p, double t, imageStruct&in, imageStruct&out)
+      : plugin(p), time(t)
+      , input(reinterpret_cast<const uint32_t*>(in.data))
+      , output(reinterpret_cast<uint32_t*>(out.data))
+    { }
+    virtual void process(unsigned int index, unsigned int numSlices)
+    {
+      Slice&slice=plugin->m_slices[index];
+      const unsigned int width=plugin->m_width;
+      if(slice.buffer.empty()) {
+        plugin->f0r_update(slice.instance, time,
+                           input+width*slice.first, output+width*slice.first);
+        return;
+      }
+      /* with overlap, render into a private buffer and only keep our own rows */
+      plugin->f0r_update(slice.instance, time,
+                         input+width*slice.first, &slice.buffer[0]);
+      memcpy(output+width*slice.start,
+             &slice.buffer[width*(slice.start-slice.first)],
+             sizeof(uint32_t)*width*(slice.stop-slice.start));
+    }
+  };
+
+  bool process(double time, imageStruct&input, imageStruct&output,
+               gem::thread::ThreadPool&pool, unsigned int overlap)
+  {
+    unsigned int numSlices=pool.getThreads();
+    /* only filters can be processed in bands,
+     * and only if all bands are multiples of 8 rows high */
+    if(numSlices<2 || F0R_PLUGIN_TYPE_FILTER != m_type || input.ysize%8) {
+      destructSlices();
+      return process(time, input, output);
+    }
+
+    if(m_slices.empty()
+        || m_sliceCount!=numSlices || m_sliceOverlap!=overlap
+        || m_width!=input.xsize || m_height!=input.ysize) {
+      if(m_instance) {
+        f0r_destruct(m_instance);
+      }
+      m_instance=NULL;
+      constructSlices(input.xsize, input.ysize, numSlices, overlap);
+    }
+    if(m_slices.empty()) {
+      return false;
+    }
+
+    SliceJob job(this, time, input, output);
+    pool.run(job, m_slices.size());
+
+    return true;
+  }
+
   GemDylib m_dylib;
 };
 
@@ -437,6 +608,8 @@ CPPEXTERN_NEW_WITH_ONE_ARG(pix_frei0r,  t_symbol*, A_DEFSYMBOL);
 pix_frei0r :: pix_frei0r(t_symbol*s)
   : m_plugin(NULL)
   , m_canopen(false)
+  , m_threads(1)
+  , m_overlap(0)
 {
   //  throw(GemException("Gem has been compiled without Frei0r-support!"));
   int can_rgba=0;
@@ -584,7 +757,13 @@ void pix_frei0r :: processRGBAImage(imageStruct &image)
   if(GL_UNSIGNED_INT_8_8_8_8 == m_image.type) {
     swapBytes(image);
   }
-  m_plugin->process(time, image, m_image);
+  if(m_threads>1) {
+    m_plugin->process(time, image, m_image, m_pool, m_overlap);
+  } else {
+    /* the per-slice instances are no longer needed */
+    m_plugin->destructSlices();
+    m_plugin->process(time, image, m_image);
+  }
   time++;
 
   image.data   = m_image.data;
@@ -595,6 +774,17 @@ void pix_frei0r :: processRGBAImage(imageStruct &image)
   image.setCsizeByFormat(m_image.format);
 }
 
+void pix_frei0r :: threadMess(int threads)
+{
+  m_threads=m_pool.setThreads(threads);
+  setPixModified();
+}
+void pix_frei0r :: overlapMess(unsigned int rows)
+{
+  m_overlap=rows;
+  setPixModified();
+}
+
 void pix_frei0r :: parmMess(const std::string&key, int argc, t_atom *argv)
 {
   if(!m_plugin) {
@@ -777,6 +967,8 @@ void pix_frei0r :: obj_setupCallback(t_class *classPtr)
   class_addanything(classPtr,
                     reinterpret_cast<t_method>(&pix_frei0r::parmCallback));
   CPPEXTERN_MSG1(classPtr, "load", openMess, t_symbol*);
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
+  CPPEXTERN_MSG1(classPtr, "overlap", overlapMess, unsigned int);
   gem_register_loader(frei0r_loader);
   gem_register_loader_nopath(frei0r_loader);
   frei0r_paths_initialize();
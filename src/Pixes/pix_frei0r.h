@@ -16,6 +16,8 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_FREI_R_H_
 
 #include "Base/GemPixObj.h"
+#include "Utils/ThreadPool.h"
+#include <vector>
 
 #ifndef DONT_WANT_FREI0R
 
@@ -73,6 +75,19 @@ protected:
   void openMess(t_symbol*name);
   void closeMess(void);
 
+  //////////
+  // slice mode: process horizontal bands of the image in parallel,
+  // each with its own instance of the plugin
+  // (frei0r wants bands of multiples of 8 rows, so images whose height is
+  //  not a multiple of 8 are processed as a whole)
+  gem::thread::ThreadPool m_pool;
+  unsigned int m_threads;
+  // number of rows each band additionally sees above/below
+  // (for filters that access neighbouring pixels; rounded up to a multiple of 8)
+  unsigned int m_overlap;
+  void threadMess(int threads);
+  void overlapMess(unsigned int rows);
+
 private:
   static void parmCallback(void *data, t_symbol*s, int argc, t_atom*argv);
 
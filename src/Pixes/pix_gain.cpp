@@ -22,6 +22,21 @@
 
 CPPEXTERN_NEW_WITH_GIMME(pix_gain);
 
+namespace
+{
+const char*s_fragmentShader =
+  "uniform sampler2D tex0;\n"
+  "uniform vec4 gain;\n"
+  "uniform float saturate;\n"
+  "void main(void) {\n"
+  "  vec4 c = texture2D(tex0, gl_TexCoord[0].st) * gain;\n"
+  "  if(saturate < 0.5) {\n"
+  "    c = mod(floor(c * 255.), 256.) / 255.;\n"
+  "  }\n"
+  "  gl_FragColor = c;\n"
+  "}\n";
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_gain
@@ -32,6 +47,7 @@ CPPEXTERN_NEW_WITH_GIMME(pix_gain);
 /////////////////////////////////////////////////////////
 pix_gain :: pix_gain(int argc, t_atom *argv)
   : m_saturate(true)
+  , m_gpu(s_fragmentShader)
 {
   inlet_new(this->x_obj, &this->x_obj->ob_pd, gensym("float"),
             gensym("ft1"));
@@ -447,6 +463,22 @@ void pix_gain :: saturateMess(int sat)
   setPixModified();
 }
 
+/////////////////////////////////////////////////////////
+// processTexture
+//
+/////////////////////////////////////////////////////////
+bool pix_gain :: processTexture(pixBlock &image)
+{
+  m_gpu.setUniform("gain", m_gain[chRed], m_gain[chGreen], m_gain[chBlue],
+                   m_gain[chAlpha]);
+  m_gpu.setUniform("saturate", m_saturate?1.f:0.f);
+  return m_gpu.process(image);
+}
+void pix_gain :: stopRendering(void)
+{
+  m_gpu.release();
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
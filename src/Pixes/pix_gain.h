@@ -17,6 +17,7 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_GAIN_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageGPU.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -90,6 +91,13 @@ protected:
   //////////
   bool  m_saturate;
 
+  //////////
+  // Do the processing on the GPU
+  virtual bool    processTexture(pixBlock &image);
+  virtual void    stopRendering(void);
+  gem::image::GPUFilter m_gpu;
+
+
 private:
 
   //////////
@@ -23,6 +23,39 @@
 
 CPPEXTERN_NEW(pix_halftone);
 
+namespace
+{
+/* runs a member function of pix_halftone on the slices of a job */
+class SliceJob : public gem::thread::ThreadPool::Job
+{
+public:
+  typedef void (pix_halftone::*Method)(unsigned int, unsigned int);
+  pix_halftone*obj;
+  Method method;
+  SliceJob(pix_halftone*o, Method m)
+    : obj(o), method(m)
+  { }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    (obj->*method)(slice, numSlices);
+  }
+};
+
+void runJob(gem::thread::ThreadPool::Job&job, unsigned int size,
+            gem::thread::ThreadPool&pool)
+{
+  unsigned int numSlices=pool.getThreads();
+  if(numSlices>size) {
+    numSlices=size;
+  }
+  if(numSlices<2) {
+    job.process(0, 1);
+    return;
+  }
+  pool.run(job, numSlices);
+}
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_halftone
@@ -36,7 +69,11 @@ pix_halftone :: pix_halftone() :
   m_Style(0),
   m_Angle(0.0f),
   m_Smoothing(128),
-  init(0)
+  init(0),
+  m_rebuild(true),
+  m_layoutWidth(0), m_layoutHeight(0), m_layoutFormat(0),
+  m_layoutCellSize(0),
+  m_source(0)
 {
   inlet_new(this->x_obj, &this->x_obj->ob_pd, gensym("float"),
             gensym("size"));
@@ -60,184 +97,7 @@ pix_halftone :: ~pix_halftone()
 /////////////////////////////////////////////////////////
 void pix_halftone :: processRGBAImage(imageStruct &image)
 {
-  const int nWidth = image.xsize;
-  const int nHeight = image.ysize;
-
-  U32*pSource = reinterpret_cast<U32*>(image.data);
-
-  myImage.xsize = image.xsize;
-  myImage.ysize = image.ysize;
-  myImage.setCsizeByFormat(image.format);
-  myImage.reallocate();
-  U32*pOutput = reinterpret_cast<U32*>(myImage.data);
-
-  int nCellSize=clampFunc(m_CellSize,1,nMaxCellSize);
-  int nStyle=clampFunc(m_Style,0,4);
-  int nSmoothingThreshold=clampFunc(m_Smoothing,0,255);
-
-  const float AngleRadians=m_Angle;
-  const int nCellSizeFP=(nCellSize<<nFPShift);
-
-  const int nHalfWidth=(nWidth/2);
-  const int nHalfHeight=(nHeight/2);
-
-  unsigned char* pDotFuncTableStart=&g_pDotFuncTable[0];
-
-  Pete_HalfTone_MakeDotFuncTable(pDotFuncTableStart,nCellSize,nStyle,
-                                 255.0f);
-
-  unsigned char* pGreyScaleTableStart=&g_pGreyScaleTable[0];
-
-  Pete_HalfTone_MakeGreyScaleTable(pGreyScaleTableStart,nSmoothingThreshold);
-
-  SPete_HalfTone_Point Left;
-  SPete_HalfTone_Point Right;
-  SPete_HalfTone_Point Top;
-  SPete_HalfTone_Point Bottom;
-  Pete_HalfTone_CalcCorners(nWidth,nHeight,AngleRadians,nCellSize,&Left,
-                            &Right,&Top,&Bottom);
-
-  //U32 TestColour=0x00ffffff;
-  int nCurrentV;
-  for (nCurrentV=Bottom.nY; nCurrentV<Top.nY; nCurrentV+=nCellSizeFP) {
-    int nSnappedV=((nCurrentV+(nCellSizeFP*1024))/nCellSize);
-    nSnappedV>>=nFPShift;
-    nSnappedV<<=nFPShift;
-    nSnappedV*=nCellSize;
-    nSnappedV-=(nCellSizeFP*1024);
-
-    int nLeftU;
-    int nRightU;
-    Pete_HalfTone_CalcSpanEnds(&Left,&Right,&Top,&Bottom,nSnappedV,&nLeftU,
-                               &nRightU);
-
-    int nCurrentU;
-    for (nCurrentU=nLeftU; nCurrentU<nRightU; nCurrentU+=nCellSizeFP) {
-      int nSnappedU=(((nCurrentU+(nCellSizeFP*1024))/nCellSize));
-      nSnappedU>>=nFPShift;
-      nSnappedU<<=nFPShift;
-      nSnappedU*=nCellSize;
-      nSnappedU-=(nCellSizeFP*1024);
-
-      SPete_HalfTone_Vertex RotatedPoints[4]= {
-        {{nSnappedU,nSnappedV},                               {0,0}},
-        {{(nSnappedU+nCellSizeFP),nSnappedV},                 {nCellSizeFP-nFPMult,0}},
-        {{(nSnappedU+nCellSizeFP),(nSnappedV+nCellSizeFP)},   {nCellSizeFP-nFPMult,nCellSizeFP-nFPMult}},
-        {{nSnappedU,(nSnappedV+nCellSizeFP)},                 {0,nCellSizeFP-nFPMult}}
-      };
-
-      SPete_HalfTone_Vertex ScreenSpacePoints[4];
-      Pete_HalfTone_RotateMultipleVertices(
-        &RotatedPoints[0],
-        &ScreenSpacePoints[0],
-        4,
-        AngleRadians);
-
-      int nCount;
-      for (nCount=0; nCount<4; nCount+=1) {
-        ScreenSpacePoints[nCount].Pos.nX+=(nHalfWidth<<nFPShift);
-        ScreenSpacePoints[nCount].Pos.nY+=(nHalfHeight<<nFPShift);
-        ScreenSpacePoints[nCount].Pos.nX&=0xffff0000;
-        ScreenSpacePoints[nCount].Pos.nY&=0xffff0000;
-      }
-
-      SPete_HalfTone_Vertex CellLeft;
-      SPete_HalfTone_Vertex CellRight;
-      SPete_HalfTone_Vertex CellTop;
-      SPete_HalfTone_Vertex CellBottom;
-      Pete_HalfTone_GetRasterizationVertices(
-        &ScreenSpacePoints[0],
-        &CellLeft,&CellRight,&CellTop,&CellBottom);
-
-      const int nSampleTopY=(ScreenSpacePoints[0].Pos.nY>>nFPShift);
-      //const int nSampleBottomY=(nSampleTopY+nCellSize);
-      //const int nSampleCenterY=(nSampleTopY+nHalfCellSize);
-      const int nSampleLeftX=(ScreenSpacePoints[0].Pos.nX>>nFPShift);
-      //const int nSampleRightX=(nSampleLeftX+nCellSize);
-      //const int nSampleCenterX=(nSampleLeftX+nHalfCellSize);
-
-      const U32 AverageColour=
-        Pete_GetImageAreaAverage(
-          nSampleLeftX,nSampleTopY,
-          nCellSize,nCellSize,
-          pSource,nWidth,nHeight);
-
-      int nLuminance=GetLuminance(AverageColour)/256;
-      nLuminance+=256;
-
-      int nCurrentYFP;
-      for (nCurrentYFP=CellBottom.Pos.nY; nCurrentYFP<=CellTop.Pos.nY;
-           nCurrentYFP+=nFPMult) {
-        if (nCurrentYFP<0) {
-          continue;
-        }
-
-        if (nCurrentYFP>=(nHeight<<nFPShift)) {
-          break;
-        }
-
-        SPete_HalfTone_Vertex SpanStart;
-        SPete_HalfTone_Vertex SpanEnd;
-        Pete_HalfTone_CalcSpanEnds_Vertex(
-          &CellLeft,&CellRight,&CellTop,&CellBottom,nCurrentYFP,
-          &SpanStart,&SpanEnd);
-
-        const int nCellLeftX=(SpanStart.Pos.nX>>nFPShift);
-        const int nCellRightX=(SpanEnd.Pos.nX>>nFPShift);
-        const int nCurrentY=(nCurrentYFP>>nFPShift);
-
-        int nLengthX=(nCellRightX-nCellLeftX);
-        if (nLengthX<1) {
-          nLengthX=1;
-        }
-
-        const int nGradientU=
-          (SpanEnd.TexCoords.nX-SpanStart.TexCoords.nX)/nLengthX;
-        const int nGradientV=
-          (SpanEnd.TexCoords.nY-SpanStart.TexCoords.nY)/nLengthX;
-
-        int nTexU=SpanStart.TexCoords.nX;
-        int nTexV=SpanStart.TexCoords.nY;
-
-        int nCurrentX;
-        for (nCurrentX=nCellLeftX; nCurrentX<nCellRightX;
-             nCurrentX+=1,nTexU+=nGradientU,nTexV+=nGradientV) {
-
-          if (nCurrentX<0) {
-            continue;
-          }
-          if (nCurrentX>=nWidth) {
-            break;
-          }
-
-          const int nTexUInt=(nTexU>>nFPShift);
-          const int nTexVInt=(nTexV>>nFPShift);
-
-          unsigned char* pCurrentDotFunc=
-            pDotFuncTableStart+
-            (nTexVInt*nCellSize)+
-            nTexUInt;
-
-          const int nDotFuncResult=*pCurrentDotFunc;
-          const int nDiff=nLuminance-nDotFuncResult;
-          const int nGreyValue=pGreyScaleTableStart[nDiff];
-          const int nAlphaValue=0xff;
-
-          const U32 OutputColour=
-            (nGreyValue<<SHIFT_RED)|
-            (nGreyValue<<SHIFT_GREEN)|
-            (nGreyValue<<SHIFT_BLUE)|
-            (nAlphaValue<<SHIFT_ALPHA);
-
-          U32* pCurrentOutput=
-            pOutput+(nCurrentY*nWidth)+nCurrentX;
-          *pCurrentOutput=OutputColour;
-
-        }
-      }
-    }
-  }
-  image.data = myImage.data;
+  halftone(image, image.xsize);
 }
 
 /////////////////////////////////////////////////////////
@@ -246,227 +106,74 @@ void pix_halftone :: processRGBAImage(imageStruct &image)
 /////////////////////////////////////////////////////////
 void pix_halftone :: processYUVImage(imageStruct &image)
 {
-  const int nWidth = image.xsize>>1;
-  const int nHeight = image.ysize;
+  /* the cells are rasterized on macropixels */
+  halftone(image, image.xsize>>1);
+}
+
+/////////////////////////////////////////////////////////
+// processGrayImage
+//
+/////////////////////////////////////////////////////////
+void pix_halftone :: processGrayImage(imageStruct &image)
+{
+  halftone(image, image.xsize);
+}
 
-  const unsigned char chroma = 128;
-  U32*pSource = reinterpret_cast<U32*>(image.data);
+/////////////////////////////////////////////////////////
+// halftone
+//   the layout of the cells only depends on the parameters and the size,
+//   so it is only rasterized if either of them changes;
+//   for each frame, the luminance of the cells is calculated and
+//   the output elements are shaded according to their cell
+/////////////////////////////////////////////////////////
+void pix_halftone :: halftone(imageStruct &image, int nWidth)
+{
+  const int nHeight = image.ysize;
 
   myImage.xsize = image.xsize;
   myImage.ysize = image.ysize;
   myImage.setCsizeByFormat(image.format);
   myImage.reallocate();
-  U32*pOutput = reinterpret_cast<U32*>(myImage.data);
-
-  int nCellSize=clampFunc(m_CellSize,1,nMaxCellSize);
-  int nStyle=clampFunc(m_Style,0,4);
-  int nSmoothingThreshold=clampFunc(m_Smoothing,0,255);
-
-  const float AngleRadians=m_Angle;
-  const int nCellSizeFP=(nCellSize<<nFPShift);
-
-  const int nHalfWidth=(nWidth>>1);
-  const int nHalfHeight=(nHeight>>1);
-
-  unsigned char* pDotFuncTableStart=&g_pDotFuncTable[0];
-
-  Pete_HalfTone_MakeDotFuncTable(pDotFuncTableStart,nCellSize,nStyle,
-                                 235.0f);
 
+  const int nSmoothingThreshold=clampFunc(m_Smoothing,0,255);
   unsigned char* pGreyScaleTableStart=&g_pGreyScaleTable[0];
+  if (GEM_YUV==image.format) {
+    YUV_MakeGreyScaleTable(pGreyScaleTableStart,nSmoothingThreshold);
+  } else {
+    Pete_HalfTone_MakeGreyScaleTable(pGreyScaleTableStart,nSmoothingThreshold);
+  }
 
-  //Pete_HalfTone_MakeGreyScaleTable(pGreyScaleTableStart,nSmoothingThreshold);
-  YUV_MakeGreyScaleTable(pGreyScaleTableStart,nSmoothingThreshold);
-
-  SPete_HalfTone_Point Left;
-  SPete_HalfTone_Point Right;
-  SPete_HalfTone_Point Top;
-  SPete_HalfTone_Point Bottom;
-  Pete_HalfTone_CalcCorners(nWidth,nHeight,AngleRadians,nCellSize,&Left,
-                            &Right,&Top,&Bottom);
-
-  int nCurrentV;
-  for (nCurrentV=Bottom.nY; nCurrentV<Top.nY; nCurrentV+=nCellSizeFP) {
-    int nSnappedV=((nCurrentV+(nCellSizeFP*1024))/nCellSize);
-    nSnappedV>>=nFPShift;
-    nSnappedV<<=nFPShift;
-    nSnappedV*=nCellSize;
-    nSnappedV-=(nCellSizeFP*1024);
-
-    int nLeftU;
-    int nRightU;
-    Pete_HalfTone_CalcSpanEnds(&Left,&Right,&Top,&Bottom,nSnappedV,&nLeftU,
-                               &nRightU);
-
-    int nCurrentU;
-    for (nCurrentU=nLeftU; nCurrentU<nRightU; nCurrentU+=nCellSizeFP) {
-      int nSnappedU=(((nCurrentU+(nCellSizeFP*1024))/nCellSize));
-      nSnappedU>>=nFPShift;
-      nSnappedU<<=nFPShift;
-      nSnappedU*=nCellSize;
-      nSnappedU-=(nCellSizeFP*1024);
-
-      SPete_HalfTone_Vertex RotatedPoints[4]= {
-        {{nSnappedU,nSnappedV},                         {0,0}},
-        {{(nSnappedU+nCellSizeFP),nSnappedV},                   {nCellSizeFP-nFPMult,0}},
-        {{(nSnappedU+nCellSizeFP),(nSnappedV+nCellSizeFP)},     {nCellSizeFP-nFPMult,nCellSizeFP-nFPMult}},
-        {{nSnappedU,(nSnappedV+nCellSizeFP)},                   {0,nCellSizeFP-nFPMult}}
-      };
-
-      SPete_HalfTone_Vertex ScreenSpacePoints[4];
-      Pete_HalfTone_RotateMultipleVertices(
-        &RotatedPoints[0],
-        &ScreenSpacePoints[0],
-        4,
-        AngleRadians);
-
-      int nCount;
-      for (nCount=0; nCount<4; nCount+=1) {
-        ScreenSpacePoints[nCount].Pos.nX+=(nHalfWidth<<nFPShift);
-        ScreenSpacePoints[nCount].Pos.nY+=(nHalfHeight<<nFPShift);
-        ScreenSpacePoints[nCount].Pos.nX&=0xffff0000;
-        ScreenSpacePoints[nCount].Pos.nY&=0xffff0000;
-      }
-
-      SPete_HalfTone_Vertex CellLeft;
-      SPete_HalfTone_Vertex CellRight;
-      SPete_HalfTone_Vertex CellTop;
-      SPete_HalfTone_Vertex CellBottom;
-      Pete_HalfTone_GetRasterizationVertices(
-        &ScreenSpacePoints[0],
-        &CellLeft,&CellRight,&CellTop,&CellBottom);
-
-      const int nSampleTopY=(ScreenSpacePoints[0].Pos.nY>>nFPShift);
-      const int nSampleLeftX=(ScreenSpacePoints[0].Pos.nX>>nFPShift);
-
-      U32 nLuminance=
-        GetImageAreaAverageLuma(
-          nSampleLeftX,nSampleTopY,
-          nCellSize,nCellSize,
-          pSource,nWidth,nHeight);
-      nLuminance+=220;
-      //nLuminance+=256;
-
-      int nCurrentYFP;
-      for (nCurrentYFP=CellBottom.Pos.nY; nCurrentYFP<=CellTop.Pos.nY;
-           nCurrentYFP+=nFPMult) {
-        if (nCurrentYFP<0) {
-          continue;
-        }
-
-        if (nCurrentYFP>=(nHeight<<nFPShift)) {
-          break;
-        }
-
-        SPete_HalfTone_Vertex SpanStart;
-        SPete_HalfTone_Vertex SpanEnd;
-        Pete_HalfTone_CalcSpanEnds_Vertex(
-          &CellLeft,&CellRight,&CellTop,&CellBottom,nCurrentYFP,
-          &SpanStart,&SpanEnd);
-
-        const int nCellLeftX=(SpanStart.Pos.nX>>nFPShift);
-        const int nCellRightX=(SpanEnd.Pos.nX>>nFPShift);
-        const int nCurrentY=(nCurrentYFP>>nFPShift);
-
-        int nLengthX=(nCellRightX-nCellLeftX);
-        if (nLengthX<1) {
-          nLengthX=1;
-        }
-
-        const int nGradientU = (SpanEnd.TexCoords.nX
-                                -SpanStart.TexCoords.nX)/nLengthX;
-        const int nGradientV = (SpanEnd.TexCoords.nY
-                                -SpanStart.TexCoords.nY)/nLengthX;
-
-        int nTexU=SpanStart.TexCoords.nX;
-        int nTexV=SpanStart.TexCoords.nY;
-
-        int nCurrentX;
-        for (nCurrentX=nCellLeftX; nCurrentX<nCellRightX;
-             nCurrentX+=1,nTexU+=nGradientU,nTexV+=nGradientV) {
+  if (m_rebuild || nWidth!=m_layoutWidth || nHeight!=m_layoutHeight
+      || image.format!=m_layoutFormat) {
+    makeLayout(nWidth, nHeight, GEM_YUV==image.format);
+    m_layoutWidth=nWidth;
+    m_layoutHeight=nHeight;
+    m_layoutFormat=image.format;
+    m_rebuild=false;
+  }
 
-          if (nCurrentX<0) {
-            continue;
-          }
-          if (nCurrentX>=nWidth) {
-            break;
-          }
+  m_source = &image;
+  m_luminance.resize(m_cells.size());
 
-          int nTexUInt=(nTexU>>nFPShift);
-          int nTexVInt=(nTexV>>nFPShift);
+  SliceJob cellJob(this, &pix_halftone::averageCells);
+  runJob(cellJob, m_cells.size(), m_pool);
+  SliceJob shadeJob(this, &pix_halftone::shadeRows);
+  runJob(shadeJob, nHeight, m_pool);
 
-          unsigned char* pCurrentDotFunc = pDotFuncTableStart+(nTexVInt*nCellSize)
-                                           +nTexUInt;
-
-          int nDotFuncResult=*pCurrentDotFunc;
-          const int nDiff = nLuminance - nDotFuncResult;
-          //const int nDiff = nLuma1 - nDotFuncResult;
-          const int nGreyValue=pGreyScaleTableStart[nDiff];
-          /*
-          if (nDiff>383)
-                  diffHi += 1;
-          if (nDiff<257)
-                  diffLo += 1;
-          */
-          nTexV += nGradientV;
-          nTexU += nGradientU;
-          nTexVInt = (nTexV>>nFPShift);
-          nTexUInt = (nTexU>>nFPShift);
-          pCurrentDotFunc = pDotFuncTableStart+(nTexVInt*nCellSize)+nTexUInt;
-          nDotFuncResult=*pCurrentDotFunc;
-          const int nDiff2 = nLuminance - nDotFuncResult;
-          //const int nDiff2 = nLuma2 - nDotFuncResult;
-          const int nGreyValue2=pGreyScaleTableStart[nDiff2];
-          //if( nGreyValue2 != nGreyValue )
-          //      post("nGreyValue's !equal");
-          /*
-          if (nDiff2>383)
-                  diffHi += 1;
-          if (nDiff2<257)
-                  diffLo += 1;
-          */
-          const U32 OutputColour =    ((chroma&0xff)<<SHIFT_U)|
-                                      ((nGreyValue&0xff)<<SHIFT_Y1)|
-                                      ((chroma&0xff)<<SHIFT_V)|
-                                      ((nGreyValue2&0xff)<<SHIFT_Y2);
-
-          U32* pCurrentOutput = pOutput+(nCurrentY*nWidth)+nCurrentX;
-          *pCurrentOutput=OutputColour;
-        }
-      }
-    }
-  }
-  //post("luma1cnt != 256: %d",luma1cnt);
-  //post("luma2cnt != 256: %d",luma2cnt);
-  //post(" diffHi = %d     diffLo = %d",diffHi, diffLo);
-  //post("diff2Hi = %d    diff2Lo = %d",diff2Hi, diff2Lo);
+  m_source = 0;
   image.data = myImage.data;
 }
 
 /////////////////////////////////////////////////////////
-// processGrayImage
-//
+// makeLayout
+//   rasterize the (rotated) cells: for each output element,
+//   remember the cell it belongs to and the value of the dot-function
+//   (for YUV, there are 2 values per macropixel)
 /////////////////////////////////////////////////////////
-void pix_halftone :: processGrayImage(imageStruct &image)
+void pix_halftone :: makeLayout(int nWidth, int nHeight, bool yuv)
 {
-  const int nWidth = image.xsize;
-  const int nHeight = image.ysize;
-
-  if (!init) {
-    Init(nWidth, nHeight);
-    init = 1;
-  }
-  unsigned char*pSource = image.data;
-
-  myImage.xsize = image.xsize;
-  myImage.ysize = image.ysize;
-  myImage.setCsizeByFormat(image.format);
-  myImage.reallocate();
-  unsigned char* pOutput = myImage.data;
-
   int nCellSize=clampFunc(m_CellSize,1,nMaxCellSize);
   int nStyle=clampFunc(m_Style,0,4);
-  int nSmoothingThreshold=clampFunc(m_Smoothing,0,255);
 
   const float AngleRadians=m_Angle;
   const int nCellSizeFP=(nCellSize<<nFPShift);
@@ -474,14 +181,18 @@ void pix_halftone :: processGrayImage(imageStruct &image)
   const int nHalfWidth=(nWidth>>1);
   const int nHalfHeight=(nHeight>>1);
 
+  const int nDotsPerElement=yuv?2:1;
+  const int nDotMax=nCellSize*nCellSize-1;
+
   unsigned char* pDotFuncTableStart=&g_pDotFuncTable[0];
 
   Pete_HalfTone_MakeDotFuncTable(pDotFuncTableStart,nCellSize,nStyle,
-                                 255.0f);
-
-  unsigned char* pGreyScaleTableStart=&g_pGreyScaleTable[0];
+                                 yuv?235.0f:255.0f);
 
-  Pete_HalfTone_MakeGreyScaleTable(pGreyScaleTableStart,nSmoothingThreshold);
+  m_layoutCellSize=nCellSize;
+  m_cells.clear();
+  m_cellIndex.assign(nWidth*nHeight, -1);
+  m_dots.resize(nWidth*nHeight*nDotsPerElement);
 
   SPete_HalfTone_Point Left;
   SPete_HalfTone_Point Right;
@@ -541,14 +252,11 @@ void pix_halftone :: processGrayImage(imageStruct &image)
         &ScreenSpacePoints[0],
         &CellLeft,&CellRight,&CellTop,&CellBottom);
 
-      const int nSampleTopY=(ScreenSpacePoints[0].Pos.nY>>nFPShift);
-      const int nSampleLeftX=(ScreenSpacePoints[0].Pos.nX>>nFPShift);
-      int nLuminance =
-        Pete_GetImageAreaAverageGray(
-          nSampleLeftX,nSampleTopY,
-          nCellSize,nCellSize,
-          pSource,nWidth,nHeight);
-      nLuminance+=256;
+      SPete_HalfTone_Point SamplePoint;
+      SamplePoint.nX=(ScreenSpacePoints[0].Pos.nX>>nFPShift);
+      SamplePoint.nY=(ScreenSpacePoints[0].Pos.nY>>nFPShift);
+      const int nCell=m_cells.size();
+      m_cells.push_back(SamplePoint);
 
       int nCurrentYFP;
       for (nCurrentYFP=CellBottom.Pos.nY; nCurrentYFP<=CellTop.Pos.nY;
@@ -595,23 +303,164 @@ void pix_halftone :: processGrayImage(imageStruct &image)
             break;
           }
 
-          const int nTexUInt=(nTexU>>nFPShift);
-          const int nTexVInt=(nTexV>>nFPShift);
+          const int nOffset=(nCurrentY*nWidth)+nCurrentX;
+          unsigned char* pCurrentDot=&m_dots[nOffset*nDotsPerElement];
+          m_cellIndex[nOffset]=nCell;
 
-          unsigned char* pCurrentDotFunc=
-            pDotFuncTableStart+
-            (nTexVInt*nCellSize)+
-            nTexUInt;
-
-          unsigned char* pCurrentOutput=
-            pOutput+(nCurrentY*nWidth)+nCurrentX;
-          *pCurrentOutput=pGreyScaleTableStart[nLuminance-*pCurrentDotFunc];
+          /* the interpolated texture-coordinates might lie (slightly)
+           * outside the cell; so clamp them to the table */
+          int nTexUInt=(nTexU>>nFPShift);
+          int nTexVInt=(nTexV>>nFPShift);
+          pCurrentDot[0]=pDotFuncTableStart[
+                           clampFunc((nTexVInt*nCellSize)+nTexUInt,
+                                     0, nDotMax)];
+
+          if (yuv) {
+            /* the 2nd luma of the macropixel */
+            nTexV += nGradientV;
+            nTexU += nGradientU;
+            nTexVInt = (nTexV>>nFPShift);
+            nTexUInt = (nTexU>>nFPShift);
+            pCurrentDot[1]=pDotFuncTableStart[
+                             clampFunc((nTexVInt*nCellSize)+nTexUInt,
+                                       0, nDotMax)];
+          }
         }
       }
     }
   }
-  image.data = myImage.data;
 }
+
+/////////////////////////////////////////////////////////
+// averageCells
+//   the luminance of each cell (offset into the greyscale-table)
+/////////////////////////////////////////////////////////
+void pix_halftone :: averageCells(unsigned int slice, unsigned int numSlices)
+{
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, m_cells.size(),
+                                    start, stop);
+  const int nWidth = m_layoutWidth;
+  const int nHeight = m_layoutHeight;
+  const int nCellSize = m_layoutCellSize;
+
+  for(unsigned int i=start; i<stop; i++) {
+    const SPete_HalfTone_Point&cell=m_cells[i];
+    int nLuminance;
+    switch(m_layoutFormat) {
+    case GEM_YUV:
+      nLuminance=
+        GetImageAreaAverageLuma(
+          cell.nX,cell.nY,
+          nCellSize,nCellSize,
+          reinterpret_cast<U32*>(m_source->data),nWidth,nHeight);
+      nLuminance+=220;
+      break;
+    case GEM_GRAY:
+      nLuminance=
+        Pete_GetImageAreaAverageGray(
+          cell.nX,cell.nY,
+          nCellSize,nCellSize,
+          m_source->data,nWidth,nHeight);
+      nLuminance+=256;
+      break;
+    default: {
+      const U32 AverageColour=
+        Pete_GetImageAreaAverage(
+          cell.nX,cell.nY,
+          nCellSize,nCellSize,
+          reinterpret_cast<U32*>(m_source->data),nWidth,nHeight);
+
+      nLuminance=GetLuminance(AverageColour)/256;
+      nLuminance+=256;
+    }
+    break;
+    }
+    m_luminance[i]=nLuminance;
+  }
+}
+
+/////////////////////////////////////////////////////////
+// shadeRows
+//   elements that are not covered by any cell are left untouched
+/////////////////////////////////////////////////////////
+void pix_halftone :: shadeRows(unsigned int slice, unsigned int numSlices)
+{
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, m_layoutHeight,
+                                    start, stop);
+  const int nWidth = m_layoutWidth;
+  const unsigned char* pGreyScaleTableStart=&g_pGreyScaleTable[0];
+  const int*pLuminance=&m_luminance[0];
+  const int nFirst=start*nWidth;
+  const int nLast=stop*nWidth;
+  int nOffset;
+
+  switch(m_layoutFormat) {
+  case GEM_YUV: {
+    const unsigned char chroma = 128;
+    U32*pOutput = reinterpret_cast<U32*>(myImage.data);
+    for (nOffset=nFirst; nOffset<nLast; nOffset+=1) {
+      const int nCell=m_cellIndex[nOffset];
+      if (nCell<0) {
+        continue;
+      }
+      const int nLuminance=pLuminance[nCell];
+      /* the YUV dots are higher than the luma-offset (220) */
+      const int nDiff=nLuminance-m_dots[2*nOffset];
+      const int nDiff2=nLuminance-m_dots[2*nOffset+1];
+      const int nGreyValue=pGreyScaleTableStart[(nDiff<0)?0:nDiff];
+      const int nGreyValue2=pGreyScaleTableStart[(nDiff2<0)?0:nDiff2];
+      pOutput[nOffset]=
+        ((chroma&0xff)<<SHIFT_U)|
+        ((nGreyValue&0xff)<<SHIFT_Y1)|
+        ((chroma&0xff)<<SHIFT_V)|
+        ((nGreyValue2&0xff)<<SHIFT_Y2);
+    }
+  }
+  break;
+  case GEM_GRAY: {
+    unsigned char*pOutput = myImage.data;
+    for (nOffset=nFirst; nOffset<nLast; nOffset+=1) {
+      const int nCell=m_cellIndex[nOffset];
+      if (nCell<0) {
+        continue;
+      }
+      pOutput[nOffset]=
+        pGreyScaleTableStart[pLuminance[nCell]-m_dots[nOffset]];
+    }
+  }
+  break;
+  default: {
+    const int nAlphaValue=0xff;
+    U32*pOutput = reinterpret_cast<U32*>(myImage.data);
+    for (nOffset=nFirst; nOffset<nLast; nOffset+=1) {
+      const int nCell=m_cellIndex[nOffset];
+      if (nCell<0) {
+        continue;
+      }
+      const int nGreyValue=
+        pGreyScaleTableStart[pLuminance[nCell]-m_dots[nOffset]];
+      pOutput[nOffset]=
+        (nGreyValue<<SHIFT_RED)|
+        (nGreyValue<<SHIFT_GREEN)|
+        (nGreyValue<<SHIFT_BLUE)|
+        (nAlphaValue<<SHIFT_ALPHA);
+    }
+  }
+  break;
+  }
+}
+
+/////////////////////////////////////////////////////////
+// threadMess
+//
+/////////////////////////////////////////////////////////
+void pix_halftone :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
+}
+
 /////////////////////////////////////////////////////////
 // various processing here
 //
@@ -1140,7 +989,7 @@ void pix_halftone :: YUV_MakeGreyScaleTable(unsigned char*
   }
 
   int nCount;
-  for (nCount=0; nCount<470; nCount+=1) {
+  for (nCount=0; nCount<512; nCount+=1) {
     const int nDiff=nCount-235;
     int nGreyValue;
     if (nDiff<16) {
@@ -1364,6 +1213,7 @@ void pix_halftone :: obj_setupCallback(t_class *classPtr)
   class_addmethod(classPtr,
                   reinterpret_cast<t_method>(&pix_halftone::angleDEGCallback),
                   gensym("angleDEG"), A_DEFFLOAT, A_NULL);
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
 }
 
 void pix_halftone :: sizeCallback(void *data, t_float m_CellSize)
@@ -1378,6 +1228,7 @@ void pix_halftone :: sizeCallback(void *data, t_float m_CellSize)
     size=nMaxCellSize;
   }
   GetMyClass(data)->m_CellSize=size;
+  GetMyClass(data)->m_rebuild=true;
   GetMyClass(data)->setPixModified();
 }
 
@@ -1389,6 +1240,7 @@ void pix_halftone :: styleCallback(void *data, t_float m_Style)
     return;
   }
   GetMyClass(data)->m_Style=style;
+  GetMyClass(data)->m_rebuild=true;
   GetMyClass(data)->setPixModified();
 }
 void pix_halftone :: smoothCallback(void *data, t_float m_Smoothing)
@@ -1399,6 +1251,7 @@ void pix_halftone :: smoothCallback(void *data, t_float m_Smoothing)
 void pix_halftone :: angleCallback(void *data, t_float m_Angle)
 {
   GetMyClass(data)->m_Angle=(m_Angle);
+  GetMyClass(data)->m_rebuild=true;
   GetMyClass(data)->setPixModified();
 }
 void pix_halftone :: smoothNCallback(void *data, t_float m_Smoothing)
@@ -1409,5 +1262,6 @@ void pix_halftone :: smoothNCallback(void *data, t_float m_Smoothing)
 void pix_halftone :: angleDEGCallback(void *data, t_float m_Angle)
 {
   GetMyClass(data)->m_Angle=(atan2f(1,1)*m_Angle/45.0);
+  GetMyClass(data)->m_rebuild=true;
   GetMyClass(data)->setPixModified();
 }
@@ -13,6 +13,8 @@ LOG
 
 #include "Base/GemPixObj.h"
 #include "Utils/GemMath.h"
+#include "Utils/ThreadPool.h"
+#include <vector>
 
 enum {
   eRoundStyle,
@@ -64,6 +66,10 @@ protected:
   virtual void    processYUVImage(imageStruct &image);
   virtual void        processGrayImage(imageStruct &image);
 
+  //////////
+  // halftone an image 'width' elements wide
+  void    halftone(imageStruct &image, int width);
+
   //////////
   //
   imageStruct    myImage;
@@ -74,6 +80,14 @@ protected:
   int     m_Smoothing;
   int     init;
 
+  //////////
+  // the layout of the cells
+  // (only rebuilt if the size, format or a geometric parameter changes)
+  bool    m_rebuild;
+  int     m_layoutWidth, m_layoutHeight;
+  unsigned int m_layoutFormat;
+  int     m_layoutCellSize;
+
   struct SPete_HalfTone_Point {
     int nX;
     int nY;
@@ -89,6 +103,24 @@ protected:
   int DiamondDotFunc(float X,float Y, float scale);
   int EuclideanDotFunc(float X,float Y, float scale);
   int PSDiamondDotFunc(float X,float Y, float scale);
+  // the upper left corner of each cell (where its luminance is sampled)
+  std::vector<SPete_HalfTone_Point> m_cells;
+  // the cell each output element belongs to (-1 if none)
+  std::vector<int> m_cellIndex;
+  // the value(s) of the dot-function for each output element
+  std::vector<unsigned char> m_dots;
+  // the luminance of each cell for the current frame
+  std::vector<int> m_luminance;
+  const imageStruct*m_source;
+
+  void makeLayout(int nWidth, int nHeight, bool yuv);
+  // the work for each frame (split into slices for the threads)
+  void averageCells(unsigned int slice, unsigned int numSlices);
+  void shadeRows(unsigned int slice, unsigned int numSlices);
+
+  gem::thread::ThreadPool m_pool;
+  void threadMess(int threads);
+
   int Init(int nWidth, int nHeight);
   void Pete_HalfTone_DeInit();
   void Rotate(SPete_HalfTone_Point* pinPoint,SPete_HalfTone_Point* poutPoint,
@@ -139,10 +139,23 @@ void pix_histo :: update_graphs(void)
 // processImage
 //
 /////////////////////////////////////////////////////////
+namespace
+{
+/* accumulate a 256-bin histogram into a table of arbitrary size */
+void fillTable(gem::RTE::Array&tab, int n, const unsigned int*histogram,
+               t_float incr)
+{
+  for(unsigned int v=0; v<256; v++) {
+    if(histogram[v]) {
+      tab[(n*v)>>8]+=histogram[v]*incr;
+    }
+  }
+}
+};
+
 void pix_histo :: processRGBAImage(imageStruct &image)
 {
   int size=image.xsize*image.ysize;
-  unsigned char *base = image.data;
 
   int n_R=0, n_G=0, n_B=0, n_A=0;
 
@@ -194,41 +207,23 @@ void pix_histo :: processRGBAImage(imageStruct &image)
 
   switch (m_mode) {
   case 1: // RGB->grey
-    while (size--) {
-
-#if 1
-      const unsigned int grey =((base[chRed]  *RGB2GRAY_RED+
-                                 base[chGreen]*RGB2GRAY_GREEN+
-                                 base[chBlue] *RGB2GRAY_BLUE)
-                                >>8)+RGB2GRAY_OFFSET;
-      const unsigned int index=(n_R*grey)>>8;
-      tabR[index]+=incr;
-#else
-      float grey = (base[chRed] * 0.3086f + base[chGreen] * 0.6094f +
-                    base[chBlue] * 0.0820f)/255.f;
-      tabR[static_cast<int>(n_R*grey)]+=incr;
-#endif
-      base+=4;
+    if(!m_stats.analyze(image, gem::image::Statistics::LUMA, &m_pool)) {
+      return;
     }
+    fillTable(tabR, n_R, m_stats.luma, incr);
     break;
   case 3: // RGB
-    while (size--) {
-      tabR[(n_R*base[chRed  ])>>8]+=incr;
-      tabG[(n_G*base[chGreen])>>8]+=incr;
-      tabB[(n_B*base[chBlue ])>>8]+=incr;
-
-      base+=4;
-    }
-    break;
   case 4: // RGBA
-    while (size--) {
-      tabR[(n_R*base[chRed  ])>>8]+=incr;
-      tabG[(n_G*base[chGreen])>>8]+=incr;
-      tabB[(n_B*base[chBlue ])>>8]+=incr;
-      tabA[(n_A*base[chAlpha])>>8]+=incr;
-
-      base+=4;
+    if(!m_stats.analyze(image, gem::image::Statistics::HISTOGRAM, &m_pool)) {
+      return;
+    }
+    fillTable(tabR, n_R, m_stats.histogram[chRed  ], incr);
+    fillTable(tabG, n_G, m_stats.histogram[chGreen], incr);
+    fillTable(tabB, n_B, m_stats.histogram[chBlue ], incr);
+    if(4 == m_mode) {
+      fillTable(tabA, n_A, m_stats.histogram[chAlpha], incr);
     }
+    break;
   default:
     break;
   }
@@ -239,7 +234,6 @@ void pix_histo :: processRGBAImage(imageStruct &image)
 void pix_histo :: processYUVImage(imageStruct &image)
 {
   int size=image.xsize*image.ysize;
-  unsigned char *base = image.data;
 
   int n_Y=0, n_U=0, n_V=0;
 
@@ -278,26 +272,17 @@ void pix_histo :: processYUVImage(imageStruct &image)
   t_float incrY = 1./size;
   t_float incrUV = incrY *2.f;
 
-  size/=2;
+  if(!m_stats.analyze(image, gem::image::Statistics::HISTOGRAM, &m_pool)) {
+    return;
+  }
   switch (m_mode) {
-  case 1: // RGB->grey
-    while (size--) {
-      tabY[(n_Y*base[chY0])>>8]+=incrY;
-      tabY[(n_Y*base[chY1])>>8]+=incrY;
-
-      //      *(tab_Y+((n_Y*base[chY0])>>8))+=incrY;
-      //      *(tab_Y+((n_Y*base[chY1])>>8))+=incrY;
-      base+=4;
-    }
-    break;
   case 3: // RGB
-    while (size--) {
-      tabU[(n_U*base[chU ])>>8]+=incrUV;
-      tabY[(n_Y*base[chY0])>>8]+=incrY;
-      tabV[(n_V*base[chV ])>>8]+=incrUV;
-      tabY[(n_Y*base[chY1])>>8]+=incrY;
-      base+=4;
-    }
+    fillTable(tabU, n_U, m_stats.histogram[chU], incrUV);
+    fillTable(tabV, n_V, m_stats.histogram[chV], incrUV);
+  /* coverity[unterminated_case] */
+  case 1: // RGB->grey
+    fillTable(tabY, n_Y, m_stats.histogram[chY0], incrY);
+    fillTable(tabY, n_Y, m_stats.histogram[chY1], incrY);
     break;
   default:
     break;
@@ -310,8 +295,6 @@ void pix_histo :: processGrayImage(imageStruct &image)
   int size=image.xsize*image.ysize;
   t_float incr= 1./size;
 
-  unsigned char *base = image.data;
-
   if (m_mode==0) {
     return;
   }
@@ -325,13 +308,18 @@ void pix_histo :: processGrayImage(imageStruct &image)
 
   tab.set(0);
 
-  while (size--) {
-    tab[(n*base[chGray])>>8]+=incr;
-    base++;
+  if(!m_stats.analyze(image, gem::image::Statistics::HISTOGRAM, &m_pool)) {
+    return;
   }
+  fillTable(tab, n, m_stats.histogram[chGray], incr);
 
   update_graphs();
 }
+
+void pix_histo :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
+}
 /////////////////////////////////////////////////////////
 // static member function
 //
@@ -341,6 +329,7 @@ void pix_histo :: obj_setupCallback(t_class *classPtr)
   class_addmethod(classPtr,
                   reinterpret_cast<t_method>(&pix_histo::setMessCallback),
                   gensym("set"), A_GIMME,0);
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
 }
 
 void pix_histo :: setMessCallback(void *data, t_symbol* s, int argc,
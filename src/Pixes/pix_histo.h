@@ -27,6 +27,8 @@
 #define _INCLUDE__GEM_PIXES_PIX_HISTO_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageStatistics.h"
+#include "Utils/ThreadPool.h"
 
 /*-----------------------------------------------------------------
   -------------------------------------------------------------------
@@ -61,6 +63,12 @@ protected:
   virtual void  processGrayImage(imageStruct &image);
   virtual void  processYUVImage(imageStruct &image);
 
+  //////////
+  // image statistics (optionally calculated on several threads)
+  gem::image::Statistics m_stats;
+  gem::thread::ThreadPool m_pool;
+  void threadMess(int threads);
+
   //////////
   // tables to hold the curves
   t_symbol* name_R, *name_G, *name_B, *name_A;
@@ -76,6 +76,16 @@ void pix_image :: threadMess(bool onoff)
 {
   m_wantThread=onoff;
 }
+void pix_image :: thumbnailMess(int width, int height)
+{
+  m_hints.clear();
+  if(width>0) {
+    m_hints.set("minwidth", (double)width);
+  }
+  if(height>0) {
+    m_hints.set("minheight", (double)height);
+  }
+}
 
 /////////////////////////////////////////////////////////
 // openMess
@@ -91,16 +101,16 @@ void pix_image :: openMess(std::string filename)
 
   m_filename = findFile(filename);
 
-  gem::image::load::callback cb = loadCallback;
+  gem::image::load::sharedcallback cb = loadCallback;
   void*userdata=reinterpret_cast<void*>(this);
 
   m_id = gem::image::load::INVALID;
 
   bool success=false;
   if(m_wantThread) {
-    success=gem::image::load::async(cb, userdata, m_filename, m_id);
+    success=gem::image::load::async(cb, userdata, m_filename, m_hints, m_id);
   } else {
-    success=gem::image::load:: sync(cb, userdata, m_filename, m_id);
+    success=gem::image::load:: sync(cb, userdata, m_filename, m_hints, m_id);
   }
   if(gem::image::load::INVALID == m_id) {
     success=false;
@@ -127,7 +137,7 @@ void pix_image :: openMess(std::string filename)
 
 
 void    pix_image:: loaded(const gem::image::load::id_t ID,
-                           imageStruct*img,
+                           const imageStruct*img,
                            const gem::Properties&props)
 {
   std::vector<gem::any>atoms;
@@ -139,6 +149,7 @@ void    pix_image:: loaded(const gem::image::load::id_t ID,
       atoms.push_back(value=(int)ID);
     }
     verbose(1, "discarding image with ID %d", ID);
+    gem::image::load::release(img);
     m_infoOut.send("load", atoms);
     return;
   }
@@ -161,7 +172,7 @@ void    pix_image:: loaded(const gem::image::load::id_t ID,
 }
 void    pix_image:: loadCallback(void*data,
                                  gem::image::load::id_t ID,
-                                 imageStruct*img,
+                                 const imageStruct*img,
                                  const gem::Properties&props)
 {
   pix_image*me=reinterpret_cast<pix_image*>(data);
@@ -225,7 +236,7 @@ void pix_image :: cleanImage()
 {
   // release previous data
   if (m_loadedImage) {
-    delete m_loadedImage;
+    gem::image::load::release(m_loadedImage);
     m_loadedImage = NULL;
     m_pixBlock.image.clear();
     m_pixBlock.image.data = NULL;
@@ -240,4 +251,5 @@ void pix_image :: obj_setupCallback(t_class *classPtr)
 {
   CPPEXTERN_MSG1(classPtr, "open", openMess, std::string);
   CPPEXTERN_MSG1(classPtr, "thread", threadMess, bool);
+  CPPEXTERN_MSG2(classPtr, "thumbnail", thumbnailMess, int, int);
 }
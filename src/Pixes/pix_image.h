@@ -20,6 +20,7 @@
 #include "Base/GemBase.h"
 #include "Gem/Image.h"
 #include "Gem/ImageIO.h"
+#include "Gem/Properties.h"
 
 #include "RTE/Outlet.h"
 
@@ -82,21 +83,27 @@ protected:
   virtual void  threadMess(bool onoff);
   bool m_wantThread;
 
+  //////////
+  // the size we actually need (0 0: the full image)
+  // the image might be decoded at a reduced resolution (at least this large)
+  virtual void  thumbnailMess(int width, int height);
+  gem::Properties m_hints;
+
   //////////
   // the full filename of the image
   std::string            m_filename;
   gem::image::load::id_t m_id;
 
   //////////
-  // The original image
-  imageStruct     *m_loadedImage;
+  // The original image (shared with the image cache)
+  const imageStruct *m_loadedImage;
 
   //////////
   // The pixBlock with the current image
   pixBlock      m_pixBlock;
 
   void     loaded(const gem::image::load::id_t ID,
-                  imageStruct*img,
+                  const imageStruct*img,
                   const gem::Properties&props);
 
 
@@ -108,7 +115,7 @@ private:
   // static member functions
   static void     loadCallback(void*data,
                                gem::image::load::id_t ID,
-                               imageStruct*img,
+                               const imageStruct*img,
                                const gem::Properties&props);
 };
 
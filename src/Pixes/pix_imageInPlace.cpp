@@ -66,6 +66,18 @@ bool pix_imageInPlace :: isRunnable(void)
 }
 
 
+/////////////////////////////////////////////////////////
+// openMess
+//
+/////////////////////////////////////////////////////////
+void pix_imageInPlace :: openMess(t_symbol* filename, int baseImage,
+                                  int topImage, int skipRate)
+{
+  // the textures are re-used for the next sequence
+  m_downloaded.assign(m_downloaded.size(), false);
+  pix_multiimage::openMess(filename, baseImage, topImage, skipRate);
+}
+
 /////////////////////////////////////////////////////////
 // render
 //
@@ -80,8 +92,9 @@ void pix_imageInPlace :: render(GemState *state)
     return;
   }
 
-  // if nothing has been bound yet
-  if (!m_loadedCache->textBind[m_curImage]) {
+  // if nothing has been downloaded yet
+  if (m_curImage<0 || m_curImage>=static_cast<int>(m_downloaded.size())
+      || !m_downloaded[m_curImage]) {
     return;
   }
 
@@ -90,9 +103,9 @@ void pix_imageInPlace :: render(GemState *state)
   glEnable(GL_TEXTURE_2D);
 
   if(GLEW_VERSION_1_1) {
-    glBindTexture   (GL_TEXTURE_2D, m_loadedCache->textBind[m_curImage]);
+    glBindTexture   (GL_TEXTURE_2D, m_textureIDs[m_curImage]);
   } else {
-    glBindTextureEXT(GL_TEXTURE_2D, m_loadedCache->textBind[m_curImage]);
+    glBindTextureEXT(GL_TEXTURE_2D, m_textureIDs[m_curImage]);
   }
 }
 
@@ -165,32 +178,49 @@ void pix_imageInPlace :: downloadMess()
   if (!mInPreload) {
     return;
   }
-  if (!m_loadedCache->textBind[0]) {
-    glGenTextures(m_numImages, (GLuint *)m_loadedCache->textBind);//__APPLE__
-
-    for (int i = 0; i < m_numImages; ++i) {
-      if(GLEW_VERSION_1_1) {
-        glBindTexture(GL_TEXTURE_2D, m_loadedCache->textBind[i]);
-      } else {
-        glBindTextureEXT(GL_TEXTURE_2D, m_loadedCache->textBind[i]);
-      }
-
-      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-      glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_repeat);
-      glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_repeat);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_textureQuality);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_textureQuality);
-      glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-      glTexImage2D(GL_TEXTURE_2D, 0,
-                   m_loadedCache->images[i]->csize,
-                   m_loadedCache->images[i]->xsize,
-                   m_loadedCache->images[i]->ysize, 0,
-                   m_loadedCache->images[i]->format,
-                   m_loadedCache->images[i]->type,
-                   m_loadedCache->images[i]->data);
+  if (!m_loadedCache) {
+    return;
+  }
+  const std::vector<const imageStruct*>&images=m_loadedCache->images;
+  const unsigned int count=images.size();
+  if (m_textureIDs.size() < count) {
+    const unsigned int oldcount=m_textureIDs.size();
+    m_textureIDs.resize(count, 0);
+    glGenTextures(count-oldcount, &m_textureIDs[oldcount]);
+  }
+  m_downloaded.resize(m_textureIDs.size(), false);
+
+  for (unsigned int i = 0; i < count; ++i) {
+    const imageStruct*img=images[i];
+    // still loading (or failed to load)
+    if (m_downloaded[i] || !img || !img->data) {
+      continue;
     }
+    if(GLEW_VERSION_1_1) {
+      glBindTexture(GL_TEXTURE_2D, m_textureIDs[i]);
+    } else {
+      glBindTextureEXT(GL_TEXTURE_2D, m_textureIDs[i]);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_repeat);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_repeat);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_textureQuality);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_textureQuality);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glTexImage2D(GL_TEXTURE_2D, 0,
+                 img->csize,
+                 img->xsize,
+                 img->ysize, 0,
+                 img->format,
+                 img->type,
+                 img->data);
+    m_downloaded[i]=true;
   }
+
+  // pick up the images that are still being loaded on the next frame
+  m_wantDownload=m_loadedCache->isLoading();
 }
 
 /////////////////////////////////////////////////////////
@@ -199,17 +229,12 @@ void pix_imageInPlace :: downloadMess()
 /////////////////////////////////////////////////////////
 void pix_imageInPlace :: purgeMess()
 {
-  if (!m_numImages) {
-    return;
-  }
-
-  if (m_loadedCache->textBind[0]) {
-    glDeleteTextures(m_numImages,
-                     (GLuint *)m_loadedCache->textBind);//__APPLE__
-    for (int i = 0; i < m_numImages; ++i) {
-      m_loadedCache->textBind[i] = 0;
-    }
+  if (!m_textureIDs.empty()) {
+    glDeleteTextures(m_textureIDs.size(), &m_textureIDs[0]);
   }
+  m_textureIDs.clear();
+  m_downloaded.clear();
+  m_wantDownload=false;
 }
 
 /////////////////////////////////////////////////////////
@@ -18,6 +18,8 @@ LOG
 #include "Pixes/pix_multiimage.h"
 #include "Gem/GemGL.h"
 
+#include <vector>
+
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
 CLASS
@@ -32,6 +34,9 @@ DESCRIPTION
 
     You can select which file by giving a number.
 
+    the images are downloaded into textures of their own once they have
+    been loaded (images that are still loading are downloaded as they arrive)
+
 -----------------------------------------------------------------*/
 class GEM_EXTERN pix_imageInPlace : public pix_multiimage
 {
@@ -54,6 +59,11 @@ protected:
   // extension check
   virtual bool isRunnable(void);
 
+  //////////
+  // When an open is received
+  virtual void    openMess(t_symbol* filename, int baseImage, int topImage,
+                           int skipRate);
+
   //////////
   // Do the rendering
   virtual void    render(GemState *state);
@@ -94,6 +104,11 @@ protected:
   int                             mInPreload;
   GLuint          m_textureQuality, m_repeat;
 
+  //////////
+  // one texture per image (the names are re-used for the next sequence)
+  std::vector<GLuint>m_textureIDs;
+  std::vector<bool>m_downloaded;
+
 private:
 
   //////////
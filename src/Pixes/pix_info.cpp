@@ -17,6 +17,7 @@
 
 #include "pix_info.h"
 #include "Gem/State.h"
+#include "Gem/ImageGPU.h"
 #include "Utils/GLUtil.h"
 
 CPPEXTERN_NEW_WITH_GIMME(pix_info);
@@ -165,6 +166,7 @@ void pix_info :: render(GemState *state)
   pixBlock*img=NULL;
   if(state) {
     state->get(GemState::_PIX, img);
+    img=gem::image::GPUFilter::hostImage(img, m_hostImage);
   }
   if(m_x) {
     showInfoRaw(img);
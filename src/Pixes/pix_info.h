@@ -72,6 +72,10 @@ protected:
   t_outlet        *m_data;          // data
 
   bool m_symbolic; // use symbols for format/colorspace (in message mode)
+
+  //////////
+  // texture-resident images are read back into here
+  pixBlock m_hostImage;
 };
 
 #endif  // for header file
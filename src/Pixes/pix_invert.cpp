@@ -20,6 +20,16 @@
 
 CPPEXTERN_NEW(pix_invert);
 
+namespace
+{
+const char*s_fragmentShader =
+  "uniform sampler2D tex0;\n"
+  "void main(void) {\n"
+  "  vec4 c = texture2D(tex0, gl_TexCoord[0].st);\n"
+  "  gl_FragColor = vec4(1. - c.rgb, c.a);\n"
+  "}\n";
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_invert
@@ -29,6 +39,7 @@ CPPEXTERN_NEW(pix_invert);
 //
 /////////////////////////////////////////////////////////
 pix_invert :: pix_invert()
+  : m_gpu(s_fragmentShader)
 { }
 
 /////////////////////////////////////////////////////////
@@ -210,6 +221,19 @@ void pix_invert :: processYUVAltivec(imageStruct &image)
 #endif // ALTIVEC
 
 
+/////////////////////////////////////////////////////////
+// processTexture
+//
+/////////////////////////////////////////////////////////
+bool pix_invert :: processTexture(pixBlock &image)
+{
+  return m_gpu.process(image);
+}
+void pix_invert :: stopRendering(void)
+{
+  m_gpu.release();
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
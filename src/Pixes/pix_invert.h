@@ -17,6 +17,7 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_INVERT_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageGPU.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -61,6 +62,12 @@ protected:
 #ifdef __VEC__
   virtual void    processYUVAltivec  (imageStruct &image);
 #endif
+
+  //////////
+  // Do the processing on the GPU
+  virtual bool    processTexture(pixBlock &image);
+  virtual void    stopRendering(void);
+  gem::image::GPUFilter m_gpu;
 };
 
 #endif  // for header file
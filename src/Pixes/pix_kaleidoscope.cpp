@@ -32,7 +32,6 @@ pix_kaleidoscope :: pix_kaleidoscope() :
   nWidth(0), nHeight(0),
   hAngleTable(0), hCosTable(0), hLines(0),
   nMaxLines(128),
-  pSource(0), pOutput(0),
   m_Divisions(7.0f),
   m_OutputAnglePreIncrement(0.0f),
   m_SourceAnglePreIncrement(0.0f),
@@ -107,950 +106,64 @@ pix_kaleidoscope :: ~pix_kaleidoscope()
 /////////////////////////////////////////////////////////
 void pix_kaleidoscope :: processRGBAImage(imageStruct &image)
 {
-  nWidth = image.xsize;
-  nHeight = image.ysize;
-  //const int nWidth=pInstanceData->nWidth;
-  //const int nHeight=pInstanceData->nHeight;
-  if (!init) {
-    Pete_Kaleidoscope_Init();
-    init = 1;
-  }
-  pSource = reinterpret_cast<U32*>(image.data);
-
-  myImage.xsize = image.xsize;
-  myImage.ysize = image.ysize;
-  myImage.setCsizeByFormat(image.format);
-  myImage.reallocate();
-  pOutput = reinterpret_cast<U32*>(myImage.data);
-
-  if (m_Divisions<1.0f) {
-
-    const int nByteCount=(nWidth*nHeight*sizeof(U32));
-    memcpy(pOutput,pSource,nByteCount);
-
-    return;
-  } else if (m_Divisions<2.0f) {
-    //SPete_SimpleMirror_Data SimpleMirrorData;
-    //SimpleMirrorData.nWidth=nWidth;
-    //SimpleMirrorData.nHeight=nHeight;
-
-    m_Angle=(m_OutputAnglePreIncrement/Pete_TwoPi)*360.0f;
-    m_DoSimpleMirrorAll=0.0f;
-    m_PlaneD=0.0f;
-
-    Pete_SimpleMirror_Render();
-
-    return;
-  }
-
-  int nLinesCount;
-  Pete_Kaleidoscope_SetupLines(&nLinesCount);
-
-  SPete_Kaleidoscope_Line* pLinesStart=
-    reinterpret_cast<SPete_Kaleidoscope_Line*>(Pete_LockHandle(hLines));
-  if (pLinesStart==NULL) {
-    return;
-  }
-
-  const float Width=static_cast<float>(nWidth);
-  //const float HalfWidth=(Width/2.0f);
-  const float Height=static_cast<float>(nHeight);
-  //const float HalfHeight=(Height/2.0f);
-
-  const float SourceStartAngle=m_SourceAnglePreIncrement;
-  float SourceHalfAngle=(Pete_TwoPi/(ceilf(m_Divisions)*2.0f));
-  SourceHalfAngle*=m_SourceAngleProportion;
-  SourceHalfAngle+=SourceStartAngle;
-
-  const float StartUOffset=(m_SourceCentreX*Width);
-  const float StartUGradient=cos(SourceStartAngle);
-  const float StartVOffset=(m_SourceCentreY*Height);
-  const float StartVGradient=sin(SourceStartAngle);
-
-  const float HalfUOffset=(m_SourceCentreX*Width);
-  const float HalfUGradient=cos(SourceHalfAngle);
-  const float HalfVOffset=(m_SourceCentreY*Height);
-  const float HalfVGradient=sin(SourceHalfAngle);
-
-  SPete_Kaleidoscope_PartitionData PartitionData;
-  Pete_Kaleidoscope_PartitionLines(pLinesStart,nLinesCount,&PartitionData);
-
-  const float OutputCentreX=(m_OutputCentreX*(Width-1));
-  const float OutputCentreY=(m_OutputCentreY*(Height-1));
-
-  const float LeftX=-OutputCentreX;
-  const float RightX=Width-OutputCentreX;
-
-  float CurrentY=-OutputCentreY;
-
-  int nScanLine;
-  for (nScanLine=0; nScanLine<nHeight; nScanLine+=1) {
-    SPete_Kaleidoscope_Line* pLinesGroupStart;
-    int nLinesGroupCount;
-    SPete_Kaleidoscope_Line* pFirstLineOtherGroup;
-    SPete_Kaleidoscope_Line* pLastLineOtherGroup;
-
-    if (CurrentY<0.0f) {
-      pLinesGroupStart=PartitionData.pYNegLines;
-      nLinesGroupCount=PartitionData.nYNegLinesCount;
-      pFirstLineOtherGroup=PartitionData.pYPosLines;
-      pLastLineOtherGroup=
-        PartitionData.pYPosLines+(PartitionData.nYPosLinesCount-1);
-    } else {
-      pLinesGroupStart=PartitionData.pYPosLines;
-      nLinesGroupCount=PartitionData.nYPosLinesCount;
-      pFirstLineOtherGroup=PartitionData.pYNegLines;
-      pLastLineOtherGroup=
-        PartitionData.pYNegLines+(PartitionData.nYNegLinesCount-1);
-    }
-
-    SPete_Kaleidoscope_Line* pLinesGroupEnd=pLinesGroupStart+nLinesGroupCount;
-    SPete_Kaleidoscope_Line* pCurrentLine=pLinesGroupStart;
-
-    float PreviousIntersectionX = 0.0f;
-    float PreviousRowU = 0.0f;
-    float PreviousRowV = 0.0f;
-
-    U32* pOutputLineStart=pOutput+(nScanLine*nWidth);
-
-    while ((pCurrentLine<=pLinesGroupEnd)&&(PreviousIntersectionX<RightX)) {
-      const bool bIsFinalSpan=(pCurrentLine==pLinesGroupEnd);
-      const bool bIsFirstSpan=(pCurrentLine==pLinesGroupStart);
-      float IntersectionX;
-      float IntersectionT;
-
-      if (bIsFinalSpan) {
-        IntersectionT=0.0f;
-        IntersectionX=RightX;
-      } else if (fabsf(pCurrentLine->Y)<Pete_Kaleidoscope_Epsilon) {
-        if (pCurrentLine->Y<0.0f) {
-          IntersectionT=CurrentY/-Pete_Kaleidoscope_Epsilon;
-        } else {
-          IntersectionT=CurrentY/Pete_Kaleidoscope_Epsilon;
-        }
-        IntersectionX=(pCurrentLine->X*IntersectionT);
-      } else {
-        IntersectionT=(CurrentY/pCurrentLine->Y);
-        IntersectionX=(pCurrentLine->X*IntersectionT);
-      }
-
-      float RowEndU;
-      float RowEndV;
-
-      if (bIsFirstSpan) {
-        SPete_Kaleidoscope_Line* pLine1=pFirstLineOtherGroup;
-        SPete_Kaleidoscope_Line* pLine2=pCurrentLine;
-
-        float Line1IntersectionY;
-        float Line1IntersectionT;
-        if (fabsf(pLine1->X)<Pete_Kaleidoscope_Epsilon) {
-          if (pLine1->X<0.0f) {
-            Line1IntersectionT=LeftX/-Pete_Kaleidoscope_Epsilon;
-          } else {
-            Line1IntersectionT=LeftX/Pete_Kaleidoscope_Epsilon;
-          }
-          Line1IntersectionY=(pLine1->Y*IntersectionT);
-        } else {
-          Line1IntersectionT=(LeftX/pLine1->X);
-          Line1IntersectionY=(pLine1->Y*Line1IntersectionT);
-        }
-
-        float Line2IntersectionY;
-        float Line2IntersectionT;
-        if (fabsf(pLine2->X)<Pete_Kaleidoscope_Epsilon) {
-          if (pLine2->X<0.0f) {
-            Line2IntersectionT=LeftX/-Pete_Kaleidoscope_Epsilon;
-          } else {
-            Line2IntersectionT=LeftX/Pete_Kaleidoscope_Epsilon;
-          }
-          Line2IntersectionY=(pLine2->Y*Line2IntersectionT);
-        } else {
-          Line2IntersectionT=(LeftX/pLine2->X);
-          Line2IntersectionY=(pLine2->Y*Line2IntersectionT);
-        }
-
-        bool bIsHalfLine=(pLine2->Flags&PETE_KALEIDOSCOPE_HALFLINE_BIT);
-        float Line1U;
-        float Line1V;
-        float Line2U;
-        float Line2V;
-        if (bIsHalfLine) {
-          Line1U=StartUOffset+(Line1IntersectionT*StartUGradient);
-          Line1V=StartVOffset+(Line1IntersectionT*StartVGradient);
-          Line2U=HalfUOffset+(Line2IntersectionT*HalfUGradient);
-          Line2V=HalfVOffset+(Line2IntersectionT*HalfVGradient);
-        } else {
-          Line1U=HalfUOffset+(Line1IntersectionT*HalfUGradient);
-          Line1V=HalfVOffset+(Line1IntersectionT*HalfVGradient);
-          Line2U=StartUOffset+(Line2IntersectionT*StartUGradient);
-          Line2V=StartVOffset+(Line2IntersectionT*StartVGradient);
-        }
-
-        const float YDist=(Line2IntersectionY-Line1IntersectionY);
-        const float OneMinusLerpValue=(CurrentY-Line1IntersectionY)/YDist;
-        const float LerpValue=(1.0f-OneMinusLerpValue);
-
-        PreviousRowU=(Line1U*LerpValue)+(Line2U*OneMinusLerpValue);
-        PreviousRowV=(Line1V*LerpValue)+(Line2V*OneMinusLerpValue);
-
-        if (fabsf(pLine1->X)<Pete_Kaleidoscope_Epsilon)
-          if (pLine1->X<0.0f) {
-            PreviousIntersectionX=-Pete_Kaleidoscope_Epsilon*Line1IntersectionT;
-          } else {
-            PreviousIntersectionX=Pete_Kaleidoscope_Epsilon*Line1IntersectionT;
-          } else {
-          PreviousIntersectionX=(pLine1->X*Line1IntersectionT);
-        }
-
-        if (bIsHalfLine) {
-          RowEndU=HalfUOffset+(IntersectionT*HalfUGradient);
-          RowEndV=HalfVOffset+(IntersectionT*HalfVGradient);
-        } else {
-          RowEndU=StartUOffset+(IntersectionT*StartUGradient);
-          RowEndV=StartVOffset+(IntersectionT*StartVGradient);
-        }
-
-      } else if (bIsFinalSpan) {
-        SPete_Kaleidoscope_Line* pLine1=(pCurrentLine-1);
-        SPete_Kaleidoscope_Line* pLine2=pLastLineOtherGroup;
-
-        float Line1IntersectionY;
-        float Line1IntersectionT;
-        if (fabsf(pLine1->X)<Pete_Kaleidoscope_Epsilon) {
-          Line1IntersectionT=10000.0f;
-          Line1IntersectionY=(pLine1->Y*10000.0f);
-        } else {
-          Line1IntersectionT=(RightX/pLine1->X);
-          Line1IntersectionY=(pLine1->Y*Line1IntersectionT);
-        }
-
-        float Line2IntersectionY;
-        float Line2IntersectionT;
-        if (fabsf(pLine2->X)<Pete_Kaleidoscope_Epsilon) {
-          Line2IntersectionT=10000.0f;
-          Line2IntersectionY=(pLine2->Y*Line2IntersectionT);
-        } else {
-          Line2IntersectionT=(RightX/pLine2->X);
-          Line2IntersectionY=(pLine2->Y*Line2IntersectionT);
-        }
-
-        bool bIsHalfLine=(pLine2->Flags&PETE_KALEIDOSCOPE_HALFLINE_BIT);
-
-        float Line1U;
-        float Line1V;
-        float Line2U;
-        float Line2V;
-        if (bIsHalfLine) {
-          Line1U=StartUOffset+(Line1IntersectionT*StartUGradient);
-          Line1V=StartVOffset+(Line1IntersectionT*StartVGradient);
-          Line2U=HalfUOffset+(Line2IntersectionT*HalfUGradient);
-          Line2V=HalfVOffset+(Line2IntersectionT*HalfVGradient);
-        } else {
-          Line1U=HalfUOffset+(Line1IntersectionT*HalfUGradient);
-          Line1V=HalfVOffset+(Line1IntersectionT*HalfVGradient);
-          Line2U=StartUOffset+(Line2IntersectionT*StartUGradient);
-          Line2V=StartVOffset+(Line2IntersectionT*StartVGradient);
-        }
-
-        const float YDist=(Line2IntersectionY-Line1IntersectionY);
-        const float OneMinusLerpValue=(CurrentY-Line1IntersectionY)/YDist;
-        const float LerpValue=(1.0f-OneMinusLerpValue);
-
-        RowEndU=(Line1U*LerpValue)+(Line2U*OneMinusLerpValue);
-        RowEndV=(Line1V*LerpValue)+(Line2V*OneMinusLerpValue);
-
-      } else {
-
-        bool bIsHalfLine=(pCurrentLine->Flags&PETE_KALEIDOSCOPE_HALFLINE_BIT);
-
-        if (bIsHalfLine) {
-          RowEndU=HalfUOffset+(IntersectionT*HalfUGradient);
-          RowEndV=HalfVOffset+(IntersectionT*HalfVGradient);
-        } else {
-          RowEndU=StartUOffset+(IntersectionT*StartUGradient);
-          RowEndV=StartVOffset+(IntersectionT*StartVGradient);
-        }
-      }
-
-      if (IntersectionX>LeftX) {
-        int nRowStartX;
-        if (PreviousIntersectionX<LeftX) {
-          nRowStartX=0;
-
-          const float XDist=(IntersectionX-PreviousIntersectionX);
-          const float OneMinusLerpValue=(LeftX-PreviousIntersectionX)/XDist;
-          const float LerpValue=(1.0f-OneMinusLerpValue);
-
-          PreviousRowU=(PreviousRowU*LerpValue)+(RowEndU*OneMinusLerpValue);
-          PreviousRowV=(PreviousRowV*LerpValue)+(RowEndV*OneMinusLerpValue);
-
-        } else {
-          nRowStartX=static_cast<int>(PreviousIntersectionX-LeftX);
-        }
-
-        int nRowEndX;
-
-        if (bIsFinalSpan) {
-          nRowEndX=static_cast<int>(RightX-LeftX);
-        } else if (IntersectionX>RightX) {
-          nRowEndX=static_cast<int>(RightX-LeftX);
-
-          const float XDist=(IntersectionX-PreviousIntersectionX);
-          const float OneMinusLerpValue=(RightX-PreviousIntersectionX)/XDist;
-          const float LerpValue=(1.0f-OneMinusLerpValue);
-
-          RowEndU=(PreviousRowU*LerpValue)+(RowEndU*OneMinusLerpValue);
-          RowEndV=(PreviousRowV*LerpValue)+(RowEndV*OneMinusLerpValue);
-
-        } else {
-          nRowEndX=static_cast<int>(IntersectionX-LeftX);
-        }
-
-        U32* pRowStart=pOutputLineStart+nRowStartX;
-        int nRowLength=(nRowEndX-nRowStartX);
-        if (nRowLength<=0) {
-          nRowLength=1;
-        }
-        U32*const pSpanEnd=(pRowStart+nRowLength);
-
-        const int nFPShift=16;
-        const int nFPMult=(1<<nFPShift);
-
-        float CurrentU=PreviousRowU;
-        float CurrentV=PreviousRowV;
-        float DeltaU  =(RowEndU-PreviousRowU)/nRowLength;
-        float DeltaV  =(RowEndV-PreviousRowV)/nRowLength;
-
-        int nCurrentU=static_cast<int>(CurrentU*nFPMult);
-        int nCurrentV=static_cast<int>(CurrentV*nFPMult);
-
-        const int nWidthFP=(nWidth<<nFPShift);
-        const int nHeightFP=(nHeight<<nFPShift);
-
-        nCurrentU+=(nWidthFP*10);
-        nCurrentV+=(nHeightFP*10);
-
-        int nDeltaU=static_cast<int>(DeltaU*nFPMult);
-        int nDeltaV=static_cast<int>(DeltaV*nFPMult);
-
-        const int nTwoWidth=(nWidth*2)<<nFPShift;
-        const int nTwoWidthMinusOne=(nTwoWidth-(1<<nFPShift));
-
-        const int nTwoHeight=(nHeight*2)<<nFPShift;
-        const int nTwoHeightMinusOne=(nTwoHeight-(1<<nFPShift));
-
-        U32* pCurrentOutput=pRowStart;
-        while (pCurrentOutput<pSpanEnd) {
-          int nNextU;
-          if (nDeltaU>=0) {
-            nNextU=((nCurrentU+nWidthFP)/nWidthFP)*nWidthFP;
-          } else {
-            nNextU=((nCurrentU-(1<<nFixedShift))/nWidthFP)*nWidthFP;
-          }
-
-          int nUDist;
-          if (nDeltaU!=0) {
-            nUDist=(nNextU-nCurrentU)/nDeltaU;
-            nUDist+=1;
-          } else {
-            nUDist=cnBiggestSignedInt;
-          }
-
-          int nNextV;
-          if (nDeltaV>=0) {
-            nNextV=((nCurrentV+nHeightFP)/nHeightFP)*nHeightFP;
-          } else {
-            nNextV=((nCurrentV-(1<<nFixedShift))/nHeightFP)*nHeightFP;
-          }
-
-          int nVDist;
-          if (nDeltaV!=0) {
-            nVDist=(nNextV-nCurrentV)/nDeltaV;
-            nVDist+=1;
-          } else {
-            nVDist=cnBiggestSignedInt;
-          }
-
-          int nMinDist = (nUDist<nVDist)?nUDist:nVDist;
-
-          int nStartU=nCurrentU%nTwoWidth;
-          if (nStartU>=nWidthFP) {
-            nStartU=(nTwoWidthMinusOne-nStartU);
-          }
-          nStartU=clampFunc(nStartU,0,nWidthFP-(1<<nFPShift));
-
-          int nStartV=nCurrentV%nTwoHeight;
-          if (nStartV>=nHeightFP) {
-            nStartV=(nTwoHeightMinusOne-nStartV);
-          }
-          nStartV=clampFunc(nStartV,0,nHeightFP-(1<<nFPShift));
-
-          int nEndU=(nCurrentU+(nMinDist*nDeltaU))%nTwoWidth;
-          if (nEndU>=nWidthFP) {
-            nEndU=(nTwoWidthMinusOne-nEndU);
-          }
-          nEndU=clampFunc(nEndU,0,nWidthFP-(1<<nFPShift));
-
-          int nEndV=(nCurrentV+(nMinDist*nDeltaV))%nTwoHeight;
-          if (nEndV>=nHeightFP) {
-            nEndV=(nTwoHeightMinusOne-nEndV);
-          }
-          nEndV=clampFunc(nEndV,0,nHeightFP-(1<<nFPShift));
-
-          int nLocalDeltaU;
-          int nLocalDeltaV;
-          if (nMinDist<1) {
-            nLocalDeltaU=0;
-            nLocalDeltaV=0;
-          } else {
-            nLocalDeltaU=(nEndU/nMinDist)-(nStartU/nMinDist);
-            nLocalDeltaV=(nEndV/nMinDist)-(nStartV/nMinDist);
-          }
-          int nLocalCurrentU=nStartU;
-          int nLocalCurrentV=nStartV;
-
-          U32* pLocalSpanEnd=(pCurrentOutput+nMinDist);
-          if ((pLocalSpanEnd>pSpanEnd)||(nMinDist==cnBiggestSignedInt)) {
-            pLocalSpanEnd=pSpanEnd;
-          }
-
-          while (pCurrentOutput<pLocalSpanEnd) {
-            const int nUIntegral=(nLocalCurrentU>>nFPShift);
-            const int nVIntegral=(nLocalCurrentV>>nFPShift);
-
-            U32* pCurrentSource=
-              pSource+(nVIntegral*nWidth)+nUIntegral;
-
-            *pCurrentOutput=*pCurrentSource;
-
-            pCurrentOutput+=1;
-            nLocalCurrentU+=nLocalDeltaU;
-            nLocalCurrentV+=nLocalDeltaV;
-          }
-
-          if (nMinDist<1) {
-            nCurrentU+=nDeltaU;
-            nCurrentV+=nDeltaV;
-          } else {
-            nCurrentU+=(nMinDist*nDeltaU);
-            nCurrentV+=(nMinDist*nDeltaV);
-          }
-        }
-      }
-
-      PreviousIntersectionX=IntersectionX;
-      PreviousRowU=RowEndU;
-      PreviousRowV=RowEndV;
-
-      pCurrentLine+=1;
-    }
-
-    CurrentY+=1.0f;
-  }
-  image.data = myImage.data;
-}
-/////////////////////////////////////////////////////////
-// do the YUV processing here
-//
-/////////////////////////////////////////////////////////
-void pix_kaleidoscope :: processYUVImage(imageStruct &image)
-{
-  nWidth = image.xsize/2;
-  nHeight = image.ysize;
-
-  if (!init) {
-    Pete_Kaleidoscope_Init();
-    init = 1;
-  }
-  pSource = reinterpret_cast<U32*>(image.data);
-  /*  works
-  if ( myImage.xsize*myImage.ysize*myImage.csize != image.xsize*image.ysize*image.csize ){
-    int dataSize = image.xsize * image.ysize * image.csize;
-    myImage.clear();
-
-    myImage.allocate(dataSize);
-  }
-  */
-
-  myImage.xsize = image.xsize;
-  myImage.ysize = image.ysize;
-  myImage.setCsizeByFormat(image.format);
-  myImage.reallocate();
-
-  pOutput = reinterpret_cast<U32*>(myImage.data);
-
-  if (m_Divisions<1.0f) {
-    const int nByteCount=(nWidth*nHeight*sizeof(U32));
-    memcpy(pOutput,pSource,nByteCount);
-    return;
-  } else if (m_Divisions<2.0f) {
-    /*SPete_SimpleMirror_Data SimpleMirrorData;
-      SimpleMirrorData.nWidth=nWidth;
-      SimpleMirrorData.nHeight=nHeight;*/
-
-    //SPete_SimpleMirror_Settings SimpleMirrorSettings;
-    m_Angle=(m_OutputAnglePreIncrement/Pete_TwoPi)*360.0f;
-    m_DoSimpleMirrorAll=0.0f;
-    m_PlaneD=0.0f;
-
-    Pete_SimpleMirror_Render();
-    return;
-  }
-
-  int nLinesCount;
-  Pete_Kaleidoscope_SetupLines(&nLinesCount);
-
-  SPete_Kaleidoscope_Line* pLinesStart=
-    reinterpret_cast<SPete_Kaleidoscope_Line*>(Pete_LockHandle(hLines));
-  if (pLinesStart==NULL) {
-    return;
-  }
-
-  const float Width=static_cast<float>(nWidth);
-  //const float HalfWidth=(Width/2.0f);
-  const float Height=static_cast<float>(nHeight);
-  //const float HalfHeight=(Height/2.0f);
-
-  const float SourceStartAngle = m_SourceAnglePreIncrement;
-  float SourceHalfAngle = (Pete_TwoPi/(ceilf(m_Divisions)*2.0f));
-  SourceHalfAngle *= m_SourceAngleProportion;
-  SourceHalfAngle += SourceStartAngle;
-
-  const float StartUOffset=(m_SourceCentreX*Width);
-  const float StartUGradient=cos(SourceStartAngle);
-  const float StartVOffset=(m_SourceCentreY*Height);
-  const float StartVGradient=sin(SourceStartAngle);
-
-  const float HalfUOffset=(m_SourceCentreX*Width);
-  const float HalfUGradient=cos(SourceHalfAngle);
-  const float HalfVOffset=(m_SourceCentreY*Height);
-  const float HalfVGradient=sin(SourceHalfAngle);
-
-  SPete_Kaleidoscope_PartitionData PartitionData;
-  Pete_Kaleidoscope_PartitionLines(pLinesStart,nLinesCount,&PartitionData);
-
-  const float OutputCentreX=(m_OutputCentreX*(Width-1));
-  const float OutputCentreY=(m_OutputCentreY*(Height-1));
-
-  const float LeftX=-OutputCentreX;
-  const float RightX=Width-OutputCentreX;
-
-  float CurrentY=-OutputCentreY;
-  int nScanLine;
-  for (nScanLine=0; nScanLine<nHeight; nScanLine+=1) {
-    SPete_Kaleidoscope_Line* pLinesGroupStart;
-    int nLinesGroupCount;
-    SPete_Kaleidoscope_Line* pFirstLineOtherGroup;
-    SPete_Kaleidoscope_Line* pLastLineOtherGroup;
-
-    if (CurrentY<0.0f) {
-      pLinesGroupStart=PartitionData.pYNegLines;
-      nLinesGroupCount=PartitionData.nYNegLinesCount;
-      pFirstLineOtherGroup=PartitionData.pYPosLines;
-      pLastLineOtherGroup=
-        PartitionData.pYPosLines+(PartitionData.nYPosLinesCount-1);
-    } else {
-      pLinesGroupStart=PartitionData.pYPosLines;
-      nLinesGroupCount=PartitionData.nYPosLinesCount;
-      pFirstLineOtherGroup=PartitionData.pYNegLines;
-      pLastLineOtherGroup=
-        PartitionData.pYNegLines+(PartitionData.nYNegLinesCount-1);
-    }
-
-    SPete_Kaleidoscope_Line* pLinesGroupEnd=pLinesGroupStart+nLinesGroupCount;
-
-    SPete_Kaleidoscope_Line* pCurrentLine=pLinesGroupStart;
-
-    float PreviousIntersectionX = 0.0f;
-    float PreviousRowU = 0.0f;
-    float PreviousRowV = 0.0f;
-
-    U32* pOutputLineStart=pOutput+(nScanLine*nWidth);
-    while ((pCurrentLine<=pLinesGroupEnd)&&(PreviousIntersectionX<RightX)) {
-      const bool bIsFinalSpan=(pCurrentLine==pLinesGroupEnd);
-      const bool bIsFirstSpan=(pCurrentLine==pLinesGroupStart);
-
-      float IntersectionX;
-      float IntersectionT;
-      if (bIsFinalSpan) {
-        IntersectionT=0.0f;
-        IntersectionX=RightX;
-      } else if (fabsf(pCurrentLine->Y)<Pete_Kaleidoscope_Epsilon) {
-        if (pCurrentLine->Y<0.0f) {
-          IntersectionT=CurrentY/-Pete_Kaleidoscope_Epsilon;
-        } else {
-          IntersectionT=CurrentY/Pete_Kaleidoscope_Epsilon;
-        }
-        IntersectionX=(pCurrentLine->X*IntersectionT);
-      } else {
-        IntersectionT=(CurrentY/pCurrentLine->Y);
-        IntersectionX=(pCurrentLine->X*IntersectionT);
-      }
-
-      float RowEndU;
-      float RowEndV;
-
-      if (bIsFirstSpan) {
-        SPete_Kaleidoscope_Line* pLine1=pFirstLineOtherGroup;
-        SPete_Kaleidoscope_Line* pLine2=pCurrentLine;
-
-        float Line1IntersectionY;
-        float Line1IntersectionT;
-        if (fabsf(pLine1->X)<Pete_Kaleidoscope_Epsilon) {
-          if (pLine1->X<0.0f) {
-            Line1IntersectionT=LeftX/-Pete_Kaleidoscope_Epsilon;
-          } else {
-            Line1IntersectionT=LeftX/Pete_Kaleidoscope_Epsilon;
-          }
-          Line1IntersectionY=(pLine1->Y*IntersectionT);
-        } else {
-          Line1IntersectionT=(LeftX/pLine1->X);
-          Line1IntersectionY=(pLine1->Y*Line1IntersectionT);
-        }
-
-        float Line2IntersectionY;
-        float Line2IntersectionT;
-        if (fabsf(pLine2->X)<Pete_Kaleidoscope_Epsilon) {
-          if (pLine2->X<0.0f) {
-            Line2IntersectionT=LeftX/-Pete_Kaleidoscope_Epsilon;
-          } else {
-            Line2IntersectionT=LeftX/Pete_Kaleidoscope_Epsilon;
-          }
-          Line2IntersectionY=(pLine2->Y*Line2IntersectionT);
-        } else {
-          Line2IntersectionT=(LeftX/pLine2->X);
-          Line2IntersectionY=(pLine2->Y*Line2IntersectionT);
-        }
-
-        bool bIsHalfLine=(pLine2->Flags&PETE_KALEIDOSCOPE_HALFLINE_BIT);
-        float Line1U;
-        float Line1V;
-        float Line2U;
-        float Line2V;
-        if (bIsHalfLine) {
-          Line1U=StartUOffset+(Line1IntersectionT*StartUGradient);
-          Line1V=StartVOffset+(Line1IntersectionT*StartVGradient);
-          Line2U=HalfUOffset+(Line2IntersectionT*HalfUGradient);
-          Line2V=HalfVOffset+(Line2IntersectionT*HalfVGradient);
-        } else {
-          Line1U=HalfUOffset+(Line1IntersectionT*HalfUGradient);
-          Line1V=HalfVOffset+(Line1IntersectionT*HalfVGradient);
-          Line2U=StartUOffset+(Line2IntersectionT*StartUGradient);
-          Line2V=StartVOffset+(Line2IntersectionT*StartVGradient);
-        }
-
-        const float YDist=
-          (Line2IntersectionY-Line1IntersectionY);
-
-        const float OneMinusLerpValue=(CurrentY-Line1IntersectionY)/YDist;
-        const float LerpValue=(1.0f-OneMinusLerpValue);
-
-        PreviousRowU=(Line1U*LerpValue)+(Line2U*OneMinusLerpValue);
-        PreviousRowV=(Line1V*LerpValue)+(Line2V*OneMinusLerpValue);
-
-        if (fabsf(pLine1->X)<Pete_Kaleidoscope_Epsilon) {
-          if (pLine1->X<0.0f) {
-            PreviousIntersectionX=-Pete_Kaleidoscope_Epsilon*Line1IntersectionT;
-          } else {
-            PreviousIntersectionX=Pete_Kaleidoscope_Epsilon*Line1IntersectionT;
-          }
-        } else {
-          PreviousIntersectionX=(pLine1->X*Line1IntersectionT);
-        }
-
-        if (bIsHalfLine) {
-          RowEndU=HalfUOffset+(IntersectionT*HalfUGradient);
-          RowEndV=HalfVOffset+(IntersectionT*HalfVGradient);
-        } else {
-          RowEndU=StartUOffset+(IntersectionT*StartUGradient);
-          RowEndV=StartVOffset+(IntersectionT*StartVGradient);
-        }
-
-      } else if (bIsFinalSpan) {
-        SPete_Kaleidoscope_Line* pLine1=(pCurrentLine-1);
-        SPete_Kaleidoscope_Line* pLine2=pLastLineOtherGroup;
-
-        float Line1IntersectionY;
-        float Line1IntersectionT;
-        if (fabsf(pLine1->X)<Pete_Kaleidoscope_Epsilon) {
-          Line1IntersectionT=10000.0f;
-          Line1IntersectionY=(pLine1->Y*10000.0f);
-        } else {
-          Line1IntersectionT=(RightX/pLine1->X);
-          Line1IntersectionY=(pLine1->Y*Line1IntersectionT);
-        }
-
-        float Line2IntersectionY;
-        float Line2IntersectionT;
-        if (fabsf(pLine2->X)<Pete_Kaleidoscope_Epsilon) {
-          Line2IntersectionT=10000.0f;
-          Line2IntersectionY=(pLine2->Y*Line2IntersectionT);
-        } else {
-          Line2IntersectionT=(RightX/pLine2->X);
-          Line2IntersectionY=(pLine2->Y*Line2IntersectionT);
-        }
-
-
-        bool bIsHalfLine=(pLine2->Flags&PETE_KALEIDOSCOPE_HALFLINE_BIT);
-
-        float Line1U;
-        float Line1V;
-        float Line2U;
-        float Line2V;
-        if (bIsHalfLine) {
-          Line1U=StartUOffset+(Line1IntersectionT*StartUGradient);
-          Line1V=StartVOffset+(Line1IntersectionT*StartVGradient);
-          Line2U=HalfUOffset+(Line2IntersectionT*HalfUGradient);
-          Line2V=HalfVOffset+(Line2IntersectionT*HalfVGradient);
-        } else {
-          Line1U=HalfUOffset+(Line1IntersectionT*HalfUGradient);
-          Line1V=HalfVOffset+(Line1IntersectionT*HalfVGradient);
-          Line2U=StartUOffset+(Line2IntersectionT*StartUGradient);
-          Line2V=StartVOffset+(Line2IntersectionT*StartVGradient);
-        }
-
-        const float YDist=
-          (Line2IntersectionY-Line1IntersectionY);
-
-        const float OneMinusLerpValue=(CurrentY-Line1IntersectionY)/YDist;
-        const float LerpValue=(1.0f-OneMinusLerpValue);
-
-        RowEndU=(Line1U*LerpValue)+(Line2U*OneMinusLerpValue);
-        RowEndV=(Line1V*LerpValue)+(Line2V*OneMinusLerpValue);
-
-      } else {
-        bool bIsHalfLine=(pCurrentLine->Flags&PETE_KALEIDOSCOPE_HALFLINE_BIT);
-
-        if (bIsHalfLine) {
-          RowEndU=HalfUOffset+(IntersectionT*HalfUGradient);
-          RowEndV=HalfVOffset+(IntersectionT*HalfVGradient);
-        } else {
-          RowEndU=StartUOffset+(IntersectionT*StartUGradient);
-          RowEndV=StartVOffset+(IntersectionT*StartVGradient);
-        }
-
-      }
-      if (IntersectionX>LeftX) {
-        int nRowStartX;
-
-        if (PreviousIntersectionX<LeftX) {
-          nRowStartX=0;
-
-          const float XDist=(IntersectionX-PreviousIntersectionX);
-          const float OneMinusLerpValue=(LeftX-PreviousIntersectionX)/XDist;
-          const float LerpValue=(1.0f-OneMinusLerpValue);
-
-          PreviousRowU=(PreviousRowU*LerpValue)+(RowEndU*OneMinusLerpValue);
-          PreviousRowV=(PreviousRowV*LerpValue)+(RowEndV*OneMinusLerpValue);
-
-        } else {
-          nRowStartX=static_cast<int>(PreviousIntersectionX-LeftX);
-        }
-
-        int nRowEndX;
-        if (bIsFinalSpan) {
-          nRowEndX=static_cast<int>(RightX-LeftX);
-        } else if (IntersectionX>RightX) {
-          nRowEndX=static_cast<int>(RightX-LeftX);
-
-          const float XDist=(IntersectionX-PreviousIntersectionX);
-          const float OneMinusLerpValue=(RightX-PreviousIntersectionX)/XDist;
-          const float LerpValue=(1.0f-OneMinusLerpValue);
-
-          RowEndU=(PreviousRowU*LerpValue)+(RowEndU*OneMinusLerpValue);
-          RowEndV=(PreviousRowV*LerpValue)+(RowEndV*OneMinusLerpValue);
-
-        } else {
-          nRowEndX=static_cast<int>(IntersectionX-LeftX);
-        }
-
-        U32* pRowStart=pOutputLineStart+nRowStartX;
-        int nRowLength=(nRowEndX-nRowStartX);
-        if (nRowLength<=0) {
-          nRowLength=1;
-        }
-        U32*const pSpanEnd=(pRowStart+nRowLength);
-
-        const int nFPShift=16;
-        const int nFPMult=(1<<nFPShift);
-
-        float CurrentU=PreviousRowU;
-        float CurrentV=PreviousRowV;
-
-        float DeltaU=(RowEndU-PreviousRowU)/nRowLength;
-        float DeltaV=(RowEndV-PreviousRowV)/nRowLength;
-
-        int nCurrentU=static_cast<int>(CurrentU*nFPMult);
-        int nCurrentV=static_cast<int>(CurrentV*nFPMult);
-
-        const int nWidthFP=(nWidth<<nFPShift);
-        const int nHeightFP=(nHeight<<nFPShift);
-
-        nCurrentU+=(nWidthFP*10);
-        nCurrentV+=(nHeightFP*10);
-
-        int nDeltaU=static_cast<int>(DeltaU*nFPMult);
-        int nDeltaV=static_cast<int>(DeltaV*nFPMult);
-
-        const int nTwoWidth=(nWidth*2)<<nFPShift;
-        const int nTwoWidthMinusOne=(nTwoWidth-(1<<nFPShift));
-
-        const int nTwoHeight=(nHeight*2)<<nFPShift;
-        const int nTwoHeightMinusOne=(nTwoHeight-(1<<nFPShift));
-
-        U32* pCurrentOutput=pRowStart;
-
-        while (pCurrentOutput<pSpanEnd) {
-          int nNextU;
-          if (nDeltaU>=0) {
-            nNextU=((nCurrentU+nWidthFP)/nWidthFP)*nWidthFP;
-          } else {
-            nNextU=((nCurrentU-(1<<nFixedShift))/nWidthFP)*nWidthFP;
-          }
-
-          int nUDist;
-          if (nDeltaU!=0) {
-            nUDist=(nNextU-nCurrentU)/nDeltaU;
-            nUDist+=1;
-          } else {
-            nUDist=cnBiggestSignedInt;
-          }
-          int nNextV;
-          if (nDeltaV>=0) {
-            nNextV=((nCurrentV+nHeightFP)/nHeightFP)*nHeightFP;
-          } else {
-            nNextV=((nCurrentV-(1<<nFixedShift))/nHeightFP)*nHeightFP;
-          }
-          int nVDist;
-          if (nDeltaV!=0) {
-            nVDist=(nNextV-nCurrentV)/nDeltaV;
-            nVDist+=1;
-          } else {
-            nVDist=cnBiggestSignedInt;
-          }
-
-          int nMinDist;
-          if (nUDist<nVDist) {
-            nMinDist=nUDist;
-          } else {
-            nMinDist=nVDist;
-          }
-
-          int nStartU=nCurrentU%nTwoWidth;
-          if (nStartU>=nWidthFP) {
-            nStartU=(nTwoWidthMinusOne-nStartU);
-          }
-          nStartU=clampFunc(nStartU,0,nWidthFP-(1<<nFPShift));
-
-          int nStartV=nCurrentV%nTwoHeight;
-          if (nStartV>=nHeightFP) {
-            nStartV=(nTwoHeightMinusOne-nStartV);
-          }
-          nStartV=clampFunc(nStartV,0,nHeightFP-(1<<nFPShift));
-
-          int nEndU=(nCurrentU+(nMinDist*nDeltaU))%nTwoWidth;
-          if (nEndU>=nWidthFP) {
-            nEndU=(nTwoWidthMinusOne-nEndU);
-          }
-          nEndU=clampFunc(nEndU,0,nWidthFP-(1<<nFPShift));
-
-          int nEndV=(nCurrentV+(nMinDist*nDeltaV))%nTwoHeight;
-          if (nEndV>=nHeightFP) {
-            nEndV=(nTwoHeightMinusOne-nEndV);
-          }
-          nEndV=clampFunc(nEndV,0,nHeightFP-(1<<nFPShift));
-
-          int nLocalDeltaU;
-          int nLocalDeltaV;
-          if (nMinDist<1) {
-            nLocalDeltaU=0;
-            nLocalDeltaV=0;
-          } else {
-            nLocalDeltaU=(nEndU/nMinDist)-(nStartU/nMinDist);
-            nLocalDeltaV=(nEndV/nMinDist)-(nStartV/nMinDist);
-          }
-          int nLocalCurrentU=nStartU;
-          int nLocalCurrentV=nStartV;
-
-          U32* pLocalSpanEnd=(pCurrentOutput+nMinDist);
-          if ((pLocalSpanEnd>pSpanEnd)||(nMinDist==cnBiggestSignedInt)) {
-            pLocalSpanEnd=pSpanEnd;
-          }
-          while (pCurrentOutput<pLocalSpanEnd) {
-            const int nUIntegral=(nLocalCurrentU>>nFPShift);
-            const int nVIntegral=(nLocalCurrentV>>nFPShift);
-            U32* pCurrentSource=
-              pSource+(nVIntegral*nWidth)+nUIntegral;
-            *pCurrentOutput=*pCurrentSource;
-            pCurrentOutput+=1;
-            nLocalCurrentU+=nLocalDeltaU;
-            nLocalCurrentV+=nLocalDeltaV;
-          }
-          if (nMinDist<1) {
-            nCurrentU+=nDeltaU;
-            nCurrentV+=nDeltaV;
-          } else {
-            nCurrentU+=(nMinDist*nDeltaU);
-            nCurrentV+=(nMinDist*nDeltaV);
-          }
-        }
-      }
-      PreviousIntersectionX=IntersectionX;
-      PreviousRowU=RowEndU;
-      PreviousRowV=RowEndV;
-
-      pCurrentLine+=1;
-
-    }
-
-    CurrentY+=1.0f;
-
-  }
-  image.data = myImage.data;
+  remap(image, image.xsize);
+}
+/////////////////////////////////////////////////////////
+// do the YUV processing here
+//
+/////////////////////////////////////////////////////////
+void pix_kaleidoscope :: processYUVImage(imageStruct &image)
+{
+  /* the map works on macropixels */
+  remap(image, image.xsize/2);
 }
 /////////////////////////////////////////////////////////
-// do the Grey processing here
+// do the Gray processing here
 //
 /////////////////////////////////////////////////////////
 void pix_kaleidoscope :: processGrayImage(imageStruct &image)
 {
-  nWidth = image.xsize;
-  nHeight = image.ysize;
-
-  if (!init) {
-    Pete_Kaleidoscope_Init();
-    init = 1;
-  }
-  unsigned char*pSourceP=image.data;
-  pSource = reinterpret_cast<U32*>(pSourceP);
-
-  myImage.xsize = image.xsize;
-  myImage.ysize = image.ysize;
-  myImage.setCsizeByFormat(image.format);
-  myImage.reallocate();
-  unsigned char*pOutputP=myImage.data;
-  pOutput = reinterpret_cast<U32*>(pOutputP);
+  remap(image, image.xsize);
+}
 
+/////////////////////////////////////////////////////////
+// remap
+//   the source-coordinates only depend on the parameters and the size,
+//   so the map is only rebuilt if either of them changes
+/////////////////////////////////////////////////////////
+void pix_kaleidoscope :: remap(imageStruct &image, int width)
+{
   if (m_Divisions<1.0f) {
-    const int nByteCount=(nWidth*nHeight*sizeof(unsigned char));
-    memcpy(pOutput,pSource,nByteCount);
     return;
-  } else if (m_Divisions<2.0f) {
-    /*SPete_SimpleMirror_Data SimpleMirrorData;
-      SimpleMirrorData.nWidth=nWidth;
-      SimpleMirrorData.nHeight=nHeight;*/
-
-    //SPete_SimpleMirror_Settings SimpleMirrorSettings;
-    m_Angle=(m_OutputAnglePreIncrement/Pete_TwoPi)*360.0f;
-    m_DoSimpleMirrorAll=0.0f;
-    m_PlaneD=0.0f;
+  }
 
-    Pete_SimpleMirror_Render();
+  if (m_remap.update(width, image.ysize)) {
+    nWidth = width;
+    nHeight = image.ysize;
+    if (!init) {
+      Pete_Kaleidoscope_Init();
+      init = 1;
+    }
+    if (m_Divisions<2.0f) {
+      m_Angle=(m_OutputAnglePreIncrement/Pete_TwoPi)*360.0f;
+      m_DoSimpleMirrorAll=0.0f;
+      m_PlaneD=0.0f;
 
-    return;
+      Pete_SimpleMirror_Render(m_remap.map());
+    } else {
+      Pete_Kaleidoscope_Render(m_remap.map());
+    }
+  }
 
+  if(m_remap.apply(image, myImage, &m_pool)) {
+    image.data = myImage.data;
   }
+}
 
+/* fill the map with the source-coordinates of the kaleidoscope,
+ * scanline by scanline */
+void pix_kaleidoscope :: Pete_Kaleidoscope_Render(int* pOutput)
+{
   int nLinesCount;
   Pete_Kaleidoscope_SetupLines(&nLinesCount);
 
@@ -1065,10 +178,10 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
   const float Height=static_cast<float>(nHeight);
   //const float HalfHeight=(Height/2.0f);
 
-  const float SourceStartAngle = m_SourceAnglePreIncrement;
-  float SourceHalfAngle = (Pete_TwoPi/(ceilf(m_Divisions)*2.0f));
-  SourceHalfAngle *= m_SourceAngleProportion;
-  SourceHalfAngle += SourceStartAngle;
+  const float SourceStartAngle=m_SourceAnglePreIncrement;
+  float SourceHalfAngle=(Pete_TwoPi/(ceilf(m_Divisions)*2.0f));
+  SourceHalfAngle*=m_SourceAngleProportion;
+  SourceHalfAngle+=SourceStartAngle;
 
   const float StartUOffset=(m_SourceCentreX*Width);
   const float StartUGradient=cos(SourceStartAngle);
@@ -1090,6 +203,7 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
   const float RightX=Width-OutputCentreX;
 
   float CurrentY=-OutputCentreY;
+
   int nScanLine;
   for (nScanLine=0; nScanLine<nHeight; nScanLine+=1) {
     SPete_Kaleidoscope_Line* pLinesGroupStart;
@@ -1112,20 +226,20 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
     }
 
     SPete_Kaleidoscope_Line* pLinesGroupEnd=pLinesGroupStart+nLinesGroupCount;
-
     SPete_Kaleidoscope_Line* pCurrentLine=pLinesGroupStart;
 
     float PreviousIntersectionX = 0.0f;
     float PreviousRowU = 0.0f;
     float PreviousRowV = 0.0f;
 
-    unsigned char* pOutputLineStart=pOutputP+(nScanLine*nWidth);
+    int* pOutputLineStart=pOutput+(nScanLine*nWidth);
+
     while ((pCurrentLine<=pLinesGroupEnd)&&(PreviousIntersectionX<RightX)) {
       const bool bIsFinalSpan=(pCurrentLine==pLinesGroupEnd);
       const bool bIsFirstSpan=(pCurrentLine==pLinesGroupStart);
-
       float IntersectionX;
       float IntersectionT;
+
       if (bIsFinalSpan) {
         IntersectionT=0.0f;
         IntersectionX=RightX;
@@ -1193,22 +307,19 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
           Line2V=StartVOffset+(Line2IntersectionT*StartVGradient);
         }
 
-        const float YDist=
-          (Line2IntersectionY-Line1IntersectionY);
-
+        const float YDist=(Line2IntersectionY-Line1IntersectionY);
         const float OneMinusLerpValue=(CurrentY-Line1IntersectionY)/YDist;
         const float LerpValue=(1.0f-OneMinusLerpValue);
 
         PreviousRowU=(Line1U*LerpValue)+(Line2U*OneMinusLerpValue);
         PreviousRowV=(Line1V*LerpValue)+(Line2V*OneMinusLerpValue);
 
-        if (fabsf(pLine1->X)<Pete_Kaleidoscope_Epsilon) {
+        if (fabsf(pLine1->X)<Pete_Kaleidoscope_Epsilon)
           if (pLine1->X<0.0f) {
             PreviousIntersectionX=-Pete_Kaleidoscope_Epsilon*Line1IntersectionT;
           } else {
             PreviousIntersectionX=Pete_Kaleidoscope_Epsilon*Line1IntersectionT;
-          }
-        } else {
+          } else {
           PreviousIntersectionX=(pLine1->X*Line1IntersectionT);
         }
 
@@ -1244,7 +355,6 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
           Line2IntersectionY=(pLine2->Y*Line2IntersectionT);
         }
 
-
         bool bIsHalfLine=(pLine2->Flags&PETE_KALEIDOSCOPE_HALFLINE_BIT);
 
         float Line1U;
@@ -1263,9 +373,7 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
           Line2V=StartVOffset+(Line2IntersectionT*StartVGradient);
         }
 
-        const float YDist=
-          (Line2IntersectionY-Line1IntersectionY);
-
+        const float YDist=(Line2IntersectionY-Line1IntersectionY);
         const float OneMinusLerpValue=(CurrentY-Line1IntersectionY)/YDist;
         const float LerpValue=(1.0f-OneMinusLerpValue);
 
@@ -1273,6 +381,7 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
         RowEndV=(Line1V*LerpValue)+(Line2V*OneMinusLerpValue);
 
       } else {
+
         bool bIsHalfLine=(pCurrentLine->Flags&PETE_KALEIDOSCOPE_HALFLINE_BIT);
 
         if (bIsHalfLine) {
@@ -1282,11 +391,10 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
           RowEndU=StartUOffset+(IntersectionT*StartUGradient);
           RowEndV=StartVOffset+(IntersectionT*StartVGradient);
         }
-
       }
+
       if (IntersectionX>LeftX) {
         int nRowStartX;
-
         if (PreviousIntersectionX<LeftX) {
           nRowStartX=0;
 
@@ -1302,6 +410,7 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
         }
 
         int nRowEndX;
+
         if (bIsFinalSpan) {
           nRowEndX=static_cast<int>(RightX-LeftX);
         } else if (IntersectionX>RightX) {
@@ -1318,21 +427,20 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
           nRowEndX=static_cast<int>(IntersectionX-LeftX);
         }
 
-        unsigned char* pRowStart=pOutputLineStart+nRowStartX;
+        int* pRowStart=pOutputLineStart+nRowStartX;
         int nRowLength=(nRowEndX-nRowStartX);
         if (nRowLength<=0) {
           nRowLength=1;
         }
-        unsigned char*const pSpanEnd=(pRowStart+nRowLength);
+        int*const pSpanEnd=(pRowStart+nRowLength);
 
         const int nFPShift=16;
         const int nFPMult=(1<<nFPShift);
 
         float CurrentU=PreviousRowU;
         float CurrentV=PreviousRowV;
-
-        float DeltaU=(RowEndU-PreviousRowU)/nRowLength;
-        float DeltaV=(RowEndV-PreviousRowV)/nRowLength;
+        float DeltaU  =(RowEndU-PreviousRowU)/nRowLength;
+        float DeltaV  =(RowEndV-PreviousRowV)/nRowLength;
 
         int nCurrentU=static_cast<int>(CurrentU*nFPMult);
         int nCurrentV=static_cast<int>(CurrentV*nFPMult);
@@ -1352,8 +460,7 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
         const int nTwoHeight=(nHeight*2)<<nFPShift;
         const int nTwoHeightMinusOne=(nTwoHeight-(1<<nFPShift));
 
-        unsigned char* pCurrentOutput=pRowStart;
-
+        int* pCurrentOutput=pRowStart;
         while (pCurrentOutput<pSpanEnd) {
           int nNextU;
           if (nDeltaU>=0) {
@@ -1369,12 +476,14 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
           } else {
             nUDist=cnBiggestSignedInt;
           }
+
           int nNextV;
           if (nDeltaV>=0) {
             nNextV=((nCurrentV+nHeightFP)/nHeightFP)*nHeightFP;
           } else {
             nNextV=((nCurrentV-(1<<nFixedShift))/nHeightFP)*nHeightFP;
           }
+
           int nVDist;
           if (nDeltaV!=0) {
             nVDist=(nNextV-nCurrentV)/nDeltaV;
@@ -1383,12 +492,7 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
             nVDist=cnBiggestSignedInt;
           }
 
-          int nMinDist;
-          if (nUDist<nVDist) {
-            nMinDist=nUDist;
-          } else {
-            nMinDist=nVDist;
-          }
+          int nMinDist = (nUDist<nVDist)?nUDist:nVDist;
 
           int nStartU=nCurrentU%nTwoWidth;
           if (nStartU>=nWidthFP) {
@@ -1426,20 +530,22 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
           int nLocalCurrentU=nStartU;
           int nLocalCurrentV=nStartV;
 
-          unsigned char* pLocalSpanEnd=(pCurrentOutput+nMinDist);
+          int* pLocalSpanEnd=(pCurrentOutput+nMinDist);
           if ((pLocalSpanEnd>pSpanEnd)||(nMinDist==cnBiggestSignedInt)) {
             pLocalSpanEnd=pSpanEnd;
           }
+
           while (pCurrentOutput<pLocalSpanEnd) {
             const int nUIntegral=(nLocalCurrentU>>nFPShift);
             const int nVIntegral=(nLocalCurrentV>>nFPShift);
-            unsigned char* pCurrentSource=
-              pSourceP+(nVIntegral*nWidth)+nUIntegral;
-            *pCurrentOutput=*pCurrentSource;
+
+            *pCurrentOutput=(nVIntegral*nWidth)+nUIntegral;
+
             pCurrentOutput+=1;
             nLocalCurrentU+=nLocalDeltaU;
             nLocalCurrentV+=nLocalDeltaV;
           }
+
           if (nMinDist<1) {
             nCurrentU+=nDeltaU;
             nCurrentV+=nDeltaV;
@@ -1449,18 +555,16 @@ void pix_kaleidoscope :: processGrayImage(imageStruct &image)
           }
         }
       }
+
       PreviousIntersectionX=IntersectionX;
       PreviousRowU=RowEndU;
       PreviousRowV=RowEndV;
 
       pCurrentLine+=1;
-
     }
 
     CurrentY+=1.0f;
-
   }
-  image.data = myImage.data;
 }
 
 inline int pix_kaleidoscope :: Pete_Kaleidoscope_CosFA(int nAngleFA)
@@ -1799,10 +903,10 @@ void pix_kaleidoscope :: Pete_Kaleidoscope_CreateAllTransforms(
 
 }
 
-void pix_kaleidoscope :: Pete_Kaleidoscope_Dev()
+void pix_kaleidoscope :: Pete_Kaleidoscope_Dev(int* pOutput)
 {
 
-  U32* pCurrentOutput=pOutput;
+  int* pCurrentOutput=pOutput;
 
   SPete_2dVector GridA= {1.0f,0.0f};
   SPete_2dVector GridB= {0.0f,1.0f};
@@ -1859,10 +963,7 @@ void pix_kaleidoscope :: Pete_Kaleidoscope_Dev()
       int nSourceY = static_cast<int>(SourcePos.y);
       nSourceY=GetMirrored(nSourceY,nHeight);
 
-      U32* pCurrentSource=
-        pSource+(nSourceY*nWidth)+nSourceX;
-
-      *pCurrentOutput=*pCurrentSource;
+      *pCurrentOutput=(nSourceY*nWidth)+nSourceX;
 
       pCurrentOutput+=1;
 
@@ -1968,7 +1069,7 @@ void pix_kaleidoscope :: Pete_2dMatrix_SetToDirectionalScale(float NormalX,
 
 }
 
-void pix_kaleidoscope :: Pete_SimpleMirror_Render()
+void pix_kaleidoscope :: Pete_SimpleMirror_Render(int* pOutput)
 {
 
   const float Width=nWidth;
@@ -1989,17 +1090,17 @@ void pix_kaleidoscope :: Pete_SimpleMirror_Render()
 
   const int nPixelsCount=(nWidth*nHeight);
 
-  U32* pOutputStart=pOutput;
-  U32* pOutputEnd=(pOutput+nPixelsCount);
+  int* pOutputStart=pOutput;
+  int* pOutputEnd=(pOutput+nPixelsCount);
 
-  U32* pCurrentOutput=pOutputStart;
-  U32* pCurrentSource=pSource;
+  int* pCurrentOutput=pOutputStart;
+  int nCurrentSource=0;
 
   float CurrentY=-HalfHeight;
   while (pCurrentOutput<pOutputEnd) {
 
-    U32* pOutputLineStart=pCurrentOutput;
-    U32* pOutputLineEnd=(pOutputLineStart+nWidth);
+    int* pOutputLineStart=pCurrentOutput;
+    int* pOutputLineEnd=(pOutputLineStart+nWidth);
 
     const float StartX=-HalfWidth;
 
@@ -2026,7 +1127,7 @@ void pix_kaleidoscope :: Pete_SimpleMirror_Render()
 
       if ((VDotNMinusD>0.0f)&&(!bSimpleMirrorEverything)) {
 
-        *pCurrentOutput=*pCurrentSource;
+        *pCurrentOutput=nCurrentSource;
 
       } else {
 
@@ -2041,12 +1142,7 @@ void pix_kaleidoscope :: Pete_SimpleMirror_Render()
         nSourceX=GetMirrored(nSourceX,nWidth);
         nSourceY=GetMirrored(nSourceY,nHeight);
 
-        U32* pSimpleMirrorSource=
-          pSource+
-          (nSourceY*nWidth)+
-          nSourceX;
-
-        *pCurrentOutput=*pSimpleMirrorSource;
+        *pCurrentOutput=(nSourceY*nWidth)+nSourceX;
 
       }
 
@@ -2054,7 +1150,7 @@ void pix_kaleidoscope :: Pete_SimpleMirror_Render()
       VDotNMinusD+=VDotNMinusDInc;
 
       pCurrentOutput+=1;
-      pCurrentSource+=1;
+      nCurrentSource+=1;
 
     }
 
@@ -2102,6 +1198,15 @@ void pix_kaleidoscope :: Pete_2dMatrix_TransformVector(
 
 }
 
+/////////////////////////////////////////////////////////
+// threadMess
+//
+/////////////////////////////////////////////////////////
+void pix_kaleidoscope :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
@@ -2135,10 +1240,12 @@ void pix_kaleidoscope :: obj_setupCallback(t_class *classPtr)
   class_addmethod(classPtr,
                   reinterpret_cast<t_method>(&pix_kaleidoscope::rlpCallback),
                   gensym("rlp"), A_DEFFLOAT, A_NULL);
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
 }
 void pix_kaleidoscope :: divCallback(void *data, t_float m_Divisions)
 {
   GetMyClass(data)->m_Divisions=(m_Divisions);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 
@@ -2146,12 +1253,14 @@ void pix_kaleidoscope :: outputAngCallback(void *data,
     t_float m_OutputAnglePreIncrement)
 {
   GetMyClass(data)->m_OutputAnglePreIncrement=(m_OutputAnglePreIncrement);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 void pix_kaleidoscope :: sourceAngCallback(void *data,
     t_float m_SourceAnglePreIncrement)
 {
   GetMyClass(data)->m_SourceAnglePreIncrement=(m_SourceAnglePreIncrement);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 void pix_kaleidoscope :: outputAngleCallback(void *data,
@@ -2159,6 +1268,7 @@ void pix_kaleidoscope :: outputAngleCallback(void *data,
 {
   GetMyClass(data)->m_OutputAnglePreIncrement=
     (m_OutputAnglePreIncrement*deg2rad);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 void pix_kaleidoscope :: sourceAngleCallback(void *data,
@@ -2166,6 +1276,7 @@ void pix_kaleidoscope :: sourceAngleCallback(void *data,
 {
   GetMyClass(data)->m_SourceAnglePreIncrement=
     (m_SourceAnglePreIncrement*deg2rad);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 void pix_kaleidoscope :: sourceCtrCallback(void *data,
@@ -2173,6 +1284,7 @@ void pix_kaleidoscope :: sourceCtrCallback(void *data,
 {
   GetMyClass(data)->m_SourceCentreX=(m_SourceCentreX);
   GetMyClass(data)->m_SourceCentreY=(m_SourceCentreY);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 
@@ -2181,12 +1293,14 @@ void pix_kaleidoscope :: outputCtrCallback(void *data,
 {
   GetMyClass(data)->m_OutputCentreX=(m_OutputCentreX);
   GetMyClass(data)->m_OutputCentreY=(m_OutputCentreY);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 void pix_kaleidoscope :: rlpCallback(void *data,
                                      t_float m_ReflectionLineProportion)
 {
   GetMyClass(data)->m_ReflectionLineProportion=(m_ReflectionLineProportion);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 
@@ -2194,5 +1308,6 @@ void pix_kaleidoscope :: sapCallback(void *data,
                                      t_float m_SourceAngleProportion)
 {
   GetMyClass(data)->m_SourceAngleProportion=(m_SourceAngleProportion);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
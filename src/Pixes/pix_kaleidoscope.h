@@ -14,6 +14,8 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_KALEIDOSCOPE_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageRemap.h"
+#include "Utils/ThreadPool.h"
 #include <math.h>
 
 #ifdef __ppc__
@@ -72,9 +74,20 @@ protected:
   virtual void    processYUVImage(imageStruct &image);
   virtual void    processGrayImage(imageStruct &image);
 
+  //////////
+  // apply the (cached) map to an image 'width' elements wide
+  void            remap(imageStruct &image, int width);
 
   imageStruct    myImage;
 
+  //////////
+  // the source-coordinates of each output element
+  // (rebuilt whenever a parameter changes)
+  gem::image::Remap m_remap;
+  // the map is optionally applied on several threads
+  gem::thread::ThreadPool m_pool;
+  void threadMess(int threads);
+
   struct SPete_AngleTable_Entry {
     int nAngleFA;
     int nDist;
@@ -87,9 +100,6 @@ protected:
   SPete_MemHandle hLines;
   int nMaxLines;
 
-  U32*                            pSource;
-  U32*                            pOutput;
-
   float m_Divisions;
   float m_OutputAnglePreIncrement;
   float m_SourceAnglePreIncrement;
@@ -152,7 +162,8 @@ protected:
   void Pete_Kaleidoscope_PartitionLines(SPete_Kaleidoscope_Line* pLinesStart,
                                         int nLinesCount,SPete_Kaleidoscope_PartitionData* poutPartitionData);
   void Pete_Kaleidoscope_CreateAllTransforms(SPete_2dMatrix* pTransforms);
-  void Pete_Kaleidoscope_Dev();
+  void Pete_Kaleidoscope_Render(int* pOutput);
+  void Pete_Kaleidoscope_Dev(int* pOutput);
   inline int GetMirrored(int inValue,const int nMax);
 
   inline void Pete_2dVector_Add(SPete_2dVector* pinA,SPete_2dVector* pinB,
@@ -191,7 +202,7 @@ protected:
                                      SPete_2dMatrix* pinMatrix,SPete_2dVector* poutResult);
   void Pete_2dMatrix_SetToTranslation(float TranslationX,float TranslationY,
                                       SPete_2dMatrix* poutResult);
-  void Pete_SimpleMirror_Render();
+  void Pete_SimpleMirror_Render(int* pOutput);
 
 #ifdef NO_HACK
   int* g_pCurrentCosTable; // Pete- Hack to avoid accessing this table via 2 indirections
@@ -18,6 +18,21 @@
 
 CPPEXTERN_NEW(pix_levels);
 
+namespace
+{
+const char*s_fragmentShader =
+  "uniform sampler2D tex0;\n"
+  "uniform sampler2D lut;\n"
+  "void main(void) {\n"
+  "  vec4 c = texture2D(tex0, gl_TexCoord[0].st);\n"
+  "  vec4 i = (floor(c * 255. + .5) + .5) / 256.;\n"
+  "  gl_FragColor = vec4(texture2D(lut, vec2(i.r, .5)).r,\n"
+  "                      texture2D(lut, vec2(i.g, .5)).g,\n"
+  "                      texture2D(lut, vec2(i.b, .5)).b,\n"
+  "                      texture2D(lut, vec2(i.a, .5)).a);\n"
+  "}\n";
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_levels
@@ -60,7 +75,8 @@ pix_levels :: pix_levels() :
   m_AlphaOutputCeiling(255.0f),
 
   m_LowPercentile(5.0f),
-  m_HighPercentile(95.0f)
+  m_HighPercentile(95.0f),
+  m_gpu(s_fragmentShader)
 {
   inlet_new(this->x_obj, &this->x_obj->ob_pd, gensym("list"),
             gensym("uniform"));
@@ -631,6 +647,33 @@ void pix_levels :: Pete_ChannelFunction_RenderYUV()
   }
 }
 
+/////////////////////////////////////////////////////////
+// processTexture
+//
+/////////////////////////////////////////////////////////
+bool pix_levels :: processTexture(pixBlock &image)
+{
+  // auto-levels need the histogram of the image
+  if(m_DoAuto) {
+    return false;
+  }
+  Pete_Levels_SetupCFSettings();
+
+  unsigned char table[256*4];
+  for(int i=0; i<256; i++) {
+    table[4*i+0] = m_nRedTable  [i];
+    table[4*i+1] = m_nGreenTable[i];
+    table[4*i+2] = m_nBlueTable [i];
+    table[4*i+3] = m_nAlphaTable[i];
+  }
+  m_gpu.setLookupTable(table);
+  return m_gpu.process(image);
+}
+void pix_levels :: stopRendering(void)
+{
+  m_gpu.release();
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
@@ -13,6 +13,7 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_LEVELS_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageGPU.h"
 
 const int nChannelFunction_Levels=256;
 
@@ -105,6 +106,12 @@ protected:
   void Pete_ChannelFunction_Render();
   void Pete_ChannelFunction_RenderYUV();
 
+  //////////
+  // Do the processing on the GPU
+  virtual bool    processTexture(pixBlock &image);
+  virtual void    stopRendering(void);
+  gem::image::GPUFilter m_gpu;
+
 
 private:
 
@@ -37,16 +37,8 @@ pix_mean_color::~pix_mean_color()
 void pix_mean_color::processYUVImage(imageStruct &image)
 {
   t_atom out[4];
-  unsigned int datasize = (image.xsize * image.ysize) >> 1;
-  unsigned char *base = image.data;
-
-  unsigned long sum[4] = {0,0,0,0};
-
-  for (unsigned int i = 0; i != datasize; ++i) {
-    for(int j = 0; j!= 4; ++j) {
-      sum[j]  += base[j];
-    }
-    base += 4;
+  if(!m_stats.analyze(image, gem::image::Statistics::SUM, &m_pool)) {
+    return;
   }
   // use formulae from http://www.poynton.com/notes/colour_and_gamma/ColorFAQ.html#RTFToC29
   /*
@@ -55,9 +47,9 @@ void pix_mean_color::processYUVImage(imageStruct &image)
    * [B]   [ 0.00456621  0.00791071  0.00000000 ]   [V-128]
    */
 
-  t_float y = (t_float)(sum[chY0]+sum[chY1]) / (t_float)(2*datasize) - 16;
-  t_float u = (t_float) sum[chU] / (t_float)(datasize) - 128;
-  t_float v = (t_float) sum[chV] / (t_float)(datasize) - 128;
+  t_float y = (m_stats.mean(chY0)+m_stats.mean(chY1))/2. - 16;
+  t_float u = m_stats.mean(chU) - 128;
+  t_float v = m_stats.mean(chV) - 128;
 
   t_float r = FLOAT_CLAMP((t_float)(0.00456621*y             +0.00625893*v));
   t_float g = FLOAT_CLAMP((t_float)(0.00456621*y-0.00153632*u-0.00318811*v));
@@ -75,17 +67,11 @@ void pix_mean_color::processYUVImage(imageStruct &image)
 void pix_mean_color::processGrayImage(imageStruct &image)
 {
   t_atom out[4];
-  unsigned int datasize = image.xsize * image.ysize;
-  unsigned char *base = image.data;
-
-  unsigned long sum = 0;
-
-  for (unsigned int i = 0; i != datasize; ++i) {
-    sum  += *base;
-    base++;
+  if(!m_stats.analyze(image, gem::image::Statistics::SUM, &m_pool)) {
+    return;
   }
 
-  t_float grey = (t_float)sum / (t_float)(datasize*255);
+  t_float grey = m_stats.mean(chGray) / 255.;
 
   SETFLOAT(out,   grey );
   SETFLOAT(out+1, grey);
@@ -98,22 +84,13 @@ void pix_mean_color::processGrayImage(imageStruct &image)
 void pix_mean_color::processRGBImage(imageStruct &image)
 {
   t_atom out[4];
-  unsigned int datasize = image.xsize * image.ysize;
-  unsigned char *base = image.data;
-
-  unsigned long sum[3] = {0,0,0};
-
-  for (unsigned int i = 0; i != datasize; ++i) {
-    for(int j = 0; j!= 3; ++j) {
-      sum[j]  += base[j];
-    }
-    base += 3;
+  if(!m_stats.analyze(image, gem::image::Statistics::SUM, &m_pool)) {
+    return;
   }
 
-
-  SETFLOAT(out,   (t_float)sum[0] / (t_float)(datasize*255));
-  SETFLOAT(out+1, (t_float)sum[1] / (t_float)(datasize*255));
-  SETFLOAT(out+2, (t_float)sum[2] / (t_float)(datasize*255));
+  SETFLOAT(out,   m_stats.mean(0) / 255.);
+  SETFLOAT(out+1, m_stats.mean(1) / 255.);
+  SETFLOAT(out+2, m_stats.mean(2) / 255.);
   SETFLOAT(out+3, 1.0);
 
   outlet_list(m_list, 0, 4, out);
@@ -121,29 +98,25 @@ void pix_mean_color::processRGBImage(imageStruct &image)
 
 void pix_mean_color::processRGBAImage(imageStruct &image)
 {
-  unsigned int datasize = image.xsize * image.ysize;
-  unsigned char *base = image.data;
-
-  unsigned long sum[4] = {0,0,0,0};
-
-  for (unsigned int i = 0; i != datasize; ++i) {
-    for(int j = 0; j!= 4; ++j) {
-      sum[j]  += base[j];
-    }
-    base += 4;
-  }
-
   t_atom out[4];
+  if(!m_stats.analyze(image, gem::image::Statistics::SUM, &m_pool)) {
+    return;
+  }
 
-  SETFLOAT(out,   (t_float)sum[chRed  ] / (t_float)(datasize*255) );
-  SETFLOAT(out+1, (t_float)sum[chGreen] / (t_float)(datasize*255) );
-  SETFLOAT(out+2, (t_float)sum[chBlue ] / (t_float)(datasize*255) );
-  SETFLOAT(out+3, (t_float)sum[chAlpha] / (t_float)(datasize*255) );
+  SETFLOAT(out,   m_stats.mean(chRed  ) / 255.);
+  SETFLOAT(out+1, m_stats.mean(chGreen) / 255.);
+  SETFLOAT(out+2, m_stats.mean(chBlue ) / 255.);
+  SETFLOAT(out+3, m_stats.mean(chAlpha) / 255.);
 
   outlet_list(m_list, 0, 4, out);
 }
 
-void pix_mean_color :: obj_setupCallback(t_class *classPtr)
+void pix_mean_color::threadMess(int threads)
 {
+  m_pool.setThreads(threads);
+}
 
+void pix_mean_color :: obj_setupCallback(t_class *classPtr)
+{
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
 }
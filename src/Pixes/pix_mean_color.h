@@ -22,6 +22,8 @@
 #define _PIX_MEAN_COLOR_H
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageStatistics.h"
+#include "Utils/ThreadPool.h"
 
 class GEM_EXTERN pix_mean_color : public GemPixObj
 {
@@ -41,6 +43,12 @@ protected:
   virtual void processGrayImage(imageStruct &image);
   virtual void processYUVImage(imageStruct &image);
 
+  //////////
+  // image statistics (optionally calculated on several threads)
+  gem::image::Statistics m_stats;
+  gem::thread::ThreadPool m_pool;
+  void threadMess(int threads);
+
   t_outlet * m_list;
 };
 
@@ -15,9 +15,102 @@
 #include "Utils/PixPete.h"
 #include "pix_metaimage.h"
 #include "Utils/Functions.h"
+#include "Utils/SIMD.h"
+
+#include <string.h>
 
 CPPEXTERN_NEW_WITH_ONE_ARG(pix_metaimage, t_floatarg, A_DEFFLOAT);
 
+namespace
+{
+/* runs a member function of pix_metaimage on a slice of the work */
+class SliceJob : public gem::thread::ThreadPool::Job
+{
+public:
+  typedef void (pix_metaimage::*Method)(unsigned int, unsigned int);
+  pix_metaimage*obj;
+  Method method;
+  SliceJob(pix_metaimage*o, Method m)
+    : obj(o), method(m)
+  { }
+  virtual void process(unsigned int slice, unsigned int numSlices)
+  {
+    (obj->*method)(slice, numSlices);
+  }
+};
+
+void runJob(gem::thread::ThreadPool::Job&job, unsigned int size,
+            gem::thread::ThreadPool&pool)
+{
+  unsigned int numSlices=pool.getThreads();
+  if(numSlices>size) {
+    numSlices=size;
+  }
+  if(numSlices<2) {
+    job.process(0, 1);
+    return;
+  }
+  pool.run(job, numSlices);
+}
+
+/* split the (signed) difference of each byte into the positive
+ * and negative part, so it can be applied with saturating arithmetic */
+void setDelta(const unsigned char*value, const unsigned char*reference,
+              unsigned char*add, unsigned char*sub, unsigned int count)
+{
+  for(unsigned int i=0; i<count; i++) {
+    const int delta=value[i]-reference[i];
+    add[i]=(delta>0)?delta:0;
+    sub[i]=(delta<0)?-delta:0;
+  }
+}
+
+/* add the delta of each element's tile */
+void addDeltasScalar(unsigned char*pOutput, const int*pTile,
+                     const U32*pAdd, const U32*pSub,
+                     unsigned int start, unsigned int stop,
+                     unsigned int elementSize)
+{
+  for(unsigned int i=start; i<stop; i++) {
+    const int nTile=pTile[i];
+    if(nTile<0) {
+      continue;
+    }
+    unsigned char*pixel=pOutput+i*elementSize;
+    const unsigned char*add=reinterpret_cast<const unsigned char*>(pAdd+nTile);
+    const unsigned char*sub=reinterpret_cast<const unsigned char*>(pSub+nTile);
+    for(unsigned int j=0; j<elementSize; j++) {
+      pixel[j]=clampFunc(pixel[j]+add[j]-sub[j], 0, 255);
+    }
+  }
+}
+
+#ifdef __SSE2__
+/* 4 elements at once with saturated arithmetic */
+unsigned int addDeltas32SSE2(unsigned char*pOutput, const int*pTile,
+                             const U32*pAdd, const U32*pSub,
+                             unsigned int start, unsigned int stop)
+{
+  unsigned int i=start;
+  for(; i+4<=stop; i+=4) {
+    const int t0=pTile[i+0], t1=pTile[i+1], t2=pTile[i+2], t3=pTile[i+3];
+    if((t0|t1|t2|t3)<0) {
+      addDeltasScalar(pOutput, pTile, pAdd, pSub, i, i+4, 4);
+      continue;
+    }
+    __m128i*pixels=reinterpret_cast<__m128i*>(pOutput+i*4);
+    __m128i value=_mm_loadu_si128(pixels);
+    value=_mm_adds_epu8(value, _mm_set_epi32(pAdd[t3], pAdd[t2],
+                        pAdd[t1], pAdd[t0]));
+    value=_mm_subs_epu8(value, _mm_set_epi32(pSub[t3], pSub[t2],
+                        pSub[t1], pSub[t0]));
+    _mm_storeu_si128(pixels, value);
+  }
+  return i;
+}
+#endif /* __SSE2__ */
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_refraction
@@ -29,12 +122,14 @@ CPPEXTERN_NEW_WITH_ONE_ARG(pix_metaimage, t_floatarg, A_DEFFLOAT);
 pix_metaimage :: pix_metaimage(t_floatarg f) :
   init(0),
   nHeight(0), nWidth(0),
-  pSource(0), pOutput(0),
+  pSource(0),
   m_Size((f>0.f)?f:0.2f),
   m_DoDistanceBased(0.0f),
   m_DoCheapAndNasty(0.0f),
-  hSubImage(NULL)
+  hSubImage(NULL),
+  m_format(0), m_elementSize(0)
 {
+  memset(m_average, 0, sizeof(m_average));
   inlet_new(this->x_obj, &this->x_obj->ob_pd, gensym("float"),
             gensym("size"));
 }
@@ -54,50 +149,7 @@ pix_metaimage :: ~pix_metaimage()
 /////////////////////////////////////////////////////////
 void pix_metaimage :: processRGBAImage(imageStruct &image)
 {
-  nWidth = image.xsize;
-  nHeight = image.ysize;
-  if (!init) {
-    Pete_MetaImage_Init();
-    init = 1;
-  }
-  pSource = reinterpret_cast<U32*>(image.data);
-
-  myImage.xsize = image.xsize;
-  myImage.ysize = image.ysize;
-  myImage.setCsizeByFormat(image.format);
-  myImage.reallocate();
-  pOutput = reinterpret_cast<U32*>(myImage.data);
-
-  float SubWidth;
-  float SubHeight;
-
-  m_Size = clampFunc(m_Size,0.0f,1.0f);
-
-  if (m_DoDistanceBased>0.0f) {
-
-    const float Distance=1.0f+(m_Size*(nHeight-1.0f));
-
-    SubWidth=nWidth/Distance;
-    SubHeight=nHeight/Distance;
-
-  } else {
-
-    SubWidth=1+(m_Size*(nWidth-1));
-    SubHeight=1+(m_Size*(nHeight-1));
-  }
-
-  U32* pSubImageData=static_cast<U32*>(Pete_LockHandle(hSubImage));
-  if (pSubImageData==NULL) {
-    return;
-  }
-
-  U32 AverageColour=Pete_MetaImage_CreateSubImage(pSource,pSubImageData,
-                    SubWidth,SubHeight);
-
-  Pete_MetaImage_DrawSubImages(pSubImageData,AverageColour,SubWidth,
-                               SubHeight);
-
-  image.data = myImage.data;
+  metaimage(image, image.xsize);
 }
 
 /////////////////////////////////////////////////////////
@@ -106,9 +158,33 @@ void pix_metaimage :: processRGBAImage(imageStruct &image)
 /////////////////////////////////////////////////////////
 void pix_metaimage :: processYUVImage(imageStruct &image)
 {
-  nWidth = image.xsize/2;
+  metaimage(image, image.xsize/2);
+}
+
+/////////////////////////////////////////////////////////
+// processGrayImage
+//
+/////////////////////////////////////////////////////////
+void pix_metaimage :: processGrayImage(imageStruct &image)
+{
+  metaimage(image, image.xsize);
+}
+
+/////////////////////////////////////////////////////////
+// metaimage
+//   the placement of the sub-images only depends on the parameters
+//   and the size, so it is kept in a map that is only rebuilt if either
+//   of them changes; for each frame, the shrunk image is remapped into
+//   the tiles and each tile is then tinted towards its own average
+/////////////////////////////////////////////////////////
+void pix_metaimage :: metaimage(imageStruct &image, int width)
+{
+  nWidth = width;
   nHeight = image.ysize;
-  if (!init) {
+  if (!init
+      || static_cast<unsigned int>(nWidth)!=m_remap.width
+      || static_cast<unsigned int>(nHeight)!=m_remap.height) {
+    /* the sub-image has to grow with the image */
     Pete_MetaImage_Init();
     init = 1;
   }
@@ -118,8 +194,6 @@ void pix_metaimage :: processYUVImage(imageStruct &image)
   myImage.ysize = image.ysize;
   myImage.setCsizeByFormat(image.format);
   myImage.reallocate();
-  //    myImage.setBlack();
-  pOutput = reinterpret_cast<U32*>(myImage.data);
 
   float SubWidth;
   float SubHeight;
@@ -144,58 +218,42 @@ void pix_metaimage :: processYUVImage(imageStruct &image)
     return;
   }
 
-  U32 AverageColour = CreateSubImageYUV(pSource,pSubImageData,SubWidth,
-                                        SubHeight);
-
-  DrawSubImagesYUV(pSubImageData,AverageColour,SubWidth,SubHeight);
-
-  image.data = myImage.data;
-}
-
-/////////////////////////////////////////////////////////
-// processGrayImage
-//
-/////////////////////////////////////////////////////////
-void pix_metaimage :: processGrayImage(imageStruct &image)
-{
-  nWidth = image.xsize;
-  nHeight = image.ysize;
-  if (!init) {
-    Pete_MetaImage_Init();
-    init = 1;
+  m_format = image.format;
+  switch(m_format) {
+  case GEM_YUV: {
+    const U32 AverageColour = CreateSubImageYUV(pSource,pSubImageData,
+                              SubWidth,SubHeight);
+    memcpy(m_average, &AverageColour, 4);
   }
-  pSource = reinterpret_cast<U32*>(image.data);
-
-  myImage.xsize = image.xsize;
-  myImage.ysize = image.ysize;
-  myImage.setCsizeByFormat(image.format);
-  myImage.reallocate();
-  //    myImage.setBlack();
-  pOutput = reinterpret_cast<U32*>(myImage.data);
-
-  float SubWidth;
-  float SubHeight;
-
-  m_Size = clampFunc(m_Size,0.0f,1.0f);
-
-  if (m_DoDistanceBased>0.0f) {
-    const float Distance=1.0f+(m_Size*(nHeight-1.0f));
-    SubWidth=nWidth/Distance;
-    SubHeight=nHeight/Distance;
-  } else {
-    SubWidth=1+(m_Size*(nWidth-1));
-    SubHeight=1+(m_Size*(nHeight-1));
+  break;
+  case GEM_GRAY:
+    m_average[0] = CreateSubImageGray(reinterpret_cast<U8*>(pSource),
+                                      reinterpret_cast<U8*>(pSubImageData),
+                                      SubWidth,SubHeight);
+    break;
+  default: {
+    const U32 AverageColour = Pete_MetaImage_CreateSubImage(
+                                pSource,pSubImageData,SubWidth,SubHeight);
+    memcpy(m_average, &AverageColour, 4);
+  }
+  break;
   }
 
-  U32* pSubImageData=static_cast<U32*>(Pete_LockHandle(hSubImage));
-  if (pSubImageData==NULL) {
-    return;
+  if (m_remap.update(nWidth, nHeight)) {
+    makeLayout(SubWidth, SubHeight);
   }
 
-  U8 AverageColour = CreateSubImageGray((U8*)pSource,(U8*)pSubImageData,
-                                        SubWidth,SubHeight);
+  const unsigned int elementSize = (image.xsize*image.csize)/nWidth;
+  m_remap.apply(reinterpret_cast<unsigned char*>(pSubImageData),
+                myImage.data, elementSize, &m_pool);
 
-  DrawSubImagesGray((U8*)pSubImageData,AverageColour,SubWidth,SubHeight);
+  m_elementSize = elementSize;
+  m_deltaAdd.resize(m_tiles.size());
+  m_deltaSub.resize(m_tiles.size());
+  SliceJob tileJob(this, &pix_metaimage::averageTiles);
+  runJob(tileJob, m_tiles.size(), m_pool);
+  SliceJob deltaJob(this, &pix_metaimage::addDeltas);
+  runJob(deltaJob, nHeight, m_pool);
 
   image.data = myImage.data;
 }
@@ -244,9 +302,23 @@ U32 pix_metaimage :: Pete_MetaImage_CreateSubImage(U32* pInput,
   return AverageColour;
 }
 
-void pix_metaimage :: Pete_MetaImage_DrawSubImages(U32* pSubImage,
-    U32 AverageColour,float SubWidth,float SubHeight)
+/////////////////////////////////////////////////////////
+// makeLayout
+//   place the sub-images (tiles) around the centre of the image:
+//   each output element within a tile is copied from the shrunk image,
+//   at the same position relative to the tile's upper left corner
+/////////////////////////////////////////////////////////
+void pix_metaimage :: makeLayout(float SubWidth, float SubHeight)
 {
+  const int nNumPixels=(nWidth*nHeight);
+  int*pMap=m_remap.map();
+  int i;
+  for (i=0; i<nNumPixels; i++) {
+    pMap[i]=-1;
+  }
+  m_tileIndex.assign(nNumPixels, -1);
+  m_tiles.clear();
+
   const int nHalfWidth=nWidth/2;
   const int nHalfHeight=nHeight/2;
 
@@ -274,106 +346,104 @@ void pix_metaimage :: Pete_MetaImage_DrawSubImages(U32* pSubImage,
       const int nClippedRightX=clampFunc(nRightX,0,(nWidth-1));
       const int nClippedBottomY=clampFunc(nBottomY,0,(nHeight-1));
 
-      U32 SubImageAverage=Pete_MetaImage_GetAreaAverage(
-                            pSource,
-                            nClippedLeftX,
-                            nClippedTopY,
-                            nClippedRightX,
-                            nClippedBottomY,
-                            4);
-
-      Pete_MetaImage_DrawSubImage(
-        pSource,
-        pSubImage,
-        pOutput,
-        nLeftX,
-        nTopY,
-        nRightX,
-        nBottomY,
-        AverageColour,
-        nClippedLeftX,
-        nClippedTopY,
-        nClippedRightX,
-        nClippedBottomY,
-        SubImageAverage);
+      if ((nClippedRightX<=nClippedLeftX)||(nClippedBottomY<=nClippedTopY)) {
+        continue;
+      }
+
+      const int nTile=m_tiles.size();
+      const SPete_MetaImage_Tile Tile= {
+        nClippedLeftX, nClippedTopY, nClippedRightX, nClippedBottomY
+      };
+      m_tiles.push_back(Tile);
+
+      /* the bottom row of the tile is included */
+      int nY;
+      for (nY=nClippedTopY; nY<=nClippedBottomY; nY++) {
+        const int nSubOffset=((nY-nTopY)*nWidth)-nLeftX;
+        int nX;
+        for (nX=nClippedLeftX; nX<nClippedRightX; nX++) {
+          const int nOffset=(nY*nWidth)+nX;
+          pMap[nOffset]=nSubOffset+nX;
+          m_tileIndex[nOffset]=nTile;
+        }
+      }
     }
   }
 }
 
-void pix_metaimage :: Pete_MetaImage_DrawSubImage(U32* pSource,
-    U32* pShrunkBuffer,U32* pOutput,int nLeftX,int nTopY,int nRightX,
-    int nBottomY,U32 WholeImageAverage,int nClippedLeftX,int nClippedTopY,
-    int nClippedRightX,int nClippedBottomY,U32 SubImageAverage)
+/////////////////////////////////////////////////////////
+// averageTiles
+//   the difference between the average of each tile
+//   and the average of the whole image
+/////////////////////////////////////////////////////////
+void pix_metaimage :: averageTiles(unsigned int slice,
+                                   unsigned int numSlices)
 {
-  //const int nWidth=pInstanceData->nWidth;
-  //const int nHeight=pInstanceData->nHeight;
-  const int nSubRed=(SubImageAverage>>SHIFT_RED)&0xff;
-  const int nSubGreen=(SubImageAverage>>SHIFT_GREEN)&0xff;
-  const int nSubBlue=(SubImageAverage>>SHIFT_BLUE)&0xff;
-  const int nSubAlpha=(SubImageAverage>>SHIFT_ALPHA)&0xff;
-
-  const int nWholeRed=(WholeImageAverage>>SHIFT_RED)&0xff;
-  const int nWholeGreen=(WholeImageAverage>>SHIFT_GREEN)&0xff;
-  const int nWholeBlue=(WholeImageAverage>>SHIFT_BLUE)&0xff;
-  const int nWholeAlpha=(WholeImageAverage>>SHIFT_ALPHA)&0xff;
-
-  const int nRedDelta=(nSubRed-nWholeRed);
-  const int nGreenDelta=(nSubGreen-nWholeGreen);
-  const int nBlueDelta=(nSubBlue-nWholeBlue);
-  const int nAlphaDelta=(nSubAlpha-nWholeAlpha);
-
-
-  const int nXDelta=nClippedRightX-nClippedLeftX;
-  const int nYDelta=nClippedBottomY-nClippedTopY;
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, m_tiles.size(),
+                                    start, stop);
+  for(unsigned int i=start; i<stop; i++) {
+    const SPete_MetaImage_Tile&Tile=m_tiles[i];
+    unsigned char*add=reinterpret_cast<unsigned char*>(&m_deltaAdd[i]);
+    unsigned char*sub=reinterpret_cast<unsigned char*>(&m_deltaSub[i]);
+    switch(m_format) {
+    case GEM_YUV: {
+      const U32 SubImageAverage = GetAreaAverageYUV(
+                                    pSource,
+                                    Tile.nLeftX,Tile.nTopY,
+                                    Tile.nRightX,Tile.nBottomY,
+                                    4);
+      setDelta(reinterpret_cast<const unsigned char*>(&SubImageAverage),
+               m_average, add, sub, 4);
+    }
+    break;
+    case GEM_GRAY: {
+      const U8 SubImageAverage = GetAreaAverageGray(
+                                   reinterpret_cast<U8*>(pSource),
+                                   Tile.nLeftX,Tile.nTopY,
+                                   Tile.nRightX,Tile.nBottomY,
+                                   1);
+      setDelta(&SubImageAverage, m_average, add, sub, 1);
+    }
+    break;
+    default: {
+      const U32 SubImageAverage = Pete_MetaImage_GetAreaAverage(
+                                    pSource,
+                                    Tile.nLeftX,Tile.nTopY,
+                                    Tile.nRightX,Tile.nBottomY,
+                                    4);
+      setDelta(reinterpret_cast<const unsigned char*>(&SubImageAverage),
+               m_average, add, sub, 4);
+    }
+    break;
+    }
+  }
+}
 
-  if ((nXDelta<=0)||(nYDelta<=0)) {
+/////////////////////////////////////////////////////////
+// addDeltas
+//   tint the (remapped) elements of each tile by its delta
+/////////////////////////////////////////////////////////
+void pix_metaimage :: addDeltas(unsigned int slice, unsigned int numSlices)
+{
+  if (m_tiles.empty()) {
     return;
   }
-
-  U32* pCurrentSource=pShrunkBuffer;
-
-  pCurrentSource+=((nClippedTopY-nTopY)*nWidth);
-  pCurrentSource+=(nClippedLeftX-nLeftX);
-
-  U32* pCurrentOutput=pOutput+(nClippedTopY*nWidth)+nClippedLeftX;
-  U32*const pOutputEnd=(pCurrentOutput+(nYDelta*nWidth)+nXDelta);
-
-  while (pCurrentOutput<pOutputEnd) {
-    U32*const pOutputLineStart=pCurrentOutput;
-    U32*const pOutputLineEnd=pCurrentOutput+nXDelta;
-    U32* pSourceLineStart=pCurrentSource;
-
-    while (pCurrentOutput<pOutputLineEnd) {
-      const U32 SourceColour=*pCurrentSource;
-      const U32 nSourceRed=(SourceColour>>SHIFT_RED)&0xff;
-      const U32 nSourceGreen=(SourceColour>>SHIFT_GREEN)&0xff;
-      const U32 nSourceBlue=(SourceColour>>SHIFT_BLUE)&0xff;
-      const U32 nSourceAlpha=(SourceColour>>SHIFT_ALPHA)&0xff;
-
-      const U32 nOutputRed  =clampFunc(static_cast<int>(nSourceRed  +nRedDelta),
-                                       0,255);
-      const U32 nOutputGreen=clampFunc(static_cast<int>(nSourceGreen
-                                       +nGreenDelta),0,255);
-      const U32 nOutputBlue =clampFunc(static_cast<int>(nSourceBlue +nBlueDelta),
-                                       0,255);
-      const U32 nOutputAlpha=clampFunc(static_cast<int>(nSourceAlpha
-                                       +nAlphaDelta),0,255);
-
-      const U32 OutputColour=
-        ((nOutputRed&0xff)<<SHIFT_RED)|
-        ((nOutputGreen&0xff)<<SHIFT_GREEN)|
-        ((nOutputBlue&0xff)<<SHIFT_BLUE)|
-        ((nOutputAlpha&0xff)<<SHIFT_ALPHA);
-
-      *pCurrentOutput=OutputColour;
-
-      pCurrentOutput+=1;
-      pCurrentSource+=1;
-    }
-
-    pCurrentOutput=pOutputLineStart+nWidth;
-    pCurrentSource=pSourceLineStart+nWidth;
+  unsigned int start, stop;
+  gem::thread::ThreadPool::getSlice(slice, numSlices, nHeight, start, stop);
+  start*=nWidth;
+  stop *=nWidth;
+
+  const int*pTile=&m_tileIndex[0];
+  const U32*pAdd=&m_deltaAdd[0];
+  const U32*pSub=&m_deltaSub[0];
+#ifdef __SSE2__
+  if(4==m_elementSize && GEM_SIMD_SSE2 == GemSIMD::getCPU()) {
+    start=addDeltas32SSE2(myImage.data, pTile, pAdd, pSub, start, stop);
   }
+#endif
+  addDeltasScalar(myImage.data, pTile, pAdd, pSub, start, stop,
+                  m_elementSize);
 }
 
 U32 pix_metaimage :: Pete_MetaImage_GetAreaAverage(U32* pImage,int nLeftX,
@@ -610,134 +680,6 @@ U32 pix_metaimage :: CreateSubImageYUV(U32* pInput,U32* pSubImage,
   return AverageColour;
 }
 
-void pix_metaimage :: DrawSubImagesYUV(U32* pSubImage,U32 AverageColour,
-                                       float SubWidth,float SubHeight)
-{
-  const int nHalfWidth=nWidth/2;
-  const int nHalfHeight=nHeight/2;
-
-  float CentreX=nHalfWidth+(SubWidth/2);
-  float CentreY=nHalfHeight+(SubHeight/2);
-
-  int nSubImageCountX=static_cast<int>(CentreX/SubWidth);
-  int nSubImageCountY=static_cast<int>(CentreY/SubHeight);
-
-  const float StartX=(nHalfWidth-(SubWidth/2))-(nSubImageCountX*SubWidth);
-  const float EndX=(nHalfWidth+(SubWidth/2))+(nSubImageCountX*SubWidth);
-  const float StartY=(nHalfHeight-(SubHeight/2))-(nSubImageCountY*SubHeight);
-  const float EndY=(nHalfHeight+(SubHeight/2))+(nSubImageCountY*SubHeight);
-
-  float CurrentY;
-  for (CurrentY=StartY; CurrentY<EndY; CurrentY+=SubHeight) {
-    float CurrentX;
-    for (CurrentX=StartX; CurrentX<EndX; CurrentX+=SubWidth) {
-      const int nLeftX=static_cast<int>(CurrentX);
-      const int nTopY=static_cast<int>(CurrentY);
-      const int nRightX=static_cast<int>(CurrentX+SubWidth);
-      const int nBottomY=static_cast<int>(CurrentY+SubHeight);
-      const int nClippedLeftX=clampFunc(nLeftX,0,(nWidth-1));
-      const int nClippedTopY=clampFunc(nTopY,0,(nHeight-1));
-      const int nClippedRightX=clampFunc(nRightX,0,(nWidth-1));
-      const int nClippedBottomY=clampFunc(nBottomY,0,(nHeight-1));
-
-      U32 SubImageAverage = GetAreaAverageYUV(
-                              pSource,
-                              nClippedLeftX,
-                              nClippedTopY,
-                              nClippedRightX,
-                              nClippedBottomY,
-                              4);
-
-      DrawSubImageYUV(
-        pSource,
-        pSubImage,
-        pOutput,
-        nLeftX,
-        nTopY,
-        nRightX,
-        nBottomY,
-        AverageColour,
-        nClippedLeftX,
-        nClippedTopY,
-        nClippedRightX,
-        nClippedBottomY,
-        SubImageAverage);
-    }
-  }
-}
-
-void pix_metaimage :: DrawSubImageYUV(U32* pSource, U32* pShrunkBuffer,
-                                      U32* pOutput,
-                                      int nLeftX,int nTopY,int nRightX,int nBottomY,U32 WholeImageAverage,
-                                      int nClippedLeftX,int nClippedTopY,int nClippedRightX,int nClippedBottomY,
-                                      U32 SubImageAverage)
-{
-  const int nSubU =(SubImageAverage>>SHIFT_U)&0xff;
-  const int nSubY1=(SubImageAverage>>SHIFT_Y1)&0xff;
-  const int nSubV =(SubImageAverage>>SHIFT_V)&0xff;
-  const int nSubY2=(SubImageAverage>>SHIFT_Y2)&0xff;
-
-  const int nWholeU =(WholeImageAverage>>SHIFT_U)&0xff;
-  const int nWholeY1=(WholeImageAverage>>SHIFT_Y1)&0xff;
-  const int nWholeV =(WholeImageAverage>>SHIFT_V)&0xff;
-  const int nWholeY2=(WholeImageAverage>>SHIFT_Y2)&0xff;
-
-  const int nUDelta  = (nSubU  - nWholeU);
-  const int nY1Delta = (nSubY1 - nWholeY1);
-  const int nVDelta  = (nSubV  - nWholeV);
-  const int nY2Delta = (nSubY2 - nWholeY2);
-
-
-  const int nXDelta=nClippedRightX-nClippedLeftX;
-  const int nYDelta=nClippedBottomY-nClippedTopY;
-
-  if ((nXDelta<=0)||(nYDelta<=0)) {
-    return;
-  }
-
-  U32* pCurrentSource=pShrunkBuffer;
-
-  pCurrentSource+=((nClippedTopY-nTopY)*nWidth);
-  pCurrentSource+=(nClippedLeftX-nLeftX);
-
-  U32* pCurrentOutput=pOutput+(nClippedTopY*nWidth)+nClippedLeftX;
-  U32*const pOutputEnd=(pCurrentOutput+(nYDelta*nWidth)+nXDelta);
-
-  while (pCurrentOutput<pOutputEnd) {
-    U32*const pOutputLineStart=pCurrentOutput;
-    U32*const pOutputLineEnd=pCurrentOutput+nXDelta;
-    U32* pSourceLineStart=pCurrentSource;
-
-    while (pCurrentOutput<pOutputLineEnd) {
-      const U32 SourceColour=*pCurrentSource;
-      const U32 nSourceU =(SourceColour>>SHIFT_U )&0xff;
-      const U32 nSourceY1=(SourceColour>>SHIFT_Y1)&0xff;
-      const U32 nSourceV =(SourceColour>>SHIFT_V )&0xff;
-      const U32 nSourceY2=(SourceColour>>SHIFT_Y2)&0xff;
-
-      const U32 nOutputU =clampFunc(static_cast<int>(nSourceU +nUDelta ),0,255);
-      const U32 nOutputY1=clampFunc(static_cast<int>(nSourceY1+nY1Delta),0,255);
-      const U32 nOutputV =clampFunc(static_cast<int>(nSourceV +nVDelta ),0,255);
-      const U32 nOutputY2=clampFunc(static_cast<int>(nSourceY2+nY2Delta),0,
-                                    255);//0xff;
-
-      const U32 OutputColour=
-        ((nOutputU &0xff)<<SHIFT_U)|
-        ((nOutputY1&0xff)<<SHIFT_Y1)|
-        ((nOutputV &0xff)<<SHIFT_V)|
-        ((nOutputY2&0xff)<<SHIFT_Y2);
-
-      *pCurrentOutput=OutputColour;
-
-      pCurrentOutput+=1;
-      pCurrentSource+=1;
-    }
-
-    pCurrentOutput=pOutputLineStart+nWidth;
-    pCurrentSource=pSourceLineStart+nWidth;
-  }
-}
-
 U32 pix_metaimage :: GetAreaAverageYUV(U32* pImage,int nLeftX,int nTopY,
                                        int nRightX,int nBottomY,int nStride)
 {
@@ -961,107 +903,6 @@ U8 pix_metaimage :: CreateSubImageGray(U8*pInput,U8*pSubImage,
   return AverageColour;
 }
 
-void pix_metaimage :: DrawSubImagesGray(U8* pSubImage,U8 AverageColour,
-                                        float SubWidth,float SubHeight)
-{
-  const int nHalfWidth=nWidth/2;
-  const int nHalfHeight=nHeight/2;
-
-  float CentreX=nHalfWidth+(SubWidth/2);
-  float CentreY=nHalfHeight+(SubHeight/2);
-
-  int nSubImageCountX=static_cast<int>(CentreX/SubWidth);
-  int nSubImageCountY=static_cast<int>(CentreY/SubHeight);
-
-  const float StartX=(nHalfWidth-(SubWidth/2))-(nSubImageCountX*SubWidth);
-  const float EndX=(nHalfWidth+(SubWidth/2))+(nSubImageCountX*SubWidth);
-  const float StartY=(nHalfHeight-(SubHeight/2))-(nSubImageCountY*SubHeight);
-  const float EndY=(nHalfHeight+(SubHeight/2))+(nSubImageCountY*SubHeight);
-
-  float CurrentY;
-  for (CurrentY=StartY; CurrentY<EndY; CurrentY+=SubHeight) {
-    float CurrentX;
-    for (CurrentX=StartX; CurrentX<EndX; CurrentX+=SubWidth) {
-      const int nLeftX=static_cast<int>(CurrentX);
-      const int nTopY=static_cast<int>(CurrentY);
-      const int nRightX=static_cast<int>(CurrentX+SubWidth);
-      const int nBottomY=static_cast<int>(CurrentY+SubHeight);
-      const int nClippedLeftX=clampFunc(nLeftX,0,(nWidth-1));
-      const int nClippedTopY=clampFunc(nTopY,0,(nHeight-1));
-      const int nClippedRightX=clampFunc(nRightX,0,(nWidth-1));
-      const int nClippedBottomY=clampFunc(nBottomY,0,(nHeight-1));
-
-      U8 SubImageAverage = GetAreaAverageGray(
-                             (U8*)pSource,
-                             nClippedLeftX,
-                             nClippedTopY,
-                             nClippedRightX,
-                             nClippedBottomY,
-                             1);
-
-
-      DrawSubImageGray(
-        (U8*)pSource,
-        (U8*)pSubImage,
-        (U8*)pOutput,
-        nLeftX,
-        nTopY,
-        nRightX,
-        nBottomY,
-        AverageColour,
-        nClippedLeftX,
-        nClippedTopY,
-        nClippedRightX,
-        nClippedBottomY,
-        SubImageAverage);
-    }
-  }
-}
-
-void pix_metaimage :: DrawSubImageGray(U8* pSource, U8* pShrunkBuffer,
-                                       U8* pOutput,
-                                       int nLeftX,int nTopY,int nRightX,int nBottomY,U8 WholeImageAverage,
-                                       int nClippedLeftX,int nClippedTopY,int nClippedRightX,int nClippedBottomY,
-                                       U8 SubImageAverage)
-{
-  const int nSubU =(SubImageAverage>>SHIFT_U)&0xff;
-  const int nWholeU =(WholeImageAverage>>SHIFT_U)&0xff;
-  const int nUDelta  = (nSubU  - nWholeU);
-
-  const int nXDelta=nClippedRightX-nClippedLeftX;
-  const int nYDelta=nClippedBottomY-nClippedTopY;
-
-  if ((nXDelta<=0)||(nYDelta<=0)) {
-    return;
-  }
-
-  U8*pCurrentSource=(U8*)pShrunkBuffer;
-
-  pCurrentSource+=((nClippedTopY-nTopY)*nWidth);
-  pCurrentSource+=(nClippedLeftX-nLeftX);
-
-  U8*pCurrentOutput=pOutput+(nClippedTopY*nWidth)+nClippedLeftX;
-  U8*const pOutputEnd=(pCurrentOutput+(nYDelta*nWidth)+nXDelta);
-
-  while (pCurrentOutput<pOutputEnd) {
-    U8*const pOutputLineStart=pCurrentOutput;
-    U8*const pOutputLineEnd=pCurrentOutput+nXDelta;
-    U8*pSourceLineStart=pCurrentSource;
-
-    while (pCurrentOutput<pOutputLineEnd) {
-      const U8 SourceColour=*pCurrentSource;
-      const U8 OutputColour =clampFunc(SourceColour+nUDelta,0,255);
-      *pCurrentOutput=OutputColour;
-
-      pCurrentOutput+=1;
-      pCurrentSource+=1;
-    }
-
-    pCurrentOutput=pOutputLineStart+nWidth;
-    pCurrentSource=pSourceLineStart+nWidth;
-  }
-}
-
 U8 pix_metaimage :: GetAreaAverageGray(U8* pImage,int nLeftX,int nTopY,
                                        int nRightX,int nBottomY,int nStride)
 {
@@ -1210,6 +1051,15 @@ U8 pix_metaimage :: ShrinkSourceImageFastGray(U8* pSource, U8* pOutput,
   return Average;
 }
 
+/////////////////////////////////////////////////////////
+// threadMess
+//
+/////////////////////////////////////////////////////////
+void pix_metaimage :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
+}
+
 
 /////////////////////////////////////////////////////////
 // static member function
@@ -1226,16 +1076,19 @@ void pix_metaimage :: obj_setupCallback(t_class *classPtr)
   class_addmethod(classPtr,
                   reinterpret_cast<t_method>(&pix_metaimage::cheapCallback),
                   gensym("cheap"), A_DEFFLOAT, A_NULL);
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
 }
 void pix_metaimage :: sizeCallback(void *data, t_float sz)
 {
   GetMyClass(data)->m_Size=(sz);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 void pix_metaimage :: distanceCallback(void *data,
                                        t_float m_DoDistanceBased)
 {
   GetMyClass(data)->m_DoDistanceBased=(m_DoDistanceBased);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 void pix_metaimage :: cheapCallback(void *data, t_float m_DoCheapAndNasty)
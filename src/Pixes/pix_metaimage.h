@@ -14,6 +14,9 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_METAIMAGE_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageRemap.h"
+#include "Utils/ThreadPool.h"
+#include <vector>
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -52,6 +55,10 @@ protected:
   virtual void    processYUVImage (imageStruct &image);
   virtual void    processGrayImage(imageStruct &image);
 
+  //////////
+  // tile an image 'width' elements wide
+  void    metaimage(imageStruct &image, int width);
+
   imageStruct     myImage;
   int             init;
 
@@ -59,7 +66,6 @@ protected:
   int             nWidth;
 
   U32*            pSource;
-  U32*            pOutput;
 
   float           m_Size;
   float           m_DoDistanceBased;
@@ -67,17 +73,42 @@ protected:
 
   SPete_MemHandle         hSubImage;
 
+  //////////
+  // the layout of the tiles
+  // (only rebuilt if the size or a geometric parameter changes)
+  struct SPete_MetaImage_Tile {
+    int nLeftX;
+    int nTopY;
+    int nRightX;
+    int nBottomY;
+  };
+  // the (clipped) area of each tile
+  std::vector<SPete_MetaImage_Tile> m_tiles;
+  // the tile each output element belongs to (-1 if none)
+  std::vector<int> m_tileIndex;
+  // where each output element is copied from in the shrunk image
+  gem::image::Remap m_remap;
+
+  // the per-frame data
+  unsigned int    m_format;
+  unsigned int    m_elementSize;
+  unsigned char   m_average[4];
+  // the (saturated) difference of each tile to the whole image
+  std::vector<U32> m_deltaAdd, m_deltaSub;
+
+  void makeLayout(float SubWidth, float SubHeight);
+  // the work for each frame (split into slices for the threads)
+  void averageTiles(unsigned int slice, unsigned int numSlices);
+  void addDeltas(unsigned int slice, unsigned int numSlices);
+
+  gem::thread::ThreadPool m_pool;
+  void threadMess(int threads);
+
   int Pete_MetaImage_Init();
   void Pete_MetaImage_DeInit();
 
   U32 Pete_MetaImage_CreateSubImage(U32* pInput,U32* pSubImage,
                                     float SubWidth,float SubHeight);
-  void Pete_MetaImage_DrawSubImages(U32* pSubImage,U32 AverageColour,
-                                    float SubWidth,float SubHeight);
-  void Pete_MetaImage_DrawSubImage(U32* pSource, U32* pShrunkBuffer,
-                                   U32* pOutput, int nLeftX,int nTopY,int nRightX,int nBottomY,
-                                   U32 WholeImageAverage,int nClippedLeftX,int nClippedTopY,
-                                   int nClippedRightX,int nClippedBottomY,U32 SubImageAverage);
   U32 Pete_MetaImage_GetAreaAverage(U32* pImage,int nLeftX,int nTopY,
                                     int nRightX,int nBottomY,int nStride);
   U32 Pete_MetaImage_ShrinkSourceImage(U32* pSource, U32* pOutput,
@@ -87,12 +118,6 @@ protected:
 
   U32  CreateSubImageYUV(U32* pInput,U32* pSubImage,float SubWidth,
                          float SubHeight);
-  void DrawSubImagesYUV(U32* pSubImage,U32 AverageColour,float SubWidth,
-                        float SubHeight);
-  void DrawSubImageYUV(U32* pSource, U32* pShrunkBuffer,U32* pOutput,
-                       int nLeftX,int nTopY,int nRightX,int nBottomY,U32 WholeImageAverage,
-                       int nClippedLeftX,int nClippedTopY,int nClippedRightX,int nClippedBottomY,
-                       U32 SubImageAverage);
   U32  GetAreaAverageYUV(U32* pImage,int nLeftX,int nTopY,int nRightX,
                          int nBottomY,int nStride);
   U32  ShrinkSourceImageYUV(U32* pSource, U32* pOutput, float SubWidth,
@@ -102,12 +127,6 @@ protected:
 
   U8  CreateSubImageGray(U8* pInput,U8* pSubImage,float SubWidth,
                          float SubHeight);
-  void DrawSubImagesGray(U8* pSubImage,U8 AverageColour,float SubWidth,
-                         float SubHeight);
-  void DrawSubImageGray(U8* pSource, U8* pShrunkBuffer,U8* pOutput,
-                        int nLeftX,int nTopY,int nRightX,int nBottomY,U8 WholeImageAverage,
-                        int nClippedLeftX,int nClippedTopY,int nClippedRightX,int nClippedBottomY,
-                        U8 SubImageAverage);
   U8  GetAreaAverageGray(U8* pImage,int nLeftX,int nTopY,int nRightX,
                          int nBottomY,int nStride);
   U8  ShrinkSourceImageGray(U8* pSource, U8* pOutput, float SubWidth,
@@ -20,6 +20,19 @@
 
 CPPEXTERN_NEW_WITH_GIMME(pix_mix);
 
+namespace
+{
+const char*s_fragmentShader =
+  "uniform sampler2D tex0;\n"
+  "uniform sampler2D tex1;\n"
+  "uniform vec2 gain;\n"
+  "void main(void) {\n"
+  "  vec4 l = texture2D(tex0, gl_TexCoord[0].st);\n"
+  "  vec4 r = texture2D(tex1, gl_TexCoord[0].st);\n"
+  "  gl_FragColor = vec4(l.rgb * gain.x + r.rgb * gain.y, l.a);\n"
+  "}\n";
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_mix
@@ -29,6 +42,7 @@ CPPEXTERN_NEW_WITH_GIMME(pix_mix);
 //
 /////////////////////////////////////////////////////////
 pix_mix :: pix_mix(int argc, t_atom*argv)
+  : m_gpu(s_fragmentShader)
 {
   switch (argc) {
   case 0:
@@ -426,6 +440,21 @@ void pix_mix :: gainMess (float X, float Y)
   setPixModified();
 }
 
+/////////////////////////////////////////////////////////
+// processDualTexture
+//
+/////////////////////////////////////////////////////////
+bool pix_mix :: processDualTexture(pixBlock &image, pixBlock &right)
+{
+  m_gpu.setUniform("gain", imageGain/256.f, rightGain/256.f);
+  return m_gpu.process(image, &right);
+}
+void pix_mix :: stopRendering(void)
+{
+  GemPixDualObj::stopRendering();
+  m_gpu.release();
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
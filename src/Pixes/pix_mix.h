@@ -17,6 +17,7 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_MIX_H_
 
 #include "Base/GemPixDualObj.h"
+#include "Gem/ImageGPU.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -68,6 +69,12 @@ protected:
 
   long imageGain,rightGain;
 
+  //////////
+  // Do the processing on the GPU
+  virtual bool    processDualTexture(pixBlock &image, pixBlock &right);
+  virtual void    stopRendering(void);
+  gem::image::GPUFilter m_gpu;
+
 
 private:
 
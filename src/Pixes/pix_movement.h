@@ -32,6 +32,8 @@ pix_movement
 #define _INCLUDE__GEM_PIXES_PIX_MOVEMENT_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageMotion.h"
+#include "Utils/ThreadPool.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -65,21 +67,19 @@ protected:
   virtual void    processRGBAImage(imageStruct &image);
   virtual void    processYUVImage(imageStruct &image);
   virtual void    processGrayImage(imageStruct &image);
-#ifdef __MMX__
-  virtual void    processGrayMMX(imageStruct &image);
-#endif
-
-#ifdef __VEC__
-  virtual void    processYUVAltivec(imageStruct &image);
-#endif
 
   //////////
-  // the last image (grey-scale)
-  imageStruct    buffer;
-  imageStruct    buffer2; // (the difference image for greyscales)
+  // the motion analysis (optionally calculated on several threads)
+  gem::image::Motion m_motion;
+  gem::thread::ThreadPool m_pool;
   //////////
   // the movement-mode
   unsigned char  threshold;
+  // if >0, output the motion-history that fades by 'decay' per frame
+  unsigned char  m_decay;
+  void threadMess(int threads);
+  void decayMess(t_float decay);
+  bool analyze(imageStruct &image);
 
   //////////
   // the methods
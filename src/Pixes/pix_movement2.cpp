@@ -26,31 +26,17 @@ CPPEXTERN_NEW_WITH_TWO_ARGS(pix_movement2, t_float,A_DEFFLOAT,t_float,
   Constructor
   initializes the pixBlocks and pixBlobs
   ------------------------------------------------------------*/
-pix_movement2 :: pix_movement2(t_float lothresh, t_float hithresh):
-  m_frameIndex(0),
-  m_storeBackground(true), m_resetThreshold(true)
+pix_movement2 :: pix_movement2(t_float lothresh, t_float hithresh)
 {
-  int i=3;
-  while(i--) {
-    m_frame[i].xsize=0;
-    m_frame[i].ysize=0;
-    m_frame[i].setCsizeByFormat(GEM_GRAY);
-    m_frame[i].reallocate();
-  }
   m_output.xsize=0;
   m_output.ysize=0;
   m_output.setCsizeByFormat(GEM_GRAY);
   m_output.reallocate();
 
-  m_background.xsize=0;
-  m_background.ysize=0;
-  m_background.setCsizeByFormat(GEM_GRAY);
-  m_background.reallocate();
-
-  m_threshold.xsize=0;
-  m_threshold.ysize=0;
-  m_threshold.setCsizeByFormat(GEM_GRAY);
-  m_threshold.reallocate();
+  m_gray.xsize=0;
+  m_gray.ysize=0;
+  m_gray.setCsizeByFormat(GEM_GRAY);
+  m_gray.reallocate();
 
   m_lowthresh=CLAMP(255.f*MIN(lothresh, hithresh));
   m_thresh=CLAMP(255.f*MAX(lothresh, hithresh));
@@ -62,9 +48,14 @@ pix_movement2 :: pix_movement2(t_float lothresh, t_float hithresh):
   }
 
   /*
-    m_thresh = 150;
-    m_lowthresh = 100;
-  */
+   * a pixel moves, if it differs from both of the last 2 frames;
+   * all other pixels are compared with the background
+   * (which gets updated quickly: 230/256 of the current frame)
+   */
+  m_motion.setHistory(2);
+  m_motion.setLearningRate(230);
+  m_motion.setThreshold(m_thresh);
+  m_motion.setLowThreshold(m_lowthresh);
 
   m_lowthreshInlet=inlet_new(this->x_obj, &this->x_obj->ob_pd,
                              gensym("float"), gensym("low_thresh"));
@@ -90,91 +81,24 @@ pix_movement2 :: ~pix_movement2()
   ------------------------------------------------------------*/
 void pix_movement2 :: processImage(imageStruct &image)
 {
-  int size = image.xsize * image.ysize;
-  int i;
-  // 0. check if we have a new dimension
-  bool firstTime = ((image.xsize!=m_frame[0].xsize)
-                    || (image.ysize!=m_frame[0].ysize));
-  if (firstTime) {
-    m_storeBackground=true;
-    m_resetThreshold=true;
-    m_output.xsize = image.xsize;
-    m_output.ysize = image.ysize;
-    m_output.reallocate();
-
-    m_background.xsize = image.xsize;
-    m_background.ysize = image.ysize;
-    m_background.reallocate();
-
-    m_threshold.xsize = image.xsize;
-    m_threshold.ysize = image.ysize;
-    m_threshold.reallocate();
-
-    i = 3;
-    while(i--) {
-      m_frame[i].xsize=image.xsize;
-      m_frame[i].ysize=image.ysize;
-      m_frame[i].reallocate();
+  const unsigned int flags=gem::image::Motion::FRAMEDIFF
+                           | gem::image::Motion::ADAPTIVE;
+  if(!m_motion.analyze(image, flags, &m_pool)) {
+    // 1. the engine only knows about GRAY, RGBA and YUV
+    m_gray.setCsizeByFormat(GEM_GRAY);
+    if(!m_gray.convertFrom(&image)
+        || !m_motion.analyze(m_gray, flags, &m_pool)) {
+      error("no method for this kind of color");
+      return;
     }
-    m_frameIndex=0;
-  }
-  if(m_resetThreshold) {
-    // we can do this, because we are in Greyscale-mode
-    memset(m_threshold.data, m_thresh, m_threshold.xsize * m_threshold.ysize);
-    m_resetThreshold=false;
-  }
-
-  // 1. store the current frame as gray-image in the appropriate buffer
-  m_frame[m_frameIndex].setCsizeByFormat();
-  if(!m_frame[m_frameIndex].convertFrom(&image)) {
-    error("no method for this kind of color");
-    return;
   }
 
-  // 2. if this is the first time, copy the current frame to the other frames as well
-  if(m_storeBackground) {
-    m_storeBackground=false;
-    m_background.fromGray(m_frame[0].data);
-    for (i = 1; i < 3; i++) {
-      m_frame[i].fromGray(m_frame[0].data);
-    }
-    // use our (black) "output"-image as "image" and return
-    m_output.copy2ImageStruct(&image);
+  // 2. use our (grayscale) "output"-image as "image"
+  m_output.xsize = image.xsize;
+  m_output.ysize = image.ysize;
+  m_output.reallocate();
+  memcpy(m_output.data, m_motion.mask(), m_output.xsize * m_output.ysize);
 
-    if(firstTime) {
-      return;
-    }
-  }
-  // 3. now calc the difference
-  unsigned char* cur   = m_frame[m_frameIndex].data;
-  unsigned char* old2  = m_frame[(m_frameIndex+1)%3].data;
-  unsigned char* old1  = m_frame[(m_frameIndex+2)%3].data;
-  unsigned char* out   = m_output.data;
-  unsigned char* thresh = m_threshold.data;
-  unsigned char* back  = m_background.data;
-
-  m_frameIndex++;
-  m_frameIndex%=3;
-
-  for(i=0; i<size; i++) {
-
-    if ((abs(cur[i]-old1[i]) > thresh[i]) &&
-        (abs(cur[i]-old2[i]) > thresh[i])) {
-      out[i] = 255;
-    } else {
-      out[i] = 0;
-      if(abs(cur[i]-back[i])>thresh[i]) {
-        out[i] = 255;
-      }
-
-      if(thresh[i] < m_lowthresh) {
-        thresh[i] = m_lowthresh;
-      }
-
-      thresh[i] = ((256-26)*thresh[i]+(26)*5*abs(cur[i]-back[i]))>>8;
-      back [i] = (26*back [i]+(256-26)*cur[i])>>8;
-    }
-  }
   m_output.upsidedown = image.upsidedown;
   m_output.copy2ImageStruct(&image);
 }
@@ -190,7 +114,7 @@ void pix_movement2 :: threshMess(int thresh)
     return;
   }
   m_thresh = CLAMP(thresh);
-  m_resetThreshold=true;
+  m_motion.setThreshold(m_thresh);
 }
 
 /*------------------------------------------------------------
@@ -204,6 +128,7 @@ void pix_movement2 :: lowThreshMess(int thresh)
     return;
   }
   m_lowthresh = CLAMP(thresh);
+  m_motion.setLowThreshold(m_lowthresh);
 }
 
 /*------------------------------------------------------------
@@ -211,7 +136,15 @@ void pix_movement2 :: lowThreshMess(int thresh)
   ------------------------------------------------------------*/
 void pix_movement2 :: bangMess()
 {
-  m_storeBackground = true;
+  m_motion.reset();
+}
+
+/*------------------------------------------------------------
+  threadMess
+  ------------------------------------------------------------*/
+void pix_movement2 :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
 }
 
 /*------------------------------------------------------------
@@ -229,6 +162,7 @@ void pix_movement2 :: obj_setupCallback(t_class*classPtr)
                   gensym("hi_thresh"), A_FLOAT, A_NULL);
   class_addbang(classPtr,
                 reinterpret_cast<t_method>(&pix_movement2::bangMessCallback));
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
 }
 
 /*------------------------------------------------------------
@@ -2,6 +2,8 @@
 #define _INCLUDE__GEM_PIXES_PIX_MOVEMENT__H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageMotion.h"
+#include "Utils/ThreadPool.h"
 
 class GEM_EXTERN pix_movement2 : public GemPixObj
 {
@@ -18,20 +20,20 @@ protected:
   ~pix_movement2();
   void processImage(imageStruct &image);
 
-  imageStruct m_frame[3];
-  imageStruct m_output, m_threshold, m_background;
-  int m_frameIndex;
+  // the last 3 frames, the background and the per-pixel thresholds
+  gem::image::Motion m_motion;
+  gem::thread::ThreadPool m_pool;
+  imageStruct m_gray, m_output;
 
   unsigned char m_thresh, m_lowthresh;
 
-  bool m_storeBackground, m_resetThreshold;
-
   t_inlet*m_threshInlet, *m_lowthreshInlet;
 
 
   void threshMess(int thresh);
   void lowThreshMess(int thresh);
   void bangMess();
+  void threadMess(int threads);
 
 private:
   static void threshMessCallback(void *data, t_float fthresh);
@@ -21,11 +21,40 @@
 #include "Gem/Cache.h"
 #include "Gem/State.h"
 #include "Gem/ImageIO.h"
+#include "Gem/Properties.h"
 
 CPPEXTERN_NEW_WITH_FOUR_ARGS(pix_multiimage, t_symbol*, A_DEFSYMBOL,
                              t_floatarg, A_DEFFLOAT, t_floatarg, A_DEFFLOAT, t_floatarg, A_DEFFLOAT);
 
-pix_multiimage::multiImageCache *pix_multiimage::s_imageCache = NULL;
+std::map<std::string, pix_multiimage::multiImageCache*>
+pix_multiimage::s_imageCache;
+
+namespace
+{
+/* point 'to' to the (shared) pixels of 'from' */
+void referenceImage(const imageStruct*from, pixBlock&to)
+{
+  from->copy2ImageStruct(&to.image);
+  to.texture=0;
+  to.textureTarget=0;
+  to.readonly=true;
+}
+/* make 'to' refer to the texture-resident image 'from' */
+void referenceTexture(const pixBlock&from, pixBlock&to)
+{
+  to.image.xsize=from.image.xsize;
+  to.image.ysize=from.image.ysize;
+  to.image.csize=from.image.csize;
+  to.image.format=from.image.format;
+  to.image.type=from.image.type;
+  to.image.upsidedown=from.image.upsidedown;
+  to.image.data=0;
+  to.image.not_owned=true;
+  to.texture=from.texture;
+  to.textureTarget=from.textureTarget;
+  to.readonly=true;
+}
+};
 
 /////////////////////////////////////////////////////////
 //
@@ -37,11 +66,15 @@ pix_multiimage::multiImageCache *pix_multiimage::s_imageCache = NULL;
 /////////////////////////////////////////////////////////
 pix_multiimage :: pix_multiimage(t_symbol* filename, t_floatarg baseImage,
                                  t_floatarg topImage, t_floatarg skipRate)
-  : m_numImages(0), m_curImage(-1), m_loadedCache(NULL)
+  : m_numImages(0), m_curImage(-1), m_shownImage(-1), m_loadedCache(NULL)
+  , m_upload(false)
+  , m_pollClock(NULL)
+  , m_infoOut(gem::RTE::Outlet(this))
 {
   inlet_new(this->x_obj, &this->x_obj->ob_pd, gensym("float"),
             gensym("img_num"));
   m_pixBlock.image = m_imageStruct;
+  m_pollClock=clock_new(this, reinterpret_cast<t_method>(pollCallback));
 
   // make sure that there are some characters
   if (filename->s_name[0]) {
@@ -64,6 +97,13 @@ pix_multiimage :: pix_multiimage(t_symbol* filename, t_floatarg baseImage,
 pix_multiimage :: ~pix_multiimage()
 {
   cleanImages();
+  for(unsigned int i=0; i<m_textures.size(); i++) {
+    delete m_textures[i];
+    delete m_texturePixBlocks[i];
+  }
+  if(m_pollClock) {
+    clock_free(m_pollClock);
+  }
 }
 
 /////////////////////////////////////////////////////////
@@ -93,31 +133,26 @@ void pix_multiimage :: openMess(t_symbol* filename, int baseImage,
     skipRate = 1;
   }
 
-  // have we already loaded the image?
-  multiImageCache *cache = s_imageCache;
-  int found = 0;
-  while (!found && cache) {
-    if (baseImage == cache->baseImage &&
-        topImage == cache->topImage &&
-        skipRate == cache->skipRate &&
-        !strcmp(filename->s_name, cache->imageName)) {
-      found = 1;
-    } else {
-      cache = cache->next;
-    }
-  }
+  // have we already loaded the images?
+  char range[64];
+  sprintf(range, "%d:%d:%d:", baseImage, topImage, skipRate);
+  const std::string key=std::string(range)+filename->s_name;
+  std::map<std::string, multiImageCache*>::iterator it=s_imageCache.find(key);
 
-  // yep, we have it
-  if (found) {
-    m_loadedCache = cache;
+  // yep, we have them (or they are being loaded)
+  if (it!=s_imageCache.end()) {
+    m_loadedCache = it->second;
     m_loadedCache->refCount++;
+    m_loadedCache->users.push_back(this);
     m_curImage = 0;
     m_numImages = m_loadedCache->numImages;
-    m_loadedCache->images[m_curImage]->copy2Image(&m_pixBlock.image);
-    m_pixBlock.newimage = 1;
     if (m_cache) {
       m_cache->resendImage = 1;
     }
+    sendProgress();
+    if(m_loadedCache->isLoading()) {
+      clock_delay(m_pollClock, 0);
+    }
     return;
   }
 
@@ -143,12 +178,16 @@ void pix_multiimage :: openMess(t_symbol* filename, int baseImage,
   postName[255]='\0';
 
   // need to figure out how many filenames there are to load
-  m_numImages = (topImage + 1 - baseImage) / skipRate;
+  int numImages = (topImage + 1 - baseImage) / skipRate;
+  if (numImages < 1) {
+    return;
+  }
 
   // create the new cache
-  multiImageCache *newCache = new multiImageCache(filename->s_name);
-  newCache->images = new imageStruct*[m_numImages];
-  newCache->numImages = m_numImages;
+  multiImageCache *newCache = new multiImageCache(key);
+  newCache->images.resize(numImages, NULL);
+  newCache->filenames.resize(numImages);
+  newCache->numImages = numImages;
   newCache->baseImage = baseImage;
   newCache->topImage = topImage;
   newCache->skipRate = skipRate;
@@ -158,46 +197,139 @@ void pix_multiimage :: openMess(t_symbol* filename, int baseImage,
   canvas_makefilename(const_cast<t_canvas*>(getCanvas()), preName, bufName,
                       MAXPDSTRING);
 
-  // allocate texture bindings for OpenGL
-  newCache->textBind = new unsigned int[m_numImages];
-
-  for (i = 0; i < m_numImages; i++, realNum += skipRate) {
+  for (i = 0; i < numImages; i++, realNum += skipRate) {
     char newName[MAXPDSTRING];
     sprintf(newName, "%s%d%s", bufName, realNum, postName);
-    newCache->textBind[i] = 0;
-    if ( !(newCache->images[i] = image2mem(newName)) ) {
-      // a load failed, blow away the cache
-      newCache->numImages = i;
-      delete newCache;
-      m_numImages = 0;
-      return;
-    }
+    newCache->filenames[i] = newName;
   }
 
+  m_loadedCache = newCache;
+  m_numImages = numImages;
   m_curImage = 0;
-  newCache->images[m_curImage]->copy2Image(&m_pixBlock.image);
-  m_pixBlock.newimage = 1;
+  newCache->refCount++;
+  newCache->users.push_back(this);
+  s_imageCache[newCache->key]=newCache;
+
+  verbose(1, "loading images: %s %s from %d to %d skipping %d",
+          bufName, postName, baseImage, topImage, skipRate);
+
+  // queue the images, the first ones first
+  for (i = 0; i < numImages; i++) {
+    gem::image::load::id_t ID = gem::image::load::INVALID;
+    newCache->loading = i;
+    if(!gem::image::load::async(loadedCallback, newCache,
+                                newCache->filenames[i], ID, -i)) {
+      // the image could not be loaded synchronously either
+      if(gem::image::load::INVALID == ID) {
+        newCache->numFailed++;
+        error("unable to load '%s'", newCache->filenames[i].c_str());
+      }
+      continue;
+    }
+    if(gem::image::load::IMMEDIATE != ID) {
+      newCache->pending[ID] = i;
+    }
+  }
+  newCache->loading = -1;
+
   if (m_cache) {
     m_cache->resendImage = 1;
   }
+  sendProgress();
+  if(newCache->isLoading()) {
+    clock_delay(m_pollClock, 0);
+  }
+}
 
-  m_loadedCache = newCache;
-  newCache->refCount++;
-
-  // insert the cache at the end of the linked list
-  multiImageCache *ptr = s_imageCache;
+/////////////////////////////////////////////////////////
+// loadedCallback
+//
+/////////////////////////////////////////////////////////
+void pix_multiimage :: loadedCallback(void *data,
+                                      gem::image::load::id_t ID,
+                                      const imageStruct*img,
+                                      const gem::Properties&props)
+{
+  multiImageCache*cache=reinterpret_cast<multiImageCache*>(data);
+  int index=cache->loading;
+  if(gem::image::load::IMMEDIATE != ID) {
+    std::map<gem::image::load::id_t, int>::iterator it=cache->pending.find(ID);
+    if(it==cache->pending.end()) {
+      gem::image::load::release(img);
+      return;
+    }
+    index=it->second;
+    cache->pending.erase(it);
+  }
+  if(index<0 || index>=cache->numImages) {
+    gem::image::load::release(img);
+    return;
+  }
 
-  if (!ptr) {
-    s_imageCache = newCache;
+  if(img) {
+    cache->images[index]=img;
+    cache->numLoaded++;
   } else {
-    while(ptr->next) {
-      ptr = ptr->next;
+    cache->numFailed++;
+    pd_error(0, "[pix_multiimage]: unable to load '%s'",
+             cache->filenames[index].c_str());
+  }
+  /* IMMEDIATE images are loaded before anybody is listening */
+  if(gem::image::load::IMMEDIATE != ID) {
+    /* the users might go away while being notified */
+    std::vector<pix_multiimage*>users=cache->users;
+    for(unsigned int i=0; i<users.size(); i++) {
+      users[i]->imageLoaded(index, (NULL!=img));
     }
-    ptr->next = newCache;
   }
+}
+
+/////////////////////////////////////////////////////////
+// imageLoaded
+//
+/////////////////////////////////////////////////////////
+void pix_multiimage :: imageLoaded(int index, bool success)
+{
+  /* render() picks up the current image as soon as it is there */
+  sendProgress();
+}
+
+/////////////////////////////////////////////////////////
+// sendProgress
+//
+/////////////////////////////////////////////////////////
+void pix_multiimage :: sendProgress(void)
+{
+  if(!m_loadedCache) {
+    return;
+  }
+  std::vector<gem::any>atoms;
+  gem::any value;
+  atoms.push_back(value=m_loadedCache->numLoaded+m_loadedCache->numFailed);
+  atoms.push_back(value=m_loadedCache->numImages);
+  m_infoOut.send("progress", atoms);
+
+  if(!m_loadedCache->isLoading()) {
+    atoms.clear();
+    atoms.push_back(value=std::string(m_loadedCache->numFailed?"fail":"done"));
+    atoms.push_back(value=m_loadedCache->numLoaded);
+    atoms.push_back(value=m_loadedCache->numImages);
+    m_infoOut.send("load", atoms);
+  }
+}
 
-  post("loaded images: %s %s from %d to %d skipping %d",
-       bufName, postName, baseImage, topImage, skipRate);
+/////////////////////////////////////////////////////////
+// pollCallback
+//
+/////////////////////////////////////////////////////////
+void pix_multiimage :: pollCallback(void *data)
+{
+  pix_multiimage*me=reinterpret_cast<pix_multiimage*>(data);
+  /* this might deliver the images to other objects as well */
+  gem::image::load::poll();
+  if(me->m_loadedCache && me->m_loadedCache->isLoading()) {
+    clock_delay(me->m_pollClock, 10);
+  }
 }
 
 /////////////////////////////////////////////////////////
@@ -210,12 +342,50 @@ void pix_multiimage :: render(GemState *state)
   if (!m_numImages) {
     return;
   }
+  if (m_loadedCache->isLoading()) {
+    gem::image::load::poll();
+  }
 
   // do we need to reload the image?
-  if (m_cache->resendImage) {
-    m_loadedCache->images[m_curImage]->refreshImage(&m_pixBlock.image);
-    m_pixBlock.newimage = 1;
-    m_cache->resendImage = 0;
+  if (m_shownImage != m_curImage || (m_cache && m_cache->resendImage)) {
+    const imageStruct*img=m_loadedCache->images[m_curImage];
+    if (img) {
+      bool uploaded=false;
+      if (m_upload && gem::image::GPUFilter::isRunnable()) {
+        if ((int)m_textures.size() < m_numImages) {
+          m_textures.resize(m_numImages, NULL);
+          m_texturePixBlocks.resize(m_numImages, NULL);
+        }
+        pixBlock*&block=m_texturePixBlocks[m_curImage];
+        if (!block) {
+          // the first time we show this image: upload it
+          if(!m_textures[m_curImage]) {
+            m_textures[m_curImage]=new gem::image::GPUFilter();
+          }
+          block=new pixBlock();
+          img->copy2ImageStruct(&block->image);
+          if (!m_textures[m_curImage]->upload(*block)) {
+            delete block;
+            block=NULL;
+          }
+        }
+        if (block) {
+          referenceTexture(*block, m_pixBlock);
+          uploaded=true;
+        }
+      }
+      if (!uploaded) {
+        referenceImage(img, m_pixBlock);
+      }
+      m_pixBlock.newimage = 1;
+      m_shownImage = m_curImage;
+    }
+    if (m_cache) {
+      m_cache->resendImage = 0;
+    }
+  }
+  if (m_shownImage < 0) {
+    return;
   }
 
   state->set(GemState::_PIX, &m_pixBlock);
@@ -237,12 +407,23 @@ void pix_multiimage :: postrender(GemState *state)
 /////////////////////////////////////////////////////////
 void pix_multiimage :: startRendering()
 {
-  if (!m_numImages) {
-    return;
-  }
+  m_shownImage = -1;
+}
 
-  m_loadedCache->images[m_curImage]->refreshImage(&m_pixBlock.image);
-  m_pixBlock.newimage = 1;
+/////////////////////////////////////////////////////////
+// stopRendering
+//
+/////////////////////////////////////////////////////////
+void pix_multiimage :: stopRendering()
+{
+  for(unsigned int i=0; i<m_textures.size(); i++) {
+    if(m_textures[i]) {
+      m_textures[i]->release();
+    }
+    delete m_texturePixBlocks[i];
+    m_texturePixBlocks[i]=NULL;
+  }
+  m_shownImage = -1;
 }
 
 /////////////////////////////////////////////////////////
@@ -264,9 +445,16 @@ void pix_multiimage :: changeImage(int imgNum)
     return;
   }
   m_curImage = imgNum;
-  if (m_cache) {
-    m_cache->resendImage = 1;
-  }
+}
+
+/////////////////////////////////////////////////////////
+// uploadMess
+//
+/////////////////////////////////////////////////////////
+void pix_multiimage :: uploadMess(bool onoff)
+{
+  m_upload = onoff;
+  m_shownImage = -1;
 }
 
 /////////////////////////////////////////////////////////
@@ -275,36 +463,39 @@ void pix_multiimage :: changeImage(int imgNum)
 /////////////////////////////////////////////////////////
 void pix_multiimage :: cleanImages()
 {
-  if (m_numImages) {
+  if (m_loadedCache) {
+    std::vector<pix_multiimage*>&users=m_loadedCache->users;
+    for(unsigned int i=0; i<users.size(); i++) {
+      if(users[i] == this) {
+        users.erase(users.begin()+i);
+        break;
+      }
+    }
+
     // decrement the reference count
     m_loadedCache->refCount--;
 
     // If the refCount == 0, then destroy the cache
+    // (this cancels all images that are still being loaded)
     if (m_loadedCache->refCount == 0) {
-      // find the cache
-      multiImageCache *ptr = s_imageCache;
-
-      // if the loaded cache is the first cache in the list
-      if (m_loadedCache == s_imageCache) {
-        s_imageCache = m_loadedCache->next;
-        delete m_loadedCache;
-      } else {
-        while (ptr && ptr->next != m_loadedCache) {
-          ptr = ptr->next;
-        }
-        if (!ptr) {
-          error("Unable to find image cache!");
-        } else {
-          ptr->next = m_loadedCache->next;
-          delete m_loadedCache;
-        }
-      }
+      s_imageCache.erase(m_loadedCache->key);
+      delete m_loadedCache;
     }
 
     m_loadedCache = NULL;
     m_numImages = 0;
+    m_shownImage = -1;
     m_pixBlock.image.clear();
     m_pixBlock.image.data = NULL;
+    m_pixBlock.texture = 0;
+    m_pixBlock.textureTarget = 0;
+    m_pixBlock.readonly = false;
+  }
+
+  // the textures are re-used for the next sequence
+  for(unsigned int i=0; i<m_texturePixBlocks.size(); i++) {
+    delete m_texturePixBlocks[i];
+    m_texturePixBlocks[i]=NULL;
   }
 }
 
@@ -320,6 +511,7 @@ void pix_multiimage :: obj_setupCallback(t_class *classPtr)
   class_addmethod(classPtr,
                   reinterpret_cast<t_method>(&pix_multiimage::changeImageCallback),
                   gensym("img_num"), A_FLOAT, A_NULL);
+  CPPEXTERN_MSG1(classPtr, "upload", uploadMess, bool);
 }
 void pix_multiimage :: openMessCallback(void *data, t_symbol* filename,
                                         t_float baseImage,
@@ -17,8 +17,13 @@ LOG
 
 #include "Base/GemBase.h"
 #include "Gem/Image.h"
+#include "Gem/ImageIO.h"
+#include "Gem/ImageGPU.h"
+#include "RTE/Outlet.h"
 
-#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -34,6 +39,15 @@ DESCRIPTION
 
     You can select which file by giving a number.
 
+    the images are loaded in the background; the progress is reported
+    on the info outlet
+    the images are shared with the image cache and handed out by reference
+    with "upload 1", each image is uploaded into a texture once,
+    so switching between images does not touch the pixels at all
+    (objects that need the pixels in host memory read such an image back
+    from the texture, so this only pays off in front of [pix_texture] or
+    GPU filters)
+
 -----------------------------------------------------------------*/
 class GEM_EXTERN pix_multiimage : public GemBase
 {
@@ -46,38 +60,53 @@ public:
   pix_multiimage(t_symbol* filename, t_floatarg baseImage,
                  t_floatarg topImage, t_floatarg skipRate);
 
+  /* an image sequence, shared by all objects that opened it */
   class multiImageCache
   {
   public:
 
-    multiImageCache(const char *_imageName)
-      : refCount(0), next(NULL), images(NULL), textBind(NULL),
-        numImages(0), baseImage(0), topImage(0), skipRate(0)
+    multiImageCache(const std::string&_key)
+      : refCount(0), key(_key),
+        numImages(0), numLoaded(0), numFailed(0), loading(0),
+        baseImage(0), topImage(0), skipRate(0)
     {
-      imageName = strdup(_imageName);
     }
     ~multiImageCache()
     {
-      delete imageName;
+      std::map<gem::image::load::id_t, int>::iterator it;
+      for(it=pending.begin(); it!=pending.end(); ++it) {
+        gem::image::load::cancel(it->first);
+      }
       for(int i=0; i < numImages; i++) {
-        delete images[i];
+        gem::image::load::release(images[i]);
       }
-      delete [] textBind;
-      delete [] images;
     }
+    bool isLoading(void) const
+    {
+      return (numLoaded+numFailed < numImages);
+    }
+
     int                 refCount;
-    multiImageCache     *next;
-    imageStruct         **images;
-    unsigned int            *textBind;
+    std::string         key;
+    std::vector<const imageStruct*>images; /* shared with the image cache */
+    std::vector<std::string>filenames;
     int                 numImages;
-    char                *imageName;
+    int                 numLoaded;
+    int                 numFailed;
+    /* the images that are still queued (ID -> index) */
+    std::map<gem::image::load::id_t, int>pending;
+    /* the index of the image being queued (for IMMEDIATE loading) */
+    int                 loading;
+    /* the objects that use this cache */
+    std::vector<pix_multiimage*>users;
     int                 baseImage;
     int                 topImage;
     int                 skipRate;
   };
 
   //////////
-  static multiImageCache  *s_imageCache;
+  // all loaded sequences, by filename and range
+  static std::map<std::string, multiImageCache*>s_imageCache;
 
 protected:
 
@@ -100,15 +129,28 @@ protected:
 
   //////////
   virtual void    startRendering();
+  virtual void    stopRendering();
 
   //////////
   // Change which image to display
   void            changeImage(int imgNum);
 
+  //////////
+  // upload the images into textures
+  void            uploadMess(bool onoff);
+
   //////////
   // Clean up the images and the pixBlock
   void            cleanImages();
 
+  //////////
+  // an image of the sequence has been loaded (or failed to load)
+  void            imageLoaded(int index, bool success);
+
+  //////////
+  // tell the world how far loading has come
+  void            sendProgress(void);
+
   //-----------------------------------
   // GROUP:   Image data
   //-----------------------------------
@@ -120,6 +162,8 @@ protected:
   //////////
   // The current image
   int             m_curImage;
+  // the image in the pixBlock (-1 if none)
+  int             m_shownImage;
 
   //////////
   // The pixBlock with the current image
@@ -130,6 +174,18 @@ protected:
   // The original images
   multiImageCache *m_loadedCache;
 
+  //////////
+  // the texture-resident images (one texture per image)
+  bool            m_upload;
+  std::vector<gem::image::GPUFilter*>m_textures;
+  std::vector<pixBlock*>m_texturePixBlocks; /* NULL if not uploaded yet */
+
+  //////////
+  // deliver loaded images while we are not rendering
+  t_clock         *m_pollClock;
+
+  gem::RTE::Outlet m_infoOut;
+
 private:
 
   //////////
@@ -137,6 +193,10 @@ private:
   static void     openMessCallback(void *data, t_symbol* filename,
                                    t_float baseImage, t_float topImage, t_float skipRate);
   static void     changeImageCallback(void *data, t_float imgNum);
+  static void     loadedCallback(void *data, gem::image::load::id_t ID,
+                                 const imageStruct*img,
+                                 const gem::Properties&props);
+  static void     pollCallback(void *data);
 };
 
 #endif  // for header file
@@ -43,34 +43,26 @@ pix_normalize :: ~pix_normalize()
 /////////////////////////////////////////////////////////
 void pix_normalize :: processRGBAImage(imageStruct &image)
 {
-  unsigned char min=255, max=0;
   int datasize = image.xsize * image.ysize;// *image.csize;
   unsigned char *pixels = image.data;
   int n = datasize;
 
-  while(n--) {
-    // think about this more carefully, to allow normalization for single channels...
-    unsigned char red=pixels[chRed], green=pixels[chGreen],
-                  blue=pixels[chBlue];
-    if (min>red) {
-      min=red;
-    }
-    if (min>green) {
-      min=green;
-    }
-    if (min>blue) {
-      min=blue;
-    }
-    if (max<red) {
-      max=red;
-    }
-    if (max<green) {
-      max=green;
-    }
-    if (max<blue) {
-      max=blue;
-    }
-    pixels+=4;
+  if(!m_stats.analyze(image, gem::image::Statistics::MINMAX, &m_pool)) {
+    return;
+  }
+  // think about this more carefully, to allow normalization for single channels...
+  unsigned char min=m_stats.min[chRed], max=m_stats.max[chRed];
+  if (min>m_stats.min[chGreen]) {
+    min=m_stats.min[chGreen];
+  }
+  if (min>m_stats.min[chBlue]) {
+    min=m_stats.min[chBlue];
+  }
+  if (max<m_stats.max[chGreen]) {
+    max=m_stats.max[chGreen];
+  }
+  if (max<m_stats.max[chBlue]) {
+    max=m_stats.max[chBlue];
   }
 
   t_float scale=(max-min)?255./(max-min):0;
@@ -85,19 +77,13 @@ void pix_normalize :: processRGBAImage(imageStruct &image)
 }
 void pix_normalize :: processGrayImage(imageStruct &image)
 {
-  unsigned char min=255, max=0;
   int datasize = image.xsize * image.ysize;
   unsigned char *pixels = image.data;
   int n = datasize;
-  while(n--) {
-    int val=*pixels++;
-    if (val>max) {
-      max=val;
-    }
-    if (val<min) {
-      min=val;
-    }
+  if(!m_stats.analyze(image, gem::image::Statistics::MINMAX, &m_pool)) {
+    return;
   }
+  unsigned char min=m_stats.min[chGray], max=m_stats.max[chGray];
   pixels=image.data;
   n = datasize;
   if (max==min) {
@@ -115,27 +101,20 @@ void pix_normalize :: processGrayImage(imageStruct &image)
 }
 void pix_normalize :: processYUVImage(imageStruct &image)
 {
-  unsigned char min=255, max=0;
   int datasize = image.xsize * image.ysize;// *image.csize;
   unsigned char *pixels = image.data;
   int n = datasize / 2;
 
-  while(n--) {
-    // think about this more carefully, to allow normalization for single channels...
-    unsigned char y0=pixels[chY0], y1=pixels[chY1];
-    if (min>y0) {
-      min=y0;
-    }
-    if (min>y1) {
-      min=y1;
-    }
-    if (max<y0) {
-      max=y0;
-    }
-    if (max<y1) {
-      max=y1;
-    }
-    pixels+=4;
+  if(!m_stats.analyze(image, gem::image::Statistics::MINMAX, &m_pool)) {
+    return;
+  }
+  // think about this more carefully, to allow normalization for single channels...
+  unsigned char min=m_stats.min[chY0], max=m_stats.max[chY0];
+  if (min>m_stats.min[chY1]) {
+    min=m_stats.min[chY1];
+  }
+  if (max<m_stats.max[chY1]) {
+    max=m_stats.max[chY1];
   }
 
   t_float scale=(max-min)?255./(max-min):0;
@@ -152,9 +131,16 @@ void pix_normalize :: processYUVImage(imageStruct &image)
 }
 
 
+void pix_normalize :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
 /////////////////////////////////////////////////////////
 void pix_normalize :: obj_setupCallback(t_class *classPtr)
-{}
+{
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
+}
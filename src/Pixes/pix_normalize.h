@@ -18,6 +18,8 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_NORMALIZE_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageStatistics.h"
+#include "Utils/ThreadPool.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -60,6 +62,12 @@ protected:
   virtual void        processGrayImage(imageStruct &image);
   virtual void        processYUVImage(imageStruct &image);
 
+  //////////
+  // image statistics (optionally calculated on several threads)
+  gem::image::Statistics m_stats;
+  gem::thread::ThreadPool m_pool;
+  void threadMess(int threads);
+
 private:
 
   //////////
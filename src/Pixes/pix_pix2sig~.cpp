@@ -16,9 +16,15 @@
 
 #include "pix_pix2sig~.h"
 #include "Gem/State.h"
+#include "Gem/ImageGPU.h"
 
 CPPEXTERN_NEW_NAMED(pix_pix2sig, "pix_pix2sig~");
 
+namespace
+{
+const size_t MAX_LATENCY = 16;
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_pix2sig
@@ -28,7 +34,9 @@ CPPEXTERN_NEW_NAMED(pix_pix2sig, "pix_pix2sig~");
 //
 /////////////////////////////////////////////////////////
 pix_pix2sig :: pix_pix2sig(void)
-  : m_fillType(CLEAR)
+  : m_frames(MAX_LATENCY+1)
+  , m_latency(1)
+  , m_fillType(CLEAR)
   , m_offsetX(0), m_offsetY(0)
   , m_line(0)
 {
@@ -63,10 +71,36 @@ void pix_pix2sig :: render(GemState *state)
   pixBlock*img=NULL;
   if(state) {
     state->get(GemState::_PIX, img);
+    img=gem::image::GPUFilter::hostImage(img, m_hostImage);
   }
-  if(img) {
-    img->image.copy2ImageStruct(&m_image);
+  if(!img) {
+    return;
   }
+  /* the DSP holds on to its current image, so the ring is only empty
+   * before the very first image */
+  const size_t queued = m_frames.capacity() - m_frames.writable();
+  if(!img->newimage && queued) {
+    return;
+  }
+  if(queued > m_latency) {
+    m_frames.overrun();
+    return;
+  }
+  img->image.copy2ImageStruct(m_frames.back());
+  m_frames.push();
+}
+void pix_pix2sig :: latencyMess(int frames)
+{
+  if(frames < 1 || static_cast<size_t>(frames) > MAX_LATENCY) {
+    error("latency must be between 1 and %d frames", (int)MAX_LATENCY);
+    return;
+  }
+  m_latency = frames;
+}
+void pix_pix2sig :: statsMess(void)
+{
+  post("stats: %lu underrun(s), %lu overrun(s)",
+       m_frames.underruns(), m_frames.overruns());
 }
 void pix_pix2sig :: filltypeMess(t_symbol*s, int argc, t_atom*argv) {
   if(!argc || A_SYMBOL != argv->a_type) {
@@ -194,9 +228,19 @@ namespace {
 
 void pix_pix2sig :: perform(t_sample**out, size_t N)
 {
-  unsigned char* data = m_image.data;
-  const size_t width = m_image.xsize;
-  const size_t height = m_image.ysize;
+  /* skip to the newest image the latency allows */
+  const size_t latency = m_latency;
+  while(m_frames.readable() > latency) {
+    m_frames.pop();
+  }
+  imageStruct*image = m_frames.front();
+  if(!image) {
+    m_frames.underrun();
+  }
+
+  unsigned char* data = image?image->data:0;
+  const size_t width = image?image->xsize:0;
+  const size_t height = image?image->ysize:0;
   const size_t pixsize = width * height;
   t_sample*outsignal[] = {
     out[0], out[1], out[2], out[3]
@@ -222,7 +266,7 @@ void pix_pix2sig :: perform(t_sample**out, size_t N)
   if(line<0)
     line = height + line;
 
-  switch(m_image.type) {
+  switch(image->type) {
   case GL_UNSIGNED_INT_8_8_8_8:
     swap = true;
     /* fallthrough */
@@ -253,9 +297,9 @@ void pix_pix2sig :: perform(t_sample**out, size_t N)
       size_t count = N-processed;
       m_offsetX %= width;
       m_offsetY %= height;
-      size_t r = m_image.upsidedown?m_offsetY:(height-m_offsetY);
+      size_t r = image->upsidedown?m_offsetY:(height-m_offsetY);
       if ((m_offsetX + count) > width) count = (width - m_offsetX);
-      p2s_perform(outsignal, count, data, r*width+m_offsetX, m_image.format, scale, swap);
+      p2s_perform(outsignal, count, data, r*width+m_offsetX, image->format, scale, swap);
       processed += count;
       m_offsetX = 0;
       m_offsetY = (m_offsetY+1)%height;
@@ -263,20 +307,20 @@ void pix_pix2sig :: perform(t_sample**out, size_t N)
     while ((processed < N) && (processed+width < pixsize)) {
       /* fill the lines */
       size_t r = m_offsetY;
-      if(!m_image.upsidedown) r = height-r-1;
+      if(!image->upsidedown) r = height-r-1;
       size_t count = N-processed;
       if (count>width) count = width;
-      p2s_perform(outsignal, count, data, r*width, m_image.format, scale, swap);
+      p2s_perform(outsignal, count, data, r*width, image->format, scale, swap);
       processed += count;
       m_offsetY = (m_offsetY+1)%height;
     }
     /* fill the final (possibly truncated) line */
     if((processed < N) && processed < pixsize) {
         size_t r = m_offsetY;
-        if(!m_image.upsidedown) r = height-r-1;
+        if(!image->upsidedown) r = height-r-1;
         size_t count = N-processed;
         if (count>width) count = width;
-        p2s_perform(outsignal, count, data, r*width+m_offsetX, m_image.format, scale, swap);
+        p2s_perform(outsignal, count, data, r*width+m_offsetX, image->format, scale, swap);
         processed += count;
         m_offsetX = (count % width);
         m_offsetY += !m_offsetX;
@@ -292,9 +336,9 @@ void pix_pix2sig :: perform(t_sample**out, size_t N)
     if(1) {
       size_t count = N;
       size_t r = m_offsetY;
-      if (!m_image.upsidedown) r = height-r-1;
+      if (!image->upsidedown) r = height-r-1;
       if ((m_offsetX + count) > width) count = (width - m_offsetX);
-      p2s_perform(outsignal, count, data, r*width+m_offsetX, m_image.format, scale, swap);
+      p2s_perform(outsignal, count, data, r*width+m_offsetX, image->format, scale, swap);
       processed += count;
       m_offsetX = 0;
       m_offsetY = (m_offsetY+1)%height;
@@ -346,4 +390,6 @@ void pix_pix2sig :: obj_setupCallback(t_class *classPtr)
   dspCallbackClass dspCB;
   class_addmethod(classPtr, reinterpret_cast<t_method>(dspCB.callback), gensym("dsp"), A_CANT, 0);
   CPPEXTERN_MSG (classPtr, "mode", filltypeMess);
+  CPPEXTERN_MSG1(classPtr, "latency", latencyMess, int);
+  CPPEXTERN_MSG0(classPtr, "stats", statsMess);
 }
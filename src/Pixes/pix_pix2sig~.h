@@ -18,6 +18,7 @@
 
 #include "Base/GemBase.h"
 #include "Gem/Image.h"
+#include "Utils/ThreadRing.h"
 
 /*-----------------------------------------------------------------
   -------------------------------------------------------------------
@@ -33,6 +34,11 @@
 
   4 outlets with signals : R~, G~, B~, A~
 
+  "latency" <frames> - number of frames (1..16) queued between
+                       the render and the DSP (default: 1)
+  "stats" - print the number of underruns (DSP without an image)
+            and overruns (images dropped because the DSP lagged behind)
+
   -----------------------------------------------------------------*/
 class GEM_EXTERN pix_pix2sig : public GemBase
 {
@@ -67,8 +73,12 @@ protected:
   //-----------------------------------
 
   //////////
-  // the current image
-  imageStruct    m_image;
+  // the images on their way from the render to the DSP
+  // (the DSP plays the oldest one, until a newer one is there)
+  gem::thread::ThreadRing<imageStruct> m_frames;
+  size_t m_latency;
+  void latencyMess(int frames);
+  void statsMess(void);
 
   //////////
   // the outlets~
@@ -81,6 +91,10 @@ protected:
   typedef enum {CLEAR, FILL, LINE, WATERFALL, INVALID}  filltype_t;
   filltype_t m_fillType;
   int m_line; /* desired line (for waterfall mode) */
+
+  //////////
+  // texture-resident images are read back into here
+  pixBlock m_hostImage;
 };
 
 #endif  // for header file
@@ -38,14 +38,10 @@ pix_puzzle :: pix_puzzle() :
   blockxsize(0), blockysize(0),  blocknum(1), spacepos(0),
   blockw(8), blockh(8),
   blockpos(0),
-  blockoffset(0),
   marginw(0), marginh(0),
   m_force(true),
   m_game(false)
 {
-  myImage.xsize=myImage.ysize=512;
-  myImage.setCsizeByFormat(GEM_RGBA);
-  myImage.allocate();
 }
 
 /////////////////////////////////////////////////////////
@@ -54,9 +50,6 @@ pix_puzzle :: pix_puzzle() :
 /////////////////////////////////////////////////////////
 pix_puzzle :: ~pix_puzzle()
 {
-  if (blockoffset) {
-    delete [] blockoffset;
-  }
   if (blockpos) {
     delete [] blockpos;
   }
@@ -68,12 +61,9 @@ pix_puzzle :: ~pix_puzzle()
 //  Puzzle-Buf
 //
 /////////////////////////////////////////////////////////
-void pix_puzzle :: makePuzzleBlocks(int xsize, int ysize, int csize)
+void pix_puzzle :: makePuzzleBlocks(int xsize, int ysize)
 {
-  int i, x, y;
-  if (blockoffset) {
-    delete [] blockoffset;
-  }
+  int i;
   if (blockpos) {
     delete [] blockpos;
   }
@@ -87,13 +77,8 @@ void pix_puzzle :: makePuzzleBlocks(int xsize, int ysize, int csize)
 
   spacepos = blocknum - 1;
 
-  blockoffset = new int[blocknum];
   blockpos = new int[blocknum];
 
-  for(y=0; y<blockh; y++)
-    for(x=0; x<blockw; x++) {
-      blockoffset[y*blockw+x] = (y*blockysize*xsize + x*blockxsize)*csize;
-    }
   for(i=0; i<blocknum; i++) {
     blockpos[i] = i;
   }
@@ -120,8 +105,42 @@ void pix_puzzle :: shuffle()
     blockpos[a] = blockpos[b];
     blockpos[b] = c;
   }
+  m_remap.invalidate();
   setPixModified();
 }
+
+/////////////////////////////////////////////////////////
+// makeMap
+//   each pixel of a block is taken from the block at 'blockpos'
+//   the margins (that don't make up a full block) are left in place
+/////////////////////////////////////////////////////////
+void pix_puzzle :: makeMap(int*map, int xsize, int ysize)
+{
+  int x, y, xx, yy, i;
+  for(i=0; i<xsize*ysize; i++) {
+    map[i] = i;
+  }
+
+  i=0;
+  for (y=0; y<blockh; y++) {
+    for(x=0; x<blockw; x++) {
+      const int srcx = (blockpos[i]%blockw)*blockxsize;
+      const int srcy = (blockpos[i]/blockw)*blockysize;
+      // leave one rectangle blank (for the puzzle game)
+      const bool blank = (m_game && spacepos == i);
+      int*q = map + (y*blockysize*xsize + x*blockxsize);
+      for(yy=0; yy<blockysize; yy++) {
+        const int src = (srcy+yy)*xsize + srcx;
+        for(xx=0; xx<blockxsize; xx++) {
+          q[xx] = blank?-1:(src+xx);
+        }
+        q += xsize;
+      }
+      i++;
+    }
+  }
+}
+
 /////////////////////////////////////////////////////////
 // sizeMess
 //
@@ -147,6 +166,7 @@ void pix_puzzle :: moveMess(int direction)
   }
   if (direction==5) {
     m_game=!m_game;
+    m_remap.invalidate();
   }
   if (!m_game) {
     return;
@@ -191,6 +211,7 @@ void pix_puzzle :: moveMess(int direction)
   blockpos[nextpos] = tmp;
   spacepos = nextpos;
 
+  m_remap.invalidate();
   setPixModified();
 }
 
@@ -200,161 +221,31 @@ void pix_puzzle :: moveMess(int direction)
 /////////////////////////////////////////////////////////
 void pix_puzzle :: processImage(imageStruct &image)
 {
-  unsigned char *src = image.data;
-  unsigned char *dest;
-
-  int x, y, xx, yy, i;
-  unsigned char *p, *q;
-
   if (m_force
-      || (myImage.xsize*myImage.ysize*myImage.csize !=
-          image.xsize*image.ysize*image.csize)) {
-    myImage.clear();
+      || m_remap.width  != static_cast<unsigned int>(image.xsize)
+      || m_remap.height != static_cast<unsigned int>(image.ysize)) {
     m_force = false;
 
-    myImage.xsize = image.xsize;
-    myImage.ysize = image.ysize;
-    myImage.setCsizeByFormat(image.format);
-
-    myImage.reallocate();
-
-    makePuzzleBlocks(image.xsize, image.ysize, image.csize);
+    makePuzzleBlocks(image.xsize, image.ysize);
     shuffle();
   }
 
-  myImage.xsize = image.xsize;
-  myImage.ysize = image.ysize;
-  myImage.setCsizeByFormat(image.format);
-
-  dest = myImage.data;
-
-  i=0;
-  for (y=0; y<blockh; y++) {
-    for(x=0; x<blockw; x++) {
-      p = &src[blockoffset[blockpos[i]]];
-      q = &dest[blockoffset[i]];
-      if(m_game && spacepos ==
-          i) { // leave one rectangle blank (for the puzzle game)
-        for(yy=0; yy<blockysize; yy++) {
-          for(xx=0; xx<blockxsize*image.csize; xx++) {
-            q[xx] = 0;
-          }
-          q += image.xsize*image.csize;
-        }
-      } else {
-        for(yy=0; yy<blockysize; yy++) {
-          for(xx=0; xx<blockxsize*image.csize; xx++) {
-            q[xx] = p[xx];
-          }
-          q += image.xsize*image.csize;
-          p += image.xsize*image.csize;
-        }
-      }
-      i++;
-    }
-  }
-
-  p = src +  blockw * blockxsize;
-  q = dest + blockw * blockxsize;
-
-  if(marginw) {
-    for(y=0; y<blockh*blockysize; y++) {
-      for(x=0; x<marginw; x++) {
-        *q++ = *p++;
-      }
-      p += image.xsize - marginw;
-      q += image.xsize - marginw;
-    }
+  if (m_remap.update(image.xsize, image.ysize)) {
+    makeMap(m_remap.map(), image.xsize, image.ysize);
   }
 
-  if(marginh) {
-    p = src + (blockh * blockysize) * image.xsize;
-    q = dest + (blockh * blockysize) * image.xsize;
-    memcpy(p, q, marginh*image.xsize*image.csize);
+  if (m_remap.apply(image, myImage, &m_pool)) {
+    image.data=myImage.data;
   }
-
-  image.data=myImage.data;
 }
 
 /////////////////////////////////////////////////////////
-// processImage
+// threadMess
 //
 /////////////////////////////////////////////////////////
-void pix_puzzle :: processYUVImage(imageStruct &image)
+void pix_puzzle :: threadMess(int threads)
 {
-  unsigned char *src = image.data;
-  unsigned char *dest;
-
-  int x, y, xx, yy, i;
-  unsigned char *p, *q;
-
-  if (m_force
-      || (myImage.xsize*myImage.ysize*myImage.csize !=
-          image.xsize*image.ysize*image.csize)) {
-    myImage.clear();
-    m_force = false;
-
-    myImage.xsize = image.xsize;
-    myImage.ysize = image.ysize;
-    myImage.setCsizeByFormat(image.format);
-    myImage.reallocate();
-
-    makePuzzleBlocks(image.xsize, image.ysize, image.csize);
-    shuffle();
-  }
-
-  myImage.xsize = image.xsize;
-  myImage.ysize = image.ysize;
-  myImage.setCsizeByFormat(image.format);
-
-  dest = myImage.data;
-
-  i=0;
-  for (y=0; y<blockh; y++) {
-    for(x=0; x<blockw; x++) {
-      p = &src[blockoffset[blockpos[i]]];
-      q = &dest[blockoffset[i]];
-      if(m_game && spacepos ==
-          i) { // leave one rectangle blank (for the puzzle game)
-        for(yy=0; yy<blockysize; yy++) {
-          for(xx=0; xx<blockxsize*image.csize; xx++) {
-            q[xx] = 0;
-          }
-          q += image.xsize*image.csize;
-        }
-      } else {
-        for(yy=0; yy<blockysize; yy++) {
-          for(xx=0; xx<blockxsize*image.csize; xx++) {
-            q[xx] = p[xx];
-          }
-          q += image.xsize*image.csize;
-          p += image.xsize*image.csize;
-        }
-      }
-      i++;
-    }
-  }
-
-  p = src +  blockw * blockxsize;
-  q = dest + blockw * blockxsize;
-
-  if(marginw) {
-    for(y=0; y<blockh*blockysize; y++) {
-      for(x=0; x<marginw; x++) {
-        *q++ = *p++;
-      }
-      p += image.xsize - marginw;
-      q += image.xsize - marginw;
-    }
-  }
-
-  if(marginh) {
-    p = src + (blockh * blockysize) * image.xsize;
-    q = dest + (blockh * blockysize) * image.xsize;
-    memcpy(p, q, marginh*image.xsize*image.csize);
-  }
-
-  image.data=myImage.data;
+  m_pool.setThreads(threads);
 }
 
 /////////////////////////////////////////////////////////
@@ -372,6 +263,7 @@ void pix_puzzle :: obj_setupCallback(t_class *classPtr)
   class_addmethod(classPtr,
                   reinterpret_cast<t_method>(&pix_puzzle::moveMessCallback),
                   gensym("move"), A_FLOAT, A_NULL);
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
 }
 
 void pix_puzzle :: bangMessCallback(void *data)
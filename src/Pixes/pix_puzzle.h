@@ -15,6 +15,8 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_PUZZLE_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageRemap.h"
+#include "Utils/ThreadPool.h"
 
 /*-----------------------------------------------------------------
   -------------------------------------------------------------------
@@ -48,13 +50,21 @@ protected:
   //////////
   // Do the processing
   virtual void  processImage(imageStruct &image);
-  virtual void processYUVImage(imageStruct &image);
 
   imageStruct    myImage;
 
+  //////////
+  // the source-pixel of each output pixel
+  // (rebuilt whenever the puzzle changes)
+  gem::image::Remap m_remap;
+  // the map is optionally applied on several threads
+  gem::thread::ThreadPool m_pool;
+  void threadMess(int threads);
+
   //////////
   // Make a puzzle
-  virtual void  makePuzzleBlocks(int xsize, int ysize, int csize);
+  virtual void  makePuzzleBlocks(int xsize, int ysize);
+  virtual void  makeMap(int*map, int xsize, int ysize);
   virtual void  shuffle();
   virtual void  sizeMess(int width, int height);
   virtual void  moveMess(int direction);
@@ -62,7 +72,6 @@ protected:
   int blockxsize,blockysize,  blocknum, spacepos;
   int blockw, blockh;
   int *blockpos;
-  int *blockoffset;
   int marginw, marginh;
 
   int m_force;
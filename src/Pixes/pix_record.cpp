@@ -6,6 +6,7 @@
 #include "pix_record.h"
 
 #include "Gem/State.h"
+#include "Gem/ImageGPU.h"
 #include "Gem/Exception.h"
 
 #include "plugins/PluginFactory.h"
@@ -263,6 +264,7 @@ void pix_record :: render(GemState *state)
   }
   pixBlock*img=NULL;
   state->get(GemState::_PIX, img);
+  img=gem::image::GPUFilter::hostImage(img, m_hostImage);
 
   if(!img || !img->image.data) {
     return;
@@ -130,6 +130,10 @@ private:
 
   class PIMPL;
   PIMPL*m_pimpl;
+
+  //////////
+  // texture-resident images are read back into here
+  pixBlock m_hostImage;
 };
 #endif  // for header file
 #endif //removes pix_record
@@ -28,8 +28,6 @@ CPPEXTERN_NEW(pix_refraction);
 /////////////////////////////////////////////////////////
 pix_refraction :: pix_refraction() :
   nHeight(0), nWidth(0),
-  init(0),
-  pSource(0), pOutput(0),
   m_Refraction(2.0f),
   m_CellWidth(16.0f),
   m_CellHeight(16.0f),
@@ -51,86 +49,7 @@ pix_refraction :: ~pix_refraction()
 /////////////////////////////////////////////////////////
 void pix_refraction :: processRGBAImage(imageStruct &image)
 {
-  nWidth = image.xsize;
-  nHeight = image.ysize;
-  if (!init) {
-    init = 1;
-  }
-  pSource = (U32*)image.data;
-
-  myImage.xsize = image.xsize;
-  myImage.ysize = image.ysize;
-  myImage.setCsizeByFormat(image.format);
-  myImage.reallocate();
-
-  pOutput = (U32*)myImage.data;
-
-  const int nHalfWidth=(nWidth/2);
-  const int nHalfHeight=(nHeight/2);
-
-  const int nNumPixels = nWidth*nHeight;
-
-  float GatedRefraction=m_Refraction;
-  if ((m_DoAllowMagnification==0.0f)&&(m_Refraction<1.0f)) {
-    GatedRefraction=1.0f;
-  }
-
-  const int nRefraction=static_cast<int>(GatedRefraction*256.0f);
-
-  int nCellWidth=static_cast<int>(m_CellWidth);
-  if (nCellWidth<=0) {
-    nCellWidth=1;
-  }
-  int nCellHeight=static_cast<int>(m_CellHeight);
-  if (nCellHeight<=0) {
-    nCellHeight=1;
-  }
-
-  const int nHalfCellWidth=(nCellWidth/2);
-  const int nHalfCellHeight=(nCellHeight/2);
-
-  //const int nYStartOffset=(nHalfCellHeight*(256))/nRefraction;
-  //const int nXStartOffset=(nHalfCellWidth*(256))/nRefraction;
-
-  U32* pCurrentOutput=pOutput;
-  const U32* pOutputEnd=(pOutput+nNumPixels);
-
-  int nY=-nHalfHeight+nHalfCellHeight;
-  while (pCurrentOutput!=pOutputEnd) {
-
-    //const U32* pOutputLineStart=pCurrentOutput;
-    const U32* pOutputLineEnd=pCurrentOutput+nWidth;
-
-    const int nYCentre=(((nY+(GetSign(nY)*nHalfCellHeight))/nCellHeight)
-                        *nCellHeight)+nHalfCellHeight;
-    const int nYDist=(nY-nYCentre);
-    int nSourceY=((nYDist*nRefraction)>>8)+nYCentre+nHalfHeight;
-    nSourceY=clampFunc(nSourceY,0,(nHeight-1));
-
-    const U32* pSourceLineStart=(pSource+(nSourceY*nWidth));
-
-    int nX=-nHalfWidth+nHalfCellWidth;
-    while (pCurrentOutput!=pOutputLineEnd) {
-
-      const int nXCentre=(((nX+(GetSign(nX)*nHalfCellWidth))/nCellWidth)
-                          *nCellWidth)+nHalfCellWidth;
-      const int nXDist=(nX-nXCentre);
-      int nSourceX=((nXDist*nRefraction)>>8)+nXCentre+nHalfWidth;
-      nSourceX=clampFunc(nSourceX,0,(nWidth-1));
-
-      const U32* pCurrentSource=pSourceLineStart+nSourceX;
-
-      *pCurrentOutput=*pCurrentSource;
-
-      pCurrentOutput+=1;
-      nX+=1;
-
-    }
-
-    nY+=1;
-
-  }
-  image.data = myImage.data;
+  remap(image, image.xsize);
 }
 
 /////////////////////////////////////////////////////////
@@ -139,19 +58,41 @@ void pix_refraction :: processRGBAImage(imageStruct &image)
 /////////////////////////////////////////////////////////
 void pix_refraction :: processYUVImage(imageStruct &image)
 {
-  nWidth = image.xsize/2;
-  nHeight = image.ysize;
-  if (!init) {
-    init = 1;
-  }
-  pSource = (U32*)image.data;
+  /* the map works on macropixels */
+  remap(image, image.xsize/2);
+}
+
+/////////////////////////////////////////////////////////
+// processGrayImage
+//
+/////////////////////////////////////////////////////////
+void pix_refraction :: processGrayImage(imageStruct &image)
+{
+  remap(image, image.xsize);
+}
 
-  myImage.xsize = image.xsize;
-  myImage.ysize = image.ysize;
-  myImage.setCsizeByFormat(image.format);
-  myImage.reallocate();
-  pOutput = (U32*)myImage.data;
+/////////////////////////////////////////////////////////
+// remap
+//   the map is only rebuilt if the parameters or the size change
+/////////////////////////////////////////////////////////
+void pix_refraction :: remap(imageStruct &image, int width)
+{
+  if (m_remap.update(width, image.ysize)) {
+    nWidth = width;
+    nHeight = image.ysize;
+    makeMap(m_remap.map());
+  }
+  if (m_remap.apply(image, myImage, &m_pool)) {
+    image.data = myImage.data;
+  }
+}
 
+/////////////////////////////////////////////////////////
+// makeMap
+//   the source-coordinates of each output element
+/////////////////////////////////////////////////////////
+void pix_refraction :: makeMap(int*pOutput)
+{
   const int nHalfWidth=(nWidth/2);
   const int nHalfHeight=(nHeight/2);
 
@@ -176,17 +117,13 @@ void pix_refraction :: processYUVImage(imageStruct &image)
   const int nHalfCellWidth=(nCellWidth/2);
   const int nHalfCellHeight=(nCellHeight/2);
 
-  //const int nYStartOffset=(nHalfCellHeight*(256))/nRefraction;
-  //const int nXStartOffset=(nHalfCellWidth*(256))/nRefraction;
-
-  U32* pCurrentOutput=pOutput;
-  const U32* pOutputEnd=(pOutput+nNumPixels);
+  int* pCurrentOutput=pOutput;
+  const int* pOutputEnd=(pOutput+nNumPixels);
 
   int nY=-nHalfHeight+nHalfCellHeight;
   while (pCurrentOutput!=pOutputEnd) {
 
-    //const U32* pOutputLineStart=pCurrentOutput;
-    const U32* pOutputLineEnd=pCurrentOutput+nWidth;
+    const int* pOutputLineEnd=pCurrentOutput+nWidth;
 
     const int nYCentre=(((nY+(GetSign(nY)*nHalfCellHeight))/nCellHeight)
                         *nCellHeight)+nHalfCellHeight;
@@ -194,7 +131,7 @@ void pix_refraction :: processYUVImage(imageStruct &image)
     int nSourceY=((nYDist*nRefraction)>>8)+nYCentre+nHalfHeight;
     nSourceY=clampFunc(nSourceY,0,(nHeight-1));
 
-    const U32* pSourceLineStart=(pSource+(nSourceY*nWidth));
+    const int nSourceLineStart=(nSourceY*nWidth);
 
     int nX=-nHalfWidth+nHalfCellWidth;
     while (pCurrentOutput!=pOutputLineEnd) {
@@ -205,9 +142,7 @@ void pix_refraction :: processYUVImage(imageStruct &image)
       int nSourceX=((nXDist*nRefraction)>>8)+nXCentre+nHalfWidth;
       nSourceX=clampFunc(nSourceX,0,(nWidth-1));
 
-      const U32* pCurrentSource=pSourceLineStart+nSourceX;
-
-      *pCurrentOutput=*pCurrentSource;
+      *pCurrentOutput=nSourceLineStart+nSourceX;
 
       pCurrentOutput+=1;
       nX+=1;
@@ -217,7 +152,15 @@ void pix_refraction :: processYUVImage(imageStruct &image)
     nY+=1;
 
   }
-  image.data = myImage.data;
+}
+
+/////////////////////////////////////////////////////////
+// threadMess
+//
+/////////////////////////////////////////////////////////
+void pix_refraction :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
 }
 
 /////////////////////////////////////////////////////////
@@ -238,21 +181,25 @@ void pix_refraction :: obj_setupCallback(t_class *classPtr)
   class_addmethod(classPtr,
                   reinterpret_cast<t_method>(&pix_refraction::magCallback),
                   gensym("mag"), A_DEFFLOAT, A_NULL);
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
 }
 void pix_refraction :: refractCallback(void *data, t_float m_Refraction)
 {
   GetMyClass(data)->m_Refraction=(m_Refraction);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 
 void pix_refraction :: widthCallback(void *data, t_float m_CellWidth)
 {
   GetMyClass(data)->m_CellWidth=(m_CellWidth);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 void pix_refraction :: heightCallback(void *data, t_float m_CellHeight)
 {
   GetMyClass(data)->m_CellHeight=(m_CellHeight);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
 
@@ -260,5 +207,6 @@ void pix_refraction :: magCallback(void *data,
                                    t_float m_DoAllowMagnification)
 {
   GetMyClass(data)->m_DoAllowMagnification=(m_DoAllowMagnification);
+  GetMyClass(data)->m_remap.invalidate();
   GetMyClass(data)->setPixModified();
 }
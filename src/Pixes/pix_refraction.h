@@ -14,6 +14,8 @@ LOG
 #define _INCLUDE__GEM_PIXES_PIX_REFRACTION_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageRemap.h"
+#include "Utils/ThreadPool.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -50,14 +52,24 @@ protected:
   // Do the processing
   virtual void    processRGBAImage(imageStruct &image);
   virtual void    processYUVImage(imageStruct &image);
+  virtual void    processGrayImage(imageStruct &image);
+
+  //////////
+  // apply the (cached) map to an image 'width' elements wide
+  void            remap(imageStruct &image, int width);
+  void            makeMap(int*pOutput);
 
   imageStruct     myImage;
   int             nHeight;
   int             nWidth;
-  int             init;
 
-  U32*            pSource;
-  U32*            pOutput;
+  //////////
+  // the source-coordinates of each output element
+  // (rebuilt whenever a parameter changes)
+  gem::image::Remap m_remap;
+  // the map is optionally applied on several threads
+  gem::thread::ThreadPool m_pool;
+  void threadMess(int threads);
 
   float           m_Refraction;
   float           m_CellWidth;
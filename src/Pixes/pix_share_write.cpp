@@ -10,6 +10,7 @@
 #include "pix_share_write.h"
 #include "Gem/Image.h"
 #include "Gem/State.h"
+#include "Gem/ImageGPU.h"
 #include "Gem/Exception.h"
 
 #include <errno.h>
@@ -379,6 +380,7 @@ void pix_share_write :: render(GemState *state)
   }
   pixBlock*img=NULL;
   state->get(GemState::_PIX, img);
+  img=gem::image::GPUFilter::hostImage(img, m_hostImage);
   if(!img) {
     return;
   }
@@ -11,6 +11,7 @@
 #define _INCLUDE__GEM_PIXES_PIX_SHARE_WRITE_H_
 
 #include "pix_share.h"
+#include "Gem/Image.h"
 
 class GEM_EXTERN pix_share_write : public GemBase
 {
@@ -39,6 +40,10 @@ protected:
   static void   setMessCallback(void *data, t_symbol* s, int argc,
                                 t_atom *argv);
 
+
+  //////////
+  // texture-resident images are read back into here
+  pixBlock m_hostImage;
 };
 
 #endif
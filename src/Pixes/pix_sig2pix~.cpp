@@ -21,6 +21,11 @@
 CPPEXTERN_NEW_NAMED_WITH_TWO_ARGS(pix_sig2pix, "pix_sig2pix~", t_float,A_DEFFLOAT,t_float,
     A_DEFFLOAT);
 
+namespace
+{
+const size_t MAX_LATENCY = 128;
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_sig2pix
@@ -35,6 +40,8 @@ pix_sig2pix :: pix_sig2pix(t_floatarg width, t_floatarg height)
   , m_reqType(0)
   , m_upsidedown(true)
   , m_fillType(CLEAR)
+  , m_blocksize(0)
+  , m_latency(32)
 {
   dimenMess((int)width, (int)height);   //tigital
   for (int i=0; i<3; i++) {
@@ -103,6 +110,20 @@ void pix_sig2pix :: csMess(std::string s)
 /////////////////////////////////////////////////////////
 void pix_sig2pix :: render(GemState *state)
 {
+  /* apply all the blocks since the last frame */
+  const size_t n = m_blocksize;
+  if(n) {
+    t_sample*signals[4];
+    for(int i=0; i<4; i++) {
+      signals[i] = &m_block[i*n];
+    }
+    if(m_samples.readable() < 4*n) {
+      m_samples.underrun();
+    }
+    while(m_samples.read(&m_block[0], 4*n)) {
+      processBlock(signals, n);
+    }
+  }
   state->set(GemState::_PIX,&m_pixBlock);
 }
 
@@ -187,6 +208,20 @@ namespace {
 };
 
 void pix_sig2pix :: perform(t_sample**signals, size_t n)
+{
+  const size_t blocksize = 4*n;
+  const size_t queued = m_samples.capacity() - m_samples.writable();
+  if(n != m_blocksize || queued + blocksize > m_latency * blocksize) {
+    m_samples.overrun();
+    return;
+  }
+  for(int i=0; i<4; i++) {
+    m_samples.write(signals[i], n);
+  }
+  m_samples.publish();
+}
+
+void pix_sig2pix :: processBlock(t_sample**signals, size_t n)
 {
   unsigned char* data = m_pixBlock.image.data;
   const size_t width = m_pixBlock.image.xsize;
@@ -307,6 +342,13 @@ void pix_sig2pix :: dspMess(t_signal** sp)
     m_width = 0;
     m_height= 0;
   }
+  /* the DSP-chain is not running, so we can safely reallocate the ring */
+  const size_t n = sp[0]->s_n;
+  if (n != m_blocksize) {
+    m_blocksize = n;
+    m_samples.resize(MAX_LATENCY * 4 * n);
+    m_block.resize(4 * n);
+  }
   dsp_add(cb.callback, 6, this->x_obj, sp[0]->s_vec, sp[1]->s_vec, sp[2]->s_vec,
           sp[3]->s_vec, sp[0]->s_n);
 }
@@ -344,6 +386,17 @@ void pix_sig2pix :: filltypeMess(std::string type) {
 void pix_sig2pix :: upsidedownMess(bool up) {
   m_upsidedown = up;
 }
+void pix_sig2pix :: latencyMess(int blocks) {
+  if(blocks < 1 || static_cast<size_t>(blocks) > MAX_LATENCY) {
+    error("latency must be between 1 and %d blocks", (int)MAX_LATENCY);
+    return;
+  }
+  m_latency = blocks;
+}
+void pix_sig2pix :: statsMess(void) {
+  post("stats: %lu underrun(s), %lu overrun(s)",
+       m_samples.underruns(), m_samples.overruns());
+}
 
 /////////////////////////////////////////////////////////
 // Callback functions
@@ -366,4 +419,6 @@ void pix_sig2pix :: obj_setupCallback(t_class *classPtr)
   CPPEXTERN_MSG1(classPtr, "type", typeMess, std::string);
   CPPEXTERN_MSG1(classPtr, "mode", filltypeMess, std::string);
   CPPEXTERN_MSG1(classPtr, "upsidedown", upsidedownMess, bool);
+  CPPEXTERN_MSG1(classPtr, "latency", latencyMess, int);
+  CPPEXTERN_MSG0(classPtr, "stats", statsMess);
 }
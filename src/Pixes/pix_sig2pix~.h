@@ -16,6 +16,9 @@
 
 #include "Base/GemBase.h"
 #include "Gem/Image.h"
+#include "Utils/ThreadRing.h"
+
+#include <vector>
 
 /*-----------------------------------------------------------------
   -------------------------------------------------------------------
@@ -30,6 +33,10 @@
   DESCRIPTION
 
   "dimen" -- change pix_buf dimension
+  "latency" -- number of DSP blocks (1..128) that can be queued between
+               two frames (default: 32)
+  "stats" -- print the number of underruns (frames without new blocks)
+             and overruns (blocks dropped because the render lagged behind)
   4 inlets eat signals : R~, G~, B~, A~
   creation: width, height in pixels
 
@@ -51,10 +58,13 @@ protected:
   virtual      ~pix_sig2pix();
 
   //////////
-
-  // DSP perform
+  // DSP perform: pass the block on to the render
   void perform(t_sample**signals, size_t count);
 
+  //////////
+  // write a block of signals into the image
+  void processBlock(t_sample**signals, size_t count);
+
   //////////
   // Do the rendering
   virtual void  render(GemState *state);
@@ -99,6 +109,16 @@ protected:
 
   virtual void upsidedownMess(bool);
   bool m_upsidedown;
+
+  //////////
+  // the blocks on their way from the DSP to the render
+  // (each is 4 channels of m_blocksize samples)
+  gem::thread::ThreadRing<t_sample> m_samples;
+  std::vector<t_sample> m_block;
+  size_t m_blocksize;
+  size_t m_latency;
+  void latencyMess(int blocks);
+  void statsMess(void);
 };
 
 #endif  // for header file
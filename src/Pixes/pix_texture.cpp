@@ -19,6 +19,8 @@
 
 #include "Gem/Settings.h"
 #include "Gem/Image.h"
+#include "Gem/ImageCompress.h"
+#include "Gem/ImageGPU.h"
 #include "Utils/Functions.h"
 #include <string.h>
 
@@ -37,6 +39,20 @@
 
 CPPEXTERN_NEW(pix_texture);
 
+namespace
+{
+/* scaled YCoCg (R=Co, G=Cg, B=scale, A=Y) to RGB */
+const char*s_ycocgShader =
+  "uniform sampler2D tex0;\n"
+  "void main(void) {\n"
+  "  vec4 c = texture2D(tex0, gl_TexCoord[0].st);\n"
+  "  float scale = c.z * (255.0/8.0) + 1.0;\n"
+  "  float co = (c.x - 128.0/255.0) / scale;\n"
+  "  float cg = (c.y - 128.0/255.0) / scale;\n"
+  "  gl_FragColor = vec4(c.w + co - cg, c.w + cg, c.w - co - cg, 1.0);\n"
+  "}\n";
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_texture
@@ -65,7 +81,8 @@ pix_texture :: pix_texture()
     m_texunit(0),
     m_numTexUnits(0),
     m_numPbo(0), m_oldNumPbo(0), m_curPbo(0), m_pbo(NULL),
-    m_upsidedown(false)
+    m_upsidedown(false),
+    m_ycocg(s_ycocgShader), m_ycocgTexture(0)
 {
   m_dataSize[0] = m_dataSize[1] = m_dataSize[2] = -1;
   m_buffer.xsize = m_buffer.ysize = m_buffer.csize = -1;
@@ -200,6 +217,27 @@ static inline void tex2state(GemState*state, TexCoord*coords, int size)
   state->set(GemState::_GL_TEX_NUMCOORDS, size);
 }
 
+/* whether the GPU can take the block compressed format as it is */
+static bool canUploadCompressed(unsigned int format)
+{
+  switch(format) {
+  case GEM_BC1:
+  case GEM_BC3:
+    return (GLEW_EXT_texture_compression_s3tc!=0);
+  case GEM_BC3_YCOCG:
+    return (GLEW_EXT_texture_compression_s3tc
+            && gem::image::GPUFilter::isRunnable());
+  case GEM_BC7:
+    return (GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc);
+  case GEM_ETC2:
+  case GEM_ETC2A:
+    return (GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility);
+  default:
+    break;
+  }
+  return false;
+}
+
 
 ////////////////////////////////////////////////////////
 // extension check
@@ -294,6 +332,7 @@ void pix_texture :: render(GemState *state)
   int newfilm = 0;
   pixBlock*img=NULL;
   GLint internalformat = GL_RGBA;
+  bool compressed=false;
 
   if(m_pbo && (m_numPbo != m_oldNumPbo)) {
     /* the PBO settings have changed, invalidate the old PBO */
@@ -308,11 +347,27 @@ void pix_texture :: render(GemState *state)
     newfilm = img->newfilm;
   }
 
-  if (!img || !img->image.data) {
+  if (img && img->texture) {
+    /* a texture-resident image: no need to upload anything */
+    useExternalTexture= true;
+    m_rebuildList     = false;
+    m_textureObj      = img->texture;
+    m_textureType     = img->textureTarget;
+    texType=m_textureType;
+    upsidedown=img->image.upsidedown;
+    if(GL_TEXTURE_2D == m_textureType) {
+      m_xRatio=1.;
+      m_yRatio=1.;
+    } else {
+      m_xRatio=img->image.xsize;
+      m_yRatio=img->image.ysize;
+    }
+    m_upsidedown=upsidedown;
+  } else if (!img || !img->image.data) {
     if(m_extTextureObj>0) {
       useExternalTexture= true;
       m_rebuildList     = false;
-      m_textureObj      = m_extTextureObj;
+      m_textureObj      = static_cast<GLuint>(m_extTextureObj);
       if(m_extType) {
         m_textureType=m_extType;
       }
@@ -330,6 +385,7 @@ void pix_texture :: render(GemState *state)
   tex2state(state, m_coords, 4);
 
   if(!useExternalTexture) {
+    m_textureObj = static_cast<GLuint>(m_realTextureObj);
     upsidedown = img->image.upsidedown;
     if (img->newimage) {
       m_rebuildList = true;
@@ -345,6 +401,15 @@ void pix_texture :: render(GemState *state)
       internalformat = GL_RGBA;
     }
 
+    /* block compressed images go to the GPU as they are
+     * (but there are no rectangle textures for them) */
+    if(imageStruct::blockSize(m_imagebuf.format)
+        && canUploadCompressed(m_imagebuf.format)) {
+      compressed = true;
+      do_rectangle = 0;
+      canMipmap = false;
+    }
+
     x_2 = powerOfTwo(m_imagebuf.xsize);
     y_2 = powerOfTwo(m_imagebuf.ysize);
 
@@ -436,7 +501,71 @@ void pix_texture :: render(GemState *state)
         m_imagebuf.fromYUV422(img->image.data);
       }
     }
-    if (normalized) {
+    // if the GPU doesn't know the compression, we have to decode it
+    if (!compressed && imageStruct::blockSize(m_imagebuf.format)) {
+      if(!img || !gem::image::compress::decode(img->image, m_imagebuf)) {
+        error("cannot texture compressed images of format 0x%X",
+              m_imagebuf.format);
+        m_imagebuf.setCsizeByFormat(GEM_RGBA);
+        m_imagebuf.reallocate();
+        m_imagebuf.setBlack();
+      }
+    }
+    if (compressed) {
+      // compressed textures cannot be resized on the fly,
+      // so they are only padded if the GPU needs power-of-two textures
+      const bool npot = (GLEW_VERSION_2_0 || GLEW_ARB_texture_non_power_of_two);
+      const GLenum format = (GEM_BC3_YCOCG == m_imagebuf.format)
+                            ?GEM_BC3:m_imagebuf.format;
+      const GLsizei size = m_imagebuf.getDataSize();
+      m_buffer.xsize = npot?m_imagebuf.xsize:x_2;
+      m_buffer.ysize = npot?m_imagebuf.ysize:y_2;
+      /* a sub-image must consist of whole 4x4 blocks
+       * (unless it reaches the border of the texture) */
+      GLsizei subwidth  = (m_imagebuf.xsize+3) & ~3;
+      GLsizei subheight = (m_imagebuf.ysize+3) & ~3;
+      if (subwidth  > m_buffer.xsize) {
+        subwidth  = m_buffer.xsize;
+      }
+      if (subheight > m_buffer.ysize) {
+        subheight = m_buffer.ysize;
+      }
+      m_xRatio = (float)m_imagebuf.xsize / (float)m_buffer.xsize;
+      m_yRatio = (float)m_imagebuf.ysize / (float)m_buffer.ysize;
+      m_upsidedown=upsidedown;
+      tex2state(state, m_coords, 4);
+
+      if (newfilm ||
+          m_buffer.format != format ||
+          0 != m_dataSize[0] ||
+          m_buffer.xsize != m_dataSize[1] ||
+          m_buffer.ysize != m_dataSize[2]) {
+        m_buffer.setCsizeByFormat(format);
+        m_dataSize[0] = m_buffer.csize;
+        m_dataSize[1] = m_buffer.xsize;
+        m_dataSize[2] = m_buffer.ysize;
+        if (npot) {
+          glCompressedTexImage2D(m_textureType, 0, format,
+                                 m_buffer.xsize, m_buffer.ysize, 0,
+                                 size, m_imagebuf.data);
+        } else {
+          m_buffer.reallocate();
+          m_buffer.setBlack();
+          glCompressedTexImage2D(m_textureType, 0, format,
+                                 m_buffer.xsize, m_buffer.ysize, 0,
+                                 m_buffer.getDataSize(), m_buffer.data);
+          glCompressedTexSubImage2D(m_textureType, 0, 0, 0,
+                                    subwidth, subheight,
+                                    format, size, m_imagebuf.data);
+        }
+        img->newfilm = 0;
+      } else {
+        glCompressedTexSubImage2D(m_textureType, 0, 0, 0,
+                                  subwidth, subheight,
+                                  format, size, m_imagebuf.data);
+      }
+      m_hasMipmap = false;
+    } else if (normalized) {
       m_buffer.xsize = m_imagebuf.xsize;
       m_buffer.ysize = m_imagebuf.ysize;
       m_buffer.csize  = m_imagebuf.csize;
@@ -609,6 +738,25 @@ void pix_texture :: render(GemState *state)
     }
   } // rebuildlist
 
+  if (compressed && GEM_BC3_YCOCG == m_imagebuf.format) {
+    /* turn the YCoCg texture into RGBA, and use that instead */
+    if (m_rebuildList) {
+      pixBlock ycocg;
+      ycocg.image.xsize = m_buffer.xsize;
+      ycocg.image.ysize = m_buffer.ysize;
+      ycocg.image.upsidedown = m_upsidedown;
+      ycocg.texture = m_textureObj;
+      ycocg.textureTarget = m_textureType;
+      if (m_ycocg.process(ycocg)) {
+        m_ycocgTexture = ycocg.texture;
+      }
+    }
+    if (m_ycocgTexture) {
+      m_textureObj = static_cast<GLuint>(m_ycocgTexture);
+      glBindTexture(m_textureType, m_textureObj);
+    }
+  }
+
   if (m_wantMipmap && canMipmap && !m_hasMipmap) {
     glGenerateMipmap(m_textureType);
     m_hasMipmap = true;
@@ -684,7 +832,7 @@ void pix_texture :: startRendering()
     glActiveTexture(GL_TEXTURE0_ARB + m_texunit);
   }
   glBindTexture(m_textureType, m_realTextureObj);
-  m_textureObj=m_realTextureObj;
+  m_textureObj=static_cast<GLuint>(m_realTextureObj);
   setUpTextureState();
 
   m_dataSize[0] = m_dataSize[1] = m_dataSize[2] = -1;
@@ -708,6 +856,8 @@ void pix_texture :: stopRendering()
     m_realTextureObj = 0;
     m_dataSize[0] = m_dataSize[1] = m_dataSize[2] = -1;
   }
+  m_ycocg.release();
+  m_ycocgTexture = 0;
 
   if(m_pbo) {
     GLuint*pbo=m_pbo;
@@ -18,6 +18,7 @@
 
 #include "Base/GemBase.h"
 #include "Gem/Image.h"
+#include "Gem/ImageGPU.h"
 #include "Gem/State.h"
 
 /*-----------------------------------------------------------------
@@ -219,6 +220,11 @@ protected:
 
   /* upside down texture? */
   gem::ContextData<GLboolean> m_upsidedown;
+
+  /* YCoCg images (HAP Q) are uploaded as BC3 and
+   * converted into the filter's RGBA texture */
+  gem::image::GPUFilter m_ycocg;
+  gem::ContextData<GLuint> m_ycocgTexture;
 };
 
 #endif  // for header file
@@ -19,6 +19,17 @@
 
 CPPEXTERN_NEW_WITH_GIMME(pix_threshold);
 
+namespace
+{
+const char*s_fragmentShader =
+  "uniform sampler2D tex0;\n"
+  "uniform vec4 thresh;\n"
+  "void main(void) {\n"
+  "  vec4 c = texture2D(tex0, gl_TexCoord[0].st);\n"
+  "  gl_FragColor = c * step(thresh, c);\n"
+  "}\n";
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_threshold
@@ -28,7 +39,8 @@ CPPEXTERN_NEW_WITH_GIMME(pix_threshold);
 //
 /////////////////////////////////////////////////////////
 pix_threshold :: pix_threshold(int argc, t_atom*argv) :
-  m_Y(0)
+  m_Y(0),
+  m_gpu(s_fragmentShader)
 {
   inlet_new(this->x_obj, &this->x_obj->ob_pd, gensym("float"),
             gensym("ft1"));
@@ -210,6 +222,26 @@ void pix_threshold :: floatThreshMess(float thresh)
   setPixModified();
 }
 
+/////////////////////////////////////////////////////////
+// processTexture
+//
+/////////////////////////////////////////////////////////
+bool pix_threshold :: processTexture(pixBlock &image)
+{
+  // values below the threshold are zeroed
+  // (the threshold is lowered by half a step to avoid rounding issues)
+  m_gpu.setUniform("thresh",
+                   (m_thresh[chRed]  -0.5f)/255.f,
+                   (m_thresh[chGreen]-0.5f)/255.f,
+                   (m_thresh[chBlue] -0.5f)/255.f,
+                   (m_thresh[chAlpha]-0.5f)/255.f);
+  return m_gpu.process(image);
+}
+void pix_threshold :: stopRendering(void)
+{
+  m_gpu.release();
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
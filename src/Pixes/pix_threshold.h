@@ -17,6 +17,7 @@ WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
 #define _INCLUDE__GEM_PIXES_PIX_THRESHOLD_H_
 
 #include "Base/GemPixObj.h"
+#include "Gem/ImageGPU.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -82,6 +83,12 @@ protected:
   // The new color
   unsigned char   m_thresh[4];
   unsigned char   m_Y;
+
+  //////////
+  // Do the processing on the GPU
+  virtual bool    processTexture(pixBlock &image);
+  virtual void    stopRendering(void);
+  gem::image::GPUFilter m_gpu;
 };
 
 #endif  // for header file
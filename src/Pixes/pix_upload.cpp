@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "pix_upload.h"
+#include "Gem/State.h"
+
+CPPEXTERN_NEW(pix_upload);
+
+/////////////////////////////////////////////////////////
+//
+// pix_upload
+//
+/////////////////////////////////////////////////////////
+// Constructor
+//
+/////////////////////////////////////////////////////////
+pix_upload :: pix_upload(void)
+  : m_onOff(true)
+  , m_orgPixBlock(NULL)
+{
+}
+
+/////////////////////////////////////////////////////////
+// Destructor
+//
+/////////////////////////////////////////////////////////
+pix_upload :: ~pix_upload(void)
+{
+}
+
+////////////////////////////////////////////////////////
+// extension check
+//
+/////////////////////////////////////////////////////////
+bool pix_upload :: isRunnable(void)
+{
+  if(gem::image::GPUFilter::isRunnable()) {
+    return true;
+  }
+  error("need OpenGL-2.0 and framebuffer objects to process images on the GPU");
+  return false;
+}
+
+/////////////////////////////////////////////////////////
+// render
+//
+/////////////////////////////////////////////////////////
+void pix_upload :: render(GemState *state)
+{
+  pixBlock*img=NULL;
+  m_orgPixBlock=NULL;
+  if(!m_onOff || !state || !state->get(GemState::_PIX, img) || !img) {
+    return;
+  }
+  // already texture-resident (or no image at all)
+  if(img->texture || !img->image.data) {
+    return;
+  }
+
+  m_orgPixBlock=img;
+  const bool firsttime = !m_pixBlock.texture;
+  m_pixBlock.newimage = img->newimage || firsttime;
+  m_pixBlock.newfilm  = img->newfilm;
+  if(m_pixBlock.newimage) {
+    img->image.copy2ImageStruct(&m_pixBlock.image);
+    if(!m_gpu.upload(m_pixBlock)) {
+      /* e.g. float images: pass them on as they are */
+      m_pixBlock.texture=0;
+      m_orgPixBlock=NULL;
+      return;
+    }
+  }
+  state->set(GemState::_PIX, &m_pixBlock);
+}
+
+/////////////////////////////////////////////////////////
+// postrender
+//
+/////////////////////////////////////////////////////////
+void pix_upload :: postrender(GemState *state)
+{
+  if(m_orgPixBlock) {
+    state->set(GemState::_PIX, m_orgPixBlock);
+  }
+  m_orgPixBlock=NULL;
+}
+
+/////////////////////////////////////////////////////////
+// stopRendering
+//
+/////////////////////////////////////////////////////////
+void pix_upload :: stopRendering(void)
+{
+  m_gpu.release();
+  m_pixBlock.texture=0;
+  m_pixBlock.textureTarget=0;
+}
+
+/////////////////////////////////////////////////////////
+// onOffMess
+//
+/////////////////////////////////////////////////////////
+void pix_upload :: onOffMess(int on)
+{
+  m_onOff=(on!=0);
+  setModified();
+}
+
+/////////////////////////////////////////////////////////
+// static member function
+//
+/////////////////////////////////////////////////////////
+void pix_upload :: obj_setupCallback(t_class *classPtr)
+{
+  CPPEXTERN_MSG1(classPtr, "float", onOffMess, int);
+}
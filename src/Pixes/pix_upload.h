@@ -0,0 +1,84 @@
+/*-----------------------------------------------------------------
+  LOG
+  GEM - Graphics Environment for Multimedia
+
+  Upload a pix into a texture, so it can be processed on the GPU
+
+  Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+  For information on usage and redistribution, and for a DISCLAIMER OF ALL
+  WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+  -----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_PIXES_PIX_UPLOAD_H_
+#define _INCLUDE__GEM_PIXES_PIX_UPLOAD_H_
+
+#include "Base/GemBase.h"
+#include "Gem/Image.h"
+#include "Gem/ImageGPU.h"
+
+/*-----------------------------------------------------------------
+  -------------------------------------------------------------------
+  CLASS
+  pix_upload
+
+  Makes a pix texture-resident
+
+  KEYWORDS
+  pix
+
+  DESCRIPTION
+
+  the image is uploaded into a texture;
+  downstream pix objects that have a GPU implementation
+  (e.g. [pix_gain], [pix_invert], [pix_mix]) process it with GLSL,
+  [pix_texture] uses the texture directly;
+  all other pix objects read the image back into host memory
+
+  "float" - turn uploading on/off
+
+  -----------------------------------------------------------------*/
+class GEM_EXTERN pix_upload : public GemBase
+{
+  CPPEXTERN_HEADER(pix_upload, GemBase);
+
+public:
+
+  //////////
+  // Constructor
+  pix_upload(void);
+
+protected:
+
+  //////////
+  // Destructor
+  virtual ~pix_upload(void);
+
+  ////////
+  // extension check
+  virtual bool isRunnable(void);
+
+  //////////
+  // Do the rendering
+  virtual void  render(GemState *state);
+  virtual void  postrender(GemState *state);
+
+  //////////
+  // Delete the texture
+  virtual void  stopRendering(void);
+
+  //////////
+  // Turn on/off uploading
+  void          onOffMess(int on);
+
+  bool          m_onOff;
+
+  //////////
+  // the texture-resident pixBlock
+  pixBlock      m_pixBlock;
+  pixBlock     *m_orgPixBlock;
+
+  gem::image::GPUFilter m_gpu;
+};
+
+#endif  // for header file
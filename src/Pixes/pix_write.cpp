@@ -23,8 +23,12 @@
 #include "Gem/ImageIO.h"
 
 #include "Gem/Files.h"
+#include "Gem/Properties.h"
+
 #include <stdio.h>
 #include <string.h>
+#include <map>
+#include <vector>
 
 #ifdef _MSC_VER  /* This is only for Microsoft's compiler, not cygwin, e.g. */
 # define snprintf _snprintf
@@ -34,6 +38,276 @@
 
 CPPEXTERN_NEW_WITH_GIMME(pix_write);
 
+/*
+ * the asynchronous pipeline:
+ * frames are read back into a ring of pixel buffer objects,
+ * fenced so that they are only mapped once the GPU is done with them;
+ * the pixels are then copied out and handed over to gem::image::save
+ *
+ * the number of frames in flight (being read back or encoded) is bounded;
+ * frames that exceed the bound are dropped (and reported as such)
+ */
+class pix_write::PIMPL
+{
+public:
+  struct Readback {
+    GLuint pbo;
+    GLsizeiptr size;
+    GLsync fence;
+    unsigned int frame;
+    int xsize, ysize, format;
+    std::string filename;
+    gem::Properties props;
+    double start;
+    Readback(void)
+      : pbo(0), size(0), fence(0), frame(0)
+      , xsize(0), ysize(0), format(0)
+      , start(0.)
+    { }
+  };
+
+  pix_write*owner;
+  std::vector<Readback>readbacks;
+  unsigned int first, busy; /* the busy readbacks, in issue order */
+  unsigned int frame;
+  /* the images that are being encoded */
+  struct Request {
+    double start;
+    std::string filename;
+  };
+  std::map<gem::image::save::id_t, Request>requests;
+  double immediateStart;
+  unsigned int queueSize;
+  /* the object is going away: write the remaining images without notification */
+  bool closing;
+
+  PIMPL(pix_write*x)
+    : owner(x)
+    , readbacks(3)
+    , first(0), busy(0)
+    , frame(0)
+    , immediateStart(0.)
+    , queueSize(16)
+    , closing(false)
+  {
+  }
+  ~PIMPL(void)
+  {
+    /* nobody will be around to be notified */
+    std::map<gem::image::save::id_t, Request>::iterator it;
+    for(it=requests.begin(); it!=requests.end(); ++it) {
+      gem::image::save::cancel(it->first);
+      owner->error("'%s' might not be written", it->second.filename.c_str());
+    }
+  }
+
+  static bool havePBO(void)
+  {
+    return GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object;
+  }
+  static bool haveSync(void)
+  {
+    return GLEW_VERSION_3_2 || GLEW_ARB_sync;
+  }
+
+  unsigned int inFlight(void) const
+  {
+    return busy + requests.size();
+  }
+
+  static void writtenCallback(void*userdata, gem::image::save::id_t ID,
+                              const std::string&filename, bool success)
+  {
+    PIMPL*me=reinterpret_cast<PIMPL*>(userdata);
+    double start=me->immediateStart;
+    if(gem::image::save::IMMEDIATE != ID) {
+      std::map<gem::image::save::id_t, Request>::iterator it=me->requests.find(
+            ID);
+      if(it==me->requests.end()) {
+        return;
+      }
+      start=it->second.start;
+      me->requests.erase(it);
+    }
+    me->owner->written(filename, success, 1000.*(sys_getrealtime()-start));
+  }
+
+  void failed(const std::string&filename, double start)
+  {
+    if(closing) {
+      owner->error("unable to save image to '%s'", filename.c_str());
+    } else {
+      owner->written(filename, false, 1000.*(sys_getrealtime()-start));
+    }
+  }
+
+  /* hand an image over to the encoders */
+  void encode(imageStruct*img, const std::string&filename,
+              const gem::Properties&props, double start)
+  {
+    gem::image::save::id_t ID=gem::image::save::INVALID;
+    immediateStart=start;
+    if(!gem::image::save::async(closing?0:writtenCallback, this, img, filename,
+                                std::string(), props, ID)) {
+      failed(filename, start);
+      return;
+    }
+    if(!closing && gem::image::save::IMMEDIATE != ID) {
+      Request&req=requests[ID];
+      req.start=start;
+      req.filename=filename;
+    }
+  }
+
+  /* copy the oldest readback out of its PBO
+   * if 'wait' is false, this only happens if the GPU is done with it
+   * returns false if there was nothing to collect */
+  bool collect(bool wait)
+  {
+    if(!busy) {
+      return false;
+    }
+    Readback&rb=readbacks[first];
+    if(rb.fence) {
+      GLenum status=glClientWaitSync(rb.fence,
+                                     wait?GL_SYNC_FLUSH_COMMANDS_BIT:0,
+                                     wait?GL_TIMEOUT_IGNORED:0);
+      if(!wait && GL_TIMEOUT_EXPIRED == status) {
+        return false;
+      }
+      glDeleteSync(rb.fence);
+      rb.fence=0;
+    } else if(!wait && rb.frame == frame) {
+      /* without fences, give it (at least) a frame */
+      return false;
+    }
+    first=(first+1)%readbacks.size();
+    busy--;
+
+    imageStruct*img=new imageStruct;
+    img->xsize=rb.xsize;
+    img->ysize=rb.ysize;
+    img->setCsizeByFormat(rb.format);
+    img->upsidedown=false;
+    img->allocate();
+    const size_t bytes=img->xsize*img->ysize*img->csize;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.pbo);
+    const void*src=glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if(src) {
+      memcpy(img->data, src, bytes);
+      glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if(!src) {
+      delete img;
+      failed(rb.filename, rb.start);
+      return true;
+    }
+    encode(img, rb.filename, rb.props, rb.start);
+    return true;
+  }
+
+  void write(int x, int y, int width, int height, int format,
+             const std::string&filename, const gem::Properties&props)
+  {
+    const double start=sys_getrealtime();
+    if(inFlight()>=queueSize) {
+      owner->dropped(filename);
+      return;
+    }
+
+    if(!havePBO()) {
+      imageStruct*img=new imageStruct;
+      img->xsize=width;
+      img->ysize=height;
+      img->setCsizeByFormat(format);
+      img->upsidedown=false;
+      img->allocate();
+      glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+      glPixelStorei(GL_PACK_ALIGNMENT, 1);
+      glReadPixels(x, y, width, height, img->format, img->type, img->data);
+      glPopClientAttrib();
+      encode(img, filename, props, start);
+      return;
+    }
+
+    if(busy == readbacks.size()) {
+      /* the oldest frame is a few frames old, so this should not stall */
+      collect(true);
+    }
+    Readback&rb=readbacks[(first+busy)%readbacks.size()];
+
+    imageStruct header;
+    header.xsize=width;
+    header.ysize=height;
+    header.setCsizeByFormat(format);
+    const GLsizeiptr size=width*height*header.csize;
+
+    if(!rb.pbo) {
+      glGenBuffers(1, &rb.pbo);
+      if(!rb.pbo) {
+        return;
+      }
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.pbo);
+    if(size != rb.size) {
+      glBufferData(GL_PIXEL_PACK_BUFFER, size, 0, GL_STREAM_READ);
+      rb.size=size;
+    }
+    glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(x, y, width, height, header.format, header.type, 0);
+    glPopClientAttrib();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if(haveSync()) {
+      rb.fence=glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    rb.frame=frame;
+    rb.xsize=width;
+    rb.ysize=height;
+    rb.format=format;
+    rb.filename=filename;
+    rb.props=props;
+    rb.start=start;
+    busy++;
+  }
+
+  /* called once per frame */
+  void tick(void)
+  {
+    frame++;
+    while(collect(false));
+    gem::image::save::poll();
+  }
+
+  /* write out all pending readbacks and free the PBOs */
+  void release(void)
+  {
+    while(collect(true));
+    for(unsigned int i=0; i<readbacks.size(); i++) {
+      if(readbacks[i].pbo) {
+        glDeleteBuffers(1, &readbacks[i].pbo);
+      }
+      readbacks[i]=Readback();
+    }
+    first=busy=0;
+  }
+
+  /* forget about the pending readbacks (when there is no context to
+   * collect them), telling the user which images are lost */
+  void drop(void)
+  {
+    for(; busy; busy--) {
+      owner->error("dropping '%s' (no context to read it back)",
+                   readbacks[first].filename.c_str());
+      first=(first+1)%readbacks.size();
+    }
+    first=0;
+  }
+};
+
 /////////////////////////////////////////////////////////
 //
 // pix_write
@@ -44,6 +318,9 @@ CPPEXTERN_NEW_WITH_GIMME(pix_write);
 /////////////////////////////////////////////////////////
 pix_write :: pix_write(int argc, t_atom *argv)
   : m_originalImage(NULL), m_color(3)
+  , m_async(false)
+  , m_infoOut(gem::RTE::Outlet(this))
+  , m_pimpl(new PIMPL(this))
 {
   m_xoff = m_yoff = 0;
   m_width = m_height = 0;
@@ -95,7 +372,16 @@ pix_write :: pix_write(int argc, t_atom *argv)
 /////////////////////////////////////////////////////////
 pix_write :: ~pix_write(void)
 {
+  /* ~GemBase() can no longer reach our stopRendering() */
+  m_pimpl->closing=true;
+  if (gem_amRendering) {
+    m_pimpl->release();
+    gem_amRendering=false;
+  }
+  m_pimpl->drop();
   cleanImage();
+  delete m_pimpl;
+  m_pimpl=NULL;
 }
 
 
@@ -167,12 +453,67 @@ void pix_write :: doWrite(void)
   mem2image(m_originalImage, m_filename, m_filetype);
 }
 
+/////////////////////////////////////////////////////////
+// doWriteAsync
+//
+/////////////////////////////////////////////////////////
+void pix_write :: doWriteAsync(void)
+{
+  int width  = m_width;
+  int height = m_height;
+
+  GemMan::getDimen(((m_width >0)?NULL:&width ),
+                   ((m_height>0)?NULL:&height));
+
+#ifndef __APPLE__
+  int format=m_color;
+#else
+  int format=GEM_RGBA;
+#endif /* APPLE */
+
+  gem::Properties props;
+  if(m_filetype>0) {
+    props.set("quality", (float)m_filetype);
+  }
+  m_pimpl->write(m_xoff, m_yoff, width, height, format, m_filename, props);
+}
+
+/////////////////////////////////////////////////////////
+// written
+//
+/////////////////////////////////////////////////////////
+void pix_write :: written(const std::string&filename, bool success,
+                          double latency)
+{
+  std::vector<gem::any>atoms;
+  gem::any value;
+  if(success) {
+    atoms.push_back(value=std::string("success"));
+    atoms.push_back(value=filename);
+    atoms.push_back(value=latency);
+  } else {
+    error("unable to save image to '%s'", filename.c_str());
+    atoms.push_back(value=std::string("fail"));
+    atoms.push_back(value=filename);
+  }
+  m_infoOut.send("write", atoms);
+}
+void pix_write :: dropped(const std::string&filename)
+{
+  std::vector<gem::any>atoms;
+  gem::any value;
+  atoms.push_back(value=std::string("drop"));
+  atoms.push_back(value=filename);
+  m_infoOut.send("write", atoms);
+}
+
 /////////////////////////////////////////////////////////
 // render
 //
 /////////////////////////////////////////////////////////
 void pix_write :: render(GemState *state)
 {
+  m_pimpl->tick();
   if (m_automatic || m_banged) {
     char *extension;
     if (m_filetype<0) {
@@ -190,10 +531,23 @@ void pix_write :: render(GemState *state)
 
     m_autocount++;
     m_banged = false;
-    doWrite();
+    if(m_async) {
+      doWriteAsync();
+    } else {
+      doWrite();
+    }
   }
 }
 
+/////////////////////////////////////////////////////////
+// stopRendering
+//
+/////////////////////////////////////////////////////////
+void pix_write :: stopRendering(void)
+{
+  m_pimpl->release();
+}
+
 
 /////////////////////////////////////////////////////////
 // sizeMess
@@ -256,6 +610,9 @@ void pix_write :: obj_setupCallback(t_class *classPtr)
   CPPEXTERN_MSG1(classPtr, "auto", autoMess, bool);
   CPPEXTERN_MSG0(classPtr, "bang", bangMess);
   CPPEXTERN_MSG1(classPtr, "color_format", colorFormatMess, int);
+  CPPEXTERN_MSG1(classPtr, "async", asyncMess, bool);
+  CPPEXTERN_MSG1(classPtr, "queue", queueMess, int);
+  CPPEXTERN_MSG1(classPtr, "threads", threadsMess, int);
 
   CPPEXTERN_MSG2(classPtr, "vert_size", sizeMess, int, int);
   CPPEXTERN_MSG2(classPtr, "vert_pos",  posMess, int, int);
@@ -277,3 +634,28 @@ void pix_write :: colorFormatMess(int format)
     m_color = 3;
   }
 }
+void pix_write :: asyncMess(bool on)
+{
+  m_async=on;
+}
+void pix_write :: queueMess(int size)
+{
+  if(size<1) {
+    error("queue size must be at least 1");
+    return;
+  }
+  m_pimpl->queueSize=size;
+}
+void pix_write :: threadsMess(int threads)
+{
+  if(threads<0) {
+    error("number of threads must not be negative");
+    return;
+  }
+  unsigned int used=gem::image::save::setThreads(threads);
+  if(!used) {
+    error("threaded image saving not supported");
+    return;
+  }
+  verbose(1, "using %d encoder threads", used);
+}
@@ -17,6 +17,7 @@ LOG
 
 #include "Base/GemBase.h"
 #include "Gem/Image.h"
+#include "RTE/Outlet.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -36,6 +37,12 @@ DESCRIPTION
     "file" - filename to write to
     "bang" - do write now
     "auto 0/1" - stop/start writing automatically
+    "async 0/1" - read back and save in the background
+    "queue <n>" - frames that may be in flight (newer ones are dropped)
+    "threads <n>" - number of encoder threads (0: one per CPU)
+
+    Outlet for info: "write success <file> <ms>", "write fail <file>",
+                     "write drop <file>"
 
     "vert_size" - Set the size of the pix
     "vert_pos" - Set the position of the pix
@@ -60,6 +67,9 @@ protected:
   //////////
   // Write to the current filename
   virtual void    doWrite(void);
+  //////////
+  // Read back now, and write to the current filename in the background
+  virtual void    doWriteAsync(void);
 
   // check extensions
   virtual bool isRunnable(void);
@@ -68,6 +78,10 @@ protected:
   // Do the rendering
   virtual void    render(GemState *state);
 
+  //////////
+  // release the readback buffers
+  virtual void    stopRendering(void);
+
   //////////
   // Clear the dirty flag on the pixBlock
   virtual void    postrender(GemState *state) {};
@@ -87,6 +101,14 @@ protected:
   void autoMess(bool);
   void bangMess(void);
   void colorFormatMess(int format);
+  void asyncMess(bool);
+  void queueMess(int size);
+  void threadsMess(int threads);
+
+  //////////
+  // called (in the main thread) when a file has been written in the background
+  void written(const std::string&filename, bool success, double latency);
+  void dropped(const std::string&filename);
 
   //////////
   // Clean up the image
@@ -140,7 +162,14 @@ protected:
   // The color (1 = R, 3 = RGB, 4 = RGBA)
   int m_color;
 
+  //////////
+  // asynchronous writing
+  bool m_async;
+  gem::RTE::Outlet m_infoOut;
+
 private:
+  class PIMPL;
+  PIMPL*m_pimpl;
 
   //////////
   // static member functions
@@ -15,6 +15,12 @@
 /////////////////////////////////////////////////////////
 
 #include "Matrix.h"
+#include "Quaternion.h"
+#include "SIMD.h"
+
+#ifdef __AVX__
+# include <immintrin.h>
+#endif
 
 #include <assert.h>
 
@@ -33,7 +39,70 @@ inline float fast_sqrtf(float x)
 #endif
 
 static const float PI = 3.141592f;
-static const float DEGREES_TO_RADIANS = 0.017453f;
+static const float DEGREES_TO_RADIANS = 0.0174532925f;
+
+static bool useSIMD(void)
+{
+#ifdef __SSE2__
+  return (GEM_SIMD_SSE2 == GemSIMD::getCPU());
+#else
+  return false;
+#endif
+}
+
+#ifdef __SSE2__
+/* dst=a*b (dst may be the same as 'a' or 'b') */
+static void multiplySSE2(float dst[4][4], const float a[4][4],
+                         const float b[4][4])
+{
+  /* each row of the result is a linear combination of the rows of 'b' */
+  const __m128 b0=_mm_loadu_ps(b[0]);
+  const __m128 b1=_mm_loadu_ps(b[1]);
+  const __m128 b2=_mm_loadu_ps(b[2]);
+  const __m128 b3=_mm_loadu_ps(b[3]);
+  for(int i=0; i<4; i++) {
+    __m128 r=_mm_mul_ps(_mm_set1_ps(a[i][0]), b0);
+    r=_mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[i][1]), b1));
+    r=_mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[i][2]), b2));
+    r=_mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[i][3]), b3));
+    _mm_storeu_ps(dst[i], r);
+  }
+}
+
+static void transformSSE2(const float m[4][4], const float*src, float*dst,
+                          unsigned int count)
+{
+  /* the columns of the matrix */
+  const __m128 c0=_mm_set_ps(m[3][0], m[2][0], m[1][0], m[0][0]);
+  const __m128 c1=_mm_set_ps(m[3][1], m[2][1], m[1][1], m[0][1]);
+  const __m128 c2=_mm_set_ps(m[3][2], m[2][2], m[1][2], m[0][2]);
+  const __m128 c3=_mm_set_ps(m[3][3], m[2][3], m[1][3], m[0][3]);
+  unsigned int i=0;
+# ifdef __AVX__
+  /* two vectors at once */
+  const __m256 C0=_mm256_broadcast_ps(&c0);
+  const __m256 C1=_mm256_broadcast_ps(&c1);
+  const __m256 C2=_mm256_broadcast_ps(&c2);
+  const __m256 C3=_mm256_broadcast_ps(&c3);
+  for(; i+2<=count; i+=2, src+=8, dst+=8) {
+    const __m256 v=_mm256_loadu_ps(src);
+    __m256 r=_mm256_mul_ps(C0, _mm256_permute_ps(v, 0x00));
+    r=_mm256_add_ps(r, _mm256_mul_ps(C1, _mm256_permute_ps(v, 0x55)));
+    r=_mm256_add_ps(r, _mm256_mul_ps(C2, _mm256_permute_ps(v, 0xAA)));
+    r=_mm256_add_ps(r, _mm256_mul_ps(C3, _mm256_permute_ps(v, 0xFF)));
+    _mm256_storeu_ps(dst, r);
+  }
+# endif /* __AVX__ */
+  for(; i<count; i++, src+=4, dst+=4) {
+    const __m128 v=_mm_loadu_ps(src);
+    __m128 r=_mm_mul_ps(c0, _mm_shuffle_ps(v, v, 0x00));
+    r=_mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, 0x55)));
+    r=_mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, 0xAA)));
+    r=_mm_add_ps(r, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, 0xFF)));
+    _mm_storeu_ps(dst, r);
+  }
+}
+#endif /* __SSE2__ */
 
 /////////////////////////////////////////////////////////
 //
@@ -68,15 +137,11 @@ void Matrix :: identity()
 /////////////////////////////////////////////////////////
 void Matrix :: scale(float x, float y, float z)
 {
-  mat[0][0] *= x;
-  mat[0][1] *= x;
-  mat[0][2] *= x;
-  mat[1][0] *= y;
-  mat[1][1] *= y;
-  mat[1][2] *= y;
-  mat[2][0] *= z;
-  mat[2][1] *= z;
-  mat[2][2] *= z;
+  for(int i=0; i<4; i++) {
+    mat[i][0] *= x;
+    mat[i][1] *= y;
+    mat[i][2] *= z;
+  }
 }
 
 /////////////////////////////////////////////////////////
@@ -85,11 +150,29 @@ void Matrix :: scale(float x, float y, float z)
 /////////////////////////////////////////////////////////
 void Matrix :: multiply(Matrix *matrix)
 {
-  Matrix tmp;
-
   assert(matrix);
-
-  tmp = *this;
+  multiply(*matrix);
+}
+void Matrix :: multiply(const float*glMatrix)
+{
+  Matrix m;
+  for(int i=0; i<4; i++) {
+    for(int j=0; j<4; j++) {
+      m.mat[i][j]=glMatrix[j*4+i];
+    }
+  }
+  multiply(m);
+}
+void Matrix :: multiply(const Matrix&m)
+{
+  const Matrix*matrix=&m;
+#ifdef __SSE2__
+  if(useSIMD()) {
+    multiplySSE2(mat, mat, matrix->mat);
+    return;
+  }
+#endif
+  Matrix tmp(*this);
 
   mat[0][0] = tmp.mat[0][0] * matrix->mat[0][0] + tmp.mat[0][1] *
               matrix->mat[1][0] + tmp.mat[0][2] * matrix->mat[2][0] + tmp.mat[0][3] *
@@ -217,6 +300,43 @@ void Matrix :: rotateZ(float degrees)
   mat[2][1] = c * tmp.mat[2][1] - s * tmp.mat[2][0];
 }
 
+/////////////////////////////////////////////////////////
+// rotate
+//
+/////////////////////////////////////////////////////////
+void Matrix :: rotate(float degrees, float x, float y, float z)
+{
+  const float len = (float)sqrt(x*x + y*y + z*z);
+  if(len == 0.0f) {
+    return;
+  }
+  x/=len;
+  y/=len;
+  z/=len;
+
+  const float c = (float)cos(DEGREES_TO_RADIANS * degrees);
+  const float s = (float)sin(DEGREES_TO_RADIANS * degrees);
+  const float t = 1.f - c;
+
+  Matrix r;
+  r.mat[0][0] = x * x * t + c;
+  r.mat[0][1] = x * y * t - z * s;
+  r.mat[0][2] = x * z * t + y * s;
+  r.mat[1][0] = y * x * t + z * s;
+  r.mat[1][1] = y * y * t + c;
+  r.mat[1][2] = y * z * t - x * s;
+  r.mat[2][0] = z * x * t - y * s;
+  r.mat[2][1] = z * y * t + x * s;
+  r.mat[2][2] = z * z * t + c;
+  multiply(r);
+}
+void Matrix :: rotate(const Quaternion&q)
+{
+  Matrix r;
+  q.getMatrix(r);
+  multiply(r);
+}
+
 /////////////////////////////////////////////////////////
 // transform
 //
@@ -228,6 +348,51 @@ void Matrix::transform(float srcX, float srcY, float srcZ, float *dstX,
   *dstY = srcX * mat[1][0] + srcY * mat[1][1] + srcZ * mat[1][2] + mat[1][3];
   *dstZ = srcX * mat[2][0] + srcY * mat[2][1] + srcZ * mat[2][2] + mat[2][3];
 }
+void Matrix::transform(const float*src, float*dst, unsigned int count) const
+{
+#ifdef __SSE2__
+  if(useSIMD()) {
+    transformSSE2(mat, src, dst, count);
+    return;
+  }
+#endif
+  for(unsigned int i=0; i<count; i++, src+=4, dst+=4) {
+    const float x=src[0], y=src[1], z=src[2], w=src[3];
+    dst[0] = x * mat[0][0] + y * mat[0][1] + z * mat[0][2] + w * mat[0][3];
+    dst[1] = x * mat[1][0] + y * mat[1][1] + z * mat[1][2] + w * mat[1][3];
+    dst[2] = x * mat[2][0] + y * mat[2][1] + z * mat[2][2] + w * mat[2][3];
+    dst[3] = x * mat[3][0] + y * mat[3][1] + z * mat[3][2] + w * mat[3][3];
+  }
+}
+
+/////////////////////////////////////////////////////////
+// getColumnMajor
+//
+/////////////////////////////////////////////////////////
+void Matrix :: getColumnMajor(float*dst) const
+{
+  for(int i=0; i<4; i++) {
+    for(int j=0; j<4; j++) {
+      dst[j*4+i]=mat[i][j];
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////
+// isIdentity
+//
+/////////////////////////////////////////////////////////
+bool Matrix :: isIdentity(void) const
+{
+  for(int i=0; i<4; i++) {
+    for(int j=0; j<4; j++) {
+      if(mat[i][j] != ((i==j)?1.f:0.f)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
 
 /////////////////////////////////////////////////////////
 // generateNormal
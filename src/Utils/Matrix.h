@@ -17,6 +17,8 @@ LOG
 
 #include "Gem/ExportDef.h"
 
+class Quaternion;
+
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
 CLASS
@@ -29,6 +31,9 @@ DESCRIPTION
         Post-concatenation
         Column-major
 
+        the values are stored as mat[row][column]
+        (use getColumnMajor() to pass the matrix to openGL)
+
 -----------------------------------------------------------------*/
 class GEM_EXTERN Matrix
 {
@@ -46,6 +51,12 @@ public:
   //////////
   // Post multiply the matrix
   void multiply(Matrix *pMatrix);
+  void multiply(const Matrix&matrix);
+
+  //////////
+  // Post multiply with a matrix in openGL's (column-major) order
+  // (like glMultMatrixf())
+  void multiply(const float*glMatrix);
 
   //////////
   void scale(float x, float y, float z);
@@ -62,10 +73,30 @@ public:
   //////////
   void rotateZ(float degrees);
 
+  //////////
+  // rotate around an arbitrary axis (like glRotatef())
+  void rotate(float degrees, float x, float y, float z);
+
+  //////////
+  // rotate by a (unit) quaternion
+  void rotate(const Quaternion&q);
+
   //////////
   void transform(float srcX, float srcY, float srcZ, float *dstX,
                  float *dstY, float *dstZ) const;
 
+  //////////
+  // transform 'count' vectors of 4 floats (x,y,z,w)
+  // 'src' and 'dst' may be the same
+  void transform(const float*src, float*dst, unsigned int count) const;
+
+  //////////
+  // get the values in openGL's (column-major) order
+  void getColumnMajor(float*dst) const;
+
+  //////////
+  bool isIdentity(void) const;
+
   //////////
   // The actual matrix values
   float                           mat[4][4];
@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+
+#include "Quaternion.h"
+#include "Matrix.h"
+
+#include <math.h>
+
+static const float DEGREES_TO_RADIANS = 0.0174532925f;
+
+/////////////////////////////////////////////////////////
+//
+// Quaternion
+//
+/////////////////////////////////////////////////////////
+// Constructor
+//
+/////////////////////////////////////////////////////////
+Quaternion :: Quaternion(void)
+  : w(1.f), x(0.f), y(0.f), z(0.f)
+{
+}
+Quaternion :: Quaternion(float W, float X, float Y, float Z)
+  : w(W), x(X), y(Y), z(Z)
+{
+}
+
+/////////////////////////////////////////////////////////
+// fromAxisAngle
+//
+/////////////////////////////////////////////////////////
+Quaternion Quaternion :: fromAxisAngle(float degrees, float X, float Y,
+                                       float Z)
+{
+  const float len = (float)sqrt(X*X + Y*Y + Z*Z);
+  if(len == 0.0f) {
+    return Quaternion();
+  }
+  const float a = 0.5f * DEGREES_TO_RADIANS * degrees;
+  const float s = (float)sin(a) / len;
+  return Quaternion((float)cos(a), X*s, Y*s, Z*s);
+}
+
+/////////////////////////////////////////////////////////
+// fromEuler
+//
+/////////////////////////////////////////////////////////
+Quaternion Quaternion :: fromEuler(float X, float Y, float Z)
+{
+  const float ax = 0.5f * DEGREES_TO_RADIANS * X;
+  const float ay = 0.5f * DEGREES_TO_RADIANS * Y;
+  const float az = 0.5f * DEGREES_TO_RADIANS * Z;
+  const float cx = (float)cos(ax), sx = (float)sin(ax);
+  const float cy = (float)cos(ay), sy = (float)sin(ay);
+  const float cz = (float)cos(az), sz = (float)sin(az);
+
+  /* qx*qy*qz, expanded */
+  return Quaternion(cx*cy*cz - sx*sy*sz,
+                    sx*cy*cz + cx*sy*sz,
+                    cx*sy*cz - sx*cy*sz,
+                    cx*cy*sz + sx*sy*cz);
+}
+
+/////////////////////////////////////////////////////////
+// operator*
+//
+/////////////////////////////////////////////////////////
+Quaternion Quaternion :: operator*(const Quaternion&q) const
+{
+  return Quaternion(w*q.w - x*q.x - y*q.y - z*q.z,
+                    w*q.x + x*q.w + y*q.z - z*q.y,
+                    w*q.y - x*q.z + y*q.w + z*q.x,
+                    w*q.z + x*q.y - y*q.x + z*q.w);
+}
+
+/////////////////////////////////////////////////////////
+// conjugate
+//
+/////////////////////////////////////////////////////////
+Quaternion Quaternion :: conjugate(void) const
+{
+  return Quaternion(w, -x, -y, -z);
+}
+
+/////////////////////////////////////////////////////////
+// norm
+//
+/////////////////////////////////////////////////////////
+float Quaternion :: norm(void) const
+{
+  return (float)sqrt(w*w + x*x + y*y + z*z);
+}
+void Quaternion :: normalize(void)
+{
+  const float n = norm();
+  if(n == 0.0f) {
+    w = 1.f;
+    x = y = z = 0.f;
+    return;
+  }
+  w /= n;
+  x /= n;
+  y /= n;
+  z /= n;
+}
+
+/////////////////////////////////////////////////////////
+// slerp
+//
+/////////////////////////////////////////////////////////
+Quaternion Quaternion :: slerp(const Quaternion&a, const Quaternion&b,
+                               float t)
+{
+  float d = a.w*b.w + a.x*b.x + a.y*b.y + a.z*b.z;
+  float sign = 1.f;
+  /* take the shorter way */
+  if(d < 0.f) {
+    d = -d;
+    sign = -1.f;
+  }
+  float wa, wb;
+  if(d > 0.9995f) {
+    /* (almost) the same rotation: interpolate linearly */
+    wa = 1.f - t;
+    wb = t;
+  } else {
+    const float theta = (float)acos(d);
+    const float s = (float)sin(theta);
+    wa = (float)sin((1.f - t) * theta) / s;
+    wb = (float)sin(t * theta) / s;
+  }
+  wb *= sign;
+  Quaternion q(wa*a.w + wb*b.w,
+               wa*a.x + wb*b.x,
+               wa*a.y + wb*b.y,
+               wa*a.z + wb*b.z);
+  q.normalize();
+  return q;
+}
+
+/////////////////////////////////////////////////////////
+// getMatrix
+//
+/////////////////////////////////////////////////////////
+void Quaternion :: getMatrix(Matrix&m) const
+{
+  const float xx = x*x, yy = y*y, zz = z*z;
+  const float xy = x*y, xz = x*z, yz = y*z;
+  const float wx = w*x, wy = w*y, wz = w*z;
+
+  m.identity();
+  m.mat[0][0] = 1.f - 2.f * (yy + zz);
+  m.mat[0][1] = 2.f * (xy - wz);
+  m.mat[0][2] = 2.f * (xz + wy);
+  m.mat[1][0] = 2.f * (xy + wz);
+  m.mat[1][1] = 1.f - 2.f * (xx + zz);
+  m.mat[1][2] = 2.f * (yz - wx);
+  m.mat[2][0] = 2.f * (xz - wy);
+  m.mat[2][1] = 2.f * (yz + wx);
+  m.mat[2][2] = 1.f - 2.f * (xx + yy);
+}
+
+/////////////////////////////////////////////////////////
+// rotate
+//
+/////////////////////////////////////////////////////////
+void Quaternion :: rotate(const float*src, float*dst) const
+{
+  /* v' = v + 2w(q x v) + 2q x (q x v) */
+  const float tx = 2.f * (y*src[2] - z*src[1]);
+  const float ty = 2.f * (z*src[0] - x*src[2]);
+  const float tz = 2.f * (x*src[1] - y*src[0]);
+  const float X = src[0] + w*tx + (y*tz - z*ty);
+  const float Y = src[1] + w*ty + (z*tx - x*tz);
+  const float Z = src[2] + w*tz + (x*ty - y*tx);
+  dst[0] = X;
+  dst[1] = Y;
+  dst[2] = Z;
+}
+void Quaternion :: rotate(const float*src, float*dst,
+                          unsigned int count) const
+{
+  Matrix m;
+  getMatrix(m);
+  m.transform(src, dst, count);
+}
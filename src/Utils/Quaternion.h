@@ -0,0 +1,88 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+        Quaternion class
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_UTILS_QUATERNION_H_
+#define _INCLUDE__GEM_UTILS_QUATERNION_H_
+
+#include "Gem/ExportDef.h"
+
+class Matrix;
+
+/*-----------------------------------------------------------------
+-------------------------------------------------------------------
+CLASS
+    Quaternion
+
+    a rotation
+
+DESCRIPTION
+
+        w + xi + yj + zk
+        all angles are in degrees
+
+-----------------------------------------------------------------*/
+class GEM_EXTERN Quaternion
+{
+public:
+
+  //////////
+  // Constructor
+  // Sets the quaternion to identity (no rotation)
+  Quaternion(void);
+  Quaternion(float w, float x, float y, float z);
+
+  //////////
+  // a rotation around an arbitrary axis (like glRotatef())
+  static Quaternion fromAxisAngle(float degrees, float x, float y, float z);
+
+  //////////
+  // a rotation around the X, then the Y and then the Z axis
+  // (like [rotateXYZ])
+  static Quaternion fromEuler(float x, float y, float z);
+
+  //////////
+  // concatenate two rotations (the right-hand one is applied first,
+  // just like with matrices)
+  Quaternion operator*(const Quaternion&q) const;
+
+  //////////
+  // the inverse rotation (for unit quaternions)
+  Quaternion conjugate(void) const;
+
+  //////////
+  float norm(void) const;
+  void normalize(void);
+
+  //////////
+  // spherical linear interpolation between two rotations
+  static Quaternion slerp(const Quaternion&a, const Quaternion&b, float t);
+
+  //////////
+  // get the rotation matrix
+  void getMatrix(Matrix&m) const;
+
+  //////////
+  // rotate a single vector (x,y,z)
+  void rotate(const float*src, float*dst) const;
+
+  //////////
+  // rotate 'count' vectors of 4 floats (x,y,z,w)
+  // 'src' and 'dst' may be the same
+  void rotate(const float*src, float*dst, unsigned int count) const;
+
+  //////////
+  // The actual values
+  float w, x, y, z;
+};
+
+
+#endif  // for header file
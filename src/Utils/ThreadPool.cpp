@@ -0,0 +1,254 @@
+////////////////////////////////////////////////////////
+//
+// GEM - Graphics Environment for Multimedia
+//
+// zmoelnig@iem.at
+//
+// Implementation file
+//
+//    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+//    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+//    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+//
+/////////////////////////////////////////////////////////
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "ThreadPool.h"
+#include "Thread.h"
+#include "Gem/RTE.h"
+
+#include <pthread.h>
+#include <vector>
+
+#ifdef _WIN32
+# include <winsock2.h>
+#endif
+
+namespace gem
+{
+namespace thread
+{
+
+ThreadPool::Job::~Job(void)
+{
+}
+
+class ThreadPool::PIMPL
+{
+public:
+  std::vector<pthread_t>threads;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t  cond_work; /* signalled when a new job is available */
+  pthread_cond_t  cond_done; /* signalled when the last slice has finished */
+
+  ThreadPool::Job*job;
+  unsigned int numSlices;
+  unsigned int nextSlice;
+  unsigned int pending;
+  unsigned long generation;
+  bool keeprunning;
+
+  PIMPL(void)
+    : job(0)
+    , numSlices(0), nextSlice(0), pending(0)
+    , generation(0)
+    , keeprunning(true)
+  {
+    pthread_mutex_init(&mutex, 0);
+    pthread_cond_init (&cond_work, 0);
+    pthread_cond_init (&cond_done, 0);
+  }
+  ~PIMPL(void)
+  {
+    stop();
+    pthread_cond_destroy (&cond_done);
+    pthread_cond_destroy (&cond_work);
+    pthread_mutex_destroy(&mutex);
+  }
+
+  /* grab slices until there are none left
+   * must be called with the mutex locked (returns with the mutex locked)
+   */
+  void work(void)
+  {
+    while(job && nextSlice<numSlices) {
+      ThreadPool::Job*j=job;
+      unsigned int slice=nextSlice++;
+      unsigned int count=numSlices;
+      pthread_mutex_unlock(&mutex);
+
+      j->process(slice, count);
+
+      pthread_mutex_lock(&mutex);
+      if(0 == --pending) {
+        job=0;
+        pthread_cond_broadcast(&cond_done);
+      }
+    }
+  }
+
+  static void*process(void*you)
+  {
+    PIMPL*me=reinterpret_cast<PIMPL*>(you);
+    unsigned long generation=0;
+    pthread_mutex_lock(&me->mutex);
+    while(me->keeprunning) {
+      while(me->keeprunning && generation == me->generation) {
+        pthread_cond_wait(&me->cond_work, &me->mutex);
+      }
+      if(!me->keeprunning) {
+        break;
+      }
+      generation=me->generation;
+      me->work();
+    }
+    pthread_mutex_unlock(&me->mutex);
+    return 0;
+  }
+
+  void start(unsigned int count)
+  {
+    pthread_mutex_lock(&mutex);
+    keeprunning=true;
+    pthread_mutex_unlock(&mutex);
+    while(threads.size()<count) {
+      pthread_t thread;
+      if(pthread_create(&thread, 0, process, this)) {
+        break;
+      }
+      threads.push_back(thread);
+    }
+  }
+  void stop(void)
+  {
+    pthread_mutex_lock(&mutex);
+    keeprunning=false;
+    pthread_cond_broadcast(&cond_work);
+    pthread_mutex_unlock(&mutex);
+    for(unsigned int i=0; i<threads.size(); i++) {
+      pthread_join(threads[i], 0);
+    }
+    threads.clear();
+  }
+
+  void run(ThreadPool::Job&j, unsigned int slices)
+  {
+    pthread_mutex_lock(&mutex);
+    job=&j;
+    numSlices=slices;
+    nextSlice=0;
+    pending=slices;
+    generation++;
+    pthread_cond_broadcast(&cond_work);
+
+    /* the calling thread helps out */
+    work();
+    while(pending) {
+      pthread_cond_wait(&cond_done, &mutex);
+    }
+    pthread_mutex_unlock(&mutex);
+  }
+};
+
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+  : m_pimpl(new PIMPL())
+{
+  setThreads(numThreads);
+}
+ThreadPool::~ThreadPool(void)
+{
+  delete m_pimpl;
+  m_pimpl=0;
+}
+
+/* _private_ dummy implementations */
+ThreadPool&ThreadPool::operator=(const ThreadPool&org)
+{
+  return (*this);
+}
+ThreadPool::ThreadPool(const ThreadPool&org)
+  : m_pimpl(new PIMPL())
+{
+}
+
+unsigned int ThreadPool::setThreads(unsigned int numThreads)
+{
+  if(0 == numThreads) {
+    numThreads=getCPUCount();
+  }
+  if(numThreads<1) {
+    numThreads=1;
+  }
+  /* more threads than this only add overhead */
+  unsigned int maxThreads=4*getCPUCount();
+  if(maxThreads<4) {
+    maxThreads=4;
+  }
+  if(numThreads>maxThreads) {
+    numThreads=maxThreads;
+  }
+  /* the calling thread is part of the pool */
+  if(numThreads-1 != m_pimpl->threads.size()) {
+    m_pimpl->stop();
+    m_pimpl->start(numThreads-1);
+  }
+  return getThreads();
+}
+unsigned int ThreadPool::setThreads(int numThreads)
+{
+  if(numThreads<0) {
+    pd_error(0, "number of threads must not be negative");
+    return getThreads();
+  }
+  return setThreads(static_cast<unsigned int>(numThreads));
+}
+unsigned int ThreadPool::getThreads(void) const
+{
+  return m_pimpl->threads.size()+1;
+}
+
+void ThreadPool::run(ThreadPool::Job&job, unsigned int numSlices)
+{
+  if(0 == numSlices) {
+    numSlices=getThreads();
+  }
+  if(1 == numSlices || m_pimpl->threads.empty()) {
+    /* no need to bother the threads */
+    for(unsigned int i=0; i<numSlices; i++) {
+      job.process(i, numSlices);
+    }
+    return;
+  }
+  m_pimpl->run(job, numSlices);
+}
+
+void ThreadPool::getSlice(unsigned int slice, unsigned int numSlices,
+                          unsigned int size,
+                          unsigned int&start, unsigned int&stop,
+                          unsigned int align)
+{
+  if(numSlices<1) {
+    numSlices=1;
+  }
+  if(align<1) {
+    align=1;
+  }
+  unsigned int chunk=(size+numSlices-1)/numSlices;
+  chunk=((chunk+align-1)/align)*align;
+
+  start=slice*chunk;
+  stop =start+chunk;
+  if(start>size) {
+    start=size;
+  }
+  if(stop>size || slice+1 == numSlices) {
+    stop=size;
+  }
+}
+
+};
+}; // } thread } gem
@@ -0,0 +1,87 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    ThreadPool.h
+       - part of GEM
+       - a pool of threads for splitting a workload into slices
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_UTILS_THREADPOOL_H_
+#define _INCLUDE__GEM_UTILS_THREADPOOL_H_
+
+#include "Gem/ExportDef.h"
+
+namespace gem
+{
+namespace thread
+{
+class GEM_EXTERN ThreadPool
+{
+private:
+  class PIMPL;
+  PIMPL*m_pimpl;
+  friend class PIMPL;
+  /* dummy implementations */
+  ThreadPool(const ThreadPool&);
+  ThreadPool&operator=(const ThreadPool&);
+public:
+  /**
+   * a workload that can be split into a number of independent slices
+   */
+  class GEM_EXTERN Job
+  {
+  public:
+    virtual ~Job(void);
+    ////
+    // the worker!
+    // gets called once for each slice, possibly from different threads
+    // in parallel (including the thread that called ThreadPool::run())
+    virtual void process(unsigned int slice, unsigned int numSlices) = 0;
+  };
+
+  /**
+   * create a pool with 'numThreads' threads (including the calling thread)
+   * if 'numThreads' is 0, the number of available CPUs is used
+   */
+  ThreadPool(unsigned int numThreads=1);
+  virtual ~ThreadPool(void);
+
+  ////
+  // change the number of threads
+  //  (0 means "as many threads as there are CPUs",
+  //   just like gem::image::load::setThreads() and gem::image::save::setThreads())
+  //  the number is limited to 4 times the number of CPUs
+  // returns the number of threads actually used
+  virtual unsigned int setThreads(unsigned int numThreads);
+  ////
+  // same as above, for numbers coming from the user (e.g. with a "threads" message)
+  //  negative numbers are rejected with an error and the pool is left as is
+  virtual unsigned int setThreads(int numThreads);
+  virtual unsigned int getThreads(void) const;
+
+  ////
+  // split the job into 'numSlices' slices and process them on the pool
+  // blocks until all slices have been processed
+  // if 'numSlices' is 0, the job is split into as many slices as there are threads
+  virtual void run(Job&job, unsigned int numSlices=0);
+
+  ////
+  // helper to calculate the [start, stop[ range of a slice,
+  //  when splitting 'size' elements into 'numSlices' (almost) equal chunks
+  //  the boundaries are aligned to multiples of 'align' (except for the last one)
+  static void getSlice(unsigned int slice, unsigned int numSlices,
+                       unsigned int size,
+                       unsigned int&start, unsigned int&stop,
+                       unsigned int align=1);
+};
+};
+};
+
+
+#endif /* _INCLUDE__GEM_UTILS_THREADPOOL_H_ */
@@ -0,0 +1,212 @@
+/*-----------------------------------------------------------------
+LOG
+    GEM - Graphics Environment for Multimedia
+
+    ThreadRing.h
+       - part of GEM
+       - a lock-free ring buffer for exchanging data between two threads
+
+    Copyright (c) 2026 IOhannes m zmölnig. forum::für::umläute. IEM. zmoelnig@iem.at
+    For information on usage and redistribution, and for a DISCLAIMER OF ALL
+    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
+
+-----------------------------------------------------------------*/
+
+#ifndef _INCLUDE__GEM_UTILS_THREADRING_H_
+#define _INCLUDE__GEM_UTILS_THREADRING_H_
+
+#include <vector>
+#include <cstddef>
+
+#ifdef _MSC_VER
+# include <intrin.h>
+#endif
+
+namespace gem
+{
+namespace thread
+{
+namespace atomic
+{
+/* load/store with acquire/release semantics */
+template<class T>
+inline T load(const volatile T&value)
+{
+#if defined(__ATOMIC_ACQUIRE)
+  return __atomic_load_n(&value, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+  /* volatile reads have acquire semantics on MSVC */
+  T result=value;
+  _ReadWriteBarrier();
+  return result;
+#else
+  T result=value;
+  __sync_synchronize();
+  return result;
+#endif
+}
+template<class T>
+inline void store(volatile T&value, T newvalue)
+{
+#if defined(__ATOMIC_RELEASE)
+  __atomic_store_n(&value, newvalue, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+  /* volatile writes have release semantics on MSVC */
+  _ReadWriteBarrier();
+  value=newvalue;
+#else
+  __sync_synchronize();
+  value=newvalue;
+#endif
+}
+};
+
+/**
+ * a ring of 'capacity' elements, for exactly one producer thread and
+ * one consumer thread (e.g. the DSP thread and the render thread)
+ *
+ * neither side blocks or allocates memory: the storage is allocated by
+ * resize(), which must only be called while neither side uses the ring
+ *
+ * the elements are either exchanged in bulk (write()/publish(), read())
+ * or in place (back()/push(), front()/pop()), e.g. to pass whole images
+ *
+ * the over- and underruns are only counted by the sides themselves
+ * (e.g. when a producer has to drop data because the ring is full),
+ * so the counters can be read from anywhere
+ */
+template<class T>
+class ThreadRing
+{
+public:
+  ThreadRing(size_t capacity=0)
+    : m_read(0), m_write(0), m_pending(0)
+    , m_overruns(0), m_underruns(0)
+  {
+    resize(capacity);
+  }
+
+  ////
+  // (re)allocate the ring; this discards its content
+  void resize(size_t capacity)
+  {
+    m_data.resize(capacity+1);
+    m_read=m_write=m_pending=0;
+  }
+  size_t capacity(void) const
+  {
+    return m_data.size()-1;
+  }
+
+  ////
+  // producer side
+
+  // the number of elements that can still be written
+  size_t writable(void) const
+  {
+    const size_t size=m_data.size();
+    return capacity() - (m_pending + size - atomic::load(m_read))%size;
+  }
+  // copy 'count' elements into the ring (all or nothing)
+  // they are not visible to the consumer until publish()
+  bool write(const T*data, size_t count)
+  {
+    if(count>writable()) {
+      return false;
+    }
+    const size_t size=m_data.size();
+    size_t pos=m_pending;
+    for(size_t i=0; i<count; i++) {
+      m_data[pos]=data[i];
+      if(++pos == size) {
+        pos=0;
+      }
+    }
+    m_pending=pos;
+    return true;
+  }
+  void publish(void)
+  {
+    atomic::store(m_write, m_pending);
+  }
+  // the next element to write to in place (or NULL if the ring is full)
+  T*back(void)
+  {
+    return writable()?&m_data[m_pending]:0;
+  }
+  // publish the element returned by back()
+  void push(void)
+  {
+    m_pending=(m_pending+1)%m_data.size();
+    publish();
+  }
+  void overrun(void)
+  {
+    m_overruns++;
+  }
+
+  ////
+  // consumer side
+
+  // the number of elements that can be read
+  size_t readable(void) const
+  {
+    const size_t size=m_data.size();
+    return (atomic::load(m_write) + size - m_read)%size;
+  }
+  // copy 'count' elements out of the ring (all or nothing)
+  bool read(T*data, size_t count)
+  {
+    if(count>readable()) {
+      return false;
+    }
+    const size_t size=m_data.size();
+    size_t pos=m_read;
+    for(size_t i=0; i<count; i++) {
+      data[i]=m_data[pos];
+      if(++pos == size) {
+        pos=0;
+      }
+    }
+    atomic::store(m_read, pos);
+    return true;
+  }
+  // the oldest element (or NULL if the ring is empty)
+  T*front(void)
+  {
+    return readable()?&m_data[m_read]:0;
+  }
+  // release the element returned by front() to the producer
+  void pop(void)
+  {
+    atomic::store(m_read, (m_read+1)%m_data.size());
+  }
+  void underrun(void)
+  {
+    m_underruns++;
+  }
+
+  ////
+  // statistics
+  unsigned long overruns(void) const
+  {
+    return m_overruns;
+  }
+  unsigned long underruns(void) const
+  {
+    return m_underruns;
+  }
+
+private:
+  ThreadRing(const ThreadRing&);
+  ThreadRing&operator=(const ThreadRing&);
+
+  std::vector<T>m_data;
+  /* the consumer owns 'm_read', the producer 'm_write' and 'm_pending' */
+  volatile size_t m_read, m_write;
+  size_t m_pending;
+  volatile unsigned long m_overruns, m_underruns;
+};
+};
+};
+#endif /* _INCLUDE__GEM_UTILS_THREADRING_H_ */
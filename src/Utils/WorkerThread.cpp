@@ -11,42 +11,17 @@
 //    WARRANTIES, see the file, "GEM.LICENSE.TERMS" in this distribution.
 //
 /////////////////////////////////////////////////////////
-#define WORKERTHREAD_DEQUEUE
 #ifdef HAVE_CONFIG_H
 # include "config.h"
 #endif
 
 #include "WorkerThread.h"
-#ifdef WORKERTHREAD_DEQUEUE
-# include <deque>
-# define QUEUE std::deque
-# define POP pop_front
-# define PUSH push_back
-#else
-# include <queue>
-# define QUEUE std::queue
-# define POP pop
-# define PUSH push
-#endif
-
+#include "Thread.h"
 #include "ThreadMutex.h"
-#include "ThreadSemaphore.h"
 
+#include <deque>
+#include <vector>
 #include <pthread.h>
-#ifdef HAVE_UNISTD_H
-# include <unistd.h>
-#endif
-#ifdef HAVE_SYS_TIME_H
-# include <sys/time.h>
-#endif
-#ifdef HAVE_SYS_TYPES_H
-# include <sys/types.h>
-#endif
-#ifdef _WIN32
-# include <winsock2.h>
-#endif
-
-#include <iostream>
 
 namespace gem
 {
@@ -62,39 +37,67 @@ public:
   WorkerThread*owner;
   WorkerThread::id_t ID; /* for generating the next ID */
 
-  bool keeprunning;
-  bool isrunning;
-
-  QUEUE< std::pair<WorkerThread::id_t, void*> > q_todo;
-  QUEUE< std::pair<WorkerThread::id_t, void*> > q_done;
-  Mutex m_todo;
+  struct Item {
+    WorkerThread::id_t ID;
+    void*data;
+    int priority;
+    Item(WorkerThread::id_t id, void*d, int prio)
+      : ID(id), data(d), priority(prio)
+    { }
+  };
+
+  /* the TODO queue is sorted by priority (FIFO within the same priority)
+   * it is protected by p_todo, which also protects 'keeprunning' and
+   * the 'processing' IDs; workers wait on p_newdata for new items */
+  std::deque<Item> q_todo;
+  std::deque< std::pair<WorkerThread::id_t, void*> > q_done;
+  pthread_mutex_t p_todo;
+  pthread_cond_t  p_newdata;
+  pthread_cond_t  p_processed;
   Mutex m_done;
-  Semaphore s_newdata;
 
-  WorkerThread::id_t
-  processingID; /* the ID currently processed or INVALID: must only be written in the thread! */
+  bool keeprunning;
+  /* the ID currently processed by each thread (or INVALID) */
+  std::vector<WorkerThread::id_t>processing;
 
-  pthread_t p_thread;
+  unsigned int numThreads;
+  std::vector<pthread_t>p_threads;
+  unsigned int running; /* number of threads currently alive */
   pthread_mutex_t p_runmutex;
   pthread_cond_t  p_runcond;
 
+  struct ThreadArg {
+    PIMPL*pimpl;
+    unsigned int index;
+  };
+  std::vector<ThreadArg>args;
+
   PIMPL(WorkerThread*x) : owner(x), ID(0)
-    , keeprunning(true), isrunning(false)
-    , m_todo(Mutex()), m_done(Mutex())
-    , s_newdata(Semaphore())
-    , processingID(WorkerThread::INVALID)
-#ifndef HAVE_PTW32_HANDLE_T
-    , p_thread(0)
-#endif
+    , m_done(Mutex())
+    , keeprunning(false)
+    , numThreads(1)
+    , running(0)
   {
+    pthread_mutex_init(&p_todo, 0);
+    pthread_cond_init (&p_newdata, 0);
+    pthread_cond_init (&p_processed, 0);
     pthread_mutex_init(&p_runmutex, 0);
     pthread_cond_init (&p_runcond, 0);
   }
   ~PIMPL(void)
   {
     stop(true);
+    /* threads detached by an earlier stop(false) might still be around */
+    pthread_mutex_lock  (&p_runmutex);
+    while(running) {
+      pthread_cond_wait (&p_runcond, &p_runmutex);
+    }
+    pthread_mutex_unlock(&p_runmutex);
     pthread_cond_destroy (&p_runcond );
     pthread_mutex_destroy(&p_runmutex);
+    pthread_cond_destroy (&p_processed);
+    pthread_cond_destroy (&p_newdata);
+    pthread_mutex_destroy(&p_todo);
   }
 
   inline WorkerThread::id_t nextID(void)
@@ -106,102 +109,167 @@ public:
     return ID;
   }
 
-  static inline void*process(void*you)
+  /* must be called with p_todo locked */
+  bool isProcessing(WorkerThread::id_t id) const
+  {
+    for(unsigned int i=0; i<processing.size(); i++) {
+      if(id == processing[i]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static void*process(void*you)
   {
-    PIMPL*me=reinterpret_cast<PIMPL*>(you);
+    ThreadArg*arg=reinterpret_cast<ThreadArg*>(you);
+    PIMPL*me=arg->pimpl;
+    const unsigned int index=arg->index;
     WorkerThread*wt=me->owner;
+
     pthread_mutex_lock  (&me->p_runmutex);
-    me->isrunning=true;
+    me->running++;
     pthread_cond_signal (&me->p_runcond );
     pthread_mutex_unlock(&me->p_runmutex);
-    std::pair <id_t, void*> in, out;
-
-    while(me->keeprunning) {
-      // wait till we are signalled new data
-
-      me->m_todo.lock();
-      while(me->q_todo.empty()) {
-        me->m_todo.unlock();
-        //std::cerr << "THREAD: waiting for new data...freeze"<<std::endl;
-        me->s_newdata.freeze();
-        //std::cerr << "THREAD: waiting for new data...thawed "<<me->keeprunning<<std::endl;
-
-        // either new data has arrived or we are told to stop
-        if(!me->keeprunning) {
-          me->isrunning = false;
-          return 0;
-        }
 
-        me->m_todo.lock();
+    pthread_mutex_lock(&me->p_todo);
+    while(true) {
+      // wait till we are signalled new data (or told to stop)
+      while(me->keeprunning && me->q_todo.empty()) {
+        pthread_cond_wait(&me->p_newdata, &me->p_todo);
+      }
+      if(!me->keeprunning) {
+        break;
       }
 
-      in=me->q_todo.front();
-      me->processingID=in.first;
-      me->q_todo.POP();
-      me->m_todo.unlock();
-
-      //std::cerr << "THREAD: processing data " << in.second  << " as "<<in.first<<std::endl;
-
-      out.first = in.first;
-      out.second=wt->process(in.first, in.second);
+      Item in=me->q_todo.front();
+      me->q_todo.pop_front();
+      me->processing[index]=in.ID;
+      pthread_mutex_unlock(&me->p_todo);
 
-      //std::cerr << "THREAD: done data " << out.second  << " as "<<out.first<<std::endl;
+      std::pair <id_t, void*> out;
+      out.first = in.ID;
+      out.second=wt->process(in.ID, in.data);
 
       me->m_done.lock();
-      bool newdata=true;//me->q_done.empty();
-      //std::cerr<<"THREAD: processed "<< out.first <<" -> "<< newdata<<std::endl;
-      me->q_done.PUSH(out);
-      me->processingID=WorkerThread::INVALID;
+      me->q_done.push_back(out);
       me->m_done.unlock();
-      //std::cerr << "THREAD: signaling newdata "<<newdata<<" for "<< out.first << std::endl;
-      if(newdata) {
-        wt->signal();
-      }
-      //std::cerr << "THREAD: signalled" << std::endl;
+
+      pthread_mutex_lock(&me->p_todo);
+      me->processing[index]=WorkerThread::INVALID;
+      pthread_cond_broadcast(&me->p_processed);
+      pthread_mutex_unlock(&me->p_todo);
+
+      wt->signal();
+
+      pthread_mutex_lock(&me->p_todo);
     }
-    //std::cerr << "THREAD: FINISHED" << std::endl;
-    me->isrunning=false;
+    pthread_mutex_unlock(&me->p_todo);
+
+    pthread_mutex_lock  (&me->p_runmutex);
+    me->running--;
+    pthread_cond_signal (&me->p_runcond );
+    pthread_mutex_unlock(&me->p_runmutex);
     return 0;
   }
 
   bool start(void)
   {
+    pthread_mutex_lock(&p_todo);
+    bool isrunning=keeprunning;
+    pthread_mutex_unlock(&p_todo);
     if(isrunning) {
       return true;
     }
-    keeprunning=true;
 
+    /* wait for detached threads of a previous run to terminate */
     pthread_mutex_lock  (&p_runmutex);
-    pthread_create      (&p_thread, 0, process, this);
-    pthread_cond_wait   (&p_runcond, &p_runmutex);
+    while(running) {
+      pthread_cond_wait (&p_runcond, &p_runmutex);
+    }
     pthread_mutex_unlock(&p_runmutex);
 
+    pthread_mutex_lock(&p_todo);
+    keeprunning=true;
+    processing.assign(numThreads, WorkerThread::INVALID);
+    pthread_mutex_unlock(&p_todo);
+
+    args.resize(numThreads);
+    p_threads.resize(numThreads);
+    unsigned int started=0;
+    for(unsigned int i=0; i<numThreads; i++) {
+      args[i].pimpl=this;
+      args[i].index=i;
+      pthread_mutex_lock  (&p_runmutex);
+      if(0 == pthread_create(&p_threads[i], 0, process, &args[i])) {
+        while(running<=started) {
+          pthread_cond_wait (&p_runcond, &p_runmutex);
+        }
+        started++;
+      }
+      pthread_mutex_unlock(&p_runmutex);
+    }
+    p_threads.resize(started);
+    if(!started) {
+      pthread_mutex_lock(&p_todo);
+      keeprunning=false;
+      pthread_mutex_unlock(&p_todo);
+      return false;
+    }
     return true;
-
   }
   bool stop(bool wait=true)
   {
-    if(!isrunning) {
-      return true;
-    }
-
+    pthread_mutex_lock(&p_todo);
+    bool wasrunning=keeprunning;
     keeprunning=false;
-    s_newdata.thaw();
-
-    if(!wait) {
-      return (!isrunning);
+    pthread_cond_broadcast(&p_newdata);
+    pthread_mutex_unlock(&p_todo);
+
+    if(wasrunning) {
+      for(unsigned int i=0; i<p_threads.size(); i++) {
+        if(wait) {
+          pthread_join(p_threads[i], 0);
+        } else {
+          pthread_detach(p_threads[i]);
+        }
+      }
+      p_threads.clear();
     }
-
-    struct timeval sleep;
-    while(isrunning) {
-      sleep.tv_sec=0;
-      sleep.tv_usec=10;
-      select(0,0,0,0,&sleep);
-      s_newdata.thaw();
+    if(!wait) {
+      pthread_mutex_lock  (&p_runmutex);
+      bool stopped=(0==running);
+      pthread_mutex_unlock(&p_runmutex);
+      return stopped;
     }
     return true;
   }
 
+  unsigned int setThreads(unsigned int n)
+  {
+    if(!n) {
+      n=gem::thread::getCPUCount();
+    }
+    if(!n) {
+      n=1;
+    }
+    if(n == numThreads) {
+      return numThreads;
+    }
+
+    pthread_mutex_lock(&p_todo);
+    bool isrunning=keeprunning;
+    pthread_mutex_unlock(&p_todo);
+
+    if(isrunning) {
+      stop(true);
+    }
+    numThreads=n;
+    if(isrunning) {
+      start();
+    }
+    return numThreads;
+  }
 };
 
 
@@ -236,63 +304,77 @@ bool WorkerThread::stop(bool wait)
 {
   return m_pimpl->stop(wait);
 }
+unsigned int WorkerThread::setThreads(unsigned int numThreads)
+{
+  return m_pimpl->setThreads(numThreads);
+}
+unsigned int WorkerThread::getThreads(void) const
+{
+  return m_pimpl->numThreads;
+}
 
 
 
 bool WorkerThread::queue(WorkerThread::id_t&ID, void*data)
 {
-  std::pair <id_t, void*> DATA;
-  DATA.second = data;
-
-  m_pimpl->m_todo.lock();
+  return queue(ID, data, 0);
+}
+bool WorkerThread::queue(WorkerThread::id_t&ID, void*data, int priority)
+{
+  pthread_mutex_lock(&m_pimpl->p_todo);
   ID=m_pimpl->nextID();
 
   //std::cerr << "queuing data " << data  << " as "<<ID<<std::endl;
   if(ID==INVALID) {
-    m_pimpl->m_todo.unlock();
+    pthread_mutex_unlock(&m_pimpl->p_todo);
     return false;
   }
 
-  DATA.first = ID;
-  m_pimpl->q_todo.PUSH(DATA);
-  m_pimpl->m_todo.unlock();
+  /* insert behind all items with the same or a higher priority */
+  std::deque<PIMPL::Item>&q=m_pimpl->q_todo;
+  std::deque<PIMPL::Item>::iterator it=q.end();
+  while(it!=q.begin()) {
+    std::deque<PIMPL::Item>::iterator prev=it;
+    --prev;
+    if(prev->priority >= priority) {
+      break;
+    }
+    it=prev;
+  }
+  q.insert(it, PIMPL::Item(ID, data, priority));
 
-  m_pimpl->s_newdata.thaw();
-  //std::cerr << "new data thawed" << std::endl;
+  pthread_cond_signal(&m_pimpl->p_newdata);
+  pthread_mutex_unlock(&m_pimpl->p_todo);
   return true;
 }
 bool WorkerThread::cancel(WorkerThread::id_t ID)
+{
+  return cancel(ID, true);
+}
+bool WorkerThread::cancel(WorkerThread::id_t ID, bool wait)
 {
   bool success=false;
-#ifdef WORKERTHREAD_DEQUEUE
-  if(!success) {
-    /* cancel from TODO list */
-    QUEUE< std::pair<WorkerThread::id_t, void*> > :: iterator it;
-    //std::cerr << "cancelling "<< (int)ID <<" from TODO" << std::endl;
-    m_pimpl->m_todo.lock();
-
-    for(it=m_pimpl->q_todo.begin(); it!=m_pimpl->q_todo.end(); ++it) {
-      if(it->first == ID) {
-        m_pimpl->q_todo.erase(it);
-        success=true;
-        break;
-      }
+  std::deque<PIMPL::Item>::iterator it;
+
+  pthread_mutex_lock(&m_pimpl->p_todo);
+  /* cancel from TODO list */
+  for(it=m_pimpl->q_todo.begin(); it!=m_pimpl->q_todo.end(); ++it) {
+    if(it->ID == ID) {
+      m_pimpl->q_todo.erase(it);
+      success=true;
+      break;
     }
-    m_pimpl->m_todo.unlock();
-
-    /* TODO: if ID is currently in the process, cancel that as well ... */
-    if(WorkerThread::INVALID != ID) {
-      /* ... or at least block until it is done... */
-      struct timeval sleep;
-      while(ID==m_pimpl->processingID) {
-        sleep.tv_sec=0;
-        sleep.tv_usec=10;
-        select(0,0,0,0,&sleep);
-      }
+  }
+
+  /* if ID is currently in the process, we cannot stop it;
+   * but we can block until it is done */
+  if(!success && wait && WorkerThread::INVALID != ID) {
+    while(m_pimpl->isProcessing(ID)) {
+      pthread_cond_wait(&m_pimpl->p_processed, &m_pimpl->p_todo);
     }
   }
-#endif
-  //    std::cerr << "cancelling "<< (int)ID <<" success " << success << std::endl;
+  pthread_mutex_unlock(&m_pimpl->p_todo);
+
   return success;
 }
 bool WorkerThread::dequeue(WorkerThread::id_t&ID, void*&data)
@@ -304,7 +386,7 @@ bool WorkerThread::dequeue(WorkerThread::id_t&ID, void*&data)
   m_pimpl->m_done.lock();
   if(!m_pimpl->q_done.empty()) {
     DATA=m_pimpl->q_done.front();
-    m_pimpl->q_done.POP();
+    m_pimpl->q_done.pop_front();
   }
   m_pimpl->m_done.unlock();
 
@@ -39,6 +39,14 @@ public:
   virtual bool start(void);
   virtual bool stop(bool wait=true);
 
+  ////
+  // set the number of threads that process the TODO queue
+  // (0 will use one thread per CPU)
+  // if the worker is running, it is restarted with the new number of threads
+  // returns the number of threads actually used
+  virtual unsigned int setThreads(unsigned int numThreads);
+  virtual unsigned int getThreads(void) const;
+
   typedef unsigned int id_t;
   static const id_t INVALID;
   static const id_t IMMEDIATE;
@@ -47,13 +55,23 @@ public:
   // the returned 'ID' can be used to interact with the queues
   // if queuing failed, FALSE is returned and ID is set to INVALID
   virtual bool queue(id_t&ID, void*data);
+  // queue a 'data' chunk with a given priority:
+  // chunks with a higher priority are processed first,
+  // chunks with the same priority in the order they were queued
+  // (the above queue() uses a priority of 0)
+  virtual bool queue(id_t&ID, void*data, int priority);
 
   //////
   // cancel a datachunk from the TODO-queue
   // if the chunk was successfully removed, returns TRUE
   // (FALSE is returned, if e.g. the given datachunk was not found in the queue)
   // note that items already processed cannot be cancelled anymore
+  // if the chunk is currently being processed, this blocks until it is done
   virtual bool cancel(const id_t ID);
+  // like above, but if 'wait' is FALSE this returns immediately
+  // even if the chunk is currently being processed
+  // (its result will show up in the DONE queue as usual)
+  virtual bool cancel(const id_t ID, bool wait);
 
   // dequeue the next datachunk from the DONE queue
   // if the queue is empty, FALSE is returned and ID is set to INVALID
@@ -64,6 +82,7 @@ protected:
   ////
   // the worker!
   // gets called from an alternative thread(s)
+  // (with several threads, process() is called concurrently!)
   // when the queue is non-empty,
   // the first element is removed from the TODO queue,
   // and this function is called with the 1st element as data
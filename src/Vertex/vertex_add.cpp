@@ -32,7 +32,8 @@ vertex_add :: vertex_add(int argc, t_atom*argv) :
   m_leftType(0), m_rightType(0),
   m_rightSize(0),
   m_rightVertexArray(NULL), m_rightColorArray(NULL),
-  m_rightTexCoordArray(NULL), m_rightNormalArray(NULL)
+  m_rightTexCoordArray(NULL), m_rightNormalArray(NULL),
+  m_operation(gem::vertex::Pipeline::ADD)
 {
   if(argc) {
     typeMess(argc, argv);
@@ -123,22 +124,11 @@ void vertex_add::typeMess(int argc, t_atom*argv)
 // we assume that "lsize" and "rsize" are >0
 // we assume that "larray" and "larray" point somewhere
 // checking is done in render()
-void vertex_add :: vertexProcess(int lsize, float*larray, int rsize,
+void vertex_add :: vertexProcess(gem::vertex::Pipeline&ops,
+                                 int lsize, float*larray, int rsize,
                                  float*rarray)
 {
-  float indR=0.f; // the right-hand index
-  float incR=static_cast<float>(rsize)/static_cast<float>
-             (lsize); // the right-hand increment
-
-  for(int i=0; i<lsize; i++) {
-    const int I=4*i;
-    const int J=4*static_cast<int>(indR); // i know that this is expensive
-    larray[I+0]+=rarray[J+0];
-    larray[I+1]+=rarray[J+1];
-    larray[I+2]+=rarray[J+2];
-    larray[I+3]+=rarray[J+3];
-    indR+=incR;
-  }
+  ops.add(m_operation, larray, lsize, rarray, rsize);
 }
 
 void vertex_add :: render(GemState *state)
@@ -187,7 +177,12 @@ void vertex_add :: render(GemState *state)
     return;
   }
 
-  vertexProcess(size, leftArray, m_rightSize, rightArray);
+  gem::vertex::Pipeline immediate;
+  gem::vertex::Pipeline*pipeline=gem::vertex::Pipeline::get(state);
+  vertexProcess(pipeline?(*pipeline):immediate,
+                size, leftArray, m_rightSize, rightArray);
+  // no pipeline in the GemState: apply right away
+  immediate.flush();
 }
 
 /////////////////////////////////////////////////////////
@@ -204,6 +199,9 @@ void vertex_add :: postrender(GemState *state)
 /////////////////////////////////////////////////////////
 void vertex_add :: rightRender(GemState *state)
 {
+  // the right-hand arrays must be up-to-date
+  gem::vertex::Pipeline::flush(state);
+
   m_rightSize          = state->VertexArraySize;
 
   m_rightVertexArray   = state->VertexArray;
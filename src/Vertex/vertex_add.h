@@ -16,6 +16,7 @@ LOG
 #define _INCLUDE__GEM_VERTEX_VERTEX_ADD_H_
 
 #include "Base/GemVertex.h"
+#include "Gem/VertexPipeline.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -61,13 +62,19 @@ protected:
 
   t_inlet *m_inlet;
 
+  // add or multiply
+  gem::vertex::Pipeline::Operation m_operation;
+
   //////////
   // set the types
   void typeMess(int, t_atom*);
 
   //////////
   // Do the rendering
-  virtual void    vertexProcess(int lsize, float*larray, int rsize,
+  // (the operation is only recorded into the pipeline;
+  //  it is applied by whoever consumes the vertex-arrays)
+  virtual void    vertexProcess(gem::vertex::Pipeline&ops,
+                                int lsize, float*larray, int rsize,
                                 float*rarray);
   virtual void    render(GemState *state);
   virtual void    postrender(GemState *state);
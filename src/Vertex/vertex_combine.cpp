@@ -17,6 +17,7 @@
 #include "vertex_combine.h"
 
 #include "Gem/State.h"
+#include "Gem/VertexPipeline.h"
 #include <string.h>
 #include <math.h>
 CPPEXTERN_NEW(vertex_combine);
@@ -54,6 +55,8 @@ void vertex_combine :: render(GemState *state)
   GLfloat *VertexArray;
   float blendL, blendR, ratiof;
 
+  gem::vertex::Pipeline::flush(state);
+
   VertexArray =state->VertexArray;
   if (state->VertexArray == NULL || state->VertexArraySize <= 0) {
     post("no vertex array!");
@@ -156,6 +159,9 @@ void vertex_combine :: postrender(GemState *state)
 /////////////////////////////////////////////////////////
 void vertex_combine :: rightRender(GemState *state)
 {
+  // the right-hand arrays must be up-to-date
+  gem::vertex::Pipeline::flush(state);
+
   if (state->VertexArray == NULL || state->VertexArraySize <= 0) {
     post("no right vertex array!");
     return;
@@ -18,6 +18,7 @@
 
 #include "Gem/State.h"
 #include "Gem/Cache.h"
+#include "Gem/VertexPipeline.h"
 
 #define __VBO
 
@@ -93,6 +94,9 @@ vertex_draw :: ~vertex_draw()
 /////////////////////////////////////////////////////////
 void vertex_draw :: render(GemState *state)
 {
+  // apply whatever [vertex_scale] & co. have left for us
+  gem::vertex::Pipeline::flush(state, &m_pool);
+
   bool rebuild=(state->VertexDirty);
   //if(rebuild)post("rebuild");
 
@@ -322,6 +326,15 @@ void vertex_draw :: typeMess(t_symbol* type)
 }
 
 
+/////////////////////////////////////////////////////////
+// threadMess
+//
+/////////////////////////////////////////////////////////
+void vertex_draw :: threadMess(int threads)
+{
+  m_pool.setThreads(threads);
+}
+
 /////////////////////////////////////////////////////////
 // static member function
 //
@@ -340,6 +353,7 @@ void vertex_draw :: obj_setupCallback(t_class *classPtr)
   class_addmethod(classPtr,
                   reinterpret_cast<t_method>(&vertex_draw::typeMessCallback),
                   gensym("draw"), A_SYMBOL, A_NULL);
+  CPPEXTERN_MSG1(classPtr, "threads", threadMess, int);
 }
 
 void vertex_draw :: defaultMessCallback(void *data, t_float size)
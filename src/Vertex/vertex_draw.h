@@ -17,6 +17,7 @@ LOG
 
 #include "Base/GemVertex.h"
 #include "Gem/GemGL.h"
+#include "Utils/ThreadPool.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -78,6 +79,11 @@ protected:
   // do we want to use the default draw-style (from GemState) or our own ?
   int     m_defaultDraw;
 
+  //////////
+  // pending vertex-operations are optionally applied on several threads
+  gem::thread::ThreadPool m_pool;
+  void threadMess(int threads);
+
 private:
   static void     colorMessCallback(void *data, t_float size);
   static void     texcoordMessCallback(void *data, t_float t);
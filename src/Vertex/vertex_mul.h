@@ -45,11 +45,6 @@ protected:
   //////////
   // Destructor
   virtual ~vertex_mul(void);
-
-  //////////
-  // Do the rendering
-  virtual void    vertexProcess(int lsize, float*larray, int rsize,
-                                float*rarray);
 };
 
 #endif  // for header file
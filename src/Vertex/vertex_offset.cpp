@@ -29,9 +29,11 @@ CPPEXTERN_NEW_WITH_GIMME(vertex_offset);
 //
 /////////////////////////////////////////////////////////
 vertex_offset :: vertex_offset(int argc, t_atom*argv) : vertex_scale(argc,
-      argv),
-  m_x(0.f), m_y(0.f), m_z(0.f), m_w(0.f)
-{}
+      argv)
+{
+  m_x=m_y=m_z=m_w=0.f;
+  m_operation=gem::vertex::Pipeline::OFFSET;
+}
 
 /////////////////////////////////////////////////////////
 // Destructor
@@ -58,51 +60,6 @@ void vertex_offset :: paramMess(int argc, t_atom*argv)
   }
 }
 
-/////////////////////////////////////////////////////////
-// render
-//
-/////////////////////////////////////////////////////////
-void vertex_offset :: vertexProcess(int size, GLfloat*array)
-{
-  int count;
-
-  if (m_offset < 0) {
-    m_offset = 0;
-  }
-  if (m_offset > size) {
-    m_offset = size;
-  }
-  count = m_count;
-
-  if (count < 1) {
-    count = 1;
-  }
-  if ((count + m_offset-1) > size) {
-    count = size - m_offset;  // -1;
-  }
-
-  //needs some altivec
-  if (m_offset) {
-    int src = (m_offset-1) * 4;
-    for (int i=0; i< count; i++) {
-      array[src] += m_x;
-      array[src+1] += m_y;
-      array[src+2] += m_z;
-      array[src+3] += m_w;
-      src+=4;
-    }
-  } else {
-    int src=0;
-    for (int i=0; i< size; i++) {
-      array[src] += m_x;
-      array[src+1] += m_y;
-      array[src+2] += m_z;
-      array[src+3] += m_w;
-      src+=4;
-    }
-  }
-}
-
 /////////////////////////////////////////////////////////
 // static member function
 //
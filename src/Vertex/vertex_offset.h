@@ -47,11 +47,6 @@ protected:
   virtual ~vertex_offset(void);
 
   virtual void paramMess(int,t_atom*);
-  float m_x,m_y,m_z,m_w;
-
-  //////////
-  // Do the rendering
-  virtual void  vertexProcess(int,GLfloat *);
 
 private:
   //static void         offsetMessCallback(void *data, t_symbol*, int, t_atom*);
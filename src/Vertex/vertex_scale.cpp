@@ -32,7 +32,8 @@ vertex_scale :: vertex_scale(int argc, t_atom*argv) : GemBase(),
   m_x(1.f), m_y(1.f), m_z(1.f), m_w(1.f),
   m_offset(0), m_count(0),
   m_vertex(false), m_color(false),
-  m_normal(false), m_texture(false)
+  m_normal(false), m_texture(false),
+  m_operation(gem::vertex::Pipeline::SCALE)
 {
   m_vertIn=inlet_new(this->x_obj, &this->x_obj->ob_pd, &s_float,
                      gensym("vertex"));
@@ -117,7 +118,8 @@ void vertex_scale :: paramMess(int argc, t_atom*argv)
 // render
 //
 /////////////////////////////////////////////////////////
-void vertex_scale :: vertexProcess(int size, GLfloat*array)
+void vertex_scale :: vertexProcess(gem::vertex::Pipeline&ops, int size,
+                                   GLfloat*array)
 {
   int count;
 
@@ -136,25 +138,11 @@ void vertex_scale :: vertexProcess(int size, GLfloat*array)
     count = size - m_offset;  // -1;
   }
 
-  //needs some altivec
+  const float param[4]= {m_x, m_y, m_z, m_w};
   if (m_offset) {
-    int src = (m_offset-1) * 4;
-    for (int i=0; i< count; i++) {
-      array[src] *= m_x;
-      array[src+1] *= m_y;
-      array[src+2] *= m_z;
-      array[src+3] *= m_w;
-      src+=4;
-    }
+    ops.add(m_operation, array, m_offset-1, count, param);
   } else {
-    int src=0;
-    for (int i=0; i< size; i++) {
-      array[src] *= m_x;
-      array[src+1] *= m_y;
-      array[src+2] *= m_z;
-      array[src+3] *= m_w;
-      src+=4;
-    }
+    ops.add(m_operation, array, 0, size, param);
   }
 }
 
@@ -164,21 +152,29 @@ void vertex_scale :: render(GemState *state)
   if(state->VertexArraySize<=0) {
     return;
   }
+  int size=state->VertexArraySize;
+  gem::vertex::Pipeline immediate;
+  gem::vertex::Pipeline*pipeline=gem::vertex::Pipeline::get(state);
+  gem::vertex::Pipeline&ops=pipeline?(*pipeline):immediate;
+
   if(m_vertex && state->VertexArray != NULL) {
-    vertexProcess(state->VertexArraySize, state->VertexArray);
+    vertexProcess(ops, size, state->VertexArray);
   }
 
   if(m_color && state->ColorArray != NULL) {
-    vertexProcess(state->VertexArraySize, state->ColorArray);
+    vertexProcess(ops, size, state->ColorArray);
   }
 
   if(m_normal && state->NormalArray != NULL) {
-    vertexProcess(state->VertexArraySize, state->NormalArray);
+    vertexProcess(ops, size, state->NormalArray);
   }
 
   if(m_texture && state->TexCoordArray != NULL) {
-    vertexProcess(state->VertexArraySize, state->TexCoordArray);
+    vertexProcess(ops, size, state->TexCoordArray);
   }
+
+  // no pipeline in the GemState: apply right away
+  immediate.flush();
 }
 
 /////////////////////////////////////////////////////////
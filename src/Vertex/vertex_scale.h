@@ -17,6 +17,7 @@ LOG
 
 #include "Base/GemVertex.h"
 #include "Gem/GemGL.h"
+#include "Gem/VertexPipeline.h"
 
 /*-----------------------------------------------------------------
 -------------------------------------------------------------------
@@ -59,9 +60,15 @@ protected:
 
   t_inlet*m_parmIn, *m_vertIn;
 
+  // what to do with the parameters (scale, offset or set)
+  gem::vertex::Pipeline::Operation m_operation;
+
   //////////
   // Do the rendering
-  virtual void  vertexProcess(int,GLfloat *);
+  // (the operation is only recorded into the pipeline;
+  //  it is applied by whoever consumes the vertex-arrays)
+  virtual void  vertexProcess(gem::vertex::Pipeline&ops, int size,
+                              GLfloat*array);
   virtual void  render(GemState *state);
 
   static void   paramMessCallback(void *data, t_symbol*, int, t_atom*);
@@ -15,6 +15,7 @@
 #include "GEMglBitmap.h"
 #include "Gem/Image.h"
 #include "Gem/State.h"
+#include "Gem/ImageGPU.h"
 
 CPPEXTERN_NEW_WITH_FOUR_ARGS ( GEMglBitmap, t_floatarg, A_DEFFLOAT,
                                t_floatarg, A_DEFFLOAT, t_floatarg, A_DEFFLOAT, t_floatarg, A_DEFFLOAT);
@@ -65,6 +66,7 @@ void GEMglBitmap :: render(GemState *state)
   }
   pixBlock*img=NULL;
   state->get(GemState::_PIX, img);
+  img=gem::image::GPUFilter::hostImage(img, m_hostImage);
   if(!img || !&img->image) {
     return;
   }
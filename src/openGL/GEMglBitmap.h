@@ -14,6 +14,7 @@
 #define _INCLUDE__GEM_OPENGL_GEMGLBITMAP_H_
 
 #include "Base/GemGLBase.h"
+#include "Gem/Image.h"
 
 /*
  CLASS
@@ -62,5 +63,9 @@ private:
   static void    yorigMessCallback (void*, t_float);
   static void    xmoveMessCallback (void*, t_float);
   static void    ymoveMessCallback (void*, t_float);
+
+  //////////
+  // texture-resident images are read back into here
+  pixBlock m_hostImage;
 };
 #endif // for header file
@@ -14,6 +14,7 @@
 #define _INCLUDE__GEM_OPENGL_GEMGLTEXIMAGE2D_H_
 
 #include "Base/GemGLBase.h"
+#include "Gem/Image.h"
 
 /*
  CLASS
@@ -73,5 +74,9 @@ private:
   static void    yoffsetMessCallback (void*, t_float);
   static void    widthMessCallback (void*, t_float);
   static void    heightMessCallback (void*, t_float);
+
+  //////////
+  // texture-resident images are read back into here
+  pixBlock m_hostImage;
 };
 #endif // for header file
@@ -15,6 +15,7 @@
 #include "GEMglTexSubImage1D.h"
 #include "Gem/Image.h"
 #include "Gem/State.h"
+#include "Gem/ImageGPU.h"
 
 CPPEXTERN_NEW_WITH_THREE_ARGS ( GEMglTexSubImage1D, t_floatarg, A_DEFFLOAT,
                                 t_floatarg, A_DEFFLOAT, t_floatarg, A_DEFFLOAT );
@@ -72,6 +73,7 @@ void GEMglTexSubImage1D :: render(GemState *state)
   }
   pixBlock*img=NULL;
   state->get(GemState::_PIX, img);
+  img=gem::image::GPUFilter::hostImage(img, m_hostImage);
   if(!img || !&img->image) {
     return;
   }
@@ -14,6 +14,7 @@
 #define _INCLUDE__GEM_OPENGL_GEMGLTEXSUBIMAGE1D_H_
 
 #include "Base/GemGLBase.h"
+#include "Gem/Image.h"
 
 /*
  CLASS
@@ -65,5 +66,9 @@ private:
   static void    levelMessCallback (void*, t_float);
   static void    xoffsetMessCallback (void*, t_float);
   static void    widthMessCallback (void*, t_float);
+
+  //////////
+  // texture-resident images are read back into here
+  pixBlock m_hostImage;
 };
 #endif // for header file
@@ -15,6 +15,7 @@
 #include "GEMglTexSubImage2D.h"
 #include "Gem/Image.h"
 #include "Gem/State.h"
+#include "Gem/ImageGPU.h"
 
 CPPEXTERN_NEW_WITH_GIMME ( GEMglTexSubImage2D );
 
@@ -89,6 +90,7 @@ void GEMglTexSubImage2D :: render(GemState *state)
   }
   pixBlock*img=NULL;
   state->get(GemState::_PIX, img);
+  img=gem::image::GPUFilter::hostImage(img, m_hostImage);
   if(!img || !&img->image) {
     return;
   }
@@ -179,6 +179,8 @@ public:
     std::vector<std::string>ids=
       gem::PluginFactory<gem::plugins::film>::getIDs();
 
+    /* HAP only takes HAP movies, which are better not decoded by others */
+    addPlugin(ids, "HAP");
     if(!addPlugin(ids, "DirectShow")) {
       addPlugin(ids, "AVI");
     }
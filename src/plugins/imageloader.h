@@ -53,6 +53,17 @@ public:
    *
    * props can be filled by the loader with additional information on the image
    * e.g. EXIF tags,...
+   *
+   * on entry, props might hold hints on the size the caller actually needs:
+   *   'minwidth', 'minheight' (float): loaders that can decode at a reduced
+   *     resolution (e.g. JPEG) may return a smaller image, as long as it is
+   *     at least that large; the original size is then reported in
+   *     'imagewidth' and 'imageheight'
+   * loaders are free to ignore these hints (and return the full image)
+   *
+   * the image might be block compressed (see imageStruct::blockSize()),
+   * e.g. when reading DDS files; such images can be passed to the GPU directly
+   * or have to be converted (e.g. to GEM_RGBA) before accessing the pixels
    */
   /* returns TRUE if loading was successful, FALSE otherwise */
   virtual bool load(std::string filename,